@@ -0,0 +1,255 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "celix_event_admin.h"
+#include "celix_event_handler_service.h"
+#include "celix_event_constants.h"
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_framework_factory.h"
+
+/**
+ * Benchmark for the async event delivery of the event admin.
+ *
+ * Every iteration posts NR_OF_EVENTS_PER_ITERATION events to state.range(0) event handlers and waits until all events
+ * are delivered. state.range(1) selects ordered (0) or unordered (1) delivery.
+ * For EventAdmin_PostEventWithBusyHandler an additional handler blocks on its first event, while
+ * NR_OF_BUSY_HANDLER_EVENTS events are pending for it.
+ * EventAdmin_PostEventWithProperties posts events with NR_OF_EVENT_PROPERTIES properties, which are copied (0) or
+ * handed over to the event admin without copy (1) depending on state.range(1).
+ * EventAdmin_PostEventBatch posts the NR_OF_EVENTS_PER_ITERATION events of an iteration with a single postEvents call,
+ * state.range(1) selects event handlers which handle the events one by one (0) or in batches with handleEvents (1).
+ * EventAdmin_SendEvent sends events synchronously to state.range(0) event handlers, which subscribe to the event topic
+ * with a topic, several prefix topics and "*".
+ */
+static constexpr int NR_OF_EVENTS_PER_ITERATION = 256;
+static constexpr int NR_OF_BUSY_HANDLER_EVENTS = 255;
+static constexpr int NR_OF_EVENT_PROPERTIES = 8;
+
+class CelixEventAdminBenchmark {
+public:
+    CelixEventAdminBenchmark(int nrOfHandlers, bool unordered, bool withBusyHandler = false, const char* handlerTopics = "org/celix/benchmark",
+                             long handlerBatchSize = 1)
+        : handlerServices(nrOfHandlers) {
+        auto* config = celix_properties_create();
+        celix_properties_set(config, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(config, CELIX_FRAMEWORK_CACHE_DIR, ".event_admin_benchmark_cache");
+        celix_properties_set(config, "CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
+        fw = celix_frameworkFactory_createFramework(config);
+        ctx = celix_framework_getFrameworkContext(fw);
+        ea = celix_eventAdmin_create(ctx);
+        celix_eventAdmin_start(ea);
+
+        for (int i = 0; i < nrOfHandlers; ++i) {
+            auto& svc = handlerServices[i];
+            svc.handle = this;
+            svc.handleEvent = [](void* handle, const char*, const celix_properties_t*) -> celix_status_t {
+                auto* benchmark = static_cast<CelixEventAdminBenchmark*>(handle);
+                benchmark->handledEvents.fetch_add(1, std::memory_order_relaxed);
+                return CELIX_SUCCESS;
+            };
+            svc.handleEvents = [](void* handle, const celix_event_entry_t*, size_t size) -> celix_status_t {
+                auto* benchmark = static_cast<CelixEventAdminBenchmark*>(handle);
+                benchmark->handledEvents.fetch_add((long)size, std::memory_order_relaxed);
+                return CELIX_SUCCESS;
+            };
+            auto* props = celix_properties_create();
+            celix_properties_set(props, CELIX_EVENT_TOPIC, handlerTopics);
+            if (handlerBatchSize > 1) {
+                celix_properties_setLong(props, CELIX_EVENT_BATCH_SIZE, handlerBatchSize);
+            }
+            celix_properties_setLong(props, CELIX_FRAMEWORK_SERVICE_ID, 1000 + i);
+            if (unordered) {
+                celix_properties_set(props, CELIX_EVENT_DELIVERY, CELIX_EVENT_DELIVERY_ASYNC_UNORDERED);
+            }
+            celix_eventAdmin_addEventHandlerWithProperties(ea, &svc, props);
+            handlerProps.push_back(props);
+        }
+
+        if (withBusyHandler) {
+            busyHandlerService.handle = this;
+            busyHandlerService.handleEvent = [](void* handle, const char*, const celix_properties_t*) -> celix_status_t {
+                auto* benchmark = static_cast<CelixEventAdminBenchmark*>(handle);
+                while (benchmark->busyHandlerBlocked.load()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                }
+                return CELIX_SUCCESS;
+            };
+            busyHandlerProps = celix_properties_create();
+            celix_properties_set(busyHandlerProps, CELIX_EVENT_TOPIC, "org/celix/benchmark/busy");
+            celix_properties_setLong(busyHandlerProps, CELIX_FRAMEWORK_SERVICE_ID, 999);
+            celix_eventAdmin_addEventHandlerWithProperties(ea, &busyHandlerService, busyHandlerProps);
+            for (int i = 0; i < NR_OF_BUSY_HANDLER_EVENTS + 1/*handling event*/; ++i) {
+                celix_eventAdmin_postEvent(ea, "org/celix/benchmark/busy", nullptr);
+            }
+        }
+    }
+
+    ~CelixEventAdminBenchmark() noexcept {
+        busyHandlerBlocked = false;
+        if (busyHandlerProps != nullptr) {
+            celix_eventAdmin_removeEventHandlerWithProperties(ea, &busyHandlerService, busyHandlerProps);
+            celix_properties_destroy(busyHandlerProps);
+        }
+        for (size_t i = 0; i < handlerProps.size(); ++i) {
+            celix_eventAdmin_removeEventHandlerWithProperties(ea, &handlerServices[i], handlerProps[i]);
+            celix_properties_destroy(handlerProps[i]);
+        }
+        celix_eventAdmin_stop(ea);
+        celix_eventAdmin_destroy(ea);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    CelixEventAdminBenchmark(const CelixEventAdminBenchmark&) = delete;
+    CelixEventAdminBenchmark& operator=(const CelixEventAdminBenchmark&) = delete;
+
+    celix_framework_t* fw{};
+    celix_bundle_context_t* ctx{};
+    celix_event_admin_t* ea{};
+    std::vector<celix_event_handler_service_t> handlerServices;
+    std::vector<celix_properties_t*> handlerProps{};
+    std::atomic<long> handledEvents{0};
+    celix_event_handler_service_t busyHandlerService{};
+    celix_properties_t* busyHandlerProps{};
+    std::atomic<bool> busyHandlerBlocked{true};
+};
+
+static void PostEvents(benchmark::State& state, CelixEventAdminBenchmark& benchmark) {
+    auto nrOfHandlers = (long)state.range(0);
+    long expectedEvents = 0;
+    long droppedEvents = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < NR_OF_EVENTS_PER_ITERATION; ++i) {
+            if (celix_eventAdmin_postEvent(benchmark.ea, "org/celix/benchmark", nullptr) == CELIX_SUCCESS) {
+                expectedEvents += nrOfHandlers;
+            } else {
+                droppedEvents++;
+            }
+        }
+        while (benchmark.handledEvents.load(std::memory_order_relaxed) < expectedEvents) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NR_OF_EVENTS_PER_ITERATION);
+    state.counters["deliveries"] = benchmark::Counter((double)expectedEvents, benchmark::Counter::kIsRate);
+    state.counters["dropped"] = (double)droppedEvents;
+}
+
+static void EventAdmin_PostEvent(benchmark::State& state) {
+    CelixEventAdminBenchmark benchmark{(int)state.range(0), state.range(1) != 0};
+    PostEvents(state, benchmark);
+}
+
+static void EventAdmin_PostEventWithBusyHandler(benchmark::State& state) {
+    CelixEventAdminBenchmark benchmark{(int)state.range(0), state.range(1) != 0, true};
+    PostEvents(state, benchmark);
+}
+
+static celix_properties_t* CreateEventProperties() {
+    auto* props = celix_properties_create();
+    for (int i = 0; i < NR_OF_EVENT_PROPERTIES; ++i) {
+        celix_properties_setLong(props, ("key" + std::to_string(i)).c_str(), i);
+    }
+    return props;
+}
+
+static void EventAdmin_PostEventWithProperties(benchmark::State& state) {
+    CelixEventAdminBenchmark benchmark{(int)state.range(0), false};
+    bool withoutCopy = state.range(1) != 0;
+    auto nrOfHandlers = (long)state.range(0);
+    long expectedEvents = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < NR_OF_EVENTS_PER_ITERATION; ++i) {
+            celix_properties_t* props = CreateEventProperties();
+            celix_status_t status;
+            if (withoutCopy) {
+                status = celix_eventAdmin_postEventWithoutCopy(benchmark.ea, "org/celix/benchmark", props);
+            } else {
+                status = celix_eventAdmin_postEvent(benchmark.ea, "org/celix/benchmark", props);
+                celix_properties_destroy(props);
+            }
+            if (status == CELIX_SUCCESS) {
+                expectedEvents += nrOfHandlers;
+            }
+        }
+        while (benchmark.handledEvents.load(std::memory_order_relaxed) < expectedEvents) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NR_OF_EVENTS_PER_ITERATION);
+}
+
+static void EventAdmin_PostEventBatch(benchmark::State& state) {
+    CelixEventAdminBenchmark benchmark{(int)state.range(0), false, false, "org/celix/benchmark",
+                                       state.range(1) != 0 ? NR_OF_EVENTS_PER_ITERATION : 1};
+    auto nrOfHandlers = (long)state.range(0);
+    std::vector<const celix_properties_t*> props(NR_OF_EVENTS_PER_ITERATION, nullptr);
+    long expectedEvents = 0;
+    for (auto _ : state) {
+        if (celix_eventAdmin_postEvents(benchmark.ea, "org/celix/benchmark", props.data(), props.size()) == CELIX_SUCCESS) {
+            expectedEvents += nrOfHandlers * NR_OF_EVENTS_PER_ITERATION;
+        }
+        while (benchmark.handledEvents.load(std::memory_order_relaxed) < expectedEvents) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NR_OF_EVENTS_PER_ITERATION);
+    state.counters["deliveries"] = benchmark::Counter((double)expectedEvents, benchmark::Counter::kIsRate);
+}
+
+static void EventAdmin_SendEvent(benchmark::State& state) {
+    CelixEventAdminBenchmark benchmark{(int)state.range(0), false, false, "*,org/*,org/celix/*,org/celix/benchmark"};
+    for (auto _ : state) {
+        celix_eventAdmin_sendEvent(benchmark.ea, "org/celix/benchmark", nullptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["deliveries"] = benchmark::Counter((double)benchmark.handledEvents.load(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(EventAdmin_PostEvent)
+    ->ArgsProduct({{1, 4, 16, 64}, {0, 1}})
+    ->ArgNames({"handlers", "unordered"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(EventAdmin_PostEventWithBusyHandler)
+    ->ArgsProduct({{1, 4, 16, 64}, {0, 1}})
+    ->ArgNames({"handlers", "unordered"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(EventAdmin_PostEventWithProperties)
+    ->ArgsProduct({{1, 16}, {0, 1}})
+    ->ArgNames({"handlers", "withoutCopy"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(EventAdmin_PostEventBatch)
+    ->ArgsProduct({{1, 4, 16, 64}, {0, 1}})
+    ->ArgNames({"handlers", "batchHandler"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(EventAdmin_SendEvent)
+    ->Arg(1)->Arg(16)->Arg(64)
+    ->ArgName("handlers")
+    ->Unit(benchmark::kNanosecond);
@@ -29,6 +29,7 @@
 #include "celix_utils_ei.h"
 #include "malloc_ei.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 
 class CelixEventAdminErrorInjectionTestSuite : public CelixEventAdminTestSuiteBaseClass {
@@ -48,9 +49,9 @@ public:
         celix_ei_expect_celix_utils_strdup(nullptr, 0, nullptr);
         celix_ei_expect_celix_stringHashMap_put(nullptr, 0, 0);
         celix_ei_expect_celix_longHashMap_put(nullptr, 0, 0);
-        celix_ei_expect_celix_arrayList_addLong(nullptr, 0, 0);
+        celix_ei_expect_celix_arrayList_add(nullptr, 0, 0);
         celix_ei_expect_celix_elapsedtime(nullptr, 0, 0);
-        celix_ei_expect_celix_arrayList_createWithOptions(nullptr, 0, nullptr);
+        celix_ei_expect_malloc(nullptr, 0, nullptr);
     }
 };
 
@@ -95,22 +96,24 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateLockForEventAdminTe
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateChannelMatchingAllEventsForEventAdminTest) {
-    celix_ei_expect_celix_arrayList_create((void*)&celix_eventAdmin_create, 0, nullptr);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToAllocMemoryForTopicTreeOfEventAdminTest) {
+    celix_ei_expect_calloc((void*)&celix_eventAdmin_create, 1, nullptr);
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateChannelsMatchingTopicForEventAdminTest) {
-    celix_ei_expect_celix_stringHashMap_create((void*)&celix_eventAdmin_create, 0, nullptr);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateTopicTreeChildrenForEventAdminTest) {
+    celix_ei_expect_celix_stringHashMap_create((void*)&celix_eventAdmin_create, 1, nullptr);
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateChannelsMatchingPrefixTopicForEventAdminTest) {
-    celix_ei_expect_celix_stringHashMap_create((void*)&celix_eventAdmin_create, 0, nullptr, 2);
-    auto ea = celix_eventAdmin_create(ctx.get());
-    EXPECT_EQ(nullptr, ea);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateTopicTreeHandlerListsForEventAdminTest) {
+    for (int i = 1; i <= 4; ++i) {
+        celix_ei_expect_celix_arrayList_create((void*)&celix_eventAdmin_create, 1, nullptr, i);
+        auto ea = celix_eventAdmin_create(ctx.get());
+        EXPECT_EQ(nullptr, ea);
+    }
 }
 
 TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateEventHandlersMapForEventAdminTest) {
@@ -119,20 +122,20 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateEventHandlersMapFor
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateMutexForEventAdminTest) {
-    celix_ei_expect_celixThreadMutex_create((void*)&celix_eventAdmin_create, 0, CELIX_ENOMEM);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateEventPoolForEventAdminTest) {
+    celix_ei_expect_celixThreadMutex_create((void*)&celix_eventAdmin_create, 1, CELIX_ENOMEM);
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateCondForEventAdminTest) {
-    celix_ei_expect_celixThreadCondition_init((void*)&celix_eventAdmin_create, 0, CELIX_ENOMEM);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateMutexForEventAdminTest) {
+    celix_ei_expect_celixThreadMutex_create((void*)&celix_eventAdmin_create, 0, CELIX_ENOMEM);
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_EQ(nullptr, ea);
 }
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateAsyncEventQueueForEventAdminTest) {
-    celix_ei_expect_celix_arrayList_createWithOptions((void*)&celix_eventAdmin_create, 0, nullptr);
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateCondForEventAdminTest) {
+    celix_ei_expect_celixThreadCondition_init((void*)&celix_eventAdmin_create, 0, CELIX_ENOMEM);
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_EQ(nullptr, ea);
 }
@@ -194,23 +197,32 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToPutHandlerToMapWhenAdding
 }
 
 TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToSubscribeAllTopicTest) {
-    celix_ei_expect_celix_arrayList_addLong((void*)&celix_eventAdmin_addEventHandlerWithProperties, 1, CELIX_ENOMEM);
+    celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_addEventHandlerWithProperties, 1, CELIX_ENOMEM);
     TestSubscribeEvent("*");
 }
 
 
 TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToSubscribeTopicTest) {
-    celix_ei_expect_calloc((void*)&celix_eventAdmin_addEventHandlerWithProperties, 2, nullptr);
+    celix_ei_expect_calloc((void*)&celix_eventAdmin_addEventHandlerWithProperties, 4, nullptr);
+    TestSubscribeEvent("org/celix/test");
+
+    celix_ei_expect_celix_stringHashMap_create((void*)&celix_eventAdmin_addEventHandlerWithProperties, 4, nullptr);
+    TestSubscribeEvent("org/celix/test");
+
+    celix_ei_expect_celix_arrayList_create((void*)&celix_eventAdmin_addEventHandlerWithProperties, 4, nullptr);
     TestSubscribeEvent("org/celix/test");
 
-    celix_ei_expect_celix_arrayList_create((void*)&celix_eventAdmin_addEventHandlerWithProperties, 2, nullptr);
+    celix_ei_expect_celix_stringHashMap_put((void*)&celix_eventAdmin_addEventHandlerWithProperties, 3, CELIX_ENOMEM);
     TestSubscribeEvent("org/celix/test");
 
-    celix_ei_expect_celix_arrayList_addLong((void*)&celix_eventAdmin_addEventHandlerWithProperties, 2, CELIX_ENOMEM);
+    celix_ei_expect_celix_stringHashMap_put((void*)&celix_eventAdmin_addEventHandlerWithProperties, 3, CELIX_ENOMEM, 2);
     TestSubscribeEvent("org/celix/test");
 
-    celix_ei_expect_celix_stringHashMap_put((void*)&celix_eventAdmin_addEventHandlerWithProperties, 2, CELIX_ENOMEM);
+    celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_addEventHandlerWithProperties, 1, CELIX_ENOMEM);
     TestSubscribeEvent("org/celix/test");
+
+    celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_addEventHandlerWithProperties, 1, CELIX_ENOMEM);
+    TestSubscribeEvent("org/celix/*");
 }
 
 TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToSubscribeExistedTopicTest) {
@@ -236,7 +248,7 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToSubscribeExistedTopicTest
         auto handlerSvcId2 = celix_bundleContext_registerService(ctx, &handler, CELIX_EVENT_HANDLER_SERVICE_NAME, props2);
         ASSERT_TRUE(handlerSvcId2 >= 0);
 
-        celix_ei_expect_celix_arrayList_addLong((void*)&celix_eventAdmin_addEventHandlerWithProperties, 2, CELIX_ENOMEM, 2);
+        celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_addEventHandlerWithProperties, 1, CELIX_ENOMEM, 2);
 
         celix_service_tracking_options_t opts{};
         opts.filter.serviceName = CELIX_EVENT_HANDLER_SERVICE_NAME;
@@ -260,31 +272,32 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToSubscribeExistedTopicTest
 }
 
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCreateEventHandlerSetsWhenSendingEventTest) {
-    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
-        celix_ei_expect_celix_longHashMap_create((void*)&celix_eventAdmin_sendEvent, 1, nullptr);
-        auto status = celix_eventAdmin_sendEvent(ea, "org/celix/test", nullptr);
-        EXPECT_EQ(CELIX_ENOMEM, status);
-    }, [](void *handle, const char *topic, const celix_properties_t *props) {
-        (void)handle;
-        (void)props;
-        (void)topic;
-        ADD_FAILURE() << "Should not be called";
-        return CELIX_SUCCESS;
-    });
-}
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToUpdateTopicTreeCacheTest) {
+    TestEventAdmin([](celix_event_admin_t *ea, celix_bundle_context_t *ctx) {
+        (void)ctx;
+        celix_event_handler_service_t handler;
+        handler.handle = nullptr;
+        handler.handleEvent = [](void *handle, const char *topic, const celix_properties_t *props) {
+            (void)handle;
+            (void)props;
+            (void)topic;
+            ADD_FAILURE() << "Should not be called";
+            return CELIX_SUCCESS;
+        };
+        auto props = celix_properties_create();
+        celix_properties_set(props, CELIX_EVENT_TOPIC, "*");
+        celix_properties_setLong(props, CELIX_FRAMEWORK_SERVICE_ID, 123);
 
-TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToCollectHandlersWhenSendingEventTest) {
-    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
-        celix_ei_expect_celix_longHashMap_put((void*)&celix_eventAdmin_sendEvent, 2, CELIX_ENOMEM);
-        auto status = celix_eventAdmin_sendEvent(ea, "org/celix/test", nullptr);
+        celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_addEventHandlerWithProperties, 3, CELIX_ENOMEM);
+        auto status = celix_eventAdmin_addEventHandlerWithProperties(ea, &handler, props);
         EXPECT_EQ(CELIX_SUCCESS, status);
-    }, [](void *handle, const char *topic, const celix_properties_t *props) {
-        (void)handle;
-        (void)props;
-        (void)topic;
-        ADD_FAILURE() << "Should not be called";
-        return CELIX_SUCCESS;
+
+        status = celix_eventAdmin_sendEvent(ea, "org/celix/test", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+
+        status = celix_eventAdmin_removeEventHandlerWithProperties(ea, &handler, props);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        celix_properties_destroy(props);
     });
 }
 
@@ -306,15 +319,16 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, SendEventToBlacklistHandlerTest)
 
 TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToPostEventTest) {
     TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
-        celix_ei_expect_calloc((void*)&celix_eventAdmin_postEvent, 2, nullptr);
+        celix_ei_expect_calloc((void*)&celix_eventPool_createEvent, 2, nullptr);
         auto status = celix_eventAdmin_postEvent(ea, "org/celix/test", nullptr);
         EXPECT_EQ(CELIX_ENOMEM, status);
 
-        celix_ei_expect_calloc((void*)&celix_event_create, 0, nullptr);
-        status = celix_eventAdmin_postEvent(ea, "org/celix/test", nullptr);
+        celix_ei_expect_calloc((void*)&celix_eventPool_assignEvent, 1, nullptr);
+        status = celix_eventAdmin_postEventWithoutCopy(ea, "org/celix/test", celix_properties_create());
         EXPECT_EQ(CELIX_ENOMEM, status);
 
-        celix_ei_expect_celix_arrayList_add((void*)&celix_eventAdmin_postEvent, 2, CELIX_ENOMEM);
+        //failed to allocate the event queue of the handler
+        celix_ei_expect_malloc((void*)&celix_eventAdmin_postEvent, 5, nullptr);
         status = celix_eventAdmin_postEvent(ea, "org/celix/test", nullptr);
         EXPECT_EQ(CELIX_ENOMEM, status);
     }, [](void *handle, const char *topic, const celix_properties_t *props) {
@@ -326,6 +340,25 @@ TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToPostEventTest) {
     });
 }
 
+TEST_F(CelixEventAdminErrorInjectionTestSuite, FailedToPostEventBatchTest) {
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        std::vector<const celix_properties_t*> props(100, nullptr);
+        celix_ei_expect_malloc((void*)&celix_eventAdmin_postEvents, 0, nullptr);
+        auto status = celix_eventAdmin_postEvents(ea, "org/celix/test", props.data(), props.size());
+        EXPECT_EQ(CELIX_ENOMEM, status);
+
+        celix_ei_expect_calloc((void*)&celix_eventPool_createEvent, 2, nullptr, 2);
+        status = celix_eventAdmin_postEvents(ea, "org/celix/test", props.data(), props.size());
+        EXPECT_EQ(CELIX_ENOMEM, status);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        (void)topic;
+        ADD_FAILURE() << "Should not be called";
+        return CELIX_SUCCESS;
+    });
+}
+
 TEST_F(CelixEventAdminErrorInjectionTestSuite, PostEventToBlacklistHandlerTest) {
     TestPublishEvent("org/celix/*", nullptr, [](celix_event_admin_t *ea) {
         celix_ei_expect_celix_elapsedtime(CELIX_EI_UNKNOWN_CALLER, 0, 61);
@@ -19,6 +19,7 @@
 #include <unistd.h>
 #include <semaphore.h>
 #include <cstdlib>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "CelixEventAdminTestSuiteBaseClass.h"
@@ -89,6 +90,18 @@ TEST_F(CelixEventAdminTestSuite, CreateEventAdminWithMaxHandlerThreadNrTest) {
     unsetenv("CELIX_EVENT_ADMIN_HANDLER_THREADS");
 }
 
+TEST_F(CelixEventAdminTestSuite, CreateEventAdminWithInvalidEventQueueConfigTest) {
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE", "0", 1);
+    auto ea = celix_eventAdmin_create(ctx.get());
+    EXPECT_TRUE(ea == nullptr);
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE");
+
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY", "invalid", 1);
+    ea = celix_eventAdmin_create(ctx.get());
+    EXPECT_TRUE(ea == nullptr);
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY");
+}
+
 TEST_F(CelixEventAdminTestSuite, StartStopEventAdminTest) {
     auto ea = celix_eventAdmin_create(ctx.get());
     EXPECT_TRUE(ea != nullptr);
@@ -557,8 +570,19 @@ TEST_F(CelixEventAdminTestSuite, EventHandlerWithInvalidFilterTopicTest) {
     });
 }
 
-TEST_F(CelixEventAdminTestSuite, PrefixTopicTooLongTest) {
-    TestSubscribeEvent("org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------/*");
+TEST_F(CelixEventAdminTestSuite, LongPrefixTopicTest) {
+    TestPublishEvent("org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------/*", nullptr, [](celix_event_admin_t *ea) {
+        auto status = celix_eventAdmin_sendEvent(ea, "org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------/test", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        EXPECT_STREQ("org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------/test", topic);
+        HandleEventDone();
+        return CELIX_SUCCESS;
+    });
 }
 
 TEST_F(CelixEventAdminTestSuite, SendEventWithInvalidArgumentsTest) {
@@ -576,11 +600,80 @@ TEST_F(CelixEventAdminTestSuite, SendEventWithInvalidArgumentsTest) {
     });
 }
 
-TEST_F(CelixEventAdminTestSuite, EventTopicTooLongForPrefixTopicHandlerTest) {
+TEST_F(CelixEventAdminTestSuite, LongEventTopicForPrefixTopicHandlerTest) {
     TestPublishEvent("org/celix/*", nullptr, [](celix_event_admin_t *ea) {
         const char *topic = "org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------";
         auto status = celix_eventAdmin_sendEvent(ea, topic, nullptr);
         EXPECT_EQ(CELIX_SUCCESS, status);
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        EXPECT_STREQ("org/celix/topic-too-long----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------", topic);
+        HandleEventDone();
+        return CELIX_SUCCESS;
+    });
+}
+
+static int g_handledEventCnt = 0;
+TEST_F(CelixEventAdminTestSuite, EventHandlerMatchingMultipleTopicsIsCalledOnceTest) {
+    g_handledEventCnt = 0;
+    TestPublishEvent("*,org/*,org/celix/*,org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        auto status = celix_eventAdmin_sendEvent(ea, "org/celix/test", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(1, g_handledEventCnt);
+        status = celix_eventAdmin_sendEvent(ea, "org/celix", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(2, g_handledEventCnt);
+        status = celix_eventAdmin_sendEvent(ea, "com/celix/test", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(3, g_handledEventCnt);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        (void)topic;
+        g_handledEventCnt++;
+        return CELIX_SUCCESS;
+    });
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventWithoutCopyTest) {
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        auto props = celix_properties_create();
+        celix_properties_set(props, "key", "value");
+        auto status = celix_eventAdmin_postEventWithoutCopy(ea, "org/celix/test", props);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        EXPECT_STREQ("org/celix/test", topic);
+        EXPECT_STREQ("value", celix_properties_get(props, "key", nullptr));
+        HandleEventDone();
+        return CELIX_SUCCESS;
+    });
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventWithoutCopyToNoHandlerTest) {
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        auto status = celix_eventAdmin_postEventWithoutCopy(ea, "org/celix/test1", celix_properties_create());
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        (void)topic;
+        ADD_FAILURE() << "Should not be called";
+        return CELIX_SUCCESS;
+    });
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventWithoutCopyWithInvalidArgumentsTest) {
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        auto status = celix_eventAdmin_postEventWithoutCopy(ea, nullptr, celix_properties_create());
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+        status = celix_eventAdmin_postEventWithoutCopy(nullptr, "org/celix/test", celix_properties_create());
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
     }, [](void *handle, const char *topic, const celix_properties_t *props) {
         (void)handle;
         (void)props;
@@ -626,6 +719,235 @@ TEST_F(CelixEventAdminTestSuite, AsyncEventQueueFullTest) {
     });
 }
 
+static std::vector<long> g_handledEventSeqs{};
+static long g_lastEventSeq = 9;
+static celix_status_t RecordEventSeq(void *handle, const char *topic, const celix_properties_t *props) {
+    (void)handle;
+    (void)topic;
+    while (g_blockingHandlerCalled) usleep(1000);
+    long seq = celix_properties_getAsLong(props, "seq", -1);
+    g_handledEventSeqs.push_back(seq);
+    if (seq == g_lastEventSeq) {
+        HandleEventDone();
+    }
+    return CELIX_SUCCESS;
+}
+
+static void PostSeqEvent(celix_event_admin_t *ea, long seq) {
+    auto props = celix_properties_create();
+    celix_properties_setLong(props, "seq", seq);
+    auto status = celix_eventAdmin_postEvent(ea, "org/celix/test", props);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    celix_properties_destroy(props);
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventsToOrderedHandlerInOrderTest) {
+    g_handledEventSeqs.clear();
+    g_lastEventSeq = 9;
+    g_blockingHandlerCalled = false;
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        for (int i = 0; i < 10; ++i) {
+            PostSeqEvent(ea, i);
+        }
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        EXPECT_EQ((std::vector<long>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), g_handledEventSeqs);
+    }, RecordEventSeq);
+}
+
+TEST_F(CelixEventAdminTestSuite, AsyncEventQueueFullWithDropOldestPolicyTest) {
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE", "4", 1);
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY", "drop_oldest", 1);
+    g_handledEventSeqs.clear();
+    g_lastEventSeq = 9;
+    g_blockingHandlerCalled = true;
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        PostSeqEvent(ea, 0);
+        usleep(30000);//wait for the handling of event 0
+        for (int i = 1; i < 10; ++i) {
+            PostSeqEvent(ea, i);
+        }
+        g_blockingHandlerCalled = false;
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        EXPECT_EQ((std::vector<long>{0, 6, 7, 8, 9}), g_handledEventSeqs);
+    }, RecordEventSeq);
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE");
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY");
+}
+
+TEST_F(CelixEventAdminTestSuite, AsyncEventQueueFullWithDropNewestPolicyTest) {
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE", "4", 1);
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY", "drop_newest", 1);
+    g_handledEventSeqs.clear();
+    g_lastEventSeq = 4;
+    g_blockingHandlerCalled = true;
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        PostSeqEvent(ea, 0);
+        usleep(30000);//wait for the handling of event 0
+        for (int i = 1; i < 10; ++i) {
+            PostSeqEvent(ea, i);
+        }
+        g_blockingHandlerCalled = false;
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        EXPECT_EQ((std::vector<long>{0, 1, 2, 3, 4}), g_handledEventSeqs);
+    }, RecordEventSeq);
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE");
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY");
+}
+
+static void PostSeqEvents(celix_event_admin_t *ea, long firstSeq, size_t size, celix_status_t expectedStatus = CELIX_SUCCESS) {
+    std::vector<celix_properties_t*> props{};
+    for (size_t i = 0; i < size; ++i) {
+        props.push_back(celix_properties_create());
+        celix_properties_setLong(props.back(), "seq", firstSeq + (long)i);
+    }
+    auto status = celix_eventAdmin_postEvents(ea, "org/celix/test", props.data(), props.size());
+    EXPECT_EQ(expectedStatus, status);
+    for (auto p : props) {
+        celix_properties_destroy(p);
+    }
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventBatchToOrderedHandlerInOrderTest) {
+    g_handledEventSeqs.clear();
+    g_lastEventSeq = 99;
+    g_blockingHandlerCalled = false;
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        PostSeqEvents(ea, 0, 100);
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        std::vector<long> expectedSeqs{};
+        for (long i = 0; i < 100; ++i) {
+            expectedSeqs.push_back(i);
+        }
+        EXPECT_EQ(expectedSeqs, g_handledEventSeqs);
+    }, RecordEventSeq);
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventBatchWithInvalidArgumentsTest) {
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        const celix_properties_t* props[] = {nullptr};
+        auto status = celix_eventAdmin_postEvents(ea, nullptr, props, 1);
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+        status = celix_eventAdmin_postEvents(nullptr, "org/celix/test", props, 1);
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+        status = celix_eventAdmin_postEvents(ea, "org/celix/test", nullptr, 1);
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+        status = celix_eventAdmin_postEvents(ea, "org/celix/test", nullptr, 0);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }, [](void *handle, const char *topic, const celix_properties_t *props) {
+        (void)handle;
+        (void)props;
+        (void)topic;
+        ADD_FAILURE() << "Should not be called";
+        return CELIX_SUCCESS;
+    });
+}
+
+TEST_F(CelixEventAdminTestSuite, PostEventBatchToFullEventQueueTest) {
+    setenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE", "4", 1);
+    g_handledEventSeqs.clear();
+    g_lastEventSeq = 3;
+    g_blockingHandlerCalled = true;
+    TestPublishEvent("org/celix/test", nullptr, [](celix_event_admin_t *ea) {
+        PostSeqEvents(ea, 0, 5, CELIX_ILLEGAL_STATE);//none of the events is posted
+        PostSeqEvents(ea, 0, 4);
+        g_blockingHandlerCalled = false;
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        EXPECT_EQ((std::vector<long>{0, 1, 2, 3}), g_handledEventSeqs);
+    }, RecordEventSeq);
+    unsetenv("CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE");
+}
+
+static std::vector<size_t> g_handledBatchSizes{};
+static bool g_syncEventHandled = false;
+TEST_F(CelixEventAdminTestSuite, PostEventsToBatchEventHandlerTest) {
+    g_handledEventSeqs.clear();
+    g_handledBatchSizes.clear();
+    g_lastEventSeq = 99;
+    g_blockingHandlerCalled = true;
+    g_syncEventHandled = false;
+    TestEventAdmin([](celix_event_admin_t *ea, celix_bundle_context_t *ctx) {
+        (void)ctx;
+        celix_event_handler_service_t handler{};
+        handler.handle = nullptr;
+        handler.handleEvent = [](void *handle, const char *topic, const celix_properties_t *props) {
+            (void)handle;
+            (void)props;
+            EXPECT_STREQ("org/celix/test", topic);
+            g_syncEventHandled = true;
+            return CELIX_SUCCESS;
+        };
+        handler.handleEvents = [](void *handle, const celix_event_entry_t *events, size_t size) {
+            g_handledBatchSizes.push_back(size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_STREQ("org/celix/test", events[i].topic);
+                RecordEventSeq(handle, events[i].topic, events[i].properties);
+            }
+            return CELIX_SUCCESS;
+        };
+        auto props = celix_properties_create();
+        celix_properties_set(props, CELIX_EVENT_TOPIC, "org/celix/test");
+        celix_properties_setLong(props, CELIX_EVENT_BATCH_SIZE, 8);
+        celix_properties_setLong(props, CELIX_FRAMEWORK_SERVICE_ID, 123);
+        auto status = celix_eventAdmin_addEventHandlerWithProperties(ea, &handler, props);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+
+        PostSeqEvents(ea, 0, 50);
+        PostSeqEvent(ea, 50);
+        PostSeqEvents(ea, 51, 49);
+        g_blockingHandlerCalled = false;
+        auto eventDone = WaitForEventDone(30);
+        EXPECT_TRUE(eventDone);
+        std::vector<long> expectedSeqs{};
+        for (long i = 0; i < 100; ++i) {
+            expectedSeqs.push_back(i);
+        }
+        EXPECT_EQ(expectedSeqs, g_handledEventSeqs);
+        for (auto size : g_handledBatchSizes) {
+            EXPECT_LE(size, 8u);
+        }
+        EXPECT_LT(g_handledBatchSizes.size(), 100u);
+        EXPECT_FALSE(g_syncEventHandled);
+
+        //sync events are delivered with handleEvent
+        status = celix_eventAdmin_sendEvent(ea, "org/celix/test", nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_TRUE(g_syncEventHandled);
+
+        status = celix_eventAdmin_removeEventHandlerWithProperties(ea, &handler, props);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        celix_properties_destroy(props);
+    });
+}
+
+TEST_F(CelixEventAdminTestSuite, AddBatchEventHandlerWithoutHandleEventsTest) {
+    TestEventAdmin([](celix_event_admin_t *ea, celix_bundle_context_t *ctx) {
+        (void)ctx;
+        celix_event_handler_service_t handler{};
+        handler.handle = nullptr;
+        handler.handleEvent = [](void *handle, const char *topic, const celix_properties_t *props) {
+            (void)handle;
+            (void)props;
+            (void)topic;
+            return CELIX_SUCCESS;
+        };
+        handler.handleEvents = nullptr;
+        auto props = celix_properties_create();
+        celix_properties_set(props, CELIX_EVENT_TOPIC, "org/celix/test");
+        celix_properties_setLong(props, CELIX_EVENT_BATCH_SIZE, 8);
+        celix_properties_setLong(props, CELIX_FRAMEWORK_SERVICE_ID, 123);
+        auto status = celix_eventAdmin_addEventHandlerWithProperties(ea, &handler, props);
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+        status = celix_eventAdmin_removeEventHandlerWithProperties(ea, &handler, props);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        celix_properties_destroy(props);
+    });
+}
+
 TEST_F(CelixEventAdminTestSuite, RemoveEventHandlerAfterEventAdminStopTest) {
     g_blockingHandlerCalled = true;
     celix_event_handler_service_t handler;
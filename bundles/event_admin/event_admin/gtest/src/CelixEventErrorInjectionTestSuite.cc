@@ -19,8 +19,10 @@
 #include "celix_event.h"
 #include "celix_properties_ei.h"
 #include "celix_utils_ei.h"
+#include "celix_threads_ei.h"
 #include "malloc_ei.h"
 #include <gtest/gtest.h>
+#include <string>
 
 class CelixEventErrorInjectionTestSuite : public ::testing::Test {
 public:
@@ -30,6 +32,7 @@ public:
         celix_ei_expect_celix_properties_copy(nullptr, 0, nullptr);
         celix_ei_expect_calloc(nullptr, 0, nullptr);
         celix_ei_expect_celix_utils_strdup(nullptr, 0, nullptr);
+        celix_ei_expect_celixThreadMutex_create(nullptr, 0, 0);
     }
 };
 
@@ -37,19 +40,44 @@ TEST_F(CelixEventErrorInjectionTestSuite, FailedToCopyEventPropertiesTest) {
     std::unique_ptr<celix_properties_t, decltype(&celix_properties_destroy)> properties{celix_properties_create(),
                                                                                         celix_properties_destroy};
     celix_properties_set(properties.get(), "key", "value");
-    celix_ei_expect_celix_properties_copy((void*)&celix_event_create, 0, nullptr);
+    celix_ei_expect_celix_properties_copy((void*)&celix_event_create, 1, nullptr);
     celix_event_t *event = celix_event_create("test_topic", properties.get());
     EXPECT_TRUE(event == nullptr);
 }
 
 TEST_F(CelixEventErrorInjectionTestSuite, FailedToAllocMemoryForEventTest) {
-    celix_ei_expect_calloc((void*)&celix_event_create, 0, nullptr);
-    celix_event_t *event = celix_event_create(nullptr, nullptr);
+    celix_ei_expect_calloc((void*)&celix_event_create, 3, nullptr);
+    celix_event_t *event = celix_event_create("test_topic", nullptr);
     EXPECT_TRUE(event == nullptr);
 }
 
 TEST_F(CelixEventErrorInjectionTestSuite, FailedToAllocMemoryForTopicTest) {
-    celix_ei_expect_celix_utils_strdup(nullptr, 0, nullptr);
-    celix_event_t *event = celix_event_create(nullptr, nullptr);
+    std::string topic(256, 'a');
+    celix_ei_expect_celix_utils_strdup(CELIX_EI_UNKNOWN_CALLER, 0, nullptr);
+    celix_event_t *event = celix_event_create(topic.c_str(), nullptr);
+    EXPECT_TRUE(event == nullptr);
+
+    //the event is returned to the pool
+    celix_autoptr(celix_event_pool_t) pool = celix_eventPool_create(1);
+    ASSERT_TRUE(pool != nullptr);
+    celix_ei_expect_celix_utils_strdup(CELIX_EI_UNKNOWN_CALLER, 0, nullptr);
+    event = celix_eventPool_createEvent(pool, topic.c_str(), nullptr);
+    EXPECT_TRUE(event == nullptr);
+}
+
+TEST_F(CelixEventErrorInjectionTestSuite, FailedToCreateEventPoolTest) {
+    celix_ei_expect_calloc((void*)&celix_eventPool_create, 0, nullptr);
+    celix_event_pool_t* pool = celix_eventPool_create(1);
+    EXPECT_TRUE(pool == nullptr);
+
+    celix_ei_expect_celixThreadMutex_create((void*)&celix_eventPool_create, 0, CELIX_ENOMEM);
+    pool = celix_eventPool_create(1);
+    EXPECT_TRUE(pool == nullptr);
+}
+
+TEST_F(CelixEventErrorInjectionTestSuite, FailedToAssignEventTest) {
+    celix_ei_expect_calloc((void*)&celix_eventPool_assignEvent, 1, nullptr);
+    celix_properties_t* properties = celix_properties_create();
+    celix_event_t *event = celix_eventPool_assignEvent(nullptr, "test_topic", properties);//properties are destroyed
     EXPECT_TRUE(event == nullptr);
 }
\ No newline at end of file
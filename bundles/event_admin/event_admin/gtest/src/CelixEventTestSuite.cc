@@ -18,6 +18,7 @@
  */
 #include "celix_event.h"
 #include <gtest/gtest.h>
+#include <string>
 
 class CelixEventTestSuite : public ::testing::Test {
 public:
@@ -43,3 +44,57 @@ TEST_F(CelixEventTestSuite, CreateEventWithoutPropertiesTest) {
     EXPECT_TRUE(celix_event_getProperties(event) == nullptr);
     celix_event_release(event);
 }
+
+TEST_F(CelixEventTestSuite, CreateEventWithLongTopicTest) {
+    std::string topic(256, 'a');
+    celix_event_t *event = celix_event_create(topic.c_str(), nullptr);
+    EXPECT_TRUE(event != nullptr);
+    EXPECT_STREQ(topic.c_str(), celix_event_getTopic(event));
+    celix_event_release(event);
+}
+
+TEST_F(CelixEventTestSuite, CreateEventWithInvalidTopicTest) {
+    celix_event_t *event = celix_event_create(nullptr, nullptr);
+    EXPECT_TRUE(event == nullptr);
+}
+
+TEST_F(CelixEventTestSuite, CreateEventFromPoolTest) {
+    celix_autoptr(celix_event_pool_t) pool = celix_eventPool_create(1);
+    ASSERT_TRUE(pool != nullptr);
+
+    celix_autoptr(celix_properties_t) properties = celix_properties_create();
+    celix_properties_set(properties, "key", "value");
+    celix_event_t *event1 = celix_eventPool_createEvent(pool, "test_topic", properties);
+    ASSERT_TRUE(event1 != nullptr);
+    celix_event_t *event2 = celix_eventPool_createEvent(pool, "test_topic2", nullptr);
+    ASSERT_TRUE(event2 != nullptr);
+    EXPECT_STREQ("value", celix_properties_get(celix_event_getProperties(event1), "key", nullptr));
+    EXPECT_NE(properties, celix_event_getProperties(event1));
+    celix_event_release(event1);
+    celix_event_release(event2);//pool is full, event2 is freed
+
+    //the pooled event is reused
+    celix_event_t *event3 = celix_eventPool_createEvent(pool, "test_topic3", nullptr);
+    EXPECT_EQ(event1, event3);
+    EXPECT_STREQ("test_topic3", celix_event_getTopic(event3));
+    EXPECT_TRUE(celix_event_getProperties(event3) == nullptr);
+    celix_event_release(event3);
+}
+
+TEST_F(CelixEventTestSuite, AssignEventFromPoolTest) {
+    celix_autoptr(celix_event_pool_t) pool = celix_eventPool_create(8);
+    ASSERT_TRUE(pool != nullptr);
+
+    celix_properties_t* properties = celix_properties_create();
+    celix_properties_set(properties, "key", "value");
+    celix_event_t *event = celix_eventPool_assignEvent(pool, "test_topic", properties);
+    ASSERT_TRUE(event != nullptr);
+    EXPECT_EQ(properties, celix_event_getProperties(event));
+    EXPECT_STREQ("test_topic", celix_event_getTopic(event));
+    celix_event_release(event);
+
+    //properties are destroyed if the event can not be created
+    properties = celix_properties_create();
+    event = celix_eventPool_assignEvent(pool, nullptr, properties);
+    EXPECT_TRUE(event == nullptr);
+}
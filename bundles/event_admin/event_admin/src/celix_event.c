@@ -23,42 +23,132 @@
 #include <string.h>
 
 #include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
 #include "celix_ref.h"
 #include "celix_utils.h"
 
+#define CELIX_EVENT_TOPIC_BUFFER_SIZE 128
+
 struct celix_event {
     struct celix_ref ref;
-    char* topic;
+    celix_event_pool_t* pool;
+    celix_event_t* nextPooledEvent;
+    char* topic;//points to topicBuffer if the topic fits, otherwise to a heap copy
     celix_properties_t* properties;
+    char topicBuffer[CELIX_EVENT_TOPIC_BUFFER_SIZE];
 };
 
-celix_event_t* celix_event_create(const char* topic, const celix_properties_t* properties) {
-    celix_autoptr(celix_properties_t) props = NULL;
-    if (properties != NULL && (props = celix_properties_copy(properties)) == NULL) {
+struct celix_event_pool {
+    celix_thread_mutex_t mutex;//protects pooledEvents and pooledEventCnt
+    celix_event_t* pooledEvents;
+    size_t pooledEventCnt;
+    size_t maxPooledEvents;
+};
+
+celix_event_pool_t* celix_eventPool_create(size_t maxPooledEvents) {
+    celix_autofree celix_event_pool_t* pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
         return NULL;
     }
-    celix_autofree celix_event_t* event = calloc(1, sizeof(*event));
-    if (event == NULL) {
+    if (celixThreadMutex_create(&pool->mutex, NULL) != CELIX_SUCCESS) {
         return NULL;
     }
-    event->properties = props;
-    event->topic = celix_utils_strdup(topic);
-    if (event->topic == NULL) {
+    pool->pooledEvents = NULL;
+    pool->pooledEventCnt = 0;
+    pool->maxPooledEvents = maxPooledEvents;
+    return celix_steal_ptr(pool);
+}
+
+void celix_eventPool_destroy(celix_event_pool_t* pool) {
+    if (pool != NULL) {
+        celix_event_t* event = pool->pooledEvents;
+        while (event != NULL) {
+            celix_event_t* next = event->nextPooledEvent;
+            free(event);
+            event = next;
+        }
+        celixThreadMutex_destroy(&pool->mutex);
+        free(pool);
+    }
+    return;
+}
+
+static void celix_eventPool_releaseEvent(celix_event_pool_t* pool, celix_event_t* event) {
+    if (pool != NULL) {
+        celixThreadMutex_lock(&pool->mutex);
+        if (pool->pooledEventCnt < pool->maxPooledEvents) {
+            event->nextPooledEvent = pool->pooledEvents;
+            pool->pooledEvents = event;
+            pool->pooledEventCnt++;
+            event = NULL;
+        }
+        celixThreadMutex_unlock(&pool->mutex);
+    }
+    free(event);
+    return;
+}
+
+static celix_event_t* celix_eventPool_allocEvent(celix_event_pool_t* pool, const char* topic) {
+    if (topic == NULL) {
+        return NULL;
+    }
+    celix_event_t* event = NULL;
+    if (pool != NULL) {
+        celixThreadMutex_lock(&pool->mutex);
+        event = pool->pooledEvents;
+        if (event != NULL) {
+            pool->pooledEvents = event->nextPooledEvent;
+            pool->pooledEventCnt--;
+        }
+        celixThreadMutex_unlock(&pool->mutex);
+    }
+    if (event == NULL && (event = calloc(1, sizeof(*event))) == NULL) {
         return NULL;
     }
+    size_t topicLen = strlen(topic);
+    if (topicLen < sizeof(event->topicBuffer)) {
+        memcpy(event->topicBuffer, topic, topicLen + 1);
+        event->topic = event->topicBuffer;
+    } else if ((event->topic = celix_utils_strdup(topic)) == NULL) {
+        celix_eventPool_releaseEvent(pool, event);
+        return NULL;
+    }
+    event->pool = pool;
+    event->nextPooledEvent = NULL;
+    event->properties = NULL;
     celix_ref_init(&event->ref);
-    celix_steal_ptr(props);
-    return celix_steal_ptr(event);
+    return event;
+}
+
+celix_event_t* celix_eventPool_createEvent(celix_event_pool_t* pool, const char* topic, const celix_properties_t* properties) {
+    celix_autoptr(celix_properties_t) props = NULL;
+    if (properties != NULL && (props = celix_properties_copy(properties)) == NULL) {
+        return NULL;
+    }
+    return celix_eventPool_assignEvent(pool, topic, celix_steal_ptr(props));
+}
+
+celix_event_t* celix_eventPool_assignEvent(celix_event_pool_t* pool, const char* topic, celix_properties_t* properties) {
+    celix_autoptr(celix_properties_t) props = properties;
+    celix_event_t* event = celix_eventPool_allocEvent(pool, topic);
+    if (event == NULL) {
+        return NULL;
+    }
+    event->properties = celix_steal_ptr(props);
+    return event;
+}
+
+celix_event_t* celix_event_create(const char* topic, const celix_properties_t* properties) {
+    return celix_eventPool_createEvent(NULL, topic, properties);
 }
 
 static bool celix_event_releaseCb(struct celix_ref* ref) {
     celix_event_t* event = (celix_event_t*)ref;
     celix_properties_destroy(event->properties);
-    free(event->topic);
-    free(event);
+    celix_utils_freeStringIfNotEqual(event->topicBuffer, event->topic);
+    celix_eventPool_releaseEvent(event->pool, event);
     return true;
 }
-
 void celix_event_release(celix_event_t* event) {
     if (event != NULL) {
         celix_ref_put(&event->ref, celix_event_releaseCb);
@@ -28,6 +28,8 @@ extern "C" {
 
 typedef struct celix_event celix_event_t;
 
+typedef struct celix_event_pool celix_event_pool_t;
+
 
 celix_event_t* celix_event_create(const char* topic, const celix_properties_t* properties);
 
@@ -35,6 +37,28 @@ void celix_event_release(celix_event_t* event);
 
 CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_t, celix_event_release);
 
+/**
+ * @brief Creates a pool of event objects. Released events are kept in the pool (at most maxPooledEvents) and reused
+ * by celix_eventPool_createEvent/celix_eventPool_assignEvent.
+ * @note The pool must outlive the events created from it.
+ */
+celix_event_pool_t* celix_eventPool_create(size_t maxPooledEvents);
+
+void celix_eventPool_destroy(celix_event_pool_t* pool);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_pool_t, celix_eventPool_destroy);
+
+/**
+ * @brief Creates an event from the pool with a copy of the properties.
+ */
+celix_event_t* celix_eventPool_createEvent(celix_event_pool_t* pool, const char* topic, const celix_properties_t* properties);
+
+/**
+ * @brief Creates an event from the pool, which takes ownership of the properties.
+ * The properties are destroyed, also if creating the event fails.
+ */
+celix_event_t* celix_eventPool_assignEvent(celix_event_pool_t* pool, const char* topic, celix_properties_t* properties);
+
 const char* celix_event_getTopic(const celix_event_t* event);
 
 const celix_properties_t* celix_event_getProperties(const celix_event_t* event);
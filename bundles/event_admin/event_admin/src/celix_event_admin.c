@@ -36,49 +36,90 @@
 
 #define CELIX_EVENT_ADMIN_MAX_HANDLER_THREADS 20
 #define CELIX_EVENT_ADMIN_HANDLER_THREADS_DEFAULT 5
+#define CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE_DEFAULT 512 //events per event handler
+#define CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY_DEFAULT CELIX_EVENT_ADMIN_DROP_POLICY_REJECT
+
+#define CELIX_EVENT_ADMIN_DROP_POLICY_REJECT "reject"
+#define CELIX_EVENT_ADMIN_DROP_POLICY_DROP_OLDEST "drop_oldest"
+#define CELIX_EVENT_ADMIN_DROP_POLICY_DROP_NEWEST "drop_newest"
 
 //Belows parameters are not configurable, consider its configurability until a real need arises.
 #define CELIX_EVENT_ADMIN_MAX_PARALLEL_EVENTS_OF_HANDLER(handlerThNr) ((handlerThNr)/3 + 1) //max parallel async event for a single handler
 #define CELIX_EVENT_ADMIN_MAX_HANDLE_EVENT_TIME 60 //seconds
-#define CELIX_EVENT_ADMIN_MAX_EVENT_QUEUE_SIZE 512 //events
+#define CELIX_EVENT_ADMIN_EVENT_QUEUE_INITIAL_CAPACITY 16 //events
+#define CELIX_EVENT_ADMIN_TOPIC_SEGMENT_BUFFER_SIZE 128 //topic segments which do not fit are copied to the heap
+#define CELIX_EVENT_ADMIN_EVENT_BATCH_BUFFER_SIZE 64 //events, the events of larger posted batches are collected on the heap
+#define CELIX_EVENT_ADMIN_MAX_HANDLER_BATCH_SIZE 64 //max events per handleEvents call
+
+typedef enum celix_event_admin_drop_policy {
+    CELIX_EVENT_ADMIN_DROP_POLICY_REJECT_E, //reject the event if the event queue of any target handler is full
+    CELIX_EVENT_ADMIN_DROP_POLICY_DROP_OLDEST_E, //drop the oldest pending event of the handler whose event queue is full
+    CELIX_EVENT_ADMIN_DROP_POLICY_DROP_NEWEST_E, //drop the new event for the handler whose event queue is full
+} celix_event_admin_drop_policy_e;
+
+typedef struct celix_event_queue {
+    celix_event_t** events;//ring buffer, grows on demand up to the configured event queue size
+    size_t capacity;
+    size_t head;
+    size_t size;
+} celix_event_queue_t;
 
 typedef struct celix_event_handler {
     celix_event_handler_service_t* service;
     long serviceId;
     const char* serviceDescription;
     bool asyncOrdered;
+    size_t batchSize;//max events per delivery, events are delivered with handleEvents if it is greater than 1
     celix_filter_t* eventFilter;
     bool blackListed;//Blacklisted handlers must not be notified of any events.
+    unsigned long topicTreeMark;//used to de-duplicate the handlers of a topic node, protected by celix_event_admin_t::lock
+    //Belows are protected by celix_event_admin_t::eventsMutex
+    celix_event_queue_t asyncEventQueue;//pending async events of the handler, in post order
     unsigned int handlingAsyncEventCnt;
+    size_t droppedEventCnt;
+    bool ready;//whether the handler is in the ready handler queue
+    struct celix_event_handler* prevReady;
+    struct celix_event_handler* nextReady;
 }celix_event_handler_t;
 
-typedef struct celix_event_channel {
-    celix_array_list_t* eventHandlerSvcIdList;
-}celix_event_channel_t;
-
-typedef struct celix_event_entry {
-    celix_event_t* event;
-    celix_long_hash_map_t* eventHandlers;//key: event handler service id, value: null
-}celix_event_entry_t;
+/**
+ * @brief A node of the topic tree. Every node represents a topic, the children of a node are the topics with one
+ * more topic segment. The handler sets of the nodes are pre-merged and de-duplicated when the subscriptions change,
+ * so that the event handlers for an event topic are found with a single walk of the topic tree.
+ */
+typedef struct celix_event_topic_node {
+    celix_string_hash_map_t* children;//key: topic segment, value: celix_event_topic_node_t*
+    celix_array_list_t* topicHandlers;//array_list<celix_event_handler_t*>, handlers subscribed to the topic of the node
+    celix_array_list_t* prefixHandlers;//array_list<celix_event_handler_t*>, handlers subscribed to "<topic of the node>/*". For the root node, the handlers subscribed to "*"
+    celix_array_list_t* matchingHandlers;//array_list<celix_event_handler_t*>, cached handlers for events with the topic of the node
+    celix_array_list_t* descendantHandlers;//array_list<celix_event_handler_t*>, cached handlers for events with a topic below the node, which has no own node
+}celix_event_topic_node_t;
 
 struct celix_event_admin {
     celix_bundle_context_t* ctx;
     celix_log_helper_t* logHelper;
     unsigned int handlerThreadNr;
-    celix_thread_rwlock_t lock;//projects: channels,eventHandlers
-    celix_event_channel_t channelMatchingAllEvents;
-    celix_string_hash_map_t* channelsMatchingTopic; //key: topic, value: celix_event_channel_t *
-    celix_string_hash_map_t* channelsMatchingPrefixTopic;//key:prefix topic, value: celix_event_channel_t *
+    size_t eventQueueSize;
+    celix_event_admin_drop_policy_e dropPolicy;
+    celix_thread_rwlock_t lock;//projects: topicTree,eventHandlers
+    celix_event_topic_node_t* topicTree;
+    unsigned long topicTreeMark;
     celix_long_hash_map_t* eventHandlers;//key: event handler service id, value: celix_event_handler_t*
-    celix_thread_mutex_t eventsMutex;// protect belows
+    celix_event_pool_t* eventPool;//reused event objects of the async events
+    celix_thread_mutex_t eventsMutex;// protect belows and the async event queues of the event handlers
     celix_thread_cond_t eventsTriggerCond;
-    celix_array_list_t* asyncEventQueue;//array_list<celix_event_entry_t*>
+    celix_event_handler_t* readyHandlersHead;//FIFO of handlers which have pending events and can handle an event now
+    celix_event_handler_t* readyHandlersTail;
+    unsigned int idleThreadCnt;//number of event handler threads waiting for a ready handler
     bool threadsRunning;
     celix_thread_t eventHandlerThreads[CELIX_EVENT_ADMIN_MAX_HANDLER_THREADS];
 };
 
 static void* celix_eventAdmin_deliverEventThread(void* data);
-static void onAsyncEventQueueRemoved(void* value);
+static celix_event_topic_node_t* celix_eventAdmin_createTopicNode(void);
+static void celix_eventAdmin_destroyTopicNode(celix_event_topic_node_t* node);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_topic_node_t, celix_eventAdmin_destroyTopicNode)
 
 celix_event_admin_t* celix_eventAdmin_create(celix_bundle_context_t* ctx) {
     celix_autofree celix_event_admin_t* ea = calloc(1, sizeof(*ea));
@@ -97,36 +138,47 @@ celix_event_admin_t* celix_eventAdmin_create(celix_bundle_context_t* ctx) {
         celix_logHelper_error(logHelper, "CELIX_EVENT_ADMIN_HANDLER_THREADS is set to %i, but max is %i.", ea->handlerThreadNr, CELIX_EVENT_ADMIN_MAX_HANDLER_THREADS);
         return NULL;
     }
-    celix_status_t status = celixThreadRwlock_create(&ea->lock, NULL);
-    if (status != CELIX_SUCCESS) {
-        celix_logHelper_error(logHelper, "Failed to create event admin lock.");
+    long eventQueueSize = celix_bundleContext_getPropertyAsLong(ctx, "CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE", CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE_DEFAULT);
+    if (eventQueueSize <= 0) {
+        celix_logHelper_error(logHelper, "CELIX_EVENT_ADMIN_EVENT_QUEUE_SIZE is set to %li, but it must be greater than 0.", eventQueueSize);
         return NULL;
     }
-    celix_autoptr(celix_thread_rwlock_t) lock = &ea->lock;
-    celix_autoptr(celix_array_list_t) channelMatchingAllEvents = ea->channelMatchingAllEvents.eventHandlerSvcIdList = celix_arrayList_create();
-    if (channelMatchingAllEvents == NULL) {
-        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(logHelper, "Failed to create event channel matching all events.");
+    ea->eventQueueSize = (size_t)eventQueueSize;
+    const char* dropPolicy = celix_bundleContext_getProperty(ctx, "CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY", CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY_DEFAULT);
+    if (celix_utils_stringEquals(dropPolicy, CELIX_EVENT_ADMIN_DROP_POLICY_REJECT)) {
+        ea->dropPolicy = CELIX_EVENT_ADMIN_DROP_POLICY_REJECT_E;
+    } else if (celix_utils_stringEquals(dropPolicy, CELIX_EVENT_ADMIN_DROP_POLICY_DROP_OLDEST)) {
+        ea->dropPolicy = CELIX_EVENT_ADMIN_DROP_POLICY_DROP_OLDEST_E;
+    } else if (celix_utils_stringEquals(dropPolicy, CELIX_EVENT_ADMIN_DROP_POLICY_DROP_NEWEST)) {
+        ea->dropPolicy = CELIX_EVENT_ADMIN_DROP_POLICY_DROP_NEWEST_E;
+    } else {
+        celix_logHelper_error(logHelper, "Unknown CELIX_EVENT_ADMIN_EVENT_QUEUE_DROP_POLICY %s.", dropPolicy);
         return NULL;
     }
-    celix_autoptr(celix_string_hash_map_t) channelsMatchingTopic = ea->channelsMatchingTopic = celix_stringHashMap_create();
-    if (channelsMatchingTopic == NULL) {
-        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(logHelper, "Failed to create event channels matching topic.");
+    celix_status_t status = celixThreadRwlock_create(&ea->lock, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create event admin lock.");
         return NULL;
     }
-    celix_autoptr(celix_string_hash_map_t) channelsMatchingPrefixTopic = ea->channelsMatchingPrefixTopic = celix_stringHashMap_create();
-    if (channelsMatchingPrefixTopic == NULL) {
+    celix_autoptr(celix_thread_rwlock_t) lock = &ea->lock;
+    celix_autoptr(celix_event_topic_node_t) topicTree = ea->topicTree = celix_eventAdmin_createTopicNode();
+    if (topicTree == NULL) {
         celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(logHelper, "Failed to create event channels matching prefix topic.");
+        celix_logHelper_error(logHelper, "Failed to create event topic tree.");
         return NULL;
     }
+    ea->topicTreeMark = 0;
     celix_autoptr(celix_long_hash_map_t) eventHandlers = ea->eventHandlers = celix_longHashMap_create();
     if (eventHandlers == NULL) {
         celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
         celix_logHelper_error(logHelper, "Failed to create event handler map.");
         return NULL;
     }
+    celix_autoptr(celix_event_pool_t) eventPool = ea->eventPool = celix_eventPool_create(ea->eventQueueSize);
+    if (eventPool == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create event pool.");
+        return NULL;
+    }
 
     status = celixThreadMutex_create(&ea->eventsMutex, NULL);
     if (status != CELIX_SUCCESS) {
@@ -140,24 +192,15 @@ celix_event_admin_t* celix_eventAdmin_create(celix_bundle_context_t* ctx) {
         return NULL;
     }
     celix_autoptr(celix_thread_cond_t) cond = &ea->eventsTriggerCond;
+    ea->readyHandlersHead = NULL;
+    ea->readyHandlersTail = NULL;
+    ea->idleThreadCnt = 0;
 
-    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
-    opts.elementType = CELIX_ARRAY_LIST_ELEMENT_TYPE_POINTER;
-    opts.simpleRemovedCallback = onAsyncEventQueueRemoved;
-    celix_autoptr(celix_array_list_t) asyncEventQueue = ea->asyncEventQueue = celix_arrayList_createWithOptions(&opts);
-    if (asyncEventQueue == NULL) {
-        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(logHelper, "Failed to create async event queue.");
-        return NULL;
-    }
-
-    celix_steal_ptr(asyncEventQueue);
     celix_steal_ptr(cond);
     celix_steal_ptr(mutex);
+    celix_steal_ptr(eventPool);
     celix_steal_ptr(eventHandlers);
-    celix_steal_ptr(channelsMatchingPrefixTopic);
-    celix_steal_ptr(channelsMatchingTopic);
-    celix_steal_ptr(channelMatchingAllEvents);
+    celix_steal_ptr(topicTree);
     celix_steal_ptr(lock);
     celix_steal_ptr(logHelper);
 
@@ -201,110 +244,330 @@ int celix_eventAdmin_stop(celix_event_admin_t* ea) {
 
 void celix_eventAdmin_destroy(celix_event_admin_t* ea) {
     assert(ea != NULL);
-    celix_arrayList_destroy(ea->asyncEventQueue);
     celixThreadCondition_destroy(&ea->eventsTriggerCond);
     celixThreadMutex_destroy(&ea->eventsMutex);
+    celix_eventPool_destroy(ea->eventPool);
     assert(celix_longHashMap_size(ea->eventHandlers) == 0);
     celix_longHashMap_destroy(ea->eventHandlers);
-    assert(celix_stringHashMap_size(ea->channelsMatchingPrefixTopic) == 0);
-    celix_stringHashMap_destroy(ea->channelsMatchingPrefixTopic);
-    assert(celix_stringHashMap_size(ea->channelsMatchingTopic) == 0);
-    celix_stringHashMap_destroy(ea->channelsMatchingTopic);
-    celix_arrayList_destroy(ea->channelMatchingAllEvents.eventHandlerSvcIdList);
+    assert(celix_stringHashMap_size(ea->topicTree->children) == 0);
+    assert(celix_arrayList_size(ea->topicTree->prefixHandlers) == 0);
+    celix_eventAdmin_destroyTopicNode(ea->topicTree);
     celixThreadRwlock_destroy(&ea->lock);
     celix_logHelper_destroy(ea->logHelper);
     free(ea);
     return;
 }
 
-static void onAsyncEventQueueRemoved(void* value) {
-    celix_event_entry_t *entry = value;
-    celix_event_release(entry->event);
-    celix_longHashMap_destroy(entry->eventHandlers);
-    free(entry);
-}
-
-static void celix_eventAdmin_addEventHandlerToChannels(celix_event_admin_t* ea, const char* topic,
-                                                       celix_event_handler_t* eventHandler, celix_string_hash_map_t* channels) {
-    celix_event_channel_t* channel = celix_stringHashMap_get(channels, topic);
-    if (channel == NULL) {
-        celix_autofree celix_event_channel_t *_channel = channel = calloc(1, sizeof(*channel));
-        if (_channel == NULL) {
-            celix_logHelper_error(ea->logHelper, "Failed to create event channel for topic %s", topic);
-            return;
+static celix_status_t celix_eventQueue_push(celix_event_queue_t* queue, celix_event_t* event, size_t maxSize) {
+    if (queue->size == queue->capacity) {
+        size_t newCapacity = queue->capacity == 0 ? CELIX_EVENT_ADMIN_EVENT_QUEUE_INITIAL_CAPACITY : queue->capacity * 2;
+        if (newCapacity > maxSize) {
+            newCapacity = maxSize;
         }
-        celix_autoptr(celix_array_list_t) eventHandlerSvcIdList = channel->eventHandlerSvcIdList = celix_arrayList_create();
-        if (eventHandlerSvcIdList == NULL) {
-            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-            celix_logHelper_error(ea->logHelper, "Failed to create event handlers list for topic %s", topic);
-            return;
-        }
-        if (celix_arrayList_addLong(channel->eventHandlerSvcIdList, eventHandler->serviceId) != CELIX_SUCCESS) {
-            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-            celix_logHelper_error(ea->logHelper, "Failed to subscribe %s for event handler(%s).", topic, eventHandler->serviceDescription);
-            return;
+        celix_event_t** events = malloc(newCapacity * sizeof(*events));
+        if (events == NULL) {
+            return CELIX_ENOMEM;
         }
-        if (celix_stringHashMap_put(channels, topic, channel) != CELIX_SUCCESS) {
-            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-            celix_logHelper_error(ea->logHelper, "Failed to add event channel for topic %s", topic);
-            return;
+        for (size_t i = 0; i < queue->size; ++i) {
+            events[i] = queue->events[(queue->head + i) % queue->capacity];
         }
-        celix_steal_ptr(eventHandlerSvcIdList);
-        celix_steal_ptr(_channel);
-    } else if (celix_arrayList_addLong(channel->eventHandlerSvcIdList, eventHandler->serviceId) != CELIX_SUCCESS) {
+        free(queue->events);
+        queue->events = events;
+        queue->capacity = newCapacity;
+        queue->head = 0;
+    }
+    queue->events[(queue->head + queue->size) % queue->capacity] = celix_event_retain(event);
+    queue->size++;
+    return CELIX_SUCCESS;
+}
+
+static celix_event_t* celix_eventQueue_pop(celix_event_queue_t* queue) {
+    if (queue->size == 0) {
+        return NULL;
+    }
+    celix_event_t* event = queue->events[queue->head];
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->size--;
+    return event;
+}
+
+static void celix_eventQueue_clear(celix_event_queue_t* queue) {
+    celix_event_t* event;
+    while ((event = celix_eventQueue_pop(queue)) != NULL) {
+        celix_event_release(event);
+    }
+    free(queue->events);
+    queue->events = NULL;
+    queue->capacity = 0;
+    queue->head = 0;
+}
+
+/**
+ * @brief Adds the handler to the tail of the ready handler queue if it has pending events and can handle an event now.
+ * Must be called with eventsMutex locked.
+ * @return true if the handler is added to the ready handler queue.
+ */
+static bool celix_eventAdmin_scheduleHandler(celix_event_admin_t* ea, celix_event_handler_t* handler) {
+    if (handler->ready || handler->asyncEventQueue.size == 0) {
+        return false;
+    }
+    unsigned int handlingEventCnt = handler->handlingAsyncEventCnt;
+    if (handlingEventCnt != 0 && (handler->asyncOrdered || handlingEventCnt >= CELIX_EVENT_ADMIN_MAX_PARALLEL_EVENTS_OF_HANDLER(ea->handlerThreadNr))) {
+        return false;
+    }
+    handler->ready = true;
+    handler->nextReady = NULL;
+    handler->prevReady = ea->readyHandlersTail;
+    if (ea->readyHandlersTail != NULL) {
+        ea->readyHandlersTail->nextReady = handler;
+    } else {
+        ea->readyHandlersHead = handler;
+    }
+    ea->readyHandlersTail = handler;
+    return true;
+}
+
+/**
+ * @brief Removes the handler from the ready handler queue. Must be called with eventsMutex locked.
+ */
+static void celix_eventAdmin_unscheduleHandler(celix_event_admin_t* ea, celix_event_handler_t* handler) {
+    if (!handler->ready) {
+        return;
+    }
+    if (handler->prevReady != NULL) {
+        handler->prevReady->nextReady = handler->nextReady;
+    } else {
+        ea->readyHandlersHead = handler->nextReady;
+    }
+    if (handler->nextReady != NULL) {
+        handler->nextReady->prevReady = handler->prevReady;
+    } else {
+        ea->readyHandlersTail = handler->prevReady;
+    }
+    handler->ready = false;
+    handler->prevReady = NULL;
+    handler->nextReady = NULL;
+}
+
+static celix_event_topic_node_t* celix_eventAdmin_createTopicNode(void) {
+    celix_autofree celix_event_topic_node_t* node = calloc(1, sizeof(*node));
+    if (node == NULL) {
+        return NULL;
+    }
+    celix_autoptr(celix_string_hash_map_t) children = node->children = celix_stringHashMap_create();
+    if (children == NULL) {
+        return NULL;
+    }
+    celix_autoptr(celix_array_list_t) topicHandlers = node->topicHandlers = celix_arrayList_create();
+    if (topicHandlers == NULL) {
+        return NULL;
+    }
+    celix_autoptr(celix_array_list_t) prefixHandlers = node->prefixHandlers = celix_arrayList_create();
+    if (prefixHandlers == NULL) {
+        return NULL;
+    }
+    celix_autoptr(celix_array_list_t) matchingHandlers = node->matchingHandlers = celix_arrayList_create();
+    if (matchingHandlers == NULL) {
+        return NULL;
+    }
+    celix_autoptr(celix_array_list_t) descendantHandlers = node->descendantHandlers = celix_arrayList_create();
+    if (descendantHandlers == NULL) {
+        return NULL;
+    }
+    celix_steal_ptr(descendantHandlers);
+    celix_steal_ptr(matchingHandlers);
+    celix_steal_ptr(prefixHandlers);
+    celix_steal_ptr(topicHandlers);
+    celix_steal_ptr(children);
+    return celix_steal_ptr(node);
+}
+
+static void celix_eventAdmin_destroyTopicNode(celix_event_topic_node_t* node) {
+    CELIX_STRING_HASH_MAP_ITERATE(node->children, iter) {
+        celix_eventAdmin_destroyTopicNode(iter.value.ptrValue);
+    }
+    celix_stringHashMap_destroy(node->children);
+    celix_arrayList_destroy(node->topicHandlers);
+    celix_arrayList_destroy(node->prefixHandlers);
+    celix_arrayList_destroy(node->matchingHandlers);
+    celix_arrayList_destroy(node->descendantHandlers);
+    free(node);
+}
+
+/**
+ * @brief Returns the topic segment as a NUL-terminated string. The segment is copied to the buffer if it fits,
+ * otherwise to the heap. The result must be freed with celix_utils_freeStringIfNotEqual.
+ */
+static char* celix_eventAdmin_topicSegmentKey(char* buffer, size_t bufferSize, const char* segment, size_t segmentLen) {
+    if (segmentLen < bufferSize) {
+        memcpy(buffer, segment, segmentLen);
+        buffer[segmentLen] = '\0';
+        return buffer;
+    }
+    return strndup(segment, segmentLen);
+}
+
+static celix_event_topic_node_t* celix_eventAdmin_getTopicChildNode(celix_event_admin_t* ea, const celix_event_topic_node_t* node,
+                                                                   const char* segment, size_t segmentLen) {
+    if (celix_stringHashMap_size(node->children) == 0) {
+        return NULL;
+    }
+    char buffer[CELIX_EVENT_ADMIN_TOPIC_SEGMENT_BUFFER_SIZE];
+    char* key = celix_eventAdmin_topicSegmentKey(buffer, sizeof(buffer), segment, segmentLen);
+    if (key == NULL) {
+        celix_logHelper_error(ea->logHelper, "Failed to copy topic segment %.*s.", (int)segmentLen, segment);
+        return NULL;
+    }
+    celix_event_topic_node_t* child = celix_stringHashMap_get(node->children, key);
+    celix_utils_freeStringIfNotEqual(buffer, key);
+    return child;
+}
+
+static celix_event_topic_node_t* celix_eventAdmin_addTopicChildNode(celix_event_admin_t* ea, celix_event_topic_node_t* node,
+                                                                   const char* segment, size_t segmentLen) {
+    char buffer[CELIX_EVENT_ADMIN_TOPIC_SEGMENT_BUFFER_SIZE];
+    char* key = celix_eventAdmin_topicSegmentKey(buffer, sizeof(buffer), segment, segmentLen);
+    if (key == NULL) {
+        celix_logHelper_error(ea->logHelper, "Failed to copy topic segment %.*s.", (int)segmentLen, segment);
+        return NULL;
+    }
+    celix_autoptr(celix_event_topic_node_t) child = celix_eventAdmin_createTopicNode();
+    if (child == NULL) {
         celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(ea->logHelper, "Failed to subscribe %s for event handler(%s).", topic, eventHandler->serviceDescription);
+        celix_logHelper_error(ea->logHelper, "Failed to create topic node for topic segment %s.", key);
+    } else if (celix_stringHashMap_put(node->children, key, child) != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(ea->logHelper, "Failed to add topic node for topic segment %s.", key);
+        celix_eventAdmin_destroyTopicNode(celix_steal_ptr(child));
     }
-    return;
+    celix_utils_freeStringIfNotEqual(buffer, key);
+    return celix_steal_ptr(child);
+}
+
+static celix_event_topic_node_t* celix_eventAdmin_getOrCreateTopicNode(celix_event_admin_t* ea, const char* topic, size_t topicLen) {
+    celix_event_topic_node_t* node = ea->topicTree;
+    const char* segment = topic;
+    const char* topicEnd = topic + topicLen;
+    while (node != NULL) {
+        const char* segmentEnd = memchr(segment, '/', topicEnd - segment);
+        size_t segmentLen = segmentEnd != NULL ? (size_t)(segmentEnd - segment) : (size_t)(topicEnd - segment);
+        celix_event_topic_node_t* child = celix_eventAdmin_getTopicChildNode(ea, node, segment, segmentLen);
+        if (child == NULL) {
+            child = celix_eventAdmin_addTopicChildNode(ea, node, segment, segmentLen);
+        }
+        if (segmentEnd == NULL) {
+            return child;
+        }
+        node = child;
+        segment = segmentEnd + 1;
+    }
+    return NULL;
 }
 
 static void celix_eventAdmin_subscribeTopicFor(celix_event_admin_t* ea, const char* topic, celix_event_handler_t* eventHandler) {
     size_t topicLen = celix_utils_strlen(topic);
+    celix_array_list_t* handlers = NULL;
     if (celix_utils_stringEquals(topic, "*")) {
-        celix_event_channel_t *channel = &ea->channelMatchingAllEvents;
-        if (celix_arrayList_addLong(channel->eventHandlerSvcIdList, eventHandler->serviceId) != CELIX_SUCCESS) {
-            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-            celix_logHelper_error(ea->logHelper, "Failed to subscribe %s for event handler(%s).", topic, eventHandler->serviceDescription);
-            return;
-        }
-    } else if (topicLen > 2 && topic[topicLen-1] == '*' && topic[topicLen-2] == '/'){
-        char prefixTopic[256] = {0};
-        if (topicLen-2 >= sizeof(prefixTopic)) {
-            celix_logHelper_error(ea->logHelper, "Prefix topic %s too long.", topic);
-            return;
-        }
-        memcpy(prefixTopic, topic, topicLen - 2);
-        prefixTopic[topicLen - 2] = '\0';
-        celix_eventAdmin_addEventHandlerToChannels(ea, prefixTopic, eventHandler, ea->channelsMatchingPrefixTopic);
+        handlers = ea->topicTree->prefixHandlers;
+    } else if (topicLen > 2 && topic[topicLen-1] == '*' && topic[topicLen-2] == '/') {
+        celix_event_topic_node_t* node = celix_eventAdmin_getOrCreateTopicNode(ea, topic, topicLen - 2);
+        handlers = node != NULL ? node->prefixHandlers : NULL;
     } else {
-        celix_eventAdmin_addEventHandlerToChannels(ea, topic, eventHandler, ea->channelsMatchingTopic);
+        celix_event_topic_node_t* node = celix_eventAdmin_getOrCreateTopicNode(ea, topic, topicLen);
+        handlers = node != NULL ? node->topicHandlers : NULL;
+    }
+    if (handlers == NULL || celix_arrayList_add(handlers, eventHandler) != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(ea->logHelper, "Failed to subscribe %s for event handler(%s).", topic, eventHandler->serviceDescription);
     }
     return;
 }
 
-static void celix_eventAdmin_removeEventHandlerFromChannels(celix_event_admin_t* ea, celix_event_handler_t* eventHandler, celix_string_hash_map_t* channels) {
-    (void)ea;//unused
-    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(channels);
+/**
+ * @brief Removes the event handler from the node and its descendants and removes the nodes which become empty.
+ * @return true if the node itself is empty.
+ */
+static bool celix_eventAdmin_unsubscribeTopicNodeFor(celix_event_topic_node_t* node, celix_event_handler_t* eventHandler) {
+    celix_arrayList_remove(node->topicHandlers, eventHandler);
+    celix_arrayList_remove(node->prefixHandlers, eventHandler);
+    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(node->children);
     while (!celix_stringHashMapIterator_isEnd(&iter)) {
-        celix_event_channel_t *channel = iter.value.ptrValue;
-        celix_arrayList_removeLong(channel->eventHandlerSvcIdList, eventHandler->serviceId);
-        if (celix_arrayList_size(channel->eventHandlerSvcIdList) == 0) {
+        celix_event_topic_node_t* child = iter.value.ptrValue;
+        if (celix_eventAdmin_unsubscribeTopicNodeFor(child, eventHandler)) {
             celix_stringHashMapIterator_remove(&iter);
-            celix_arrayList_destroy(channel->eventHandlerSvcIdList);
-            free(channel);
+            celix_eventAdmin_destroyTopicNode(child);
         } else {
             celix_stringHashMapIterator_next(&iter);
         }
     }
+    return celix_stringHashMap_size(node->children) == 0 && celix_arrayList_size(node->topicHandlers) == 0 &&
+           celix_arrayList_size(node->prefixHandlers) == 0;
 }
 
 static void celix_eventAdmin_unsubscribeTopicFor(celix_event_admin_t* ea, celix_event_handler_t* eventHandler) {
-    celix_arrayList_removeLong(ea->channelMatchingAllEvents.eventHandlerSvcIdList, eventHandler->serviceId);
-    celix_eventAdmin_removeEventHandlerFromChannels(ea, eventHandler, ea->channelsMatchingPrefixTopic);
-    celix_eventAdmin_removeEventHandlerFromChannels(ea, eventHandler, ea->channelsMatchingTopic);
+    (void)celix_eventAdmin_unsubscribeTopicNodeFor(ea->topicTree, eventHandler);
     return;
 }
 
+static void celix_eventAdmin_mergeEventHandlers(celix_event_admin_t* ea, celix_array_list_t* mergedHandlers, const celix_array_list_t* handlers) {
+    int size = handlers != NULL ? celix_arrayList_size(handlers) : 0;
+    for (int i = 0; i < size; ++i) {
+        celix_event_handler_t* eventHandler = celix_arrayList_get(handlers, i);
+        if (eventHandler->topicTreeMark == ea->topicTreeMark) {
+            continue;//already merged
+        }
+        eventHandler->topicTreeMark = ea->topicTreeMark;
+        if (celix_arrayList_add(mergedHandlers, eventHandler) != CELIX_SUCCESS) {
+            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
+            celix_logHelper_error(ea->logHelper, "Failed to merge event handler(%s).", eventHandler->serviceDescription);
+        }
+    }
+}
+
+static void celix_eventAdmin_updateTopicNodeCache(celix_event_admin_t* ea, celix_event_topic_node_t* node, const celix_array_list_t* inheritedHandlers) {
+    celix_arrayList_clear(node->matchingHandlers);
+    ea->topicTreeMark++;
+    celix_eventAdmin_mergeEventHandlers(ea, node->matchingHandlers, inheritedHandlers);
+    celix_eventAdmin_mergeEventHandlers(ea, node->matchingHandlers, node->topicHandlers);
+
+    celix_arrayList_clear(node->descendantHandlers);
+    ea->topicTreeMark++;
+    celix_eventAdmin_mergeEventHandlers(ea, node->descendantHandlers, inheritedHandlers);
+    celix_eventAdmin_mergeEventHandlers(ea, node->descendantHandlers, node->prefixHandlers);
+
+    CELIX_STRING_HASH_MAP_ITERATE(node->children, iter) {
+        celix_eventAdmin_updateTopicNodeCache(ea, iter.value.ptrValue, node->descendantHandlers);
+    }
+}
+
+/**
+ * @brief Updates the pre-merged handler sets of the topic tree. Must be called with the write lock after the subscriptions changed.
+ */
+static void celix_eventAdmin_updateTopicTreeCache(celix_event_admin_t* ea) {
+    celix_eventAdmin_updateTopicNodeCache(ea, ea->topicTree, NULL);
+}
+
+/**
+ * @brief Returns the event handlers which subscribed to the event topic. Must be called with the read lock.
+ */
+static const celix_array_list_t* celix_eventAdmin_findEventHandlers(celix_event_admin_t* ea, const char* topic) {
+    const celix_event_topic_node_t* node = ea->topicTree;
+    const char* segment = topic;
+    while (true) {
+        const char* segmentEnd = strchr(segment, '/');
+        size_t segmentLen = segmentEnd != NULL ? (size_t)(segmentEnd - segment) : strlen(segment);
+        const celix_event_topic_node_t* child = celix_eventAdmin_getTopicChildNode(ea, node, segment, segmentLen);
+        if (child == NULL) {
+            return node->descendantHandlers;
+        }
+        if (segmentEnd == NULL) {
+            return child->matchingHandlers;
+        }
+        node = child;
+        segment = segmentEnd + 1;
+    }
+}
+
 int celix_eventAdmin_addEventHandlerWithProperties(void* handle, void* svc, const celix_properties_t* props) {
     assert(handle != NULL);
     assert(svc != NULL);
@@ -331,9 +594,22 @@ int celix_eventAdmin_addEventHandlerWithProperties(void* handle, void* svc, cons
     handler->serviceDescription = celix_properties_get(props, CELIX_FRAMEWORK_SERVICE_DESCRIPTION, "Unknown");
     const char *deliver = celix_properties_get(props, CELIX_EVENT_DELIVERY, NULL);
     handler->asyncOrdered = (deliver == NULL || strstr(deliver,CELIX_EVENT_DELIVERY_ASYNC_ORDERED) != NULL);
+    long batchSize = celix_properties_getAsLong(props, CELIX_EVENT_BATCH_SIZE, 1);
+    handler->batchSize = 1;
+    if (batchSize > 1) {
+        if (((celix_event_handler_service_t*)svc)->handleEvents == NULL) {
+            celix_logHelper_error(ea->logHelper, "Event handler(%s) sets %s, but has no handleEvents method.",
+                                  handler->serviceDescription, CELIX_EVENT_BATCH_SIZE);
+            return CELIX_ILLEGAL_ARGUMENT;
+        }
+        handler->batchSize = batchSize > CELIX_EVENT_ADMIN_MAX_HANDLER_BATCH_SIZE ? CELIX_EVENT_ADMIN_MAX_HANDLER_BATCH_SIZE : (size_t)batchSize;
+    }
     handler->eventFilter = NULL;
     handler->blackListed = false;
+    handler->topicTreeMark = 0;
     handler->handlingAsyncEventCnt = 0;
+    handler->droppedEventCnt = 0;
+    handler->ready = false;
 
     celix_autofree char* topicsCopy = celix_utils_strdup(topics);
     if (topicsCopy == NULL) {
@@ -381,6 +657,7 @@ int celix_eventAdmin_addEventHandlerWithProperties(void* handle, void* svc, cons
     CELIX_STRING_HASH_MAP_ITERATE(topicsMap, iter) {
         celix_eventAdmin_subscribeTopicFor(ea, iter.key, handler);
     }
+    celix_eventAdmin_updateTopicTreeCache(ea);
 
     celix_logHelper_debug(ea->logHelper, "Added event handler(%s) for topics %s", handler->serviceDescription, topics);
 
@@ -407,7 +684,15 @@ int celix_eventAdmin_removeEventHandlerWithProperties(void* handle, void* svc, c
     if (handler != NULL) {
         celix_logHelper_debug(ea->logHelper, "Removing event handler(%s)", handler->serviceDescription);
         celix_eventAdmin_unsubscribeTopicFor(ea, handler);
+        celix_eventAdmin_updateTopicTreeCache(ea);
         celix_longHashMap_remove(ea->eventHandlers, serviceId);
+        celixThreadMutex_lock(&ea->eventsMutex);
+        celix_eventAdmin_unscheduleHandler(ea, handler);
+        celix_eventQueue_clear(&handler->asyncEventQueue);
+        celixThreadMutex_unlock(&ea->eventsMutex);
+        if (handler->droppedEventCnt > 0) {
+            celix_logHelper_warning(ea->logHelper, "%zu events were dropped for event handler(%s).", handler->droppedEventCnt, handler->serviceDescription);
+        }
         celix_filter_destroy(handler->eventFilter);
         free(handler);
     }
@@ -415,83 +700,31 @@ int celix_eventAdmin_removeEventHandlerWithProperties(void* handle, void* svc, c
     return CELIX_SUCCESS;
 }
 
-static void celix_eventAdmin_collectEventHandlers(celix_event_admin_t* ea, const char* eventTopic, const celix_properties_t* eventProperties,
-                                                  celix_event_channel_t* channel, celix_long_hash_map_t* eventHandlers) {
-    if (channel == NULL) {
-        return;
+static bool celix_eventAdmin_isEventHandlerMatched(celix_event_admin_t* ea, celix_event_handler_t* eventHandler,
+                                                   const char* eventTopic, const celix_properties_t* eventProperties) {
+    if (!celix_filter_match(eventHandler->eventFilter, eventProperties)) {
+        celix_logHelper_debug(ea->logHelper, "Event %s is filtered by filter(%s)", eventTopic,
+                              celix_filter_getFilterString(eventHandler->eventFilter));
+        return false;
     }
-    size_t size = celix_arrayList_size(channel->eventHandlerSvcIdList);
-    for (int i = 0; i < size; ++i) {
-        long handlerSvcId = celix_arrayList_getLong(channel->eventHandlerSvcIdList, i);
-        celix_event_handler_t* eventHandler = celix_longHashMap_get(ea->eventHandlers, handlerSvcId);
-        if (eventHandler == NULL) {
-            continue;
-        }
-        if (!celix_filter_match(eventHandler->eventFilter, eventProperties)) {
-            celix_logHelper_debug(ea->logHelper, "Event %s is filtered by filter(%s)", eventTopic,
-                                  celix_filter_getFilterString(eventHandler->eventFilter));
-            continue;
-        }
-        if (__atomic_load_n(&eventHandler->blackListed, __ATOMIC_ACQUIRE)) {
-            celix_logHelper_warning(ea->logHelper, "Skipping blacklisted event handler for topic %s, %s", eventTopic,
-                                    eventHandler->serviceDescription);
-            continue;
-        }
-        if (celix_longHashMap_put(eventHandlers, handlerSvcId, NULL) != CELIX_SUCCESS) {
-            celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-            celix_logHelper_error(ea->logHelper, "Failed to collect event handler for topic %s, %s", eventTopic,
-                                  eventHandler->serviceDescription);
-        }
+    if (__atomic_load_n(&eventHandler->blackListed, __ATOMIC_ACQUIRE)) {
+        celix_logHelper_warning(ea->logHelper, "Skipping blacklisted event handler for topic %s, %s", eventTopic,
+                                eventHandler->serviceDescription);
+        return false;
     }
-    return;
+    return true;
 }
 
 static int celix_eventAdmin_deliverEvent(celix_event_admin_t* ea, const char* eventTopic, const celix_properties_t* eventProperties,
                                           int (*deliverAction)(celix_event_admin_t* ea, const char* topic, const celix_properties_t* properties,
-                                                  celix_long_hash_map_t* eventHandlers, bool* stealEventHandlers)) {
-    celix_autoptr(celix_long_hash_map_t) eventHandlers = celix_longHashMap_create();//avoid duplicated event handler
-    if (eventHandlers == NULL) {
-        celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(ea->logHelper, "Failed to create event handlers list.");
-        return CELIX_ENOMEM;
-    }
-
-    {
-        celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
-        // Add all handlers for matching everything
-        celix_eventAdmin_collectEventHandlers(ea, eventTopic, eventProperties, &ea->channelMatchingAllEvents, eventHandlers);
-
-        // Add the handlers for prefix matches
-        if (celix_stringHashMap_size(ea->channelsMatchingPrefixTopic) != 0) {
-            char topicCopy[256] = {0};
-            if (celix_utils_strlen(eventTopic) >= sizeof(topicCopy)) {
-                celix_logHelper_error(ea->logHelper, "Topic %s too long.", eventTopic);
-            } else {
-                strcpy(topicCopy, eventTopic);
-                char *pos;
-                while ((pos = strrchr(topicCopy, '/')) != NULL) {
-                    topicCopy[pos - topicCopy] = '\0';
-                    celix_event_channel_t *channel = celix_stringHashMap_get(ea->channelsMatchingPrefixTopic, topicCopy);
-                    celix_eventAdmin_collectEventHandlers(ea, eventTopic, eventProperties, channel, eventHandlers);
-                }
-            }
-        }
-
-        // Add the handlers for matching topic names
-        celix_event_channel_t* channel = celix_stringHashMap_get(ea->channelsMatchingTopic, eventTopic);
-        celix_eventAdmin_collectEventHandlers(ea, eventTopic, eventProperties, channel, eventHandlers);
-    }
-
-    if (celix_longHashMap_size(eventHandlers) == 0) {//no event handlers found, discard event
+                                                  const celix_array_list_t* eventHandlers)) {
+    celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
+    const celix_array_list_t* eventHandlers = celix_eventAdmin_findEventHandlers(ea, eventTopic);
+    if (celix_arrayList_size(eventHandlers) == 0) {//no event handlers found, discard event
         celix_logHelper_trace(ea->logHelper, "No event handlers found for topic %s", eventTopic);
         return CELIX_SUCCESS;
     }
-    bool stealEventHandlers = false;
-    celix_status_t status = deliverAction(ea, eventTopic, eventProperties, eventHandlers, &stealEventHandlers);
-    if (stealEventHandlers) {
-        celix_steal_ptr(eventHandlers);
-    }
-    return status;
+    return deliverAction(ea, eventTopic, eventProperties, eventHandlers);
 }
 
 static void celix_eventAdmin_deliverEventToHandler(celix_event_admin_t* ea, const char* topic, const celix_properties_t* props,
@@ -516,15 +749,14 @@ static void celix_eventAdmin_deliverEventToHandler(celix_event_admin_t* ea, cons
 }
 
 static int celix_eventAdmin_deliverEventSyncDo(celix_event_admin_t* ea, const char* topic, const celix_properties_t* props,
-                                               celix_long_hash_map_t* eventHandlers, bool* stealEventHandlers) {
-    celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
-    CELIX_LONG_HASH_MAP_ITERATE(eventHandlers, iter) {
-        celix_event_handler_t* eventHandler = celix_longHashMap_get(ea->eventHandlers, iter.key);
-        if (eventHandler) {
+                                               const celix_array_list_t* eventHandlers) {
+    int size = celix_arrayList_size(eventHandlers);
+    for (int i = 0; i < size; ++i) {
+        celix_event_handler_t* eventHandler = celix_arrayList_get(eventHandlers, i);
+        if (celix_eventAdmin_isEventHandlerMatched(ea, eventHandler, topic, props)) {
             celix_eventAdmin_deliverEventToHandler(ea, topic, props, eventHandler);
         }
     }
-    *stealEventHandlers = false;
     return CELIX_SUCCESS;
 }
 
@@ -536,36 +768,134 @@ celix_status_t celix_eventAdmin_sendEvent(void* handle, const char* topic, const
     return celix_eventAdmin_deliverEvent(ea, topic, props, celix_eventAdmin_deliverEventSyncDo);
 }
 
-static int celix_eventAdmin_deliverEventAsyncDo(celix_event_admin_t* ea, const char* topic, const celix_properties_t* props,
-                                                 celix_long_hash_map_t* eventHandlers, bool* stealEventHandlers) {
-    celix_autofree celix_event_entry_t* entry = calloc(1, sizeof(*entry));
-    if (entry == NULL) {
-        celix_logHelper_error(ea->logHelper, "Failed to alloc memory for event entry %s.", topic);
-        return CELIX_ENOMEM;
+/**
+ * @brief Adds the event to the async event queue of the handler, applying the drop policy if the queue is full.
+ * Must be called with eventsMutex locked.
+ */
+static celix_status_t celix_eventAdmin_queueEventForHandler(celix_event_admin_t* ea, celix_event_handler_t* eventHandler, celix_event_t* event) {
+    celix_event_queue_t* queue = &eventHandler->asyncEventQueue;
+    if (queue->size >= ea->eventQueueSize) {
+        eventHandler->droppedEventCnt++;
+        if (ea->dropPolicy == CELIX_EVENT_ADMIN_DROP_POLICY_DROP_NEWEST_E) {
+            celix_logHelper_warning(ea->logHelper, "Event queue of handler(%s) is full. Dropping event %s.",
+                                    eventHandler->serviceDescription, celix_event_getTopic(event));
+            return CELIX_SUCCESS;
+        }
+        celix_event_t* oldestEvent = celix_eventQueue_pop(queue);
+        celix_logHelper_warning(ea->logHelper, "Event queue of handler(%s) is full. Dropping oldest event %s.",
+                                eventHandler->serviceDescription, celix_event_getTopic(oldestEvent));
+        celix_event_release(oldestEvent);
     }
-    celix_autoptr(celix_event_t) event = entry->event = celix_event_create(topic, props);
-    if (event == NULL) {
-        celix_logHelper_error(ea->logHelper, "Failed to alloc memory for event %s.", topic);
-        return CELIX_ENOMEM;
+    celix_status_t status = celix_eventQueue_push(queue, event, ea->eventQueueSize);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(ea->logHelper, "Failed to add event(%s) to event queue of handler(%s).",
+                              celix_event_getTopic(event), eventHandler->serviceDescription);
     }
-    entry->eventHandlers = eventHandlers;
+    return status;
+}
+
+static size_t celix_eventAdmin_countMatchedEvents(celix_event_admin_t* ea, celix_event_handler_t* eventHandler,
+                                                  celix_event_t* const* events, size_t eventCnt) {
+    size_t matchedCnt = 0;
+    for (size_t i = 0; i < eventCnt; ++i) {
+        if (celix_eventAdmin_isEventHandlerMatched(ea, eventHandler, celix_event_getTopic(events[i]), celix_event_getProperties(events[i]))) {
+            matchedCnt++;
+        }
+    }
+    return matchedCnt;
+}
+
+/**
+ * @brief Checks whether the event queue of the event handler can hold the matching events of the batch.
+ * Must be called with eventsMutex locked.
+ */
+static bool celix_eventAdmin_canQueueEventsForHandler(celix_event_admin_t* ea, celix_event_handler_t* eventHandler,
+                                                      celix_event_t* const* events, size_t eventCnt) {
+    size_t freeCnt = ea->eventQueueSize - eventHandler->asyncEventQueue.size;
+    if (freeCnt >= eventCnt) {
+        return true;
+    }
+    size_t matchedCnt = celix_eventAdmin_countMatchedEvents(ea, eventHandler, events, eventCnt);
+    if (matchedCnt > freeCnt) {
+        celix_logHelper_error(ea->logHelper, "Event queue of handler(%s) is full. Dropping %zu event(s) %s.",
+                              eventHandler->serviceDescription, matchedCnt, celix_event_getTopic(events[0]));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether the event queues of all event handlers can hold the matching events of the batch.
+ * If not, the batch is rejected for all event handlers and the dropped events are counted for every event handler
+ * that misses them. Must be called with eventsMutex locked.
+ */
+static bool celix_eventAdmin_canQueueEvents(celix_event_admin_t* ea, celix_event_t* const* events, size_t eventCnt,
+                                            const celix_array_list_t* eventHandlers) {
+    int size = celix_arrayList_size(eventHandlers);
+    bool canQueue = true;
+    for (int i = 0; i < size; ++i) {
+        celix_event_handler_t* eventHandler = celix_arrayList_get(eventHandlers, i);
+        if (!celix_eventAdmin_canQueueEventsForHandler(ea, eventHandler, events, eventCnt)) {
+            canQueue = false;
+        }
+    }
+    if (!canQueue) {
+        for (int i = 0; i < size; ++i) {
+            celix_event_handler_t* eventHandler = celix_arrayList_get(eventHandlers, i);
+            eventHandler->droppedEventCnt += celix_eventAdmin_countMatchedEvents(ea, eventHandler, events, eventCnt);
+        }
+    }
+    return canQueue;
+}
+
+/**
+ * @brief Adds the events to the async event queues of the matching event handlers and wakes up the event handler threads.
+ * Must be called with the read lock.
+ */
+static celix_status_t celix_eventAdmin_queueEvents(celix_event_admin_t* ea, celix_event_t* const* events, size_t eventCnt,
+                                                   const celix_array_list_t* eventHandlers) {
+    int size = celix_arrayList_size(eventHandlers);
     celix_auto(celix_mutex_lock_guard_t) mutexGuard = celixMutexLockGuard_init(&ea->eventsMutex);
-    if (celix_arrayList_size(ea->asyncEventQueue) >= CELIX_EVENT_ADMIN_MAX_EVENT_QUEUE_SIZE) {
-        celix_logHelper_error(ea->logHelper, "Event queue is full. Dropping event %s.", topic);
+    if (ea->dropPolicy == CELIX_EVENT_ADMIN_DROP_POLICY_REJECT_E && !celix_eventAdmin_canQueueEvents(ea, events, eventCnt, eventHandlers)) {
         return CELIX_ILLEGAL_STATE;
     }
-    int status = celix_arrayList_add(ea->asyncEventQueue, entry);
-    if (status != CELIX_SUCCESS) {
-        celix_logHelper_logTssErrors(ea->logHelper, CELIX_LOG_LEVEL_ERROR);
-        celix_logHelper_error(ea->logHelper, "Failed to add event(%s) to event queue.", topic);
-        return status;
+    celix_status_t status = CELIX_SUCCESS;
+    unsigned int readyHandlerCnt = 0;
+    for (int i = 0; i < size; ++i) {
+        celix_event_handler_t* eventHandler = celix_arrayList_get(eventHandlers, i);
+        for (size_t j = 0; j < eventCnt; ++j) {
+            if (!celix_eventAdmin_isEventHandlerMatched(ea, eventHandler, celix_event_getTopic(events[j]), celix_event_getProperties(events[j]))) {
+                continue;
+            }
+            celix_status_t queueStatus = celix_eventAdmin_queueEventForHandler(ea, eventHandler, events[j]);
+            if (queueStatus != CELIX_SUCCESS) {
+                status = queueStatus;
+            }
+        }
+        if (celix_eventAdmin_scheduleHandler(ea, eventHandler)) {
+            readyHandlerCnt++;
+        }
     }
-    *stealEventHandlers = true;
-    celix_steal_ptr(event);
-    celix_steal_ptr(entry);
-    celixThreadCondition_signal(&ea->eventsTriggerCond);
+    if (readyHandlerCnt >= ea->idleThreadCnt) {
+        if (ea->idleThreadCnt > 0) {
+            celixThreadCondition_broadcast(&ea->eventsTriggerCond);
+        }
+    } else {
+        for (unsigned int i = 0; i < readyHandlerCnt; ++i) {
+            celixThreadCondition_signal(&ea->eventsTriggerCond);
+        }
+    }
+    return status;
+}
 
-    return CELIX_SUCCESS;
+static int celix_eventAdmin_deliverEventAsyncDo(celix_event_admin_t* ea, const char* topic, const celix_properties_t* props,
+                                                 const celix_array_list_t* eventHandlers) {
+    celix_autoptr(celix_event_t) event = celix_eventPool_createEvent(ea->eventPool, topic, props);
+    if (event == NULL) {
+        celix_logHelper_error(ea->logHelper, "Failed to alloc memory for event %s.", topic);
+        return CELIX_ENOMEM;
+    }
+    return celix_eventAdmin_queueEvents(ea, &event, 1, eventHandlers);
 }
 
 celix_status_t celix_eventAdmin_postEvent(void* handle, const char* topic, const celix_properties_t* props) {
@@ -576,75 +906,161 @@ celix_status_t celix_eventAdmin_postEvent(void* handle, const char* topic, const
     return celix_eventAdmin_deliverEvent(ea, topic, props, celix_eventAdmin_deliverEventAsyncDo);
 }
 
-static bool celix_eventAdmin_getPendingEvent(celix_event_admin_t* ea, celix_event_t** event, long* eventHandlerSvcId) {
-    bool found = false;
-    size_t size = celix_arrayList_size(ea->asyncEventQueue);
-    for (int i = 0; (i < size) && !found; ++i) {
-        celix_event_entry_t* eventEntry = celix_arrayList_get(ea->asyncEventQueue, i);
-        celix_long_hash_map_iterator_t iter = celix_longHashMap_begin(eventEntry->eventHandlers);
-        while (!celix_longHashMapIterator_isEnd(&iter) && !found) {
-            celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
-            long handlerSvcId = iter.key;
-            celix_event_handler_t* eventHandler = celix_longHashMap_get(ea->eventHandlers, handlerSvcId);
-            if (eventHandler == NULL) {
-                celix_longHashMapIterator_remove(&iter);
-                continue;
-            }
-            unsigned int handlingEventCnt = __atomic_fetch_add(&eventHandler->handlingAsyncEventCnt, 1, __ATOMIC_SEQ_CST);
-            if (handlingEventCnt == 0 || (!eventHandler->asyncOrdered && handlingEventCnt < CELIX_EVENT_ADMIN_MAX_PARALLEL_EVENTS_OF_HANDLER(ea->handlerThreadNr))) {
-                *event = celix_event_retain(eventEntry->event);
-                *eventHandlerSvcId = handlerSvcId;
-                celix_longHashMapIterator_remove(&iter);
-                found = true;
-                continue;
-            }
-            __atomic_fetch_sub(&eventHandler->handlingAsyncEventCnt, 1, __ATOMIC_SEQ_CST);
-
-            celix_longHashMapIterator_next(&iter);
-        }
-        if (celix_longHashMap_size(eventEntry->eventHandlers) == 0) {
-            celix_arrayList_removeAt(ea->asyncEventQueue, i);
-            i--;
-            size--;
+celix_status_t celix_eventAdmin_postEvents(void* handle, const char* topic, const celix_properties_t* const* props, size_t size) {
+    if (handle == NULL || topic == NULL || (props == NULL && size > 0)) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_event_admin_t* ea = (celix_event_admin_t*)handle;
+    celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
+    const celix_array_list_t* eventHandlers = celix_eventAdmin_findEventHandlers(ea, topic);
+    if (size == 0 || celix_arrayList_size(eventHandlers) == 0) {//no event handlers found, discard events
+        celix_logHelper_trace(ea->logHelper, "No event handlers found for topic %s", topic);
+        return CELIX_SUCCESS;
+    }
+    celix_event_t* eventsBuffer[CELIX_EVENT_ADMIN_EVENT_BATCH_BUFFER_SIZE];
+    celix_event_t** events = eventsBuffer;
+    if (size > CELIX_EVENT_ADMIN_EVENT_BATCH_BUFFER_SIZE && (events = malloc(size * sizeof(*events))) == NULL) {
+        celix_logHelper_error(ea->logHelper, "Failed to alloc memory for %zu events %s.", size, topic);
+        return CELIX_ENOMEM;
+    }
+    celix_status_t status = CELIX_SUCCESS;
+    size_t eventCnt = 0;
+    for (; eventCnt < size; ++eventCnt) {
+        events[eventCnt] = celix_eventPool_createEvent(ea->eventPool, topic, props[eventCnt]);
+        if (events[eventCnt] == NULL) {
+            celix_logHelper_error(ea->logHelper, "Failed to alloc memory for event %s.", topic);
+            status = CELIX_ENOMEM;
+            break;
         }
     }
-    return found;
+    if (status == CELIX_SUCCESS) {
+        status = celix_eventAdmin_queueEvents(ea, events, eventCnt, eventHandlers);
+    }
+    for (size_t i = 0; i < eventCnt; ++i) {
+        celix_event_release(events[i]);
+    }
+    if (events != eventsBuffer) {
+        free(events);
+    }
+    return status;
 }
 
-static void celix_eventAdmin_deliverPendingEvent(celix_event_admin_t* ea, const char* topic, const celix_properties_t* props, long eventHandlerSvcId) {
+celix_status_t celix_eventAdmin_postEventWithoutCopy(void* handle, const char* topic, celix_properties_t* props) {
+    celix_autoptr(celix_properties_t) properties = props;
+    if (handle == NULL || topic == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_event_admin_t* ea = (celix_event_admin_t*)handle;
     celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&ea->lock);
+    const celix_array_list_t* eventHandlers = celix_eventAdmin_findEventHandlers(ea, topic);
+    if (celix_arrayList_size(eventHandlers) == 0) {//no event handlers found, discard event
+        celix_logHelper_trace(ea->logHelper, "No event handlers found for topic %s", topic);
+        return CELIX_SUCCESS;
+    }
+    celix_autoptr(celix_event_t) event = celix_eventPool_assignEvent(ea->eventPool, topic, celix_steal_ptr(properties));
+    if (event == NULL) {
+        celix_logHelper_error(ea->logHelper, "Failed to alloc memory for event %s.", topic);
+        return CELIX_ENOMEM;
+    }
+    return celix_eventAdmin_queueEvents(ea, &event, 1, eventHandlers);
+}
+
+/**
+ * @brief Takes the oldest pending events, at most the batch size of the handler, of the first ready handler.
+ * Must be called with eventsMutex locked.
+ * @return The number of taken events.
+ */
+static size_t celix_eventAdmin_getPendingEvents(celix_event_admin_t* ea, celix_event_t** events, long* eventHandlerSvcId) {
+    celix_event_handler_t* eventHandler = ea->readyHandlersHead;
+    if (eventHandler == NULL) {
+        return 0;
+    }
+    celix_eventAdmin_unscheduleHandler(ea, eventHandler);
+    size_t eventCnt = 0;
+    while (eventCnt < eventHandler->batchSize && eventHandler->asyncEventQueue.size > 0) {
+        events[eventCnt++] = celix_eventQueue_pop(&eventHandler->asyncEventQueue);
+    }
+    *eventHandlerSvcId = eventHandler->serviceId;
+    eventHandler->handlingAsyncEventCnt++;
+    //An unordered handler goes back to the tail of the ready handler queue, so that handlers are served round-robin.
+    (void)celix_eventAdmin_scheduleHandler(ea, eventHandler);
+    if (ea->readyHandlersHead != NULL && ea->idleThreadCnt > 0) {
+        celixThreadCondition_signal(&ea->eventsTriggerCond);
+    }
+    return eventCnt;
+}
+
+static void celix_eventAdmin_deliverEventsToHandler(celix_event_admin_t* ea, celix_event_t* const* events, size_t eventCnt,
+                                                    celix_event_handler_t* eventHandler) {
+    const char* topic = celix_event_getTopic(events[0]);
+    celix_logHelper_trace(ea->logHelper, "Delivering %zu events %s to handler(%s)", eventCnt, topic, eventHandler->serviceDescription);
+    celix_event_entry_t entries[CELIX_EVENT_ADMIN_MAX_HANDLER_BATCH_SIZE];
+    for (size_t i = 0; i < eventCnt; ++i) {
+        entries[i].topic = celix_event_getTopic(events[i]);
+        entries[i].properties = celix_event_getProperties(events[i]);
+    }
+    celix_event_handler_service_t* svc = eventHandler->service;
+    struct timespec startTime = celix_gettime(CLOCK_MONOTONIC);
+    celix_status_t status = svc->handleEvents(svc->handle, entries, eventCnt);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(ea->logHelper, "Failed to handle %zu events %s for handler(%s)", eventCnt, topic, eventHandler->serviceDescription);
+    }
+    double elapsedTime = celix_elapsedtime(CLOCK_MONOTONIC, startTime);
+    if (elapsedTime > CELIX_EVENT_ADMIN_MAX_HANDLE_EVENT_TIME) {
+        celix_logHelper_error(ea->logHelper, "Event handler for %zu events %s took %f seconds, %s", eventCnt, topic, elapsedTime, eventHandler->serviceDescription);
+        __atomic_store_n(&eventHandler->blackListed, true, __ATOMIC_RELEASE);
+    }
+    return;
+}
+
+/**
+ * @brief Delivers the pending events to the event handler. Must be called without locks, returns with eventsMutex locked,
+ * so that the event handler thread can take the next pending events without locking eventsMutex again.
+ */
+static void celix_eventAdmin_deliverPendingEvents(celix_event_admin_t* ea, celix_event_t* const* events, size_t eventCnt, long eventHandlerSvcId) {
+    celixThreadRwlock_readLock(&ea->lock);
     celix_event_handler_t* eventHandler = celix_longHashMap_get(ea->eventHandlers, eventHandlerSvcId);
-    if(eventHandler == NULL) {
-        return;
+    if (eventHandler != NULL) {
+        if (__atomic_load_n(&eventHandler->blackListed, __ATOMIC_ACQUIRE)) {
+            celix_logHelper_warning(ea->logHelper, "Skipping blacklisted event handler for topic %s, %s", celix_event_getTopic(events[0]),
+                                    eventHandler->serviceDescription);
+        } else if (eventHandler->batchSize > 1) {
+            celix_eventAdmin_deliverEventsToHandler(ea, events, eventCnt, eventHandler);
+        } else {
+            celix_eventAdmin_deliverEventToHandler(ea, celix_event_getTopic(events[0]), celix_event_getProperties(events[0]), eventHandler);
+        }
     }
-    if (__atomic_load_n(&eventHandler->blackListed, __ATOMIC_ACQUIRE)) {
-        celix_logHelper_warning(ea->logHelper, "Skipping blacklisted event handler for topic %s, %s", topic,
-                                eventHandler->serviceDescription);
-    } else {
-        celix_eventAdmin_deliverEventToHandler(ea, topic, props, eventHandler);
+    for (size_t i = 0; i < eventCnt; ++i) {
+        celix_event_release(events[i]);
     }
-    __atomic_fetch_sub(&eventHandler->handlingAsyncEventCnt, 1, __ATOMIC_SEQ_CST);
+    celixThreadMutex_lock(&ea->eventsMutex);
+    if (eventHandler != NULL) {
+        eventHandler->handlingAsyncEventCnt--;
+        (void)celix_eventAdmin_scheduleHandler(ea, eventHandler);
+    }
+    celixThreadRwlock_unlock(&ea->lock);
     return;
 }
 
 static void* celix_eventAdmin_deliverEventThread(void* data) {
     assert(data != NULL);
     celix_event_admin_t* ea = (celix_event_admin_t*)data;
-    bool running = ea->threadsRunning;
-    while (running) {
-        celix_event_t *event = NULL;
+    celixThreadMutex_lock(&ea->eventsMutex);
+    while (true) {
+        celix_event_t* events[CELIX_EVENT_ADMIN_MAX_HANDLER_BATCH_SIZE];
+        size_t eventCnt = 0;
         long eventHandlerSvcId = -1;
-        celixThreadMutex_lock(&ea->eventsMutex);
-        while (ea->threadsRunning && !celix_eventAdmin_getPendingEvent(ea, &event, &eventHandlerSvcId)) {
+        while (ea->threadsRunning && (eventCnt = celix_eventAdmin_getPendingEvents(ea, events, &eventHandlerSvcId)) == 0) {
+            ea->idleThreadCnt++;
             celixThreadCondition_wait(&ea->eventsTriggerCond, &ea->eventsMutex);
+            ea->idleThreadCnt--;
         }
-        running = ea->threadsRunning;
-        celixThreadMutex_unlock(&ea->eventsMutex);
-
-        if (event) {
-            celix_eventAdmin_deliverPendingEvent(ea, celix_event_getTopic(event), celix_event_getProperties(event), eventHandlerSvcId);
-            celix_event_release(event);
+        if (eventCnt == 0) {//event admin is stopped
+            break;
         }
+        celixThreadMutex_unlock(&ea->eventsMutex);
+        celix_eventAdmin_deliverPendingEvents(ea, events, eventCnt, eventHandlerSvcId);
     }
+    celixThreadMutex_unlock(&ea->eventsMutex);
     return NULL;
-}
\ No newline at end of file
+}
@@ -39,6 +39,8 @@ int celix_eventAdmin_removeEventHandlerWithProperties(void* handle, void* svc, c
 
 celix_status_t celix_eventAdmin_sendEvent(void* handle, const char* topic, const celix_properties_t* props);
 celix_status_t celix_eventAdmin_postEvent(void* handle, const char* topic, const celix_properties_t* props);
+celix_status_t celix_eventAdmin_postEvents(void* handle, const char* topic, const celix_properties_t* const* props, size_t size);
+celix_status_t celix_eventAdmin_postEventWithoutCopy(void* handle, const char* topic, celix_properties_t* props);
 
 #ifdef __cplusplus
 }
@@ -73,6 +73,8 @@ celix_status_t celix_eventAdminActivator_start(celix_event_admin_activator_t *ac
 
     act->eventAdminService.handle = act->eventAdmin;
     act->eventAdminService.postEvent = celix_eventAdmin_postEvent;
+    act->eventAdminService.postEventWithoutCopy = celix_eventAdmin_postEventWithoutCopy;
+    act->eventAdminService.postEvents = celix_eventAdmin_postEvents;
     act->eventAdminService.sendEvent = celix_eventAdmin_sendEvent;
     status = celix_dmComponent_addInterface(adminCmp, CELIX_EVENT_ADMIN_SERVICE_NAME, CELIX_EVENT_ADMIN_SERVICE_VERSION, &act->eventAdminService, NULL);
     if (status != CELIX_SUCCESS) {
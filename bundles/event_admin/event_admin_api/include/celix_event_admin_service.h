@@ -33,7 +33,7 @@ extern "C" {
 /**
  * @brief The Event Admin service version
  */
-#define CELIX_EVENT_ADMIN_SERVICE_VERSION "1.0.0"
+#define CELIX_EVENT_ADMIN_SERVICE_VERSION "1.2.0"
 #define CELIX_EVENT_ADMIN_SERVICE_USE_RANGE "[1.0.0,2)"
 
 /**
@@ -58,6 +58,32 @@ typedef struct celix_event_admin_service {
      * @return Status code indicating failure or success. CELIX_SUCCESS if no errors are encountered. If an error is encountered, it should be a celix errno.
      */
     celix_status_t (*sendEvent)(void* handle, const char* topic, const celix_properties_t* properties);
+    /**
+     * @brief Asynchronous event delivery without copying the event properties. This method returns to the caller before delivery of the event is completed.
+     *
+     * The event admin takes ownership of the properties, also if an error is returned. The properties are shared by all
+     * event handlers of the event and must not be changed after this call.
+     * @note Added in version 1.1.0 of the service, use the version range "[1.1.0,2)" to depend on it.
+     * @param[in] handle The handle as provided by the service registration.
+     * @param[in] topic The topic of the event.
+     * @param[in] properties The properties of the event. It can be NULL.
+     * @return Status code indicating failure or success. CELIX_SUCCESS if no errors are encountered. If an error is encountered, it should be a celix errno.
+     */
+    celix_status_t (*postEventWithoutCopy)(void* handle, const char* topic, celix_properties_t* properties);
+    /**
+     * @brief Asynchronous delivery of a batch of events with the same topic. This method returns to the caller before delivery of the events is completed.
+     *
+     * The events are queued at once, which is cheaper than posting the events one by one. The events are delivered in
+     * order to event handlers with the "async.ordered" delivery quality. If an event queue of an event handler can not
+     * hold the events of the batch and the "reject" drop policy is configured, none of the events is posted.
+     * @note Added in version 1.2.0 of the service, use the version range "[1.2.0,2)" to depend on it.
+     * @param[in] handle The handle as provided by the service registration.
+     * @param[in] topic The topic of the events.
+     * @param[in] properties The properties of the events, the properties are copied. An entry can be NULL.
+     * @param[in] size The number of events.
+     * @return Status code indicating failure or success. CELIX_SUCCESS if no errors are encountered. If an error is encountered, it should be a celix errno.
+     */
+    celix_status_t (*postEvents)(void* handle, const char* topic, const celix_properties_t* const* properties, size_t size);
 }celix_event_admin_service_t;
 
 #ifdef __cplusplus
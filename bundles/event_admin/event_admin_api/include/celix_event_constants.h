@@ -61,6 +61,15 @@ extern "C" {
  */
 #define CELIX_EVENT_DELIVERY "event.delivery"
 
+/**
+ * @brief Service Registration property specifying the maximum number of asynchronously delivered events, which are
+ * passed to the Event Handler in a single celix_event_handler_service_t::handleEvents call.
+ * The type of the value for this service property is Long. If it is not set or smaller than 2, the events are delivered
+ * one by one with celix_event_handler_service_t::handleEvent.
+ * @note An Event Handler which sets this property must provide the handleEvents method (event handler service version 1.1.0).
+ */
+#define CELIX_EVENT_BATCH_SIZE "event.batch.size"
+
 /**
  * @brief Service Registration property specifying a filter to further select Event s of interest to an Event Handler service.
  * The type of the value for this service property is String.
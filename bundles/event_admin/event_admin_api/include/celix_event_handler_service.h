@@ -23,6 +23,8 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+
 #include "celix_properties.h"
 #include "celix_errno.h"
 
@@ -34,9 +36,16 @@ extern "C" {
 /**
  * @brief Version of the event handler service
  */
-#define CELIX_EVENT_HANDLER_SERVICE_VERSION "1.0.0"
+#define CELIX_EVENT_HANDLER_SERVICE_VERSION "1.1.0"
 #define CELIX_EVENT_HANDLER_SERVICE_USE_RANGE "[1.0.0,2)"
 
+/**
+ * @brief An event as passed to celix_event_handler_service_t::handleEvents.
+ */
+typedef struct celix_event_entry {
+    const char* topic;
+    const celix_properties_t* properties;
+}celix_event_entry_t;
 
 /**
  * @brief Listener for Events.
@@ -58,6 +67,19 @@ typedef struct celix_event_handler_service {
      * @see CELIX_EVENT_TOPIC, CELIX_EVENT_FILTER, CELIX_EVENT_DELIVERY
      */
     celix_status_t (*handleEvent)(void* handle, const char* topic, const celix_properties_t* properties);
+    /**
+     * @brief Handle a batch of asynchronously delivered events. Called by the event admin instead of handleEvent,
+     * if the event handler is registered with the CELIX_EVENT_BATCH_SIZE service property.
+     * @details The events are passed in delivery order. Synchronously delivered events are always passed to handleEvent.
+     * @note Added in version 1.1.0 of the service. It is only used if the CELIX_EVENT_BATCH_SIZE service property is set.
+     * @param[in] handle The handle as provided by the service registration.
+     * @param[in] events The events, the array and the events are only valid during the call.
+     * @param[in] size The number of events, at most the value of the CELIX_EVENT_BATCH_SIZE service property.
+     * @return Status code indicating failure or success.
+     * CELIX_SUCCESS if no errors are encountered. If an error is encountered, it should be return celix errno.
+     * @see CELIX_EVENT_BATCH_SIZE
+     */
+    celix_status_t (*handleEvents)(void* handle, const celix_event_entry_t* events, size_t size);
 }celix_event_handler_service_t;
 
 #ifdef __cplusplus
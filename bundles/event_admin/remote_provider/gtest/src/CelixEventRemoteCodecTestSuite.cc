@@ -0,0 +1,229 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "celix_event_remote_codec.h"
+#include "celix_array_list.h"
+#include "celix_version.h"
+
+class CelixEventRemoteCodecTestSuite : public ::testing::Test {
+public:
+    CelixEventRemoteCodecTestSuite() {
+        celix_eventRemoteFrame_init(&frame);
+    }
+
+    ~CelixEventRemoteCodecTestSuite() override {
+        celix_eventRemoteFrame_deinit(&frame);
+        for (auto* props : decodedProperties) {
+            celix_properties_destroy(props);
+        }
+    }
+
+    celix_status_t decode(const void* data, size_t size) {
+        return celix_eventRemoteFrame_decode(data, size, [](void* handle, const char* topic, celix_properties_t* props) {
+            auto* suite = static_cast<CelixEventRemoteCodecTestSuite*>(handle);
+            suite->decodedTopics.emplace_back(topic);
+            suite->decodedProperties.push_back(props);
+        }, this);
+    }
+
+    celix_event_remote_frame_t frame{};
+    std::vector<std::string> decodedTopics{};
+    std::vector<celix_properties_t*> decodedProperties{};
+};
+
+TEST_F(CelixEventRemoteCodecTestSuite, EncodeAndDecodeEventWithAllPropertyTypesTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_set(props, "string", "value");
+    celix_properties_set(props, "emptyString", "");
+    celix_properties_setLong(props, "long", -1234567890123L);
+    celix_properties_setLong(props, "longMin", LONG_MIN);
+    celix_properties_setLong(props, "longMax", LONG_MAX);
+    celix_properties_setDouble(props, "double", 3.14);
+    celix_properties_setBool(props, "bool", true);
+    celix_properties_assignVersion(props, "version", celix_version_create(1, 2, 3, "qualifier"));
+    celix_array_list_t* strings = celix_arrayList_createStringArray();
+    celix_arrayList_addString(strings, "a");
+    celix_arrayList_addString(strings, "b");
+    celix_properties_assignArrayList(props, "strings", strings);
+    celix_array_list_t* longs = celix_arrayList_createLongArray();
+    celix_arrayList_addLong(longs, -1);
+    celix_arrayList_addLong(longs, 300);
+    celix_properties_assignArrayList(props, "longs", longs);
+    celix_array_list_t* doubles = celix_arrayList_createDoubleArray();
+    celix_arrayList_addDouble(doubles, -0.5);
+    celix_properties_assignArrayList(props, "doubles", doubles);
+    celix_array_list_t* bools = celix_arrayList_createBoolArray();
+    celix_arrayList_addBool(bools, false);
+    celix_arrayList_addBool(bools, true);
+    celix_properties_assignArrayList(props, "bools", bools);
+    celix_array_list_t* versions = celix_arrayList_createVersionArray();
+    celix_arrayList_assignVersion(versions, celix_version_create(2, 0, 0, nullptr));
+    celix_properties_assignArrayList(props, "versions", versions);
+
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test", props));
+    celix_eventRemoteFrame_end(&frame);
+    EXPECT_EQ(1u, frame.nrOfEvents);
+
+    ASSERT_EQ(CELIX_SUCCESS, decode(frame.data, frame.size));
+    ASSERT_EQ(1u, decodedTopics.size());
+    EXPECT_EQ("org/celix/test", decodedTopics[0]);
+    ASSERT_NE(nullptr, decodedProperties[0]);
+    EXPECT_TRUE(celix_properties_equals(props, decodedProperties[0]));
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_VERSION, celix_properties_getType(decodedProperties[0], "version"));
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_ARRAY_LIST, celix_properties_getType(decodedProperties[0], "versions"));
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, EncodeAndDecodeMultipleEventsTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_setLong(props, "seq", 0);
+    std::string longTopic(1024, 't');
+
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test1", props));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test2", nullptr));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, longTopic.c_str(), props));
+    celix_eventRemoteFrame_end(&frame);
+
+    ASSERT_EQ(CELIX_SUCCESS, decode(frame.data, frame.size));
+    ASSERT_EQ(3u, decodedTopics.size());
+    EXPECT_EQ("org/celix/test1", decodedTopics[0]);
+    EXPECT_EQ(0L, celix_properties_getAsLong(decodedProperties[0], "seq", -1));
+    EXPECT_EQ("org/celix/test2", decodedTopics[1]);
+    EXPECT_EQ(nullptr, decodedProperties[1]);
+    EXPECT_EQ(longTopic, decodedTopics[2]);
+    EXPECT_EQ(0L, celix_properties_getAsLong(decodedProperties[2], "seq", -1));
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, ReuseFrameTest) {
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test1", nullptr));
+    celix_eventRemoteFrame_end(&frame);
+
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test2", nullptr));
+    celix_eventRemoteFrame_end(&frame);
+
+    ASSERT_EQ(CELIX_SUCCESS, decode(frame.data, frame.size));
+    ASSERT_EQ(1u, decodedTopics.size());
+    EXPECT_EQ("org/celix/test2", decodedTopics[0]);
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, EncodedEventIsCompactTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_setLong(props, "id", 42);
+    celix_properties_setBool(props, "flag", true);
+
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "a/b", props));
+    celix_eventRemoteFrame_end(&frame);
+    //header + topic(1+3) + nrOfProperties(1) + id(1+2 +1 +1) + flag(1+4 +1 +1)
+    EXPECT_EQ((size_t)CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE + 17, frame.size);
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, AddEventWithoutTopicTest) {
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, celix_eventRemoteFrame_addEvent(&frame, nullptr, nullptr));
+    EXPECT_EQ(0u, frame.nrOfEvents);
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, AddEventExceedingMaxFrameSizeTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    std::string largeValue(CELIX_EVENT_REMOTE_MAX_FRAME_SIZE / 2, 'v');
+    celix_properties_set(props, "large", largeValue.c_str());
+
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test1", props));
+    size_t sizeAfterFirstEvent = frame.size;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test2", props));
+    EXPECT_EQ(sizeAfterFirstEvent, frame.size);//the failed event is removed from the frame
+    celix_eventRemoteFrame_end(&frame);
+
+    ASSERT_EQ(CELIX_SUCCESS, decode(frame.data, frame.size));
+    ASSERT_EQ(1u, decodedTopics.size());
+    EXPECT_EQ("org/celix/test1", decodedTopics[0]);
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, DecodeInvalidFrameTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_setBool(props, "bool", true);
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test", props));
+    celix_eventRemoteFrame_end(&frame);
+    std::vector<uint8_t> data{frame.data, frame.data + frame.size};
+
+    //too small for a header
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(data.data(), CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE - 1));
+
+    //invalid magic
+    auto invalid = data;
+    invalid[0] ^= 0xFF;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(invalid.data(), invalid.size()));
+
+    //truncated payload
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(data.data(), data.size() - 1));
+
+    //truncated payload with a matching payload size
+    for (size_t size = CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE; size < data.size(); ++size) {
+        invalid = std::vector<uint8_t>{data.begin(), data.begin() + (long)size};
+        uint32_t payloadSize = (uint32_t)(size - CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE);
+        memcpy(invalid.data() + 4, &payloadSize, sizeof(payloadSize));//test runs on little endian hosts
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(invalid.data(), invalid.size())) << "size " << size;
+    }
+
+    //invalid bool value, the bool value is the last byte of the frame
+    invalid = data;
+    invalid.back() = 2;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(invalid.data(), invalid.size()));
+
+    //no events are decoded from invalid frames
+    EXPECT_TRUE(decodedTopics.empty());
+
+    //trailing data, the frame is validated before the events are decoded
+    invalid = data;
+    invalid.push_back(0);
+    uint32_t payloadSize = (uint32_t)(invalid.size() - CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE);
+    memcpy(invalid.data() + 4, &payloadSize, sizeof(payloadSize));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(invalid.data(), invalid.size()));
+    EXPECT_TRUE(decodedTopics.empty());
+}
+
+TEST_F(CelixEventRemoteCodecTestSuite, DecodeFrameWithInvalidLastEventTest) {
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    celix_properties_setBool(props, "bool", true);
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_begin(&frame));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test1", props));
+    ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteFrame_addEvent(&frame, "org/celix/test2", props));
+    celix_eventRemoteFrame_end(&frame);
+    std::vector<uint8_t> invalid{frame.data, frame.data + frame.size};
+
+    //the bool value of the last event is invalid, none of the events are passed to the callback
+    invalid.back() = 2;
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, decode(invalid.data(), invalid.size()));
+    EXPECT_TRUE(decodedTopics.empty());
+
+    invalid.back() = 1;
+    EXPECT_EQ(CELIX_SUCCESS, decode(invalid.data(), invalid.size()));
+    EXPECT_EQ(2u, decodedTopics.size());
+}
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "celix_event_admin_service.h"
+#include "celix_event_handler_service.h"
+#include "celix_event_constants.h"
+#include "celix_bundle_context.h"
+#include "celix_framework_factory.h"
+#include "celix_constants.h"
+
+class CelixEventRemoteProviderIntegrationTestSuite : public ::testing::Test {
+public:
+    CelixEventRemoteProviderIntegrationTestSuite() = default;
+
+    ~CelixEventRemoteProviderIntegrationTestSuite() override {
+        if (handlerSvcId >= 0) {
+            celix_bundleContext_unregisterService(celix_framework_getFrameworkContext(receiverFw.get()), handlerSvcId);
+        }
+    }
+
+    static std::shared_ptr<celix_framework_t> createFramework(const std::string& name, celix_properties_t* props) {
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, (".event_remote_provider_" + name + "_cache").c_str());
+        auto fwPtr = celix_frameworkFactory_createFramework(props);
+        EXPECT_NE(nullptr, fwPtr);
+        auto ctx = celix_framework_getFrameworkContext(fwPtr);
+        EXPECT_GE(celix_bundleContext_installBundle(ctx, EVENT_ADMIN_BUNDLE, true), 0);
+        EXPECT_GE(celix_bundleContext_installBundle(ctx, EVENT_ADMIN_REMOTE_PROVIDER_BUNDLE, true), 0);
+        return std::shared_ptr<celix_framework_t>{fwPtr, [](celix_framework_t* f) { celix_frameworkFactory_destroyFramework(f); }};
+    }
+
+    void createFrameworks(const std::string& peer, celix_properties_t* receiverProps) {
+        receiverFw = createFramework("receiver", receiverProps);
+        auto senderProps = celix_properties_create();
+        celix_properties_set(senderProps, "CELIX_EVENT_REMOTE_PROVIDER_TOPICS", "org/celix/remote/*");
+        celix_properties_set(senderProps, "CELIX_EVENT_REMOTE_PROVIDER_PEERS", peer.c_str());
+        senderFw = createFramework("sender", senderProps);
+
+        handlerSvc.handle = this;
+        handlerSvc.handleEvent = [](void* handle, const char* topic, const celix_properties_t* props) -> celix_status_t {
+            auto* suite = static_cast<CelixEventRemoteProviderIntegrationTestSuite*>(handle);
+            std::lock_guard<std::mutex> lock{suite->mutex};
+            suite->receivedTopic = topic;
+            suite->receivedId = celix_properties_getAsLong(props, "id", -1);
+            suite->receivedRemote = celix_properties_getAsBool(props, "celix.event.remote", false);
+            suite->nrOfReceivedEvents++;
+            suite->cond.notify_all();
+            return CELIX_SUCCESS;
+        };
+        auto handlerProps = celix_properties_create();
+        celix_properties_set(handlerProps, CELIX_EVENT_TOPIC, "org/celix/remote/*");
+        celix_service_registration_options_t opts{};
+        opts.svc = &handlerSvc;
+        opts.serviceName = CELIX_EVENT_HANDLER_SERVICE_NAME;
+        opts.serviceVersion = CELIX_EVENT_HANDLER_SERVICE_VERSION;
+        opts.properties = handlerProps;
+        handlerSvcId = celix_bundleContext_registerServiceWithOptions(celix_framework_getFrameworkContext(receiverFw.get()), &opts);
+        ASSERT_GE(handlerSvcId, 0);
+    }
+
+    void postEventAndWaitForRemoteEvent() {
+        auto ctx = celix_framework_getFrameworkContext(senderFw.get());
+        celix_bundleContext_waitForEvents(ctx);
+        celix_bundleContext_waitForEvents(celix_framework_getFrameworkContext(receiverFw.get()));
+        celix_service_use_options_t opts{};
+        opts.filter.serviceName = CELIX_EVENT_ADMIN_SERVICE_NAME;
+        opts.callbackHandle = nullptr;
+        opts.use = [](void*, void* svc) {
+            auto* ea = static_cast<celix_event_admin_service_t*>(svc);
+            celix_autoptr(celix_properties_t) props = celix_properties_create();
+            celix_properties_setLong(props, "id", 42);
+            auto status = ea->postEvent(ea->handle, "org/celix/remote/test", props);
+            EXPECT_EQ(CELIX_SUCCESS, status);
+        };
+        opts.waitTimeoutInSeconds = 30;
+        ASSERT_TRUE(celix_bundleContext_useServiceWithOptions(ctx, &opts));
+
+        std::unique_lock<std::mutex> lock{mutex};
+        ASSERT_TRUE(cond.wait_for(lock, std::chrono::seconds{30}, [this] { return nrOfReceivedEvents > 0; }));
+        EXPECT_EQ("org/celix/remote/test", receivedTopic);
+        EXPECT_EQ(42, receivedId);
+        EXPECT_TRUE(receivedRemote);
+    }
+
+    std::shared_ptr<celix_framework_t> receiverFw{};
+    std::shared_ptr<celix_framework_t> senderFw{};
+    celix_event_handler_service_t handlerSvc{};
+    long handlerSvcId{-1};
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    int nrOfReceivedEvents{0};
+    std::string receivedTopic{};
+    long receivedId{-1};
+    bool receivedRemote{false};
+};
+
+TEST_F(CelixEventRemoteProviderIntegrationTestSuite, ForwardEventOverShmTest) {
+    std::string shmName = "celix_event_remote_provider_test_" + std::to_string(getpid());
+    auto props = celix_properties_create();
+    celix_properties_set(props, "CELIX_EVENT_REMOTE_PROVIDER_SHM_NAME", shmName.c_str());
+    createFrameworks("shm://" + shmName, props);
+    postEventAndWaitForRemoteEvent();
+}
+
+TEST_F(CelixEventRemoteProviderIntegrationTestSuite, ForwardEventOverTcpTest) {
+    //find a free port
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(0, getsockname(fd, (struct sockaddr*)&addr, &len));
+    close(fd);
+    int port = ntohs(addr.sin_port);
+
+    auto props = celix_properties_create();
+    celix_properties_set(props, "CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST", "127.0.0.1");
+    celix_properties_setLong(props, "CELIX_EVENT_REMOTE_PROVIDER_TCP_PORT", port);
+    createFrameworks("tcp://127.0.0.1:" + std::to_string(port), props);
+    postEventAndWaitForRemoteEvent();
+}
@@ -0,0 +1,407 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "celix_event_remote_codec.h"
+#include "celix_event_remote_shm.h"
+#include "celix_event_remote_tcp.h"
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_framework_factory.h"
+#include "celix_log_helper.h"
+#include "shm_pool.h"
+
+class CelixEventRemoteTransportTestSuite : public ::testing::Test {
+public:
+    static constexpr int NR_OF_FRAMES = 2000;
+    static constexpr int EVENTS_PER_FRAME = 64;
+
+    CelixEventRemoteTransportTestSuite() {
+        auto props = celix_properties_create();
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".event_remote_transport_test_cache");
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, "CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "info");
+        auto fwPtr = celix_frameworkFactory_createFramework(props);
+        fw = std::shared_ptr<celix_framework_t>{fwPtr, [](celix_framework_t* f) { celix_frameworkFactory_destroyFramework(f); }};
+        ctx = celix_framework_getFrameworkContext(fw.get());
+        logHelper = std::shared_ptr<celix_log_helper_t>{celix_logHelper_create(ctx, "EventRemoteTransportTest"),
+                                                        [](celix_log_helper_t* l) { celix_logHelper_destroy(l); }};
+        celix_eventRemoteFrame_init(&frame);
+        shmName = "celix_event_remote_test_" + std::to_string(getpid());
+    }
+
+    ~CelixEventRemoteTransportTestSuite() override {
+        celix_eventRemoteFrame_deinit(&frame);
+    }
+
+    static void frameReceived(void* handle, const void* data, size_t size) {
+        auto* suite = static_cast<CelixEventRemoteTransportTestSuite*>(handle);
+        size_t decoded = 0;
+        auto status = celix_eventRemoteFrame_decode(data, size, [](void* handle, const char*, celix_properties_t* props) {
+            (*static_cast<size_t*>(handle))++;
+            celix_properties_destroy(props);
+        }, &decoded);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        std::unique_lock<std::mutex> lock{suite->mutex};
+        suite->receivedEvents += decoded;
+        suite->receivedFrames++;
+        suite->cond.notify_all();
+    }
+
+    void createFrame(int nrOfEvents) {
+        celix_autoptr(celix_properties_t) props = celix_properties_create();
+        celix_properties_setLong(props, "id", 42);
+        celix_properties_set(props, "source", "CelixEventRemoteTransportTestSuite");
+        celix_properties_setDouble(props, "value", 1.5);
+        celix_eventRemoteFrame_begin(&frame);
+        for (int i = 0; i < nrOfEvents; ++i) {
+            celix_eventRemoteFrame_addEvent(&frame, "org/celix/remote/test", props);
+        }
+        celix_eventRemoteFrame_end(&frame);
+    }
+
+    /**
+     * @brief Binds a datagram socket to the shm name, which receives the messages of a shm sender but never reads
+     * the frames, like a shm receiver which is gone before it consumed its frames.
+     */
+    int bindNotConsumingShmReceiver() {
+        int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        EXPECT_GE(fd, 0);
+        struct sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(&addr.sun_path[1], shmName.c_str(), sizeof(addr.sun_path) - 2);
+        EXPECT_EQ(0, bind(fd, (const struct sockaddr*)&addr, sizeof(addr)));
+        return fd;
+    }
+
+    bool waitForEvents(size_t nrOfEvents, std::chrono::seconds timeout = std::chrono::seconds{30}) {
+        std::unique_lock<std::mutex> lock{mutex};
+        return cond.wait_for(lock, timeout, [&] { return receivedEvents >= nrOfEvents; });
+    }
+
+    void printThroughput(const char* transport, std::chrono::steady_clock::time_point start) {
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double eventsPerSecond = (double)receivedEvents / elapsed;
+        RecordProperty("eventsPerSecond", std::to_string((long)eventsPerSecond));
+        printf("%s loopback: %zu events in %zu frames (%zu bytes/frame) in %.3f s, %.0f events/s\n", transport,
+               receivedEvents, receivedFrames, frame.size, elapsed, eventsPerSecond);
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    celix_bundle_context_t* ctx{};
+    std::shared_ptr<celix_log_helper_t> logHelper{};
+    celix_event_remote_frame_t frame{};
+    std::string shmName{};
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    size_t receivedEvents{0};
+    size_t receivedFrames{0};
+};
+
+TEST_F(CelixEventRemoteTransportTestSuite, TcpLoopbackThroughputTest) {
+    celix_autoptr(celix_event_remote_tcp_receiver_t) receiver =
+        celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", 0, frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    int port = celix_eventRemoteTcpReceiver_getPort(receiver);
+    EXPECT_GT(port, 0);
+    celix_autoptr(celix_event_remote_tcp_sender_t) sender = celix_eventRemoteTcpSender_create(logHelper.get(), "127.0.0.1", port);
+    ASSERT_NE(nullptr, sender);
+
+    createFrame(EVENTS_PER_FRAME);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NR_OF_FRAMES; ++i) {
+        ASSERT_EQ(CELIX_SUCCESS, celix_eventRemoteTcpSender_send(sender, frame.data, frame.size));
+    }
+    ASSERT_TRUE(waitForEvents(NR_OF_FRAMES * EVENTS_PER_FRAME));
+    printThroughput("tcp", start);
+    EXPECT_EQ((size_t)NR_OF_FRAMES, receivedFrames);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmLoopbackThroughputTest) {
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 1024 * 1024, 10.0);
+    ASSERT_NE(nullptr, sender);
+
+    createFrame(EVENTS_PER_FRAME);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NR_OF_FRAMES; ++i) {
+        celix_status_t status;
+        while ((status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size)) == CELIX_ENOMEM) {
+            usleep(10);//all frames in the pool are waiting to be consumed by the receiver
+        }
+        ASSERT_EQ(CELIX_SUCCESS, status);
+    }
+    ASSERT_TRUE(waitForEvents(NR_OF_FRAMES * EVENTS_PER_FRAME));
+    printThroughput("shm", start);
+    EXPECT_EQ((size_t)NR_OF_FRAMES, receivedFrames);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, TcpSenderWithoutReceiverTest) {
+    //find a free port
+    int port;
+    {
+        celix_autoptr(celix_event_remote_tcp_receiver_t) receiver =
+            celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", 0, frameReceived, this);
+        ASSERT_NE(nullptr, receiver);
+        port = celix_eventRemoteTcpReceiver_getPort(receiver);
+    }
+    celix_autoptr(celix_event_remote_tcp_sender_t) sender = celix_eventRemoteTcpSender_create(logHelper.get(), "127.0.0.1", port);
+    ASSERT_NE(nullptr, sender);
+    createFrame(1);
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_eventRemoteTcpSender_send(sender, frame.data, frame.size));
+    EXPECT_EQ(CELIX_ILLEGAL_STATE, celix_eventRemoteTcpSender_send(sender, frame.data, frame.size));//no reconnect within a second
+
+    //The sender connects, once the receiver is available and the reconnect interval is passed.
+    celix_autoptr(celix_event_remote_tcp_receiver_t) receiver =
+        celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", port, frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    sleep(1);
+    EXPECT_EQ(CELIX_SUCCESS, celix_eventRemoteTcpSender_send(sender, frame.data, frame.size));
+    EXPECT_TRUE(waitForEvents(1));
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, TcpReceiverReassemblesFramesTest) {
+    celix_autoptr(celix_event_remote_tcp_receiver_t) receiver =
+        celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", 0, frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)celix_eventRemoteTcpReceiver_getPort(receiver));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(fd, (sockaddr*)&addr, sizeof(addr)));
+
+    createFrame(2);
+    //a frame split over multiple writes
+    for (size_t i = 0; i < frame.size; ++i) {
+        ASSERT_EQ(1, write(fd, frame.data + i, 1));
+    }
+    EXPECT_TRUE(waitForEvents(2));
+
+    //multiple frames in a single write
+    std::string frames{(const char*)frame.data, frame.size};
+    frames += frames;
+    ASSERT_EQ((ssize_t)frames.size(), write(fd, frames.data(), frames.size()));
+    EXPECT_TRUE(waitForEvents(6));
+    EXPECT_EQ(3u, receivedFrames);
+    close(fd);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, TcpReceiverClosesConnectionWithInvalidFrameTest) {
+    celix_autoptr(celix_event_remote_tcp_receiver_t) receiver =
+        celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", 0, frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)celix_eventRemoteTcpReceiver_getPort(receiver));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(fd, (sockaddr*)&addr, sizeof(addr)));
+
+    char garbage[CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE] = "not a frame";
+    ASSERT_EQ((ssize_t)sizeof(garbage), write(fd, garbage, sizeof(garbage)));
+    char buf[1];
+    EXPECT_EQ(0, read(fd, buf, sizeof(buf)));//closed by the receiver
+    EXPECT_EQ(0u, receivedFrames);
+    close(fd);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmSenderWithoutReceiverTest) {
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 64 * 1024, 10.0);
+    ASSERT_NE(nullptr, sender);
+    createFrame(1);
+    celix_status_t status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size);
+    EXPECT_EQ(CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, ECONNREFUSED), status);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmSenderReusesConsumedFramesTest) {
+    std::mutex blockMutex{};
+    bool blocked{true};
+    std::condition_variable blockCond{};
+    struct BlockingHandle {
+        CelixEventRemoteTransportTestSuite* suite;
+        std::mutex* mutex;
+        bool* blocked;
+        std::condition_variable* cond;
+    } handle{this, &blockMutex, &blocked, &blockCond};
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), [](void* handle, const void* data, size_t size) {
+            auto* h = static_cast<BlockingHandle*>(handle);
+            {
+                std::unique_lock<std::mutex> lock{*h->mutex};
+                h->cond->wait(lock, [h] { return !*h->blocked; });
+            }
+            frameReceived(h->suite, data, size);
+        }, &handle);
+    ASSERT_NE(nullptr, receiver);
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 32 * 1024, 10.0);
+    ASSERT_NE(nullptr, sender);
+
+    createFrame(EVENTS_PER_FRAME);
+    int sentFrames = 0;
+    celix_status_t status;
+    while ((status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size)) == CELIX_SUCCESS) {
+        sentFrames++;
+    }
+    //the pool, which is smaller than the datagram queue of the receiver, is exhausted by the frames which are not consumed
+    EXPECT_EQ(CELIX_ENOMEM, status);
+    EXPECT_GT(sentFrames, 0);
+
+    {
+        std::unique_lock<std::mutex> lock{blockMutex};
+        blocked = false;
+        blockCond.notify_all();
+    }
+    ASSERT_TRUE(waitForEvents((size_t)sentFrames * EVENTS_PER_FRAME));
+
+    //the consumed frames are released
+    for (int i = 0; i < sentFrames; ++i) {
+        EXPECT_EQ(CELIX_SUCCESS, celix_eventRemoteShmSender_send(sender, frame.data, frame.size));
+        ASSERT_TRUE(waitForEvents((size_t)(sentFrames + i + 1) * EVENTS_PER_FRAME));
+    }
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmSenderReclaimsFramesOfGonePeerTest) {
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 32 * 1024, 10.0);
+    ASSERT_NE(nullptr, sender);
+    createFrame(EVENTS_PER_FRAME);
+
+    int fd = bindNotConsumingShmReceiver();
+    celix_status_t status;
+    while ((status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size)) == CELIX_SUCCESS) {}
+    EXPECT_EQ(CELIX_ENOMEM, status);
+    close(fd);
+
+    //the failed send to the gone peer reclaims the frames which the peer did not read
+    EXPECT_EQ(CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, ECONNREFUSED), celix_eventRemoteShmSender_send(sender, frame.data, frame.size));
+
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    EXPECT_EQ(CELIX_SUCCESS, celix_eventRemoteShmSender_send(sender, frame.data, frame.size));
+    ASSERT_TRUE(waitForEvents(EVENTS_PER_FRAME));
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmSenderReclaimsFramesAfterReceiverRestartTest) {
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 32 * 1024, 0.5);
+    ASSERT_NE(nullptr, sender);
+    createFrame(EVENTS_PER_FRAME);
+
+    int fd = bindNotConsumingShmReceiver();
+    celix_status_t status;
+    while ((status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size)) == CELIX_SUCCESS) {}
+    EXPECT_EQ(CELIX_ENOMEM, status);
+
+    //the receiver restarts before the sender notices that the peer was gone
+    close(fd);
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+
+    //the frames which are not read within the consume timeout are reclaimed
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while ((status = celix_eventRemoteShmSender_send(sender, frame.data, frame.size)) == CELIX_ENOMEM &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    }
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    ASSERT_TRUE(waitForEvents(EVENTS_PER_FRAME));
+    EXPECT_EQ(1u, receivedFrames);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, ShmReceiverRejectsOutOfRangeFramesTest) {
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    celix_autoptr(shm_pool_t) pool = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, shmPool_create(8192, &pool));
+    void* mem = shmPool_malloc(pool, 128);
+    ASSERT_NE(nullptr, mem);
+
+    //messages with the layout of the shm receiver, which refer to memory outside the shared memory
+    struct {
+        int shmId;
+        ssize_t blockOffset;
+        size_t frameSize;
+        uint64_t seq;
+    } msgs[] = {
+        {shmPool_getShmId(pool), 16 * 1024 * 1024, 16, 0},//block out of range
+        {shmPool_getShmId(pool), shmPool_getMemoryOffset(pool, mem), 1024 * 1024, 0},//frame out of range
+        {shmPool_getShmId(pool), shmPool_getMemoryOffset(pool, mem), SIZE_MAX, 0},//frame size overflow
+    };
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(&addr.sun_path[1], shmName.c_str(), sizeof(addr.sun_path) - 2);
+    for (const auto& msg : msgs) {
+        EXPECT_EQ((ssize_t)sizeof(msg), sendto(fd, &msg, sizeof(msg), 0, (const struct sockaddr*)&addr, sizeof(addr)));
+    }
+    close(fd);
+    shmPool_free(pool, mem);
+
+    //the receiver is still receiving valid frames
+    celix_autoptr(celix_event_remote_shm_sender_t) sender =
+        celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 32 * 1024, 10.0);
+    ASSERT_NE(nullptr, sender);
+    createFrame(EVENTS_PER_FRAME);
+    EXPECT_EQ(CELIX_SUCCESS, celix_eventRemoteShmSender_send(sender, frame.data, frame.size));
+    ASSERT_TRUE(waitForEvents(EVENTS_PER_FRAME));
+    EXPECT_EQ(1u, receivedFrames);
+}
+
+TEST_F(CelixEventRemoteTransportTestSuite, CreateReceiversWithInvalidArgumentsTest) {
+    std::string longName(200, 'n');
+    EXPECT_EQ(nullptr, celix_eventRemoteShmReceiver_create(logHelper.get(), longName.c_str(), frameReceived, this));
+    EXPECT_EQ(nullptr, celix_eventRemoteShmSender_create(logHelper.get(), longName.c_str(), 64 * 1024, 10.0));
+    EXPECT_EQ(nullptr, celix_eventRemoteShmSender_create(logHelper.get(), shmName.c_str(), 16, 10.0));//pool too small
+
+    celix_autoptr(celix_event_remote_shm_receiver_t) receiver =
+        celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this);
+    ASSERT_NE(nullptr, receiver);
+    EXPECT_EQ(nullptr, celix_eventRemoteShmReceiver_create(logHelper.get(), shmName.c_str(), frameReceived, this));//name in use
+
+    celix_autoptr(celix_event_remote_tcp_receiver_t) tcpReceiver =
+        celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1", 0, frameReceived, this);
+    ASSERT_NE(nullptr, tcpReceiver);
+    EXPECT_EQ(nullptr, celix_eventRemoteTcpReceiver_create(logHelper.get(), "127.0.0.1",
+                                                           celix_eventRemoteTcpReceiver_getPort(tcpReceiver), frameReceived, this));//port in use
+    EXPECT_EQ(nullptr, celix_eventRemoteTcpReceiver_create(logHelper.get(), "invalid host name", 0, frameReceived, this));
+}
@@ -0,0 +1,603 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "celix_event_remote_codec.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_array_list.h"
+#include "celix_version.h"
+
+#define CELIX_EVENT_REMOTE_FRAME_INITIAL_CAPACITY 512
+#define CELIX_EVENT_REMOTE_MAX_VARINT_SIZE 10
+
+//The value types on the wire, they are independent of the celix_properties_value_type_e values.
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_STRING 1
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_LONG 2
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE 3
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL 4
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_VERSION 5
+#define CELIX_EVENT_REMOTE_VALUE_TYPE_ARRAY 6
+
+//The scratch buffers of the decoder, the topic must stay valid while the properties of the event are decoded.
+#define CELIX_EVENT_REMOTE_SCRATCH_TOPIC 0
+#define CELIX_EVENT_REMOTE_SCRATCH_KEY 1
+#define CELIX_EVENT_REMOTE_SCRATCH_VALUE 2
+#define CELIX_EVENT_REMOTE_SCRATCH_COUNT 3
+
+void celix_eventRemoteFrame_init(celix_event_remote_frame_t* frame) {
+    memset(frame, 0, sizeof(*frame));
+}
+
+void celix_eventRemoteFrame_deinit(celix_event_remote_frame_t* frame) {
+    free(frame->data);
+    memset(frame, 0, sizeof(*frame));
+}
+
+static celix_status_t celix_eventRemoteFrame_reserve(celix_event_remote_frame_t* frame, size_t extra) {
+    if (extra > CELIX_EVENT_REMOTE_MAX_FRAME_SIZE - frame->size) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    size_t required = frame->size + extra;
+    if (required <= frame->capacity) {
+        return CELIX_SUCCESS;
+    }
+    size_t capacity = frame->capacity == 0 ? CELIX_EVENT_REMOTE_FRAME_INITIAL_CAPACITY : frame->capacity;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    uint8_t* data = realloc(frame->data, capacity);
+    if (data == NULL) {
+        return CELIX_ENOMEM;
+    }
+    frame->data = data;
+    frame->capacity = capacity;
+    return CELIX_SUCCESS;
+}
+
+static void celix_eventRemoteFrame_putUint32(uint8_t* dst, uint32_t value) {
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t celix_eventRemoteFrame_getUint32(const uint8_t* src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static celix_status_t celix_eventRemoteFrame_writeByte(celix_event_remote_frame_t* frame, uint8_t value) {
+    celix_status_t status = celix_eventRemoteFrame_reserve(frame, 1);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    frame->data[frame->size++] = value;
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeVarint(celix_event_remote_frame_t* frame, uint64_t value) {
+    celix_status_t status = celix_eventRemoteFrame_reserve(frame, CELIX_EVENT_REMOTE_MAX_VARINT_SIZE);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    while (value >= 0x80) {
+        frame->data[frame->size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    frame->data[frame->size++] = (uint8_t)value;
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeLong(celix_event_remote_frame_t* frame, long value) {
+    uint64_t uv = (uint64_t)value;
+    return celix_eventRemoteFrame_writeVarint(frame, (uv << 1) ^ (0 - (uv >> 63)));//zigzag encoding
+}
+
+static celix_status_t celix_eventRemoteFrame_writeDouble(celix_event_remote_frame_t* frame, double value) {
+    celix_status_t status = celix_eventRemoteFrame_reserve(frame, sizeof(uint64_t));
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    celix_eventRemoteFrame_putUint32(frame->data + frame->size, (uint32_t)bits);
+    celix_eventRemoteFrame_putUint32(frame->data + frame->size + 4, (uint32_t)(bits >> 32));
+    frame->size += sizeof(uint64_t);
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeString(celix_event_remote_frame_t* frame, const char* str) {
+    size_t len = strlen(str);
+    celix_status_t status = celix_eventRemoteFrame_writeVarint(frame, len);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    status = celix_eventRemoteFrame_reserve(frame, len);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    memcpy(frame->data + frame->size, str, len);
+    frame->size += len;
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeVersion(celix_event_remote_frame_t* frame, const celix_version_t* version) {
+    celix_status_t status = celix_eventRemoteFrame_writeVarint(frame, (uint64_t)celix_version_getMajor(version));
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeVarint(frame, (uint64_t)celix_version_getMinor(version));
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeVarint(frame, (uint64_t)celix_version_getMicro(version));
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeString(frame, celix_version_getQualifier(version));
+    return status;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeArray(celix_event_remote_frame_t* frame, const celix_array_list_t* array) {
+    uint8_t elementType;
+    switch (celix_arrayList_getElementType(array)) {
+    case CELIX_ARRAY_LIST_ELEMENT_TYPE_STRING:
+        elementType = CELIX_EVENT_REMOTE_VALUE_TYPE_STRING;
+        break;
+    case CELIX_ARRAY_LIST_ELEMENT_TYPE_LONG:
+        elementType = CELIX_EVENT_REMOTE_VALUE_TYPE_LONG;
+        break;
+    case CELIX_ARRAY_LIST_ELEMENT_TYPE_DOUBLE:
+        elementType = CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE;
+        break;
+    case CELIX_ARRAY_LIST_ELEMENT_TYPE_BOOL:
+        elementType = CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL;
+        break;
+    case CELIX_ARRAY_LIST_ELEMENT_TYPE_VERSION:
+        elementType = CELIX_EVENT_REMOTE_VALUE_TYPE_VERSION;
+        break;
+    default:
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    int size = celix_arrayList_size(array);
+    celix_status_t status = celix_eventRemoteFrame_writeByte(frame, elementType);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeVarint(frame, (uint64_t)size);
+    for (int i = 0; i < size && status == CELIX_SUCCESS; ++i) {
+        switch (elementType) {
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_STRING:
+            status = celix_eventRemoteFrame_writeString(frame, celix_arrayList_getString(array, i));
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_LONG:
+            status = celix_eventRemoteFrame_writeLong(frame, celix_arrayList_getLong(array, i));
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE:
+            status = celix_eventRemoteFrame_writeDouble(frame, celix_arrayList_getDouble(array, i));
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL:
+            status = celix_eventRemoteFrame_writeByte(frame, celix_arrayList_getBool(array, i) ? 1 : 0);
+            break;
+        default:
+            status = celix_eventRemoteFrame_writeVersion(frame, celix_arrayList_getVersion(array, i));
+            break;
+        }
+    }
+    return status;
+}
+
+static celix_status_t celix_eventRemoteFrame_writeProperty(celix_event_remote_frame_t* frame, const char* key, const celix_properties_entry_t* entry) {
+    celix_status_t status = celix_eventRemoteFrame_writeString(frame, key);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    switch (entry->valueType) {
+    case CELIX_PROPERTIES_VALUE_TYPE_LONG:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_LONG);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeLong(frame, entry->typed.longValue);
+    case CELIX_PROPERTIES_VALUE_TYPE_DOUBLE:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeDouble(frame, entry->typed.doubleValue);
+    case CELIX_PROPERTIES_VALUE_TYPE_BOOL:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeByte(frame, entry->typed.boolValue ? 1 : 0);
+    case CELIX_PROPERTIES_VALUE_TYPE_VERSION:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_VERSION);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeVersion(frame, entry->typed.versionValue);
+    case CELIX_PROPERTIES_VALUE_TYPE_ARRAY_LIST:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_ARRAY);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeArray(frame, entry->typed.arrayValue);
+    default:
+        status = celix_eventRemoteFrame_writeByte(frame, CELIX_EVENT_REMOTE_VALUE_TYPE_STRING);
+        return status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeString(frame, entry->value);
+    }
+}
+
+celix_status_t celix_eventRemoteFrame_begin(celix_event_remote_frame_t* frame) {
+    frame->size = 0;
+    frame->nrOfEvents = 0;
+    celix_status_t status = celix_eventRemoteFrame_reserve(frame, CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    frame->size = CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE;
+    return CELIX_SUCCESS;
+}
+
+celix_status_t celix_eventRemoteFrame_addEvent(celix_event_remote_frame_t* frame, const char* topic, const celix_properties_t* properties) {
+    assert(frame->size >= CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE);
+    if (topic == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    size_t eventOffset = frame->size;
+    celix_status_t status = celix_eventRemoteFrame_writeString(frame, topic);
+    size_t nrOfProperties = properties == NULL ? 0 : celix_properties_size(properties);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteFrame_writeVarint(frame, nrOfProperties);
+    if (nrOfProperties > 0) {
+        CELIX_PROPERTIES_ITERATE(properties, iter) {
+            if (status != CELIX_SUCCESS) {
+                break;
+            }
+            status = celix_eventRemoteFrame_writeProperty(frame, iter.key, &iter.entry);
+        }
+    }
+    if (status != CELIX_SUCCESS) {
+        frame->size = eventOffset;
+        return status;
+    }
+    frame->nrOfEvents++;
+    return CELIX_SUCCESS;
+}
+
+void celix_eventRemoteFrame_end(celix_event_remote_frame_t* frame) {
+    assert(frame->size >= CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE);
+    celix_eventRemoteFrame_putUint32(frame->data, CELIX_EVENT_REMOTE_FRAME_MAGIC);
+    celix_eventRemoteFrame_putUint32(frame->data + 4, (uint32_t)(frame->size - CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE));
+    celix_eventRemoteFrame_putUint32(frame->data + 8, frame->nrOfEvents);
+}
+
+celix_status_t celix_eventRemoteFrame_decodeHeader(const void* data, size_t* payloadSize, uint32_t* nrOfEvents) {
+    const uint8_t* header = data;
+    if (celix_eventRemoteFrame_getUint32(header) != CELIX_EVENT_REMOTE_FRAME_MAGIC) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    uint32_t size = celix_eventRemoteFrame_getUint32(header + 4);
+    if (size > CELIX_EVENT_REMOTE_MAX_FRAME_SIZE - CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *payloadSize = size;
+    *nrOfEvents = celix_eventRemoteFrame_getUint32(header + 8);
+    return CELIX_SUCCESS;
+}
+
+typedef struct celix_event_remote_reader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    char* scratch[CELIX_EVENT_REMOTE_SCRATCH_COUNT];
+    size_t scratchCapacity[CELIX_EVENT_REMOTE_SCRATCH_COUNT];
+} celix_event_remote_reader_t;
+
+static celix_status_t celix_eventRemoteReader_readByte(celix_event_remote_reader_t* reader, uint8_t* value) {
+    if (reader->pos >= reader->end) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *value = *reader->pos++;
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteReader_readVarint(celix_event_remote_reader_t* reader, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->pos >= reader->end) {
+            return CELIX_ILLEGAL_ARGUMENT;
+        }
+        uint8_t byte = *reader->pos++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return CELIX_SUCCESS;
+        }
+    }
+    return CELIX_ILLEGAL_ARGUMENT;
+}
+
+static celix_status_t celix_eventRemoteReader_readLong(celix_event_remote_reader_t* reader, long* value) {
+    uint64_t uv;
+    celix_status_t status = celix_eventRemoteReader_readVarint(reader, &uv);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    *value = (long)((uv >> 1) ^ (0 - (uv & 1)));
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteReader_readInt(celix_event_remote_reader_t* reader, int* value) {
+    uint64_t uv;
+    celix_status_t status = celix_eventRemoteReader_readVarint(reader, &uv);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (uv > INT_MAX) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *value = (int)uv;
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteReader_readDouble(celix_event_remote_reader_t* reader, double* value) {
+    if ((size_t)(reader->end - reader->pos) < sizeof(uint64_t)) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    uint64_t bits = (uint64_t)celix_eventRemoteFrame_getUint32(reader->pos) |
+                    ((uint64_t)celix_eventRemoteFrame_getUint32(reader->pos + 4) << 32);
+    memcpy(value, &bits, sizeof(*value));
+    reader->pos += sizeof(uint64_t);
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteReader_readBool(celix_event_remote_reader_t* reader, bool* value) {
+    uint8_t byte;
+    celix_status_t status = celix_eventRemoteReader_readByte(reader, &byte);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (byte > 1) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *value = byte == 1;
+    return CELIX_SUCCESS;
+}
+
+/**
+ * @brief Reads a string into a scratch buffer of the reader. The string is valid until the scratch buffer is reused.
+ */
+static celix_status_t celix_eventRemoteReader_readString(celix_event_remote_reader_t* reader, int scratchIdx, const char** str) {
+    uint64_t len;
+    celix_status_t status = celix_eventRemoteReader_readVarint(reader, &len);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (len > (uint64_t)(reader->end - reader->pos)) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    if (len + 1 > reader->scratchCapacity[scratchIdx]) {
+        char* scratch = realloc(reader->scratch[scratchIdx], len + 1);
+        if (scratch == NULL) {
+            return CELIX_ENOMEM;
+        }
+        reader->scratch[scratchIdx] = scratch;
+        reader->scratchCapacity[scratchIdx] = len + 1;
+    }
+    memcpy(reader->scratch[scratchIdx], reader->pos, len);
+    reader->scratch[scratchIdx][len] = '\0';
+    reader->pos += len;
+    *str = reader->scratch[scratchIdx];
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_eventRemoteReader_readVersion(celix_event_remote_reader_t* reader, celix_version_t** version) {
+    int major;
+    int minor;
+    int micro;
+    const char* qualifier;
+    celix_status_t status = celix_eventRemoteReader_readInt(reader, &major);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readInt(reader, &minor);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readInt(reader, &micro);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readString(reader, CELIX_EVENT_REMOTE_SCRATCH_VALUE, &qualifier);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    *version = celix_version_create(major, minor, micro, qualifier);
+    return *version != NULL ? CELIX_SUCCESS : CELIX_ILLEGAL_ARGUMENT;
+}
+
+/**
+ * @brief Reads an array property. If properties is NULL, the array is only validated.
+ */
+static celix_status_t celix_eventRemoteReader_readArray(celix_event_remote_reader_t* reader, celix_properties_t* properties, const char* key) {
+    uint8_t elementType;
+    uint64_t size;
+    celix_status_t status = celix_eventRemoteReader_readByte(reader, &elementType);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readVarint(reader, &size);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (size > (uint64_t)(reader->end - reader->pos)) {//every element is at least 1 byte
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    if (elementType < CELIX_EVENT_REMOTE_VALUE_TYPE_STRING || elementType > CELIX_EVENT_REMOTE_VALUE_TYPE_VERSION) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_autoptr(celix_array_list_t) array = NULL;
+    if (properties != NULL) {
+        switch (elementType) {
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_STRING:
+            array = celix_arrayList_createStringArray();
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_LONG:
+            array = celix_arrayList_createLongArray();
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE:
+            array = celix_arrayList_createDoubleArray();
+            break;
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL:
+            array = celix_arrayList_createBoolArray();
+            break;
+        default:
+            array = celix_arrayList_createVersionArray();
+            break;
+        }
+        if (array == NULL) {
+            return CELIX_ENOMEM;
+        }
+    }
+    for (uint64_t i = 0; i < size && status == CELIX_SUCCESS; ++i) {
+        switch (elementType) {
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_STRING: {
+            const char* str;
+            status = celix_eventRemoteReader_readString(reader, CELIX_EVENT_REMOTE_SCRATCH_VALUE, &str);
+            status = status != CELIX_SUCCESS || array == NULL ? status : celix_arrayList_addString(array, str);
+            break;
+        }
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_LONG: {
+            long value;
+            status = celix_eventRemoteReader_readLong(reader, &value);
+            status = status != CELIX_SUCCESS || array == NULL ? status : celix_arrayList_addLong(array, value);
+            break;
+        }
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE: {
+            double value;
+            status = celix_eventRemoteReader_readDouble(reader, &value);
+            status = status != CELIX_SUCCESS || array == NULL ? status : celix_arrayList_addDouble(array, value);
+            break;
+        }
+        case CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL: {
+            bool value;
+            status = celix_eventRemoteReader_readBool(reader, &value);
+            status = status != CELIX_SUCCESS || array == NULL ? status : celix_arrayList_addBool(array, value);
+            break;
+        }
+        default: {
+            celix_version_t* version = NULL;
+            status = celix_eventRemoteReader_readVersion(reader, &version);
+            if (status == CELIX_SUCCESS && array == NULL) {
+                celix_version_destroy(version);
+            } else if (status == CELIX_SUCCESS) {
+                status = celix_arrayList_assignVersion(array, version);
+            }
+            break;
+        }
+        }
+    }
+    if (status != CELIX_SUCCESS || properties == NULL) {
+        return status;
+    }
+    return celix_properties_assignArrayList(properties, key, celix_steal_ptr(array));
+}
+
+/**
+ * @brief Reads a property. If properties is NULL, the property is only validated.
+ */
+static celix_status_t celix_eventRemoteReader_readProperty(celix_event_remote_reader_t* reader, celix_properties_t* properties) {
+    const char* key;
+    uint8_t type;
+    celix_status_t status = celix_eventRemoteReader_readString(reader, CELIX_EVENT_REMOTE_SCRATCH_KEY, &key);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readByte(reader, &type);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    switch (type) {
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_STRING: {
+        const char* value;
+        status = celix_eventRemoteReader_readString(reader, CELIX_EVENT_REMOTE_SCRATCH_VALUE, &value);
+        return status != CELIX_SUCCESS || properties == NULL ? status : celix_properties_set(properties, key, value);
+    }
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_LONG: {
+        long value;
+        status = celix_eventRemoteReader_readLong(reader, &value);
+        return status != CELIX_SUCCESS || properties == NULL ? status : celix_properties_setLong(properties, key, value);
+    }
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_DOUBLE: {
+        double value;
+        status = celix_eventRemoteReader_readDouble(reader, &value);
+        return status != CELIX_SUCCESS || properties == NULL ? status : celix_properties_setDouble(properties, key, value);
+    }
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_BOOL: {
+        bool value;
+        status = celix_eventRemoteReader_readBool(reader, &value);
+        return status != CELIX_SUCCESS || properties == NULL ? status : celix_properties_setBool(properties, key, value);
+    }
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_VERSION: {
+        celix_version_t* version = NULL;
+        status = celix_eventRemoteReader_readVersion(reader, &version);
+        if (status == CELIX_SUCCESS && properties == NULL) {
+            celix_version_destroy(version);
+            return CELIX_SUCCESS;
+        }
+        return status != CELIX_SUCCESS ? status : celix_properties_assignVersion(properties, key, version);
+    }
+    case CELIX_EVENT_REMOTE_VALUE_TYPE_ARRAY:
+        return celix_eventRemoteReader_readArray(reader, properties, key);
+    default:
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+}
+
+/**
+ * @brief Reads an event and passes it to the callback. If callback is NULL, the event is only validated.
+ */
+static celix_status_t celix_eventRemoteReader_readEvent(celix_event_remote_reader_t* reader, celix_event_remote_decoded_event_fp callback, void* handle) {
+    const char* topic;
+    uint64_t nrOfProperties;
+    celix_status_t status = celix_eventRemoteReader_readString(reader, CELIX_EVENT_REMOTE_SCRATCH_TOPIC, &topic);
+    status = status != CELIX_SUCCESS ? status : celix_eventRemoteReader_readVarint(reader, &nrOfProperties);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    celix_autoptr(celix_properties_t) properties = NULL;
+    if (nrOfProperties > 0 && callback != NULL) {
+        properties = celix_properties_create();
+        if (properties == NULL) {
+            return CELIX_ENOMEM;
+        }
+    }
+    for (uint64_t i = 0; i < nrOfProperties && status == CELIX_SUCCESS; ++i) {
+        status = celix_eventRemoteReader_readProperty(reader, properties);
+    }
+    if (status != CELIX_SUCCESS || callback == NULL) {
+        return status;
+    }
+    callback(handle, topic, celix_steal_ptr(properties));
+    return CELIX_SUCCESS;
+}
+
+/**
+ * @brief Reads all events of the payload. If callback is NULL, the events are only validated.
+ */
+static celix_status_t celix_eventRemoteReader_readEvents(celix_event_remote_reader_t* reader, uint32_t nrOfEvents,
+                                                         celix_event_remote_decoded_event_fp callback, void* handle) {
+    celix_status_t status = CELIX_SUCCESS;
+    for (uint32_t i = 0; i < nrOfEvents && status == CELIX_SUCCESS; ++i) {
+        status = celix_eventRemoteReader_readEvent(reader, callback, handle);
+    }
+    if (status == CELIX_SUCCESS && reader->pos != reader->end) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    }
+    return status;
+}
+
+celix_status_t celix_eventRemoteFrame_decode(const void* data, size_t size, celix_event_remote_decoded_event_fp callback, void* handle) {
+    if (size < CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    size_t payloadSize;
+    uint32_t nrOfEvents;
+    celix_status_t status = celix_eventRemoteFrame_decodeHeader(data, &payloadSize, &nrOfEvents);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (payloadSize != size - CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_event_remote_reader_t reader;
+    memset(&reader, 0, sizeof(reader));
+    reader.pos = (const uint8_t*)data + CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE;
+    reader.end = (const uint8_t*)data + size;
+    //validate the whole frame first, so that no events of a malformed frame are passed to the callback
+    status = celix_eventRemoteReader_readEvents(&reader, nrOfEvents, NULL, NULL);
+    if (status == CELIX_SUCCESS) {
+        reader.pos = (const uint8_t*)data + CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE;
+        status = celix_eventRemoteReader_readEvents(&reader, nrOfEvents, callback, handle);
+    }
+    for (int i = 0; i < CELIX_EVENT_REMOTE_SCRATCH_COUNT; ++i) {
+        free(reader.scratch[i]);
+    }
+    return status;
+}
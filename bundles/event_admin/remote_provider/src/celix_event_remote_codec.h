@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_EVENT_REMOTE_CODEC_H
+#define CELIX_EVENT_REMOTE_CODEC_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "celix_properties.h"
+#include "celix_errno.h"
+
+/*
+ * Binary encoding of a batch of remote events (a frame).
+ *
+ * Frame header (12 bytes, little endian): magic (4) | payload size (uint32) | number of events (uint32).
+ * Payload: the events, an event is encoded as: topic | number of properties (varint) | properties.
+ * A property is encoded as: key | value type (1 byte) | value, where the value is:
+ *  - string: string
+ *  - long: zigzag varint
+ *  - double: 8 bytes, little endian IEEE 754
+ *  - bool: 1 byte
+ *  - version: major (varint) | minor (varint) | micro (varint) | qualifier (string)
+ *  - array: element type (1 byte) | number of elements (varint) | elements, encoded as the values above
+ * A string (and a topic and key) is encoded as: length (varint) | bytes, without the terminating '\0'.
+ */
+
+#define CELIX_EVENT_REMOTE_FRAME_MAGIC 0x42564543u //"CEVB" in little endian
+#define CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE 12
+#define CELIX_EVENT_REMOTE_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+/**
+ * @brief A growable buffer in which a frame is encoded. The buffer is reused for the next frame.
+ */
+typedef struct celix_event_remote_frame {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint32_t nrOfEvents;
+} celix_event_remote_frame_t;
+
+/**
+ * @brief Initializes an empty frame, which does not allocate memory until the first event is encoded.
+ */
+void celix_eventRemoteFrame_init(celix_event_remote_frame_t* frame);
+
+/**
+ * @brief Frees the memory of the frame.
+ */
+void celix_eventRemoteFrame_deinit(celix_event_remote_frame_t* frame);
+
+/**
+ * @brief Starts a new frame, the previous content of the frame is discarded.
+ */
+celix_status_t celix_eventRemoteFrame_begin(celix_event_remote_frame_t* frame);
+
+/**
+ * @brief Appends an event to the frame.
+ * @return CELIX_SUCCESS if the event is encoded, CELIX_ENOMEM if out of memory or CELIX_ILLEGAL_ARGUMENT if the
+ * frame would exceed CELIX_EVENT_REMOTE_MAX_FRAME_SIZE. On error, the frame still contains the previous events.
+ */
+celix_status_t celix_eventRemoteFrame_addEvent(celix_event_remote_frame_t* frame, const char* topic, const celix_properties_t* properties);
+
+/**
+ * @brief Completes the frame header. Afterwards frame->data and frame->size contain the encoded frame.
+ */
+void celix_eventRemoteFrame_end(celix_event_remote_frame_t* frame);
+
+/**
+ * @brief Decodes a frame header.
+ * @param[in] data The data, which must contain at least CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE bytes.
+ * @param[out] payloadSize The size of the payload, which follows the header.
+ * @param[out] nrOfEvents The number of events in the payload.
+ * @return CELIX_SUCCESS or CELIX_ILLEGAL_ARGUMENT if the header is invalid.
+ */
+celix_status_t celix_eventRemoteFrame_decodeHeader(const void* data, size_t* payloadSize, uint32_t* nrOfEvents);
+
+/**
+ * @brief Called for every decoded event. The callee takes ownership of the properties.
+ */
+typedef void (*celix_event_remote_decoded_event_fp)(void* handle, const char* topic, celix_properties_t* properties);
+
+/**
+ * @brief Decodes all events of a frame.
+ * @param[in] data The frame, including the header.
+ * @param[in] size The size of the frame.
+ * @param[in] callback Called for every decoded event.
+ * @param[in] handle The handle for the callback.
+ * @return CELIX_SUCCESS, CELIX_ENOMEM or CELIX_ILLEGAL_ARGUMENT if the frame is malformed. The frame is validated
+ * before the first event is passed to the callback, so no events of a malformed frame are passed to the callback.
+ * Only on CELIX_ENOMEM, the events decoded before the error have already been passed to the callback.
+ */
+celix_status_t celix_eventRemoteFrame_decode(const void* data, size_t size, celix_event_remote_decoded_event_fp callback, void* handle);
+
+/**
+ * @brief Called by the receivers of the transports for every received frame. The frame is only valid during the call.
+ */
+typedef void (*celix_event_remote_frame_received_fp)(void* handle, const void* frame, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_EVENT_REMOTE_CODEC_H
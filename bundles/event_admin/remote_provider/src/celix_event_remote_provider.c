@@ -0,0 +1,372 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "celix_event_remote_provider.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_event_admin_service.h"
+#include "celix_event_constants.h"
+#include "celix_event_remote_codec.h"
+#include "celix_event_remote_shm.h"
+#include "celix_event_remote_tcp.h"
+#include "celix_array_list.h"
+#include "celix_log_helper.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
+#include "celix_utils.h"
+
+#define CELIX_EVENT_REMOTE_PROVIDER_MAX_BATCH_SIZE 64
+
+typedef struct celix_event_remote_peer {
+    char* url;
+    celix_event_remote_tcp_sender_t* tcpSender;
+    celix_event_remote_shm_sender_t* shmSender;
+    bool failing;//only logs the first failure of a sequence of failed sends
+} celix_event_remote_peer_t;
+
+struct celix_event_remote_provider {
+    celix_bundle_context_t* ctx;
+    celix_log_helper_t* logHelper;
+    const char* topics;
+    const char* filter;
+    long batchSize;
+    const char* tcpHost;
+    long tcpPort;
+    const char* shmName;
+    celix_array_list_t* peers;//element = celix_event_remote_peer_t*
+    celix_thread_mutex_t sendMutex;//protects frame and the failing flags of the peers
+    celix_event_remote_frame_t frame;
+    celix_thread_rwlock_t lock;//protects eventAdminService
+    celix_event_admin_service_t* eventAdminService;
+    celix_event_remote_tcp_receiver_t* tcpReceiver;
+    celix_event_remote_shm_receiver_t* shmReceiver;
+};
+
+static void celix_eventRemoteProvider_destroyPeer(celix_event_remote_peer_t* peer) {
+    if (peer != NULL) {
+        celix_eventRemoteTcpSender_destroy(peer->tcpSender);
+        celix_eventRemoteShmSender_destroy(peer->shmSender);
+        free(peer->url);
+        free(peer);
+    }
+}
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_remote_peer_t, celix_eventRemoteProvider_destroyPeer);
+
+static celix_event_remote_peer_t* celix_eventRemoteProvider_createPeer(celix_event_remote_provider_t* provider, const char* url) {
+    celix_autoptr(celix_event_remote_peer_t) peer = calloc(1, sizeof(*peer));
+    if (peer == NULL || (peer->url = celix_utils_strdup(url)) == NULL) {
+        celix_logHelper_error(provider->logHelper, "Failed to create peer %s.", url);
+        return NULL;
+    }
+    size_t tcpPrefixLen = strlen(CELIX_EVENT_REMOTE_PROVIDER_TCP_PEER_PREFIX);
+    size_t shmPrefixLen = strlen(CELIX_EVENT_REMOTE_PROVIDER_SHM_PEER_PREFIX);
+    if (strncmp(url, CELIX_EVENT_REMOTE_PROVIDER_TCP_PEER_PREFIX, tcpPrefixLen) == 0) {
+        celix_autofree char* host = celix_utils_strdup(url + tcpPrefixLen);
+        if (host == NULL) {
+            celix_logHelper_error(provider->logHelper, "Failed to create peer %s.", url);
+            return NULL;
+        }
+        char* portStr = strrchr(host, ':');
+        char* end = NULL;
+        long port = portStr == NULL ? -1 : strtol(portStr + 1, &end, 10);
+        if (portStr == NULL || end == portStr + 1 || *end != '\0' || port <= 0 || port > 65535) {
+            celix_logHelper_error(provider->logHelper, "Invalid tcp peer %s, expected tcp://<host>:<port>.", url);
+            return NULL;
+        }
+        *portStr = '\0';
+        char* hostStart = host;
+        size_t hostLen = strlen(host);
+        if (hostLen > 2 && host[0] == '[' && host[hostLen - 1] == ']') {//IPv6 address
+            host[hostLen - 1] = '\0';
+            hostStart = host + 1;
+        }
+        peer->tcpSender = celix_eventRemoteTcpSender_create(provider->logHelper, hostStart, (int)port);
+        if (peer->tcpSender == NULL) {
+            return NULL;
+        }
+    } else if (strncmp(url, CELIX_EVENT_REMOTE_PROVIDER_SHM_PEER_PREFIX, shmPrefixLen) == 0 && url[shmPrefixLen] != '\0') {
+        long poolSize = celix_bundleContext_getPropertyAsLong(provider->ctx, CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE,
+                                                              CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE_DEFAULT);
+        if (poolSize <= 0) {
+            celix_logHelper_error(provider->logHelper, "Invalid %s %ld.", CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE, poolSize);
+            return NULL;
+        }
+        double consumeTimeout = celix_bundleContext_getPropertyAsDouble(provider->ctx, CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT,
+                                                                        CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT_DEFAULT);
+        if (consumeTimeout <= 0) {
+            celix_logHelper_error(provider->logHelper, "Invalid %s %f.", CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT, consumeTimeout);
+            return NULL;
+        }
+        peer->shmSender = celix_eventRemoteShmSender_create(provider->logHelper, url + shmPrefixLen, (size_t)poolSize, consumeTimeout);
+        if (peer->shmSender == NULL) {
+            return NULL;
+        }
+    } else {
+        celix_logHelper_error(provider->logHelper, "Invalid peer %s, expected tcp://<host>:<port> or shm://<name>.", url);
+        return NULL;
+    }
+    return celix_steal_ptr(peer);
+}
+
+static celix_status_t celix_eventRemoteProvider_createPeers(celix_event_remote_provider_t* provider, const char* peers) {
+    if (peers == NULL) {
+        return CELIX_SUCCESS;
+    }
+    celix_autofree char* peersCopy = celix_utils_strdup(peers);
+    if (peersCopy == NULL) {
+        celix_logHelper_error(provider->logHelper, "Failed to copy peers.");
+        return CELIX_ENOMEM;
+    }
+    char* savePtr = NULL;
+    for (char* url = strtok_r(peersCopy, ",", &savePtr); url != NULL; url = strtok_r(NULL, ",", &savePtr)) {
+        url = celix_utils_trimInPlace(url);
+        if (url[0] == '\0') {
+            continue;
+        }
+        celix_autoptr(celix_event_remote_peer_t) peer = celix_eventRemoteProvider_createPeer(provider, url);
+        if (peer == NULL) {
+            return CELIX_ILLEGAL_ARGUMENT;
+        }
+        celix_status_t status = celix_arrayList_add(provider->peers, peer);
+        if (status != CELIX_SUCCESS) {
+            celix_logHelper_error(provider->logHelper, "Failed to add peer %s.", url);
+            return status;
+        }
+        celix_steal_ptr(peer);
+    }
+    return CELIX_SUCCESS;
+}
+
+celix_event_remote_provider_t* celix_eventRemoteProvider_create(celix_bundle_context_t* ctx) {
+    assert(ctx != NULL);
+    celix_autofree celix_event_remote_provider_t* provider = calloc(1, sizeof(*provider));
+    if (provider == NULL) {
+        return NULL;
+    }
+    provider->ctx = ctx;
+    celix_autoptr(celix_log_helper_t) logHelper = provider->logHelper = celix_logHelper_create(ctx, "CelixEventRemoteProvider");
+    if (logHelper == NULL) {
+        return NULL;
+    }
+    provider->topics = celix_bundleContext_getProperty(ctx, CELIX_EVENT_REMOTE_PROVIDER_TOPICS, NULL);
+    provider->filter = celix_bundleContext_getProperty(ctx, CELIX_EVENT_REMOTE_PROVIDER_FILTER, NULL);
+    provider->batchSize = celix_bundleContext_getPropertyAsLong(ctx, CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE,
+                                                                CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE_DEFAULT);
+    if (provider->batchSize <= 0 || provider->batchSize > CELIX_EVENT_REMOTE_PROVIDER_MAX_BATCH_SIZE) {
+        celix_logHelper_error(logHelper, "Invalid %s %ld, it must be between 1 and %d.", CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE,
+                              provider->batchSize, CELIX_EVENT_REMOTE_PROVIDER_MAX_BATCH_SIZE);
+        return NULL;
+    }
+    provider->tcpHost = celix_bundleContext_getProperty(ctx, CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST,
+                                                       CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST_DEFAULT);
+    provider->tcpPort = celix_bundleContext_getPropertyAsLong(ctx, CELIX_EVENT_REMOTE_PROVIDER_TCP_PORT, -1);
+    if (provider->tcpPort > 65535) {
+        celix_logHelper_error(logHelper, "Invalid %s %ld.", CELIX_EVENT_REMOTE_PROVIDER_TCP_PORT, provider->tcpPort);
+        return NULL;
+    }
+    provider->shmName = celix_bundleContext_getProperty(ctx, CELIX_EVENT_REMOTE_PROVIDER_SHM_NAME, NULL);
+
+    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = (void*)celix_eventRemoteProvider_destroyPeer;
+    celix_autoptr(celix_array_list_t) peers = provider->peers = celix_arrayList_createWithOptions(&opts);
+    if (peers == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create peer list.");
+        return NULL;
+    }
+    celix_status_t status = celix_eventRemoteProvider_createPeers(provider, celix_bundleContext_getProperty(ctx, CELIX_EVENT_REMOTE_PROVIDER_PEERS, NULL));
+    if (status != CELIX_SUCCESS) {
+        return NULL;
+    }
+    status = celixThreadMutex_create(&provider->sendMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create send mutex.");
+        return NULL;
+    }
+    celix_autoptr(celix_thread_mutex_t) sendMutex = &provider->sendMutex;
+    status = celixThreadRwlock_create(&provider->lock, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create lock.");
+        return NULL;
+    }
+    celix_eventRemoteFrame_init(&provider->frame);
+
+    celix_steal_ptr(sendMutex);
+    celix_steal_ptr(peers);
+    celix_steal_ptr(logHelper);
+    return celix_steal_ptr(provider);
+}
+
+void celix_eventRemoteProvider_destroy(celix_event_remote_provider_t* provider) {
+    if (provider != NULL) {
+        assert(provider->tcpReceiver == NULL && provider->shmReceiver == NULL);
+        celix_eventRemoteFrame_deinit(&provider->frame);
+        celixThreadRwlock_destroy(&provider->lock);
+        celixThreadMutex_destroy(&provider->sendMutex);
+        celix_arrayList_destroy(provider->peers);
+        celix_logHelper_destroy(provider->logHelper);
+        free(provider);
+    }
+}
+
+int celix_eventRemoteProvider_start(celix_event_remote_provider_t* provider) {
+    assert(provider != NULL);
+    celix_autoptr(celix_event_remote_tcp_receiver_t) tcpReceiver = NULL;
+    if (provider->tcpPort >= 0) {
+        tcpReceiver = celix_eventRemoteTcpReceiver_create(provider->logHelper, provider->tcpHost, (int)provider->tcpPort,
+                                                          celix_eventRemoteProvider_frameReceived, provider);
+        if (tcpReceiver == NULL) {
+            return CELIX_BUNDLE_EXCEPTION;
+        }
+    }
+    celix_autoptr(celix_event_remote_shm_receiver_t) shmReceiver = NULL;
+    if (provider->shmName != NULL) {
+        shmReceiver = celix_eventRemoteShmReceiver_create(provider->logHelper, provider->shmName,
+                                                          celix_eventRemoteProvider_frameReceived, provider);
+        if (shmReceiver == NULL) {
+            return CELIX_BUNDLE_EXCEPTION;
+        }
+    }
+    provider->tcpReceiver = celix_steal_ptr(tcpReceiver);
+    provider->shmReceiver = celix_steal_ptr(shmReceiver);
+    return CELIX_SUCCESS;
+}
+
+int celix_eventRemoteProvider_stop(celix_event_remote_provider_t* provider) {
+    assert(provider != NULL);
+    celix_eventRemoteShmReceiver_destroy(provider->shmReceiver);
+    provider->shmReceiver = NULL;
+    celix_eventRemoteTcpReceiver_destroy(provider->tcpReceiver);
+    provider->tcpReceiver = NULL;
+    return CELIX_SUCCESS;
+}
+
+celix_properties_t* celix_eventRemoteProvider_createEventHandlerProperties(celix_event_remote_provider_t* provider) {
+    assert(provider != NULL);
+    if (provider->topics == NULL) {
+        celix_logHelper_info(provider->logHelper, "%s is not configured, no events are forwarded.", CELIX_EVENT_REMOTE_PROVIDER_TOPICS);
+        return NULL;
+    }
+    celix_autoptr(celix_properties_t) props = celix_properties_create();
+    if (props == NULL) {
+        celix_logHelper_error(provider->logHelper, "Failed to create event handler properties.");
+        return NULL;
+    }
+    //Events which are received from a peer are not forwarded
+    celix_autofree char* filter = NULL;
+    if (provider->filter != NULL) {
+        if (asprintf(&filter, "(&(!(%s=*))%s)", CELIX_EVENT_REMOTE_PROVIDER_REMOTE_EVENT, provider->filter) < 0) {
+            filter = NULL;
+        }
+    } else if (asprintf(&filter, "(!(%s=*))", CELIX_EVENT_REMOTE_PROVIDER_REMOTE_EVENT) < 0) {
+        filter = NULL;
+    }
+    celix_status_t status = filter == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+    status = status != CELIX_SUCCESS ? status : celix_properties_set(props, CELIX_EVENT_TOPIC, provider->topics);
+    status = status != CELIX_SUCCESS ? status : celix_properties_set(props, CELIX_EVENT_FILTER, filter);
+    status = status != CELIX_SUCCESS ? status : celix_properties_set(props, CELIX_EVENT_DELIVERY, CELIX_EVENT_DELIVERY_ASYNC_ORDERED);
+    status = status != CELIX_SUCCESS ? status : celix_properties_setLong(props, CELIX_EVENT_BATCH_SIZE, provider->batchSize);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(provider->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(provider->logHelper, "Failed to create event handler properties.");
+        return NULL;
+    }
+    return celix_steal_ptr(props);
+}
+
+int celix_eventRemoteProvider_setEventAdminService(void* handle, void* svc) {
+    celix_event_remote_provider_t* provider = handle;
+    assert(provider != NULL);
+    celix_auto(celix_rwlock_wlock_guard_t) wLockGuard = celixRwlockWlockGuard_init(&provider->lock);
+    provider->eventAdminService = svc;
+    return CELIX_SUCCESS;
+}
+
+celix_status_t celix_eventRemoteProvider_handleEvent(void* handle, const char* topic, const celix_properties_t* properties) {
+    celix_event_entry_t event = {.topic = topic, .properties = properties};
+    return celix_eventRemoteProvider_handleEvents(handle, &event, 1);
+}
+
+celix_status_t celix_eventRemoteProvider_handleEvents(void* handle, const celix_event_entry_t* events, size_t size) {
+    celix_event_remote_provider_t* provider = handle;
+    assert(provider != NULL);
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&provider->sendMutex);
+    if (celix_arrayList_size(provider->peers) == 0) {
+        return CELIX_SUCCESS;
+    }
+    celix_status_t status = celix_eventRemoteFrame_begin(&provider->frame);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(provider->logHelper, "Failed to create frame. %d.", status);
+        return status;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        status = celix_eventRemoteFrame_addEvent(&provider->frame, events[i].topic, events[i].properties);
+        if (status != CELIX_SUCCESS) {
+            celix_logHelper_warning(provider->logHelper, "Failed to encode event %s, it is not forwarded. %d.", events[i].topic, status);
+        }
+    }
+    if (provider->frame.nrOfEvents == 0) {
+        return CELIX_SUCCESS;
+    }
+    celix_eventRemoteFrame_end(&provider->frame);
+
+    for (int i = 0; i < celix_arrayList_size(provider->peers); ++i) {
+        celix_event_remote_peer_t* peer = celix_arrayList_get(provider->peers, i);
+        status = peer->tcpSender != NULL ? celix_eventRemoteTcpSender_send(peer->tcpSender, provider->frame.data, provider->frame.size)
+                                         : celix_eventRemoteShmSender_send(peer->shmSender, provider->frame.data, provider->frame.size);
+        if (status != CELIX_SUCCESS && !peer->failing) {
+            celix_logHelper_warning(provider->logHelper, "Failed to forward events to %s, events are dropped until it is reachable. %d.",
+                                    peer->url, status);
+        } else if (status == CELIX_SUCCESS && peer->failing) {
+            celix_logHelper_info(provider->logHelper, "Forwarding events to %s.", peer->url);
+        }
+        peer->failing = status != CELIX_SUCCESS;
+    }
+    return CELIX_SUCCESS;
+}
+
+static void celix_eventRemoteProvider_postReceivedEvent(void* handle, const char* topic, celix_properties_t* properties) {
+    celix_event_remote_provider_t* provider = handle;
+    celix_autoptr(celix_properties_t) props = properties != NULL ? properties : celix_properties_create();
+    if (props == NULL || celix_properties_setBool(props, CELIX_EVENT_REMOTE_PROVIDER_REMOTE_EVENT, true) != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(provider->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(provider->logHelper, "Failed to create properties for remote event %s.", topic);
+        return;
+    }
+    celix_status_t status = provider->eventAdminService->postEventWithoutCopy(provider->eventAdminService->handle, topic, celix_steal_ptr(props));
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_warning(provider->logHelper, "Failed to post remote event %s. %d.", topic, status);
+    }
+}
+
+void celix_eventRemoteProvider_frameReceived(void* handle, const void* frame, size_t size) {
+    celix_event_remote_provider_t* provider = handle;
+    assert(provider != NULL);
+    celix_auto(celix_rwlock_rlock_guard_t) rLockGuard = celixRwlockRlockGuard_init(&provider->lock);
+    if (provider->eventAdminService == NULL) {
+        celix_logHelper_debug(provider->logHelper, "No event admin, dropping remote events.");
+        return;
+    }
+    celix_status_t status = celix_eventRemoteFrame_decode(frame, size, celix_eventRemoteProvider_postReceivedEvent, provider);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(provider->logHelper, "Failed to decode remote events. %d.", status);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_EVENT_REMOTE_PROVIDER_H
+#define CELIX_EVENT_REMOTE_PROVIDER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "celix_bundle_context.h"
+#include "celix_event_handler_service.h"
+#include "celix_properties.h"
+#include "celix_errno.h"
+
+//The configuration properties of the remote provider, see README.md
+#define CELIX_EVENT_REMOTE_PROVIDER_TOPICS "CELIX_EVENT_REMOTE_PROVIDER_TOPICS"
+#define CELIX_EVENT_REMOTE_PROVIDER_FILTER "CELIX_EVENT_REMOTE_PROVIDER_FILTER"
+#define CELIX_EVENT_REMOTE_PROVIDER_PEERS "CELIX_EVENT_REMOTE_PROVIDER_PEERS"
+#define CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST "CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST"
+#define CELIX_EVENT_REMOTE_PROVIDER_TCP_PORT "CELIX_EVENT_REMOTE_PROVIDER_TCP_PORT"
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_NAME "CELIX_EVENT_REMOTE_PROVIDER_SHM_NAME"
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE "CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE"
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT "CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT"
+#define CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE "CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE"
+
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_POOL_SIZE_DEFAULT (1024 * 1024)
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_CONSUME_TIMEOUT_DEFAULT 10.0
+#define CELIX_EVENT_REMOTE_PROVIDER_BATCH_SIZE_DEFAULT 64
+#define CELIX_EVENT_REMOTE_PROVIDER_TCP_HOST_DEFAULT "127.0.0.1"
+
+#define CELIX_EVENT_REMOTE_PROVIDER_TCP_PEER_PREFIX "tcp://"
+#define CELIX_EVENT_REMOTE_PROVIDER_SHM_PEER_PREFIX "shm://"
+
+/**
+ * @brief The event property which is set to true on the events received from a peer. Such events are not forwarded
+ * again, so that peers which forward the same topics to each other do not loop events.
+ */
+#define CELIX_EVENT_REMOTE_PROVIDER_REMOTE_EVENT "celix.event.remote"
+
+typedef struct celix_event_remote_provider celix_event_remote_provider_t;
+
+celix_event_remote_provider_t* celix_eventRemoteProvider_create(celix_bundle_context_t* ctx);
+
+void celix_eventRemoteProvider_destroy(celix_event_remote_provider_t* provider);
+
+/**
+ * @brief Starts receiving events from the peers.
+ */
+int celix_eventRemoteProvider_start(celix_event_remote_provider_t* provider);
+
+/**
+ * @brief Stops receiving events from the peers.
+ */
+int celix_eventRemoteProvider_stop(celix_event_remote_provider_t* provider);
+
+/**
+ * @brief Creates the service properties of the event handler service of the provider, which selects the events
+ * to forward.
+ * @return The service properties, or NULL if no topics are configured to forward or on error.
+ */
+celix_properties_t* celix_eventRemoteProvider_createEventHandlerProperties(celix_event_remote_provider_t* provider);
+
+int celix_eventRemoteProvider_setEventAdminService(void* handle, void* svc);
+
+celix_status_t celix_eventRemoteProvider_handleEvent(void* handle, const char* topic, const celix_properties_t* properties);
+
+celix_status_t celix_eventRemoteProvider_handleEvents(void* handle, const celix_event_entry_t* events, size_t size);
+
+/**
+ * @brief Decodes a frame, which is received from a peer, and posts its events to the event admin.
+ */
+void celix_eventRemoteProvider_frameReceived(void* handle, const void* frame, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_EVENT_REMOTE_PROVIDER_H
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <assert.h>
+
+#include "celix_errno.h"
+#include "celix_bundle_activator.h"
+#include "celix_event_remote_provider.h"
+#include "celix_event_admin_service.h"
+#include "celix_event_handler_service.h"
+
+//postEventWithoutCopy is required to post the received events
+#define CELIX_EVENT_REMOTE_PROVIDER_EVENT_ADMIN_SERVICE_USE_RANGE "[1.1.0,2)"
+
+typedef struct celix_event_remote_provider_activator {
+    celix_event_remote_provider_t* provider;
+    celix_event_handler_service_t eventHandlerService;
+} celix_event_remote_provider_activator_t;
+
+celix_status_t celix_eventRemoteProviderActivator_start(celix_event_remote_provider_activator_t* act, celix_bundle_context_t* ctx) {
+    assert(act != NULL);
+    assert(ctx != NULL);
+    celix_autoptr(celix_dm_component_t) cmp = celix_dmComponent_create(ctx, "EVENT_REMOTE_PROVIDER_CMP");
+    if (cmp == NULL) {
+        return CELIX_ENOMEM;
+    }
+    act->provider = celix_eventRemoteProvider_create(ctx);
+    if (act->provider == NULL) {
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+    celix_dmComponent_setImplementation(cmp, act->provider);
+    CELIX_DM_COMPONENT_SET_CALLBACKS(cmp, celix_event_remote_provider_t, NULL, celix_eventRemoteProvider_start,
+                                     celix_eventRemoteProvider_stop, NULL);
+    CELIX_DM_COMPONENT_SET_IMPLEMENTATION_DESTROY_FUNCTION(cmp, celix_event_remote_provider_t, celix_eventRemoteProvider_destroy);
+
+    {
+        celix_autoptr(celix_dm_service_dependency_t) eventAdminDep = celix_dmServiceDependency_create();
+        if (eventAdminDep == NULL) {
+            return CELIX_ENOMEM;
+        }
+        celix_status_t status = celix_dmServiceDependency_setService(eventAdminDep, CELIX_EVENT_ADMIN_SERVICE_NAME,
+                                                                     CELIX_EVENT_REMOTE_PROVIDER_EVENT_ADMIN_SERVICE_USE_RANGE, NULL);
+        if (status != CELIX_SUCCESS) {
+            return status;
+        }
+        celix_dmServiceDependency_setRequired(eventAdminDep, true);
+        celix_dmServiceDependency_setStrategy(eventAdminDep, DM_SERVICE_DEPENDENCY_STRATEGY_LOCKING);
+        celix_dm_service_dependency_callback_options_t opts = CELIX_EMPTY_DM_SERVICE_DEPENDENCY_CALLBACK_OPTIONS;
+        opts.set = celix_eventRemoteProvider_setEventAdminService;
+        celix_dmServiceDependency_setCallbacksWithOptions(eventAdminDep, &opts);
+        status = celix_dmComponent_addServiceDependency(cmp, eventAdminDep);
+        if (status != CELIX_SUCCESS) {
+            return status;
+        }
+        celix_steal_ptr(eventAdminDep);
+    }
+
+    celix_properties_t* handlerProps = celix_eventRemoteProvider_createEventHandlerProperties(act->provider);
+    if (handlerProps != NULL) {
+        act->eventHandlerService.handle = act->provider;
+        act->eventHandlerService.handleEvent = celix_eventRemoteProvider_handleEvent;
+        act->eventHandlerService.handleEvents = celix_eventRemoteProvider_handleEvents;
+        celix_status_t status = celix_dmComponent_addInterface(cmp, CELIX_EVENT_HANDLER_SERVICE_NAME, CELIX_EVENT_HANDLER_SERVICE_VERSION,
+                                                               &act->eventHandlerService, handlerProps);
+        if (status != CELIX_SUCCESS) {
+            return status;
+        }
+    }
+
+    celix_dependency_manager_t* mng = celix_bundleContext_getDependencyManager(ctx);
+    if (mng == NULL) {
+        return CELIX_ENOMEM;
+    }
+    celix_status_t status = celix_dependencyManager_addAsync(mng, cmp);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    celix_steal_ptr(cmp);
+    return CELIX_SUCCESS;
+}
+
+CELIX_GEN_BUNDLE_ACTIVATOR(celix_event_remote_provider_activator_t, celix_eventRemoteProviderActivator_start, NULL)
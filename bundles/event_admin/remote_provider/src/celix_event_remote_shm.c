@@ -0,0 +1,339 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "celix_event_remote_shm.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "shm_pool.h"
+#include "shm_cache.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
+#include "celix_unistd_cleanup.h"
+#include "celix_utils.h"
+
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_MAGIC 0x4d485345u
+#define CELIX_EVENT_REMOTE_SHM_SEND_TIMEOUT_S 5
+#define CELIX_EVENT_REMOTE_SHM_RECV_RETRY_INTERVAL_US 100000
+
+/**
+ * @brief The states of a block. The state is combined with the sequence number of the frame in the block, so that
+ * a stale message of a reclaimed block does not match the frame of a block which reuses the memory.
+ */
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_PENDING 0u//sent, but not yet read by the receiver
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_READING 1u//the receiver is handling the frame
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_CONSUMED 2u//the receiver handled the frame
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_RECLAIMED 3u//the sender reclaimed the block before the receiver read it
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_BITS 2u
+#define CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_MASK 3u
+
+/**
+ * @brief A frame in the shared memory pool, the frame data follows the block header.
+ */
+typedef struct celix_event_remote_shm_block {
+    uint32_t magic;
+    _Atomic uint64_t state;//sequence number << CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_BITS | block state
+    size_t frameSize;
+    struct timespec sendTime;//only used by the sender
+    struct celix_event_remote_shm_block* next;//only used by the sender, the list of not yet consumed blocks
+} celix_event_remote_shm_block_t;
+
+/**
+ * @brief The datagram which is sent to the receiver for every frame.
+ */
+typedef struct celix_event_remote_shm_msg {
+    int shmId;
+    ssize_t blockOffset;
+    size_t frameSize;
+    uint64_t seq;
+} celix_event_remote_shm_msg_t;
+
+struct celix_event_remote_shm_sender {
+    celix_log_helper_t* logHelper;
+    shm_pool_t* pool;
+    int fd;
+    struct sockaddr_un peerAddr;
+    double consumeTimeout;
+    celix_thread_mutex_t mutex;//protects pendingBlocks and nextSeq
+    celix_event_remote_shm_block_t* pendingBlocks;
+    uint64_t nextSeq;
+};
+
+struct celix_event_remote_shm_receiver {
+    celix_log_helper_t* logHelper;
+    celix_event_remote_frame_received_fp callback;
+    void* handle;
+    int fd;
+    shm_cache_t* cache;
+    atomic_bool active;
+    celix_thread_t thread;
+};
+
+static bool celix_eventRemoteShm_initAddress(struct sockaddr_un* addr, const char* name) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(name) >= sizeof(addr->sun_path) - 1) {
+        return false;
+    }
+    //An abstract socket, addr->sun_path[0] is 0
+    strncpy(&addr->sun_path[1], name, sizeof(addr->sun_path) - 2);
+    return true;
+}
+
+static inline uint64_t celix_eventRemoteShm_blockState(uint64_t seq, uint64_t state) {
+    return (seq << CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_BITS) | state;
+}
+
+celix_event_remote_shm_sender_t* celix_eventRemoteShmSender_create(celix_log_helper_t* logHelper, const char* peerName, size_t poolSize,
+                                                                   double consumeTimeout) {
+    assert(logHelper != NULL);
+    assert(peerName != NULL);
+    celix_autofree celix_event_remote_shm_sender_t* sender = calloc(1, sizeof(*sender));
+    if (sender == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create shm sender for %s.", peerName);
+        return NULL;
+    }
+    sender->logHelper = logHelper;
+    sender->consumeTimeout = consumeTimeout;
+    if (!celix_eventRemoteShm_initAddress(&sender->peerAddr, peerName)) {
+        celix_logHelper_error(logHelper, "Shm peer name %s is too long.", peerName);
+        return NULL;
+    }
+    celix_auto(celix_fd_t) fd = sender->fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        celix_logHelper_error(logHelper, "Failed to create socket for shm peer %s. %d.", peerName, errno);
+        return NULL;
+    }
+    struct timeval timeout = {.tv_sec = CELIX_EVENT_REMOTE_SHM_SEND_TIMEOUT_S, .tv_usec = 0};
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0) {
+        celix_logHelper_error(logHelper, "Failed to set send timeout for shm peer %s. %d.", peerName, errno);
+        return NULL;
+    }
+    celix_autoptr(shm_pool_t) pool = NULL;
+    celix_status_t status = shmPool_create(poolSize, &pool);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(logHelper, "Failed to create shm pool for shm peer %s. %d.", peerName, status);
+        return NULL;
+    }
+    status = celixThreadMutex_create(&sender->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create shm sender mutex. %d.", status);
+        return NULL;
+    }
+    sender->pool = celix_steal_ptr(pool);
+    celix_steal_fd(&fd);
+    return celix_steal_ptr(sender);
+}
+
+void celix_eventRemoteShmSender_destroy(celix_event_remote_shm_sender_t* sender) {
+    if (sender != NULL) {
+        close(sender->fd);
+        //The pending blocks are released with the pool.
+        shmPool_destroy(sender->pool);
+        celixThreadMutex_destroy(&sender->mutex);
+        free(sender);
+    }
+}
+
+/**
+ * @brief Frees the consumed blocks. If reclaimAll is true or if a block is not read by the receiver within the consume
+ * timeout, the message of the block is considered lost (e.g. the receiver is restarted) and the block is reclaimed.
+ */
+static void celix_eventRemoteShmSender_freeConsumedBlocks(celix_event_remote_shm_sender_t* sender, bool reclaimAll) {
+    size_t reclaimedCnt = 0;
+    celix_event_remote_shm_block_t** link = &sender->pendingBlocks;
+    while (*link != NULL) {
+        celix_event_remote_shm_block_t* block = *link;
+        uint64_t state = atomic_load_explicit(&block->state, memory_order_acquire);
+        bool release = (state & CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_MASK) == CELIX_EVENT_REMOTE_SHM_BLOCK_CONSUMED;
+        if (!release && (state & CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_MASK) == CELIX_EVENT_REMOTE_SHM_BLOCK_PENDING &&
+            (reclaimAll || celix_elapsedtime(CLOCK_MONOTONIC, block->sendTime) > sender->consumeTimeout)) {
+            uint64_t reclaimed = (state & ~(uint64_t)CELIX_EVENT_REMOTE_SHM_BLOCK_STATE_MASK) | CELIX_EVENT_REMOTE_SHM_BLOCK_RECLAIMED;
+            release = atomic_compare_exchange_strong_explicit(&block->state, &state, reclaimed, memory_order_acq_rel,
+                                                              memory_order_acquire);
+            reclaimedCnt += release ? 1 : 0;
+        }
+        if (release) {
+            *link = block->next;
+            shmPool_free(sender->pool, block);
+        } else {
+            link = &block->next;
+        }
+    }
+    if (reclaimedCnt > 0) {
+        celix_logHelper_warning(sender->logHelper, "Reclaimed %zu shm frame(s) which are not read by the peer.", reclaimedCnt);
+    }
+}
+
+celix_status_t celix_eventRemoteShmSender_send(celix_event_remote_shm_sender_t* sender, const void* frame, size_t size) {
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&sender->mutex);
+    celix_eventRemoteShmSender_freeConsumedBlocks(sender, false);
+    celix_event_remote_shm_block_t* block = shmPool_malloc(sender->pool, sizeof(*block) + size);
+    if (block == NULL) {
+        return CELIX_ENOMEM;
+    }
+    uint64_t seq = sender->nextSeq++;
+    block->magic = CELIX_EVENT_REMOTE_SHM_BLOCK_MAGIC;
+    atomic_store_explicit(&block->state, celix_eventRemoteShm_blockState(seq, CELIX_EVENT_REMOTE_SHM_BLOCK_PENDING), memory_order_relaxed);
+    block->frameSize = size;
+    block->sendTime = celix_gettime(CLOCK_MONOTONIC);
+    memcpy(block + 1, frame, size);
+
+    celix_event_remote_shm_msg_t msg = {
+        .shmId = shmPool_getShmId(sender->pool),
+        .blockOffset = shmPool_getMemoryOffset(sender->pool, block),
+        .frameSize = size,
+        .seq = seq,
+    };
+    if (sendto(sender->fd, &msg, sizeof(msg), 0, (const struct sockaddr*)&sender->peerAddr, sizeof(sender->peerAddr)) != sizeof(msg)) {
+        int err = errno;
+        shmPool_free(sender->pool, block);
+        if (err == ECONNREFUSED || err == ENOENT) {
+            //The peer is gone, the messages of the pending blocks are lost with its socket.
+            celix_eventRemoteShmSender_freeConsumedBlocks(sender, true);
+        }
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, err);
+    }
+    block->next = sender->pendingBlocks;
+    sender->pendingBlocks = block;
+    return CELIX_SUCCESS;
+}
+
+static void* celix_eventRemoteShmReceiver_thread(void* data);
+
+celix_event_remote_shm_receiver_t* celix_eventRemoteShmReceiver_create(celix_log_helper_t* logHelper, const char* name,
+                                                                       celix_event_remote_frame_received_fp callback, void* handle) {
+    assert(logHelper != NULL);
+    assert(name != NULL);
+    assert(callback != NULL);
+    celix_autofree celix_event_remote_shm_receiver_t* receiver = calloc(1, sizeof(*receiver));
+    if (receiver == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create shm receiver %s.", name);
+        return NULL;
+    }
+    receiver->logHelper = logHelper;
+    receiver->callback = callback;
+    receiver->handle = handle;
+    struct sockaddr_un addr;
+    if (!celix_eventRemoteShm_initAddress(&addr, name)) {
+        celix_logHelper_error(logHelper, "Shm receiver name %s is too long.", name);
+        return NULL;
+    }
+    celix_auto(celix_fd_t) fd = receiver->fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        celix_logHelper_error(logHelper, "Failed to create socket for shm receiver %s. %d.", name, errno);
+        return NULL;
+    }
+    if (bind(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        celix_logHelper_error(logHelper, "Failed to bind shm receiver %s. %d.", name, errno);
+        return NULL;
+    }
+    celix_autoptr(shm_cache_t) cache = NULL;
+    celix_status_t status = shmCache_create(false, &cache);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(logHelper, "Failed to create shm cache for shm receiver %s. %d.", name, status);
+        return NULL;
+    }
+    receiver->cache = cache;
+    atomic_init(&receiver->active, true);
+    status = celixThread_create(&receiver->thread, NULL, celix_eventRemoteShmReceiver_thread, receiver);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create shm receive thread. %d.", status);
+        return NULL;
+    }
+    celixThread_setName(&receiver->thread, "CelixEvtShmRcv");
+    celix_steal_ptr(cache);
+    celix_steal_fd(&fd);
+    return celix_steal_ptr(receiver);
+}
+
+void celix_eventRemoteShmReceiver_destroy(celix_event_remote_shm_receiver_t* receiver) {
+    if (receiver != NULL) {
+        atomic_store(&receiver->active, false);
+        shutdown(receiver->fd, SHUT_RD);
+        celixThread_join(receiver->thread, NULL);
+        shmCache_destroy(receiver->cache);
+        close(receiver->fd);
+        free(receiver);
+    }
+}
+
+static void celix_eventRemoteShmReceiver_handleMsg(celix_event_remote_shm_receiver_t* receiver, const celix_event_remote_shm_msg_t* msg) {
+    //The message is received from a peer, so the frame must be within the shared memory before it is dereferenced
+    if (msg->blockOffset <= 0 || msg->blockOffset % _Alignof(celix_event_remote_shm_block_t) != 0 ||
+        msg->frameSize > SIZE_MAX - sizeof(celix_event_remote_shm_block_t)) {
+        celix_logHelper_error(receiver->logHelper, "Received invalid shm message.");
+        return;
+    }
+    celix_event_remote_shm_block_t* block = shmCache_getMemoryPtrInRange(receiver->cache, msg->shmId, msg->blockOffset,
+                                                                         sizeof(*block) + msg->frameSize);
+    if (block == NULL) {
+        celix_logHelper_logTssErrors(receiver->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(receiver->logHelper, "Failed to map shm frame (shm id %d).", msg->shmId);
+        return;
+    }
+    uint64_t pending = celix_eventRemoteShm_blockState(msg->seq, CELIX_EVENT_REMOTE_SHM_BLOCK_PENDING);
+    if (block->magic != CELIX_EVENT_REMOTE_SHM_BLOCK_MAGIC) {
+        celix_logHelper_error(receiver->logHelper, "Received invalid shm frame.");
+    } else if (!atomic_compare_exchange_strong_explicit(&block->state, &pending,
+                                                        celix_eventRemoteShm_blockState(msg->seq, CELIX_EVENT_REMOTE_SHM_BLOCK_READING),
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+        celix_logHelper_warning(receiver->logHelper, "Shm frame %" PRIu64 " is reclaimed by the sender, dropping it.", msg->seq);
+    } else {
+        if (block->frameSize != msg->frameSize) {
+            celix_logHelper_error(receiver->logHelper, "Received invalid shm frame.");
+        } else {
+            receiver->callback(receiver->handle, block + 1, msg->frameSize);
+        }
+        atomic_store_explicit(&block->state, celix_eventRemoteShm_blockState(msg->seq, CELIX_EVENT_REMOTE_SHM_BLOCK_CONSUMED),
+                              memory_order_release);
+    }
+    shmCache_releaseMemoryPtr(receiver->cache, block);
+}
+
+static void* celix_eventRemoteShmReceiver_thread(void* data) {
+    celix_event_remote_shm_receiver_t* receiver = data;
+    celix_event_remote_shm_msg_t msg;
+    while (atomic_load(&receiver->active)) {
+        ssize_t n = recv(receiver->fd, &msg, sizeof(msg), 0);
+        if (n == sizeof(msg)) {
+            celix_eventRemoteShmReceiver_handleMsg(receiver, &msg);
+        } else if (n < 0 && (errno == EAGAIN || errno == ENOBUFS || errno == ENOMEM)) {
+            celix_logHelper_warning(receiver->logHelper, "Failed to receive shm frame, retrying. %d.", errno);
+            usleep(CELIX_EVENT_REMOTE_SHM_RECV_RETRY_INTERVAL_US);
+        } else if (n < 0 && errno != EINTR) {
+            celix_logHelper_error(receiver->logHelper, "Failed to receive shm frame, stopping the shm receiver. %d.", errno);
+            break;
+        } else if (n > 0) {
+            celix_logHelper_error(receiver->logHelper, "Received invalid shm message of %zd bytes.", n);
+        }
+    }
+    return NULL;
+}
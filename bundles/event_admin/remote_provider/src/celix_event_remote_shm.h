@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_EVENT_REMOTE_SHM_H
+#define CELIX_EVENT_REMOTE_SHM_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "celix_event_remote_codec.h"
+#include "celix_log_helper.h"
+#include "celix_cleanup.h"
+#include "celix_errno.h"
+
+/**
+ * @brief Sends frames to a peer on the same host. The frames are copied to a shared memory pool (shm_pool) and only
+ * the location of a frame is sent to the abstract unix domain socket of the peer. The memory of a frame is reused
+ * after the peer marked the frame as consumed. If the peer does not read a frame, because the peer is gone or restarted,
+ * the memory of the frame is reclaimed after a failed send to the peer or after the consume timeout.
+ */
+typedef struct celix_event_remote_shm_sender celix_event_remote_shm_sender_t;
+
+/**
+ * @brief Creates a sender for the peer which receives frames on the abstract unix domain socket peerName.
+ * @param[in] poolSize The size of the shared memory pool, which limits the size of the frames which are not yet
+ * consumed by the peer.
+ * @param[in] consumeTimeout The time in seconds after which a frame which is not yet read by the peer is considered
+ * lost and its memory is reclaimed. The peer drops a reclaimed frame.
+ */
+celix_event_remote_shm_sender_t* celix_eventRemoteShmSender_create(celix_log_helper_t* logHelper, const char* peerName, size_t poolSize,
+                                                                   double consumeTimeout);
+
+void celix_eventRemoteShmSender_destroy(celix_event_remote_shm_sender_t* sender);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_remote_shm_sender_t, celix_eventRemoteShmSender_destroy);
+
+/**
+ * @brief Sends a frame to the peer. Thread safe.
+ * @return CELIX_SUCCESS, CELIX_ENOMEM if the shared memory pool is exhausted by frames which are not yet consumed
+ * by the peer or an errno status if the peer is not reachable.
+ */
+celix_status_t celix_eventRemoteShmSender_send(celix_event_remote_shm_sender_t* sender, const void* frame, size_t size);
+
+/**
+ * @brief Receives the frames of celix_event_remote_shm_sender_t senders in a single thread, which calls the frame callback.
+ */
+typedef struct celix_event_remote_shm_receiver celix_event_remote_shm_receiver_t;
+
+/**
+ * @brief Creates a receiver which receives frames on the abstract unix domain socket name.
+ */
+celix_event_remote_shm_receiver_t* celix_eventRemoteShmReceiver_create(celix_log_helper_t* logHelper, const char* name,
+                                                                       celix_event_remote_frame_received_fp callback, void* handle);
+
+void celix_eventRemoteShmReceiver_destroy(celix_event_remote_shm_receiver_t* receiver);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_remote_shm_receiver_t, celix_eventRemoteShmReceiver_destroy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_EVENT_REMOTE_SHM_H
@@ -0,0 +1,400 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "celix_event_remote_tcp.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
+#include "celix_unistd_cleanup.h"
+#include "celix_utils.h"
+
+#define CELIX_EVENT_REMOTE_TCP_CONNECT_TIMEOUT_MS 1000
+#define CELIX_EVENT_REMOTE_TCP_RECONNECT_INTERVAL_S 1.0
+#define CELIX_EVENT_REMOTE_TCP_SEND_TIMEOUT_S 5
+#define CELIX_EVENT_REMOTE_TCP_LISTEN_BACKLOG 16
+#define CELIX_EVENT_REMOTE_TCP_MAX_CONNECTIONS 64
+#define CELIX_EVENT_REMOTE_TCP_READ_SIZE (64 * 1024)
+
+struct celix_event_remote_tcp_sender {
+    celix_log_helper_t* logHelper;
+    char* host;
+    char port[16];
+    celix_thread_mutex_t mutex;//protects below
+    int fd;
+    bool connectTried;
+    struct timespec lastConnectTime;
+};
+
+typedef struct celix_event_remote_tcp_connection {
+    int fd;
+    uint8_t* buffer;
+    size_t size;
+    size_t capacity;
+} celix_event_remote_tcp_connection_t;
+
+struct celix_event_remote_tcp_receiver {
+    celix_log_helper_t* logHelper;
+    celix_event_remote_frame_received_fp callback;
+    void* handle;
+    int listenFd;
+    int eventFd;
+    int port;
+    celix_thread_t thread;
+    //Only used by the receive thread
+    celix_event_remote_tcp_connection_t connections[CELIX_EVENT_REMOTE_TCP_MAX_CONNECTIONS];
+    size_t nrOfConnections;
+};
+
+celix_event_remote_tcp_sender_t* celix_eventRemoteTcpSender_create(celix_log_helper_t* logHelper, const char* host, int port) {
+    assert(logHelper != NULL);
+    assert(host != NULL);
+    celix_autofree celix_event_remote_tcp_sender_t* sender = calloc(1, sizeof(*sender));
+    if (sender == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create tcp sender for %s:%d.", host, port);
+        return NULL;
+    }
+    sender->logHelper = logHelper;
+    sender->fd = -1;
+    (void)snprintf(sender->port, sizeof(sender->port), "%d", port);
+    celix_autofree char* hostCopy = sender->host = celix_utils_strdup(host);
+    if (sender->host == NULL) {
+        celix_logHelper_error(logHelper, "Failed to copy host %s.", host);
+        return NULL;
+    }
+    celix_status_t status = celixThreadMutex_create(&sender->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create tcp sender mutex. %d.", status);
+        return NULL;
+    }
+    celix_steal_ptr(hostCopy);
+    return celix_steal_ptr(sender);
+}
+
+void celix_eventRemoteTcpSender_destroy(celix_event_remote_tcp_sender_t* sender) {
+    if (sender != NULL) {
+        if (sender->fd >= 0) {
+            close(sender->fd);
+        }
+        celixThreadMutex_destroy(&sender->mutex);
+        free(sender->host);
+        free(sender);
+    }
+}
+
+static int celix_eventRemoteTcpSender_connectAddress(const struct addrinfo* addr) {
+    celix_auto(celix_fd_t) fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, addr->ai_protocol);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, addr->ai_addr, addr->ai_addrlen) != 0) {
+        if (errno != EINPROGRESS) {
+            return -1;
+        }
+        struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+        if (poll(&pfd, 1, CELIX_EVENT_REMOTE_TCP_CONNECT_TIMEOUT_MS) != 1) {
+            return -1;
+        }
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) != 0 || err != 0) {
+            return -1;
+        }
+    }
+    //Send blocking with a timeout, the events are batched by the caller.
+    int flags = fcntl(fd, F_GETFL, 0);
+    int noDelay = 1;
+    struct timeval timeout = {.tv_sec = CELIX_EVENT_REMOTE_TCP_SEND_TIMEOUT_S, .tv_usec = 0};
+    if (flags < 0 || fcntl(fd, F_SETFL, flags & ~O_NONBLOCK) != 0 ||
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)) != 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0) {
+        return -1;
+    }
+    return celix_steal_fd(&fd);
+}
+
+static int celix_eventRemoteTcpSender_connect(celix_event_remote_tcp_sender_t* sender) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addrs = NULL;
+    int rc = getaddrinfo(sender->host, sender->port, &hints, &addrs);
+    if (rc != 0) {
+        celix_logHelper_warning(sender->logHelper, "Failed to resolve %s:%s. %s.", sender->host, sender->port, gai_strerror(rc));
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo* addr = addrs; addr != NULL && fd < 0; addr = addr->ai_next) {
+        fd = celix_eventRemoteTcpSender_connectAddress(addr);
+    }
+    freeaddrinfo(addrs);
+    if (fd < 0) {
+        celix_logHelper_debug(sender->logHelper, "Failed to connect to %s:%s.", sender->host, sender->port);
+    } else {
+        celix_logHelper_info(sender->logHelper, "Connected to %s:%s.", sender->host, sender->port);
+    }
+    return fd;
+}
+
+celix_status_t celix_eventRemoteTcpSender_send(celix_event_remote_tcp_sender_t* sender, const void* frame, size_t size) {
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&sender->mutex);
+    if (sender->fd < 0) {
+        if (sender->connectTried &&
+            celix_elapsedtime(CLOCK_MONOTONIC, sender->lastConnectTime) < CELIX_EVENT_REMOTE_TCP_RECONNECT_INTERVAL_S) {
+            return CELIX_ILLEGAL_STATE;
+        }
+        sender->connectTried = true;
+        sender->lastConnectTime = celix_gettime(CLOCK_MONOTONIC);
+        sender->fd = celix_eventRemoteTcpSender_connect(sender);
+        if (sender->fd < 0) {
+            return CELIX_ILLEGAL_STATE;
+        }
+    }
+    const uint8_t* data = frame;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(sender->fd, data + sent, size - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            celix_status_t status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, n < 0 ? errno : EPIPE);
+            celix_logHelper_warning(sender->logHelper, "Failed to send frame to %s:%s, closing connection. %d.",
+                                    sender->host, sender->port, n < 0 ? errno : EPIPE);
+            //A partially written frame can not be recovered, the peer drops it when the connection is closed.
+            close(sender->fd);
+            sender->fd = -1;
+            return status;
+        }
+        sent += (size_t)n;
+    }
+    return CELIX_SUCCESS;
+}
+
+static void* celix_eventRemoteTcpReceiver_thread(void* data);
+
+static int celix_eventRemoteTcpReceiver_listen(celix_event_remote_tcp_receiver_t* receiver, const char* host, int port) {
+    char portStr[16];
+    (void)snprintf(portStr, sizeof(portStr), "%d", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo* addrs = NULL;
+    int rc = getaddrinfo(host, portStr, &hints, &addrs);
+    if (rc != 0) {
+        celix_logHelper_error(receiver->logHelper, "Failed to resolve listen address %s:%d. %s.", host == NULL ? "*" : host, port, gai_strerror(rc));
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo* addr = addrs; addr != NULL && fd < 0; addr = addr->ai_next) {
+        celix_auto(celix_fd_t) candidate = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        int reuse = 1;
+        if (candidate >= 0 && setsockopt(candidate, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == 0 &&
+            bind(candidate, addr->ai_addr, addr->ai_addrlen) == 0 &&
+            listen(candidate, CELIX_EVENT_REMOTE_TCP_LISTEN_BACKLOG) == 0) {
+            fd = celix_steal_fd(&candidate);
+        }
+    }
+    freeaddrinfo(addrs);
+    if (fd < 0) {
+        celix_logHelper_error(receiver->logHelper, "Failed to listen on %s:%d. %d.", host == NULL ? "*" : host, port, errno);
+        return -1;
+    }
+    struct sockaddr_storage boundAddr;
+    socklen_t boundAddrLen = sizeof(boundAddr);
+    if (getsockname(fd, (struct sockaddr*)&boundAddr, &boundAddrLen) == 0) {
+        receiver->port = ntohs(boundAddr.ss_family == AF_INET6 ? ((struct sockaddr_in6*)&boundAddr)->sin6_port
+                                                                 : ((struct sockaddr_in*)&boundAddr)->sin_port);
+    } else {
+        receiver->port = port;
+    }
+    return fd;
+}
+
+celix_event_remote_tcp_receiver_t* celix_eventRemoteTcpReceiver_create(celix_log_helper_t* logHelper, const char* host, int port,
+                                                                       celix_event_remote_frame_received_fp callback, void* handle) {
+    assert(logHelper != NULL);
+    assert(callback != NULL);
+    celix_autofree celix_event_remote_tcp_receiver_t* receiver = calloc(1, sizeof(*receiver));
+    if (receiver == NULL) {
+        celix_logHelper_error(logHelper, "Failed to create tcp receiver.");
+        return NULL;
+    }
+    receiver->logHelper = logHelper;
+    receiver->callback = callback;
+    receiver->handle = handle;
+    celix_auto(celix_fd_t) listenFd = receiver->listenFd = celix_eventRemoteTcpReceiver_listen(receiver, host, port);
+    if (listenFd < 0) {
+        return NULL;
+    }
+    celix_auto(celix_fd_t) eventFd = receiver->eventFd = eventfd(0, EFD_CLOEXEC);
+    if (eventFd < 0) {
+        celix_logHelper_error(logHelper, "Failed to create eventfd for tcp receiver. %d.", errno);
+        return NULL;
+    }
+    celix_status_t status = celixThread_create(&receiver->thread, NULL, celix_eventRemoteTcpReceiver_thread, receiver);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Failed to create tcp receive thread. %d.", status);
+        return NULL;
+    }
+    celixThread_setName(&receiver->thread, "CelixEvtTcpRcv");
+    celix_steal_fd(&eventFd);
+    celix_steal_fd(&listenFd);
+    celix_logHelper_info(logHelper, "Listening for remote events on port %d.", receiver->port);
+    return celix_steal_ptr(receiver);
+}
+
+void celix_eventRemoteTcpReceiver_destroy(celix_event_remote_tcp_receiver_t* receiver) {
+    if (receiver != NULL) {
+        eventfd_write(receiver->eventFd, 1);
+        celixThread_join(receiver->thread, NULL);
+        for (size_t i = 0; i < receiver->nrOfConnections; ++i) {
+            close(receiver->connections[i].fd);
+            free(receiver->connections[i].buffer);
+        }
+        close(receiver->eventFd);
+        close(receiver->listenFd);
+        free(receiver);
+    }
+}
+
+int celix_eventRemoteTcpReceiver_getPort(const celix_event_remote_tcp_receiver_t* receiver) {
+    return receiver->port;
+}
+
+static void celix_eventRemoteTcpReceiver_accept(celix_event_remote_tcp_receiver_t* receiver) {
+    celix_auto(celix_fd_t) fd = accept4(receiver->listenFd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) {
+        celix_logHelper_warning(receiver->logHelper, "Failed to accept tcp connection. %d.", errno);
+        return;
+    }
+    if (receiver->nrOfConnections == CELIX_EVENT_REMOTE_TCP_MAX_CONNECTIONS) {
+        celix_logHelper_error(receiver->logHelper, "Too many tcp connections, max is %d.", CELIX_EVENT_REMOTE_TCP_MAX_CONNECTIONS);
+        return;
+    }
+    celix_event_remote_tcp_connection_t* conn = &receiver->connections[receiver->nrOfConnections++];
+    memset(conn, 0, sizeof(*conn));
+    conn->fd = celix_steal_fd(&fd);
+}
+
+static void celix_eventRemoteTcpReceiver_closeConnection(celix_event_remote_tcp_receiver_t* receiver, size_t idx) {
+    celix_event_remote_tcp_connection_t* conn = &receiver->connections[idx];
+    close(conn->fd);
+    free(conn->buffer);
+    receiver->connections[idx] = receiver->connections[--receiver->nrOfConnections];
+}
+
+/**
+ * @brief Reads the available data of a connection and passes the completely received frames to the callback.
+ * @return false if the connection must be closed.
+ */
+static bool celix_eventRemoteTcpReceiver_readConnection(celix_event_remote_tcp_receiver_t* receiver, celix_event_remote_tcp_connection_t* conn) {
+    if (conn->capacity - conn->size < CELIX_EVENT_REMOTE_TCP_READ_SIZE) {
+        size_t capacity = conn->capacity == 0 ? CELIX_EVENT_REMOTE_TCP_READ_SIZE : conn->capacity * 2;
+        uint8_t* buffer = realloc(conn->buffer, capacity);
+        if (buffer == NULL) {
+            celix_logHelper_error(receiver->logHelper, "Failed to allocate tcp receive buffer.");
+            return false;
+        }
+        conn->buffer = buffer;
+        conn->capacity = capacity;
+    }
+    ssize_t n = recv(conn->fd, conn->buffer + conn->size, conn->capacity - conn->size, 0);
+    if (n < 0) {
+        return errno == EINTR || errno == EAGAIN;
+    } else if (n == 0) {
+        return false;//closed by peer
+    }
+    conn->size += (size_t)n;
+
+    size_t offset = 0;
+    while (conn->size - offset >= CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE) {
+        size_t payloadSize;
+        uint32_t nrOfEvents;
+        if (celix_eventRemoteFrame_decodeHeader(conn->buffer + offset, &payloadSize, &nrOfEvents) != CELIX_SUCCESS) {
+            celix_logHelper_error(receiver->logHelper, "Received invalid frame header, closing connection.");
+            return false;
+        }
+        size_t frameSize = CELIX_EVENT_REMOTE_FRAME_HEADER_SIZE + payloadSize;
+        if (conn->size - offset < frameSize) {
+            break;
+        }
+        receiver->callback(receiver->handle, conn->buffer + offset, frameSize);
+        offset += frameSize;
+    }
+    if (offset > 0) {
+        memmove(conn->buffer, conn->buffer + offset, conn->size - offset);
+        conn->size -= offset;
+    }
+    return true;
+}
+
+static void* celix_eventRemoteTcpReceiver_thread(void* data) {
+    celix_event_remote_tcp_receiver_t* receiver = data;
+    struct pollfd fds[2 + CELIX_EVENT_REMOTE_TCP_MAX_CONNECTIONS];
+    while (true) {
+        fds[0].fd = receiver->eventFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = receiver->listenFd;
+        fds[1].events = POLLIN;
+        size_t nrOfConnections = receiver->nrOfConnections;
+        for (size_t i = 0; i < nrOfConnections; ++i) {
+            fds[2 + i].fd = receiver->connections[i].fd;
+            fds[2 + i].events = POLLIN;
+        }
+        int rc = poll(fds, 2 + nrOfConnections, -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            celix_logHelper_error(receiver->logHelper, "Failed to poll tcp connections. %d.", errno);
+            break;
+        }
+        if (fds[0].revents != 0) {
+            break;//stopped
+        }
+        //Iterate backwards, closing a connection moves the last connection to the closed slot.
+        for (size_t i = nrOfConnections; i > 0; --i) {
+            if (fds[1 + i].revents != 0 &&
+                !celix_eventRemoteTcpReceiver_readConnection(receiver, &receiver->connections[i - 1])) {
+                celix_eventRemoteTcpReceiver_closeConnection(receiver, i - 1);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            celix_eventRemoteTcpReceiver_accept(receiver);
+        }
+    }
+    return NULL;
+}
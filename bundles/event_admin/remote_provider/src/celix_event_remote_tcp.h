@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_EVENT_REMOTE_TCP_H
+#define CELIX_EVENT_REMOTE_TCP_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "celix_event_remote_codec.h"
+#include "celix_log_helper.h"
+#include "celix_cleanup.h"
+#include "celix_errno.h"
+
+/**
+ * @brief Sends frames over a TCP stream to a peer. Every frame is written as a whole, so that a batch of events
+ * costs a single write call. The connection is (re)established on demand.
+ */
+typedef struct celix_event_remote_tcp_sender celix_event_remote_tcp_sender_t;
+
+celix_event_remote_tcp_sender_t* celix_eventRemoteTcpSender_create(celix_log_helper_t* logHelper, const char* host, int port);
+
+void celix_eventRemoteTcpSender_destroy(celix_event_remote_tcp_sender_t* sender);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_remote_tcp_sender_t, celix_eventRemoteTcpSender_destroy);
+
+/**
+ * @brief Sends a frame to the peer. Thread safe.
+ * @return CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the peer is not connected (a new connection is tried at most once
+ * per second) or an errno status if the frame could not be written. If writing fails, the connection is closed.
+ */
+celix_status_t celix_eventRemoteTcpSender_send(celix_event_remote_tcp_sender_t* sender, const void* frame, size_t size);
+
+/**
+ * @brief Receives frames from the peers which are connected to a TCP port. The frames are received in a single
+ * thread, which calls the frame callback.
+ * The peers are not authenticated, every process which can connect to the port can deliver frames.
+ */
+typedef struct celix_event_remote_tcp_receiver celix_event_remote_tcp_receiver_t;
+
+/**
+ * @brief Creates a receiver which listens on the given host and port.
+ * @param[in] host The interface address to listen on, NULL for all interfaces.
+ * @param[in] port The port, 0 for a port chosen by the system.
+ */
+celix_event_remote_tcp_receiver_t* celix_eventRemoteTcpReceiver_create(celix_log_helper_t* logHelper, const char* host, int port,
+                                                                       celix_event_remote_frame_received_fp callback, void* handle);
+
+void celix_eventRemoteTcpReceiver_destroy(celix_event_remote_tcp_receiver_t* receiver);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(celix_event_remote_tcp_receiver_t, celix_eventRemoteTcpReceiver_destroy);
+
+/**
+ * @brief Returns the port on which the receiver listens.
+ */
+int celix_eventRemoteTcpReceiver_getPort(const celix_event_remote_tcp_receiver_t* receiver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_EVENT_REMOTE_TCP_H
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "celix/FrameworkFactory.h"
+#include "civetweb.h"
+
+#define HTTP_PORT 45113
+
+class HttpUploadTestSuite : public ::testing::Test {
+public:
+    static constexpr size_t UPLOAD_SIZE = 64 * 1024 * 1024;
+    static constexpr size_t UPLOAD_PART_SIZE = 64 * 1024;
+
+    HttpUploadTestSuite() {
+        celix::Properties config{
+                {"CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "trace"},
+                {"CELIX_HTTP_ADMIN_LISTENING_PORTS", std::to_string(HTTP_PORT) },
+                {"CELIX_HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE", std::to_string(UPLOAD_SIZE) }
+        };
+        fw = celix::createFramework(config);
+        ctx = fw->getFrameworkBundleContext();
+
+        long httpAdminBndId = ctx->installBundle(HTTP_ADMIN_BUNDLE);
+        EXPECT_GE(httpAdminBndId, 0);
+
+        long httpEndpointProviderBndId = ctx->installBundle(HTTP_ADMIN_SUT_BUNDLE);
+        EXPECT_GE(httpEndpointProviderBndId, 0);
+
+        uploadPart.resize(UPLOAD_PART_SIZE);
+        for (size_t i = 0; i < uploadPart.size(); ++i) {
+            uploadPart[i] = (char)('a' + i % 26);
+        }
+    }
+
+    /**
+     * Uploads uploadSize bytes to the given uri and returns the number of received bytes as reported in the response
+     * of the sut upload services, or -1 if the upload failed.
+     * The upload throughput is printed.
+     */
+    long long upload(const char* method, const char* uri, size_t uploadSize, bool chunked, int expectedStatus = 200) {
+        char errBuf[100] = {0};
+        auto* connection = mg_connect_client("localhost", HTTP_PORT /*port*/, 0 /*no ssl*/, errBuf, sizeof(errBuf));
+        EXPECT_TRUE(connection != nullptr);
+        if (connection == nullptr) {
+            return -1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (chunked) {
+            mg_printf(connection, "%s %s HTTP/1.1\r\n"
+                                  "Content-Type: application/octet-stream\r\n"
+                                  "Transfer-Encoding: chunked\r\n\r\n", method, uri);
+        } else {
+            mg_printf(connection, "%s %s HTTP/1.1\r\n"
+                                  "Content-Type: application/octet-stream\r\n"
+                                  "Content-Length: %zu\r\n\r\n", method, uri, uploadSize);
+        }
+        size_t sent = 0;
+        while (sent < uploadSize) {
+            size_t len = std::min(uploadPart.size(), uploadSize - sent);
+            int rc = chunked ? mg_send_chunk(connection, uploadPart.data(), (unsigned int)len) :
+                               mg_write(connection, uploadPart.data(), len);
+            EXPECT_GT(rc, 0);
+            if (rc <= 0) {
+                mg_close_connection(connection);
+                return -1;
+            }
+            sent += len;
+        }
+        if (chunked) {
+            mg_send_chunk(connection, "", 0); //last chunk
+        }
+
+        long long received = -1;
+        auto response = mg_get_response(connection, errBuf, sizeof(errBuf), 10000);
+        EXPECT_GT(response, 0);
+        auto* responseInfo = mg_get_response_info(connection);
+        if (response > 0 && responseInfo != nullptr) {
+            EXPECT_EQ(expectedStatus, responseInfo->status_code);
+            char content[32] = {0};
+            if (responseInfo->status_code == 200 && mg_read(connection, content, sizeof(content) - 1) > 0) {
+                received = std::stoll(content);
+            }
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << method << " " << uri << (chunked ? " (chunked)" : "") << ": uploaded "
+                  << (uploadSize / (1024 * 1024)) << " MiB with " << ((double)uploadSize / (1024 * 1024) / elapsed)
+                  << " MiB/s" << std::endl;
+
+        mg_close_connection(connection);
+        return received;
+    }
+
+    std::shared_ptr<celix::Framework> fw{};
+    std::shared_ptr<celix::BundleContext> ctx{};
+    std::vector<char> uploadPart{};
+};
+
+TEST_F(HttpUploadTestSuite, StreamingPostUploadTest) {
+    EXPECT_EQ((long long)UPLOAD_SIZE, upload("POST", "/upload", UPLOAD_SIZE, false));
+}
+
+TEST_F(HttpUploadTestSuite, StreamingPutUploadTest) {
+    EXPECT_EQ((long long)UPLOAD_SIZE, upload("PUT", "/upload", UPLOAD_SIZE, false));
+}
+
+TEST_F(HttpUploadTestSuite, StreamingChunkedUploadTest) {
+    EXPECT_EQ((long long)UPLOAD_SIZE, upload("POST", "/upload", UPLOAD_SIZE, true));
+}
+
+TEST_F(HttpUploadTestSuite, BufferedPostUploadTest) {
+    //Throughput reference for the streaming upload tests, the complete body is buffered by the HTTP admin
+    EXPECT_EQ((long long)UPLOAD_SIZE, upload("POST", "/upload_buffered", UPLOAD_SIZE, false));
+}
+
+TEST_F(HttpUploadTestSuite, BufferedChunkedUploadTest) {
+    //A chunked body, with an unknown length, is also buffered for the non-streaming request functions
+    EXPECT_EQ((long long)UPLOAD_PART_SIZE * 3 + 10, upload("POST", "/upload_buffered", UPLOAD_PART_SIZE * 3 + 10, true));
+}
+
+TEST_F(HttpUploadTestSuite, EmptyUploadTest) {
+    EXPECT_EQ(0, upload("POST", "/upload", 0, false));
+    EXPECT_EQ(0, upload("POST", "/upload", 0, true));
+    EXPECT_EQ(0, upload("POST", "/upload_buffered", 0, false));
+}
+
+TEST_F(HttpUploadTestSuite, BufferedUploadAboveMaxSizeTest) {
+    //A buffered body above CELIX_HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE is rejected before it is read
+    char errBuf[100] = {0};
+    auto* connection = mg_connect_client("localhost", HTTP_PORT /*port*/, 0 /*no ssl*/, errBuf, sizeof(errBuf));
+    ASSERT_TRUE(connection != nullptr);
+    mg_printf(connection, "POST /upload_buffered HTTP/1.1\r\n"
+                          "Content-Type: application/octet-stream\r\n"
+                          "Content-Length: %zu\r\n\r\n", UPLOAD_SIZE + 1);
+    EXPECT_GT(mg_get_response(connection, errBuf, sizeof(errBuf), 10000), 0);
+    auto* responseInfo = mg_get_response_info(connection);
+    ASSERT_TRUE(responseInfo != nullptr);
+    EXPECT_EQ(413, responseInfo->status_code);
+    mg_close_connection(connection);
+
+    //A chunked body is rejected when more than CELIX_HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE is received
+    EXPECT_EQ(-1, upload("POST", "/upload_buffered", UPLOAD_SIZE + 1, true, 413));
+}
+
+TEST_F(HttpUploadTestSuite, StreamingUploadAboveMaxBufferedSizeTest) {
+    //The max buffered body size does not apply to the streaming request functions
+    EXPECT_EQ((long long)UPLOAD_SIZE + UPLOAD_PART_SIZE, upload("POST", "/upload", UPLOAD_SIZE + UPLOAD_PART_SIZE, false));
+}
+
+TEST_F(HttpUploadTestSuite, UnversionedStreamingServiceTest) {
+    //doPostStream is not used for a service registered without a service version of at least 1.1.0
+    EXPECT_EQ((long long)UPLOAD_PART_SIZE, upload("POST", "/upload_unversioned", UPLOAD_PART_SIZE, false));
+}
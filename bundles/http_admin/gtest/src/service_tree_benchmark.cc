@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "service_tree.h"
+
+/**
+ * Benchmark for routing a request URI with the http admin service tree.
+ *
+ * The service tree is filled with state.range(0) services registered for "/app<i % 10>/service<i>" and requests
+ * are routed to "/app<i % 10>/service<i>/resource/index.html". The routing benchmark runs with 1 and 4 threads.
+ */
+static service_tree_t g_tree{};
+static std::vector<int> g_services{};
+static std::vector<std::string> g_requestUris{};
+
+static std::string serviceUri(int64_t i) {
+    return "/app" + std::to_string(i % 10) + "/service" + std::to_string(i);
+}
+
+static void fillServiceTree(int64_t nrOfServices) {
+    g_services.resize(nrOfServices);
+    g_requestUris.clear();
+    for (int64_t i = 0; i < nrOfServices; ++i) {
+        addServiceNode(&g_tree, serviceUri(i).c_str(), &g_services[i]);
+        g_requestUris.emplace_back(serviceUri(i) + "/resource/index.html");
+    }
+}
+
+static void ServiceTree_Route(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        fillServiceTree(state.range(0));
+    }
+    size_t i = (size_t)state.thread_index();
+    for (auto _ : state) {
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&g_tree);
+        void* svc = findServiceInTree(&g_tree, g_requestUris[i++ % g_requestUris.size()].c_str());
+        benchmark::DoNotOptimize(svc);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        destroyServiceTree(&g_tree);
+    }
+}
+
+static void ServiceTree_AddRemove(benchmark::State& state) {
+    fillServiceTree(state.range(0));
+    int extraSvc = 0;
+    for (auto _ : state) {
+        addServiceNode(&g_tree, "/extra/service", &extraSvc);
+        removeServiceNode(&g_tree, "/extra/service", &extraSvc);
+    }
+    state.SetItemsProcessed(state.iterations());
+    destroyServiceTree(&g_tree);
+}
+
+BENCHMARK(ServiceTree_Route)->RangeMultiplier(10)->Range(10, 1000)->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(ServiceTree_AddRemove)->RangeMultiplier(10)->Range(10, 1000);
@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "service_tree.h"
+
+class ServiceTreeTestSuite : public ::testing::Test {
+public:
+    ~ServiceTreeTestSuite() override {
+        destroyServiceTree(&tree);
+    }
+
+    void* find(const char* uri) {
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&tree);
+        return findServiceInTree(&tree, uri);
+    }
+
+    service_tree_t tree{};
+    int svc1{1};
+    int svc2{2};
+    int svc3{3};
+};
+
+TEST_F(ServiceTreeTestSuite, EmptyTreeTest) {
+    EXPECT_EQ(nullptr, find("/"));
+    EXPECT_EQ(nullptr, find("/foo"));
+    EXPECT_FALSE(removeServiceNode(&tree, "/foo", &svc1));
+}
+
+TEST_F(ServiceTreeTestSuite, LongestMatchTest) {
+    EXPECT_TRUE(addServiceNode(&tree, "/", &svc1));
+    EXPECT_TRUE(addServiceNode(&tree, "/alias", &svc2));
+    EXPECT_TRUE(addServiceNode(&tree, "/foo/bar", &svc3));
+
+    EXPECT_EQ(&svc1, find("/"));
+    EXPECT_EQ(&svc1, find("/unknown/index.html"));
+    EXPECT_EQ(&svc2, find("/alias"));
+    EXPECT_EQ(&svc2, find("/alias/index.html"));
+    EXPECT_EQ(&svc1, find("/aliasx"));
+    EXPECT_EQ(&svc1, find("/foo"));
+    EXPECT_EQ(&svc3, find("/foo/bar"));
+    EXPECT_EQ(&svc3, find("/foo/bar/baz/index.html"));
+    EXPECT_EQ(&svc3, find("//foo//bar/"));
+}
+
+TEST_F(ServiceTreeTestSuite, NoRootServiceTest) {
+    EXPECT_TRUE(addServiceNode(&tree, "/foo/bar", &svc1));
+
+    EXPECT_EQ(nullptr, find("/"));
+    EXPECT_EQ(nullptr, find("/foo"));
+    EXPECT_EQ(nullptr, find("/other/bar"));
+    EXPECT_EQ(&svc1, find("/foo/bar/index.html"));
+}
+
+TEST_F(ServiceTreeTestSuite, DuplicateUriTest) {
+    EXPECT_TRUE(addServiceNode(&tree, "/foo", &svc1));
+    EXPECT_FALSE(addServiceNode(&tree, "/foo", &svc2));
+    EXPECT_FALSE(addServiceNode(&tree, "/foo/", &svc2)); //same URI after normalization
+    EXPECT_EQ(&svc1, find("/foo"));
+
+    //removing the rejected service does not remove the registered service
+    EXPECT_FALSE(removeServiceNode(&tree, "/foo", &svc2));
+    EXPECT_EQ(&svc1, find("/foo"));
+}
+
+TEST_F(ServiceTreeTestSuite, RemoveServiceTest) {
+    EXPECT_TRUE(addServiceNode(&tree, "/", &svc1));
+    EXPECT_TRUE(addServiceNode(&tree, "/foo", &svc2));
+    EXPECT_TRUE(addServiceNode(&tree, "/foo/bar", &svc3));
+
+    EXPECT_TRUE(removeServiceNode(&tree, "/foo", &svc2));
+    EXPECT_EQ(&svc1, find("/foo"));
+    EXPECT_EQ(&svc3, find("/foo/bar"));
+    EXPECT_FALSE(removeServiceNode(&tree, "/foo", &svc2));
+
+    EXPECT_TRUE(removeServiceNode(&tree, "/", &svc1));
+    EXPECT_EQ(nullptr, find("/foo"));
+    EXPECT_EQ(&svc3, find("/foo/bar"));
+
+    EXPECT_TRUE(removeServiceNode(&tree, "/foo/bar", &svc3));
+    EXPECT_EQ(nullptr, find("/foo/bar"));
+
+    //services can be added again after removal
+    EXPECT_TRUE(addServiceNode(&tree, "/foo", &svc2));
+    EXPECT_EQ(&svc2, find("/foo/bar"));
+}
+
+TEST_F(ServiceTreeTestSuite, ManyServicesTest) {
+    const int nrOfServices = 1000;
+    std::vector<int> services(nrOfServices);
+    for (int i = 0; i < nrOfServices; ++i) {
+        auto uri = "/service" + std::to_string(i % 10) + "/endpoint" + std::to_string(i);
+        EXPECT_TRUE(addServiceNode(&tree, uri.c_str(), &services[i]));
+    }
+    for (int i = 0; i < nrOfServices; ++i) {
+        auto uri = "/service" + std::to_string(i % 10) + "/endpoint" + std::to_string(i) + "/resource";
+        EXPECT_EQ(&services[i], find(uri.c_str()));
+    }
+    EXPECT_EQ(nullptr, find("/service1/endpoint0"));
+}
+
+TEST_F(ServiceTreeTestSuite, ConcurrentRoutingTest) {
+    //A removed service is not used by readers after removeServiceNode returns.
+    struct TestService {
+        std::atomic<bool> available{true};
+    };
+    std::atomic<bool> stop{false};
+    std::atomic<long> nrOfUnavailableUses{0};
+    std::atomic<long> nrOfRoutedRequests{0};
+
+    std::vector<std::thread> readers{};
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&tree);
+                auto* svc = static_cast<TestService*>(findServiceInTree(&tree, "/foo/bar/index.html"));
+                if (svc != nullptr) {
+                    std::this_thread::yield(); //use the service for a while
+                    if (!svc->available.load()) {
+                        nrOfUnavailableUses++;
+                    }
+                    nrOfRoutedRequests++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        auto* svc = new TestService{};
+        EXPECT_TRUE(addServiceNode(&tree, i % 2 == 0 ? "/foo" : "/foo/bar", svc));
+        std::this_thread::yield();
+        EXPECT_TRUE(removeServiceNode(&tree, i % 2 == 0 ? "/foo" : "/foo/bar", svc));
+        svc->available = false;
+        delete svc;
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(0, nrOfUnavailableUses.load());
+    EXPECT_GT(nrOfRoutedRequests.load(), 0);
+}
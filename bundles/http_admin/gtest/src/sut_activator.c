@@ -17,10 +17,12 @@
  * under the License.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "celix_bundle_activator.h"
 #include "celix_compiler.h"
+#include "celix_constants.h"
 #include "http_admin/api.h"
 
 #include "civetweb.h"
@@ -29,9 +31,15 @@ struct activator {
     celix_http_service_t httpSvc;
     celix_http_service_t httpSvc2;
     celix_http_service_t httpSvc3;
+    celix_http_service_t uploadSvc;
+    celix_http_service_t bufferedUploadSvc;
+    celix_http_service_t unversionedUploadSvc;
     long httpSvcId;
     long httpSvcId2;
     long httpSvcId3;
+    long uploadSvcId;
+    long bufferedUploadSvcId;
+    long unversionedUploadSvcId;
 
     celix_websocket_service_t sockSvc;
     long sockSvcId;
@@ -39,6 +47,9 @@ struct activator {
 
 //Local function prototypes
 int alias_test_put(void *handle, struct mg_connection *connection, const char *path, const char *data, size_t length);
+int upload_test_stream(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+int upload_test_post(void *handle, struct mg_connection *connection, const char *data, size_t length);
+int upload_test_unexpected_stream(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
 int websocket_data_echo(struct mg_connection *connection, int op_code, char *data, size_t length, void *handle);
 
 celix_status_t bnd_start(struct activator *act, celix_bundle_context_t *ctx) {
@@ -58,6 +69,28 @@ celix_status_t bnd_start(struct activator *act, celix_bundle_context_t *ctx) {
     act->httpSvc3.handle = act;
     act->httpSvcId3 = celix_bundleContext_registerService(ctx, &act->httpSvc3, HTTP_ADMIN_SERVICE_NAME, props3);
 
+    celix_properties_t *uploadProps = celix_properties_create();
+    celix_properties_set(uploadProps, HTTP_ADMIN_URI, "/upload");
+    celix_properties_set(uploadProps, CELIX_FRAMEWORK_SERVICE_VERSION, HTTP_ADMIN_SERVICE_VERSION);
+    act->uploadSvc.handle = act;
+    act->uploadSvc.doPostStream = upload_test_stream;
+    act->uploadSvc.doPutStream = upload_test_stream;
+    act->uploadSvcId = celix_bundleContext_registerService(ctx, &act->uploadSvc, HTTP_ADMIN_SERVICE_NAME, uploadProps);
+
+    celix_properties_t *bufferedUploadProps = celix_properties_create();
+    celix_properties_set(bufferedUploadProps, HTTP_ADMIN_URI, "/upload_buffered");
+    act->bufferedUploadSvc.handle = act;
+    act->bufferedUploadSvc.doPost = upload_test_post;
+    act->bufferedUploadSvcId = celix_bundleContext_registerService(ctx, &act->bufferedUploadSvc, HTTP_ADMIN_SERVICE_NAME, bufferedUploadProps);
+
+    //A service without service version, for which the streaming request functions should not be used
+    celix_properties_t *unversionedUploadProps = celix_properties_create();
+    celix_properties_set(unversionedUploadProps, HTTP_ADMIN_URI, "/upload_unversioned");
+    act->unversionedUploadSvc.handle = act;
+    act->unversionedUploadSvc.doPost = upload_test_post;
+    act->unversionedUploadSvc.doPostStream = upload_test_unexpected_stream;
+    act->unversionedUploadSvcId = celix_bundleContext_registerService(ctx, &act->unversionedUploadSvc, HTTP_ADMIN_SERVICE_NAME, unversionedUploadProps);
+
     celix_properties_t *props4 = celix_properties_create();
     celix_properties_set(props4, WEBSOCKET_ADMIN_URI, "/");
     act->sockSvc.handle = act;
@@ -71,6 +104,9 @@ celix_status_t bnd_stop(struct activator *act, celix_bundle_context_t *ctx) {
     celix_bundleContext_unregisterService(ctx, act->httpSvcId);
     celix_bundleContext_unregisterService(ctx, act->httpSvcId2);
     celix_bundleContext_unregisterService(ctx, act->httpSvcId3);
+    celix_bundleContext_unregisterService(ctx, act->uploadSvcId);
+    celix_bundleContext_unregisterService(ctx, act->bufferedUploadSvcId);
+    celix_bundleContext_unregisterService(ctx, act->unversionedUploadSvcId);
     celix_bundleContext_unregisterService(ctx, act->sockSvcId);
 
     return CELIX_SUCCESS;
@@ -90,6 +126,40 @@ int alias_test_put(void *handle CELIX_UNUSED, struct mg_connection *connection,
     return 200;
 }
 
+static int upload_test_respond(struct mg_connection *connection, long long length) {
+    //Respond with the number of received bytes
+    char content[32];
+    int contentLength = snprintf(content, sizeof(content), "%lld", length);
+    mg_printf(connection,
+              "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
+              contentLength, content);
+    return 200;
+}
+
+int upload_test_stream(void *handle CELIX_UNUSED, struct mg_connection *connection, const char *path CELIX_UNUSED, celix_http_request_body_t *body) {
+    //Read the body in parts with a bounded buffer, as a service processing a large upload would do
+    char buf[16 * 1024];
+    long long total = 0;
+    int rc;
+    while ((rc = body->read(body->handle, buf, sizeof(buf))) > 0) {
+        total += rc;
+    }
+    if (rc < 0) {
+        mg_send_http_error(connection, 400, "%s", "Bad request");
+        return 400;
+    }
+    return upload_test_respond(connection, total);
+}
+
+int upload_test_post(void *handle CELIX_UNUSED, struct mg_connection *connection, const char *data CELIX_UNUSED, size_t length) {
+    return upload_test_respond(connection, (long long)length);
+}
+
+int upload_test_unexpected_stream(void *handle CELIX_UNUSED, struct mg_connection *connection, const char *path CELIX_UNUSED, celix_http_request_body_t *body CELIX_UNUSED) {
+    mg_send_http_error(connection, 500, "%s", "Unexpected streaming request");
+    return 500;
+}
+
 int websocket_data_echo(struct mg_connection *connection, int op_code CELIX_UNUSED, char *data, size_t length, void *handle CELIX_UNUSED) {
     mg_websocket_write(connection, MG_WEBSOCKET_OPCODE_PONG, data, length);
 
@@ -20,10 +20,12 @@
 #include <ctype.h>
 #include <limits.h>
 #include <memory.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 
 #include "http_admin.h"
+#include "http_admin_constants.h"
 #include "http_admin/api.h"
 #include "service_tree.h"
 
@@ -31,22 +33,41 @@
 
 #include "celix_utils_api.h"
 #include "celix_compiler.h"
+#include "celix_constants.h"
+#include "celix_long_hash_map.h"
+#include "celix_version.h"
 
 
 struct http_admin_manager {
     celix_bundle_context_t *context;
     struct mg_context *mgCtx;
     char *root;
+    size_t maxBufferedBodySize; //Max size of a request body read in a single buffer, larger bodies are rejected
 
     celix_thread_rwlock_t admin_lock;  //protects below
 
     celix_http_info_service_t infoSvc;
     long infoSvcId;
     celix_array_list_t *aliasList;      //Array list of http_alias_t
-    service_tree_t http_svc_tree;
+    celix_long_hash_map_t *httpSvcs;    //Key: service id, value: copy of the celix_http_service_t in the service tree
+    service_tree_t http_svc_tree;       //Lock-free for routing requests, updates are protected by admin_lock
 };
 
 
+/**
+ * Reader state of a request body, used as handle of celix_http_request_body_t.
+ */
+typedef struct http_admin_body_reader {
+    struct mg_connection *connection;
+    long long contentLength; //-1 if unknown (chunked transfer-encoding)
+    long long bytesRead;
+} http_admin_body_reader_t;
+
+/**
+ * Initial buffer size used to read a request body with an unknown length.
+ */
+#define HTTP_ADMIN_BODY_INITIAL_BUFFER_SIZE (16 * 1024)
+
 typedef struct http_alias {
     char *url;
     char *alias_path;
@@ -57,6 +78,8 @@ typedef struct http_alias {
 //Local function prototypes
 static int http_request_handle(struct mg_connection *connection);
 static void httpAdmin_updateInfoSvc(http_admin_manager_t *admin);
+static int httpAdmin_readBody(void *handle, void *buffer, size_t length);
+static int httpAdmin_readCompleteBody(struct mg_connection *connection, long long contentLength, size_t maxLength, char **data, size_t *length);
 static void createAliasesSymlink(const char *aliases, const char *admin_root, const char *bundle_root, long bundle_id, celix_array_list_t *alias_list);
 static bool aliasList_containsAlias(celix_array_list_t *alias_list, const char *alias);
 
@@ -70,9 +93,18 @@ http_admin_manager_t *httpAdmin_create(celix_bundle_context_t *context, char *ro
     admin->context = context;
     admin->root = root;
     admin->infoSvcId = -1L;
+    long maxBufferedBodySize = celix_bundleContext_getPropertyAsLong(context, HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE_KEY,
+                                                                     HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE_DFT);
+    admin->maxBufferedBodySize = maxBufferedBodySize < 0 ? 0 : (size_t)maxBufferedBodySize;
 
     status = celixThreadRwlock_create(&admin->admin_lock, NULL);
     admin->aliasList = celix_arrayList_create();
+    celix_long_hash_map_create_options_t httpSvcsOpts = CELIX_EMPTY_LONG_HASH_MAP_CREATE_OPTIONS;
+    httpSvcsOpts.simpleRemovedCallback = free;
+    admin->httpSvcs = celix_longHashMap_createWithOptions(&httpSvcsOpts);
+    if (status == CELIX_SUCCESS && admin->httpSvcs == NULL) {
+        status = CELIX_ENOMEM;
+    }
 
     if (status == CELIX_SUCCESS) {
         //Use only begin_request callback
@@ -96,6 +128,7 @@ http_admin_manager_t *httpAdmin_create(celix_bundle_context_t *context, char *ro
         }
         celixThreadRwlock_destroy(&admin->admin_lock);
 
+        celix_longHashMap_destroy(admin->httpSvcs);
         celix_arrayList_destroy(admin->aliasList);
         free(admin);
         admin = NULL;
@@ -112,6 +145,7 @@ void httpAdmin_destroy(http_admin_manager_t *admin) {
     celixThreadRwlock_writeLock(&(admin->admin_lock));
     celix_bundleContext_unregisterService(admin->context, admin->infoSvcId);
     destroyServiceTree(&admin->http_svc_tree);
+    celix_longHashMap_destroy(admin->httpSvcs);
 
     //Destroy alias map by removing symbolic links first.
     unsigned int size = celix_arrayList_size(admin->aliasList);
@@ -140,16 +174,64 @@ struct mg_context *httpAdmin_getServerContext(const http_admin_manager_t *admin)
     return admin->mgCtx;
 }
 
+/**
+ * Copies the HTTP service, so that the streaming request functions which are not provided by services registered
+ * without a service version of at least 1.1.0 are set to NULL instead of being read beyond the provided service.
+ */
+static celix_status_t httpAdmin_copyHttpService(const celix_http_service_t *svc, const celix_properties_t *props,
+                                                celix_http_service_t **out) {
+    celix_autoptr(celix_version_t) version = NULL;
+    celix_status_t status = celix_properties_getAsVersion(props, CELIX_FRAMEWORK_SERVICE_VERSION, NULL, &version);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    if (version == NULL && celix_properties_get(props, CELIX_FRAMEWORK_SERVICE_VERSION, NULL) != NULL) {
+        printf("Invalid service version '%s' for HTTP service with URI %s, streaming request functions are not used.\n",
+               celix_properties_get(props, CELIX_FRAMEWORK_SERVICE_VERSION, NULL),
+               celix_properties_get(props, HTTP_ADMIN_URI, ""));
+    }
+    celix_http_service_t *copy = calloc(1, sizeof(*copy));
+    if (copy == NULL) {
+        return CELIX_ENOMEM;
+    }
+    copy->handle = svc->handle;
+    copy->doGet = svc->doGet;
+    copy->doHead = svc->doHead;
+    copy->doPost = svc->doPost;
+    copy->doPut = svc->doPut;
+    copy->doDelete = svc->doDelete;
+    copy->doTrace = svc->doTrace;
+    copy->doOptions = svc->doOptions;
+    copy->doPatch = svc->doPatch;
+    if (version != NULL && celix_version_compareToMajorMinor(version, 1, 1) >= 0) {
+        copy->doPostStream = svc->doPostStream;
+        copy->doPutStream = svc->doPutStream;
+    }
+    *out = copy;
+    return CELIX_SUCCESS;
+}
+
 void http_admin_addHttpService(void *handle, void *svc, const celix_properties_t *props) {
     http_admin_manager_t *admin = (http_admin_manager_t *) handle;
-    celix_http_service_t *httpSvc = (celix_http_service_t *) svc;
 
     const char *uri = celix_properties_get(props, HTTP_ADMIN_URI, NULL);
+    long svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1L);
 
     if(uri != NULL) {
+        celix_http_service_t *httpSvc = NULL;
+        celix_status_t status = httpAdmin_copyHttpService(svc, props, &httpSvc);
+        if (status != CELIX_SUCCESS) {
+            printf("Cannot add HTTP service with URI %s: %s\n", uri, celix_strerror(status));
+            return;
+        }
         celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
         if(!addServiceNode(&admin->http_svc_tree, uri, httpSvc)) {
             printf("HTTP service with URI %s already exists!\n", uri);
+            free(httpSvc);
+        } else if (celix_longHashMap_put(admin->httpSvcs, svcId, httpSvc) != CELIX_SUCCESS) {
+            printf("Cannot add HTTP service with URI %s, out of memory!\n", uri);
+            removeServiceNode(&admin->http_svc_tree, uri, httpSvc);
+            free(httpSvc);
         }
     }
 }
@@ -158,18 +240,16 @@ void http_admin_removeHttpService(void *handle, void *svc CELIX_UNUSED, const ce
     http_admin_manager_t *admin = (http_admin_manager_t *) handle;
 
     const char *uri = celix_properties_get(props, HTTP_ADMIN_URI, NULL);
+    long svcId = celix_properties_getAsLong(props, CELIX_FRAMEWORK_SERVICE_ID, -1L);
 
     if(uri != NULL) {
         celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
-        service_tree_node_t *node = NULL;
-
-        node = findServiceNodeInTree(&admin->http_svc_tree, uri);
-
-        if(node != NULL){
-            destroyServiceNode(&admin->http_svc_tree, node, &admin->http_svc_tree.tree_node_count, &admin->http_svc_tree.tree_svc_count);
-        } else {
+        celix_http_service_t *httpSvc = celix_longHashMap_get(admin->httpSvcs, svcId);
+        if(httpSvc == NULL || !removeServiceNode(&admin->http_svc_tree, uri, httpSvc)) {
             printf("Couldn't remove HTTP service with URI: %s, it doesn't exist\n", uri);
         }
+        //note removeServiceNode returns after the copy cannot be used by a request anymore
+        celix_longHashMap_remove(admin->httpSvcs, svcId);
     }
 }
 
@@ -179,21 +259,18 @@ int http_request_handle(struct mg_connection *connection) {
     if (connection != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         http_admin_manager_t *admin = (http_admin_manager_t *) ri->user_data;
-        service_tree_node_t *node = NULL;
 
         if (mg_get_header(connection, "Upgrade") != NULL) {
             //Assume this is a websocket request...
             ret_status = 0; //... so return zero to let the civetweb server handle the request.
         }
         else {
-            celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
+            celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&admin->http_svc_tree);
             const char *req_uri = ri->request_uri;
-            node = findServiceNodeInTree(&admin->http_svc_tree, req_uri);
-
-            if (node != NULL) {
-                //Requested URI with node exists, now obtain the http service and call the requested function.
-                celix_http_service_t *httpSvc = (celix_http_service_t *) node->svc_data->service;
+            celix_http_service_t *httpSvc = findServiceInTree(&admin->http_svc_tree, req_uri);
 
+            if (httpSvc != NULL) {
+                //Requested URI exists, call the requested function of the http service.
                 if (strcmp("GET", ri->request_method) == 0) {
                     if (httpSvc->doGet != NULL) {
                         ret_status = httpSvc->doGet(httpSvc->handle, connection, req_uri);
@@ -207,60 +284,37 @@ int http_request_handle(struct mg_connection *connection) {
                         ret_status = 0; //Let civetweb handle the request
                     }
                 } else if (strcmp("POST", ri->request_method) == 0) {
-                    if (httpSvc->doPost != NULL) {
-                        int bytes_read = 0;
-                        bool no_data = false;
+                    if (httpSvc->doPostStream != NULL) {
+                        http_admin_body_reader_t reader = {connection, ri->content_length, 0};
+                        celix_http_request_body_t body = {&reader, ri->content_length, httpAdmin_readBody};
+                        ret_status = httpSvc->doPostStream(httpSvc->handle, connection, req_uri, &body);
+                    } else if (httpSvc->doPost != NULL) {
                         char *rcv_buf = NULL;
-
-                        if (ri->content_length > 0) {
-                            int content_size = (ri->content_length > INT_MAX ? INT_MAX : (int) ri->content_length);
-                            rcv_buf = malloc((size_t) content_size + 1);
-                            rcv_buf[content_size] = '\0';
-                            bytes_read = mg_read(connection, rcv_buf, (size_t) content_size);
-                        } else {
-                            no_data = true;
-                        }
-
-                        if (bytes_read > 0 || no_data) {
-                            ret_status = httpSvc->doPost(httpSvc->handle, connection, rcv_buf, (size_t) bytes_read);
-                        } else {
-                            mg_send_http_error(connection, 400, "%s", "Bad request");
-                            ret_status = 400; //Bad Request, failed to read data
-                        }
-
-                        if (rcv_buf != NULL) {
-                            free(rcv_buf);
+                        size_t rcv_len = 0;
+                        ret_status = httpAdmin_readCompleteBody(connection, ri->content_length,
+                                                                admin->maxBufferedBodySize, &rcv_buf, &rcv_len);
+                        if (ret_status == 0) {
+                            ret_status = httpSvc->doPost(httpSvc->handle, connection, rcv_buf, rcv_len);
                         }
+                        free(rcv_buf);
                     } else {
                         ret_status = 0; //Let civetweb handle the request
                     }
 
                 } else if (strcmp("PUT", ri->request_method) == 0) {
-                    if (httpSvc->doPut != NULL) {
-                        int bytes_read = 0;
-                        bool no_data = false;
+                    if (httpSvc->doPutStream != NULL) {
+                        http_admin_body_reader_t reader = {connection, ri->content_length, 0};
+                        celix_http_request_body_t body = {&reader, ri->content_length, httpAdmin_readBody};
+                        ret_status = httpSvc->doPutStream(httpSvc->handle, connection, req_uri, &body);
+                    } else if (httpSvc->doPut != NULL) {
                         char *rcv_buf = NULL;
-
-                        if (ri->content_length > 0) {
-                            int content_size = (ri->content_length > INT_MAX ? INT_MAX : (int) ri->content_length);
-                            rcv_buf = malloc((size_t) content_size + 1);
-                            rcv_buf[content_size] = '\0';
-                            bytes_read = mg_read(connection, rcv_buf, (size_t) content_size);
-                        } else {
-                            no_data = true;
-                        }
-
-                        if (bytes_read > 0 || no_data) {
-                            ret_status = httpSvc->doPut(httpSvc->handle, connection, req_uri, rcv_buf,
-                                                        (size_t) bytes_read);
-                        } else {
-                            mg_send_http_error(connection, 400, "%s", "Bad request");
-                            ret_status = 400; //Bad Request, failed to read data
-                        }
-
-                        if (rcv_buf != NULL) {
-                            free(rcv_buf);
+                        size_t rcv_len = 0;
+                        ret_status = httpAdmin_readCompleteBody(connection, ri->content_length,
+                                                                admin->maxBufferedBodySize, &rcv_buf, &rcv_len);
+                        if (ret_status == 0) {
+                            ret_status = httpSvc->doPut(httpSvc->handle, connection, req_uri, rcv_buf, rcv_len);
                         }
+                        free(rcv_buf);
                     } else {
                         ret_status = 0; //Let civetweb handle the request
                     }
@@ -272,29 +326,14 @@ int http_request_handle(struct mg_connection *connection) {
                     }
                 } else if (strcmp("TRACE", ri->request_method) == 0) {
                     if (httpSvc->doTrace != NULL) {
-                        int bytes_read = 0;
-                        bool no_data = false;
                         char *rcv_buf = NULL;
-
-                        if (ri->content_length > 0) {
-                            int content_size = (ri->content_length > INT_MAX ? INT_MAX : (int) ri->content_length);
-                            rcv_buf = malloc((size_t) content_size + 1);
-                            rcv_buf[content_size] = '\0';
-                            bytes_read = mg_read(connection, rcv_buf, (size_t) content_size);
-                        } else {
-                            no_data = true;
-                        }
-
-                        if (bytes_read > 0 || no_data) {
-                            ret_status = httpSvc->doTrace(httpSvc->handle, connection, rcv_buf, (size_t) bytes_read);
-                        } else {
-                            mg_send_http_error(connection, 400, "%s", "Bad request");
-                            ret_status = 400; //Bad Request, failed to read data
-                        }
-
-                        if (rcv_buf != NULL) {
-                            free(rcv_buf);
+                        size_t rcv_len = 0;
+                        ret_status = httpAdmin_readCompleteBody(connection, ri->content_length,
+                                                                admin->maxBufferedBodySize, &rcv_buf, &rcv_len);
+                        if (ret_status == 0) {
+                            ret_status = httpSvc->doTrace(httpSvc->handle, connection, rcv_buf, rcv_len);
                         }
+                        free(rcv_buf);
                     } else {
                         ret_status = 0; //Let civetweb handle the request
                     }
@@ -306,30 +345,14 @@ int http_request_handle(struct mg_connection *connection) {
                     }
                 } else if (strcmp("PATCH", ri->request_method) == 0) {
                     if (httpSvc->doPatch != NULL) {
-                        int bytes_read = 0;
-                        bool no_data = false;
                         char *rcv_buf = NULL;
-
-                        if (ri->content_length > 0) {
-                            int content_size = (ri->content_length > INT_MAX ? INT_MAX : (int) ri->content_length);
-                            rcv_buf = malloc((size_t) content_size + 1);
-                            rcv_buf[content_size] = '\0';
-                            bytes_read = mg_read(connection, rcv_buf, (size_t) content_size);
-                        } else {
-                            no_data = true;
-                        }
-
-                        if (bytes_read > 0 || no_data) {
-                            ret_status = httpSvc->doPatch(httpSvc->handle, connection, req_uri, rcv_buf,
-                                                          (size_t) bytes_read);
-                        } else {
-                            mg_send_http_error(connection, 400, "%s", "Bad request");
-                            ret_status = 400; //Bad Request, failed to read data
-                        }
-
-                        if (rcv_buf != NULL) {
-                            free(rcv_buf);
+                        size_t rcv_len = 0;
+                        ret_status = httpAdmin_readCompleteBody(connection, ri->content_length,
+                                                                admin->maxBufferedBodySize, &rcv_buf, &rcv_len);
+                        if (ret_status == 0) {
+                            ret_status = httpSvc->doPatch(httpSvc->handle, connection, req_uri, rcv_buf, rcv_len);
                         }
+                        free(rcv_buf);
                     } else {
                         ret_status = 0; //Let civetweb handle the request
                     }
@@ -349,6 +372,97 @@ int http_request_handle(struct mg_connection *connection) {
     return ret_status;
 }
 
+static int httpAdmin_readBody(void *handle, void *buffer, size_t length) {
+    http_admin_body_reader_t *reader = handle;
+    if (length == 0) {
+        return 0;
+    }
+    int bytesRead = mg_read(reader->connection, buffer, length > INT_MAX ? INT_MAX : length);
+    if (bytesRead > 0) {
+        reader->bytesRead += bytesRead;
+    } else if (bytesRead == 0 && reader->contentLength > 0 && reader->bytesRead < reader->contentLength) {
+        bytesRead = -1; //connection closed before the complete body is received
+    } else if (bytesRead < 0) {
+        bytesRead = -1;
+    }
+    return bytesRead;
+}
+
+/**
+ * Reads the complete request body in a single buffer, for the non-streaming request functions.
+ * If the request has no body, data is set to NULL. Otherwise data is a '\0' terminated buffer, which must be freed
+ * by the caller.
+ * A request body larger than maxLength is rejected, so that a client cannot exhaust the memory of the HTTP admin.
+ * Unbounded uploads are only supported by the streaming request functions.
+ *
+ * @return 0 if the request body is read or the HTTP status code of the error response, which is sent on error.
+ */
+static int httpAdmin_readCompleteBody(struct mg_connection *connection, long long contentLength, size_t maxLength,
+                                      char **data, size_t *length) {
+    *data = NULL;
+    *length = 0;
+    if (contentLength == 0) {
+        return 0;
+    }
+    if (contentLength > 0 && (unsigned long long)contentLength > maxLength) {
+        mg_send_http_error(connection, 413, "%s", "Payload too large");
+        return 413;
+    }
+
+    //note a body with an unknown length is read in a growing buffer of at most maxLength + 1 bytes,
+    //so that a body larger than maxLength is detected
+    http_admin_body_reader_t reader = {connection, contentLength, 0};
+    size_t capacity = HTTP_ADMIN_BODY_INITIAL_BUFFER_SIZE;
+    if (contentLength > 0) {
+        capacity = (size_t)contentLength;
+    } else if (maxLength < capacity) {
+        capacity = maxLength + 1;
+    }
+    size_t size = 0;
+    char *buf = malloc(capacity + 1);
+    while (buf != NULL && (contentLength < 0 || size < capacity)) {
+        if (size == capacity) {
+            //body length unknown, grow buffer
+            if (size > maxLength) {
+                free(buf);
+                mg_send_http_error(connection, 413, "%s", "Payload too large");
+                return 413;
+            }
+            size_t newCapacity = capacity > maxLength / 2 ? maxLength + 1 : capacity * 2;
+            char *newBuf = realloc(buf, newCapacity + 1);
+            if (newBuf == NULL) {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = newBuf;
+            capacity = newCapacity;
+        }
+        int rc = httpAdmin_readBody(&reader, buf + size, capacity - size);
+        if (rc < 0) {
+            free(buf);
+            mg_send_http_error(connection, 400, "%s", "Bad request");
+            return 400; //Bad Request, failed to read data
+        } else if (rc == 0) {
+            break;
+        }
+        size += (size_t)rc;
+    }
+
+    if (buf == NULL) {
+        mg_send_http_error(connection, 413, "%s", "Payload too large");
+        return 413;
+    }
+    if (size == 0) {
+        free(buf);
+        return 0;
+    }
+    buf[size] = '\0';
+    *data = buf;
+    *length = size;
+    return 0;
+}
+
 static void httpAdmin_updateInfoSvc(http_admin_manager_t *admin) {
     const char *ports = mg_get_option(admin->mgCtx, "listening_ports");
 
@@ -39,5 +39,8 @@
 #define HTTP_ADMIN_NUM_THREADS_KEY              "CELIX_HTTP_ADMIN_NUM_THREADS"
 #define HTTP_ADMIN_NUM_THREADS_DFT              1L
 
+#define HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE_KEY   "CELIX_HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE"
+#define HTTP_ADMIN_MAX_BUFFERED_BODY_SIZE_DFT   (16L * 1024L * 1024L)
+
 
 #endif //CELIX_HTTP_ADMIN_CONSTANTS_H
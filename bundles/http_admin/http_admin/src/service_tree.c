@@ -16,337 +16,332 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-
 #include <stdlib.h>
 #include <stdbool.h> //for `bool`
-#include <stdio.h>   //for `asprintf`
-#include <memory.h>  //for `strcmp` and `strtok_r`
+#include <stdint.h>
+#include <memory.h>  //for `strcmp`, `strcspn` and `memcmp`
+#include <unistd.h>  //for `usleep`
+
+#include "celix_array_list.h"
+#include "celix_errno.h"
+#include "celix_stdlib_cleanup.h"
 
 #include "service_tree.h"
 
+/**
+ * Sleep time used while waiting until the readers of a replaced router have left the service tree.
+ */
+#define SERVICE_TREE_READER_WAIT_US 100
+
+struct service_tree_node {
+    void *service;                          //Service registered for the URI of this node, NULL if none
+    uint32_t hash;                          //Hash of the segment
+    size_t segment_len;
+    char *segment;                          //URI path segment of this node, empty for the root node
+    size_t children_mask;                   //Size of the children hash table - 1
+    service_tree_node_t **children;         //Open addressing hash table with the child nodes, NULL if no children
+    celix_array_list_t *build_children;     //Child nodes, only used while building the router
+};
+
 //Local function prototypes
-static service_tree_node_t *createServiceNode(service_tree_node_t *parent, service_tree_node_t *children, service_tree_node_t *next, service_tree_node_t *prev, const char *uri, void *svc);
-static size_t getUriTokenCount(const char *uri, const char *separator);
+static uint32_t hashSegment(const char *segment, size_t len);
+static const char *nextUriSegment(const char *uri, size_t *len);
+static char *normalizeUri(const char *uri);
+static service_tree_node_t *createServiceNode(const char *segment, size_t len);
+static void destroyServiceNode(service_tree_node_t *node);
+static service_tree_node_t *getOrCreateChildServiceNode(service_tree_node_t *parent, const char *segment, size_t len);
+static const service_tree_node_t *findChildServiceNode(const service_tree_node_t *parent, const char *segment, size_t len);
+static celix_status_t freezeServiceNode(service_tree_node_t *node);
+static celix_status_t buildRouter(const celix_string_hash_map_t *services, service_tree_node_t **router);
+static void publishRouter(service_tree_t *svc_tree, service_tree_node_t *router);
+static void waitForReaders(service_tree_t *svc_tree);
+
+
+static uint32_t hashSegment(const char *segment, size_t len) {
+    //FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (unsigned char)segment[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
+/**
+ * Returns the next URI path segment (not '\0' terminated) and its length in len, 0 if there are no more segments.
+ * Empty segments are skipped, so "/foo//bar/" has the segments "foo" and "bar".
+ */
+static const char *nextUriSegment(const char *uri, size_t *len) {
+    while (*uri == '/') {
+        uri++;
+    }
+    *len = strcspn(uri, "/");
+    return uri;
+}
 
+/**
+ * Returns the URI with only its path segments, separated by a single '/'. The root URI is normalized to "/".
+ */
+static char *normalizeUri(const char *uri) {
+    char *normalized = malloc(strlen(uri) + 2);
+    if (normalized == NULL) {
+        return NULL;
+    }
+    size_t normalizedLen = 0;
+    size_t len;
+    const char *segment = nextUriSegment(uri, &len);
+    while (len > 0) {
+        normalized[normalizedLen++] = '/';
+        memcpy(normalized + normalizedLen, segment, len);
+        normalizedLen += len;
+        segment = nextUriSegment(segment + len, &len);
+    }
+    if (normalizedLen == 0) {
+        normalized[normalizedLen++] = '/';
+    }
+    normalized[normalizedLen] = '\0';
+    return normalized;
+}
 
-static service_tree_node_t *createServiceNode(service_tree_node_t *parent, service_tree_node_t *children, service_tree_node_t *next, service_tree_node_t *prev, const char *uri, void *svc) {
+static service_tree_node_t *createServiceNode(const char *segment, size_t len) {
     service_tree_node_t *node = calloc(1, sizeof(service_tree_node_t));
-    node->parent = parent;
-    node->children = children;
-    node->next = next;
-    node->prev = prev;
-    node->svc_data = calloc(1, sizeof(service_node_data_t));
-    node->svc_data->sub_uri = (uri != NULL ? strdup(uri) : NULL);
-    node->svc_data->service = svc;
+    if (node != NULL) {
+        node->segment = strndup(segment, len);
+        node->segment_len = len;
+        node->hash = hashSegment(segment, len);
+    }
+    if (node != NULL && node->segment == NULL) {
+        free(node);
+        node = NULL;
+    }
     return node;
 }
 
-static size_t getUriTokenCount(const char *uri, const char *separator) {
-    char *saveptr, *token;
-    char *uri_cpy = strdup(uri);
-    size_t tokenCount = 0;
-
-    token = strtok_r(uri_cpy, separator, &saveptr);
-    while(token != NULL) {
-        tokenCount++;
-        token = strtok_r(NULL, separator, &saveptr);
+static void destroyServiceNode(service_tree_node_t *node) {
+    if (node != NULL) {
+        if (node->children != NULL) {
+            for (size_t i = 0; i <= node->children_mask; ++i) {
+                destroyServiceNode(node->children[i]);
+            }
+            free(node->children);
+        }
+        if (node->build_children != NULL) {
+            int size = celix_arrayList_size(node->build_children);
+            for (int i = 0; i < size; ++i) {
+                destroyServiceNode(celix_arrayList_get(node->build_children, i));
+            }
+            celix_arrayList_destroy(node->build_children);
+        }
+        free(node->segment);
+        free(node);
     }
-
-    free(uri_cpy);
-    return tokenCount;
 }
 
-bool addServiceNode(service_tree_t *svc_tree, const char *uri, void *svc) {
-    char *save_ptr = NULL; //Used internally by strtok_r
-    char *uri_cpy = NULL;
-    char *req_uri = NULL;
-    bool uri_exists = true;
-    size_t tokenCount = getUriTokenCount(uri, "/");
-    size_t subNodeCount = 1;
-
-    if(svc_tree == NULL || uri == NULL){
-        return false;
+static service_tree_node_t *getOrCreateChildServiceNode(service_tree_node_t *parent, const char *segment, size_t len) {
+    if (parent->build_children == NULL) {
+        parent->build_children = celix_arrayList_create();
+        if (parent->build_children == NULL) {
+            return NULL;
+        }
     }
-
-    if(strcmp(uri, "/") == 0 ) {
-        //Create the root URI
-        if(svc_tree->root_node == NULL) { //No service yet added
-            svc_tree->root_node = createServiceNode(NULL, NULL, NULL, NULL, "root", svc);
-            svc_tree->tree_node_count = 1;
-            uri_exists = false;
-        } else if(strcmp(svc_tree->root_node->svc_data->sub_uri, "root") != 0) {
-            service_tree_node_t *node = createServiceNode(NULL, svc_tree->root_node, NULL, NULL, "root", svc);
-            //Set this new node as parent for the first line of nodes
-            service_tree_node_t *tmp = svc_tree->root_node;
-            while(tmp != NULL){
-                tmp->parent = node;
-                tmp = tmp->next;
-            }
-            svc_tree->root_node->parent = node;
-            svc_tree->root_node = node; //Set new root
-            svc_tree->tree_node_count++;
-            uri_exists = false;
+    int size = celix_arrayList_size(parent->build_children);
+    for (int i = 0; i < size; ++i) {
+        service_tree_node_t *child = celix_arrayList_get(parent->build_children, i);
+        if (child->segment_len == len && memcmp(child->segment, segment, len) == 0) {
+            return child;
         }
-        //Else root already exists
-    } else if(svc_tree->root_node == NULL) { //No service yet added
-        uri_cpy = strdup(uri);
-        req_uri = strtok_r(uri_cpy, "/", &save_ptr);
-        svc_tree->root_node = createServiceNode(NULL, NULL, NULL, NULL, req_uri, (tokenCount == 1 ? svc : NULL));
-        svc_tree->tree_node_count = 1;
-        uri_exists = false;
-    } else if(strcmp(svc_tree->root_node->svc_data->sub_uri, "root") == 0){
-        asprintf(&uri_cpy, "%s%s", "root", uri);
-        req_uri = strtok_r(uri_cpy, "/", &save_ptr);
-    } else {
-        uri_cpy = strdup(uri);
-        req_uri = strtok_r(uri_cpy, "/", &save_ptr);
     }
+    service_tree_node_t *child = createServiceNode(segment, len);
+    if (child != NULL && celix_arrayList_add(parent->build_children, child) != CELIX_SUCCESS) {
+        destroyServiceNode(child);
+        child = NULL;
+    }
+    return child;
+}
 
-    service_tree_node_t *current = svc_tree->root_node;
-    service_node_data_t *current_data = current->svc_data;
-    while (req_uri != NULL && subNodeCount <= tokenCount) {
-        bool is_last_entry = (tokenCount == subNodeCount);
-        if (strcmp(current_data->sub_uri, req_uri) == 0) {
-            if (is_last_entry) {
-                //Entry already exists/added in tree
-                if (current_data->service == NULL) {
-                    //When no service added yet, add the current. Because there can already be sub URIs registered
-                    //as children for this URI. No extra node is added, because the node already exists
-                    current_data->service = svc;
-                    uri_exists = false;
-                }
-                req_uri = strtok_r(NULL, "/", &save_ptr);
-            } else if (current->children != NULL) {
-                //Found the parent of the URI, keep searching in the children for sub URIs
-                current = current->children;
-                current_data = current->svc_data;
-                req_uri = strtok_r(NULL, "/", &save_ptr);
-            } else {
-                //Parent has no sub URIs registered yet
-                req_uri = strtok_r(NULL, "/", &save_ptr);
-                //Create svc node without svc pointer, this will be added later if needed.
-                service_tree_node_t *node = createServiceNode(current, NULL, NULL, NULL, req_uri, NULL);
-                current->children = node;
-                current = node;
-                current_data = node->svc_data;
-                svc_tree->tree_node_count++;
-                uri_exists = false;
-            }
-            subNodeCount++;
-        } else if (current->next != NULL) {
-            current = current->next;
-            current_data = current->svc_data;
-        } else {
-            //Not found, so create this URI (tree)
-            service_tree_node_t *node = createServiceNode(current->parent, NULL, NULL, current,
-                                                          req_uri, (is_last_entry ? svc : NULL));
-            current->next = node;
-            current = node;
-            current_data = node->svc_data;
-            svc_tree->tree_node_count++;
-            uri_exists = false;
-            subNodeCount++;
+static const service_tree_node_t *findChildServiceNode(const service_tree_node_t *parent, const char *segment, size_t len) {
+    uint32_t hash = hashSegment(segment, len);
+    for (size_t i = hash & parent->children_mask;; i = (i + 1) & parent->children_mask) {
+        const service_tree_node_t *child = parent->children[i];
+        if (child == NULL) {
+            return NULL;
+        } else if (child->hash == hash && child->segment_len == len && memcmp(child->segment, segment, len) == 0) {
+            return child;
         }
     }
+}
 
-    //Increment tree service count if URI exists (only one service can be added at once)
-    if(!uri_exists) {
-        svc_tree->tree_svc_count++;
+/**
+ * Moves the child nodes of the node (and recursively of its child nodes) to a hash table.
+ * The hash table is at most half full, so a lookup always ends at an empty slot.
+ */
+static celix_status_t freezeServiceNode(service_tree_node_t *node) {
+    if (node->build_children == NULL) {
+        return CELIX_SUCCESS;
     }
-
-    if(uri_cpy) {
-        free(uri_cpy);
+    size_t size = (size_t)celix_arrayList_size(node->build_children);
+    size_t capacity = 2;
+    while (capacity < size * 2) {
+        capacity *= 2;
     }
-
-    return !uri_exists;
+    node->children = calloc(capacity, sizeof(service_tree_node_t *));
+    if (node->children == NULL) {
+        return CELIX_ENOMEM;
+    }
+    node->children_mask = capacity - 1;
+
+    celix_status_t status = CELIX_SUCCESS;
+    for (size_t i = 0; i < size; ++i) {
+        service_tree_node_t *child = celix_arrayList_get(node->build_children, (int)i);
+        size_t slot = child->hash & node->children_mask;
+        while (node->children[slot] != NULL) {
+            slot = (slot + 1) & node->children_mask;
+        }
+        node->children[slot] = child;
+        if (status == CELIX_SUCCESS) {
+            status = freezeServiceNode(child);
+        }
+    }
+    celix_arrayList_destroy(node->build_children);
+    node->build_children = NULL;
+    return status;
 }
 
-void destroyChildrenFromServiceNode(service_tree_node_t *parent, int *tree_item_count, int *tree_svc_count) {
-    if(parent != NULL && tree_item_count != NULL && tree_svc_count != NULL){
-        service_tree_node_t *child = parent->children;
-        while(child != NULL) {
-            if (child->children != NULL) {
-                //Delete children first
-                destroyChildrenFromServiceNode(child, tree_item_count, tree_svc_count);
-
-            } else {
-                //Delete child first
-                service_tree_node_t *next_child = child->next;
+static celix_status_t buildRouter(const celix_string_hash_map_t *services, service_tree_node_t **router) {
+    *router = NULL;
+    if (celix_stringHashMap_size(services) == 0) {
+        return CELIX_SUCCESS;
+    }
 
-                if(child->svc_data != NULL) {
-                    //Decrement service count if a service was present
-                    if(child->svc_data->service != NULL) (*tree_svc_count)--;
-                    free(child->svc_data->sub_uri);
-                    free(child->svc_data);
-                }
-                free(child);
-                (*tree_item_count)--;
-                child = next_child;
-            }
+    service_tree_node_t *root = createServiceNode("", 0);
+    if (root == NULL) {
+        return CELIX_ENOMEM;
+    }
+    CELIX_STRING_HASH_MAP_ITERATE(services, iter) {
+        service_tree_node_t *node = root;
+        size_t len;
+        const char *segment = nextUriSegment(iter.key, &len);
+        while (node != NULL && len > 0) {
+            node = getOrCreateChildServiceNode(node, segment, len);
+            segment = nextUriSegment(segment + len, &len);
+        }
+        if (node == NULL) {
+            destroyServiceNode(root);
+            return CELIX_ENOMEM;
         }
-        parent->children = NULL;
+        node->service = iter.value.ptrValue;
     }
-}
 
-void destroyServiceNode(service_tree_t *svc_tree, service_tree_node_t *node, int *tree_item_count, int *tree_svc_count) {
-    if(node != NULL && tree_item_count != NULL && tree_svc_count != NULL) {
-        bool has_underlaying_services = false;
+    celix_status_t status = freezeServiceNode(root);
+    if (status != CELIX_SUCCESS) {
+        destroyServiceNode(root);
+        return status;
+    }
+    *router = root;
+    return CELIX_SUCCESS;
+}
 
-        //If this service node has children then check if we need to destroy them first
-        if(node->children != NULL) {
-            service_tree_node_t *node_cpy = node;
-            while(node_cpy->children != NULL && has_underlaying_services == false) {
-                service_tree_node_t *node_cpy_horizontal = node_cpy->children;
-                has_underlaying_services |= (node_cpy_horizontal->svc_data->service != NULL);
-                while(node_cpy_horizontal->next != NULL && has_underlaying_services == false) {
-                    has_underlaying_services |= (node_cpy_horizontal->svc_data->service != NULL);
-                    node_cpy_horizontal = node_cpy_horizontal->next;
-                }
-                node_cpy = node_cpy->children;
-            }
+static void publishRouter(service_tree_t *svc_tree, service_tree_node_t *router) {
+    service_tree_node_t *old = __atomic_exchange_n(&svc_tree->root_node, router, __ATOMIC_SEQ_CST);
+    if (old != NULL) {
+        //The replaced router - and the services it routes to - can only be released if no reader uses it anymore
+        waitForReaders(svc_tree);
+        destroyServiceNode(old);
+    }
+}
 
-            //No underlaying services means we can delete all children
-            if(!has_underlaying_services) {
-                destroyChildrenFromServiceNode(node, tree_item_count, tree_svc_count);
-            }
+static void waitForReaders(service_tree_t *svc_tree) {
+    //Readers entering after an epoch flip are counted in the other epoch index, so new readers cannot starve this wait.
+    //The epoch is flipped (and waited for) twice, because a reader which read the epoch before an earlier flip can
+    //still be counted in the current epoch index.
+    for (int i = 0; i < 2; ++i) {
+        unsigned int epoch = __atomic_fetch_add(&svc_tree->reader_epoch, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&svc_tree->reader_count[epoch & 1], __ATOMIC_SEQ_CST) != 0) {
+            usleep(SERVICE_TREE_READER_WAIT_US);
         }
+    }
+}
 
-        //Decrement service count if a service was present
-        if(node->svc_data->service != NULL) {
-            node->svc_data->service = NULL;
-            (*tree_svc_count)--;
+bool addServiceNode(service_tree_t *svc_tree, const char *uri, void *svc) {
+    if (svc_tree == NULL || uri == NULL || svc == NULL) {
+        return false;
+    }
+    if (svc_tree->services == NULL) {
+        svc_tree->services = celix_stringHashMap_create();
+        if (svc_tree->services == NULL) {
+            return false;
         }
+    }
 
-        //When no underlaying services found, we have to take care of some pointers and memory...
-        if(!has_underlaying_services){
-            //Set new children pointer for parent when this is the first child in the tree.
-            //When no next is present the children pointer should become NULL.
-            if(node->parent != NULL && node->prev == NULL){
-                node->parent->children = node->next;
-            }
+    celix_autofree char *key = normalizeUri(uri);
+    if (key == NULL || celix_stringHashMap_hasKey(svc_tree->services, key)) {
+        return false; //URI already exists
+    }
+    if (celix_stringHashMap_put(svc_tree->services, key, svc) != CELIX_SUCCESS) {
+        return false;
+    }
 
-            //If current node to delete is the root node, set new root node pointer
-            if(svc_tree->root_node == node) {
-                svc_tree->root_node = node->next;
-            }
+    service_tree_node_t *router = NULL;
+    if (buildRouter(svc_tree->services, &router) != CELIX_SUCCESS) {
+        celix_stringHashMap_remove(svc_tree->services, key);
+        return false;
+    }
+    publishRouter(svc_tree, router);
+    return true;
+}
 
-            //Set new previous pointer for the next node if present.
-            if(node->next != NULL) {
-                node->next->prev = node->prev;
-            }
+bool removeServiceNode(service_tree_t *svc_tree, const char *uri, void *svc) {
+    if (svc_tree == NULL || uri == NULL || svc_tree->services == NULL) {
+        return false;
+    }
 
-            //Set new next pointer if a previous is present
-            if(node->prev != NULL) {
-                node->prev->next = node->next;
-            }
+    celix_autofree char *key = normalizeUri(uri);
+    if (key == NULL || celix_stringHashMap_get(svc_tree->services, key) != svc) {
+        return false; //URI doesn't exist or is registered for another service
+    }
+    celix_stringHashMap_remove(svc_tree->services, key);
 
-            free(node->svc_data->sub_uri);
-            free(node->svc_data);
-            free(node);
-            (*tree_item_count)--;
-        }
+    service_tree_node_t *router = NULL;
+    if (buildRouter(svc_tree->services, &router) != CELIX_SUCCESS) {
+        //The current router still routes to the removed service and must be replaced, so publish an empty router.
+        //The router is rebuilt with all services on the next add or remove.
+        router = NULL;
     }
+    publishRouter(svc_tree, router);
+    return true;
 }
 
 void destroyServiceTree(service_tree_t *svc_tree) {
-    if(svc_tree != NULL) {
-        if(svc_tree->tree_node_count > 0 && svc_tree->root_node != NULL) {
-            service_tree_node_t *current = svc_tree->root_node;
-
-            while(current != NULL) {
-                destroyChildrenFromServiceNode(current, &svc_tree->tree_node_count, &svc_tree->tree_svc_count);
-
-                service_tree_node_t *next = current->next;
-                if(current->svc_data != NULL) {
-                    if(current->svc_data->service != NULL) svc_tree->tree_svc_count--;
-                    free(current->svc_data->sub_uri);
-                    free(current->svc_data);
-                }
-                free(current);
-
-                //Iterate to next node in similar level as root node
-                current = next;
-            }
-
-            svc_tree->tree_node_count = 0;
-            svc_tree->tree_svc_count = 0;
-            svc_tree->root_node = NULL;
-        }
+    if (svc_tree != NULL) {
+        publishRouter(svc_tree, NULL);
+        celix_stringHashMap_destroy(svc_tree->services);
+        svc_tree->services = NULL;
     }
 }
 
-
-service_tree_node_t *findServiceNodeInTree(service_tree_t *svc_tree, const char *uri) {
-    service_tree_node_t *found_node = NULL;
-    service_tree_node_t *current = NULL;
-    char *save_ptr; //Pointer used internally by strtok_r to point to next token
-    char *uri_cpy;
-    bool tree_not_empty = false;
-
-    if (svc_tree != NULL && uri != NULL) {
-        tree_not_empty = ((bool) (svc_tree->tree_svc_count | svc_tree->tree_node_count)
-                               & (svc_tree->root_node != NULL));
-        current = svc_tree->root_node;
+void *findServiceInTree(service_tree_t *svc_tree, const char *uri) {
+    if (svc_tree == NULL || uri == NULL) {
+        return NULL;
+    }
+    const service_tree_node_t *node = __atomic_load_n(&svc_tree->root_node, __ATOMIC_SEQ_CST);
+    if (node == NULL) {
+        return NULL;
     }
 
-    if (tree_not_empty) {
-        if(strcmp(current->svc_data->sub_uri, "root") == 0)
-        {
-            asprintf(&uri_cpy, "%s%s", "root", uri);
-        } else {
-            uri_cpy = strdup(uri);
+    //Return the service of the longest matching URI to comply with OSGI Http Whiteboard Specification,
+    //a service registered for "/" matches every URI.
+    void *found = node->service;
+    size_t len;
+    const char *segment = nextUriSegment(uri, &len);
+    while (len > 0 && node->children != NULL) {
+        node = findChildServiceNode(node, segment, len);
+        if (node == NULL) {
+            break;
         }
-
-        char *uri_token = strtok_r(uri_cpy, "/", &save_ptr);
-        //Check for horizontal matches for the first token
-        while (current != NULL) {
-            if (uri_token == NULL) {
-                current = NULL;
-            } else if (strcmp(current->svc_data->sub_uri, uri_token) == 0){
-                //Save current node to comply with OSGI Http Whiteboard Specification
-                if (current->svc_data->service != NULL) {
-                    found_node = current;
-                }
-                break; //Break out of while loop, keep 'current' pointer
-            } else {
-                current = current->next;
-            }
+        if (node->service != NULL) {
+            found = node->service;
         }
-
-        //Check also in vertical direction for the remaining tokens
-        if (current != NULL) {
-            uri_token = strtok_r(NULL, "/", &save_ptr);
-            if (uri_token != NULL && current->children != NULL){
-                current = current->children;
-                while (current != NULL) {
-                    //Match for current sub URI with URI token
-                    if (current->svc_data->sub_uri != NULL && strcmp(current->svc_data->sub_uri, uri_token) == 0) {
-                        //Save current node to comply with OSGI Http Whiteboard Specification
-                        if (current->svc_data->service != NULL) {
-                            found_node = current;
-                        }
-
-                        uri_token = strtok_r(NULL, "/", &save_ptr);
-                        if (uri_token != NULL && current->children != NULL) {
-                            current = current->children;
-                        }
-                        else {
-                            break; //Break out of while loop since URI token can still have a value
-                        }
-                    } else {
-                        current = current->next;
-                    }
-                }
-                //No more tokens left, save this node when a service is present
-            } else if (uri_token == NULL && current->svc_data->service != NULL) {
-                found_node = current;
-            }
-            //Else we haven't found a node that complies with the requested URI...
-        }
-
-        free(uri_cpy);
+        segment = nextUriSegment(segment + len, &len);
     }
-
-    return found_node;
+    return found;
 }
@@ -27,34 +27,84 @@
 #ifndef SERVICE_TREE_H
 #define SERVICE_TREE_H
 
-//Type declarations
-typedef struct service_tree_node service_tree_node_t;
+#include <stdbool.h>
 
-typedef struct service_node_data {
-    char *sub_uri;
-    void *service;
-} service_node_data_t;
+#include "celix_cleanup.h"
+#include "celix_compiler.h"
+#include "celix_string_hash_map.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-struct service_tree_node {
-    service_node_data_t *svc_data;
-    service_tree_node_t *next;
-    service_tree_node_t *prev;
-    service_tree_node_t *parent;
-    service_tree_node_t *children;
-};
+//Type declarations
+typedef struct service_tree_node service_tree_node_t; //Immutable router node, opaque
 
+/**
+ * URI tree of services, used to route a request URI to the service registered for the longest matching URI.
+ *
+ * The request URIs are routed with an immutable router: a tree of URI path segments with a hash table of the child
+ * segments per node. The router is rebuilt when a service is added or removed and published with an atomic pointer
+ * swap, so routing a request URI is lock-free and O(path segments).
+ * Readers enter the service tree (see serviceTreeReadGuard_init) before routing and leave it after the found service
+ * is used. A replaced router is only destroyed - and addServiceNode/removeServiceNode only return - if no reader
+ * that can still use the replaced router is in the service tree anymore.
+ *
+ * Adding and removing services must be serialized by the caller.
+ * A zero initialized service tree is an empty tree.
+ */
 typedef struct service_tree {
-    int tree_svc_count;             //Count for number of services in the tree (not number of nodes)
-    int tree_node_count;            //Count for number of nodes (tree_node_count != tree_svc_count)
-    service_tree_node_t *root_node; //Pointer to first item
+    celix_string_hash_map_t *services;  //Registered services with the normalized URI as key, used to rebuild the router
+    service_tree_node_t *root_node;     //Current router, NULL if empty. Swapped atomically.
+    unsigned int reader_epoch;          //Epoch of new readers, the lowest bit is the index in reader_count
+    unsigned int reader_count[2];       //Number of readers in the service tree per epoch index
 } service_tree_t;
 
+/**
+ * Read guard for a service tree, see serviceTreeReadGuard_init.
+ */
+typedef struct service_tree_read_guard {
+    service_tree_t *svc_tree;
+    unsigned int epoch_idx;
+} service_tree_read_guard_t;
+
 //Global function prototypes
 bool addServiceNode(service_tree_t *svc_tree, const char *uri, void *svc);
-void destroyChildrenFromServiceNode(service_tree_node_t *parent, int *tree_item_count, int *tree_svc_count);
-void destroyServiceNode(service_tree_t *svc_tree, service_tree_node_t *node, int *tree_item_count, int *tree_svc_count);
+bool removeServiceNode(service_tree_t *svc_tree, const char *uri, void *svc);
 void destroyServiceTree(service_tree_t *svc_tree);
-service_tree_node_t *findServiceNodeInTree(service_tree_t *svc_tree, const char *uri);
+
+/**
+ * Find the service registered for the longest URI matching the given request URI, or NULL if not found.
+ * Must be called with a service tree read guard and the returned service can only be used while the read guard exists.
+ */
+void *findServiceInTree(service_tree_t *svc_tree, const char *uri);
+
+/**
+ * Enter the service tree as reader. This is lock-free and does not block adding and removing services,
+ * but adding and removing services waits until the readers have left.
+ * This is intended to be used with celix_auto().
+ */
+static CELIX_UNUSED inline service_tree_read_guard_t serviceTreeReadGuard_init(service_tree_t *svc_tree) {
+    service_tree_read_guard_t guard;
+    guard.svc_tree = svc_tree;
+    guard.epoch_idx = __atomic_load_n(&svc_tree->reader_epoch, __ATOMIC_SEQ_CST) & 1;
+    __atomic_add_fetch(&svc_tree->reader_count[guard.epoch_idx], 1, __ATOMIC_SEQ_CST);
+    return guard;
+}
+
+/**
+ * Leave the service tree as reader.
+ */
+static CELIX_UNUSED inline void serviceTreeReadGuard_deinit(service_tree_read_guard_t *guard) {
+    if (guard->svc_tree) {
+        __atomic_sub_fetch(&guard->svc_tree->reader_count[guard->epoch_idx], 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+CELIX_DEFINE_AUTO_CLEANUP_CLEAR_FUNC(service_tree_read_guard_t, serviceTreeReadGuard_deinit)
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif //SERVICE_TREE_H
@@ -90,20 +90,14 @@ void websocket_admin_addWebsocketService(void *handle, void *svc, const celix_pr
     }
 }
 
-void websocket_admin_removeWebsocketService(void *handle, void *svc CELIX_UNUSED, const celix_properties_t *props) {
+void websocket_admin_removeWebsocketService(void *handle, void *svc, const celix_properties_t *props) {
     websocket_admin_manager_t *admin = (websocket_admin_manager_t *) handle;
 
     const char *uri = celix_properties_get(props, WEBSOCKET_ADMIN_URI, NULL);
 
     if(uri != NULL) {
         celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&(admin->admin_lock));
-        service_tree_node_t *node = NULL;
-
-        node = findServiceNodeInTree(&admin->sock_svc_tree, uri);
-
-        if(node != NULL){
-            destroyServiceNode(&admin->sock_svc_tree, node, &admin->sock_svc_tree.tree_node_count, &admin->sock_svc_tree.tree_svc_count);
-        } else {
+        if(!removeServiceNode(&admin->sock_svc_tree, uri, svc)) {
             printf("Couldn't remove websocket service with URI: %s, it doesn't exist\n", uri);
         }
 
@@ -117,15 +111,11 @@ int websocket_connect_handler(const struct mg_connection *connection, void *hand
     if(connection != NULL && handle != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         const char *req_uri = ri->request_uri;
-        service_tree_node_t *node = NULL;
-
-        celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
-        node = findServiceNodeInTree(&admin->sock_svc_tree, req_uri);
-
-        if(node != NULL) {
-            //Requested URI exists, now obtain the service and delegate the callback handle.
-            celix_websocket_service_t *sockSvc = (celix_websocket_service_t *) node->svc_data->service;
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&admin->sock_svc_tree);
+        celix_websocket_service_t *sockSvc = findServiceInTree(&admin->sock_svc_tree, req_uri);
 
+        if(sockSvc != NULL) {
+            //Requested URI exists, delegate the callback handle to the service.
             if(sockSvc->connect != NULL) {
                 result = sockSvc->connect(connection, sockSvc->handle);
             }
@@ -145,15 +135,11 @@ void websocket_ready_handler(struct mg_connection *connection, void *handle) {
     if(connection != NULL && handle != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         const char *req_uri = ri->request_uri;
-        service_tree_node_t *node = NULL;
-
-        celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
-        node = findServiceNodeInTree(&admin->sock_svc_tree, req_uri);
-
-        if(node != NULL) {
-            //Requested URI exists, now obtain the service and delegate the callback handle.
-            celix_websocket_service_t *sockSvc = (celix_websocket_service_t *) node->svc_data->service;
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&admin->sock_svc_tree);
+        celix_websocket_service_t *sockSvc = findServiceInTree(&admin->sock_svc_tree, req_uri);
 
+        if(sockSvc != NULL) {
+            //Requested URI exists, delegate the callback handle to the service.
             if(sockSvc->ready != NULL) {
                 sockSvc->ready(connection, sockSvc->handle);
             }
@@ -168,15 +154,11 @@ int websocket_data_handler(struct mg_connection *connection, int op_code, char *
     if(connection != NULL && handle != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         const char *req_uri = ri->request_uri;
-        service_tree_node_t *node = NULL;
-
-        celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
-        node = findServiceNodeInTree(&admin->sock_svc_tree, req_uri);
-
-        if(node != NULL) {
-            //Requested URI exists, now obtain the service and delegate the callback handle.
-            celix_websocket_service_t *sockSvc = (celix_websocket_service_t *) node->svc_data->service;
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&admin->sock_svc_tree);
+        celix_websocket_service_t *sockSvc = findServiceInTree(&admin->sock_svc_tree, req_uri);
 
+        if(sockSvc != NULL) {
+            //Requested URI exists, delegate the callback handle to the service.
             if(sockSvc->data != NULL) {
                 result = sockSvc->data(connection, op_code, data, length, sockSvc->handle);
             }
@@ -192,15 +174,11 @@ void websocket_close_handler(const struct mg_connection *connection, void *handl
     if (connection != NULL && handle != NULL) {
         const struct mg_request_info *ri = mg_get_request_info(connection);
         const char *req_uri = ri->request_uri;
-        service_tree_node_t *node = NULL;
-
-        celix_auto(celix_rwlock_rlock_guard_t) lock = celixRwlockRlockGuard_init(&(admin->admin_lock));
-        node = findServiceNodeInTree(&admin->sock_svc_tree, req_uri);
-
-        if(node != NULL) {
-            //Requested URI exists, now obtain the service and delegate the callback handle.
-            celix_websocket_service_t *sockSvc = (celix_websocket_service_t *) node->svc_data->service;
+        celix_auto(service_tree_read_guard_t) guard = serviceTreeReadGuard_init(&admin->sock_svc_tree);
+        celix_websocket_service_t *sockSvc = findServiceInTree(&admin->sock_svc_tree, req_uri);
 
+        if(sockSvc != NULL) {
+            //Requested URI exists, delegate the callback handle to the service.
             if (sockSvc->close != NULL) {
                 sockSvc->close(connection, sockSvc->handle);
             }
@@ -32,9 +32,41 @@
 
 #define HTTP_ADMIN_SERVICE_NAME "http_admin_service"
 
+/*
+ * Version of the HTTP service. The streaming request functions (doPostStream and doPutStream) are added in version
+ * 1.1.0 and are only used for services registered with a CELIX_FRAMEWORK_SERVICE_VERSION property of at least 1.1.0.
+ * For services without (or with an older) service version, only the functions up to doPatch are accessed.
+ */
+#define HTTP_ADMIN_SERVICE_VERSION "1.1.0"
+
 //Properties
 #define HTTP_ADMIN_URI          "uri"
 
+/*
+ * Request body of a streaming HTTP request (see doPostStream and doPutStream), used to read the request body in parts
+ * instead of receiving the complete request body in a single buffer.
+ */
+struct celix_http_request_body {
+    void *handle;
+
+    /*
+     * The length of the request body as specified in the Content-Length header or -1 if the length is not known in
+     * advance (e.g. for a request with chunked transfer-encoding).
+     */
+    long long contentLength;
+
+    /*
+     * Reads the next part of the request body in the given buffer. A chunked request body is decoded by the reader.
+     * Can be called repeatedly until the complete request body is read.
+     *
+     * Returns the number of bytes read (at most length), 0 if the complete request body is read or -1 if the
+     * request body could not be read, e.g. because the connection was closed before the complete body was received.
+     */
+    int (*read)(void *handle, void *buffer, size_t length);
+};
+
+typedef struct celix_http_request_body celix_http_request_body_t;
+
 struct celix_http_service {
     void *handle;
 
@@ -104,6 +136,26 @@ struct celix_http_service {
      */
     int (*doPatch)(void *handle, struct mg_connection *connection, const char *path, const char *data, size_t length);
 
+    /*
+     * Streaming implementation of POST HTTP request. The request body is not buffered by the HTTP admin, but can be
+     * read in parts with the given request body, so that large (or chunked) uploads can be processed with bounded
+     * memory. The request body is only valid during the call.
+     * If set, doPostStream is used instead of doPost.
+     * Only used if the service is registered with a service version of at least 1.1.0 (HTTP_ADMIN_SERVICE_VERSION).
+     *
+     * Returns HTTP status code.
+     */
+    int (*doPostStream)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+
+    /*
+     * Streaming implementation of PUT HTTP request, see doPostStream.
+     * If set, doPutStream is used instead of doPut.
+     * Only used if the service is registered with a service version of at least 1.1.0 (HTTP_ADMIN_SERVICE_VERSION).
+     *
+     * Returns HTTP status code.
+     */
+    int (*doPutStream)(void *handle, struct mg_connection *connection, const char *path, celix_http_request_body_t *body);
+
 };
 
 typedef struct celix_http_service celix_http_service_t;
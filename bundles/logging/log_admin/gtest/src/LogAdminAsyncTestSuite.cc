@@ -0,0 +1,360 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "celix_log_sink.h"
+#include "celix_log_control.h"
+#include "celix_bundle_context.h"
+#include "celix_framework_factory.h"
+#include "celix_log_service.h"
+#include "celix_shell_command.h"
+#include "celix_constants.h"
+#include "celix_log_binary.h"
+
+class LogAdminAsyncTestSuite : public ::testing::Test {
+public:
+    ~LogAdminAsyncTestSuite() override {
+        if (ctx != nullptr) {
+            celix_bundleContext_stopTracker(ctx, logSvcTrkId);
+            celix_bundleContext_stopTracker(ctx, controlTrkId);
+            celix_bundleContext_unregisterService(ctx, sinkSvcId);
+        }
+    }
+
+    void createFramework(long queueSize, bool binary = false, const char* binaryLogFile = nullptr) {
+        auto* properties = celix_properties_create();
+        celix_properties_set(properties, CELIX_FRAMEWORK_CACHE_DIR, ".cacheLogAdminAsyncTestSuite");
+        celix_properties_set(properties, "CELIX_LOG_ADMIN_ASYNC", "true");
+        celix_properties_setLong(properties, "CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE", queueSize);
+        celix_properties_setBool(properties, "CELIX_LOG_ADMIN_ASYNC_BINARY", binary);
+        if (binaryLogFile != nullptr) {
+            celix_properties_set(properties, "CELIX_LOG_ADMIN_BINARY_LOG_FILE", binaryLogFile);
+        }
+        auto* fwPtr = celix_frameworkFactory_createFramework(properties);
+        fw = std::shared_ptr<celix_framework_t>{fwPtr, [](celix_framework_t* f) {celix_frameworkFactory_destroyFramework(f);}};
+        ctx = celix_framework_getFrameworkContext(fwPtr);
+
+        bndId = celix_bundleContext_installBundle(ctx, LOG_ADMIN_BUNDLE, true);
+        ASSERT_GE(bndId, 0);
+
+        sink.handle = this;
+        sink.sinkLog = [](void* handle, celix_log_level_e /*level*/, long /*logServiceId*/, const char* logServiceName,
+                          const char* file, const char* function, int line, const char* format, va_list formatArgs) {
+            auto* self = static_cast<LogAdminAsyncTestSuite*>(handle);
+            char buf[2048];
+            vsnprintf(buf, sizeof(buf), format, formatArgs);
+            std::unique_lock<std::mutex> lock{self->mutex};
+            self->cond.wait(lock, [self]{ return !self->sinkBlocked; });
+            if (std::string{"test::Log1"} == logServiceName) {
+                self->messages.emplace_back(buf);
+                self->files.emplace_back(file == nullptr ? "" : file);
+                self->functionsSet.push_back(function != nullptr);
+                self->lines.push_back(line);
+                self->sinkThreads.push_back(std::this_thread::get_id());
+            }
+            self->cond.notify_all();
+        };
+        auto* svcProps = celix_properties_create();
+        celix_properties_set(svcProps, CELIX_LOG_SINK_PROPERTY_NAME, "test::Sink1");
+        celix_service_registration_options_t opts{};
+        opts.serviceName = CELIX_LOG_SINK_NAME;
+        opts.serviceVersion = CELIX_LOG_SINK_VERSION;
+        opts.properties = svcProps;
+        opts.svc = &sink;
+        sinkSvcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+        ASSERT_GE(sinkSvcId, 0);
+
+        {
+            celix_service_tracking_options_t trkOpts{};
+            trkOpts.filter.serviceName = CELIX_LOG_SERVICE_NAME;
+            trkOpts.filter.filter = "(name=test::Log1)";
+            trkOpts.callbackHandle = this;
+            trkOpts.set = [](void* handle, void* svc) {
+                static_cast<LogAdminAsyncTestSuite*>(handle)->logSvc.store(static_cast<celix_log_service_t*>(svc));
+            };
+            logSvcTrkId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+        }
+        {
+            celix_service_tracking_options_t trkOpts{};
+            trkOpts.filter.serviceName = CELIX_LOG_CONTROL_NAME;
+            trkOpts.filter.versionRange = "[1.2.0,2)";
+            trkOpts.callbackHandle = this;
+            trkOpts.set = [](void* handle, void* svc) {
+                static_cast<LogAdminAsyncTestSuite*>(handle)->control.store(static_cast<celix_log_control_t*>(svc));
+            };
+            controlTrkId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+        }
+        celix_framework_waitForEmptyEventQueue(fwPtr);
+        ASSERT_NE(nullptr, logSvc.load());
+        ASSERT_NE(nullptr, control.load());
+    }
+
+    bool waitForMessages(size_t count) {
+        std::unique_lock<std::mutex> lock{mutex};
+        return cond.wait_for(lock, std::chrono::seconds{10}, [&]{ return messages.size() >= count; });
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    celix_bundle_context_t* ctx{nullptr};
+    long bndId{-1};
+    long sinkSvcId{-1};
+    long logSvcTrkId{-1};
+    long controlTrkId{-1};
+    celix_log_sink_t sink{};
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    std::atomic<celix_log_control_t*> control{nullptr};
+
+    std::mutex mutex{}; //protects below
+    std::condition_variable cond{};
+    bool sinkBlocked{false};
+    std::vector<std::string> messages{};
+    std::vector<std::string> files{};
+    std::vector<bool> functionsSet{};
+    std::vector<int> lines{};
+    std::vector<std::thread::id> sinkThreads{};
+};
+
+TEST_F(LogAdminAsyncTestSuite, LogToSinkFromWriterThreadTest) {
+    createFramework(1024);
+    auto* ls = logSvc.load();
+    auto* ctrl = control.load();
+
+    ls->info(ls->handle, "test %i %s", 1, "async");
+    ls->debug(ls->handle, "not active"); //not an active log level
+    ctrl->setDetailed(ctrl->handle, "test::Log1", true);
+    ls->logDetails(ls->handle, CELIX_LOG_LEVEL_ERROR, __FILE__, __FUNCTION__, __LINE__, "detailed %i", 2);
+    ctrl->setDetailed(ctrl->handle, "test::Log1", false);
+    ls->logDetails(ls->handle, CELIX_LOG_LEVEL_ERROR, __FILE__, __FUNCTION__, __LINE__, "brief %i", 3);
+
+    ASSERT_TRUE(waitForMessages(3));
+    std::lock_guard<std::mutex> lock{mutex};
+    ASSERT_EQ(3, messages.size());
+    EXPECT_EQ("test 1 async", messages[0]);
+    EXPECT_EQ("detailed 2", messages[1]);
+    EXPECT_EQ(__FILE__, files[1]);
+    EXPECT_TRUE(functionsSet[1]);
+    EXPECT_GT(lines[1], 0);
+    EXPECT_EQ("brief 3", messages[2]);
+    EXPECT_EQ("", files[2]);
+    EXPECT_FALSE(functionsSet[2]);
+    EXPECT_EQ(0, lines[2]);
+    for (auto& id : sinkThreads) {
+        EXPECT_NE(std::this_thread::get_id(), id);
+    }
+    EXPECT_EQ(0, ctrl->nrOfDroppedLogs(ctrl->handle, nullptr));
+}
+
+TEST_F(LogAdminAsyncTestSuite, LongLogMessageIsTruncatedTest) {
+    createFramework(1024);
+    auto* ls = logSvc.load();
+
+    std::string longMessage(4096, 'x');
+    ls->info(ls->handle, "%s", longMessage.c_str());
+
+    ASSERT_TRUE(waitForMessages(1));
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_LT(messages[0].size(), 1024);
+    EXPECT_EQ(0, longMessage.compare(0, messages[0].size(), messages[0]));
+}
+
+TEST_F(LogAdminAsyncTestSuite, DropLogsIfQueueIsFullTest) {
+    createFramework(2);
+    auto* ls = logSvc.load();
+    auto* ctrl = control.load();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sinkBlocked = true;
+    }
+    constexpr int nrOfLogs = 16;
+    for (int i = 0; i < nrOfLogs; ++i) {
+        ls->info(ls->handle, "test %i", i);
+    }
+    //at most 1 log in the blocked sink and 2 in the queue
+    size_t dropped = ctrl->nrOfDroppedLogs(ctrl->handle, nullptr);
+    EXPECT_GE(dropped, nrOfLogs - 3);
+    EXPECT_EQ(dropped, ctrl->nrOfDroppedLogs(ctrl->handle, "test::"));
+    EXPECT_EQ(0, ctrl->nrOfDroppedLogs(ctrl->handle, "celix_framework"));
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sinkBlocked = false;
+        cond.notify_all();
+    }
+    ASSERT_TRUE(waitForMessages(nrOfLogs - dropped));
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_EQ(nrOfLogs - dropped, messages.size());
+    EXPECT_EQ("test 0", messages[0]); //the oldest logs are kept
+}
+
+TEST_F(LogAdminAsyncTestSuite, ConcurrentLoggingTest) {
+    createFramework(1024);
+    auto* ls = logSvc.load();
+    auto* ctrl = control.load();
+
+    constexpr int nrOfThreads = 4;
+    constexpr int nrOfLogsPerThread = 200;
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < nrOfThreads; ++t) {
+        threads.emplace_back([ls, t] {
+            for (int i = 0; i < nrOfLogsPerThread; ++i) {
+                ls->info(ls->handle, "thread %i log %i", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t expected = nrOfThreads * nrOfLogsPerThread - ctrl->nrOfDroppedLogs(ctrl->handle, nullptr);
+    ASSERT_TRUE(waitForMessages(expected));
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_EQ(expected, messages.size());
+}
+
+TEST_F(LogAdminAsyncTestSuite, QueuedLogsAreWrittenWhenStoppingTest) {
+    createFramework(1024);
+    auto* ls = logSvc.load();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sinkBlocked = true;
+    }
+    for (int i = 0; i < 10; ++i) {
+        ls->info(ls->handle, "test %i", i);
+    }
+    std::thread unblock{[this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        std::lock_guard<std::mutex> lock{mutex};
+        sinkBlocked = false;
+        cond.notify_all();
+    }};
+    celix_bundleContext_stopBundle(ctx, bndId);
+    unblock.join();
+
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_EQ(10, messages.size());
+}
+
+TEST_F(LogAdminAsyncTestSuite, LoggingWhileStoppingTest) {
+    createFramework(1024 * 16);
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> loggedBeforeStop{0};
+    std::vector<std::thread> producers{};
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([this, &stopping, &loggedBeforeStop] {
+            celix_service_use_options_t opts{};
+            opts.filter.serviceName = CELIX_LOG_SERVICE_NAME;
+            opts.filter.filter = "(name=test::Log1)";
+            opts.callbackHandle = &stopping;
+            opts.use = [](void* handle, void* svc) {
+                auto* ls = static_cast<celix_log_service_t*>(svc);
+                ls->info(ls->handle, "test %s", static_cast<std::atomic<bool>*>(handle)->load() ? "stopping" : "active");
+            };
+            //the log service is in use during the log call, so the log admin is stopped while log calls are in flight
+            for (int i = 0; i < 2048; ++i) {
+                bool wasStopping = stopping.load();
+                if (!celix_bundleContext_useServiceWithOptions(ctx, &opts)) {
+                    break;
+                }
+                if (!wasStopping) {
+                    loggedBeforeStop++;
+                }
+            }
+        });
+    }
+    ASSERT_TRUE(waitForMessages(100));
+    stopping = true;
+    celix_bundleContext_stopBundle(ctx, bndId);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    //the log calls which pushed to the queue before the writer thread was stopped, are written to the sink
+    std::lock_guard<std::mutex> lock{mutex};
+    EXPECT_GE(messages.size(), loggedBeforeStop.load());
+}
+
+TEST_F(LogAdminAsyncTestSuite, LogAdminCmdTest) {
+    createFramework(1024);
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = CELIX_SHELL_COMMAND_SERVICE_NAME;
+    opts.filter.filter = "(command.name=celix::log_admin)";
+    opts.use = [](void*, void *svc) {
+        auto* cmd = static_cast<celix_shell_command_t*>(svc);
+        char *cmdResult = nullptr;
+        size_t cmdResultLen;
+        FILE *ss = open_memstream(&cmdResult, &cmdResultLen);
+        cmd->executeCommand(cmd->handle, "celix::log_admin", ss, ss); //overview
+        fclose(ss);
+        EXPECT_TRUE(strstr(cmdResult, "Log Admin logs asynchronously with a queue size of 1024, 0 log messages are dropped") != nullptr) << cmdResult;
+        EXPECT_TRUE(strstr(cmdResult, "test::Log1, active log level info, detailed, 0 dropped") != nullptr) << cmdResult;
+        free(cmdResult);
+    };
+    EXPECT_TRUE(celix_bundleContext_useServiceWithOptions(ctx, &opts));
+}
+
+TEST_F(LogAdminAsyncTestSuite, BinaryLoggingTest) {
+    const char* binaryLogFile = ".LogAdminAsyncTestSuite.clog";
+    remove(binaryLogFile);
+    createFramework(1024, true, binaryLogFile);
+    auto* ls = logSvc.load();
+
+    ls->info(ls->handle, "binary %i %s %.2f", 1, "test", 3.14159);
+    ls->info(ls->handle, "unsupported %m"); //logged as formatted log message
+    ASSERT_TRUE(waitForMessages(2));
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        EXPECT_EQ("binary 1 test 3.14", messages[0]);
+        EXPECT_EQ(0, messages[1].find("unsupported "));
+    }
+    celix_bundleContext_stopBundle(ctx, bndId); //closes the binary log file
+
+    FILE* file = fopen(binaryLogFile, "rb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(0, celix_logBinary_readFileHeader(file));
+    char* buffer = nullptr;
+    size_t bufferSize = 0;
+    celix_log_record_t record{};
+    std::vector<std::string> fileMessages{};
+    while (celix_logBinary_readRecord(file, &buffer, &bufferSize, &record) > 0) {
+        if (std::string{"test::Log1"} != record.logServiceName) {
+            continue;
+        }
+        if (record.message == nullptr) {
+            char out[128];
+            EXPECT_TRUE(celix_logBinary_format(record.binaryMessage, record.binaryMessageSize, out, sizeof(out)));
+            fileMessages.emplace_back(out);
+        } else {
+            fileMessages.emplace_back(record.message);
+        }
+    }
+    free(buffer);
+    fclose(file);
+    ASSERT_EQ(2, fileMessages.size());
+    EXPECT_EQ("binary 1 test 3.14", fileMessages[0]);
+    EXPECT_EQ(0, fileMessages[1].find("unsupported "));
+}
@@ -0,0 +1,157 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "celix_log_sink.h"
+#include "celix_log_control.h"
+#include "celix_log_service.h"
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_framework_factory.h"
+
+/**
+ * Benchmark for the log throughput of the log admin.
+ *
+ * Every iteration state.range(1) threads log NR_OF_LOGS_PER_THREAD log messages concurrently to a log sink, which
+ * formats the log message and is busy for state.range(2) ns per log message to simulate a slow log sink (e.g. syslog).
+ * state.range(0) selects synchronous (0), asynchronous (1) or asynchronous binary (2) logging. With asynchronous logging
+ * the measured time is the time spent by the logging threads, the log messages which do not fit in the log queue are
+ * dropped and counted. With asynchronous binary logging the log messages are formatted by the log writer thread.
+ */
+static constexpr int NR_OF_LOGS_PER_THREAD = 256;
+
+class CelixLogAdminBenchmark {
+public:
+    CelixLogAdminBenchmark(long mode, long sinkDelayInNs) : sinkDelay{sinkDelayInNs} {
+        auto* config = celix_properties_create();
+        celix_properties_set(config, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(config, CELIX_FRAMEWORK_CACHE_DIR, ".log_admin_benchmark_cache");
+        celix_properties_setBool(config, "CELIX_LOG_ADMIN_ASYNC", mode != 0);
+        celix_properties_setBool(config, "CELIX_LOG_ADMIN_ASYNC_BINARY", mode == 2);
+        fw = celix_frameworkFactory_createFramework(config);
+        ctx = celix_framework_getFrameworkContext(fw);
+        celix_bundleContext_installBundle(ctx, LOG_ADMIN_BUNDLE, true);
+
+        sink.handle = this;
+        sink.sinkLog = [](void* handle, celix_log_level_e, long, const char*, const char*, const char*, int,
+                          const char* format, va_list formatArgs) {
+            auto* benchmark = static_cast<CelixLogAdminBenchmark*>(handle);
+            char buf[512];
+            vsnprintf(buf, sizeof(buf), format, formatArgs);
+            benchmark::DoNotOptimize(buf);
+            if (benchmark->sinkDelay.count() > 0) {
+                auto end = std::chrono::steady_clock::now() + benchmark->sinkDelay;
+                while (std::chrono::steady_clock::now() < end) {
+                    //busy
+                }
+            }
+            benchmark->sunkLogs.fetch_add(1, std::memory_order_relaxed);
+        };
+        auto* props = celix_properties_create();
+        celix_properties_set(props, CELIX_LOG_SINK_PROPERTY_NAME, "benchmark");
+        celix_service_registration_options_t opts{};
+        opts.serviceName = CELIX_LOG_SINK_NAME;
+        opts.serviceVersion = CELIX_LOG_SINK_VERSION;
+        opts.properties = props;
+        opts.svc = &sink;
+        sinkSvcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+
+        celix_service_tracking_options_t trkOpts{};
+        trkOpts.filter.serviceName = CELIX_LOG_SERVICE_NAME;
+        trkOpts.filter.filter = "(name=benchmark)";
+        trkOpts.callbackHandle = this;
+        trkOpts.set = [](void* handle, void* svc) {
+            static_cast<CelixLogAdminBenchmark*>(handle)->logSvc.store(static_cast<celix_log_service_t*>(svc));
+        };
+        logSvcTrkId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+
+        trkOpts.filter.serviceName = CELIX_LOG_CONTROL_NAME;
+        trkOpts.filter.filter = nullptr;
+        trkOpts.filter.versionRange = "[1.2.0,2)";
+        trkOpts.set = [](void* handle, void* svc) {
+            static_cast<CelixLogAdminBenchmark*>(handle)->control.store(static_cast<celix_log_control_t*>(svc));
+        };
+        controlTrkId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+        celix_framework_waitForEmptyEventQueue(fw);
+    }
+
+    ~CelixLogAdminBenchmark() noexcept {
+        celix_bundleContext_stopTracker(ctx, controlTrkId);
+        celix_bundleContext_stopTracker(ctx, logSvcTrkId);
+        celix_bundleContext_unregisterService(ctx, sinkSvcId);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    CelixLogAdminBenchmark(const CelixLogAdminBenchmark&) = delete;
+    CelixLogAdminBenchmark& operator=(const CelixLogAdminBenchmark&) = delete;
+
+    celix_framework_t* fw{};
+    celix_bundle_context_t* ctx{};
+    std::chrono::nanoseconds sinkDelay;
+    celix_log_sink_t sink{};
+    long sinkSvcId{-1};
+    long logSvcTrkId{-1};
+    long controlTrkId{-1};
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    std::atomic<celix_log_control_t*> control{nullptr};
+    std::atomic<long> sunkLogs{0};
+};
+
+static void LogAdmin_Log(benchmark::State& state) {
+    CelixLogAdminBenchmark benchmark{(long)state.range(0), (long)state.range(2)};
+    auto nrOfThreads = (int)state.range(1);
+    celix_log_service_t* ls = benchmark.logSvc.load();
+    celix_log_control_t* control = benchmark.control.load();
+    if (ls == nullptr || control == nullptr) {
+        state.SkipWithError("log service or log control not available");
+        return;
+    }
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads{};
+        threads.reserve(nrOfThreads);
+        for (int t = 0; t < nrOfThreads; ++t) {
+            threads.emplace_back([ls, t] {
+                for (int i = 0; i < NR_OF_LOGS_PER_THREAD; ++i) {
+                    ls->info(ls->handle, "benchmark thread %i, log %i with value %f", t, i, 3.14);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    long total = (long)state.iterations() * nrOfThreads * NR_OF_LOGS_PER_THREAD;
+    auto dropped = (long)control->nrOfDroppedLogs(control->handle, "benchmark");
+    state.SetItemsProcessed(total);
+    state.counters["dropped"] = (double)dropped;
+    state.counters["dropped_ratio"] = total == 0 ? 0.0 : (double)dropped / (double)total;
+}
+
+BENCHMARK(LogAdmin_Log)
+    ->ArgsProduct({{0, 1, 2}, {1, 4}, {0, 2000}})
+    ->ArgNames({"mode", "threads", "sink_delay_ns"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
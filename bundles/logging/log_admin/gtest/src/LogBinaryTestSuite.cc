@@ -0,0 +1,280 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "celix_log_binary.h"
+#include "celix_log_queue.h"
+
+class LogBinaryTestSuite : public ::testing::Test {
+public:
+    static int encode(std::vector<char>& buffer, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        int size = celix_logBinary_encode(buffer.data(), buffer.size(), format, args);
+        va_end(args);
+        return size;
+    }
+
+    static std::string expected(const char* format, ...) {
+        char buf[1024];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        return buf;
+    }
+
+    static std::string format(const std::vector<char>& buffer, int size) {
+        char out[1024];
+        EXPECT_TRUE(celix_logBinary_format(buffer.data(), (size_t)size, out, sizeof(out)));
+        return out;
+    }
+
+    static bool push(celix_log_queue_t* queue, bool binary, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        bool pushed = celix_logQueue_vpush(queue, binary, CELIX_LOG_LEVEL_INFO, 42, "test", "file.c", "func", 7, format, args);
+        va_end(args);
+        return pushed;
+    }
+};
+
+#define EXPECT_ROUNDTRIP(...)                                                                                          \
+    do {                                                                                                               \
+        std::vector<char> buffer(1024);                                                                                \
+        int size = encode(buffer, __VA_ARGS__);                                                                        \
+        ASSERT_GT(size, 0);                                                                                            \
+        EXPECT_EQ(expected(__VA_ARGS__), format(buffer, size));                                                        \
+    } while (0)
+
+TEST_F(LogBinaryTestSuite, EncodeAndFormatTest) {
+    EXPECT_ROUNDTRIP("no arguments");
+    EXPECT_ROUNDTRIP("100%% literal");
+    EXPECT_ROUNDTRIP("int %i %d %u %x %X %o %c", -1, 2, 3u, 0xabu, 0xcdu, 8u, 'c');
+    EXPECT_ROUNDTRIP("short %hd %hhu", (short)-12, (unsigned char)250);
+    EXPECT_ROUNDTRIP("long %li %lu %lld %llu %qd", -1L, 2UL, -3LL, 4ULL, 5LL);
+    EXPECT_ROUNDTRIP("sizes %zu %zd %td %jd %ju", (size_t)1, (ssize_t)-2, (ptrdiff_t)-3, (intmax_t)-4, (uintmax_t)5);
+    EXPECT_ROUNDTRIP("double %f %.3e %g %a %10.2F %lf", 3.14, -2.5e10, 0.0001, 1.0, 42.0, 1.5);
+    EXPECT_ROUNDTRIP("long double %Lf %Lg", (long double)1.25, (long double)-3.5);
+    EXPECT_ROUNDTRIP("string '%s' '%10s' '%-10s|' '%.3s'", "abc", "right", "left", "truncated");
+    EXPECT_ROUNDTRIP("pointer %p", (void*)0x1234);
+    EXPECT_ROUNDTRIP("flags %+d % d %05d %-5d| %#x", 1, 2, 3, 4, 0xffu);
+    EXPECT_ROUNDTRIP("star %*d %-*d| %.*f %*.*s", 5, 1, 4, 2, 2, 3.14159, 8, 2, "abcdef");
+}
+
+TEST_F(LogBinaryTestSuite, EncodeStringWithPrecisionIsNotReadBeyondPrecisionTest) {
+    const char notTerminated[3] = {'a', 'b', 'c'};
+    std::vector<char> buffer(128);
+    int size = encode(buffer, "%.3s %.*s", notTerminated, 2, notTerminated);
+    ASSERT_GT(size, 0);
+    EXPECT_EQ("abc ab", format(buffer, size));
+}
+
+TEST_F(LogBinaryTestSuite, EncodeNullStringTest) {
+    const char* nullStr = nullptr;
+    std::vector<char> buffer(128);
+    int size = encode(buffer, "%s", nullStr);
+    ASSERT_GT(size, 0);
+    char expectedNull[32];
+    snprintf(expectedNull, sizeof(expectedNull), "%s", "(null)");
+    EXPECT_EQ(expectedNull, format(buffer, size));
+}
+
+TEST_F(LogBinaryTestSuite, EncodeUnsupportedFormatTest) {
+    std::vector<char> buffer(128);
+    int n;
+    EXPECT_EQ(-1, encode(buffer, "positional %1$d", 1));
+    EXPECT_EQ(-1, encode(buffer, "count %n", &n));
+    EXPECT_EQ(-1, encode(buffer, "errno %m"));
+    EXPECT_EQ(-1, encode(buffer, "wide %ls", L"wide"));
+    EXPECT_EQ(-1, encode(buffer, "unknown %y"));
+    EXPECT_EQ(-1, encode(buffer, "incomplete %"));
+}
+
+TEST_F(LogBinaryTestSuite, EncodeInTooSmallBufferTest) {
+    std::vector<char> buffer(16);
+    EXPECT_EQ(-1, encode(buffer, "a too long format string"));
+    EXPECT_EQ(-1, encode(buffer, "%s", "a too long string argument"));
+    EXPECT_GT(encode(buffer, "%i", 1), 0);
+}
+
+TEST_F(LogBinaryTestSuite, FormatTruncatesOutputTest) {
+    std::vector<char> buffer(128);
+    int size = encode(buffer, "%s and %i", "a long string", 42);
+    ASSERT_GT(size, 0);
+    char out[8];
+    EXPECT_TRUE(celix_logBinary_format(buffer.data(), (size_t)size, out, sizeof(out)));
+    EXPECT_STREQ("a long ", out);
+    EXPECT_TRUE(celix_logBinary_format(buffer.data(), (size_t)size, out, 0));
+}
+
+TEST_F(LogBinaryTestSuite, FormatInvalidBinaryMessageTest) {
+    std::vector<char> buffer(128);
+    int size = encode(buffer, "%i %s", 1, "abc");
+    ASSERT_GT(size, 0);
+    char out[128];
+    for (int i = 0; i < size; ++i) {
+        EXPECT_FALSE(celix_logBinary_format(buffer.data(), (size_t)i, out, sizeof(out))) << "size " << i;
+    }
+    EXPECT_FALSE(celix_logBinary_format(buffer.data(), (size_t)size + 1, out, sizeof(out))); //trailing data
+
+    //argument type does not match the format string
+    buffer[4] = 'f';
+    EXPECT_FALSE(celix_logBinary_format(buffer.data(), (size_t)size, out, sizeof(out)));
+}
+
+TEST_F(LogBinaryTestSuite, BinaryLogFileTest) {
+    FILE* file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(0, celix_logBinary_writeFileHeader(file));
+
+    std::vector<char> buffer(128);
+    int size = encode(buffer, "binary %i %s", 1, "message");
+    ASSERT_GT(size, 0);
+    celix_log_record_t record{};
+    record.level = CELIX_LOG_LEVEL_WARNING;
+    record.logServiceId = 42;
+    record.logServiceName = "test::Log";
+    record.file = "file.c";
+    record.function = "func";
+    record.line = 7;
+    record.timestamp.tv_sec = 1000;
+    record.timestamp.tv_nsec = 5;
+    record.binaryMessage = buffer.data();
+    record.binaryMessageSize = (size_t)size;
+    EXPECT_EQ(0, celix_logBinary_writeRecord(file, &record));
+
+    celix_log_record_t briefRecord{};
+    briefRecord.level = CELIX_LOG_LEVEL_ERROR;
+    briefRecord.logServiceName = "test::Log";
+    briefRecord.message = "formatted message";
+    EXPECT_EQ(0, celix_logBinary_writeRecord(file, &briefRecord));
+    rewind(file);
+
+    char* readBuffer = nullptr;
+    size_t readBufferSize = 0;
+    celix_log_record_t read{};
+    EXPECT_EQ(0, celix_logBinary_readFileHeader(file));
+    ASSERT_EQ(1, celix_logBinary_readRecord(file, &readBuffer, &readBufferSize, &read));
+    EXPECT_EQ(CELIX_LOG_LEVEL_WARNING, read.level);
+    EXPECT_EQ(42, read.logServiceId);
+    EXPECT_STREQ("test::Log", read.logServiceName);
+    EXPECT_STREQ("file.c", read.file);
+    EXPECT_STREQ("func", read.function);
+    EXPECT_EQ(7, read.line);
+    EXPECT_EQ(1000, read.timestamp.tv_sec);
+    EXPECT_EQ(5, read.timestamp.tv_nsec);
+    EXPECT_EQ(nullptr, read.message);
+    char out[128];
+    ASSERT_TRUE(celix_logBinary_format(read.binaryMessage, read.binaryMessageSize, out, sizeof(out)));
+    EXPECT_STREQ("binary 1 message", out);
+
+    ASSERT_EQ(1, celix_logBinary_readRecord(file, &readBuffer, &readBufferSize, &read));
+    EXPECT_EQ(CELIX_LOG_LEVEL_ERROR, read.level);
+    EXPECT_EQ(nullptr, read.file);
+    EXPECT_EQ(nullptr, read.function);
+    EXPECT_STREQ("formatted message", read.message);
+    EXPECT_EQ(nullptr, read.binaryMessage);
+
+    EXPECT_EQ(0, celix_logBinary_readRecord(file, &readBuffer, &readBufferSize, &read));
+    free(readBuffer);
+    fclose(file);
+}
+
+TEST_F(LogBinaryTestSuite, ReadInvalidBinaryLogFileTest) {
+    FILE* file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    fputs("NOTALOG!", file);
+    rewind(file);
+    EXPECT_EQ(-1, celix_logBinary_readFileHeader(file));
+    fclose(file);
+
+    //truncated record
+    file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    celix_log_record_t record{};
+    record.logServiceName = "test::Log";
+    record.message = "message";
+    EXPECT_EQ(0, celix_logBinary_writeRecord(file, &record));
+    long size = ftell(file);
+    rewind(file);
+    std::vector<char> content((size_t)size);
+    ASSERT_EQ(content.size(), fread(content.data(), 1, content.size(), file));
+    fclose(file);
+
+    file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    fwrite(content.data(), 1, content.size() - 1, file);
+    rewind(file);
+    char* readBuffer = nullptr;
+    size_t readBufferSize = 0;
+    EXPECT_EQ(-1, celix_logBinary_readRecord(file, &readBuffer, &readBufferSize, &record));
+    free(readBuffer);
+    fclose(file);
+}
+
+TEST_F(LogBinaryTestSuite, QueueBinaryLogRecordTest) {
+    celix_log_queue_t* queue = celix_logQueue_create(4, 256);
+    ASSERT_NE(nullptr, queue);
+
+    EXPECT_TRUE(push(queue, true, "binary %i %s", 1, "message"));
+    EXPECT_TRUE(push(queue, true, "errno %m")); //not supported, falls back to a formatted log message
+    EXPECT_TRUE(push(queue, false, "formatted %i", 2));
+    std::string longString(512, 'x');
+    EXPECT_TRUE(push(queue, true, "%s", longString.c_str())); //does not fit, falls back to a truncated log message
+
+    struct Context {
+        std::vector<bool> binary{};
+        std::vector<std::string> messages{};
+    } context{};
+    size_t count = celix_logQueue_pop(queue, 10, &context, [](void* handle, const celix_log_record_t* record) {
+        auto* ctx = static_cast<Context*>(handle);
+        EXPECT_EQ(42, record->logServiceId);
+        EXPECT_STREQ("test", record->logServiceName);
+        EXPECT_GT(record->timestamp.tv_sec, 0);
+        if (record->message == nullptr) {
+            char out[256];
+            EXPECT_TRUE(celix_logBinary_format(record->binaryMessage, record->binaryMessageSize, out, sizeof(out)));
+            ctx->binary.push_back(true);
+            ctx->messages.emplace_back(out);
+        } else {
+            ctx->binary.push_back(false);
+            ctx->messages.emplace_back(record->message);
+        }
+    });
+    ASSERT_EQ(4, count);
+    EXPECT_TRUE(context.binary[0]);
+    EXPECT_EQ("binary 1 message", context.messages[0]);
+    EXPECT_FALSE(context.binary[1]);
+    EXPECT_EQ(0, context.messages[1].find("errno "));
+    EXPECT_FALSE(context.binary[2]);
+    EXPECT_EQ("formatted 2", context.messages[2]);
+    EXPECT_FALSE(context.binary[3]);
+    EXPECT_EQ(0, longString.compare(0, context.messages[3].size(), context.messages[3]));
+
+    celix_logQueue_destroy(queue);
+}
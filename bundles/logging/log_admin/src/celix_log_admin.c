@@ -19,6 +19,7 @@
 
 #include "celix_log_admin.h"
 
+#include <errno.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
@@ -33,6 +34,8 @@
 #include "celix_utils.h"
 #include "celix_log_utils.h"
 #include "celix_log_constants.h"
+#include "celix_log_binary.h"
+#include "celix_log_queue.h"
 #include "celix_shell_command.h"
 #include "celix_threads.h"
 #include "hash_map.h"
@@ -40,6 +43,8 @@
 
 #define CELIX_LOG_ADMIN_DEFAULT_LOG_NAME "default"
 #define CELIX_LOG_ADMIN_FRAMEWORK_LOG_NAME "celix_framework"
+#define CELIX_LOG_ADMIN_WRITER_BATCH_SIZE 64
+#define CELIX_LOG_ADMIN_WRITER_WAIT_TIME_IN_SECONDS 1.0
 
 struct celix_log_admin {
     celix_bundle_context_t* ctx;
@@ -56,6 +61,16 @@ struct celix_log_admin {
     celix_shell_command_t cmdSvc;
     long cmdSvcId;
 
+    celix_log_queue_t* queue; //NULL if the async mode is disabled
+    celix_thread_t writerThread;
+    bool writerActive; //accessed atomically
+    size_t nrOfAsyncProducers; //accessed atomically, the number of log calls which can still push to the queue
+    bool binaryLogging; //read-only, whether log messages are queued as binary log messages
+    FILE* binaryLogFile; //only used by the writer thread, NULL if no binary log file is configured
+    char* formatBuffer; //only used by the writer thread, for formatting binary log messages
+    size_t formatBufferSize;
+    size_t nrOfDroppedLogs; //accessed atomically, including the dropped logs of removed log services
+
     celix_thread_rwlock_t lock; //protects below
     hash_map_t *loggers; //key = name, value = celix_log_service_instance_t
     hash_map_t* sinks; //key = name, value = celix_log_sink_t
@@ -67,6 +82,7 @@ typedef struct celix_log_service_entry {
     char *name;
     long logSvcId;
     celix_log_service_t logSvc;
+    size_t nrOfDroppedLogs; //accessed atomically
 
     //mutable and protected by admin->lock
     celix_log_level_e activeLogLevel;
@@ -82,6 +98,25 @@ typedef struct celix_log_sink_entry {
     bool enabled;
 } celix_log_sink_entry_t;
 
+static void celix_logAdmin_vlogDetailsAsync(celix_log_service_entry_t* entry, celix_log_level_e level, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
+    celixThreadRwlock_readLock(&entry->admin->lock);
+    bool active = level >= entry->activeLogLevel;
+    bool detailed = entry->detailed;
+    celixThreadRwlock_unlock(&entry->admin->lock);
+    if (!active) {
+        return;
+    }
+
+    //note entry->name and entry->logSvcId do not change during the lifetime of the log service
+    bool queued = celix_logQueue_vpush(entry->admin->queue, entry->admin->binaryLogging, level, entry->logSvcId,
+                                       entry->name, detailed ? file : NULL, detailed ? function : NULL, detailed ? line : 0,
+                                       format, formatArgs);
+    if (!queued) {
+        __atomic_fetch_add(&entry->nrOfDroppedLogs, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&entry->admin->nrOfDroppedLogs, 1, __ATOMIC_RELAXED);
+    }
+}
+
 static void celix_logAdmin_vlogDetails(void *handle, celix_log_level_e level, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
     celix_log_service_entry_t* entry = handle;
 
@@ -90,6 +125,23 @@ static void celix_logAdmin_vlogDetails(void *handle, celix_log_level_e level, co
         return;
     }
 
+    if (entry->admin->queue != NULL) {
+        //enter before checking writerActive, so that destroy can wait for the log calls which push to the queue
+        __atomic_fetch_add(&entry->admin->nrOfAsyncProducers, 1, __ATOMIC_SEQ_CST);
+        bool async = __atomic_load_n(&entry->admin->writerActive, __ATOMIC_SEQ_CST);
+        if (async) {
+            celix_logAdmin_vlogDetailsAsync(entry, level, file, function, line, format, formatArgs);
+        }
+        if (__atomic_sub_fetch(&entry->admin->nrOfAsyncProducers, 1, __ATOMIC_SEQ_CST) == 0 &&
+            !__atomic_load_n(&entry->admin->writerActive, __ATOMIC_SEQ_CST)) {
+            //the writer thread is stopping and waits for the last log call which can push to the queue
+            celix_logQueue_wakeup(entry->admin->queue);
+        }
+        if (async) {
+            return;
+        }
+    }
+
     celixThreadRwlock_readLock(&entry->admin->lock);
     if (level >= entry->activeLogLevel) {
         int nrOfLogWriters = hashMap_size(entry->admin->sinks);
@@ -178,6 +230,99 @@ static void celix_logAdmin_fatal(void *handle, const char *format, ...) {
     va_end(args);
 }
 
+static void celix_logAdmin_sinkLog(celix_log_sink_t* sink, const celix_log_record_t* record, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    sink->sinkLog(sink->handle, record->level, record->logServiceId, record->logServiceName,
+                  record->file, record->function, record->line, format, args);
+    va_end(args);
+}
+
+/**
+ * Returns the formatted log message of a log record, a binary log message is formatted on demand.
+ */
+static const char* celix_logAdmin_recordMessage(celix_log_admin_t* admin, const celix_log_record_t* record) {
+    if (record->message != NULL) {
+        return record->message;
+    }
+    if (!celix_logBinary_format(record->binaryMessage, record->binaryMessageSize, admin->formatBuffer, admin->formatBufferSize)) {
+        return "<invalid binary log message>";
+    }
+    return admin->formatBuffer;
+}
+
+static void celix_logAdmin_writeRecordToBinaryLogFile(celix_log_admin_t* admin, const celix_log_record_t* record) {
+    if (celix_logBinary_writeRecord(admin->binaryLogFile, record) != 0) {
+        celix_logUtils_logToStdout(CELIX_LOG_ADMIN_DEFAULT_LOG_NAME, CELIX_LOG_LEVEL_ERROR,
+                                   "Cannot write to binary log file: %s. Closing binary log file.", strerror(errno));
+        fclose(admin->binaryLogFile);
+        admin->binaryLogFile = NULL;
+    }
+}
+
+/**
+ * Forwards a log record popped from the async log queue to the binary log file and the enabled sinks.
+ * Called with the admin read lock.
+ */
+static void celix_logAdmin_writeRecord(void* handle, const celix_log_record_t* record) {
+    celix_log_admin_t* admin = handle;
+    int nrOfLogWriters = hashMap_size(admin->sinks);
+    const char* message = NULL; //formatted lazily, only if needed
+    if (admin->binaryLogFile != NULL) {
+        nrOfLogWriters += 1;
+        celix_logAdmin_writeRecordToBinaryLogFile(admin, record);
+    }
+
+    hash_map_iterator_t iter = hashMapIterator_construct(admin->sinks);
+    while (hashMapIterator_hasNext(&iter)) {
+        celix_log_sink_entry_t *sinkEntry = hashMapIterator_nextValue(&iter);
+        if (sinkEntry->enabled) {
+            message = message == NULL ? celix_logAdmin_recordMessage(admin, record) : message;
+            celix_logAdmin_sinkLog(sinkEntry->sink, record, "%s", message);
+        }
+    }
+
+    if (admin->alwaysLogToStdOut || (nrOfLogWriters == 0 && admin->fallbackToStdOut)) {
+        message = message == NULL ? celix_logAdmin_recordMessage(admin, record) : message;
+        celix_logUtils_logToStdoutDetails(record->logServiceName, record->level, record->file, record->function,
+                                          record->line, "%s", message);
+    }
+}
+
+/**
+ * Forwards at most CELIX_LOG_ADMIN_WRITER_BATCH_SIZE log records to the sinks.
+ * @return The number of forwarded log records.
+ */
+static size_t celix_logAdmin_writeRecords(celix_log_admin_t* admin) {
+    celixThreadRwlock_readLock(&admin->lock);
+    size_t count = celix_logQueue_pop(admin->queue, CELIX_LOG_ADMIN_WRITER_BATCH_SIZE, admin, celix_logAdmin_writeRecord);
+    celixThreadRwlock_unlock(&admin->lock);
+    if (count > 0 && admin->binaryLogFile != NULL) {
+        fflush(admin->binaryLogFile);
+    }
+    return count;
+}
+
+static void* celix_logAdmin_writerThread(void* data) {
+    celix_log_admin_t* admin = data;
+    while (__atomic_load_n(&admin->writerActive, __ATOMIC_ACQUIRE)) {
+        if (celix_logAdmin_writeRecords(admin) == 0) {
+            celix_logQueue_waitForRecords(admin->queue, CELIX_LOG_ADMIN_WRITER_WAIT_TIME_IN_SECONDS);
+        }
+    }
+    //wait for the log calls which are still pushing to the queue, the last one wakes up the writer thread
+    while (__atomic_load_n(&admin->nrOfAsyncProducers, __ATOMIC_SEQ_CST) > 0) {
+        if (celix_logAdmin_writeRecords(admin) == 0) {
+            celix_logQueue_waitForRecords(admin->queue, CELIX_LOG_ADMIN_WRITER_WAIT_TIME_IN_SECONDS);
+        }
+    }
+    //drain the log records which are queued before the writer thread is stopped
+    while (celix_logAdmin_writeRecords(admin) > 0) {
+        //nop
+    }
+    return NULL;
+}
+
 static void celix_logAdmin_frameworkLogFunction(void* handle, celix_log_level_e level, const char* file, const char *function, int line, const char *format, va_list formatArgs) {
     celix_log_service_entry_t* entry = handle;
     //note for now igoring func & line
@@ -507,6 +652,26 @@ static bool celix_logAdmin_logServiceInfo(void *handle, const char* logServiceNa
     return celix_logAdmin_logServiceInfoEx(handle, logServiceName, outActiveLogLevel, NULL);
 }
 
+static size_t celix_logAdmin_nrOfDroppedLogs(void *handle, const char* select) {
+    celix_log_admin_t* admin = handle;
+    if (select == NULL) {
+        return __atomic_load_n(&admin->nrOfDroppedLogs, __ATOMIC_RELAXED);
+    }
+    size_t count = 0;
+    celixThreadRwlock_readLock(&admin->lock);
+    hash_map_iterator_t iter = hashMapIterator_construct(admin->loggers);
+    while (hashMapIterator_hasNext(&iter)) {
+        celix_log_service_entry_t *visit = hashMapIterator_nextValue(&iter);
+        char *match = strcasestr(visit->name, select);
+        if (match != NULL && match == visit->name) {
+            //note if select is found in visit->name and visit->name start with select
+            count += __atomic_load_n(&visit->nrOfDroppedLogs, __ATOMIC_RELAXED);
+        }
+    }
+    celixThreadRwlock_unlock(&admin->lock);
+    return count;
+}
+
 static void celix_logAdmin_setLogLevelCmd(celix_log_admin_t* admin, const char* select, const char* level, FILE* outStream, FILE* errorStream) {
     bool converted;
     celix_log_level_e logLevel = celix_logUtils_logLevelFromStringWithCheck(level, CELIX_LOG_LEVEL_TRACE, &converted);
@@ -542,13 +707,22 @@ static void celix_logAdmin_InfoCmd(celix_log_admin_t* admin, FILE* outStream, FI
     celix_arrayList_sort(logServices);
     celix_arrayList_sort(sinks);
 
+    if (admin->queue != NULL) {
+        fprintf(outStream, "Log Admin logs asynchronously%s with a queue size of %zu, %zu log messages are dropped\n",
+                admin->binaryLogging ? " (binary)" : "", celix_logQueue_capacity(admin->queue),
+                celix_logAdmin_nrOfDroppedLogs(admin, NULL));
+    }
     fprintf(outStream, "Log Admin provided log services:\n");
     for (int i = 0 ; i < celix_arrayList_size(logServices); ++i) {
         const char *name = celix_arrayList_getString(logServices, i);
         celix_log_level_e level;
         bool detailed;
         bool found = celix_logAdmin_logServiceInfoEx(admin, name, &level, &detailed);
-        if (found) {
+        if (found && admin->queue != NULL) {
+            fprintf(outStream, " |- %i) Log Service %20s, active log level %s, %s, %zu dropped\n",
+                    i+1, name, celix_logUtils_logLevelToString(level), detailed ? "detailed" : "brief",
+                    celix_logAdmin_nrOfDroppedLogs(admin, name));
+        } else if (found) {
             fprintf(outStream, " |- %i) Log Service %20s, active log level %s, %s\n",
                     i+1, name, celix_logUtils_logLevelToString(level), detailed ? "detailed" : "brief");
         }
@@ -642,6 +816,26 @@ static bool celix_logAdmin_executeCommand(void *handle, const char *commandLine,
     return true;
 }
 
+/**
+ * Opens the configured binary log file in append mode. A new binary log file starts with the binary log file magic.
+ */
+static void celix_logAdmin_openBinaryLogFile(celix_log_admin_t* admin) {
+    const char* path = celix_bundleContext_getProperty(admin->ctx, CELIX_LOG_ADMIN_BINARY_LOG_FILE_CONFIG_NAME, NULL);
+    if (celix_utils_isStringNullOrEmpty(path)) {
+        return;
+    }
+    admin->binaryLogFile = fopen(path, "ab");
+    if (admin->binaryLogFile != NULL && fseek(admin->binaryLogFile, 0, SEEK_END) == 0 &&
+        ftell(admin->binaryLogFile) == 0 && celix_logBinary_writeFileHeader(admin->binaryLogFile) != 0) {
+        fclose(admin->binaryLogFile);
+        admin->binaryLogFile = NULL;
+    }
+    if (admin->binaryLogFile == NULL) {
+        celix_logUtils_logToStdout(CELIX_LOG_ADMIN_DEFAULT_LOG_NAME, CELIX_LOG_LEVEL_ERROR,
+                                   "Cannot open binary log file %s: %s", path, strerror(errno));
+    }
+}
+
 celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
     celix_log_admin_t* admin = calloc(1, sizeof(*admin));
     admin->ctx = ctx;
@@ -656,6 +850,40 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
 
     celixThreadRwlock_create(&admin->lock, NULL);
 
+    if (celix_bundleContext_getPropertyAsBool(ctx, CELIX_LOG_ADMIN_ASYNC_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_DEFAULT_VALUE)) {
+        long queueSize = celix_bundleContext_getPropertyAsLong(ctx, CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE_DEFAULT_VALUE);
+        long maxLogSize = celix_bundleContext_getPropertyAsLong(ctx, CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE_DEFAULT_VALUE);
+        admin->queue = queueSize > 0 && maxLogSize > 0 ? celix_logQueue_create((size_t)queueSize, (size_t)maxLogSize) : NULL;
+        admin->binaryLogging = celix_bundleContext_getPropertyAsBool(ctx, CELIX_LOG_ADMIN_ASYNC_BINARY_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_BINARY_DEFAULT_VALUE);
+        if (admin->queue != NULL && admin->binaryLogging) {
+            admin->formatBufferSize = (size_t)maxLogSize;
+            admin->formatBuffer = malloc(admin->formatBufferSize);
+        }
+        if (admin->queue != NULL && (!admin->binaryLogging || admin->formatBuffer != NULL)) {
+            celix_logAdmin_openBinaryLogFile(admin);
+            admin->writerActive = true;
+            if (celixThread_create(&admin->writerThread, NULL, celix_logAdmin_writerThread, admin) == CELIX_SUCCESS) {
+                celixThread_setName(&admin->writerThread, "CelixLogAdmin");
+            } else {
+                admin->writerActive = false;
+            }
+        }
+        if (!admin->writerActive) {
+            celix_logQueue_destroy(admin->queue);
+            admin->queue = NULL;
+            admin->binaryLogging = false;
+            free(admin->formatBuffer);
+            admin->formatBuffer = NULL;
+            if (admin->binaryLogFile != NULL) {
+                fclose(admin->binaryLogFile);
+                admin->binaryLogFile = NULL;
+            }
+            celix_logUtils_logToStdout(CELIX_LOG_ADMIN_DEFAULT_LOG_NAME, CELIX_LOG_LEVEL_ERROR,
+                                       "Cannot create async log queue with size %li and max log size %li, logging synchronously.",
+                                       queueSize, maxLogSize);
+        }
+    }
+
     {
         celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
         opts.filter.serviceName = CELIX_LOG_SINK_NAME;
@@ -680,6 +908,7 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
         admin->controlSvc.setSinkEnabled = celix_logAdmin_setSinkEnabled;
         admin->controlSvc.setDetailed = celix_logAdmin_setDetailed;
         admin->controlSvc.logServiceInfoEx = celix_logAdmin_logServiceInfoEx;
+        admin->controlSvc.nrOfDroppedLogs = celix_logAdmin_nrOfDroppedLogs;
 
         celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
         opts.serviceName = CELIX_LOG_CONTROL_NAME;
@@ -719,6 +948,14 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
 
 void celix_logAdmin_destroy(celix_log_admin_t *admin) {
     if (admin != NULL) {
+        if (admin->queue != NULL) {
+            //log synchronously from now on and forward the queued log records, while the log sinks are still available
+            //note the writer thread waits for the log calls which are still pushing to the queue and drains their records
+            __atomic_store_n(&admin->writerActive, false, __ATOMIC_SEQ_CST);
+            celix_logQueue_wakeup(admin->queue);
+            celixThread_join(admin->writerThread, NULL);
+        }
+
         celix_logAdmin_remLogSvcForName(admin, CELIX_LOG_ADMIN_FRAMEWORK_LOG_NAME);
 
         celix_bundleContext_unregisterServiceAsync(admin->ctx, admin->cmdSvcId, NULL, NULL);
@@ -733,6 +970,11 @@ void celix_logAdmin_destroy(celix_log_admin_t *admin) {
         assert(hashMap_size(admin->sinks) == 0); //note stopping service tracker should triggered all needed remove events
         hashMap_destroy(admin->sinks, false, false);
 
+        celix_logQueue_destroy(admin->queue);
+        if (admin->binaryLogFile != NULL) {
+            fclose(admin->binaryLogFile);
+        }
+        free(admin->formatBuffer);
         celixThreadRwlock_destroy(&admin->lock);
         free(admin);
     }
@@ -36,6 +36,20 @@ extern "C" {
 #define CELIX_LOG_ADMIN_LOG_SINKS_DEFAULT_ENABLED_CONFIG_NAME               "CELIX_LOG_ADMIN_LOG_SINKS_DEFAULT_ENABLED"
 #define CELIX_LOG_ADMIN_SINKS_DEFAULT_ENABLED_DEFAULT_VALUE                 true
 
+#define CELIX_LOG_ADMIN_ASYNC_CONFIG_NAME                                   "CELIX_LOG_ADMIN_ASYNC"
+#define CELIX_LOG_ADMIN_ASYNC_DEFAULT_VALUE                                 false
+
+#define CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE_CONFIG_NAME                        "CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE"
+#define CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE_DEFAULT_VALUE                      1024
+
+#define CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE_CONFIG_NAME                      "CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE"
+#define CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE_DEFAULT_VALUE                    1024
+
+#define CELIX_LOG_ADMIN_ASYNC_BINARY_CONFIG_NAME                            "CELIX_LOG_ADMIN_ASYNC_BINARY"
+#define CELIX_LOG_ADMIN_ASYNC_BINARY_DEFAULT_VALUE                          false
+
+#define CELIX_LOG_ADMIN_BINARY_LOG_FILE_CONFIG_NAME                         "CELIX_LOG_ADMIN_BINARY_LOG_FILE"
+
 /**
  * Celix log service admin will monitoring celix log service and create celix log services on
  * demand. For every unique requested celix log service name, a new log service istance will be
@@ -56,6 +70,18 @@ extern "C" {
  *
  * When requesting this service a name can be used in the service filter. If the name is present,
  * a logging instance for that name will be created.
+ *
+ * If CELIX_LOG_ADMIN_ASYNC config/env is set to true (default false), log statements are formatted on the caller
+ * thread into a lock-free queue of CELIX_LOG_ADMIN_ASYNC_QUEUE_SIZE (default 1024) entries of at most
+ * CELIX_LOG_ADMIN_ASYNC_MAX_LOG_SIZE (default 1024) bytes, and forwarded to the log sinks and stdout/stderr by a
+ * log writer thread. If the queue is full, the log statement is dropped and counted.
+ *
+ * If additionally CELIX_LOG_ADMIN_ASYNC_BINARY is set to true (default false), log statements are not formatted on the
+ * caller thread, but the format string and the raw format arguments are queued as binary log message. The log writer
+ * thread only formats a binary log message if it is forwarded to a log sink or stdout/stderr.
+ * If CELIX_LOG_ADMIN_BINARY_LOG_FILE is set (and CELIX_LOG_ADMIN_ASYNC is true), the log writer thread appends all log
+ * records - as-is - to the configured binary log file, which can be rendered with the celix_log_decoder tool.
+ * The binary log file counts as log sink for the CELIX_LOG_ADMIN_FALLBACK_TO_STDOUT config.
  */
 typedef struct celix_log_admin celix_log_admin_t; //opaque
 
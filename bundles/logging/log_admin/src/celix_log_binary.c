@@ -0,0 +1,607 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "celix_log_binary.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CELIX_LOG_BINARY_MAX_SPEC_LENGTH 32
+#define CELIX_LOG_BINARY_MAX_RECORD_SIZE (16 * 1024 * 1024)
+
+#define CELIX_LOG_BINARY_RECORD_FLAG_BINARY 0x01
+#define CELIX_LOG_BINARY_RECORD_FLAG_FILE 0x02
+#define CELIX_LOG_BINARY_RECORD_FLAG_FUNCTION 0x04
+
+/**
+ * The type tags of the arguments in a binary log message. Every argument is stored as a type tag followed by the
+ * argument value in host representation, a string is stored as a uint32_t length followed by the '\0' terminated
+ * string.
+ */
+typedef enum celix_log_binary_arg_type {
+    CELIX_LOG_BINARY_ARG_NONE = 0, //"%%"
+    CELIX_LOG_BINARY_ARG_INT = 1,
+    CELIX_LOG_BINARY_ARG_LONG = 2,
+    CELIX_LOG_BINARY_ARG_LONG_LONG = 3,
+    CELIX_LOG_BINARY_ARG_INTMAX = 4,
+    CELIX_LOG_BINARY_ARG_SIZE = 5,
+    CELIX_LOG_BINARY_ARG_PTRDIFF = 6,
+    CELIX_LOG_BINARY_ARG_DOUBLE = 7,
+    CELIX_LOG_BINARY_ARG_LONG_DOUBLE = 8,
+    CELIX_LOG_BINARY_ARG_STRING = 9,
+    CELIX_LOG_BINARY_ARG_NULL_STRING = 10,
+    CELIX_LOG_BINARY_ARG_POINTER = 11,
+} celix_log_binary_arg_type_e;
+
+/**
+ * A parsed printf conversion specification.
+ */
+typedef struct celix_log_binary_spec {
+    char spec[CELIX_LOG_BINARY_MAX_SPEC_LENGTH + 1]; //'\0' terminated copy of the conversion specification
+    size_t length; //length of the conversion specification in the format string
+    int nrOfStars; //number of '*' width and precision arguments
+    bool starPrecision;
+    int precision; //-1 if not specified (or specified with '*')
+    celix_log_binary_arg_type_e type;
+} celix_log_binary_spec_t;
+
+/**
+ * The fixed size header of a record in a binary log file, followed by the '\0' terminated log service name, file and
+ * function and the (binary) log message.
+ */
+typedef struct celix_log_binary_record_header {
+    uint32_t size; //size of the record after the header
+    int32_t line;
+    int64_t logServiceId;
+    int64_t seconds;
+    int64_t nanoseconds;
+    uint8_t level;
+    uint8_t flags;
+    uint16_t reserved1;
+    uint32_t reserved2;
+} celix_log_binary_record_header_t;
+
+/**
+ * Parses the conversion specification starting at format, which points to a '%'.
+ * @return true if the conversion specification is supported.
+ */
+static bool celix_logBinary_parseSpec(const char* format, celix_log_binary_spec_t* spec) {
+    const char* p = format + 1;
+    spec->nrOfStars = 0;
+    spec->starPrecision = false;
+    spec->precision = -1;
+
+    if (*p == '%') {
+        spec->type = CELIX_LOG_BINARY_ARG_NONE;
+        spec->length = 2;
+        return true;
+    }
+
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        ++p;
+    }
+    if (*p == '*') {
+        spec->nrOfStars += 1;
+        ++p;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+    if (*p == '$') {
+        return false; //positional arguments
+    }
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            spec->nrOfStars += 1;
+            spec->starPrecision = true;
+            ++p;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                if (spec->precision < 100000) {
+                    spec->precision = spec->precision * 10 + (*p - '0');
+                }
+                ++p;
+            }
+        }
+    }
+
+    enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_BIG_L } len = LEN_NONE;
+    if (p[0] == 'h' && p[1] == 'h') {
+        len = LEN_HH;
+        p += 2;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        len = LEN_LL;
+        p += 2;
+    } else if (*p == 'h') {
+        len = LEN_H;
+        ++p;
+    } else if (*p == 'l') {
+        len = LEN_L;
+        ++p;
+    } else if (*p == 'q') {
+        len = LEN_LL;
+        ++p;
+    } else if (*p == 'j') {
+        len = LEN_J;
+        ++p;
+    } else if (*p == 'z' || *p == 'Z') {
+        len = LEN_Z;
+        ++p;
+    } else if (*p == 't') {
+        len = LEN_T;
+        ++p;
+    } else if (*p == 'L') {
+        len = LEN_BIG_L;
+        ++p;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+        switch (len) {
+        case LEN_NONE:
+        case LEN_HH:
+        case LEN_H:
+            spec->type = CELIX_LOG_BINARY_ARG_INT;
+            break;
+        case LEN_L:
+            spec->type = CELIX_LOG_BINARY_ARG_LONG;
+            break;
+        case LEN_LL:
+            spec->type = CELIX_LOG_BINARY_ARG_LONG_LONG;
+            break;
+        case LEN_J:
+            spec->type = CELIX_LOG_BINARY_ARG_INTMAX;
+            break;
+        case LEN_Z:
+            spec->type = CELIX_LOG_BINARY_ARG_SIZE;
+            break;
+        case LEN_T:
+            spec->type = CELIX_LOG_BINARY_ARG_PTRDIFF;
+            break;
+        default:
+            return false;
+        }
+        break;
+    case 'c':
+        if (len != LEN_NONE) {
+            return false; //wide character
+        }
+        spec->type = CELIX_LOG_BINARY_ARG_INT;
+        break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        if (len == LEN_BIG_L) {
+            spec->type = CELIX_LOG_BINARY_ARG_LONG_DOUBLE;
+        } else if (len == LEN_NONE || len == LEN_L) {
+            spec->type = CELIX_LOG_BINARY_ARG_DOUBLE;
+        } else {
+            return false;
+        }
+        break;
+    case 's':
+        if (len != LEN_NONE) {
+            return false; //wide string
+        }
+        spec->type = CELIX_LOG_BINARY_ARG_STRING;
+        break;
+    case 'p':
+        if (len != LEN_NONE) {
+            return false;
+        }
+        spec->type = CELIX_LOG_BINARY_ARG_POINTER;
+        break;
+    default:
+        return false; //%n, %m, wide characters and unknown conversions
+    }
+
+    spec->length = (size_t)(p + 1 - format);
+    if (spec->length > CELIX_LOG_BINARY_MAX_SPEC_LENGTH) {
+        return false;
+    }
+    memcpy(spec->spec, format, spec->length);
+    spec->spec[spec->length] = '\0';
+    return true;
+}
+
+static bool celix_logBinary_write(char* buffer, size_t size, size_t* pos, const void* data, size_t dataSize) {
+    if (dataSize > size - *pos) {
+        return false;
+    }
+    memcpy(buffer + *pos, data, dataSize);
+    *pos += dataSize;
+    return true;
+}
+
+static bool celix_logBinary_writeArg(char* buffer, size_t size, size_t* pos, celix_log_binary_arg_type_e type, const void* value, size_t valueSize) {
+    uint8_t tag = (uint8_t)type;
+    return celix_logBinary_write(buffer, size, pos, &tag, sizeof(tag)) &&
+           celix_logBinary_write(buffer, size, pos, value, valueSize);
+}
+
+static bool celix_logBinary_encodeArg(char* buffer, size_t size, size_t* pos, const celix_log_binary_spec_t* spec, int starPrecision, va_list* args) {
+    switch (spec->type) {
+    case CELIX_LOG_BINARY_ARG_INT: {
+        int val = va_arg(*args, int);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_LONG: {
+        long val = va_arg(*args, long);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_LONG_LONG: {
+        long long val = va_arg(*args, long long);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_INTMAX: {
+        intmax_t val = va_arg(*args, intmax_t);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_SIZE: {
+        size_t val = va_arg(*args, size_t);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_PTRDIFF: {
+        ptrdiff_t val = va_arg(*args, ptrdiff_t);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_DOUBLE: {
+        double val = va_arg(*args, double);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_LONG_DOUBLE: {
+        long double val = va_arg(*args, long double);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_POINTER: {
+        void* val = va_arg(*args, void*);
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &val, sizeof(val));
+    }
+    case CELIX_LOG_BINARY_ARG_STRING: {
+        const char* str = va_arg(*args, const char*);
+        if (str == NULL) {
+            uint8_t tag = CELIX_LOG_BINARY_ARG_NULL_STRING;
+            return celix_logBinary_write(buffer, size, pos, &tag, sizeof(tag));
+        }
+        //with a precision the string does not need to be '\0' terminated
+        int precision = spec->starPrecision ? starPrecision : spec->precision;
+        size_t len = precision >= 0 ? strnlen(str, (size_t)precision) : strlen(str);
+        if (len > UINT32_MAX) {
+            return false;
+        }
+        uint32_t len32 = (uint32_t)len;
+        char nul = '\0';
+        return celix_logBinary_writeArg(buffer, size, pos, spec->type, &len32, sizeof(len32)) &&
+               celix_logBinary_write(buffer, size, pos, str, len) &&
+               celix_logBinary_write(buffer, size, pos, &nul, sizeof(nul));
+    }
+    default:
+        return false;
+    }
+}
+
+int celix_logBinary_encode(void* buffer, size_t size, const char* format, va_list formatArgs) {
+    va_list args;
+    va_copy(args, formatArgs);
+    char* buf = buffer;
+    size_t pos = 0;
+    bool ok = format != NULL && celix_logBinary_write(buf, size, &pos, format, strlen(format) + 1);
+    for (const char* p = format; ok && (p = strchr(p, '%')) != NULL; ) {
+        celix_log_binary_spec_t spec;
+        ok = celix_logBinary_parseSpec(p, &spec);
+        int starPrecision = -1;
+        for (int i = 0; ok && i < spec.nrOfStars; ++i) {
+            int val = va_arg(args, int);
+            starPrecision = val;
+            ok = celix_logBinary_writeArg(buf, size, &pos, CELIX_LOG_BINARY_ARG_INT, &val, sizeof(val));
+        }
+        if (ok && spec.type != CELIX_LOG_BINARY_ARG_NONE) {
+            ok = celix_logBinary_encodeArg(buf, size, &pos, &spec, starPrecision, &args);
+        }
+        if (ok) {
+            p += spec.length;
+        }
+    }
+    va_end(args);
+    return ok && pos <= INT32_MAX ? (int)pos : -1;
+}
+
+/**
+ * Reads the next argument of a binary log message.
+ * @return a pointer to the argument value or NULL if the next argument does not have the expected type.
+ */
+static const char* celix_logBinary_readArg(const char* msg, size_t size, size_t* pos, celix_log_binary_arg_type_e type, size_t valueSize) {
+    if (*pos >= size || (uint8_t)msg[*pos] != (uint8_t)type || valueSize > size - *pos - 1) {
+        return NULL;
+    }
+    const char* value = msg + *pos + 1;
+    *pos += 1 + valueSize;
+    return value;
+}
+
+#define CELIX_LOG_BINARY_READ_VALUE(type, cType)                                                                       \
+    cType val;                                                                                                         \
+    const char* valPtr = celix_logBinary_readArg(msg, size, &pos, type, sizeof(val));                                  \
+    if (valPtr == NULL) {                                                                                              \
+        return false;                                                                                                  \
+    }                                                                                                                  \
+    memcpy(&val, valPtr, sizeof(val))
+
+#define CELIX_LOG_BINARY_PRINT(val)                                                                                    \
+    (spec.nrOfStars == 0   ? snprintf(out + outPos, outSize - outPos, spec.spec, val)                                  \
+     : spec.nrOfStars == 1 ? snprintf(out + outPos, outSize - outPos, spec.spec, stars[0], val)                        \
+                           : snprintf(out + outPos, outSize - outPos, spec.spec, stars[0], stars[1], val))
+
+bool celix_logBinary_format(const void* binaryMessage, size_t size, char* out, size_t outSize) {
+    char dummy;
+    if (outSize == 0) {
+        out = &dummy;
+        outSize = 1;
+    }
+    out[0] = '\0';
+    const char* msg = binaryMessage;
+    const char* fmtEnd = msg == NULL ? NULL : memchr(msg, '\0', size);
+    if (fmtEnd == NULL) {
+        return false;
+    }
+    size_t pos = (size_t)(fmtEnd - msg) + 1;
+    size_t outPos = 0; //invariant: outPos < outSize
+
+    const char* p = msg;
+    while (*p != '\0') {
+        const char* next = strchr(p, '%');
+        size_t literalLen = next == NULL ? strlen(p) : (size_t)(next - p);
+        size_t copyLen = literalLen < outSize - outPos - 1 ? literalLen : outSize - outPos - 1;
+        memcpy(out + outPos, p, copyLen);
+        outPos += copyLen;
+        out[outPos] = '\0';
+        if (next == NULL) {
+            break;
+        }
+        p = next;
+
+        celix_log_binary_spec_t spec;
+        if (!celix_logBinary_parseSpec(p, &spec)) {
+            return false;
+        }
+        p += spec.length;
+        if (spec.type == CELIX_LOG_BINARY_ARG_NONE) {
+            if (outPos < outSize - 1) {
+                out[outPos++] = '%';
+                out[outPos] = '\0';
+            }
+            continue;
+        }
+
+        int stars[2] = {0, 0};
+        for (int i = 0; i < spec.nrOfStars; ++i) {
+            CELIX_LOG_BINARY_READ_VALUE(CELIX_LOG_BINARY_ARG_INT, int);
+            stars[i] = val;
+        }
+
+        int written;
+        switch (spec.type) {
+        case CELIX_LOG_BINARY_ARG_INT: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, int);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_LONG: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, long);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_LONG_LONG: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, long long);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_INTMAX: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, intmax_t);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_SIZE: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, size_t);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_PTRDIFF: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, ptrdiff_t);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_DOUBLE: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, double);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_LONG_DOUBLE: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, long double);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_POINTER: {
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, void*);
+            written = CELIX_LOG_BINARY_PRINT(val);
+            break;
+        }
+        case CELIX_LOG_BINARY_ARG_STRING: {
+            if (pos < size && (uint8_t)msg[pos] == CELIX_LOG_BINARY_ARG_NULL_STRING) {
+                pos += 1;
+                const char* val = NULL;
+                written = CELIX_LOG_BINARY_PRINT(val);
+                break;
+            }
+            CELIX_LOG_BINARY_READ_VALUE(spec.type, uint32_t);
+            if (val >= size - pos || msg[pos + val] != '\0') {
+                return false;
+            }
+            const char* str = msg + pos;
+            pos += val + 1;
+            written = CELIX_LOG_BINARY_PRINT(str);
+            break;
+        }
+        default:
+            return false;
+        }
+        if (written < 0) {
+            return false;
+        }
+        outPos = (size_t)written < outSize - outPos ? outPos + (size_t)written : outSize - 1;
+    }
+    return pos == size;
+}
+
+int celix_logBinary_writeFileHeader(FILE* stream) {
+    return fwrite(CELIX_LOG_BINARY_FILE_MAGIC, 1, strlen(CELIX_LOG_BINARY_FILE_MAGIC), stream) ==
+                   strlen(CELIX_LOG_BINARY_FILE_MAGIC)
+               ? 0
+               : -1;
+}
+
+int celix_logBinary_readFileHeader(FILE* stream) {
+    char magic[sizeof(CELIX_LOG_BINARY_FILE_MAGIC)] = {0};
+    size_t len = strlen(CELIX_LOG_BINARY_FILE_MAGIC);
+    if (fread(magic, 1, len, stream) != len || memcmp(magic, CELIX_LOG_BINARY_FILE_MAGIC, len) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int celix_logBinary_writeRecord(FILE* stream, const celix_log_record_t* record) {
+    const char* name = record->logServiceName == NULL ? "" : record->logServiceName;
+    bool binary = record->message == NULL;
+    size_t nameSize = strlen(name) + 1;
+    size_t fileSize = record->file == NULL ? 0 : strlen(record->file) + 1;
+    size_t functionSize = record->function == NULL ? 0 : strlen(record->function) + 1;
+    size_t messageSize = binary ? record->binaryMessageSize : strlen(record->message) + 1;
+    size_t recordSize = nameSize + fileSize + functionSize + messageSize;
+    if (recordSize > CELIX_LOG_BINARY_MAX_RECORD_SIZE) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    celix_log_binary_record_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.size = (uint32_t)recordSize;
+    header.line = record->line;
+    header.logServiceId = record->logServiceId;
+    header.seconds = record->timestamp.tv_sec;
+    header.nanoseconds = record->timestamp.tv_nsec;
+    header.level = (uint8_t)record->level;
+    header.flags = (binary ? CELIX_LOG_BINARY_RECORD_FLAG_BINARY : 0) |
+                   (record->file != NULL ? CELIX_LOG_BINARY_RECORD_FLAG_FILE : 0) |
+                   (record->function != NULL ? CELIX_LOG_BINARY_RECORD_FLAG_FUNCTION : 0);
+
+    bool ok = fwrite(&header, sizeof(header), 1, stream) == 1 && fwrite(name, 1, nameSize, stream) == nameSize &&
+              (fileSize == 0 || fwrite(record->file, 1, fileSize, stream) == fileSize) &&
+              (functionSize == 0 || fwrite(record->function, 1, functionSize, stream) == functionSize) &&
+              (messageSize == 0 ||
+               fwrite(binary ? record->binaryMessage : record->message, 1, messageSize, stream) == messageSize);
+    return ok ? 0 : -1;
+}
+
+/**
+ * Returns the '\0' terminated string at *pos and moves pos past the string or returns NULL if there is no '\0'
+ * terminated string at *pos.
+ */
+static const char* celix_logBinary_readString(const char* buffer, size_t size, size_t* pos) {
+    const char* end = *pos < size ? memchr(buffer + *pos, '\0', size - *pos) : NULL;
+    if (end == NULL) {
+        return NULL;
+    }
+    const char* str = buffer + *pos;
+    *pos = (size_t)(end - buffer) + 1;
+    return str;
+}
+
+int celix_logBinary_readRecord(FILE* stream, char** buffer, size_t* bufferSize, celix_log_record_t* record) {
+    celix_log_binary_record_header_t header;
+    size_t n = fread(&header, 1, sizeof(header), stream);
+    if (n == 0 && feof(stream)) {
+        return 0;
+    } else if (n != sizeof(header) || header.size > CELIX_LOG_BINARY_MAX_RECORD_SIZE ||
+               header.level > CELIX_LOG_LEVEL_DISABLED || header.nanoseconds < 0 || header.nanoseconds >= 1000000000) {
+        return -1;
+    }
+
+    if (*buffer == NULL || *bufferSize < header.size) {
+        char* newBuffer = realloc(*buffer, header.size);
+        if (newBuffer == NULL && header.size > 0) {
+            return -1;
+        }
+        *buffer = newBuffer;
+        *bufferSize = header.size;
+    }
+    if (fread(*buffer, 1, header.size, stream) != header.size) {
+        return -1;
+    }
+
+    memset(record, 0, sizeof(*record));
+    record->level = (celix_log_level_e)header.level;
+    record->logServiceId = (long)header.logServiceId;
+    record->line = header.line;
+    record->timestamp.tv_sec = (time_t)header.seconds;
+    record->timestamp.tv_nsec = (long)header.nanoseconds;
+
+    size_t pos = 0;
+    record->logServiceName = celix_logBinary_readString(*buffer, header.size, &pos);
+    if (record->logServiceName == NULL) {
+        return -1;
+    }
+    if (header.flags & CELIX_LOG_BINARY_RECORD_FLAG_FILE) {
+        record->file = celix_logBinary_readString(*buffer, header.size, &pos);
+        if (record->file == NULL) {
+            return -1;
+        }
+    }
+    if (header.flags & CELIX_LOG_BINARY_RECORD_FLAG_FUNCTION) {
+        record->function = celix_logBinary_readString(*buffer, header.size, &pos);
+        if (record->function == NULL) {
+            return -1;
+        }
+    }
+    if (header.flags & CELIX_LOG_BINARY_RECORD_FLAG_BINARY) {
+        record->binaryMessage = *buffer + pos;
+        record->binaryMessageSize = header.size - pos;
+    } else {
+        record->message = celix_logBinary_readString(*buffer, header.size, &pos);
+        if (record->message == NULL || pos != header.size) {
+            return -1;
+        }
+    }
+    return 1;
+}
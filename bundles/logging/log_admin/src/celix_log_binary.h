@@ -0,0 +1,113 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#ifndef CELIX_LOG_BINARY_H
+#define CELIX_LOG_BINARY_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "celix_log_level.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary log messages.
+ *
+ * A binary log message is the printf format string followed by the raw format arguments, so that a log message can be
+ * captured without formatting it and formatted later (e.g. in a log writer thread or offline with celix_log_decoder).
+ * String arguments are copied, the other arguments are stored in their native representation. Positional arguments,
+ * %n, %m and wide character conversions are not supported.
+ */
+
+#define CELIX_LOG_BINARY_FILE_MAGIC "CELXLOG1"
+
+/**
+ * A log record, as popped from the async log queue or read from a binary log file.
+ */
+typedef struct celix_log_record {
+    celix_log_level_e level;
+    long logServiceId;
+    const char* logServiceName;
+    const char* file; //NULL if not available
+    const char* function; //NULL if not available
+    int line;
+    struct timespec timestamp;
+    const char* message; //NULL for a binary log message
+    const void* binaryMessage; //NULL for a formatted log message
+    size_t binaryMessageSize;
+} celix_log_record_t;
+
+/**
+ * Encodes a log message as binary log message.
+ * @param buffer The output buffer.
+ * @param size The size of the output buffer.
+ * @param format The printf format string.
+ * @param formatArgs The format arguments. Note that the va_list is consumed, also on failure.
+ * @return The size of the binary log message or -1 if the binary log message does not fit in the buffer or
+ * the format string is not supported.
+ */
+int celix_logBinary_encode(void* buffer, size_t size, const char* format, va_list formatArgs);
+
+/**
+ * Formats a binary log message.
+ * @param binaryMessage The binary log message.
+ * @param size The size of the binary log message.
+ * @param out The output buffer, the output is truncated and always '\0' terminated if outSize > 0.
+ * @param outSize The size of the output buffer.
+ * @return true if the binary log message is valid, false otherwise.
+ */
+bool celix_logBinary_format(const void* binaryMessage, size_t size, char* out, size_t outSize);
+
+/**
+ * Writes the CELIX_LOG_BINARY_FILE_MAGIC of a binary log file.
+ * @return 0 on success, -1 on error (errno is set).
+ */
+int celix_logBinary_writeFileHeader(FILE* stream);
+
+/**
+ * Reads and checks the CELIX_LOG_BINARY_FILE_MAGIC of a binary log file.
+ * @return 0 on success, -1 if the stream is not a binary log file.
+ */
+int celix_logBinary_readFileHeader(FILE* stream);
+
+/**
+ * Appends a log record to a binary log file.
+ * @return 0 on success, -1 on error (errno is set).
+ */
+int celix_logBinary_writeRecord(FILE* stream, const celix_log_record_t* record);
+
+/**
+ * Reads a log record from a binary log file.
+ * The strings and binary message of the read record point into *buffer, which is (re)allocated as needed and must be
+ * freed by the caller.
+ * @return 1 if a record is read, 0 on end of file and -1 if the stream contains an invalid record.
+ */
+int celix_logBinary_readRecord(FILE* stream, char** buffer, size_t* bufferSize, celix_log_record_t* record);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //CELIX_LOG_BINARY_H
@@ -0,0 +1,121 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+/**
+ * celix_log_decoder renders the binary log files written by the Celix Log Admin
+ * (see CELIX_LOG_ADMIN_BINARY_LOG_FILE) to stdout, in the same format as the log admin logs to stdout.
+ *
+ * Usage: celix_log_decoder [-l <min_log_level>] <binary_log_file>...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "celix_log_binary.h"
+#include "celix_log_level.h"
+
+#define CELIX_LOG_DECODER_MAX_MESSAGE_SIZE (64 * 1024)
+
+static void celix_logDecoder_printRecord(const celix_log_record_t* record, char* messageBuffer) {
+    const char* message = record->message;
+    if (message == NULL) {
+        message = celix_logBinary_format(record->binaryMessage, record->binaryMessageSize, messageBuffer,
+                                         CELIX_LOG_DECODER_MAX_MESSAGE_SIZE)
+                      ? messageBuffer
+                      : "<invalid binary log message>";
+    }
+
+    struct tm local;
+    time_t t = record->timestamp.tv_sec;
+    localtime_r(&t, &local);
+    printf("[%i-%02i-%02iT%02i:%02i:%02i.%06li] ", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+           local.tm_hour, local.tm_min, local.tm_sec, record->timestamp.tv_nsec / 1000);
+    if (record->function != NULL) {
+        printf("[%7s] [%s] [%s:%i] %s\n", celix_logLevel_toString(record->level), record->logServiceName,
+               record->function, record->line, message);
+    } else {
+        printf("[%7s] [%s] %s\n", celix_logLevel_toString(record->level), record->logServiceName, message);
+    }
+}
+
+static int celix_logDecoder_decodeFile(const char* path, celix_log_level_e minLevel, char* messageBuffer) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    if (celix_logBinary_readFileHeader(file) != 0) {
+        fprintf(stderr, "%s is not a Celix binary log file\n", path);
+        fclose(file);
+        return 1;
+    }
+
+    int rc = 0;
+    char* buffer = NULL;
+    size_t bufferSize = 0;
+    celix_log_record_t record;
+    int read;
+    while ((read = celix_logBinary_readRecord(file, &buffer, &bufferSize, &record)) > 0) {
+        if (record.level >= minLevel) {
+            celix_logDecoder_printRecord(&record, messageBuffer);
+        }
+    }
+    if (read < 0) {
+        //note a truncated last record is expected if the log admin was writing while the file was copied
+        fprintf(stderr, "%s contains an invalid or truncated log record\n", path);
+        rc = 1;
+    }
+    free(buffer);
+    fclose(file);
+    return rc;
+}
+
+int main(int argc, char** argv) {
+    celix_log_level_e minLevel = CELIX_LOG_LEVEL_TRACE;
+    int opt;
+    while ((opt = getopt(argc, argv, "l:h")) != -1) {
+        switch (opt) {
+        case 'l':
+            minLevel = celix_logLevel_fromString(optarg, CELIX_LOG_LEVEL_TRACE);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-l <min_log_level>] <binary_log_file>...\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage: %s [-l <min_log_level>] <binary_log_file>...\n", argv[0]);
+        return 1;
+    }
+
+    char* messageBuffer = malloc(CELIX_LOG_DECODER_MAX_MESSAGE_SIZE);
+    if (messageBuffer == NULL) {
+        fprintf(stderr, "Cannot allocate message buffer\n");
+        return 1;
+    }
+    int rc = 0;
+    for (int i = optind; i < argc; ++i) {
+        rc |= celix_logDecoder_decodeFile(argv[i], minLevel, messageBuffer);
+    }
+    free(messageBuffer);
+    return rc;
+}
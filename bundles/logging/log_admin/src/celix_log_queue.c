@@ -0,0 +1,260 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "celix_log_queue.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "celix_threads.h"
+
+#define CELIX_LOG_QUEUE_CACHE_LINE_SIZE 64
+#define CELIX_LOG_QUEUE_MIN_RECORD_SIZE 128
+#define CELIX_LOG_QUEUE_NO_STRING (-1)
+
+/**
+ * A slot of the queue. The slot is free for the producer which pushes log record sequence number 'sequence' and
+ * contains a log record for the consumer if sequence is the log record sequence number + 1 (see Dmitry Vyukov's bounded
+ * MPMC queue).
+ */
+typedef struct celix_log_queue_slot {
+    size_t sequence;
+    celix_log_level_e level;
+    long logServiceId;
+    int line;
+    int fileOffset;
+    int functionOffset;
+    int messageOffset;
+    int binaryMessageSize; //-1 for a formatted log message
+    struct timespec timestamp;
+    char data[];
+} celix_log_queue_slot_t;
+
+struct celix_log_queue {
+    //read-only after creation
+    char* slots;
+    size_t slotSize;
+    size_t mask;
+    size_t maxRecordSize;
+
+    //producers
+    size_t pushPos __attribute__((aligned(CELIX_LOG_QUEUE_CACHE_LINE_SIZE)));
+
+    //consumer
+    size_t popPos __attribute__((aligned(CELIX_LOG_QUEUE_CACHE_LINE_SIZE)));
+    bool waiting; //whether the consumer is (going to) wait for log records, accessed atomically
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond;
+    bool wakeupRequested;
+};
+
+static celix_log_queue_slot_t* celix_logQueue_slot(const celix_log_queue_t* queue, size_t pos) {
+    return (celix_log_queue_slot_t*)(queue->slots + (pos & queue->mask) * queue->slotSize);
+}
+
+celix_log_queue_t* celix_logQueue_create(size_t capacity, size_t maxRecordSize) {
+    if (capacity == 0 || capacity > (SIZE_MAX >> 2) || maxRecordSize < CELIX_LOG_QUEUE_MIN_RECORD_SIZE || maxRecordSize > INT32_MAX) {
+        return NULL;
+    }
+    size_t nrOfSlots = 2;
+    while (nrOfSlots < capacity) {
+        nrOfSlots <<= 1;
+    }
+    size_t slotSize = sizeof(celix_log_queue_slot_t) + maxRecordSize;
+    slotSize = (slotSize + CELIX_LOG_QUEUE_CACHE_LINE_SIZE - 1) & ~((size_t)CELIX_LOG_QUEUE_CACHE_LINE_SIZE - 1);
+    if (nrOfSlots > SIZE_MAX / slotSize) {
+        return NULL;
+    }
+
+    celix_log_queue_t* queue = NULL;
+    if (posix_memalign((void**)&queue, CELIX_LOG_QUEUE_CACHE_LINE_SIZE, sizeof(*queue)) != 0) {
+        return NULL;
+    }
+    memset(queue, 0, sizeof(*queue));
+    if (posix_memalign((void**)&queue->slots, CELIX_LOG_QUEUE_CACHE_LINE_SIZE, nrOfSlots * slotSize) != 0) {
+        free(queue);
+        return NULL;
+    }
+    queue->slotSize = slotSize;
+    queue->mask = nrOfSlots - 1;
+    queue->maxRecordSize = maxRecordSize;
+    for (size_t i = 0; i < nrOfSlots; ++i) {
+        celix_logQueue_slot(queue, i)->sequence = i;
+    }
+    celix_status_t status = celixThreadMutex_create(&queue->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        free(queue->slots);
+        free(queue);
+        return NULL;
+    }
+    status = celixThreadCondition_init(&queue->cond, NULL);
+    if (status != CELIX_SUCCESS) {
+        celixThreadMutex_destroy(&queue->mutex);
+        free(queue->slots);
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+void celix_logQueue_destroy(celix_log_queue_t* queue) {
+    if (queue != NULL) {
+        celixThreadCondition_destroy(&queue->cond);
+        celixThreadMutex_destroy(&queue->mutex);
+        free(queue->slots);
+        free(queue);
+    }
+}
+
+size_t celix_logQueue_capacity(const celix_log_queue_t* queue) {
+    return queue->mask + 1;
+}
+
+/**
+ * Copies a string in the slot buffer, limited to maxLen characters.
+ * @return The offset of the copied string or CELIX_LOG_QUEUE_NO_STRING if str is NULL.
+ */
+static int celix_logQueue_appendString(celix_log_queue_slot_t* slot, size_t* pos, const char* str, size_t maxLen) {
+    if (str == NULL) {
+        return CELIX_LOG_QUEUE_NO_STRING;
+    }
+    size_t len = strnlen(str, maxLen);
+    int offset = (int)*pos;
+    memcpy(slot->data + *pos, str, len);
+    slot->data[*pos + len] = '\0';
+    *pos += len + 1;
+    return offset;
+}
+
+bool celix_logQueue_vpush(celix_log_queue_t* queue, bool binary, celix_log_level_e level, long logServiceId,
+                          const char* logServiceName, const char* file, const char* function, int line,
+                          const char* format, va_list formatArgs) {
+    celix_log_queue_slot_t* slot;
+    size_t pos = __atomic_load_n(&queue->pushPos, __ATOMIC_RELAXED);
+    for (;;) {
+        slot = celix_logQueue_slot(queue, pos);
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->pushPos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+            //pos is updated by the failed compare exchange
+        } else if (diff < 0) {
+            //the slot still contains a log record, which is not yet popped -> full
+            return false;
+        } else {
+            pos = __atomic_load_n(&queue->pushPos, __ATOMIC_RELAXED);
+        }
+    }
+
+    //the names, file and function use at most a quarter of the buffer each, so that the message always fits partly
+    size_t maxStringLen = queue->maxRecordSize / 4 - 1;
+    size_t dataPos = 0;
+    slot->level = level;
+    slot->logServiceId = logServiceId;
+    slot->line = line;
+    clock_gettime(CLOCK_REALTIME, &slot->timestamp);
+    (void)celix_logQueue_appendString(slot, &dataPos, logServiceName == NULL ? "" : logServiceName, maxStringLen);
+    slot->fileOffset = celix_logQueue_appendString(slot, &dataPos, file, maxStringLen);
+    slot->functionOffset = celix_logQueue_appendString(slot, &dataPos, function, maxStringLen);
+    slot->messageOffset = (int)dataPos;
+    size_t remaining = queue->maxRecordSize - dataPos;
+    slot->binaryMessageSize = -1;
+    if (binary) {
+        va_list args;
+        va_copy(args, formatArgs);
+        //fallback to a formatted log message if the binary log message does not fit or is not supported
+        slot->binaryMessageSize = celix_logBinary_encode(slot->data + dataPos, remaining, format, args);
+        va_end(args);
+    }
+    if (slot->binaryMessageSize < 0 && vsnprintf(slot->data + dataPos, remaining, format, formatArgs) < 0) {
+        slot->data[dataPos] = '\0';
+    }
+
+    //Dekker style handshake with celix_logQueue_waitForRecords, using sequentially consistent operations:
+    //either the consumer sees the new log record or this producer sees that the consumer is waiting.
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->waiting, __ATOMIC_SEQ_CST)) {
+        celixThreadMutex_lock(&queue->mutex);
+        celixThreadCondition_signal(&queue->cond);
+        celixThreadMutex_unlock(&queue->mutex);
+    }
+    return true;
+}
+
+static bool celix_logQueue_hasRecord(celix_log_queue_t* queue) {
+    celix_log_queue_slot_t* slot = celix_logQueue_slot(queue, queue->popPos);
+    return __atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) == queue->popPos + 1;
+}
+
+size_t celix_logQueue_pop(celix_log_queue_t* queue, size_t maxRecords, void* handle,
+                          void (*callback)(void* handle, const celix_log_record_t* record)) {
+    size_t count = 0;
+    while (count < maxRecords && celix_logQueue_hasRecord(queue)) {
+        celix_log_queue_slot_t* slot = celix_logQueue_slot(queue, queue->popPos);
+        celix_log_record_t record;
+        record.level = slot->level;
+        record.logServiceId = slot->logServiceId;
+        record.logServiceName = slot->data;
+        record.file = slot->fileOffset == CELIX_LOG_QUEUE_NO_STRING ? NULL : slot->data + slot->fileOffset;
+        record.function = slot->functionOffset == CELIX_LOG_QUEUE_NO_STRING ? NULL : slot->data + slot->functionOffset;
+        record.line = slot->line;
+        record.timestamp = slot->timestamp;
+        if (slot->binaryMessageSize < 0) {
+            record.message = slot->data + slot->messageOffset;
+            record.binaryMessage = NULL;
+            record.binaryMessageSize = 0;
+        } else {
+            record.message = NULL;
+            record.binaryMessage = slot->data + slot->messageOffset;
+            record.binaryMessageSize = (size_t)slot->binaryMessageSize;
+        }
+        callback(handle, &record);
+
+        //release the slot for the producer of the log record in the next round
+        __atomic_store_n(&slot->sequence, queue->popPos + queue->mask + 1, __ATOMIC_RELEASE);
+        queue->popPos += 1;
+        count += 1;
+    }
+    return count;
+}
+
+void celix_logQueue_waitForRecords(celix_log_queue_t* queue, double timeoutInSeconds) {
+    struct timespec absTime = celixThreadCondition_getDelayedTime(timeoutInSeconds);
+    celixThreadMutex_lock(&queue->mutex);
+    __atomic_store_n(&queue->waiting, true, __ATOMIC_SEQ_CST);
+    if (!queue->wakeupRequested && !celix_logQueue_hasRecord(queue)) {
+        celixThreadCondition_waitUntil(&queue->cond, &queue->mutex, &absTime);
+    }
+    __atomic_store_n(&queue->waiting, false, __ATOMIC_RELAXED);
+    queue->wakeupRequested = false;
+    celixThreadMutex_unlock(&queue->mutex);
+}
+
+void celix_logQueue_wakeup(celix_log_queue_t* queue) {
+    celixThreadMutex_lock(&queue->mutex);
+    queue->wakeupRequested = true;
+    celixThreadCondition_signal(&queue->cond);
+    celixThreadMutex_unlock(&queue->mutex);
+}
@@ -0,0 +1,93 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#ifndef CELIX_LOG_QUEUE_H
+#define CELIX_LOG_QUEUE_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "celix_log_binary.h"
+#include "celix_log_level.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bounded, lock-free multi-producer single-consumer queue of (binary) log records.
+ *
+ * Every slot of the queue has a fixed size buffer. A producer claims a slot with a single compare-and-swap and formats
+ * (or encodes) the log record directly into the buffer of the claimed slot, so logging does not allocate memory and
+ * producers do not block each other. If the queue is full the log record is rejected, the caller is responsible for the
+ * accounting of dropped log records.
+ * The consumer is only woken up if it is waiting for log records.
+ */
+typedef struct celix_log_queue celix_log_queue_t; //opaque
+
+/**
+ * Creates a log queue.
+ * @param capacity The number of slots, rounded up to a power of 2.
+ * @param maxRecordSize The buffer size of a slot, used for the log service name, file, function and message.
+ * @return The log queue or NULL if the arguments are invalid or memory could not be allocated.
+ */
+celix_log_queue_t* celix_logQueue_create(size_t capacity, size_t maxRecordSize);
+
+void celix_logQueue_destroy(celix_log_queue_t* queue);
+
+/**
+ * Returns the number of slots of the log queue.
+ */
+size_t celix_logQueue_capacity(const celix_log_queue_t* queue);
+
+/**
+ * Formats a log record into a free slot of the queue. Can be called concurrently.
+ * @param binary If true, the log message is stored as binary log message (see celix_log_binary.h) and formatting is
+ * deferred to the consumer. Falls back to a formatted log message if the binary log message does not fit in the slot.
+ * @return true if the log record is queued, false if the queue is full.
+ */
+bool celix_logQueue_vpush(celix_log_queue_t* queue, bool binary, celix_log_level_e level, long logServiceId,
+                          const char* logServiceName, const char* file, const char* function, int line,
+                          const char* format, va_list formatArgs);
+
+/**
+ * Pops at most maxRecords log records from the queue and calls the callback for every popped log record.
+ * Should only be called from the consumer thread.
+ * @return The number of popped log records.
+ */
+size_t celix_logQueue_pop(celix_log_queue_t* queue, size_t maxRecords, void* handle,
+                          void (*callback)(void* handle, const celix_log_record_t* record));
+
+/**
+ * Waits until a log record is available, the queue is woken up or the timeout expires.
+ * Should only be called from the consumer thread.
+ */
+void celix_logQueue_waitForRecords(celix_log_queue_t* queue, double timeoutInSeconds);
+
+/**
+ * Wakes up the consumer thread, if it is waiting for log records.
+ */
+void celix_logQueue_wakeup(celix_log_queue_t* queue);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //CELIX_LOG_QUEUE_H
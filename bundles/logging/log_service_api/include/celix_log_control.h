@@ -30,7 +30,7 @@ extern "C" {
 #endif
 
 #define CELIX_LOG_CONTROL_NAME      "celix_log_control"
-#define CELIX_LOG_CONTROL_VERSION   "1.1.0"
+#define CELIX_LOG_CONTROL_VERSION   "1.2.0"
 #define CELIX_LOG_CONTROL_USE_RANGE "[1.1.0,2)"
 
 typedef struct celix_log_control {
@@ -88,6 +88,17 @@ typedef struct celix_log_control {
      */
     bool (*logServiceInfoEx)(void *handle, const char* loggerName, celix_log_level_e* outActiveLogLevel, bool* outDetailed);
 
+    /**
+     * @brief Get the number of log messages which are dropped, because the async log queue was full.
+     * @details Log messages are only dropped if the log admin logs asynchronously.
+     * @since 1.2.0
+     * @param[in] handle The service handle.
+     * @param[in] select The select string that specifies the case-insensitive name prefix of target loggers.
+     *                   If NULL, the dropped log messages of all loggers, including removed loggers, are counted.
+     * @return Number of dropped log messages of the selected loggers.
+     */
+    size_t (*nrOfDroppedLogs)(void *handle, const char* select);
+
 } celix_log_control_t;
 
 #ifdef __cplusplus
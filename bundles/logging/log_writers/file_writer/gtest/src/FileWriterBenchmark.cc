@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <unistd.h>
+
+#include "celix_file_writer.h"
+
+/**
+ * Benchmark for the log throughput of the file writer, compared to logging with a line buffered FILE stream
+ * (a write syscall per log line), which is how the log admin logs to stdout.
+ *
+ * The benchmarks run with 1 and 4 threads, logging to a single file writer / FILE stream.
+ */
+static constexpr const char* BENCHMARK_LOG_FILE = ".file_writer_benchmark.log";
+static constexpr const char* BENCHMARK_STDIO_FILE = ".file_writer_benchmark_stdio.log";
+
+static celix_file_writer_t* g_writer = nullptr;
+static FILE* g_stream = nullptr;
+static std::mutex g_streamMutex{};
+
+static void removeLogFiles() {
+    for (const char* file : {BENCHMARK_LOG_FILE, ".file_writer_benchmark.log.1", ".file_writer_benchmark.log.2", BENCHMARK_STDIO_FILE}) {
+        unlink(file);
+    }
+}
+
+static void sinkLog(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    celix_fileWriter_sinkLog(g_writer, CELIX_LOG_LEVEL_INFO, 1, "benchmark", nullptr, nullptr, 0, format, args);
+    va_end(args);
+}
+
+static void FileWriter_Log(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        removeLogFiles();
+        celix_file_writer_config_t config{};
+        config.path = BENCHMARK_LOG_FILE;
+        config.maxFileSize = 64 * 1024 * 1024;
+        config.maxFiles = 2;
+        config.syncIntervalInMs = 1000;
+        config.logLevel = CELIX_LOG_LEVEL_TRACE;
+        g_writer = celix_fileWriter_create(&config);
+    }
+    long i = 0;
+    for (auto _ : state) {
+        sinkLog("benchmark thread %i, log %li with value %f", state.thread_index(), i++, 3.14);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = (double)celix_fileWriter_nrOfDroppedLogs(g_writer);
+        celix_fileWriter_destroy(g_writer);
+        g_writer = nullptr;
+        removeLogFiles();
+    }
+}
+
+static void Stdio_LineBufferedLog(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        removeLogFiles();
+        g_stream = fopen(BENCHMARK_STDIO_FILE, "w");
+        setvbuf(g_stream, nullptr, _IOLBF, BUFSIZ);
+    }
+    long i = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock{g_streamMutex};
+        fprintf(g_stream, "[%7s] [%s] benchmark thread %i, log %li with value %f\n", "info", "benchmark",
+                state.thread_index(), i++, 3.14);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        fclose(g_stream);
+        g_stream = nullptr;
+        removeLogFiles();
+    }
+}
+
+BENCHMARK(FileWriter_Log)->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(Stdio_LineBufferedLog)->Threads(1)->Threads(4)->UseRealTime();
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "celix_err.h"
+#include "celix_file_writer.h"
+#include "celix_threads_ei.h"
+
+class FileWriterErrorInjectionTestSuite : public ::testing::Test {
+public:
+    FileWriterErrorInjectionTestSuite() {
+        unlink(path);
+        config.path = path;
+        config.maxFileSize = 64 * 1024;
+        config.maxFiles = 2;
+        config.rotateIntervalInSeconds = 0;
+        config.syncIntervalInMs = 10;
+        config.logLevel = CELIX_LOG_LEVEL_TRACE;
+    }
+
+    ~FileWriterErrorInjectionTestSuite() override {
+        celix_ei_expect_celixThreadMutex_create(nullptr, 0, CELIX_SUCCESS);
+        celix_ei_expect_celixThreadCondition_init(nullptr, 0, CELIX_SUCCESS);
+        celix_err_resetErrors();
+        unlink(path);
+    }
+
+    static constexpr const char* path = ".FileWriterErrorInjectionTestSuite.log";
+    celix_file_writer_config_t config{};
+};
+
+TEST_F(FileWriterErrorInjectionTestSuite, MutexCreateFailureTest) {
+    celix_ei_expect_celixThreadMutex_create((void*)celix_fileWriter_create, 0, CELIX_ENOMEM);
+    EXPECT_EQ(nullptr, celix_fileWriter_create(&config));
+    EXPECT_GE(celix_err_getErrorCount(), 1);
+}
+
+TEST_F(FileWriterErrorInjectionTestSuite, ConditionInitFailureTest) {
+    celix_ei_expect_celixThreadCondition_init((void*)celix_fileWriter_create, 0, CELIX_ENOMEM);
+    EXPECT_EQ(nullptr, celix_fileWriter_create(&config));
+    EXPECT_GE(celix_err_getErrorCount(), 1);
+}
@@ -0,0 +1,293 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdarg>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_file_writer.h"
+#include "celix_framework_factory.h"
+#include "celix_log_constants.h"
+#include "celix_log_control.h"
+#include "celix_log_service.h"
+
+class FileWriterTestSuite : public ::testing::Test {
+public:
+    FileWriterTestSuite() {
+        removeLogFiles();
+        config.path = path;
+        config.maxFileSize = 64 * 1024;
+        config.maxFiles = 2;
+        config.rotateIntervalInSeconds = 0;
+        config.syncIntervalInMs = 10;
+        config.logLevel = CELIX_LOG_LEVEL_TRACE;
+    }
+
+    ~FileWriterTestSuite() override {
+        removeLogFiles();
+    }
+
+    static void removeLogFiles() {
+        for (const char* file : {path, ".FileWriterTestSuite.log.1", ".FileWriterTestSuite.log.2", ".FileWriterTestSuite.log.3"}) {
+            unlink(file);
+        }
+    }
+
+    static void log(celix_file_writer_t* writer, celix_log_level_e level, const char* function, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        celix_fileWriter_sinkLog(writer, level, 1, "test::Log", nullptr, function, 42, format, args);
+        va_end(args);
+    }
+
+    static std::vector<std::string> readLines(const char* file) {
+        std::ifstream in{file};
+        std::vector<std::string> lines{};
+        std::string line{};
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    static std::string message(const std::string& line) {
+        return line.substr(line.find("] [test::Log] ") + strlen("] [test::Log] "));
+    }
+
+    static off_t fileSize(const char* file) {
+        struct stat st{};
+        return stat(file, &st) == 0 ? st.st_size : -1;
+    }
+
+    static constexpr const char* path = ".FileWriterTestSuite.log";
+    celix_file_writer_config_t config{};
+};
+
+TEST_F(FileWriterTestSuite, CreateWithInvalidConfigTest) {
+    config.maxFileSize = 16;
+    EXPECT_EQ(nullptr, celix_fileWriter_create(&config));
+    config.maxFileSize = 64 * 1024;
+    config.path = "";
+    EXPECT_EQ(nullptr, celix_fileWriter_create(&config));
+    config.path = "/non-existing-dir/celix.log";
+    EXPECT_EQ(nullptr, celix_fileWriter_create(&config));
+}
+
+TEST_F(FileWriterTestSuite, LogToFileTest) {
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    EXPECT_EQ((off_t)config.maxFileSize, fileSize(path)); //pre-allocated
+
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "test %i %s", 1, "info");
+    log(writer, CELIX_LOG_LEVEL_ERROR, "func", "test %i %s", 2, "error");
+    celix_fileWriter_destroy(writer);
+
+    auto lines = readLines(path);
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ('[', lines[0][0]);
+    EXPECT_EQ('.', lines[0][20]); //[YYYY-MM-DDTHH:MM:SS.uuuuuu]
+    EXPECT_NE(std::string::npos, lines[0].find("] [   info] [test::Log] test 1 info"));
+    EXPECT_NE(std::string::npos, lines[1].find("] [  error] [test::Log] [func:42] test 2 error"));
+
+    //the closed log file is truncated to the used size
+    off_t expectedSize = 0;
+    for (auto& line : lines) {
+        expectedSize += (off_t)line.size() + 1;
+    }
+    EXPECT_EQ(expectedSize, fileSize(path));
+
+    //a reopened log file is appended to
+    writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "test 3");
+    celix_fileWriter_destroy(writer);
+    lines = readLines(path);
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ("test 3", message(lines[2]));
+}
+
+TEST_F(FileWriterTestSuite, LogLevelFilterTest) {
+    config.logLevel = CELIX_LOG_LEVEL_WARNING;
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    log(writer, CELIX_LOG_LEVEL_DEBUG, nullptr, "debug");
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "info");
+    log(writer, CELIX_LOG_LEVEL_WARNING, nullptr, "warning");
+    log(writer, CELIX_LOG_LEVEL_FATAL, nullptr, "fatal");
+    celix_fileWriter_destroy(writer);
+
+    auto lines = readLines(path);
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("warning", message(lines[0]));
+    EXPECT_EQ("fatal", message(lines[1]));
+}
+
+TEST_F(FileWriterTestSuite, LongLogLineIsTruncatedTest) {
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    std::string longMessage(2 * CELIX_FILE_WRITER_MAX_LINE_SIZE, 'x');
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "%s", longMessage.c_str());
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "next");
+    celix_fileWriter_destroy(writer);
+
+    auto lines = readLines(path);
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ(CELIX_FILE_WRITER_MAX_LINE_SIZE - 1, lines[0].size());
+    EXPECT_EQ("next", message(lines[1]));
+}
+
+TEST_F(FileWriterTestSuite, RotateOnSizeTest) {
+    config.maxFileSize = 2 * CELIX_FILE_WRITER_MAX_LINE_SIZE;
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    std::string msg(1000, 'x');
+    constexpr int nrOfLogs = 40; //~40KB, so more than maxFiles rotations
+    for (int i = 0; i < nrOfLogs; ++i) {
+        log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "%04i %s", i, msg.c_str());
+    }
+    EXPECT_EQ(0, celix_fileWriter_nrOfDroppedLogs(writer));
+    celix_fileWriter_destroy(writer);
+
+    auto current = readLines(path);
+    auto rotated1 = readLines(".FileWriterTestSuite.log.1");
+    auto rotated2 = readLines(".FileWriterTestSuite.log.2");
+    EXPECT_EQ(-1, fileSize(".FileWriterTestSuite.log.3")); //at most maxFiles rotated log files
+    ASSERT_FALSE(current.empty());
+    ASSERT_FALSE(rotated1.empty());
+    ASSERT_FALSE(rotated2.empty());
+    EXPECT_LE(fileSize(".FileWriterTestSuite.log.1"), (off_t)config.maxFileSize);
+
+    //the log files contain consecutive log lines, and the current log file contains the last log line
+    EXPECT_EQ(std::stoi(message(rotated2.back())) + 1, std::stoi(message(rotated1.front())));
+    EXPECT_EQ(std::stoi(message(rotated1.back())) + 1, std::stoi(message(current.front())));
+    EXPECT_EQ(nrOfLogs - 1, std::stoi(message(current.back())));
+}
+
+TEST_F(FileWriterTestSuite, RotateOnTimeTest) {
+    config.rotateIntervalInSeconds = 1;
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "first");
+    std::this_thread::sleep_for(std::chrono::milliseconds{1100});
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "second");
+    celix_fileWriter_destroy(writer);
+
+    auto rotated = readLines(".FileWriterTestSuite.log.1");
+    auto current = readLines(path);
+    ASSERT_EQ(1, rotated.size());
+    EXPECT_EQ("first", message(rotated[0]));
+    ASSERT_EQ(1, current.size());
+    EXPECT_EQ("second", message(current[0]));
+}
+
+TEST_F(FileWriterTestSuite, RecoverAfterCrashTest) {
+    //simulate a crashed file writer: a pre-allocated log file with a zero filled tail and an incomplete last log line
+    {
+        std::string content = "[2024-01-01T00:00:00.000000] [   info] [test::Log] before crash\n"
+                              "[2024-01-01T00:00:00.000001] [   info] [test::Log] incompl";
+        content.resize(config.maxFileSize, '\0');
+        std::ofstream out{path, std::ios::binary};
+        out.write(content.data(), (std::streamsize)content.size());
+    }
+
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "after crash");
+    celix_fileWriter_destroy(writer);
+
+    auto lines = readLines(path);
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("before crash", message(lines[0]));
+    EXPECT_EQ("after crash", message(lines[1]));
+}
+
+TEST_F(FileWriterTestSuite, ConcurrentLoggingTest) {
+    config.maxFileSize = 256 * 1024;
+    auto* writer = celix_fileWriter_create(&config);
+    ASSERT_NE(nullptr, writer);
+    constexpr int nrOfThreads = 4;
+    constexpr int nrOfLogsPerThread = 1000;
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < nrOfThreads; ++t) {
+        threads.emplace_back([writer, t] {
+            for (int i = 0; i < nrOfLogsPerThread; ++i) {
+                log(writer, CELIX_LOG_LEVEL_INFO, nullptr, "thread %i log %i", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    celix_fileWriter_destroy(writer);
+
+    size_t total = 0;
+    for (const char* file : {path, ".FileWriterTestSuite.log.1", ".FileWriterTestSuite.log.2"}) {
+        for (auto& line : readLines(file)) {
+            EXPECT_EQ(0, message(line).find("thread "));
+            ++total;
+        }
+    }
+    EXPECT_LE(total, (size_t)(nrOfThreads * nrOfLogsPerThread)); //note the oldest log files are removed
+    EXPECT_GT(total, 0);
+}
+
+TEST_F(FileWriterTestSuite, LogToFileWriterBundleTest) {
+    auto* properties = celix_properties_create();
+    celix_properties_set(properties, CELIX_FRAMEWORK_CACHE_DIR, ".cacheFileWriterTestSuite");
+    celix_properties_set(properties, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+    celix_properties_set(properties, CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL_CONFIG_NAME, "trace");
+    celix_properties_set(properties, CELIX_FILE_WRITER_PATH_CONFIG_NAME, path);
+    celix_properties_set(properties, CELIX_FILE_WRITER_LOG_LEVEL_CONFIG_NAME, "info");
+    auto* fw = celix_frameworkFactory_createFramework(properties);
+    ASSERT_NE(nullptr, fw);
+    auto* ctx = celix_framework_getFrameworkContext(fw);
+    EXPECT_GE(celix_bundleContext_installBundle(ctx, LOG_ADMIN_BUNDLE, true), 0);
+    EXPECT_GE(celix_bundleContext_installBundle(ctx, FILE_WRITER_BUNDLE, true), 0);
+    celix_framework_waitForEmptyEventQueue(fw);
+
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = CELIX_LOG_SERVICE_NAME;
+    opts.filter.filter = "(name=test::Log)";
+    opts.use = [](void*, void* svc) {
+        auto* ls = static_cast<celix_log_service_t*>(svc);
+        ls->debug(ls->handle, "filtered by the file writer");
+        ls->info(ls->handle, "test %i", 1);
+    };
+    EXPECT_TRUE(celix_bundleContext_useServiceWithOptions(ctx, &opts));
+    celix_frameworkFactory_destroyFramework(fw);
+
+    auto lines = readLines(path);
+    std::vector<std::string> testLines{};
+    for (auto& line : lines) {
+        if (line.find("[test::Log]") != std::string::npos) {
+            testLines.push_back(message(line));
+        }
+    }
+    ASSERT_EQ(1, testLines.size());
+    EXPECT_EQ("test 1", testLines[0]);
+}
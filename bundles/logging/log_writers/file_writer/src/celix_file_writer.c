@@ -0,0 +1,389 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "celix_file_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "celix_compiler.h"
+#include "celix_err.h"
+#include "celix_errno.h"
+#include "celix_threads.h"
+#include "celix_utils.h"
+
+#define CELIX_FILE_WRITER_TIMESTAMP_SIZE 29 //"[YYYY-MM-DDTHH:MM:SS.uuuuuu] "
+#define CELIX_FILE_WRITER_REOPEN_INTERVAL_IN_SECONDS 1
+
+struct celix_file_writer {
+    //read-only after creation
+    char* path;
+    size_t maxFileSize;
+    int maxFiles;
+    long rotateIntervalInSeconds;
+    long syncIntervalInMs;
+    celix_log_level_e logLevel;
+    celix_thread_t syncThread;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond;
+    bool syncThreadActive;
+    int fd; //-1 if the log file is not open
+    char* map;
+    size_t mapSize;
+    size_t offset; //write offset in the log file
+    bool dirty; //whether log lines are written since the last sync
+    time_t openTime; //monotonic time the log file was opened or the last open attempt
+    time_t cachedSecond; //the second of cachedTimestamp
+    char cachedTimestamp[CELIX_FILE_WRITER_TIMESTAMP_SIZE + 1];
+    size_t nrOfDroppedLogs;
+};
+
+static time_t celix_fileWriter_monotonicSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+/**
+ * Writes the dirty pages of the log file, including the dirty pages of the shared memory mapping, back to disk.
+ */
+static void celix_fileWriter_syncFd(int fd) {
+#ifdef __APPLE__
+    (void)fsync(fd);
+#else
+    (void)fdatasync(fd);
+#endif
+}
+
+/**
+ * Returns the write offset of a (crashed) log file: the end of the last complete log line before the zero filled tail.
+ * An incomplete last log line is discarded.
+ */
+static size_t celix_fileWriter_recoverOffset(char* map, size_t fileSize) {
+    size_t end = fileSize;
+    while (end > 0 && map[end - 1] == '\0') {
+        --end;
+    }
+    size_t offset = end;
+    while (offset > 0 && map[offset - 1] != '\n') {
+        --offset;
+    }
+    memset(map + offset, 0, end - offset);
+    return offset;
+}
+
+/**
+ * Opens (or recovers) the log file and maps it in memory. Called with the mutex locked or during creation.
+ */
+static celix_status_t celix_fileWriter_openFile(celix_file_writer_t* writer) {
+    writer->openTime = celix_fileWriter_monotonicSeconds();
+    int fd = open(writer->path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        celix_err_pushf("File writer: Cannot open log file %s: %s", writer->path, strerror(errno));
+        return CELIX_FILE_IO_EXCEPTION;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        celix_err_pushf("File writer: Cannot stat log file %s: %s", writer->path, strerror(errno));
+        close(fd);
+        return CELIX_FILE_IO_EXCEPTION;
+    }
+    size_t fileSize = (size_t)st.st_size;
+    size_t mapSize = fileSize > writer->maxFileSize ? fileSize : writer->maxFileSize;
+    if (fileSize < mapSize) {
+        if (ftruncate(fd, (off_t)mapSize) != 0) {
+            celix_err_pushf("File writer: Cannot resize log file %s: %s", writer->path, strerror(errno));
+            close(fd);
+            return CELIX_FILE_IO_EXCEPTION;
+        }
+#ifdef __linux__
+        //reserve the disk blocks, so that writing to the mapped log file does not fail on a full disk (SIGBUS)
+        int rc = posix_fallocate(fd, (off_t)fileSize, (off_t)(mapSize - fileSize));
+        if (rc != 0) {
+            celix_err_pushf("File writer: Cannot reserve disk space for log file %s: %s", writer->path, strerror(rc));
+            if (ftruncate(fd, (off_t)fileSize) != 0) {
+                //note the log file keeps its zero filled tail, which is recovered when the log file is opened again
+            }
+            close(fd);
+            return CELIX_FILE_IO_EXCEPTION;
+        }
+#endif
+    }
+    char* map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        celix_err_pushf("File writer: Cannot map log file %s: %s", writer->path, strerror(errno));
+        if (ftruncate(fd, (off_t)fileSize) != 0) {
+            //note the log file keeps its zero filled tail, which is recovered when the log file is opened again
+        }
+        close(fd);
+        return CELIX_FILE_IO_EXCEPTION;
+    }
+    writer->fd = fd;
+    writer->map = map;
+    writer->mapSize = mapSize;
+    writer->offset = celix_fileWriter_recoverOffset(map, fileSize);
+    return CELIX_SUCCESS;
+}
+
+/**
+ * Unmaps and closes the log file. The log file is truncated to the used size, so that a closed log file has no zero
+ * filled tail. Called with the mutex locked or during destruction.
+ */
+static void celix_fileWriter_closeFile(celix_file_writer_t* writer) {
+    if (writer->fd < 0) {
+        return;
+    }
+    munmap(writer->map, writer->mapSize);
+    if (ftruncate(writer->fd, (off_t)writer->offset) != 0) {
+        //note the log file keeps its zero filled tail, which is recovered when the log file is opened again
+    }
+    close(writer->fd);
+    writer->fd = -1;
+    writer->map = NULL;
+    writer->mapSize = 0;
+    writer->offset = 0;
+}
+
+/**
+ * Renames <path> to <path>.1, <path>.1 to <path>.2, etc. and removes the oldest rotated log file.
+ */
+static void celix_fileWriter_shiftFiles(celix_file_writer_t* writer) {
+    char* from = NULL;
+    char* to = NULL;
+    for (int i = writer->maxFiles - 1; i >= 1; --i) {
+        if (asprintf(&from, "%s.%i", writer->path, i) >= 0 && asprintf(&to, "%s.%i", writer->path, i + 1) >= 0) {
+            (void)rename(from, to);
+        }
+        free(from);
+        free(to);
+        from = NULL;
+        to = NULL;
+    }
+    if (writer->maxFiles > 0 && asprintf(&to, "%s.1", writer->path) >= 0) {
+        (void)rename(writer->path, to);
+        free(to);
+    } else {
+        (void)unlink(writer->path);
+    }
+}
+
+/**
+ * Closes the current log file, rotates the log files and opens a new log file. Called with the mutex locked.
+ */
+static void celix_fileWriter_rotate(celix_file_writer_t* writer) {
+    celix_fileWriter_closeFile(writer);
+    celix_fileWriter_shiftFiles(writer);
+    if (celix_fileWriter_openFile(writer) != CELIX_SUCCESS) {
+        celix_err_resetErrors(); //note retried on a next log line
+    }
+}
+
+static void* celix_fileWriter_syncThread(void* data) {
+    celix_file_writer_t* writer = data;
+    celixThreadMutex_lock(&writer->mutex);
+    while (writer->syncThreadActive) {
+        struct timespec absTime = celixThreadCondition_getDelayedTime((double)writer->syncIntervalInMs / 1000.0);
+        celixThreadCondition_waitUntil(&writer->cond, &writer->mutex, &absTime);
+        if (!writer->dirty || writer->fd < 0) {
+            continue;
+        }
+        //note a duplicated file descriptor keeps the log file open if it is rotated while syncing
+        int fd = dup(writer->fd);
+        writer->dirty = false;
+        celixThreadMutex_unlock(&writer->mutex);
+        if (fd >= 0) {
+            celix_fileWriter_syncFd(fd);
+            close(fd);
+        }
+        celixThreadMutex_lock(&writer->mutex);
+    }
+    celixThreadMutex_unlock(&writer->mutex);
+    return NULL;
+}
+
+celix_file_writer_t* celix_fileWriter_create(const celix_file_writer_config_t* config) {
+    if (celix_utils_isStringNullOrEmpty(config->path) || config->maxFileSize < 2 * CELIX_FILE_WRITER_MAX_LINE_SIZE ||
+        config->maxFiles < 0 || config->rotateIntervalInSeconds < 0 || config->syncIntervalInMs < 0) {
+        celix_err_pushf("File writer: Invalid config, the max file size should be at least %i bytes.",
+                        2 * CELIX_FILE_WRITER_MAX_LINE_SIZE);
+        return NULL;
+    }
+    celix_file_writer_t* writer = calloc(1, sizeof(*writer));
+    if (writer == NULL) {
+        return NULL;
+    }
+    writer->path = celix_utils_strdup(config->path);
+    writer->maxFileSize = config->maxFileSize;
+    writer->maxFiles = config->maxFiles;
+    writer->rotateIntervalInSeconds = config->rotateIntervalInSeconds;
+    writer->syncIntervalInMs = config->syncIntervalInMs;
+    writer->logLevel = config->logLevel;
+    writer->fd = -1;
+    writer->cachedSecond = -1;
+    if (writer->path == NULL || celix_fileWriter_openFile(writer) != CELIX_SUCCESS) {
+        free(writer->path);
+        free(writer);
+        return NULL;
+    }
+    celix_status_t status = celixThreadMutex_create(&writer->mutex, NULL);
+    if (status == CELIX_SUCCESS) {
+        status = celixThreadCondition_init(&writer->cond, NULL);
+        if (status != CELIX_SUCCESS) {
+            celixThreadMutex_destroy(&writer->mutex);
+        }
+    }
+    if (status != CELIX_SUCCESS) {
+        celix_err_pushf("File writer: Cannot create the file writer lock: %s", celix_strerror(status));
+        celix_fileWriter_closeFile(writer);
+        free(writer->path);
+        free(writer);
+        return NULL;
+    }
+    if (writer->syncIntervalInMs > 0) {
+        writer->syncThreadActive = true;
+        if (celixThread_create(&writer->syncThread, NULL, celix_fileWriter_syncThread, writer) == CELIX_SUCCESS) {
+            celixThread_setName(&writer->syncThread, "CelixFileWriter");
+        } else {
+            writer->syncThreadActive = false;
+        }
+    }
+    return writer;
+}
+
+void celix_fileWriter_destroy(celix_file_writer_t* writer) {
+    if (writer == NULL) {
+        return;
+    }
+    celixThreadMutex_lock(&writer->mutex);
+    bool joinSyncThread = writer->syncThreadActive;
+    writer->syncThreadActive = false;
+    celixThreadCondition_broadcast(&writer->cond);
+    celixThreadMutex_unlock(&writer->mutex);
+    if (joinSyncThread) {
+        celixThread_join(writer->syncThread, NULL);
+    }
+    if (writer->fd >= 0 && writer->syncIntervalInMs > 0) {
+        celix_fileWriter_syncFd(writer->fd);
+    }
+    celix_fileWriter_closeFile(writer);
+    celixThreadCondition_destroy(&writer->cond);
+    celixThreadMutex_destroy(&writer->mutex);
+    free(writer->path);
+    free(writer);
+}
+
+/**
+ * Writes the "[YYYY-MM-DDTHH:MM:SS.uuuuuu] " timestamp of a log line. The date and time part is only formatted once
+ * per second. Called with the mutex locked.
+ */
+static void celix_fileWriter_writeTimestamp(celix_file_writer_t* writer, char* out, const struct timespec* ts) {
+    if (ts->tv_sec != writer->cachedSecond) {
+        struct tm local;
+        localtime_r(&ts->tv_sec, &local);
+        if (strftime(writer->cachedTimestamp, sizeof(writer->cachedTimestamp), "[%Y-%m-%dT%H:%M:%S.000000] ", &local) !=
+            CELIX_FILE_WRITER_TIMESTAMP_SIZE) {
+            memcpy(writer->cachedTimestamp, "[0000-00-00T00:00:00.000000] ", CELIX_FILE_WRITER_TIMESTAMP_SIZE);
+        }
+        writer->cachedSecond = ts->tv_sec;
+    }
+    memcpy(out, writer->cachedTimestamp, CELIX_FILE_WRITER_TIMESTAMP_SIZE);
+    long usec = ts->tv_nsec / 1000;
+    for (int i = 26; i >= 21; --i) {
+        out[i] = (char)('0' + usec % 10);
+        usec /= 10;
+    }
+}
+
+/**
+ * Formats the log line, without the timestamp, in buffer.
+ * @return The size of the log line, including the '\n'.
+ */
+static size_t celix_fileWriter_formatLine(char* buffer, size_t size, celix_log_level_e level, const char* logServiceName,
+                                          const char* function, int line, const char* format, va_list formatArgs) {
+    int len;
+    if (function != NULL) {
+        len = snprintf(buffer, size, "[%7s] [%s] [%s:%i] ", celix_logLevel_toString(level), logServiceName, function, line);
+    } else {
+        len = snprintf(buffer, size, "[%7s] [%s] ", celix_logLevel_toString(level), logServiceName);
+    }
+    size_t pos = len < 0 ? 0 : ((size_t)len < size - 1 ? (size_t)len : size - 1);
+    len = vsnprintf(buffer + pos, size - pos, format, formatArgs);
+    pos = len < 0 ? pos : ((size_t)len < size - 1 - pos ? pos + (size_t)len : size - 1);
+    buffer[pos] = '\n'; //note buffer is not '\0' terminated
+    return pos + 1;
+}
+
+void celix_fileWriter_sinkLog(void* handle, celix_log_level_e level, long logServiceId CELIX_UNUSED,
+                              const char* logServiceName, const char* file CELIX_UNUSED,
+                              const char* function, int line, const char* format, va_list formatArgs) {
+    celix_file_writer_t* writer = handle;
+    if (level < writer->logLevel || level == CELIX_LOG_LEVEL_DISABLED) {
+        return;
+    }
+
+    //format outside the lock, so that concurrent log calls only serialize on the memcpy
+    char buffer[CELIX_FILE_WRITER_MAX_LINE_SIZE - CELIX_FILE_WRITER_TIMESTAMP_SIZE];
+    size_t len = celix_fileWriter_formatLine(buffer, sizeof(buffer), level, logServiceName == NULL ? "" : logServiceName,
+                                             function, line, format, formatArgs);
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    size_t lineSize = CELIX_FILE_WRITER_TIMESTAMP_SIZE + len;
+
+    celixThreadMutex_lock(&writer->mutex);
+    time_t now = writer->fd < 0 || writer->rotateIntervalInSeconds > 0 ? celix_fileWriter_monotonicSeconds() : 0;
+    if (writer->fd < 0) {
+        if (now - writer->openTime >= CELIX_FILE_WRITER_REOPEN_INTERVAL_IN_SECONDS &&
+            celix_fileWriter_openFile(writer) != CELIX_SUCCESS) {
+            celix_err_resetErrors();
+        }
+    } else if (writer->offset + lineSize > writer->mapSize ||
+               (writer->rotateIntervalInSeconds > 0 && now - writer->openTime >= writer->rotateIntervalInSeconds)) {
+        if (writer->offset > 0) {
+            celix_fileWriter_rotate(writer);
+        } else {
+            writer->openTime = now; //note an empty log file is not rotated
+        }
+    }
+    if (writer->fd >= 0 && writer->offset + lineSize <= writer->mapSize) {
+        char* out = writer->map + writer->offset;
+        celix_fileWriter_writeTimestamp(writer, out, &ts);
+        memcpy(out + CELIX_FILE_WRITER_TIMESTAMP_SIZE, buffer, len);
+        writer->offset += lineSize;
+        writer->dirty = true;
+    } else {
+        writer->nrOfDroppedLogs += 1;
+    }
+    celixThreadMutex_unlock(&writer->mutex);
+}
+
+size_t celix_fileWriter_nrOfDroppedLogs(celix_file_writer_t* writer) {
+    celixThreadMutex_lock(&writer->mutex);
+    size_t dropped = writer->nrOfDroppedLogs;
+    celixThreadMutex_unlock(&writer->mutex);
+    return dropped;
+}
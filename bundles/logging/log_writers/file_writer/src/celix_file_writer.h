@@ -0,0 +1,107 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#ifndef CELIX_FILE_WRITER_H
+#define CELIX_FILE_WRITER_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#include "celix_log_level.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CELIX_FILE_WRITER_NAME_CONFIG_NAME                          "CELIX_FILE_WRITER_NAME"
+#define CELIX_FILE_WRITER_NAME_DEFAULT_VALUE                        "celix_file"
+
+#define CELIX_FILE_WRITER_PATH_CONFIG_NAME                          "CELIX_FILE_WRITER_PATH"
+#define CELIX_FILE_WRITER_PATH_DEFAULT_VALUE                        "celix.log"
+
+#define CELIX_FILE_WRITER_MAX_FILE_SIZE_CONFIG_NAME                 "CELIX_FILE_WRITER_MAX_FILE_SIZE"
+#define CELIX_FILE_WRITER_MAX_FILE_SIZE_DEFAULT_VALUE               (16 * 1024 * 1024)
+
+#define CELIX_FILE_WRITER_MAX_FILES_CONFIG_NAME                     "CELIX_FILE_WRITER_MAX_FILES"
+#define CELIX_FILE_WRITER_MAX_FILES_DEFAULT_VALUE                   5
+
+#define CELIX_FILE_WRITER_ROTATE_INTERVAL_CONFIG_NAME               "CELIX_FILE_WRITER_ROTATE_INTERVAL"
+#define CELIX_FILE_WRITER_ROTATE_INTERVAL_DEFAULT_VALUE             0
+
+#define CELIX_FILE_WRITER_SYNC_INTERVAL_CONFIG_NAME                 "CELIX_FILE_WRITER_SYNC_INTERVAL"
+#define CELIX_FILE_WRITER_SYNC_INTERVAL_DEFAULT_VALUE               1000
+
+#define CELIX_FILE_WRITER_LOG_LEVEL_CONFIG_NAME                     "CELIX_FILE_WRITER_LOG_LEVEL"
+#define CELIX_FILE_WRITER_LOG_LEVEL_DEFAULT_VALUE                   "trace"
+
+/**
+ * The maximum size of a log line, longer log lines are truncated.
+ */
+#define CELIX_FILE_WRITER_MAX_LINE_SIZE 4096
+
+/**
+ * A log file writer which appends log lines to a memory-mapped, pre-allocated log file.
+ *
+ * The log file is pre-allocated with maxFileSize bytes and mapped in memory, so that appending a log line is a
+ * memcpy under a mutex and not a syscall. When the log file is full or older than rotateIntervalInSeconds,
+ * the log file is truncated to the used size and rotated: <path> is renamed to <path>.1, <path>.1 to <path>.2, etc. and
+ * at most maxFiles rotated log files are kept.
+ * A sync thread writes the dirty log file pages back to disk every syncIntervalInMs ms.
+ *
+ * After a crash, the log file still has its pre-allocated size and a zero filled tail. When the log file is opened
+ * again, the tail is scanned to find the end of the last complete log line and logging is continued from there.
+ */
+typedef struct celix_file_writer celix_file_writer_t; //opaque
+
+typedef struct celix_file_writer_config {
+    const char* path;
+    size_t maxFileSize;
+    int maxFiles; //number of rotated log files to keep
+    long rotateIntervalInSeconds; //0 to only rotate if the log file is full
+    long syncIntervalInMs; //0 to leave syncing to the OS
+    celix_log_level_e logLevel; //the minimum log level of the logged log lines
+} celix_file_writer_config_t;
+
+/**
+ * Creates a file writer and opens (or recovers) the log file.
+ * @return The file writer or NULL if the log file cannot be opened. The error is pushed to celix_err.
+ */
+celix_file_writer_t* celix_fileWriter_create(const celix_file_writer_config_t* config);
+
+/**
+ * Destroys the file writer, the log file is synced and truncated to the used size.
+ */
+void celix_fileWriter_destroy(celix_file_writer_t* writer);
+
+/**
+ * Appends a log line to the log file. Can be used as celix_log_sink_t sinkLog function and can be called concurrently.
+ */
+void celix_fileWriter_sinkLog(void* handle, celix_log_level_e level, long logServiceId, const char* logServiceName,
+                              const char* file, const char* function, int line, const char* format, va_list formatArgs);
+
+/**
+ * Returns the number of log lines, which could not be written because the log file could not be (re)opened.
+ */
+size_t celix_fileWriter_nrOfDroppedLogs(celix_file_writer_t* writer);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif //CELIX_FILE_WRITER_H
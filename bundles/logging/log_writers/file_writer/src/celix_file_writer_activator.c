@@ -0,0 +1,73 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "celix_bundle_activator.h"
+#include "celix_file_writer.h"
+#include "celix_log_sink.h"
+#include "celix_log_level.h"
+
+typedef struct celix_file_writer_activator {
+    celix_file_writer_t* writer;
+    celix_log_sink_t logSinkSvc;
+    long logSinkSvcId;
+} celix_file_writer_activator_t;
+
+static celix_status_t celix_fileWriterActivator_start(celix_file_writer_activator_t* act, celix_bundle_context_t* ctx) {
+    celix_file_writer_config_t config;
+    config.path = celix_bundleContext_getProperty(ctx, CELIX_FILE_WRITER_PATH_CONFIG_NAME, CELIX_FILE_WRITER_PATH_DEFAULT_VALUE);
+    long maxFileSize = celix_bundleContext_getPropertyAsLong(ctx, CELIX_FILE_WRITER_MAX_FILE_SIZE_CONFIG_NAME, CELIX_FILE_WRITER_MAX_FILE_SIZE_DEFAULT_VALUE);
+    config.maxFileSize = maxFileSize > 0 ? (size_t)maxFileSize : 0;
+    config.maxFiles = (int)celix_bundleContext_getPropertyAsLong(ctx, CELIX_FILE_WRITER_MAX_FILES_CONFIG_NAME, CELIX_FILE_WRITER_MAX_FILES_DEFAULT_VALUE);
+    config.rotateIntervalInSeconds = celix_bundleContext_getPropertyAsLong(ctx, CELIX_FILE_WRITER_ROTATE_INTERVAL_CONFIG_NAME, CELIX_FILE_WRITER_ROTATE_INTERVAL_DEFAULT_VALUE);
+    config.syncIntervalInMs = celix_bundleContext_getPropertyAsLong(ctx, CELIX_FILE_WRITER_SYNC_INTERVAL_CONFIG_NAME, CELIX_FILE_WRITER_SYNC_INTERVAL_DEFAULT_VALUE);
+    const char* logLevel = celix_bundleContext_getProperty(ctx, CELIX_FILE_WRITER_LOG_LEVEL_CONFIG_NAME, CELIX_FILE_WRITER_LOG_LEVEL_DEFAULT_VALUE);
+    config.logLevel = celix_logLevel_fromString(logLevel, CELIX_LOG_LEVEL_TRACE);
+
+    act->writer = celix_fileWriter_create(&config);
+    if (act->writer == NULL) {
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+
+    act->logSinkSvc.handle = act->writer;
+    act->logSinkSvc.sinkLog = celix_fileWriter_sinkLog;
+
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    celix_properties_t* props = celix_properties_create();
+    celix_properties_set(props, CELIX_LOG_SINK_PROPERTY_NAME,
+                         celix_bundleContext_getProperty(ctx, CELIX_FILE_WRITER_NAME_CONFIG_NAME, CELIX_FILE_WRITER_NAME_DEFAULT_VALUE));
+    opts.serviceName = CELIX_LOG_SINK_NAME;
+    opts.serviceVersion = CELIX_LOG_SINK_VERSION;
+    opts.properties = props;
+    opts.svc = &act->logSinkSvc;
+    act->logSinkSvcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+    if (act->logSinkSvcId < 0) {
+        celix_fileWriter_destroy(act->writer);
+        act->writer = NULL;
+        return CELIX_BUNDLE_EXCEPTION;
+    }
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t celix_fileWriterActivator_stop(celix_file_writer_activator_t* act, celix_bundle_context_t* ctx) {
+    celix_bundleContext_unregisterService(ctx, act->logSinkSvcId);
+    celix_fileWriter_destroy(act->writer);
+    return CELIX_SUCCESS;
+}
+
+CELIX_GEN_BUNDLE_ACTIVATOR(celix_file_writer_activator_t, celix_fileWriterActivator_start, celix_fileWriterActivator_stop);
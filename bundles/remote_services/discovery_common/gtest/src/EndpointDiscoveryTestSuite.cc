@@ -0,0 +1,340 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+extern "C" {
+#include "discovery.h"
+#include "endpoint_discovery_poller.h"
+#include "endpoint_discovery_server.h"
+#include "endpoint_discovery_protocol.h"
+}
+#include "celix_constants.h"
+#include "celix_framework.h"
+#include "celix_framework_factory.h"
+#include "celix_properties.h"
+#include "remote_constants.h"
+#include "utils.h"
+
+namespace {
+    struct HttpResponse {
+        long code{0};
+        std::string etag{};
+        std::string delta{};
+        std::string removed{};
+        std::string body{};
+    };
+
+    size_t writeBody(char* data, size_t size, size_t nmemb, void* userdata) {
+        static_cast<std::string*>(userdata)->append(data, size * nmemb);
+        return size * nmemb;
+    }
+
+    size_t writeHeader(char* data, size_t size, size_t nmemb, void* userdata) {
+        auto* response = static_cast<HttpResponse*>(userdata);
+        std::string line{data, size * nmemb};
+        auto sep = line.find(':');
+        if (sep != std::string::npos) {
+            auto name = line.substr(0, sep);
+            auto value = line.substr(sep + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            value.erase(value.find_last_not_of("\r\n") + 1);
+            if (strcasecmp(name.c_str(), DISCOVERY_ETAG_HEADER) == 0) {
+                response->etag = value;
+            } else if (strcasecmp(name.c_str(), DISCOVERY_DELTA_HEADER) == 0) {
+                response->delta = value;
+            } else if (strcasecmp(name.c_str(), DISCOVERY_REMOVED_HEADER) == 0) {
+                response->removed = value;
+            }
+        }
+        return size * nmemb;
+    }
+
+    HttpResponse httpGet(const std::string& url) {
+        HttpResponse response{};
+        CURL* curl = curl_easy_init();
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeBody);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, writeHeader);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+        if (curl_easy_perform(curl) == CURLE_OK) {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.code);
+        }
+        curl_easy_cleanup(curl);
+        return response;
+    }
+
+    std::string unquote(const std::string& etag) {
+        return etag.size() >= 2 && etag.front() == '"' ? etag.substr(1, etag.size() - 2) : etag;
+    }
+
+    std::string epochOf(const std::string& etag) {
+        auto revision = unquote(etag);
+        return revision.substr(0, revision.find('-'));
+    }
+}
+
+class EndpointDiscoveryTestSuite : public ::testing::Test {
+public:
+    EndpointDiscoveryTestSuite() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".rsa_discovery_common_test_cache");
+        celix_properties_set(props, DISCOVERY_SERVER_IP, "127.0.0.1");
+        celix_properties_set(props, DISCOVERY_SERVER_PORT, "9970");
+        celix_properties_setBool(props, CELIX_DISCOVERY_BIND_ON_ALL_INTERFACES, false);
+        celix_properties_set(props, DISCOVERY_SERVER_MAX_WAIT, "5");
+        celix_properties_set(props, DISCOVERY_SERVER_THREADS, "4");
+        celix_properties_set(props, "DISCOVERY_CFG_POLL_INTERVAL", "1");
+        celix_properties_set(props, DISCOVERY_POLL_WAIT, "1");
+        fw = std::shared_ptr<celix_framework_t>{celix_frameworkFactory_createFramework(props), [](auto* f) {celix_frameworkFactory_destroyFramework(f);}};
+        ctx = celix_framework_getFrameworkContext(fw.get());
+
+        discovery = (discovery_t*)calloc(1, sizeof(*discovery));
+        discovery->context = ctx;
+        discovery->listenerReferences = hashMap_create(serviceReference_hashCode, nullptr, serviceReference_equals2, nullptr);
+        discovery->discoveredServices = hashMap_create(utils_stringHash, nullptr, utils_stringEquals, nullptr);
+        celixThreadMutex_create(&discovery->mutex, nullptr);
+        discovery->loghelper = celix_logHelper_create(ctx, "test_rsa_discovery_common");
+    }
+
+    ~EndpointDiscoveryTestSuite() override {
+        if (poller != nullptr) {
+            endpointDiscoveryPoller_destroy(poller);
+        }
+        if (server != nullptr) {
+            endpointDiscoveryServer_destroy(server);
+        }
+        for (auto* endpoint : endpoints) {
+            endpointDescription_destroy(endpoint);
+        }
+        hashMap_destroy(discovery->discoveredServices, false, false);
+        hashMap_destroy(discovery->listenerReferences, false, false);
+        celixThreadMutex_destroy(&discovery->mutex);
+        celix_logHelper_destroy(discovery->loghelper);
+        free(discovery);
+    }
+
+    void createServer() {
+        auto status = endpointDiscoveryServer_create(discovery, ctx, "org.apache.celix.test", "9970", "127.0.0.1", &server);
+        ASSERT_EQ(status, CELIX_SUCCESS);
+        char url[256];
+        ASSERT_EQ(endpointDiscoveryServer_getUrl(server, url, sizeof(url)), CELIX_SUCCESS);
+        serverUrl = url;
+    }
+
+    void destroyServer() {
+        endpointDiscoveryServer_destroy(server);
+        server = nullptr;
+    }
+
+    endpoint_description_t* createEndpoint(const char* endpointId) {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, CELIX_RSA_ENDPOINT_FRAMEWORK_UUID, "e7c2a8ab-79a8-40c5-a926-85ae64c9382a");
+        celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_NAME, "org.example.api.Foo");
+        celix_properties_set(props, CELIX_RSA_ENDPOINT_ID, endpointId);
+        celix_properties_set(props, CELIX_RSA_ENDPOINT_SERVICE_ID, "100");
+        endpoint_description_t* endpoint = nullptr;
+        EXPECT_EQ(endpointDescription_create(props, &endpoint), CELIX_SUCCESS);
+        endpoints.push_back(endpoint);
+        return endpoint;
+    }
+
+    bool isDiscovered(const char* endpointId) {
+        celixThreadMutex_lock(&discovery->mutex);
+        bool discovered = hashMap_containsKey(discovery->discoveredServices, endpointId);
+        celixThreadMutex_unlock(&discovery->mutex);
+        return discovered;
+    }
+
+    template<typename Predicate>
+    bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::seconds{10}) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return true;
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    celix_bundle_context_t* ctx{nullptr};
+    discovery_t* discovery{nullptr};
+    endpoint_discovery_server_t* server{nullptr};
+    endpoint_discovery_poller_t* poller{nullptr};
+    std::string serverUrl{};
+    std::vector<endpoint_description_t*> endpoints{};
+};
+
+TEST_F(EndpointDiscoveryTestSuite, ServerEpochChangesOnRestart) {
+    createServer();
+    auto first = httpGet(serverUrl);
+    EXPECT_EQ(first.code, 200);
+    ASSERT_FALSE(first.etag.empty());
+    destroyServer();
+
+    //a restart within the same second must result in another epoch
+    createServer();
+    auto second = httpGet(serverUrl);
+    EXPECT_EQ(second.code, 200);
+    ASSERT_FALSE(second.etag.empty());
+    EXPECT_NE(epochOf(first.etag), epochOf(second.etag));
+
+    //a revision of the previous server instance results in a full response
+    auto full = httpGet(serverUrl + "?" DISCOVERY_SINCE_QUERY_PARAM "=" + unquote(first.etag));
+    EXPECT_EQ(full.code, 200);
+    EXPECT_TRUE(full.delta.empty());
+}
+
+TEST_F(EndpointDiscoveryTestSuite, ServerReturnsDeltaSinceKnownRevision) {
+    createServer();
+    auto* endpoint1 = createEndpoint("endpoint-1");
+    auto* endpoint2 = createEndpoint("endpoint-2");
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, endpoint1), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, endpoint2), CELIX_SUCCESS);
+
+    auto full = httpGet(serverUrl);
+    EXPECT_EQ(full.code, 200);
+    EXPECT_TRUE(full.delta.empty());
+    EXPECT_NE(full.body.find("endpoint-1"), std::string::npos);
+    EXPECT_NE(full.body.find("endpoint-2"), std::string::npos);
+
+    auto* endpoint3 = createEndpoint("endpoint-3");
+    EXPECT_EQ(endpointDiscoveryServer_removeEndpoint(server, endpoint1), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, endpoint3), CELIX_SUCCESS);
+
+    auto delta = httpGet(serverUrl + "?" DISCOVERY_SINCE_QUERY_PARAM "=" + unquote(full.etag));
+    EXPECT_EQ(delta.code, 200);
+    EXPECT_EQ(delta.delta, "true");
+    EXPECT_EQ(delta.removed, "endpoint-1");
+    EXPECT_EQ(delta.body.find("endpoint-2"), std::string::npos);
+    EXPECT_NE(delta.body.find("endpoint-3"), std::string::npos);
+    EXPECT_EQ(epochOf(delta.etag), epochOf(full.etag));
+    EXPECT_NE(delta.etag, full.etag);
+}
+
+TEST_F(EndpointDiscoveryTestSuite, LongPollTimesOutWithNotModified) {
+    createServer();
+    auto full = httpGet(serverUrl);
+    ASSERT_EQ(full.code, 200);
+
+    auto start = std::chrono::steady_clock::now();
+    auto notModified = httpGet(serverUrl + "?" DISCOVERY_SINCE_QUERY_PARAM "=" + unquote(full.etag) + "&" DISCOVERY_WAIT_QUERY_PARAM "=1");
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(notModified.code, 304);
+    EXPECT_EQ(notModified.etag, full.etag);
+    EXPECT_GE(elapsed, std::chrono::milliseconds{900});
+}
+
+TEST_F(EndpointDiscoveryTestSuite, LongPollReturnsOnChange) {
+    createServer();
+    auto full = httpGet(serverUrl);
+    ASSERT_EQ(full.code, 200);
+
+    auto start = std::chrono::steady_clock::now();
+    auto pending = std::async(std::launch::async, [this, &full] {
+        return httpGet(serverUrl + "?" DISCOVERY_SINCE_QUERY_PARAM "=" + unquote(full.etag) + "&" DISCOVERY_WAIT_QUERY_PARAM "=5");
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, createEndpoint("endpoint-1")), CELIX_SUCCESS);
+
+    auto changed = pending.get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(changed.code, 200);
+    EXPECT_EQ(changed.delta, "true");
+    EXPECT_NE(changed.body.find("endpoint-1"), std::string::npos);
+    EXPECT_LT(elapsed, std::chrono::seconds{5});
+}
+
+TEST_F(EndpointDiscoveryTestSuite, LongPollsDoNotBlockAllServerThreads) {
+    createServer();
+    auto full = httpGet(serverUrl);
+    ASSERT_EQ(full.code, 200);
+
+    //more long-polls than server threads, only half of the threads may be blocked
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::chrono::steady_clock::duration>> pending{};
+    for (int i = 0; i < 6; ++i) {
+        pending.emplace_back(std::async(std::launch::async, [this, &full, start] {
+            auto response = httpGet(serverUrl + "?" DISCOVERY_SINCE_QUERY_PARAM "=" + unquote(full.etag) + "&" DISCOVERY_WAIT_QUERY_PARAM "=3");
+            EXPECT_EQ(response.code, 304);
+            return std::chrono::steady_clock::now() - start;
+        }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+
+    auto fetch = httpGet(serverUrl);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(fetch.code, 200);
+    EXPECT_LT(elapsed, std::chrono::seconds{2});
+
+    int blocked = 0;
+    for (auto& f : pending) {
+        if (f.get() >= std::chrono::milliseconds{2900}) {
+            ++blocked;
+        }
+    }
+    EXPECT_EQ(blocked, 2);
+}
+
+TEST_F(EndpointDiscoveryTestSuite, PollerAppliesDeltas) {
+    createServer();
+    auto* endpoint1 = createEndpoint("endpoint-1");
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, endpoint1), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, createEndpoint("endpoint-2")), CELIX_SUCCESS);
+
+    ASSERT_EQ(endpointDiscoveryPoller_create(discovery, ctx, "", &poller), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryPoller_addDiscoveryEndpoint(poller, (char*)serverUrl.c_str()), CELIX_SUCCESS);
+    EXPECT_TRUE(waitFor([this] { return isDiscovered("endpoint-1") && isDiscovered("endpoint-2"); }));
+
+    //the poller is long-polling, so the changes are received as delta
+    EXPECT_EQ(endpointDiscoveryServer_removeEndpoint(server, endpoint1), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, createEndpoint("endpoint-3")), CELIX_SUCCESS);
+    EXPECT_TRUE(waitFor([this] { return !isDiscovered("endpoint-1") && isDiscovered("endpoint-3"); }));
+    EXPECT_TRUE(isDiscovered("endpoint-2"));
+}
+
+TEST_F(EndpointDiscoveryTestSuite, PollerFallsBackToFullResponseAfterServerRestart) {
+    createServer();
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, createEndpoint("endpoint-1")), CELIX_SUCCESS);
+
+    ASSERT_EQ(endpointDiscoveryPoller_create(discovery, ctx, "", &poller), CELIX_SUCCESS);
+    EXPECT_EQ(endpointDiscoveryPoller_addDiscoveryEndpoint(poller, (char*)serverUrl.c_str()), CELIX_SUCCESS);
+    EXPECT_TRUE(waitFor([this] { return isDiscovered("endpoint-1"); }));
+
+    //the restarted server has the same revision count, but another epoch; the poller must not apply it as delta
+    auto url = serverUrl;
+    destroyServer();
+    createServer();
+    ASSERT_EQ(serverUrl, url);
+    EXPECT_EQ(endpointDiscoveryServer_addEndpoint(server, createEndpoint("endpoint-2")), CELIX_SUCCESS);
+    EXPECT_TRUE(waitFor([this] { return !isDiscovered("endpoint-1") && isDiscovered("endpoint-2"); }));
+}
@@ -46,6 +46,9 @@
 #define DISCOVERY_SERVER_PATH       "DISCOVERY_CFG_SERVER_PATH"
 #define DISCOVERY_POLL_ENDPOINTS    "DISCOVERY_CFG_POLL_ENDPOINTS"
 #define DISCOVERY_SERVER_MAX_EP     "DISCOVERY_CFG_SERVER_MAX_EP"
+#define DISCOVERY_SERVER_THREADS    "DISCOVERY_CFG_SERVER_THREADS"
+#define DISCOVERY_SERVER_MAX_WAIT   "DISCOVERY_CFG_SERVER_MAX_WAIT"
+#define DISCOVERY_POLL_WAIT         "DISCOVERY_CFG_POLL_WAIT"
 
 /**
  * @brief Remote Service Admin Discovery environment property (named "CELIX_DISCOVERY_BIND_ON_ALL_INTERFACES") which specifies
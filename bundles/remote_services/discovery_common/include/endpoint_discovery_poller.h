@@ -46,6 +46,8 @@ struct endpoint_discovery_poller {
 
     unsigned int poll_interval;
     unsigned int poll_timeout;
+    unsigned int poll_wait; // long-poll wait time in seconds, 0 if long-polling is disabled
+    unsigned long nextEntryId;
 
     volatile bool running;
 };
@@ -28,16 +28,19 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 #include <curl/curl.h>
 
 #include "bundle_context.h"
 #include "celix_log_helper.h"
+#include "celix_string_hash_map.h"
 #include "celix_utils.h"
 #include "utils.h"
 
 #include "endpoint_descriptor_reader.h"
+#include "endpoint_discovery_protocol.h"
 #include "discovery.h"
 
 
@@ -47,11 +50,45 @@
 #define DISCOVERY_POLL_TIMEOUT "DISCOVERY_CFG_POLL_TIMEOUT"
 #define DEFAULT_POLL_TIMEOUT "10" // seconds
 
+#define DEFAULT_POLL_WAIT 20 // seconds
+
+// defines how long (in ms) the poller thread waits for poll responses before checking for new work
+#define POLLER_WAIT_TIME_MS 100
+
+struct MemoryStruct {
+	char *memory;
+	size_t size;
+};
+
+typedef struct endpoint_discovery_poller_entry {
+    unsigned long id; // unique id, used to detect that an url is removed (and re-added) during a poll request
+    celix_string_hash_map_t* endpoints; // key = endpoint id, value = endpoint_description_t*
+    char* revision; // ETag of the last response, NULL if the discovery server does not support revisions
+    bool polling; // whether a poll request of the poller thread is in progress
+    struct timespec nextPoll;
+} endpoint_discovery_poller_entry_t;
+
+typedef struct endpoint_discovery_poller_response {
+    struct MemoryStruct body;
+    char* etag;
+    bool delta;
+    char* removed; // comma separated list of removed endpoint ids
+} endpoint_discovery_poller_response_t;
+
+typedef struct endpoint_discovery_poller_request {
+    char* url;
+    unsigned long entryId;
+    bool longPoll;
+    struct timespec start;
+    CURL* curl;
+    endpoint_discovery_poller_response_t response;
+} endpoint_discovery_poller_request_t;
+
 static void *endpointDiscoveryPoller_performPeriodicPoll(void *data);
-celix_status_t endpointDiscoveryPoller_poll(endpoint_discovery_poller_t *poller, char *url, celix_array_list_t* currentEndpoints);
-static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, celix_array_list_t** updatedEndpoints);
-static bool endpointDiscoveryPoller_endpointDescriptionEquals(celix_array_list_entry_t endpointEntry,
-                                                              celix_array_list_entry_t compareEntry);
+static endpoint_discovery_poller_request_t* endpointDiscoveryPoller_createRequest(endpoint_discovery_poller_t *poller, const char *url, endpoint_discovery_poller_entry_t* entry);
+static void endpointDiscoveryPoller_destroyRequest(endpoint_discovery_poller_request_t* request);
+static void endpointDiscoveryPoller_scheduleNextPoll(endpoint_discovery_poller_t* poller, endpoint_discovery_poller_entry_t* entry, celix_status_t status, endpoint_discovery_poller_request_t* request);
+static celix_status_t endpointDiscoveryPoller_processResponse(endpoint_discovery_poller_t *poller, endpoint_discovery_poller_entry_t* entry, CURLcode res, endpoint_discovery_poller_request_t* request);
 
 /**
  * Allocates memory and initializes a new endpoint_discovery_poller instance.
@@ -93,8 +130,11 @@ celix_status_t endpointDiscoveryPoller_create(discovery_t *discovery, celix_bund
 
 	(*poller)->poll_interval = atoi(interval);
 	(*poller)->poll_timeout = atoi(timeout);
+	long wait = celix_bundleContext_getPropertyAsLong(context, DISCOVERY_POLL_WAIT, DEFAULT_POLL_WAIT);
+	(*poller)->poll_wait = wait > 0 ? (unsigned int)wait : 0;
 	(*poller)->discovery = discovery;
 	(*poller)->running = false;
+	(*poller)->nextEntryId = 1;
 	(*poller)->entries = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
 
 	const char* sep = ",";
@@ -183,6 +223,7 @@ celix_status_t endpointDiscoveryPoller_getDiscoveryEndpoints(endpoint_discovery_
 
 /**
  * Adds a new endpoint URL to the list of polled endpoints.
+ * The endpoint URL is not polled by the caller, the poller thread polls a new endpoint URL on its next iteration.
  */
 celix_status_t endpointDiscoveryPoller_addDiscoveryEndpoint(endpoint_discovery_poller_t* poller, char* url) {
     celix_status_t status;
@@ -193,22 +234,27 @@ celix_status_t endpointDiscoveryPoller_addDiscoveryEndpoint(endpoint_discovery_p
     }
 
     // Avoid memory leaks when adding an already existing URL...
-    celix_array_list_t* endpoints = hashMap_get(poller->entries, url);
-    if (endpoints == NULL) {
-        celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
-        opts.equalsCallback = endpointDiscoveryPoller_endpointDescriptionEquals;
-        endpoints = celix_arrayList_createWithOptions(&opts);
+    endpoint_discovery_poller_entry_t* entry = hashMap_get(poller->entries, url);
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+        if (entry) {
+            entry->endpoints = celix_stringHashMap_create();
+        }
 
-        if (endpoints) {
+        if (entry && entry->endpoints) {
             celix_logHelper_debug(*poller->loghelper, "ENDPOINT_POLLER: add new discovery endpoint with url %s", url);
-            hashMap_put(poller->entries, strdup(url), endpoints);
-            endpointDiscoveryPoller_poll(poller, url, endpoints);
+            entry->id = poller->nextEntryId++;
+            entry->nextPoll = celixThreadCondition_getTime();
+            hashMap_put(poller->entries, strdup(url), entry);
+        } else {
+            free(entry);
+            status = CELIX_ENOMEM;
         }
     }
 
-    status = celixThreadMutex_unlock(&poller->pollerLock);
+    celix_status_t unlockStatus = celixThreadMutex_unlock(&poller->pollerLock);
 
-    return status;
+    return status != CELIX_SUCCESS ? status : unlockStatus;
 }
 
 /**
@@ -232,16 +278,17 @@ celix_status_t endpointDiscoveryPoller_removeDiscoveryEndpoint(endpoint_discover
 
             celix_logHelper_debug(*poller->loghelper, "ENDPOINT_POLLER: remove discovery endpoint with url %s", url);
 
-            celix_array_list_t* entries = hashMap_remove(poller->entries, url);
+            endpoint_discovery_poller_entry_t* entry = hashMap_remove(poller->entries, url);
 
-            if (entries != NULL) {
-                for (unsigned int i = celix_arrayList_size(entries); i > 0; i--) {
-                    endpoint_description_t* endpoint = celix_arrayList_get(entries, i - 1);
+            if (entry != NULL) {
+                CELIX_STRING_HASH_MAP_ITERATE(entry->endpoints, iter) {
+                    endpoint_description_t* endpoint = iter.value.ptrValue;
                     discovery_removeDiscoveredEndpoint(poller->discovery, endpoint);
-                    celix_arrayList_removeAt(entries, i - 1);
                     endpointDescription_destroy(endpoint);
                 }
-                celix_arrayList_destroy(entries);
+                celix_stringHashMap_destroy(entry->endpoints);
+                free(entry->revision);
+                free(entry);
             }
 
             free(origKey);
@@ -252,93 +299,228 @@ celix_status_t endpointDiscoveryPoller_removeDiscoveryEndpoint(endpoint_discover
     return status;
 }
 
-celix_status_t
-endpointDiscoveryPoller_poll(endpoint_discovery_poller_t* poller, char* url, celix_array_list_t* currentEndpoints) {
-    // create an arraylist with a custom equality test to ensure we can find endpoints properly...
-    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
-    opts.equalsCallback = endpointDiscoveryPoller_endpointDescriptionEquals;
-    celix_array_list_t* updatedEndpoints = celix_arrayList_createWithOptions(&opts);
+static void endpointDiscoveryPoller_addEndpoint(endpoint_discovery_poller_t* poller, endpoint_discovery_poller_entry_t* entry, endpoint_description_t* endpoint) {
+    if (celix_stringHashMap_hasKey(entry->endpoints, endpoint->id)) {
+        endpointDescription_destroy(endpoint);
+        return;
+    }
+    if (celix_stringHashMap_put(entry->endpoints, endpoint->id, endpoint) != CELIX_SUCCESS) {
+        celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: unable to add endpoint %s", endpoint->id);
+        endpointDescription_destroy(endpoint);
+        return;
+    }
+    discovery_addDiscoveredEndpoint(poller->discovery, endpoint);
+}
+
+static void endpointDiscoveryPoller_removeEndpoint(endpoint_discovery_poller_t* poller, endpoint_discovery_poller_entry_t* entry, const char* endpointId) {
+    endpoint_description_t* endpoint = celix_stringHashMap_get(entry->endpoints, endpointId);
+    if (endpoint != NULL) {
+        discovery_removeDiscoveredEndpoint(poller->discovery, endpoint);
+        celix_stringHashMap_remove(entry->endpoints, endpointId);
+        endpointDescription_destroy(endpoint);
+    }
+}
+
+/**
+ * Applies a poll response to the discovered endpoints of a discovery endpoint url.
+ * A delta response contains the added endpoints and the ids of the removed endpoints, otherwise the response
+ * contains all endpoints and the current endpoints are diffed against the response.
+ */
+static celix_status_t endpointDiscoveryPoller_processResponse(endpoint_discovery_poller_t *poller, endpoint_discovery_poller_entry_t* entry, CURLcode res, endpoint_discovery_poller_request_t* request) {
+    long httpCode = 0;
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(request->curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    }
+    if (res != CURLE_OK) {
+        celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: unable to read endpoints from %s, reason: %s", request->url, curl_easy_strerror(res));
+        return CELIX_ILLEGAL_STATE;
+    } else if (httpCode == 304) {
+        return CELIX_SUCCESS;
+    } else if (httpCode != 200) {
+        celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: unable to read endpoints from %s, http status %li", request->url, httpCode);
+        return CELIX_ILLEGAL_STATE;
+    }
+
+    celix_array_list_t* updatedEndpoints = celix_arrayList_create();
     if (!updatedEndpoints) {
         return CELIX_ENOMEM;
     }
 
-    celix_status_t status = endpointDiscoveryPoller_getEndpoints(poller, url, &updatedEndpoints);
+    // process endpoints file
+    endpoint_descriptor_reader_t *reader = NULL;
+    celix_status_t status = endpointDescriptorReader_create(poller, &reader);
     if (status == CELIX_SUCCESS) {
-        for (int i = celix_arrayList_size(currentEndpoints); i > 0; i--) {
-            endpoint_description_t* endpoint = celix_arrayList_get(currentEndpoints, i - 1);
-
-            celix_array_list_entry_t entry;
-            memset(&entry, 0, sizeof(entry));
-            entry.voidPtrVal = endpoint;
+        status = endpointDescriptorReader_parseDocument(reader, request->response.body.memory, &updatedEndpoints);
+    }
+    if (reader) {
+        endpointDescriptorReader_destroy(reader);
+    }
 
-            if (celix_arrayList_indexOf(updatedEndpoints, entry) < 0) {
-                status = discovery_removeDiscoveredEndpoint(poller->discovery, endpoint);
-                celix_arrayList_removeAt(currentEndpoints, i - 1);
-                endpointDescription_destroy(endpoint);
-            }
+    if (status == CELIX_SUCCESS && request->response.delta) {
+        char* savePtr = NULL;
+        char* endpointId = request->response.removed == NULL ? NULL : strtok_r(request->response.removed, ",", &savePtr);
+        while (endpointId != NULL) {
+            endpointDiscoveryPoller_removeEndpoint(poller, entry, celix_utils_trimInPlace(endpointId));
+            endpointId = strtok_r(NULL, ",", &savePtr);
         }
-
-        for (int i = 0; i < celix_arrayList_size(updatedEndpoints); i++) {
+    } else if (status == CELIX_SUCCESS) {
+        celix_string_hash_map_t* updatedIds = celix_stringHashMap_create();
+        if (updatedIds == NULL) {
+            status = CELIX_ENOMEM;
+        }
+        for (int i = 0; updatedIds != NULL && i < celix_arrayList_size(updatedEndpoints); i++) {
             endpoint_description_t* endpoint = celix_arrayList_get(updatedEndpoints, i);
-            celix_array_list_entry_t entry;
-            memset(&entry, 0, sizeof(entry));
-            entry.voidPtrVal = endpoint;
-            if (celix_arrayList_indexOf(currentEndpoints, entry) < 0) {
-                celix_arrayList_add(currentEndpoints, endpoint);
-                status = discovery_addDiscoveredEndpoint(poller->discovery, endpoint);
-            } else {
-                endpointDescription_destroy(endpoint);
+            if (celix_stringHashMap_putBool(updatedIds, endpoint->id, true) != CELIX_SUCCESS) {
+                status = CELIX_ENOMEM;
+                break;
             }
         }
+        if (status == CELIX_SUCCESS) {
+            celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(entry->endpoints);
+            while (!celix_stringHashMapIterator_isEnd(&iter)) {
+                if (celix_stringHashMap_hasKey(updatedIds, iter.key)) {
+                    celix_stringHashMapIterator_next(&iter);
+                } else {
+                    endpoint_description_t* endpoint = iter.value.ptrValue;
+                    discovery_removeDiscoveredEndpoint(poller->discovery, endpoint);
+                    celix_stringHashMapIterator_remove(&iter);
+                    endpointDescription_destroy(endpoint);
+                }
+            }
+        }
+        celix_stringHashMap_destroy(updatedIds);
     }
 
-    if (updatedEndpoints) {
-        celix_arrayList_destroy(updatedEndpoints);
+    for (int i = 0; i < celix_arrayList_size(updatedEndpoints); i++) {
+        endpoint_description_t* endpoint = celix_arrayList_get(updatedEndpoints, i);
+        if (status == CELIX_SUCCESS) {
+            endpointDiscoveryPoller_addEndpoint(poller, entry, endpoint);
+        } else {
+            endpointDescription_destroy(endpoint);
+        }
+    }
+    celix_arrayList_destroy(updatedEndpoints);
+
+    if (status == CELIX_SUCCESS) {
+        free(entry->revision);
+        entry->revision = celix_steal_ptr(request->response.etag);
     }
 
     return status;
 }
 
+static void endpointDiscoveryPoller_scheduleNextPoll(endpoint_discovery_poller_t* poller, endpoint_discovery_poller_entry_t* entry, celix_status_t status, endpoint_discovery_poller_request_t* request) {
+    if (status != CELIX_SUCCESS || entry->revision == NULL || poller->poll_wait == 0) {
+        entry->nextPoll = celixThreadCondition_getDelayedTime(poller->poll_interval);
+    } else if (request != NULL && request->longPoll) {
+        // immediately poll again, unless the server did not block the request for the requested wait time.
+        entry->nextPoll = celix_delayedTimespec(&request->start, poller->poll_wait);
+        long httpCode = 0;
+        curl_easy_getinfo(request->curl, CURLINFO_RESPONSE_CODE, &httpCode);
+        if (httpCode == 200) {
+            entry->nextPoll = celixThreadCondition_getTime();
+        }
+    } else {
+        entry->nextPoll = celixThreadCondition_getTime();
+    }
+}
+
+static void endpointDiscoveryPoller_startRequests(endpoint_discovery_poller_t* poller, CURLM* multi, celix_array_list_t* requests) {
+    struct timespec now = celixThreadCondition_getTime();
+    hash_map_iterator_t iter = hashMapIterator_construct(poller->entries);
+    while (hashMapIterator_hasNext(&iter)) {
+        hash_map_entry_pt mapEntry = hashMapIterator_nextEntry(&iter);
+        const char* url = hashMapEntry_getKey(mapEntry);
+        endpoint_discovery_poller_entry_t* entry = hashMapEntry_getValue(mapEntry);
+        if (entry->polling || celix_compareTime(&now, &entry->nextPoll) < 0) {
+            continue;
+        }
+        endpoint_discovery_poller_request_t* request = endpointDiscoveryPoller_createRequest(poller, url, entry);
+        if (request == NULL || celix_arrayList_add(requests, request) != CELIX_SUCCESS) {
+            endpointDiscoveryPoller_destroyRequest(request);
+            entry->nextPoll = celixThreadCondition_getDelayedTime(poller->poll_interval);
+            continue;
+        }
+        if (curl_multi_add_handle(multi, request->curl) != CURLM_OK) {
+            celix_arrayList_remove(requests, request);
+            endpointDiscoveryPoller_destroyRequest(request);
+            entry->nextPoll = celixThreadCondition_getDelayedTime(poller->poll_interval);
+            continue;
+        }
+        entry->polling = true;
+    }
+}
+
+static void endpointDiscoveryPoller_finishRequest(endpoint_discovery_poller_t* poller, CURLM* multi, celix_array_list_t* requests, endpoint_discovery_poller_request_t* request, CURLcode res) {
+    curl_multi_remove_handle(multi, request->curl);
+    celix_arrayList_remove(requests, request);
+
+    celixThreadMutex_lock(&poller->pollerLock);
+    endpoint_discovery_poller_entry_t* entry = hashMap_get(poller->entries, request->url);
+    // the discovery endpoint url can be removed (and re-added) during the poll request
+    if (entry != NULL && entry->id == request->entryId) {
+        celix_status_t status = endpointDiscoveryPoller_processResponse(poller, entry, res, request);
+        entry->polling = false;
+        endpointDiscoveryPoller_scheduleNextPoll(poller, entry, status, request);
+    }
+    celixThreadMutex_unlock(&poller->pollerLock);
+
+    endpointDiscoveryPoller_destroyRequest(request);
+}
+
 static void* endpointDiscoveryPoller_performPeriodicPoll(void* data) {
     endpoint_discovery_poller_t* poller = (endpoint_discovery_poller_t*)data;
 
-    useconds_t interval = (useconds_t)(poller->poll_interval * 1000000L);
+    CURLM* multi = curl_multi_init();
+    celix_array_list_t* requests = celix_arrayList_create();
+    if (multi == NULL || requests == NULL) {
+        celix_logHelper_error(*poller->loghelper, "ENDPOINT_POLLER: failed to create the poller state, discovery endpoints are not polled.");
+        celix_arrayList_destroy(requests);
+        if (multi != NULL) {
+            curl_multi_cleanup(multi);
+        }
+        return NULL;
+    }
 
     while (poller->running) {
-        usleep(interval);
         celix_status_t status = celixThreadMutex_lock(&poller->pollerLock);
-
         if (status != CELIX_SUCCESS) {
             celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: failed to obtain lock; retrying...");
         } else {
-            hash_map_iterator_pt iterator = hashMapIterator_create(poller->entries);
-
-            while (hashMapIterator_hasNext(iterator)) {
-                hash_map_entry_pt entry = hashMapIterator_nextEntry(iterator);
+            endpointDiscoveryPoller_startRequests(poller, multi, requests);
+            celixThreadMutex_unlock(&poller->pollerLock);
+        }
 
-                char* url = hashMapEntry_getKey(entry);
-                celix_array_list_t* currentEndpoints = hashMapEntry_getValue(entry);
+        int runningRequests = 0;
+        curl_multi_perform(multi, &runningRequests);
+        curl_multi_wait(multi, NULL, 0, POLLER_WAIT_TIME_MS, NULL);
+        curl_multi_perform(multi, &runningRequests);
 
-                endpointDiscoveryPoller_poll(poller, url, currentEndpoints);
+        int msgsInQueue = 0;
+        CURLMsg* msg = NULL;
+        while ((msg = curl_multi_info_read(multi, &msgsInQueue)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            endpoint_discovery_poller_request_t* request = NULL;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&request);
+            if (request != NULL) {
+                endpointDiscoveryPoller_finishRequest(poller, multi, requests, request, msg->data.result);
             }
-
-            hashMapIterator_destroy(iterator);
         }
+    }
 
-        status = celixThreadMutex_unlock(&poller->pollerLock);
-        if (status != CELIX_SUCCESS) {
-            celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: failed to release lock; retrying...");
-        }
+    for (int i = 0; i < celix_arrayList_size(requests); ++i) {
+        endpoint_discovery_poller_request_t* request = celix_arrayList_get(requests, i);
+        curl_multi_remove_handle(multi, request->curl);
+        endpointDiscoveryPoller_destroyRequest(request);
     }
+    celix_arrayList_destroy(requests);
+    curl_multi_cleanup(multi);
 
     return NULL;
 }
 
-struct MemoryStruct {
-	char *memory;
-	size_t size;
-};
-
 static size_t endpointDiscoveryPoller_writeMemory(void *contents, size_t size, size_t nmemb, void *memoryPtr) {
 	size_t realsize = size * nmemb;
 	struct MemoryStruct *mem = (struct MemoryStruct *)memoryPtr;
@@ -357,59 +539,112 @@ static size_t endpointDiscoveryPoller_writeMemory(void *contents, size_t size, s
 	return realsize;
 }
 
-static celix_status_t endpointDiscoveryPoller_getEndpoints(endpoint_discovery_poller_t *poller, char *url, celix_array_list_t** updatedEndpoints) {
-	celix_status_t status = CELIX_SUCCESS;
-
-
-	CURL *curl = NULL;
-	CURLcode res = CURLE_OK;
-
-	struct MemoryStruct chunk;
-	chunk.memory = malloc(1);
-	chunk.size = 0;
-
-	curl = curl_easy_init();
-	if (!curl) {
-		status = CELIX_ILLEGAL_STATE;
-	} else {
-		curl_easy_setopt(curl, CURLOPT_URL, url);
-		curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
-		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, endpointDiscoveryPoller_writeMemory);
-		curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
-		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
-		curl_easy_setopt(curl, CURLOPT_TIMEOUT, poller->poll_timeout);
-		res = curl_easy_perform(curl);
-
-		curl_easy_cleanup(curl);
-	}
+static char* endpointDiscoveryPoller_getHeaderValue(const char* header, size_t headerLen, const char* name) {
+    size_t nameLen = strlen(name);
+    if (headerLen <= nameLen || strncasecmp(header, name, nameLen) != 0 || header[nameLen] != ':') {
+        return NULL;
+    }
+    char* value = strndup(header + nameLen + 1, headerLen - nameLen - 1);
+    if (value != NULL) {
+        celix_utils_trimInPlace(value);
+    }
+    return value;
+}
 
-	// process endpoints file
-	if (res == CURLE_OK) {
-		endpoint_descriptor_reader_t *reader = NULL;
+static size_t endpointDiscoveryPoller_writeHeader(char *buffer, size_t size, size_t nitems, void *responsePtr) {
+    size_t realsize = size * nitems;
+    endpoint_discovery_poller_response_t* response = responsePtr;
+
+    char* value = NULL;
+    if ((value = endpointDiscoveryPoller_getHeaderValue(buffer, realsize, DISCOVERY_ETAG_HEADER)) != NULL) {
+        free(response->etag);
+        response->etag = value;
+    } else if ((value = endpointDiscoveryPoller_getHeaderValue(buffer, realsize, DISCOVERY_DELTA_HEADER)) != NULL) {
+        response->delta = celix_utils_stringEquals(value, "true");
+        free(value);
+    } else if ((value = endpointDiscoveryPoller_getHeaderValue(buffer, realsize, DISCOVERY_REMOVED_HEADER)) != NULL) {
+        free(response->removed);
+        response->removed = value;
+    }
 
-		status = endpointDescriptorReader_create(poller, &reader);
-		if (status == CELIX_SUCCESS) {
-			status = endpointDescriptorReader_parseDocument(reader, chunk.memory, updatedEndpoints);
-		}
+    return realsize;
+}
 
-		if (reader) {
-			endpointDescriptorReader_destroy(reader);
-		}
-	} else {
-        celix_logHelper_warning(*poller->loghelper, "ENDPOINT_POLLER: unable to read endpoints from %s, reason: %s", url, curl_easy_strerror(res));
-	}
+/**
+ * Creates a poll request for a discovery endpoint url. If an entry with a known revision is provided, only the changes
+ * since the revision are requested and the request is a long-poll request (if enabled).
+ */
+static endpoint_discovery_poller_request_t* endpointDiscoveryPoller_createRequest(endpoint_discovery_poller_t *poller, const char *url, endpoint_discovery_poller_entry_t* entry) {
+    endpoint_discovery_poller_request_t* request = calloc(1, sizeof(*request));
+    if (request == NULL) {
+        return NULL;
+    }
+    request->start = celixThreadCondition_getTime();
+    request->response.body.memory = calloc(1, 1);
+    request->response.body.size = 0;
+    request->curl = curl_easy_init();
+
+    if (entry != NULL && entry->revision != NULL) {
+        // strip the quotes of the ETag
+        const char* revision = entry->revision[0] == '"' ? entry->revision + 1 : entry->revision;
+        size_t revisionLen = strlen(revision);
+        if (revisionLen > 0 && revision[revisionLen - 1] == '"') {
+            revisionLen -= 1;
+        }
+        request->longPoll = poller->poll_wait > 0;
+        char waitParam[32] = "";
+        if (request->longPoll) {
+            (void)snprintf(waitParam, sizeof(waitParam), "&" DISCOVERY_WAIT_QUERY_PARAM "=%u", poller->poll_wait);
+        }
+        if (asprintf(&request->url, "%s%s" DISCOVERY_SINCE_QUERY_PARAM "=%.*s%s", url, strchr(url, '?') == NULL ? "?" : "&",
+                     (int)revisionLen, revision, waitParam) < 0) {
+            request->url = NULL;
+        }
+        request->entryId = entry->id;
+    } else {
+        request->url = celix_utils_strdup(url);
+        request->entryId = entry != NULL ? entry->id : 0;
+    }
 
-	// clean up endpoints file
-	if (chunk.memory) {
-		free(chunk.memory);
-	}
+    if (request->url == NULL || request->curl == NULL || request->response.body.memory == NULL) {
+        endpointDiscoveryPoller_destroyRequest(request);
+        return NULL;
+    }
 
-	return status;
+    // the (base) url is used to lookup the entry when the request is finished
+    if (entry != NULL && entry->revision != NULL) {
+        char* requestUrl = request->url;
+        request->url = celix_utils_strdup(url);
+        curl_easy_setopt(request->curl, CURLOPT_URL, requestUrl);
+        free(requestUrl);
+        if (request->url == NULL) {
+            endpointDiscoveryPoller_destroyRequest(request);
+            return NULL;
+        }
+    } else {
+        curl_easy_setopt(request->curl, CURLOPT_URL, request->url);
+    }
+    curl_easy_setopt(request->curl, CURLOPT_NOSIGNAL, 1);
+    curl_easy_setopt(request->curl, CURLOPT_WRITEFUNCTION, endpointDiscoveryPoller_writeMemory);
+    curl_easy_setopt(request->curl, CURLOPT_WRITEDATA, (void *)&request->response.body);
+    curl_easy_setopt(request->curl, CURLOPT_HEADERFUNCTION, endpointDiscoveryPoller_writeHeader);
+    curl_easy_setopt(request->curl, CURLOPT_HEADERDATA, (void *)&request->response);
+    curl_easy_setopt(request->curl, CURLOPT_PRIVATE, (void *)request);
+    curl_easy_setopt(request->curl, CURLOPT_CONNECTTIMEOUT, 5L);
+    curl_easy_setopt(request->curl, CURLOPT_TIMEOUT, (long)(poller->poll_timeout + (request->longPoll ? poller->poll_wait : 0)));
+
+    return request;
 }
 
-static bool endpointDiscoveryPoller_endpointDescriptionEquals(celix_array_list_entry_t endpointEntry,
-                                                              celix_array_list_entry_t compareEntry) {
-    endpoint_description_t* endpoint = (endpoint_description_t*)endpointEntry.voidPtrVal;
-    endpoint_description_t* compare = (endpoint_description_t*)compareEntry.voidPtrVal;
-    return strcmp(endpoint->id, compare->id) == 0;
+static void endpointDiscoveryPoller_destroyRequest(endpoint_discovery_poller_request_t* request) {
+    if (request != NULL) {
+        if (request->curl != NULL) {
+            curl_easy_cleanup(request->curl);
+        }
+        free(request->response.body.memory);
+        free(request->response.etag);
+        free(request->response.removed);
+        free(request->url);
+        free(request);
+    }
 }
@@ -0,0 +1,43 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ENDPOINT_DISCOVERY_PROTOCOL_H_
+#define ENDPOINT_DISCOVERY_PROTOCOL_H_
+
+/*
+ * Private constants for the HTTP protocol between the endpoint discovery server and poller.
+ *
+ * Every response of the server for the list of all endpoints contains an ETag header with the revision
+ * ("<server epoch>-<revision>") of the endpoint list. A poller which already knows a revision can request:
+ *  - "?since=<revision>": only the endpoints added after the given revision. The response contains the
+ *    DISCOVERY_DELTA_HEADER header and the ids of the removed endpoints in the DISCOVERY_REMOVED_HEADER header.
+ *    If the server can not create a delta for the given revision, the complete endpoint list is returned without
+ *    the DISCOVERY_DELTA_HEADER header.
+ *  - "&wait=<seconds>": long-poll, the server blocks the request until the revision changes or the wait time expires.
+ * If the revision is not changed, the server responds with 304 Not Modified.
+ */
+
+#define DISCOVERY_SINCE_QUERY_PARAM "since"
+#define DISCOVERY_WAIT_QUERY_PARAM "wait"
+
+#define DISCOVERY_ETAG_HEADER "ETag"
+#define DISCOVERY_DELTA_HEADER "X-Celix-Discovery-Delta"
+#define DISCOVERY_REMOVED_HEADER "X-Celix-Discovery-Removed"
+
+#endif /* ENDPOINT_DISCOVERY_PROTOCOL_H_ */
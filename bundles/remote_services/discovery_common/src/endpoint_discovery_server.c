@@ -19,6 +19,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #ifndef ANDROID
@@ -31,25 +33,46 @@
 #include "celix_log_helper.h"
 #include "discovery.h"
 #include "endpoint_descriptor_writer.h"
+#include "endpoint_discovery_protocol.h"
 
 // defines how often the webserver is restarted (with an increased port number)
 #define MAX_NUMBER_OF_RESTARTS     15
-#define DEFAULT_SERVER_THREADS     "5"
+#define DEFAULT_SERVER_THREADS     "32"
+// defines the max time (in seconds) a long-poll request is blocked
+#define DEFAULT_SERVER_MAX_WAIT    30
+// defines the part of the server threads which may be blocked by long-poll requests (1/n)
+#define SERVER_THREADS_WAITER_DIVISOR 2
+// defines how many removed endpoints are remembered for delta responses
+#define MAX_REMOVED_ENDPOINTS      256
 
 #define CIVETWEB_REQUEST_NOT_HANDLED 0
 #define CIVETWEB_REQUEST_HANDLED 1
 
-static const char *response_headers =
-        "HTTP/1.1 200 OK\r\n"
-        "Cache: no-cache\r\n"
-        "Content-Type: application/xml;charset=utf-8\r\n"
-        "\r\n";
+typedef struct endpoint_discovery_server_entry {
+    endpoint_description_t *endpoint;
+    unsigned long revision; // revision in which the endpoint is added
+} endpoint_discovery_server_entry_t;
+
+typedef struct endpoint_discovery_server_removal {
+    unsigned long revision; // revision in which the endpoint is removed
+    char *endpointId;
+} endpoint_discovery_server_removal_t;
 
 struct endpoint_discovery_server {
     celix_log_helper_t **loghelper;
-    hash_map_pt entries; // key = endpointId, value = endpoint_descriptor_pt
+    hash_map_pt entries; // key = endpointId, value = endpoint_discovery_server_entry_t*
+
+    celix_thread_mutex_t serverLock; // protects entries, revision, deltaBaseRevision, removals and stopping
+    celix_thread_cond_t revisionChanged;
 
-    celix_thread_mutex_t serverLock;
+    unsigned long epoch; // unique id of the server instance, part of the revision to detect a restarted server
+    unsigned long revision; // incremented for every added or removed endpoint
+    unsigned long deltaBaseRevision; // oldest revision for which a delta response can be created
+    celix_array_list_t *removals; // removed endpoints ordered by revision, value = endpoint_discovery_server_removal_t*
+    bool stopping;
+    long maxWait; // max time in seconds a long-poll request is blocked
+    long maxWaiters; // max number of concurrently blocked long-poll requests, the other threads stay available
+    long waiters; // number of currently blocked long-poll requests
 
     const char *path;
     const char *port;
@@ -60,6 +83,8 @@ struct endpoint_discovery_server {
 // Forward declarations...
 static int endpointDiscoveryServer_callback(struct mg_connection *conn);
 static char* format_path(const char* path);
+static void endpointDiscoveryServer_destroyRemoval(void *removal);
+static unsigned long endpointDiscoveryServer_createEpoch(void);
 
 #ifndef ANDROID
 static celix_status_t endpointDiscoveryServer_getIpAddress(char* interface, char** ip);
@@ -92,10 +117,26 @@ celix_status_t endpointDiscoveryServer_create(discovery_t *discovery,
         return CELIX_ENOMEM;
     }
 
+    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = endpointDiscoveryServer_destroyRemoval;
+    (*server)->removals = celix_arrayList_createWithOptions(&opts);
+    if (!(*server)->removals) {
+        return CELIX_ENOMEM;
+    }
+    (*server)->epoch = endpointDiscoveryServer_createEpoch();
+    (*server)->revision = 0;
+    (*server)->deltaBaseRevision = 0;
+    (*server)->stopping = false;
+    (*server)->maxWait = celix_bundleContext_getPropertyAsLong(context, DISCOVERY_SERVER_MAX_WAIT, DEFAULT_SERVER_MAX_WAIT);
+
     status = celixThreadMutex_create(&(*server)->serverLock, NULL);
     if (status != CELIX_SUCCESS) {
         return CELIX_BUNDLE_EXCEPTION;
     }
+    status = celixThreadCondition_init(&(*server)->revisionChanged, NULL);
+    if (status != CELIX_SUCCESS) {
+        return CELIX_BUNDLE_EXCEPTION;
+    }
 
     bundleContext_getProperty(context, DISCOVERY_SERVER_IP, &ip);
 #ifndef ANDROID
@@ -152,6 +193,9 @@ celix_status_t endpointDiscoveryServer_create(discovery_t *discovery,
     const struct mg_callbacks callbacks = {
             .begin_request = endpointDiscoveryServer_callback,
     };
+    const char *numThreads = celix_bundleContext_getProperty(context, DISCOVERY_SERVER_THREADS, DEFAULT_SERVER_THREADS);
+    (*server)->maxWaiters = strtol(numThreads, NULL, 10) / SERVER_THREADS_WAITER_DIVISOR;
+    (*server)->waiters = 0;
 
     unsigned int port_counter = 0;
     char newPort[10];
@@ -167,7 +211,7 @@ celix_status_t endpointDiscoveryServer_create(discovery_t *discovery,
 
         const char *options[] = {
                 "listening_ports", listeningPorts,
-                "num_threads", DEFAULT_SERVER_THREADS,
+                "num_threads", numThreads,
                 NULL
         };
 
@@ -218,6 +262,12 @@ celix_status_t endpointDiscoveryServer_getUrl(endpoint_discovery_server_t *serve
 celix_status_t endpointDiscoveryServer_destroy(endpoint_discovery_server_t *server) {
     celix_status_t status;
 
+    // wake up pending long-poll requests, so that the server can be stopped
+    celixThreadMutex_lock(&server->serverLock);
+    server->stopping = true;
+    celixThreadCondition_broadcast(&server->revisionChanged);
+    celixThreadMutex_unlock(&server->serverLock);
+
     // stop & block until the actual server is shut down...
     if (server->ctx != NULL) {
         mg_stop(server->ctx);
@@ -226,9 +276,11 @@ celix_status_t endpointDiscoveryServer_destroy(endpoint_discovery_server_t *serv
 
     status = celixThreadMutex_lock(&server->serverLock);
 
-    hashMap_destroy(server->entries, true /* freeKeys */, false /* freeValues */);
+    hashMap_destroy(server->entries, true /* freeKeys */, true /* freeValues */);
+    celix_arrayList_destroy(server->removals);
 
     status = celixThreadMutex_unlock(&server->serverLock);
+    status = celixThreadCondition_destroy(&server->revisionChanged);
     status = celixThreadMutex_destroy(&server->serverLock);
 
     free((void*) server->path);
@@ -248,13 +300,23 @@ celix_status_t endpointDiscoveryServer_addEndpoint(endpoint_discovery_server_t *
         return CELIX_BUNDLE_EXCEPTION;
     }
 
-    // create a local copy of the endpointId which we can control...
-    char* endpointId = strdup(endpoint->id);
-    endpoint_description_t *cur_value = hashMap_get(server->entries, endpointId);
+    endpoint_discovery_server_entry_t *cur_value = hashMap_get(server->entries, endpoint->id);
     if (!cur_value) {
+        // create a local copy of the endpointId which we can control...
+        char* endpointId = strdup(endpoint->id);
+        endpoint_discovery_server_entry_t *entry = calloc(1, sizeof(*entry));
+        if (endpointId == NULL || entry == NULL) {
+            free(endpointId);
+            free(entry);
+            celixThreadMutex_unlock(&server->serverLock);
+            return CELIX_ENOMEM;
+        }
         celix_logHelper_info(*server->loghelper, "exposing new endpoint \"%s\"...", endpointId);
 
-        hashMap_put(server->entries, endpointId, endpoint);
+        entry->endpoint = endpoint;
+        entry->revision = ++server->revision;
+        hashMap_put(server->entries, endpointId, entry);
+        celixThreadCondition_broadcast(&server->revisionChanged);
     }
 
     status = celixThreadMutex_unlock(&server->serverLock);
@@ -265,6 +327,49 @@ celix_status_t endpointDiscoveryServer_addEndpoint(endpoint_discovery_server_t *
     return status;
 }
 
+/**
+ * Creates the epoch of a server instance.
+ * The epoch must differ for a restarted server, also if the server is restarted within the same second or by
+ * another process, otherwise pollers could apply a delta of the restarted server to the endpoints of the old one.
+ */
+static unsigned long endpointDiscoveryServer_createEpoch(void) {
+    struct timespec now = celix_gettime(CLOCK_REALTIME);
+    unsigned long epoch = (unsigned long)now.tv_sec * 1000000000UL + (unsigned long)now.tv_nsec;
+    return epoch ^ ((unsigned long)getpid() * 2654435761UL);
+}
+
+static void endpointDiscoveryServer_destroyRemoval(void *data) {
+    endpoint_discovery_server_removal_t *removal = data;
+    free(removal->endpointId);
+    free(removal);
+}
+
+/**
+ * Remembers a removed endpoint for delta responses, takes ownership of the endpointId.
+ * If no removal can be remembered, delta responses are no longer possible for the older revisions.
+ */
+static void endpointDiscoveryServer_addRemoval(endpoint_discovery_server_t *server, char *endpointId) {
+    if (celix_arrayList_size(server->removals) >= MAX_REMOVED_ENDPOINTS) {
+        endpoint_discovery_server_removal_t *oldest = celix_arrayList_get(server->removals, 0);
+        server->deltaBaseRevision = oldest->revision;
+        celix_arrayList_removeAt(server->removals, 0);
+    }
+    endpoint_discovery_server_removal_t *removal = calloc(1, sizeof(*removal));
+    if (removal == NULL) {
+        free(endpointId);
+        server->deltaBaseRevision = server->revision;
+        celix_arrayList_clear(server->removals);
+        return;
+    }
+    removal->revision = server->revision;
+    removal->endpointId = endpointId;
+    if (celix_arrayList_add(server->removals, removal) != CELIX_SUCCESS) {
+        endpointDiscoveryServer_destroyRemoval(removal);
+        server->deltaBaseRevision = server->revision;
+        celix_arrayList_clear(server->removals);
+    }
+}
+
 celix_status_t endpointDiscoveryServer_removeEndpoint(endpoint_discovery_server_t *server, endpoint_description_t *endpoint) {
     celix_status_t status;
 
@@ -279,10 +384,11 @@ celix_status_t endpointDiscoveryServer_removeEndpoint(endpoint_discovery_server_
 
         celix_logHelper_info(*server->loghelper, "removing endpoint \"%s\"...\n", key);
 
-        hashMap_remove(server->entries, key);
-
-        // we've made this key, see _addEndpoint above...
-        free((void*) key);
+        endpoint_discovery_server_entry_t *value = hashMap_remove(server->entries, key);
+        free(value);
+        server->revision += 1;
+        endpointDiscoveryServer_addRemoval(server, key);
+        celixThreadCondition_broadcast(&server->revisionChanged);
     }
 
     status = celixThreadMutex_unlock(&server->serverLock);
@@ -306,7 +412,7 @@ static char* format_path(const char* path) {
     return result;
 }
 
-static celix_status_t endpointDiscoveryServer_getEndpoints(endpoint_discovery_server_t *server, const char* the_endpoint_id, celix_array_list_t** endpoints) {
+static celix_status_t endpointDiscoveryServer_getEndpoints(endpoint_discovery_server_t *server, const char* the_endpoint_id, unsigned long sinceRevision, celix_array_list_t** endpoints) {
     *endpoints = celix_arrayList_create();
     if (!(*endpoints)) {
         return CELIX_ENOMEM;
@@ -318,10 +424,9 @@ static celix_status_t endpointDiscoveryServer_getEndpoints(endpoint_discovery_se
         hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
 
         char* endpoint_id = hashMapEntry_getKey(entry);
-        if (the_endpoint_id == NULL || strcmp(the_endpoint_id, endpoint_id) == 0) {
-            endpoint_description_t *endpoint = hashMapEntry_getValue(entry);
-
-            celix_arrayList_add(*endpoints, endpoint);
+        endpoint_discovery_server_entry_t *value = hashMapEntry_getValue(entry);
+        if ((the_endpoint_id == NULL || strcmp(the_endpoint_id, endpoint_id) == 0) && value->revision > sinceRevision) {
+            celix_arrayList_add(*endpoints, value->endpoint);
         }
     }
     hashMapIterator_destroy(iter);
@@ -329,69 +434,198 @@ static celix_status_t endpointDiscoveryServer_getEndpoints(endpoint_discovery_se
     return CELIX_SUCCESS;
 }
 
-static int endpointDiscoveryServer_writeEndpoints(struct mg_connection* conn, celix_array_list_t* endpoints) {
-    celix_status_t status;
-    int rv = CIVETWEB_REQUEST_NOT_HANDLED;
-
+static char* endpointDiscoveryServer_createDocument(celix_array_list_t* endpoints) {
+    char *buffer = NULL;
     endpoint_descriptor_writer_t *writer = NULL;
-    status = endpointDescriptorWriter_create(&writer);
+    celix_status_t status = endpointDescriptorWriter_create(&writer);
     if (status == CELIX_SUCCESS) {
-
-        char *buffer = NULL;
         status = endpointDescriptorWriter_writeDocument(writer, endpoints, &buffer);
-        if (buffer) {
-            mg_write(conn, response_headers, strlen(response_headers));
-            mg_write(conn, buffer, strlen(buffer));
-        }
-
-        rv = CIVETWEB_REQUEST_HANDLED;
     }
-
     if (writer != NULL) {
         endpointDescriptorWriter_destroy(writer);
     }
+    if (status != CELIX_SUCCESS) {
+        free(buffer);
+        buffer = NULL;
+    }
+    return buffer;
+}
+
+static void endpointDiscoveryServer_writeDocument(struct mg_connection* conn, const char* etag, const char* extraHeaders, const char* document) {
+    mg_printf(conn,
+              "HTTP/1.1 200 OK\r\n"
+              "Cache: no-cache\r\n"
+              "Content-Type: application/xml;charset=utf-8\r\n"
+              "Content-Length: %zu\r\n"
+              "%s%s%s"
+              "%s"
+              "\r\n",
+              strlen(document),
+              etag != NULL ? DISCOVERY_ETAG_HEADER ": " : "", etag != NULL ? etag : "", etag != NULL ? "\r\n" : "",
+              extraHeaders != NULL ? extraHeaders : "");
+    mg_write(conn, document, strlen(document));
+}
+
+/**
+ * Parses a revision ("<epoch>-<revision>", optionally quoted) of this server.
+ * Returns false if the revision can not be parsed or if the revision is of another (restarted) server.
+ */
+static bool endpointDiscoveryServer_parseRevision(endpoint_discovery_server_t *server, const char *str, unsigned long *revision) {
+    if (str == NULL) {
+        return false;
+    }
+    if (*str == '"') {
+        str++;
+    }
+    char *end = NULL;
+    errno = 0;
+    unsigned long epoch = strtoul(str, &end, 10);
+    if (errno != 0 || end == str || *end != '-' || epoch != server->epoch) {
+        return false;
+    }
+    str = end + 1;
+    *revision = strtoul(str, &end, 10);
+    return errno == 0 && end != str && (*end == '\0' || *end == '"');
+}
 
-    return rv;
+/**
+ * Creates the value of the removed endpoints header for a delta response.
+ * Returns NULL if there are no removed endpoints since the given revision.
+ */
+static char* endpointDiscoveryServer_createRemovedHeader(endpoint_discovery_server_t *server, unsigned long sinceRevision) {
+    char *header = NULL;
+    size_t headerSize = 0;
+    FILE *stream = NULL;
+    for (int i = 0; i < celix_arrayList_size(server->removals); ++i) {
+        endpoint_discovery_server_removal_t *removal = celix_arrayList_get(server->removals, i);
+        if (removal->revision <= sinceRevision) {
+            continue;
+        }
+        if (stream == NULL) {
+            stream = open_memstream(&header, &headerSize);
+            if (stream == NULL) {
+                return NULL;
+            }
+            fprintf(stream, DISCOVERY_REMOVED_HEADER ": %s", removal->endpointId);
+        } else {
+            fprintf(stream, ",%s", removal->endpointId);
+        }
+    }
+    if (stream != NULL) {
+        fputs("\r\n", stream);
+        fclose(stream);
+    }
+    return header;
 }
 
-// returns all endpoints as XML...
+// returns all endpoints, or the changes since a known revision, as XML...
 static int endpointDiscoveryServer_returnAllEndpoints(endpoint_discovery_server_t *server, struct mg_connection* conn) {
-    int status = CIVETWEB_REQUEST_NOT_HANDLED;
+    const struct mg_request_info *request_info = mg_get_request_info(conn);
+    const char *query = request_info->query_string;
+    size_t queryLen = query != NULL ? strlen(query) : 0;
+
+    bool knownRevisionSet = false;
+    bool deltaRequested = false;
+    unsigned long knownRevision = 0;
+    long wait = 0;
+    char value[64];
+    if (query != NULL && mg_get_var(query, queryLen, DISCOVERY_SINCE_QUERY_PARAM, value, sizeof(value)) > 0) {
+        knownRevisionSet = endpointDiscoveryServer_parseRevision(server, value, &knownRevision);
+        deltaRequested = knownRevisionSet;
+    } else {
+        knownRevisionSet = endpointDiscoveryServer_parseRevision(server, mg_get_header(conn, "If-None-Match"), &knownRevision);
+    }
+    if (query != NULL && mg_get_var(query, queryLen, DISCOVERY_WAIT_QUERY_PARAM, value, sizeof(value)) > 0) {
+        wait = strtol(value, NULL, 10);
+        wait = wait < 0 ? 0 : (wait > server->maxWait ? server->maxWait : wait);
+    }
 
-    celix_array_list_t* endpoints = NULL;
+    char etag[64];
+    char *document = NULL;
+    char *removedHeader = NULL;
+    bool delta = false;
 
-    if (celixThreadMutex_lock(&server->serverLock) == CELIX_SUCCESS) {
-        endpointDiscoveryServer_getEndpoints(server, NULL, &endpoints);
+    if (celixThreadMutex_lock(&server->serverLock) != CELIX_SUCCESS) {
+        return CIVETWEB_REQUEST_NOT_HANDLED;
+    }
+    // if too many requests are already blocked, answer immediately so that server threads remain available
+    if (knownRevisionSet && wait > 0 && server->waiters < server->maxWaiters) {
+        struct timespec deadline = celixThreadCondition_getDelayedTime((double)wait);
+        server->waiters++;
+        while (!server->stopping && server->revision == knownRevision) {
+            if (celixThreadCondition_waitUntil(&server->revisionChanged, &server->serverLock, &deadline) != CELIX_SUCCESS) {
+                break;
+            }
+        }
+        server->waiters--;
+    }
+    (void)snprintf(etag, sizeof(etag), "\"%lu-%lu\"", server->epoch, server->revision);
+    bool modified = !knownRevisionSet || knownRevision != server->revision;
+    if (modified) {
+        delta = deltaRequested && knownRevision >= server->deltaBaseRevision && knownRevision < server->revision;
+        celix_array_list_t* endpoints = NULL;
+        endpointDiscoveryServer_getEndpoints(server, NULL, delta ? knownRevision : 0, &endpoints);
         if (endpoints) {
-            status = endpointDiscoveryServer_writeEndpoints(conn, endpoints);
-
+            document = endpointDiscoveryServer_createDocument(endpoints);
             celix_arrayList_destroy(endpoints);
         }
-
-
-        celixThreadMutex_unlock(&server->serverLock);
+        if (delta) {
+            removedHeader = endpointDiscoveryServer_createRemovedHeader(server, knownRevision);
+        }
+    }
+    celixThreadMutex_unlock(&server->serverLock);
+
+    if (!modified) {
+        mg_printf(conn,
+                  "HTTP/1.1 304 Not Modified\r\n"
+                  "Cache: no-cache\r\n"
+                  DISCOVERY_ETAG_HEADER ": %s\r\n"
+                  "Content-Length: 0\r\n"
+                  "\r\n", etag);
+        return CIVETWEB_REQUEST_HANDLED;
     }
+    int status = CIVETWEB_REQUEST_NOT_HANDLED;
+    char *extraHeaders = NULL;
+    if (document != NULL && delta) {
+        if (asprintf(&extraHeaders, DISCOVERY_DELTA_HEADER ": true\r\n%s", removedHeader != NULL ? removedHeader : "") < 0) {
+            extraHeaders = NULL;
+            free(document);
+            document = NULL;
+        }
+    }
+    if (document != NULL) {
+        endpointDiscoveryServer_writeDocument(conn, etag, extraHeaders, document);
+        status = CIVETWEB_REQUEST_HANDLED;
+    }
+
+    free(extraHeaders);
+    free(removedHeader);
+    free(document);
 
     return status;
 }
 
 // returns a single endpoint as XML...
 static int endpointDiscoveryServer_returnEndpoint(endpoint_discovery_server_t *server, struct mg_connection* conn, const char* endpoint_id) {
-    int status = CIVETWEB_REQUEST_NOT_HANDLED;
-
+    char *document = NULL;
     celix_array_list_t* endpoints = NULL;
 
     if (celixThreadMutex_lock(&server->serverLock) == CELIX_SUCCESS) {
-        endpointDiscoveryServer_getEndpoints(server, endpoint_id, &endpoints);
+        endpointDiscoveryServer_getEndpoints(server, endpoint_id, 0, &endpoints);
         if (endpoints) {
-            status = endpointDiscoveryServer_writeEndpoints(conn, endpoints);
+            document = endpointDiscoveryServer_createDocument(endpoints);
             celix_arrayList_destroy(endpoints);
         }
 
         celixThreadMutex_unlock(&server->serverLock);
     }
 
-    return status;
+    if (document == NULL) {
+        return CIVETWEB_REQUEST_NOT_HANDLED;
+    }
+    endpointDiscoveryServer_writeDocument(conn, NULL, NULL, document);
+    free(document);
+    return CIVETWEB_REQUEST_HANDLED;
 }
 
 static int endpointDiscoveryServer_callback(struct mg_connection* conn) {
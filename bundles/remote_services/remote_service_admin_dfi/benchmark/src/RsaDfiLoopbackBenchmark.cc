@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#include "celix_bundle_context.h"
+#include "celix_framework_factory.h"
+#include "celix_properties.h"
+#include "calculator_service.h"
+
+/**
+ * Loopback benchmark for the RSA DFI HTTP transport.
+ *
+ * A server framework exports the calculator example service and a client framework in the same process imports it.
+ * The remote calculator add method is called in a loop, optionally from multiple threads, for the different curl
+ * client configurations of the RSA DFI.
+ */
+enum class CurlMode {
+    NoPool, ///< A new curl easy handle (and connection) per call.
+    Pooled, ///< Pooled curl easy handles per endpoint.
+    Multi   ///< Pooled curl easy handles, transfers performed by the curl multi event loop thread.
+};
+
+class RsaDfiLoopbackBenchmark {
+public:
+    explicit RsaDfiLoopbackBenchmark(CurlMode mode) {
+        celix_properties_t* serverProps = celix_properties_load("server.properties");
+        serverFw = celix_frameworkFactory_createFramework(serverProps);
+
+        celix_properties_t* clientProps = celix_properties_load("client.properties");
+        celix_properties_setLong(clientProps, "RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT", mode == CurlMode::NoPool ? 0 : 16);
+        celix_properties_setBool(clientProps, "RSA_DFI_USE_CURL_MULTI_HANDLE", mode == CurlMode::Multi);
+        clientFw = celix_frameworkFactory_createFramework(clientProps);
+        clientCtx = clientFw == nullptr ? nullptr : celix_framework_getFrameworkContext(clientFw);
+    }
+
+    ~RsaDfiLoopbackBenchmark() noexcept {
+        if (clientFw != nullptr) {
+            celix_frameworkFactory_destroyFramework(clientFw);
+        }
+        if (serverFw != nullptr) {
+            celix_frameworkFactory_destroyFramework(serverFw);
+        }
+    }
+
+    RsaDfiLoopbackBenchmark(RsaDfiLoopbackBenchmark&&) = delete;
+    RsaDfiLoopbackBenchmark(const RsaDfiLoopbackBenchmark&) = delete;
+    RsaDfiLoopbackBenchmark& operator=(RsaDfiLoopbackBenchmark&&) = delete;
+    RsaDfiLoopbackBenchmark& operator=(const RsaDfiLoopbackBenchmark&) = delete;
+
+    /**
+     * @brief Calls the remote calculator add method, waiting at most waitTimeoutInSeconds for the imported service.
+     */
+    bool add(double waitTimeoutInSeconds = 0.0) {
+        bool ok = false;
+        celix_service_use_options_t opts{};
+        opts.filter.serviceName = CALCULATOR_SERVICE;
+        opts.waitTimeoutInSeconds = waitTimeoutInSeconds;
+        opts.callbackHandle = &ok;
+        opts.use = [](void* handle, void* svc) {
+            auto* calc = static_cast<calculator_service_t*>(svc);
+            double result = 0.0;
+            int rc = calc->add(calc->handle, 1.0, 2.0, &result);
+            *static_cast<bool*>(handle) = rc == 0 && result == 3.0;
+        };
+        bool called = clientCtx != nullptr && celix_bundleContext_useServiceWithOptions(clientCtx, &opts);
+        return called && ok;
+    }
+
+private:
+    celix_framework_t* serverFw{nullptr};
+    celix_framework_t* clientFw{nullptr};
+    celix_bundle_context_t* clientCtx{nullptr};
+};
+
+static void remoteCalculatorAdd(benchmark::State& state, CurlMode mode) {
+    static std::unique_ptr<RsaDfiLoopbackBenchmark> env{};
+    if (state.thread_index() == 0) {
+        env = std::make_unique<RsaDfiLoopbackBenchmark>(mode);
+        if (!env->add(10.0)) {
+            state.SkipWithError("Remote calculator service not available");
+        }
+    }
+
+    for (auto _ : state) {
+        // This code gets timed
+        if (!env->add()) {
+            state.SkipWithError("Remote call failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        env.reset();
+    }
+}
+
+#define CELIX_BENCHMARK(name, mode) \
+    BENCHMARK_CAPTURE(remoteCalculatorAdd, name, mode)->UseRealTime()->Unit(benchmark::kMicrosecond)->ThreadRange(1, 16)
+
+CELIX_BENCHMARK(NoPool, CurlMode::NoPool);
+CELIX_BENCHMARK(Pooled, CurlMode::Pooled);
+CELIX_BENCHMARK(Multi, CurlMode::Multi);
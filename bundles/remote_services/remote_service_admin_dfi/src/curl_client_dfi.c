@@ -0,0 +1,316 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "curl_client_dfi.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "celix_array_list.h"
+#include "celix_string_hash_map.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
+
+#define CURL_CLIENT_MULTI_POLL_TIMEOUT_MS 1000
+
+/**
+ * Called once when a transfer of the event loop is completed, with the result of the transfer.
+ * Called on the event loop thread, so the callback should not block.
+ */
+typedef void (*curl_client_completion_fp)(void* data, CURLcode result);
+
+typedef struct curl_client_transfer {
+    CURL* handle;
+    curl_client_completion_fp callback;
+    void* callbackData;
+} curl_client_transfer_t;
+
+typedef struct curl_client_sync_transfer {
+    curl_client_t* client;
+    CURLcode result;
+    bool done; //protected by client mutex
+    celix_thread_cond_t doneCond;
+} curl_client_sync_transfer_t;
+
+struct curl_client {
+    celix_log_helper_t* logHelper;
+    curl_client_config_t config;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_string_hash_map_t* pools; //key = endpoint id, value = celix_array_list_t* of idle CURL*
+    celix_array_list_t* pendingTransfers; //curl_client_transfer_t* entries to be added to the multi handle
+    bool running;
+
+    //only used if config.useMultiHandle is true
+    CURLM* multi;
+    celix_array_list_t* startingTransfers; //swapped with pendingTransfers by the event loop thread
+    celix_thread_t loopThread;
+};
+
+static void* curlClient_loop(void* data);
+
+static void curlClient_destroyPool(void* data) {
+    celix_array_list_t* pool = data;
+    for (int i = 0; i < celix_arrayList_size(pool); ++i) {
+        curl_easy_cleanup(celix_arrayList_get(pool, i));
+    }
+    celix_arrayList_destroy(pool);
+}
+
+celix_status_t curlClient_create(celix_log_helper_t* logHelper, const curl_client_config_t* config, curl_client_t** out) {
+    celix_autofree curl_client_t* client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        return CELIX_ENOMEM;
+    }
+    client->logHelper = logHelper;
+    client->config = *config;
+    client->running = true;
+
+    celix_status_t status = celixThreadMutex_create(&client->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) mutex = &client->mutex;
+
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = curlClient_destroyPool;
+    celix_autoptr(celix_string_hash_map_t) pools = client->pools = celix_stringHashMap_createWithOptions(&opts);
+    celix_autoptr(celix_array_list_t) pendingTransfers = client->pendingTransfers = celix_arrayList_create();
+    celix_autoptr(celix_array_list_t) startingTransfers = client->startingTransfers = celix_arrayList_create();
+    if (pools == NULL || pendingTransfers == NULL || startingTransfers == NULL) {
+        return CELIX_ENOMEM;
+    }
+
+    if (config->useMultiHandle) {
+        client->multi = curl_multi_init();
+        if (client->multi == NULL) {
+            celix_logHelper_error(logHelper, "RSA_DFI: Error creating curl multi handle.");
+            return CELIX_ENOMEM;
+        }
+        curl_multi_setopt(client->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        if (config->maxHostConnections > 0) {
+            curl_multi_setopt(client->multi, CURLMOPT_MAX_HOST_CONNECTIONS, config->maxHostConnections);
+        }
+        status = celixThread_create(&client->loopThread, NULL, curlClient_loop, client);
+        if (status != CELIX_SUCCESS) {
+            celix_logHelper_error(logHelper, "RSA_DFI: Error creating curl multi event loop thread.");
+            curl_multi_cleanup(client->multi);
+            return status;
+        }
+        celixThread_setName(&client->loopThread, "RsaCurlLoop");
+    }
+
+    celix_steal_ptr(startingTransfers);
+    celix_steal_ptr(pendingTransfers);
+    celix_steal_ptr(pools);
+    celix_steal_ptr(mutex);
+    *out = celix_steal_ptr(client);
+    return CELIX_SUCCESS;
+}
+
+void curlClient_destroy(curl_client_t* client) {
+    if (client == NULL) {
+        return;
+    }
+    celixThreadMutex_lock(&client->mutex);
+    client->running = false;
+    celixThreadMutex_unlock(&client->mutex);
+    if (client->multi != NULL) {
+        curl_multi_wakeup(client->multi);
+        celixThread_join(client->loopThread, NULL);
+        curl_multi_cleanup(client->multi);
+    }
+    assert(celix_arrayList_size(client->pendingTransfers) == 0);
+    celix_arrayList_destroy(client->pendingTransfers);
+    celix_arrayList_destroy(client->startingTransfers);
+    celix_stringHashMap_destroy(client->pools);
+    celixThreadMutex_destroy(&client->mutex);
+    free(client);
+}
+
+CURL* curlClient_acquireHandle(curl_client_t* client, const char* endpointId) {
+    CURL* handle = NULL;
+    celixThreadMutex_lock(&client->mutex);
+    celix_array_list_t* pool = celix_stringHashMap_get(client->pools, endpointId);
+    int size = pool == NULL ? 0 : celix_arrayList_size(pool);
+    if (size > 0) {
+        handle = celix_arrayList_get(pool, size - 1);
+        celix_arrayList_removeAt(pool, size - 1);
+    }
+    celixThreadMutex_unlock(&client->mutex);
+    return handle != NULL ? handle : curl_easy_init();
+}
+
+void curlClient_releaseHandle(curl_client_t* client, const char* endpointId, CURL* handle) {
+    if (handle == NULL) {
+        return;
+    }
+    //note curl_easy_reset keeps the live connections and the DNS cache of the handle
+    curl_easy_reset(handle);
+    bool pooled = false;
+    if (client->config.maxIdleHandlesPerEndpoint > 0) {
+        celixThreadMutex_lock(&client->mutex);
+        //note no pool exists for a removed endpoint, so a handle released after the endpoint is removed is cleaned up
+        celix_array_list_t* pool = celix_stringHashMap_get(client->pools, endpointId);
+        if (pool != NULL && (unsigned int)celix_arrayList_size(pool) < client->config.maxIdleHandlesPerEndpoint) {
+            pooled = celix_arrayList_add(pool, handle) == CELIX_SUCCESS;
+        }
+        celixThreadMutex_unlock(&client->mutex);
+    }
+    if (!pooled) {
+        curl_easy_cleanup(handle);
+    }
+}
+
+void curlClient_addEndpoint(curl_client_t* client, const char* endpointId) {
+    if (client->config.maxIdleHandlesPerEndpoint == 0) {
+        return;
+    }
+    celixThreadMutex_lock(&client->mutex);
+    if (!celix_stringHashMap_hasKey(client->pools, endpointId)) {
+        celix_array_list_t* pool = celix_arrayList_create();
+        if (pool != NULL && celix_stringHashMap_put(client->pools, endpointId, pool) != CELIX_SUCCESS) {
+            celix_arrayList_destroy(pool);
+        }
+    }
+    celixThreadMutex_unlock(&client->mutex);
+}
+
+void curlClient_removeEndpoint(curl_client_t* client, const char* endpointId) {
+    celixThreadMutex_lock(&client->mutex);
+    celix_stringHashMap_remove(client->pools, endpointId);
+    celixThreadMutex_unlock(&client->mutex);
+}
+
+/**
+ * Hands the transfer configured on the easy handle over to the event loop thread, which calls the callback when the
+ * transfer is completed. Returns CURLE_OK if the transfer is started, the callback is only called in that case.
+ */
+static CURLcode curlClient_startTransfer(curl_client_t* client, CURL* handle, curl_client_completion_fp callback, void* callbackData) {
+    curl_client_transfer_t* transfer = malloc(sizeof(*transfer));
+    if (transfer == NULL) {
+        return CURLE_OUT_OF_MEMORY;
+    }
+    transfer->handle = handle;
+    transfer->callback = callback;
+    transfer->callbackData = callbackData;
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, transfer);
+
+    CURLcode result = CURLE_OK;
+    celixThreadMutex_lock(&client->mutex);
+    if (!client->running) {
+        result = CURLE_ABORTED_BY_CALLBACK;
+    } else if (celix_arrayList_add(client->pendingTransfers, transfer) != CELIX_SUCCESS) {
+        result = CURLE_OUT_OF_MEMORY;
+    }
+    celixThreadMutex_unlock(&client->mutex);
+    if (result != CURLE_OK) {
+        free(transfer);
+        return result;
+    }
+    curl_multi_wakeup(client->multi);
+    return CURLE_OK;
+}
+
+static void curlClient_syncTransferDone(void* data, CURLcode result) {
+    curl_client_sync_transfer_t* transfer = data;
+    celixThreadMutex_lock(&transfer->client->mutex);
+    transfer->result = result;
+    transfer->done = true;
+    celixThreadCondition_signal(&transfer->doneCond);
+    celixThreadMutex_unlock(&transfer->client->mutex);
+}
+
+CURLcode curlClient_perform(curl_client_t* client, CURL* handle) {
+    if (client->multi == NULL) {
+        return curl_easy_perform(handle);
+    }
+
+    curl_client_sync_transfer_t transfer;
+    transfer.client = client;
+    transfer.result = CURLE_OK;
+    transfer.done = false;
+    if (celixThreadCondition_init(&transfer.doneCond, NULL) != CELIX_SUCCESS) {
+        return CURLE_OUT_OF_MEMORY;
+    }
+    CURLcode result = curlClient_startTransfer(client, handle, curlClient_syncTransferDone, &transfer);
+    if (result == CURLE_OK) {
+        celixThreadMutex_lock(&client->mutex);
+        while (!transfer.done) {
+            celixThreadCondition_wait(&transfer.doneCond, &client->mutex);
+        }
+        celixThreadMutex_unlock(&client->mutex);
+        result = transfer.result;
+    }
+    celixThreadCondition_destroy(&transfer.doneCond);
+    return result;
+}
+
+static void curlClient_completeTransfer(curl_client_transfer_t* transfer, CURLcode result) {
+    transfer->callback(transfer->callbackData, result);
+    free(transfer);
+}
+
+static void* curlClient_loop(void* data) {
+    curl_client_t* client = data;
+    int nrOfActiveTransfers = 0;
+    bool running = true;
+    while (running || nrOfActiveTransfers > 0) {
+        celixThreadMutex_lock(&client->mutex);
+        running = client->running;
+        //swap the pending list, so that the transfers are started without holding the client mutex
+        celix_array_list_t* transfers = client->pendingTransfers;
+        client->pendingTransfers = client->startingTransfers;
+        client->startingTransfers = transfers;
+        celixThreadMutex_unlock(&client->mutex);
+
+        for (int i = 0; i < celix_arrayList_size(transfers); ++i) {
+            curl_client_transfer_t* transfer = celix_arrayList_get(transfers, i);
+            if (curl_multi_add_handle(client->multi, transfer->handle) != CURLM_OK) {
+                curlClient_completeTransfer(transfer, CURLE_FAILED_INIT);
+            } else {
+                nrOfActiveTransfers += 1;
+            }
+        }
+        celix_arrayList_clear(transfers);
+
+        int stillRunning = 0;
+        curl_multi_perform(client->multi, &stillRunning);
+
+        CURLMsg* msg;
+        int msgsLeft = 0;
+        while ((msg = curl_multi_info_read(client->multi, &msgsLeft)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* handle = msg->easy_handle;
+            CURLcode result = msg->data.result;
+            curl_client_transfer_t* transfer = NULL;
+            curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&transfer);
+            curl_multi_remove_handle(client->multi, handle);
+            nrOfActiveTransfers -= 1;
+            curlClient_completeTransfer(transfer, result);
+        }
+
+        if (running || nrOfActiveTransfers > 0) {
+            curl_multi_poll(client->multi, NULL, 0, CURL_CLIENT_MULTI_POLL_TIMEOUT_MS, NULL);
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CURL_CLIENT_DFI_H
+#define CELIX_CURL_CLIENT_DFI_H
+
+#include <stdbool.h>
+#include <curl/curl.h>
+
+#include "celix_errno.h"
+#include "celix_log_helper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The HTTP client of the RSA DFI.
+ *
+ * The client keeps a pool of idle curl easy handles per imported endpoint. Curl keeps the (keep-alive) connections
+ * of an easy handle alive after a transfer, so reusing a pooled handle for the same endpoint avoids the connection
+ * setup for every remote call.
+ *
+ * Optionally the transfers are performed by a single event loop thread using a curl multi handle. The calling threads
+ * only wait for the completion of their transfer and all transfers share the connection cache of the multi handle.
+ */
+typedef struct curl_client curl_client_t;
+
+typedef struct curl_client_config {
+    unsigned int maxIdleHandlesPerEndpoint; //0 disables pooling, every transfer will use a new easy handle
+    bool useMultiHandle; //whether the transfers are performed by a curl multi event loop thread
+    long maxHostConnections; //max number of connections per host for the multi handle, 0 means unlimited
+} curl_client_config_t;
+
+celix_status_t curlClient_create(celix_log_helper_t* logHelper, const curl_client_config_t* config, curl_client_t** out);
+
+void curlClient_destroy(curl_client_t* client);
+
+/**
+ * @brief Acquires a curl easy handle for the given endpoint, an idle pooled handle is reused if available.
+ * @return A (reset) easy handle or NULL if no handle could be created.
+ */
+CURL* curlClient_acquireHandle(curl_client_t* client, const char* endpointId);
+
+/**
+ * @brief Releases a curl easy handle acquired with curlClient_acquireHandle.
+ * The handle options are reset and, if the pool for the endpoint is not full, the handle is kept for reuse.
+ */
+void curlClient_releaseHandle(curl_client_t* client, const char* endpointId, CURL* handle);
+
+/**
+ * @brief Performs the transfer configured on the easy handle.
+ * If the multi handle is used, the transfer is handed over to the event loop thread and the calling thread waits
+ * for completion.
+ */
+CURLcode curlClient_perform(curl_client_t* client, CURL* handle);
+
+/**
+ * @brief Adds the pool of idle handles for the given endpoint. Handles are only pooled for added endpoints.
+ */
+void curlClient_addEndpoint(curl_client_t* client, const char* endpointId);
+
+/**
+ * @brief Removes (and cleans up) the pooled handles of the given endpoint.
+ * A handle which is released after the endpoint is removed (e.g. of a call in flight) is cleaned up.
+ */
+void curlClient_removeEndpoint(curl_client_t* client, const char* endpointId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CURL_CLIENT_DFI_H
@@ -19,6 +19,7 @@
 
 #include <jansson.h>
 #include <dyn_interface.h>
+#include <dyn_interface_plan.h>
 #include <remote_constants.h>
 #include <remote_service_admin.h>
 #include <service_tracker_customizer.h>
@@ -42,6 +43,7 @@ struct export_registration {
     struct export_reference exportReference;
     char *servId;
     dyn_interface_type *intf; //owner
+    dyn_interface_plan *intfPlan; //owner
     char filter[32];
 
 
@@ -109,6 +111,11 @@ celix_status_t exportRegistration_create(celix_log_helper_t *helper, service_ref
         status = exportRegistration_findAndParseInterfaceDescriptor(helper, context, bundle, exports, &reg->intf);
     }
 
+    if (status == CELIX_SUCCESS && dynInterfacePlan_create(reg->intf, &reg->intfPlan) != 0) {
+        celix_logHelper_logTssErrors(helper, CELIX_LOG_LEVEL_ERROR);
+        status = CELIX_ENOMEM;
+    }
+
     if (status == CELIX_SUCCESS) {
         /* Add the interface version as a property in the properties_map */
         const char* intfVersion = dynInterface_getVersionString(reg->intf);
@@ -169,7 +176,7 @@ celix_status_t exportRegistration_call(export_registration_t *export, char *data
             if (cont) {
                 celixThreadMutex_lock(&export->mutex);
                 if (export->active && export->service != NULL) {
-                    int rc = jsonRpc_call(export->intf, export->service, data, &response);
+                    int rc = jsonRpc_callWithPlan(export->intfPlan, export->service, data, &response);
                     status = (rc != 0) ? CELIX_SERVICE_EXCEPTION : CELIX_SUCCESS;
                     if (rc != 0) {
                         celix_logHelper_logTssErrors(export->helper, CELIX_LOG_LEVEL_ERROR);
@@ -227,6 +234,8 @@ static celix_status_t exportRegistration_findAndParseInterfaceDescriptor(celix_l
 
 static void exportRegistration_destroyCallback(void* data) {
     export_registration_t* reg = data;
+    dynInterfacePlan_destroy(reg->intfPlan);
+    reg->intfPlan = NULL;
     if (reg->intf != NULL) {
         dyn_interface_type *intf = reg->intf;
         reg->intf = NULL;
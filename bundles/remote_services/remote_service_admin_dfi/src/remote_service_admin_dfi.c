@@ -39,6 +39,7 @@
 #include "import_registration_dfi.h"
 #include "export_registration_dfi.h"
 #include "remote_service_admin_dfi.h"
+#include "curl_client_dfi.h"
 #include "json_rpc.h"
 
 #include "remote_constants.h"
@@ -111,6 +112,8 @@ struct remote_service_admin {
     pthread_mutex_t curlMutexConnect;
     pthread_mutex_t curlMutexCookie;
     pthread_mutex_t curlMutexDns;
+
+    curl_client_t *curlClient;
 };
 
 struct celix_post_data {
@@ -260,6 +263,25 @@ celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote
             status = EPERM;
         }
 
+        curl_client_config_t curlClientConfig;
+        long maxIdleHandles = celix_bundleContext_getPropertyAsLong(context, RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT,
+                RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT_DEFAULT);
+        if (maxIdleHandles < 0) {
+            celix_logHelper_warning((*admin)->loghelper, "RSA_DFI: Invalid %s %ld, pooling of curl handles is disabled.",
+                                    RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT, maxIdleHandles);
+            maxIdleHandles = 0;
+        } else if ((unsigned long)maxIdleHandles > UINT_MAX) {
+            maxIdleHandles = UINT_MAX;
+        }
+        curlClientConfig.maxIdleHandlesPerEndpoint = (unsigned int)maxIdleHandles;
+        curlClientConfig.useMultiHandle = celix_bundleContext_getPropertyAsBool(context, RSA_DFI_USE_CURL_MULTI_HANDLE,
+                RSA_DFI_USE_CURL_MULTI_HANDLE_DEFAULT);
+        curlClientConfig.maxHostConnections = celix_bundleContext_getPropertyAsLong(context,
+                RSA_DFI_CURL_MAX_HOST_CONNECTIONS, RSA_DFI_CURL_MAX_HOST_CONNECTIONS_DEFAULT);
+        if (status == CELIX_SUCCESS) {
+            status = curlClient_create((*admin)->loghelper, &curlClientConfig, &(*admin)->curlClient);
+        }
+
         remoteServiceAdmin_setupStopExportsThread(*admin);
 
         // Prepare callbacks structure. We have only one callback, the rest are NULL.
@@ -326,6 +348,7 @@ celix_status_t remoteServiceAdmin_destroy(remote_service_admin_t **admin) {
     free((*admin)->discoveryInterface);
     free((*admin)->ip);
     free((*admin)->port);
+    curlClient_destroy((*admin)->curlClient);
     curl_share_cleanup((*admin)->curlShare);
     pthread_mutex_destroy(&(*admin)->curlMutexConnect);
     pthread_mutex_destroy(&(*admin)->curlMutexCookie);
@@ -911,6 +934,7 @@ celix_status_t remoteServiceAdmin_importService(remote_service_admin_t *admin, e
                       objectClass);
 
         if (objectClass != NULL) {
+            curlClient_addEndpoint(admin->curlClient, endpointDescription->id);
             status = importRegistration_create(admin->context, endpointDescription, objectClass, serviceVersion,
                                                (send_func_type )remoteServiceAdmin_send, admin,
                                                admin->logFile,
@@ -956,6 +980,7 @@ celix_status_t remoteServiceAdmin_removeImportedService(remote_service_admin_t *
         current = celix_arrayList_get(admin->importedServices, i);
         if (current == registration) {
             celix_arrayList_removeAt(admin->importedServices, i);
+            curlClient_removeEndpoint(admin->curlClient, importRegistration_getEndpointDescription(registration)->id);
             remoteServiceAdmin_removeDynamicIpUrlOfImportedRegistration(admin, registration);
             importRegistration_destroy(current);
             break;
@@ -1039,10 +1064,15 @@ celix_status_t (*useUrl)(void* handle, const char* url), void* handle) {
     return status;
 }
 
+struct celix_curl_transfer {
+    curl_client_t *client;
+    CURL *curl;
+};
+
 static celix_status_t onUseUrlCallback(void* handle, const char* url) {
-    CURL *curl = handle;
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    CURLcode ret = curl_easy_perform(curl);
+    struct celix_curl_transfer *transfer = handle;
+    curl_easy_setopt(transfer->curl, CURLOPT_URL, url);
+    CURLcode ret = curlClient_perform(transfer->client, transfer->curl);
     if (ret != CURLE_OK) {
         return CELIX_ERROR_MAKE(CELIX_FACILITY_CURL, ret);
     }
@@ -1085,7 +1115,7 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
     CURL *curl;
     CURLcode res;
 
-    curl = curl_easy_init();
+    curl = curlClient_acquireHandle(rsa->curlClient, endpointDescription->id);
     if(!curl) {
         fclose(get.stream);
         free(get.buf);
@@ -1118,10 +1148,11 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
         const char *ipaddresses = celix_properties_get(endpointDescription->properties, CELIX_RSA_IP_ADDRESSES, NULL);
         if (ipaddresses == NULL) {
             curl_easy_setopt(curl, CURLOPT_URL, url);
-            res = curl_easy_perform(curl);
+            res = curlClient_perform(rsa->curlClient, curl);
             status = (res == CURLE_OK) ? CELIX_SUCCESS:CELIX_ERROR_MAKE(CELIX_FACILITY_CURL,res);
         } else {
-            status = remoteServiceAdmin_useDynamicIpUrlsForEndpoint(rsa, endpointDescription, onUseUrlCallback, curl);
+            struct celix_curl_transfer transfer = {rsa->curlClient, curl};
+            status = remoteServiceAdmin_useDynamicIpUrlsForEndpoint(rsa, endpointDescription, onUseUrlCallback, &transfer);
         }
 
         fputc('\0', get.stream);
@@ -1133,7 +1164,7 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
             status = (httpCode == 200/*HTTP OK*/) ? CELIX_SUCCESS : CELIX_ERROR_MAKE(CELIX_FACILITY_HTTP,httpCode);
         }
 
-        curl_easy_cleanup(curl);
+        curlClient_releaseHandle(rsa->curlClient, endpointDescription->id, curl);
         curl_slist_free_all(metadataHeader);
     }
 
@@ -52,6 +52,51 @@
  */
 #define RSA_DFI_USE_CURL_SHARE_HANDLE_DEFAULT   false
 
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT") which
+ * specifies the max number of idle curl easy handles kept per imported endpoint.
+ *
+ * Curl keeps the connections of an easy handle alive after a transfer, so reusing pooled handles avoids a new
+ * connection setup for every remote call. If set to 0, a new easy handle is created (and cleaned up) for every call.
+ *
+ * The property is of the type long and the default is 4
+ */
+#define RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT "RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT
+ */
+#define RSA_DFI_CURL_MAX_IDLE_HANDLES_PER_ENDPOINT_DEFAULT 4
+
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_USE_CURL_MULTI_HANDLE") which specifies
+ * whether remote calls are performed by a single event loop thread using a curl multi handle.
+ *
+ * If enabled, the calling threads only wait for the completion of their transfer and all transfers share the
+ * connection cache of the multi handle, so many concurrent proxies can be multiplexed over a few connections.
+ *
+ * The property is of the type boolean and the default is false
+ */
+#define RSA_DFI_USE_CURL_MULTI_HANDLE "RSA_DFI_USE_CURL_MULTI_HANDLE"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_USE_CURL_MULTI_HANDLE
+ */
+#define RSA_DFI_USE_CURL_MULTI_HANDLE_DEFAULT false
+
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_CURL_MAX_HOST_CONNECTIONS") which specifies
+ * the max number of connections per host when RSA_DFI_USE_CURL_MULTI_HANDLE is enabled.
+ *
+ * The property is of the type long and the default is 0 (unlimited)
+ */
+#define RSA_DFI_CURL_MAX_HOST_CONNECTIONS "RSA_DFI_CURL_MAX_HOST_CONNECTIONS"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_CURL_MAX_HOST_CONNECTIONS
+ */
+#define RSA_DFI_CURL_MAX_HOST_CONNECTIONS_DEFAULT 0
+
 /**
  * @brief Remote Service Admin DFI environment property (named "CELIX_RSA_BIND_ON_ALL_INTERFACES") which specifies
  * whether the RSA server is reachable from all network interfaces.
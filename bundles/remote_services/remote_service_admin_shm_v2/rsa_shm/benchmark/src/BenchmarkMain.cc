@@ -16,21 +16,6 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <benchmark/benchmark.h>
 
-#ifndef CELIX_THPOOL_EI_H
-#define CELIX_THPOOL_EI_H
-#ifdef __cplusplus
-extern "C" {
-#endif
-#include "celix_error_injector.h"
-#include "thpool.h"
-
-CELIX_EI_DECLARE(thpool_init, struct thpool_*);
-
-CELIX_EI_DECLARE(thpool_add_work, int);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif //CELIX_THPOOL_EI_H
+BENCHMARK_MAIN();
\ No newline at end of file
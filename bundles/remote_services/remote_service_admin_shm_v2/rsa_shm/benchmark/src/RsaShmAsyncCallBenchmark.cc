@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "rsa_shm_server.h"
+#include "rsa_shm_client.h"
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_framework_factory.h"
+#include "celix_log_helper.h"
+#include "celix_properties.h"
+
+/**
+ * Benchmark for the synchronous and asynchronous message exchange of the RSA SHM client and server.
+ *
+ * A RSA SHM server with an echo callback and a RSA SHM client manager are created in the same process. The
+ * synchronous calls block the calling thread until the reply is received, the asynchronous calls keep a
+ * configurable number of calls in flight from a single calling thread.
+ */
+class RsaShmAsyncCallBenchmark {
+public:
+    RsaShmAsyncCallBenchmark() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".rsa_shm_benchmark_cache");
+        celix_properties_set(props, "CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
+        fw = celix_frameworkFactory_createFramework(props);
+        auto* ctx = celix_framework_getFrameworkContext(fw);
+        logHelper = celix_logHelper_create(ctx, "RsaShmBenchmark");
+        if (rsaShmServer_create(ctx, SERVER_NAME, logHelper, echo, nullptr, &server) == CELIX_SUCCESS &&
+            rsaShmClientManager_create(ctx, logHelper, &clientManager) == CELIX_SUCCESS &&
+            rsaShmClientManager_createOrAttachClient(clientManager, SERVER_NAME, SERVICE_ID) == CELIX_SUCCESS) {
+            metadata = celix_properties_create();
+        }
+    }
+
+    ~RsaShmAsyncCallBenchmark() noexcept {
+        celix_properties_destroy(metadata);
+        if (clientManager != nullptr) {
+            rsaShmClientManager_destroyOrDetachClient(clientManager, SERVER_NAME, SERVICE_ID);
+            rsaShmClientManager_destroy(clientManager);
+        }
+        rsaShmServer_destroy(server);
+        celix_logHelper_destroy(logHelper);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    RsaShmAsyncCallBenchmark(RsaShmAsyncCallBenchmark&&) = delete;
+    RsaShmAsyncCallBenchmark(const RsaShmAsyncCallBenchmark&) = delete;
+    RsaShmAsyncCallBenchmark& operator=(RsaShmAsyncCallBenchmark&&) = delete;
+    RsaShmAsyncCallBenchmark& operator=(const RsaShmAsyncCallBenchmark&) = delete;
+
+    bool isValid() const {
+        return metadata != nullptr;
+    }
+
+    bool call() {
+        struct iovec response = {nullptr, 0};
+        auto status = rsaShmClientManager_sendMsgTo(clientManager, SERVER_NAME, SERVICE_ID, metadata, &request, &response);
+        free(response.iov_base);
+        return status == CELIX_SUCCESS;
+    }
+
+    /**
+     * @brief Starts an async call, after waiting until less than maxInFlight calls are in flight.
+     */
+    bool callAsync(long maxInFlight) {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            cond.wait(lock, [this, maxInFlight]() { return nrOfInFlightCalls < maxInFlight; });
+            nrOfInFlightCalls += 1;
+        }
+        auto status = rsaShmClientManager_sendMsgToAsync(clientManager, SERVER_NAME, SERVICE_ID, metadata, &request,
+                                                         completed, this);
+        if (status != CELIX_SUCCESS) {
+            std::lock_guard<std::mutex> lock{mutex};
+            nrOfInFlightCalls -= 1;
+        }
+        return status == CELIX_SUCCESS && nrOfFailedCalls.load() == 0;
+    }
+
+    void waitForInFlightCalls() {
+        std::unique_lock<std::mutex> lock{mutex};
+        cond.wait(lock, [this]() { return nrOfInFlightCalls == 0; });
+    }
+
+private:
+    static constexpr const char* SERVER_NAME = "rsa_shm_benchmark_server";
+    static constexpr long SERVICE_ID = 100; //dummy id
+
+    static celix_status_t echo(void* /*handle*/, rsa_shm_server_t* /*server*/, celix_properties_t* /*metadata*/,
+                               const struct iovec* request, struct iovec* response) {
+        response->iov_base = malloc(request->iov_len);
+        if (response->iov_base == nullptr) {
+            return CELIX_ENOMEM;
+        }
+        memcpy(response->iov_base, request->iov_base, request->iov_len);
+        response->iov_len = request->iov_len;
+        return CELIX_SUCCESS;
+    }
+
+    static void completed(void* data, celix_status_t status, struct iovec* response) {
+        auto* benchmark = static_cast<RsaShmAsyncCallBenchmark*>(data);
+        free(response->iov_base);
+        if (status != CELIX_SUCCESS) {
+            benchmark->nrOfFailedCalls.fetch_add(1);
+        }
+        std::lock_guard<std::mutex> lock{benchmark->mutex};
+        benchmark->nrOfInFlightCalls -= 1;
+        benchmark->cond.notify_all();
+    }
+
+    celix_framework_t* fw{nullptr};
+    celix_log_helper_t* logHelper{nullptr};
+    rsa_shm_server_t* server{nullptr};
+    rsa_shm_client_manager_t* clientManager{nullptr};
+    celix_properties_t* metadata{nullptr};
+    const struct iovec request{(void*)"{\"m\":\"add(DD)D\",\"a\":[1.0,2.0]}", strlen("{\"m\":\"add(DD)D\",\"a\":[1.0,2.0]}") + 1};
+
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    long nrOfInFlightCalls{0}; //protected by mutex
+    std::atomic<long> nrOfFailedCalls{0};
+};
+
+static void syncCall(benchmark::State& state) {
+    static std::unique_ptr<RsaShmAsyncCallBenchmark> env{};
+    if (state.thread_index() == 0) {
+        env = std::make_unique<RsaShmAsyncCallBenchmark>();
+        if (!env->isValid()) {
+            state.SkipWithError("Cannot create the rsa shm server and client");
+        }
+    }
+
+    for (auto _ : state) {
+        // This code gets timed
+        if (!env->call()) {
+            state.SkipWithError("Call failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        env.reset();
+    }
+}
+
+static void asyncCall(benchmark::State& state) {
+    auto env = std::make_unique<RsaShmAsyncCallBenchmark>();
+    if (!env->isValid()) {
+        state.SkipWithError("Cannot create the rsa shm server and client");
+        return;
+    }
+    const long maxInFlight = state.range(0);
+
+    for (auto _ : state) {
+        // This code gets timed
+        if (!env->callAsync(maxInFlight)) {
+            state.SkipWithError("Async call failed");
+            break;
+        }
+    }
+    env->waitForInFlightCalls();
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(syncCall)->UseRealTime()->Unit(benchmark::kMicrosecond)->ThreadRange(1, 8);
+BENCHMARK(asyncCall)->UseRealTime()->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(1, 64);
@@ -18,6 +18,7 @@
  */
 #include "rsa_shm_server.h"
 #include "rsa_shm_client.h"
+#include "rsa_shm_work_pool.h"
 #include "shm_pool.h"
 #include "shm_cache.h"
 #include "rsa_shm_constants.h"
@@ -35,10 +36,11 @@
 #include "socket_ei.h"
 #include "stdio_ei.h"
 #include "pthread_ei.h"
-#include "thpool_ei.h"
 #include "celix_errno.h"
 #include <errno.h>
 #include <unistd.h>
+#include <condition_variable>
+#include <mutex>
 #include <gtest/gtest.h>
 
 class RsaShmClientServerUnitTestSuite : public ::testing::Test {
@@ -78,11 +80,17 @@ public:
         celix_ei_expect_pthread_condattr_setpshared(nullptr, 1, 0);
         celix_ei_expect_pthread_cond_init(nullptr, 1, 0);
         celix_ei_expect_pthread_cond_timedwait(nullptr, 1, 0);
-        celix_ei_expect_thpool_init(nullptr, 0, nullptr);
-        celix_ei_expect_thpool_add_work(nullptr, 0, 0);
+        celix_ei_expect_calloc(nullptr, 0, nullptr);
     }
 
 
+    static std::shared_ptr<celix_framework_t> createFrameworkWithConfig(celix_properties_t* props) {
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".rsa_shm_client_server_test_config_cache");
+        auto* fwPtr = celix_frameworkFactory_createFramework(props);
+        return std::shared_ptr<celix_framework_t>{fwPtr, [](auto* f) {celix_frameworkFactory_destroyFramework(f);}};
+    }
+
     std::shared_ptr<celix_framework_t> fw{};
     std::shared_ptr<celix_bundle_context_t> ctx{};
     std::shared_ptr<celix_log_helper_t> logHelper{};
@@ -139,6 +147,136 @@ TEST_F(RsaShmClientServerUnitTestSuite, SendMsg) {
     rsaShmServer_destroy(server);
 }
 
+TEST_F(RsaShmClientServerUnitTestSuite, SendMsgAsync) {
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, server);
+
+    rsa_shm_client_manager_t *clientManager = nullptr;
+    status = rsaShmClientManager_create(ctx.get(), logHelper.get(), &clientManager);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, clientManager);
+
+    long serverId = 100;//dummy id
+    status = rsaShmClientManager_createOrAttachClient(clientManager, "shm_test_server", serverId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    struct AsyncResult {
+        std::mutex mutex{};
+        std::condition_variable cond{};
+        int nrOfCompletedCalls{0};
+        int nrOfReplies{0};
+    } result{};
+    auto completion = [](void *data, celix_status_t status, struct iovec *response) {
+        auto* result = static_cast<AsyncResult*>(data);
+        std::lock_guard<std::mutex> lock{result->mutex};
+        if (status == CELIX_SUCCESS && response->iov_base != nullptr && strcmp("reply", (char*)response->iov_base) == 0) {
+            result->nrOfReplies += 1;
+        }
+        free(response->iov_base);
+        result->nrOfCompletedCalls += 1;
+        result->cond.notify_all();
+    };
+
+    const int nrOfCalls = 10;
+    celix_properties_t *metadata = celix_properties_create();
+    celix_properties_set(metadata, "CustomKey", "test");
+    struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
+    for (int i = 0; i < nrOfCalls; ++i) {
+        status = rsaShmClientManager_sendMsgToAsync(clientManager, "shm_test_server", serverId, metadata, &request,
+                                                    completion, &result);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }
+    celix_properties_destroy(metadata);
+
+    {
+        std::unique_lock<std::mutex> lock{result.mutex};
+        bool completed = result.cond.wait_for(lock, std::chrono::seconds{10}, [&result]() {
+            return result.nrOfCompletedCalls == nrOfCalls;
+        });
+        EXPECT_TRUE(completed);
+        EXPECT_EQ(nrOfCalls, result.nrOfReplies);
+    }
+
+    rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
+
+    rsaShmClientManager_destroy(clientManager);
+
+    rsaShmServer_destroy(server);
+}
+
+TEST_F(RsaShmClientServerUnitTestSuite, SendMsgAsyncToBusyServer) {
+    auto* config = celix_properties_create();
+    celix_properties_setLong(config, RSA_SHM_SERVER_MIN_THREADS_KEY, 1);
+    celix_properties_setLong(config, RSA_SHM_SERVER_MAX_THREADS_KEY, 1);
+    celix_properties_setLong(config, RSA_SHM_SERVER_MAX_QUEUE_DEPTH_KEY, 1);
+    auto busyFw = createFrameworkWithConfig(config);
+    auto* busyCtx = celix_framework_getFrameworkContext(busyFw.get());
+
+    rsa_shm_server_t *server = nullptr;
+    auto status = rsaShmServer_create(busyCtx, "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, server);
+
+    rsa_shm_client_manager_t *clientManager = nullptr;
+    status = rsaShmClientManager_create(busyCtx, logHelper.get(), &clientManager);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    EXPECT_NE(nullptr, clientManager);
+
+    long serverId = 100;//dummy id
+    status = rsaShmClientManager_createOrAttachClient(clientManager, "shm_test_server", serverId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    struct AsyncResult {
+        std::mutex mutex{};
+        std::condition_variable cond{};
+        int nrOfCompletedCalls{0};
+        int nrOfBusyReplies{0};
+    } result{};
+    auto completion = [](void *data, celix_status_t status, struct iovec *response) {
+        auto* result = static_cast<AsyncResult*>(data);
+        std::lock_guard<std::mutex> lock{result->mutex};
+        if (status == CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EBUSY)) {
+            result->nrOfBusyReplies += 1;
+        }
+        free(response->iov_base);
+        result->nrOfCompletedCalls += 1;
+        result->cond.notify_all();
+    };
+
+    //One call is handled by the only worker, the queue holds one call, so at least one call is rejected
+    expect_ReceiveMsgCallback_blocked = true;
+    const int nrOfCalls = 3;
+    struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
+    for (int i = 0; i < nrOfCalls; ++i) {
+        status = rsaShmClientManager_sendMsgToAsync(clientManager, "shm_test_server", serverId, nullptr, &request,
+                                                    completion, &result);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }
+    {
+        std::unique_lock<std::mutex> lock{result.mutex};
+        bool rejected = result.cond.wait_for(lock, std::chrono::seconds{10}, [&result]() {
+            return result.nrOfBusyReplies > 0;
+        });
+        EXPECT_TRUE(rejected);
+    }
+    expect_ReceiveMsgCallback_blocked = false;
+    {
+        std::unique_lock<std::mutex> lock{result.mutex};
+        bool completed = result.cond.wait_for(lock, std::chrono::seconds{10}, [&result]() {
+            return result.nrOfCompletedCalls == nrOfCalls;
+        });
+        EXPECT_TRUE(completed);
+    }
+
+    rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
+
+    rsaShmClientManager_destroy(clientManager);
+
+    rsaShmServer_destroy(server);
+}
+
 TEST_F(RsaShmClientServerUnitTestSuite, SendMsgWithNoServer) {
     rsa_shm_client_manager_t *clientManager = nullptr;
     auto status = rsaShmClientManager_create(ctx.get(), logHelper.get(), &clientManager);
@@ -210,6 +348,15 @@ TEST_F(RsaShmClientServerUnitTestSuite, CreateRsaShmClientManagerWithInvalidPara
     EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
 }
 
+TEST_F(RsaShmClientServerUnitTestSuite, CreateRsaShmClientManagerWithNegativeConfig) {
+    auto* config = celix_properties_create();
+    celix_properties_setLong(config, RSA_SHM_MSG_TIMEOUT_KEY, -1);
+    auto invalidFw = createFrameworkWithConfig(config);
+    rsa_shm_client_manager_t *clientManager = nullptr;
+    auto status = rsaShmClientManager_create(celix_framework_getFrameworkContext(invalidFw.get()), logHelper.get(), &clientManager);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
+}
+
 TEST_F(RsaShmClientServerUnitTestSuite, CreateRsaShmClientManagerWithENOMEM) {
     rsa_shm_client_manager_t *clientManager = nullptr;
     celix_ei_expect_malloc((void*)&rsaShmClientManager_create, 0, nullptr);
@@ -717,6 +864,19 @@ TEST_F(RsaShmClientServerUnitTestSuite, CreateShmServerWithInvalidParams) {
     EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status);
 }
 
+TEST_F(RsaShmClientServerUnitTestSuite, CreateShmServerWithNegativeConfig) {
+    for (const char* key : {RSA_SHM_MSG_TIMEOUT_KEY, RSA_SHM_SERVER_MIN_THREADS_KEY, RSA_SHM_SERVER_MAX_THREADS_KEY,
+                            RSA_SHM_SERVER_MAX_QUEUE_DEPTH_KEY}) {
+        auto* config = celix_properties_create();
+        celix_properties_setLong(config, key, -1);
+        auto invalidFw = createFrameworkWithConfig(config);
+        rsa_shm_server_t *server = nullptr;
+        auto status = rsaShmServer_create(celix_framework_getFrameworkContext(invalidFw.get()), "shm_test_server",
+                                          logHelper.get(), ReceiveMsgCallback, nullptr, &server);
+        EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, status) << key;
+    }
+}
+
 TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToDupServerName) {
     celix_ei_expect_celix_utils_strdup((void*)&rsaShmServer_create, 0, nullptr);
     rsa_shm_server_t *server = nullptr;
@@ -745,11 +905,11 @@ TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateShmCache) {
     EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
-TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateThpool) {
-    celix_ei_expect_thpool_init((void*)&rsaShmServer_create, 0, nullptr);
+TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateWorkPool) {
+    celix_ei_expect_calloc((void*)&rsaShmWorkPool_create, 0, nullptr);
     rsa_shm_server_t *server = nullptr;
     auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallbackWithBigResponse, nullptr, &server);
-    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
+    EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
 TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateReceiveThread) {
@@ -758,32 +918,3 @@ TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToCreateReceiveThread) {
     auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallbackWithBigResponse, nullptr, &server);
     EXPECT_EQ(CELIX_ENOMEM, status);
 }
-
-TEST_F(RsaShmClientServerUnitTestSuite, ShmServerFailedToAddWorkToThpool) {
-    rsa_shm_server_t *server = nullptr;
-    auto status = rsaShmServer_create(ctx.get(), "shm_test_server", logHelper.get(), ReceiveMsgCallback, nullptr, &server);
-    EXPECT_EQ(CELIX_SUCCESS, status);
-    EXPECT_NE(nullptr, server);
-
-    rsa_shm_client_manager_t *clientManager = nullptr;
-    status = rsaShmClientManager_create(ctx.get(), logHelper.get(), &clientManager);
-    EXPECT_EQ(CELIX_SUCCESS, status);
-    EXPECT_NE(nullptr, clientManager);
-
-    long serverId = 100;//dummy id
-    status = rsaShmClientManager_createOrAttachClient(clientManager, "shm_test_server", serverId);
-    EXPECT_EQ(CELIX_SUCCESS, status);
-
-
-    celix_ei_expect_thpool_add_work(CELIX_EI_UNKNOWN_CALLER, 0, -1);
-    struct iovec request = {.iov_base = (void*)"request", .iov_len = strlen("request")};
-    struct iovec response = {.iov_base = nullptr, .iov_len = 0};
-    status = rsaShmClientManager_sendMsgTo(clientManager, "shm_test_server", serverId, nullptr, &request, &response);
-    EXPECT_EQ(CELIX_ILLEGAL_STATE, status);
-
-    rsaShmClientManager_destroyOrDetachClient(clientManager, "shm_test_server", serverId);
-
-    rsaShmClientManager_destroy(clientManager);
-
-    rsaShmServer_destroy(server);
-}
\ No newline at end of file
@@ -0,0 +1,194 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "rsa_shm_work_pool.h"
+#include "celix_log_helper.h"
+#include "celix_framework.h"
+#include "celix_framework_factory.h"
+#include "celix_properties.h"
+#include "celix_constants.h"
+#include "malloc_ei.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <gtest/gtest.h>
+
+class RsaShmWorkPoolUnitTestSuite : public ::testing::Test {
+public:
+    RsaShmWorkPoolUnitTestSuite() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(props, CELIX_FRAMEWORK_CACHE_DIR, ".rsa_shm_work_pool_test_cache");
+        auto* fwPtr = celix_frameworkFactory_createFramework(props);
+        auto* ctxPtr = celix_framework_getFrameworkContext(fwPtr);
+        fw = std::shared_ptr<celix_framework_t>{fwPtr, [](auto* f) {celix_frameworkFactory_destroyFramework(f);}};
+        auto* logHelperPtr = celix_logHelper_create(ctxPtr,"RsaShmWorkPool");
+        logHelper = std::shared_ptr<celix_log_helper_t>{logHelperPtr, [](auto*l){ celix_logHelper_destroy(l);}};
+    }
+
+    ~RsaShmWorkPoolUnitTestSuite() override {
+        celix_ei_expect_calloc(nullptr, 0, nullptr);
+    }
+
+    /**
+     * @brief A work which blocks until it is released.
+     */
+    struct BlockingWorks {
+        std::mutex mutex{};
+        std::condition_variable cond{};
+        bool released{false};
+        int nrOfStartedWorks{0};
+        int nrOfDoneWorks{0};
+
+        static void work(void* data) {
+            auto* works = static_cast<BlockingWorks*>(data);
+            std::unique_lock<std::mutex> lock{works->mutex};
+            works->nrOfStartedWorks += 1;
+            works->cond.notify_all();
+            works->cond.wait(lock, [works]() { return works->released; });
+            works->nrOfDoneWorks += 1;
+        }
+
+        bool waitForStartedWorks(int nrOfWorks) {
+            std::unique_lock<std::mutex> lock{mutex};
+            return cond.wait_for(lock, std::chrono::seconds{5}, [this, nrOfWorks]() { return nrOfStartedWorks == nrOfWorks; });
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock{mutex};
+            released = true;
+            cond.notify_all();
+        }
+    };
+
+    static bool waitForNrOfThreads(rsa_shm_work_pool_t* pool, unsigned int nrOfThreads) {
+        for (int i = 0; i < 500 && rsaShmWorkPool_nrOfThreads(pool) != nrOfThreads; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return rsaShmWorkPool_nrOfThreads(pool) == nrOfThreads;
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    std::shared_ptr<celix_log_helper_t> logHelper{};
+};
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, CreateWorkPoolWithInvalidParams) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{1, 4, 16, 1000};
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(nullptr, &config, &pool));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), nullptr, &pool));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), &config, nullptr));
+
+    rsa_shm_work_pool_config_t noThreads{0, 0, 16, 1000};
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), &noThreads, &pool));
+    rsa_shm_work_pool_config_t minGreaterThanMax{5, 4, 16, 1000};
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), &minGreaterThanMax, &pool));
+    rsa_shm_work_pool_config_t noQueue{1, 4, 0, 1000};
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), &noQueue, &pool));
+    rsa_shm_work_pool_config_t noIdleTimeout{1, 4, 16, 0};
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_create(logHelper.get(), &noIdleTimeout, &pool));
+}
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, CreateWorkPoolWithENOMEM) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{1, 4, 16, 1000};
+    celix_ei_expect_calloc((void*)&rsaShmWorkPool_create, 0, nullptr);
+    EXPECT_EQ(CELIX_ENOMEM, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+
+    celix_ei_expect_calloc((void*)&rsaShmWorkPool_create, 0, nullptr, 2);
+    EXPECT_EQ(CELIX_ENOMEM, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+}
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, SubmitWorks) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{2, 4, 16, 1000};
+    ASSERT_EQ(CELIX_SUCCESS, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+    EXPECT_EQ(2, rsaShmWorkPool_nrOfThreads(pool));
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; ++i) {
+        auto status = rsaShmWorkPool_submit(pool, [](void* data) {
+            static_cast<std::atomic<int>*>(data)->fetch_add(1);
+        }, &count);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }
+    //destroy waits until all submitted works are done
+    rsaShmWorkPool_destroy(pool);
+    EXPECT_EQ(1000, count.load());
+}
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, SubmitWorkWithInvalidParams) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{1, 1, 16, 1000};
+    ASSERT_EQ(CELIX_SUCCESS, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_submit(nullptr, BlockingWorks::work, nullptr));
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, rsaShmWorkPool_submit(pool, nullptr, nullptr));
+    rsaShmWorkPool_destroy(pool);
+}
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, GrowAndShrinkWithLoad) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{1, 4, 16, 50};
+    ASSERT_EQ(CELIX_SUCCESS, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+    EXPECT_EQ(1, rsaShmWorkPool_nrOfThreads(pool));
+
+    BlockingWorks works{};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(CELIX_SUCCESS, rsaShmWorkPool_submit(pool, BlockingWorks::work, &works));
+    }
+    //every blocked work is handled by its own thread, if needed by stealing it from the queue of a busy thread
+    EXPECT_TRUE(works.waitForStartedWorks(4));
+    EXPECT_EQ(4, rsaShmWorkPool_nrOfThreads(pool));
+
+    works.release();
+    EXPECT_TRUE(waitForNrOfThreads(pool, 1));
+
+    //the pool grows again for new load
+    BlockingWorks moreWorks{};
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(CELIX_SUCCESS, rsaShmWorkPool_submit(pool, BlockingWorks::work, &moreWorks));
+    }
+    EXPECT_TRUE(moreWorks.waitForStartedWorks(2));
+    moreWorks.release();
+
+    rsaShmWorkPool_destroy(pool);
+    EXPECT_EQ(4, works.nrOfDoneWorks);
+    EXPECT_EQ(2, moreWorks.nrOfDoneWorks);
+}
+
+TEST_F(RsaShmWorkPoolUnitTestSuite, SubmitIsRejectedIfQueueIsFull) {
+    rsa_shm_work_pool_t* pool = nullptr;
+    rsa_shm_work_pool_config_t config{1, 1, 2, 1000};
+    ASSERT_EQ(CELIX_SUCCESS, rsaShmWorkPool_create(logHelper.get(), &config, &pool));
+
+    BlockingWorks works{};
+    EXPECT_EQ(CELIX_SUCCESS, rsaShmWorkPool_submit(pool, BlockingWorks::work, &works));
+    EXPECT_TRUE(works.waitForStartedWorks(1));
+    EXPECT_EQ(CELIX_SUCCESS, rsaShmWorkPool_submit(pool, BlockingWorks::work, &works));
+    EXPECT_EQ(CELIX_SUCCESS, rsaShmWorkPool_submit(pool, BlockingWorks::work, &works));
+    EXPECT_EQ(2, rsaShmWorkPool_queueDepth(pool));
+
+    EXPECT_EQ(RSA_SHM_WORK_POOL_BUSY, rsaShmWorkPool_submit(pool, BlockingWorks::work, &works));
+    EXPECT_EQ(2, rsaShmWorkPool_queueDepth(pool));
+
+    works.release();
+    rsaShmWorkPool_destroy(pool);
+    EXPECT_EQ(3, works.nrOfDoneWorks);
+}
@@ -31,13 +31,17 @@
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/time.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <sys/param.h>
+#include <poll.h>
 #include <assert.h>
 #include <stdbool.h>
 #include <errno.h>
 
+//The interval in which the asynchronous completion thread checks for timed out messages
+#define RSA_SHM_ASYNC_TIMEOUT_CHECK_INTERVAL_IN_MS 200
 
 struct rsa_shm_client_manager {
     celix_bundle_context_t *ctx;
@@ -52,6 +56,11 @@ struct rsa_shm_client_manager {
     celix_array_list_t *exceptionMsgList;
     celix_thread_t msgExceptionHandlerThread;
     bool threadActive;
+    int asyncFd;//It is used to send asynchronous messages and to receive the state change notifications of them
+    celix_thread_mutex_t asyncCallsMutex;//It protects asyncCalls and asyncThreadActive
+    celix_long_hash_map_t *asyncCalls;// Key: offset of msg control data; value: rsa_shm_async_call_t
+    celix_thread_t asyncCompletionThread;
+    bool asyncThreadActive;
 };
 
 struct service_diagnostic_info {
@@ -78,6 +87,21 @@ typedef struct rsa_shm_exception_msg {
     char *peerServerName;
 }rsa_shm_exception_msg_t;
 
+typedef struct rsa_shm_async_call {
+    rsa_shm_msg_control_t *msgCtrl;
+    char *msgBody;
+    size_t msgBodySize;
+    char *reply;
+    size_t replySize;
+    celix_status_t status;
+    bool replied;
+    struct timespec deadline;
+    long serviceId;
+    char *peerServerName;
+    rsaShmClientManager_completionCB callback;
+    void *callbackData;
+}rsa_shm_async_call_t;
+
 typedef struct rsa_shm_msg_control_alloc {
     rsa_shm_msg_control_t *ctrl;
     rsa_shm_client_manager_t *clientManager;
@@ -90,6 +114,12 @@ static void rsaShmClientManager_destroyMsgControl(rsa_shm_msg_control_alloc_t* a
 CELIX_DEFINE_AUTO_CLEANUP_CLEAR_FUNC(rsa_shm_msg_control_alloc_t, rsaShmClientManager_destroyMsgControl)
 
 static void *rsaShmClientManager_exceptionMsgHandlerThread(void *data);
+static void rsaShmClientManager_stopExceptionMsgHandlerThread(rsa_shm_client_manager_t *clientManager);
+static void rsaShmClientManager_addExceptionMsg(rsa_shm_client_manager_t *clientManager,
+        rsa_shm_msg_control_t *msgCtrl, void *msgBuffer, long serviceId, const char *peerServerName);
+static celix_status_t rsaShmClientManager_startAsyncCompletion(rsa_shm_client_manager_t *clientManager);
+static void rsaShmClientManager_stopAsyncCompletion(rsa_shm_client_manager_t *clientManager);
+static void *rsaShmClientManager_asyncCompletionThread(void *data);
 static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t *clientManager,
         const char *peerServerName, rsa_shm_client_t **clientOut);
 static void rsaShmClientManager_destroyClient(rsa_shm_client_t *client);
@@ -109,6 +139,7 @@ static celix_status_t rsaShmClientManager_receiveResponse(rsa_shm_client_manager
 static void rsaShmClient_destroyOrDetachSvcDiagInfo(rsa_shm_client_t *client, long serviceId);
 static void rsaShmClient_createOrAttachSvcDiagInfo(rsa_shm_client_t *client, long serviceId);
 static bool rsaShmClient_shouldBreakInvocation(rsa_shm_client_t *client, long serviceId);
+static celix_status_t rsaShmClientManager_setSendTimeout(rsa_shm_client_manager_t *clientManager, int fd);
 
 celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
         celix_log_helper_t *loghelper, rsa_shm_client_manager_t **clientManagerOut) {
@@ -127,6 +158,12 @@ celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
             RSA_SHM_MAX_CONCURRENT_INVOCATIONS_KEY, RSA_SHM_MAX_CONCURRENT_INVOCATIONS_DEFAULT);
     clientManager->msgTimeOutInSec = celix_bundleContext_getPropertyAsLong(ctx,
             RSA_SHM_MSG_TIMEOUT_KEY, RSA_SHM_MSG_TIMEOUT_DEFAULT_IN_S);
+    if (clientManager->maxConcurrentNum < 0 || clientManager->msgTimeOutInSec < 0) {
+        celix_logHelper_error(loghelper, "RsaShmClient: Invalid value %ld for %s or %ld for %s.",
+                clientManager->maxConcurrentNum, RSA_SHM_MAX_CONCURRENT_INVOCATIONS_KEY,
+                clientManager->msgTimeOutInSec, RSA_SHM_MSG_TIMEOUT_KEY);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
 
     long shmPoolSize = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_MEMORY_POOL_SIZE_KEY,
             RSA_SHM_MEMORY_POOL_SIZE_DEFAULT);
@@ -173,6 +210,12 @@ celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
     }
     celixThread_setName(&clientManager->msgExceptionHandlerThread, "rsaShmMsgLifeManager");
 
+    status = rsaShmClientManager_startAsyncCompletion(clientManager);
+    if (status != CELIX_SUCCESS) {
+        rsaShmClientManager_stopExceptionMsgHandlerThread(clientManager);
+        return status;
+    }
+
     celix_steal_ptr(exceptionMsgList);
     celix_steal_ptr(exceptionMsgListNotEmpty);
     celix_steal_ptr(exceptionMsgListMutex);
@@ -183,12 +226,18 @@ celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
     return CELIX_SUCCESS;
 }
 
-void rsaShmClientManager_destroy(rsa_shm_client_manager_t *clientManager) {
+static void rsaShmClientManager_stopExceptionMsgHandlerThread(rsa_shm_client_manager_t *clientManager) {
     celixThreadMutex_lock(&clientManager->exceptionMsgListMutex);
     clientManager->threadActive = false;
     celixThreadMutex_unlock(&clientManager->exceptionMsgListMutex);
     (void)celixThreadCondition_signal(&clientManager->exceptionMsgListNotEmpty);
     celixThread_join(clientManager->msgExceptionHandlerThread, NULL);
+}
+
+void rsaShmClientManager_destroy(rsa_shm_client_manager_t *clientManager) {
+    //The pending asynchronous messages are handed over to the exception message list, so stop it first.
+    rsaShmClientManager_stopAsyncCompletion(clientManager);
+    rsaShmClientManager_stopExceptionMsgHandlerThread(clientManager);
     size_t listSize = celix_arrayList_size(clientManager->exceptionMsgList);
     for (int i = 0; i < listSize; ++i) {
         rsa_shm_exception_msg_t *exceptionMsg = celix_arrayList_get(clientManager->exceptionMsgList, i);
@@ -318,6 +367,7 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
             .msgBodyTotalSize = msgBodySize,
             .metadataSize = metadataSize,
             .requestSize = request->iov_len,
+            .flags = RSA_SHM_MSG_FLAG_ACCEPT_BUSY_STATE,
     };
     //LCOV_EXCL_START
     if (msgInfo.shmId < 0 || msgInfo.ctrlDataOffset < 0 || msgInfo.msgBodyOffset < 0) {
@@ -351,21 +401,173 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
     if (replied) {
         rsaShmClientManager_markSvcCallFinished(clientManager, peerServerName, serviceId);
     } else {
-        rsa_shm_exception_msg_t *exceptionMsg = (rsa_shm_exception_msg_t *)malloc(sizeof(*exceptionMsg));
-        assert(exceptionMsg != NULL);
-        exceptionMsg->msgCtrl = (rsa_shm_msg_control_t*)celix_steal_ptr(msgCtrlAlloc.ctrl);
-        exceptionMsg->msgBuffer = celix_steal_ptr(msgBodyAlloc.ptr);
-        exceptionMsg->serviceId = serviceId;
-        exceptionMsg->peerServerName = strdup(peerServerName);
-        // Let rsaShmClientManager_exceptionMsgHandlerThread free exception message
-        celixThreadMutex_lock(&clientManager->exceptionMsgListMutex);
-        celix_arrayList_add(clientManager->exceptionMsgList, exceptionMsg);
-        celixThreadMutex_unlock(&clientManager->exceptionMsgListMutex);
-        celixThreadCondition_signal(&clientManager->exceptionMsgListNotEmpty);
+        rsaShmClientManager_addExceptionMsg(clientManager, (rsa_shm_msg_control_t*)celix_steal_ptr(msgCtrlAlloc.ctrl),
+                celix_steal_ptr(msgBodyAlloc.ptr), serviceId, peerServerName);
+    }
+    return status;
+}
+
+static celix_status_t rsaShmClientManager_sendAsyncCall(rsa_shm_client_manager_t *clientManager,
+        rsa_shm_client_t *client, long serviceId, celix_properties_t *metadata, const struct iovec *request,
+        rsaShmClientManager_completionCB callback, void *callbackData) {
+    celix_status_t status = CELIX_SUCCESS;
+    celix_autofree rsa_shm_async_call_t *call = (rsa_shm_async_call_t *)calloc(1, sizeof(*call));
+    if (call == NULL) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error allocating async call.");
+        return CELIX_ENOMEM;
+    }
+    celix_autofree char *peerServerName = call->peerServerName = celix_utils_strdup(client->peerServerName);
+    if (peerServerName == NULL) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error allocating async call.");
+        return CELIX_ENOMEM;
+    }
+
+    size_t metadataStringSize = 0;
+    celix_autofree char* metadataString = NULL;
+    FILE *fp = open_memstream(&metadataString, &metadataStringSize);
+    if (fp == NULL) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error opening metadata memory. %d.", errno);
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    if (metadata != NULL) {
+        CELIX_PROPERTIES_ITERATE(metadata, iter) {
+            fprintf(fp,"%s=%s\n", iter.key, iter.entry.value);
+        }
+    }
+    fclose(fp);
+    // make the metadata include the terminating null byte ('\0')
+    size_t metadataSize = (metadataStringSize == 0) ? 0 : metadataStringSize +1;
+    size_t msgBodySize = MAX((metadataSize + request->iov_len), ESTIMATED_MSG_RESPONSE_SIZE_DEFAULT);
+
+    celix_auto(rsa_shm_msg_control_alloc_t) msgCtrlAlloc = {
+            .ctrl = NULL,
+            .clientManager = clientManager,
+    };
+    status = rsaShmClientManager_createMsgControl(clientManager, &msgCtrlAlloc);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating msg control. %d.", status);
+        return status;
+    }
+    celix_auto(celix_shm_pool_alloc_guard_t) msgBodyAlloc =
+        celix_shmPoolAllocGuard_init(shmPool_malloc(clientManager->shmPool, msgBodySize), clientManager->shmPool);
+    char *msgBody = (char *)msgBodyAlloc.ptr;
+    if (msgBody == NULL) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error allocing msg buffer.");
+        return CELIX_ENOMEM;
+    }
+    if (metadataSize != 0) {
+        memcpy(msgBody, metadataString, metadataSize);
+    }
+    memcpy(msgBody + metadataSize, request->iov_base,request->iov_len);
+
+    rsa_shm_msg_t msgInfo = {
+            .size = sizeof(rsa_shm_msg_t),
+            .shmId = shmPool_getShmId(clientManager->shmPool),
+            .ctrlDataOffset = shmPool_getMemoryOffset(clientManager->shmPool, msgCtrlAlloc.ctrl),
+            .ctrlDataSize = sizeof(rsa_shm_msg_control_t),
+            .msgBodyOffset = shmPool_getMemoryOffset(clientManager->shmPool, msgBody),
+            .msgBodyTotalSize = msgBodySize,
+            .metadataSize = metadataSize,
+            .requestSize = request->iov_len,
+            .flags = RSA_SHM_MSG_FLAG_NOTIFY_STATE_CHANGE | RSA_SHM_MSG_FLAG_ACCEPT_BUSY_STATE,
+    };
+    //LCOV_EXCL_START
+    if (msgInfo.shmId < 0 || msgInfo.ctrlDataOffset < 0 || msgInfo.msgBodyOffset < 0) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Illegal message info.");
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    //LCOV_EXCL_STOP
+
+    call->msgCtrl = msgCtrlAlloc.ctrl;
+    call->msgBody = msgBody;
+    call->msgBodySize = msgBodySize;
+    call->status = CELIX_SUCCESS;
+    call->replied = false;
+    call->deadline = celix_gettime(CLOCK_MONOTONIC);
+    call->deadline.tv_sec += clientManager->msgTimeOutInSec;
+    call->serviceId = serviceId;
+    call->callback = callback;
+    call->callbackData = callbackData;
+
+    celixThreadMutex_lock(&clientManager->asyncCallsMutex);
+    if (!clientManager->asyncThreadActive) {
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        status = celix_longHashMap_put(clientManager->asyncCalls, (long)msgInfo.ctrlDataOffset, call);
+    }
+    celixThreadMutex_unlock(&clientManager->asyncCallsMutex);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error adding async call. %d.", status);
+        return status;
+    }
+
+    while (sendto(clientManager->asyncFd, &msgInfo, sizeof(msgInfo), 0, (struct sockaddr *) &client->serverAddr,
+                  sizeof(struct sockaddr_un)) != sizeof(msgInfo)) {
+        if (errno == EINTR) {
+            continue;
+        }
+        status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error sending message to %s. %d",
+                              client->peerServerName, errno);
+        celixThreadMutex_lock(&clientManager->asyncCallsMutex);
+        bool removed = celix_longHashMap_remove(clientManager->asyncCalls, (long)msgInfo.ctrlDataOffset);
+        celixThreadMutex_unlock(&clientManager->asyncCallsMutex);
+        if (removed) {
+            return status;
+        }
+        //The call has already been completed(timeout) by the completion thread, which is the owner of the call now.
+        break;
+    }
+
+    celix_steal_ptr(msgBodyAlloc.ptr);
+    celix_steal_ptr(msgCtrlAlloc.ctrl);
+    celix_steal_ptr(peerServerName);
+    celix_steal_ptr(call);
+    return CELIX_SUCCESS;
+}
+
+celix_status_t rsaShmClientManager_sendMsgToAsync(rsa_shm_client_manager_t *clientManager,
+        const char *peerServerName, long serviceId, celix_properties_t *metadata,
+        const struct iovec *request, rsaShmClientManager_completionCB callback, void *callbackData) {
+    if (clientManager == NULL || peerServerName == NULL || strlen(peerServerName) >= MAX_RSA_SHM_SERVER_NAME_SIZE
+            || request == NULL || request->iov_base == NULL || request->iov_len == 0
+            || callback == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    celix_autoptr(rsa_shm_client_t) client = rsaShmClientManager_getClient(clientManager, peerServerName);
+    if (client == NULL) {
+        return CELIX_ILLEGAL_STATE;
+    }
+
+    if (rsaShmClient_shouldBreakInvocation(client, serviceId)) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Breaking current invocation for service id %ld.", serviceId);
+        return CELIX_ILLEGAL_STATE;
+    }
+
+    celix_status_t status = rsaShmClientManager_sendAsyncCall(clientManager, client, serviceId, metadata, request,
+                                                              callback, callbackData);
+    if (status != CELIX_SUCCESS) {
+        rsaShmClientManager_markSvcCallFinished(clientManager, peerServerName, serviceId);
     }
     return status;
 }
 
+static void rsaShmClientManager_addExceptionMsg(rsa_shm_client_manager_t *clientManager,
+        rsa_shm_msg_control_t *msgCtrl, void *msgBuffer, long serviceId, const char *peerServerName) {
+    rsa_shm_exception_msg_t *exceptionMsg = (rsa_shm_exception_msg_t *)malloc(sizeof(*exceptionMsg));
+    assert(exceptionMsg != NULL);
+    exceptionMsg->msgCtrl = msgCtrl;
+    exceptionMsg->msgBuffer = msgBuffer;
+    exceptionMsg->serviceId = serviceId;
+    exceptionMsg->peerServerName = strdup(peerServerName);
+    // Let rsaShmClientManager_exceptionMsgHandlerThread free exception message
+    celixThreadMutex_lock(&clientManager->exceptionMsgListMutex);
+    celix_arrayList_add(clientManager->exceptionMsgList, exceptionMsg);
+    celixThreadMutex_unlock(&clientManager->exceptionMsgListMutex);
+    celixThreadCondition_signal(&clientManager->exceptionMsgListNotEmpty);
+}
+
 static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t *clientManager,
         const char *peerServerName, rsa_shm_client_t **clientOut) {
     celix_status_t status = CELIX_SUCCESS;
@@ -415,6 +617,10 @@ static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t
         celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error binding unix fd.");
         return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
     }
+    status = rsaShmClientManager_setSendTimeout(clientManager, cfd);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
 
     memset(&client->serverAddr, 0, sizeof(struct sockaddr_un));
     client->serverAddr.sun_family = AF_UNIX;
@@ -560,6 +766,7 @@ static bool rsaShmClientManager_handleMsgState(rsa_shm_client_manager_t *clientM
             break;
         case REPLIED:
         case ABEND:
+        case SERVER_BUSY:
             removed = true;
             rsaShmClientManager_markSvcCallFinished(clientManager, msgEntry->peerServerName, msgEntry->serviceId);
             break;
@@ -639,7 +846,10 @@ static celix_status_t rsaShmClientManager_receiveResponse(rsa_shm_client_manager
             waitRet = pthread_cond_timedwait(&msgCtrl->signal, &msgCtrl->lock, &timeout);
         }
 
-        if (waitRet == 0 && msgCtrl->msgState != ABEND) {// Message State is REPLYING or REPLIED
+        if (waitRet == 0 && msgCtrl->msgState == SERVER_BUSY) {
+            celix_logHelper_warning(clientManager->logHelper, "RsaShmClient: Service endpoint is busy.");
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EBUSY);
+        } else if (waitRet == 0 && msgCtrl->msgState != ABEND) {// Message State is REPLYING or REPLIED
             if (msgCtrl->actualReplyedSize != 0 && msgCtrl->actualReplyedSize <= bufSize) {
                 reply = realloc(reply, replySize + msgCtrl->actualReplyedSize);
                 assert(reply != NULL);
@@ -659,7 +869,7 @@ static celix_status_t rsaShmClientManager_receiveResponse(rsa_shm_client_manager
             status = (waitRet == 0) ? CELIX_ILLEGAL_STATE : CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, waitRet);
         }
 
-        if (msgCtrl->msgState == ABEND || msgCtrl->msgState == REPLIED) {
+        if (msgCtrl->msgState == ABEND || msgCtrl->msgState == SERVER_BUSY || msgCtrl->msgState == REPLIED) {
             *replied = true;
         }
 
@@ -705,6 +915,19 @@ static void rsaShmClient_destroyOrDetachSvcDiagInfo(rsa_shm_client_t *client, lo
     return;
 }
 
+static celix_status_t rsaShmClientManager_setSendTimeout(rsa_shm_client_manager_t *clientManager, int fd) {
+    if (clientManager->msgTimeOutInSec == 0) {
+        return CELIX_SUCCESS;
+    }
+    //Bound sendto by the call timeout, so that a stalled server cannot block the invocation forever
+    struct timeval sendTimeout = {.tv_sec = clientManager->msgTimeOutInSec, .tv_usec = 0};
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout)) == -1) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error setting send timeout. %d.", errno);
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    return CELIX_SUCCESS;
+}
+
 static bool rsaShmClient_shouldBreakInvocation(rsa_shm_client_t *client, long serviceId) {
     bool breaked = false;
     rsa_shm_client_manager_t *clientManager = client->manager;
@@ -741,3 +964,201 @@ static bool rsaShmClient_shouldBreakInvocation(rsa_shm_client_t *client, long se
     }while (false);
     return breaked;
 };
+
+static celix_status_t rsaShmClientManager_startAsyncCompletion(rsa_shm_client_manager_t *clientManager) {
+    celix_status_t status = celixThreadMutex_create(&clientManager->asyncCallsMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating async calls mutex.");
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) asyncCallsMutex = &clientManager->asyncCallsMutex;
+    celix_autoptr(celix_long_hash_map_t) asyncCalls = clientManager->asyncCalls = celix_longHashMap_create();
+    if (asyncCalls == NULL) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating async calls map.");
+        return CELIX_ENOMEM;
+    }
+
+    celix_auto(celix_fd_t) asyncFd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (asyncFd == -1) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating async unix fd.");
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    // Autobind to a unique abstract address, the server sends the state change notifications to this address.
+    struct sockaddr_un claddr;
+    memset(&claddr, 0, sizeof(claddr));
+    claddr.sun_family = AF_UNIX;
+    if (bind(asyncFd, (struct sockaddr *) &claddr, sizeof(sa_family_t)) == -1) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error binding async unix fd.");
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
+    }
+    status = rsaShmClientManager_setSendTimeout(clientManager, asyncFd);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    clientManager->asyncFd = asyncFd;
+
+    clientManager->asyncThreadActive = true;
+    status = celixThread_create(&clientManager->asyncCompletionThread, NULL,
+            rsaShmClientManager_asyncCompletionThread, clientManager);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating async completion thread.");
+        return status;
+    }
+    celixThread_setName(&clientManager->asyncCompletionThread, "rsaShmAsyncCompl");
+
+    celix_steal_fd(&asyncFd);
+    celix_steal_ptr(asyncCalls);
+    celix_steal_ptr(asyncCallsMutex);
+    return CELIX_SUCCESS;
+}
+
+static void rsaShmClientManager_completeAsyncCall(rsa_shm_client_manager_t *clientManager,
+        rsa_shm_async_call_t *call) {
+    if (call->status != CELIX_SUCCESS) {
+        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error receiving async response. %d.", call->status);
+        rsaShmClientManager_markSvcCallFailed(clientManager, call->peerServerName, call->serviceId);
+    }
+    if (call->replied) {
+        rsaShmClientManager_markSvcCallFinished(clientManager, call->peerServerName, call->serviceId);
+        shmPool_free(clientManager->shmPool, call->msgBody);
+        rsa_shm_msg_control_alloc_t controlAlloc = {
+                .ctrl = call->msgCtrl,
+                .clientManager = clientManager,
+        };
+        rsaShmClientManager_destroyMsgControl(&controlAlloc);
+    } else {
+        rsaShmClientManager_addExceptionMsg(clientManager, call->msgCtrl, call->msgBody, call->serviceId,
+                                            call->peerServerName);
+    }
+
+    struct iovec response = {NULL, 0};
+    if (call->status == CELIX_SUCCESS) {
+        response.iov_base = call->reply;
+        response.iov_len = call->replySize;
+    } else {
+        free(call->reply);
+    }
+    call->callback(call->callbackData, call->status, &response);
+    free(call->peerServerName);
+    free(call);
+}
+
+static void rsaShmClientManager_stopAsyncCompletion(rsa_shm_client_manager_t *clientManager) {
+    celixThreadMutex_lock(&clientManager->asyncCallsMutex);
+    clientManager->asyncThreadActive = false;
+    celixThreadMutex_unlock(&clientManager->asyncCallsMutex);
+    celixThread_join(clientManager->asyncCompletionThread, NULL);
+    CELIX_LONG_HASH_MAP_ITERATE(clientManager->asyncCalls, iter) {
+        rsa_shm_async_call_t *call = iter.value.ptrValue;
+        call->status = CELIX_ILLEGAL_STATE;
+        rsaShmClientManager_completeAsyncCall(clientManager, call);
+    }
+    celix_longHashMap_destroy(clientManager->asyncCalls);
+    close(clientManager->asyncFd);
+    (void)celixThreadMutex_destroy(&clientManager->asyncCallsMutex);
+}
+
+/**
+ * Handles the state change of an asynchronous message. Returns true if the message exchange is finished.
+ */
+static bool rsaShmClientManager_handleAsyncCallStateChange(rsa_shm_client_manager_t *clientManager,
+        rsa_shm_async_call_t *call) {
+    bool finished = false;
+    bool isStreamingReply = false;
+    rsa_shm_msg_control_t *msgCtrl = call->msgCtrl;
+    celix_auto(celix_mutex_lock_guard_t) locker = celixMutexLockGuard_init(&msgCtrl->lock);
+    switch (msgCtrl->msgState) {
+        case REPLYING:
+        case REPLIED: {
+            if (msgCtrl->actualReplyedSize == 0 || msgCtrl->actualReplyedSize > call->msgBodySize) {
+                celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Response size(%zu) is illegal.", msgCtrl->actualReplyedSize);
+                call->status = CELIX_ILLEGAL_ARGUMENT;
+                finished = true;
+                break;
+            }
+            char *reply = realloc(call->reply, call->replySize + msgCtrl->actualReplyedSize);
+            if (reply == NULL) {
+                call->status = CELIX_ENOMEM;
+                finished = true;
+                break;
+            }
+            memcpy(reply + call->replySize, call->msgBody, msgCtrl->actualReplyedSize);
+            call->reply = reply;
+            call->replySize += msgCtrl->actualReplyedSize;
+            msgCtrl->actualReplyedSize = 0;
+            if (msgCtrl->msgState == REPLYING) {
+                msgCtrl->msgState = REQUESTING;
+                isStreamingReply = true;
+            } else {
+                finished = true;
+            }
+            break;
+        }
+        case ABEND:
+            celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Service endpoint exception.");
+            call->status = CELIX_ILLEGAL_STATE;
+            finished = true;
+            break;
+        case SERVER_BUSY:
+            celix_logHelper_warning(clientManager->logHelper, "RsaShmClient: Service endpoint is busy.");
+            call->status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EBUSY);
+            finished = true;
+            break;
+        default:
+            //Still requesting, e.g. a late notification of an earlier message which used the same control data
+            break;
+    }
+    call->replied = (msgCtrl->msgState == ABEND || msgCtrl->msgState == SERVER_BUSY || msgCtrl->msgState == REPLIED);
+    if (isStreamingReply) {
+        pthread_cond_signal(&msgCtrl->signal);
+    }
+    return finished;
+}
+
+static void *rsaShmClientManager_asyncCompletionThread(void *data) {
+    rsa_shm_client_manager_t *clientManager = data;
+    celix_autoptr(celix_array_list_t) finishedCalls = celix_arrayList_create();
+    struct timespec nextTimeoutCheck = celix_gettime(CLOCK_MONOTONIC);
+    bool active = true;
+    while (active) {
+        struct pollfd pfd = {.fd = clientManager->asyncFd, .events = POLLIN, .revents = 0};
+        int nfds = poll(&pfd, 1, RSA_SHM_ASYNC_TIMEOUT_CHECK_INTERVAL_IN_MS);
+
+        celixThreadMutex_lock(&clientManager->asyncCallsMutex);
+        if (nfds > 0) {
+            ssize_t ctrlDataOffset = -1;
+            while (recv(clientManager->asyncFd, &ctrlDataOffset, sizeof(ctrlDataOffset), MSG_DONTWAIT) == sizeof(ctrlDataOffset)) {
+                rsa_shm_async_call_t *call = celix_longHashMap_get(clientManager->asyncCalls, (long)ctrlDataOffset);
+                if (call != NULL && rsaShmClientManager_handleAsyncCallStateChange(clientManager, call)) {
+                    (void)celix_longHashMap_remove(clientManager->asyncCalls, (long)ctrlDataOffset);
+                    celix_arrayList_add(finishedCalls, call);
+                }
+            }
+        }
+
+        struct timespec now = celix_gettime(CLOCK_MONOTONIC);
+        if (celix_compareTime(&now, &nextTimeoutCheck) >= 0) {
+            celix_long_hash_map_iterator_t iter = celix_longHashMap_begin(clientManager->asyncCalls);
+            while (!celix_longHashMapIterator_isEnd(&iter)) {
+                rsa_shm_async_call_t *call = iter.value.ptrValue;
+                if (celix_compareTime(&now, &call->deadline) >= 0) {
+                    //The message will be handed over to the exception message list, same as a timed out synchronous message
+                    call->status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, ETIMEDOUT);
+                    celix_arrayList_add(finishedCalls, call);
+                    celix_longHashMapIterator_remove(&iter);
+                } else {
+                    celix_longHashMapIterator_next(&iter);
+                }
+            }
+            nextTimeoutCheck = celix_delayedTimespec(&now, RSA_SHM_ASYNC_TIMEOUT_CHECK_INTERVAL_IN_MS / 1000.0);
+        }
+        active = clientManager->asyncThreadActive;
+        celixThreadMutex_unlock(&clientManager->asyncCallsMutex);
+
+        for (int i = 0; i < celix_arrayList_size(finishedCalls); ++i) {
+            rsaShmClientManager_completeAsyncCall(clientManager, celix_arrayList_get(finishedCalls, i));
+        }
+        celix_arrayList_clear(finishedCalls);
+    }
+    return NULL;
+}
@@ -34,6 +34,14 @@ extern "C" {
 
 typedef struct rsa_shm_client_manager rsa_shm_client_manager_t;
 
+/**
+ * @brief The completion callback of an asynchronous message.
+ * @param[in] data The callback data given to rsaShmClientManager_sendMsgToAsync
+ * @param[in] status The status of the message exchange
+ * @param[in] response The response, only valid if status is CELIX_SUCCESS. The callback is the owner of the response memory.
+ */
+typedef void (*rsaShmClientManager_completionCB)(void *data, celix_status_t status, struct iovec *response);
+
 celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
         celix_log_helper_t *loghelper, rsa_shm_client_manager_t **clientManagerOut);
 
@@ -51,6 +59,18 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
         const char *peerServerName, long serviceId, celix_properties_t *metadata,
         const struct iovec *request, struct iovec *response);
 
+/**
+ * @brief Sends a message without waiting for the response.
+ *
+ * The response is received by the asynchronous completion thread of the client manager, which is notified by the
+ * server when the message state changes. If the function returns CELIX_SUCCESS, the callback will be called exactly
+ * once from the completion thread, also if the message times out or the client manager is destroyed. If the function
+ * returns an error, the callback will not be called.
+ */
+celix_status_t rsaShmClientManager_sendMsgToAsync(rsa_shm_client_manager_t *clientManager,
+        const char *peerServerName, long serviceId, celix_properties_t *metadata,
+        const struct iovec *request, rsaShmClientManager_completionCB callback, void *callbackData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,6 +60,41 @@ extern "C" {
  */
 #define RSA_SHM_MSG_TIMEOUT_DEFAULT_IN_S 30
 
+/**
+ * @brief A property of RsaShm bundle that indicates the minimum number of threads handling the received invocations.
+ *
+ */
+#define RSA_SHM_SERVER_MIN_THREADS_KEY "CELIX_RSA_SHM_SERVER_MIN_THREADS"
+/**
+ * @brief The default minimum number of threads handling the received invocations.
+ *
+ */
+#define RSA_SHM_SERVER_MIN_THREADS_DEFAULT 1
+
+/**
+ * @brief A property of RsaShm bundle that indicates the maximum number of threads handling the received invocations.
+ * The number of threads grows with the load up to this value, and idle threads stop down to the minimum.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_THREADS_KEY "CELIX_RSA_SHM_SERVER_MAX_THREADS"
+/**
+ * @brief The default maximum number of threads handling the received invocations.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_THREADS_DEFAULT 16
+
+/**
+ * @brief A property of RsaShm bundle that indicates the maximum number of received invocations waiting for a thread.
+ * If there are more waiting invocations, the server stops receiving invocations until a thread is available.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_QUEUE_DEPTH_KEY "CELIX_RSA_SHM_SERVER_MAX_QUEUE_DEPTH"
+/**
+ * @brief The default maximum number of received invocations waiting for a thread.
+ *
+ */
+#define RSA_SHM_SERVER_MAX_QUEUE_DEPTH_DEFAULT 256
+
 /**
  * @brief A property of RsaShm bundle that indicates the maximum concurrent invocations of the same service.
  * If there are more concurrent invocations than its value,  service invocation will fail.
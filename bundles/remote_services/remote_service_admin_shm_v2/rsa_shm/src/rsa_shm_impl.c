@@ -102,6 +102,7 @@ celix_status_t rsaShm_create(celix_bundle_context_t *context, celix_log_helper_t
 
     ad->reqSenderService.handle = ad;
     ad->reqSenderService.sendRequest = (void*)rsaShm_send;
+    ad->reqSenderService.sendRequestAsync = (void*)rsaShm_sendAsync;
     celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
     opts.serviceName = CELIX_RSA_REQUEST_SENDER_SERVICE_NAME;
     opts.serviceVersion = CELIX_RSA_REQUEST_SENDER_SERVICE_VERSION;
@@ -227,6 +228,24 @@ celix_status_t rsaShm_send(rsa_shm_t *admin, endpoint_description_t *endpoint,
     return status;
 }
 
+celix_status_t rsaShm_sendAsync(rsa_shm_t *admin, endpoint_description_t *endpoint,
+        celix_properties_t *metadata, const struct iovec *request,
+        rsa_request_sender_completion_fp callback, void *callbackData) {
+    if (admin == NULL || endpoint == NULL || request == NULL || callback == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    const char *shmServerName = celix_properties_get(endpoint->properties, RSA_SHM_SERVER_NAME_KEY, NULL);
+    if (shmServerName == NULL) {
+        celix_logHelper_error(admin->logHelper,"RSA shm server name of %s is invalid.", endpoint->serviceName);
+        return CELIX_SERVICE_EXCEPTION;
+    }
+    celix_autoptr(celix_properties_t) newMetadata = celix_properties_copy(metadata);
+    celix_properties_setLong(newMetadata, CELIX_RSA_ENDPOINT_SERVICE_ID, endpoint->serviceId);
+    return rsaShmClientManager_sendMsgToAsync(admin->shmClientManager, shmServerName,
+            (long)endpoint->serviceId, newMetadata, request, callback, callbackData);
+}
+
 static void rsaShm_overlayProperties(celix_properties_t *additionalProperties, celix_properties_t *serviceProperties) {
 
     /*The property keys of a service are case-insensitive,while the property keys of the specified additional properties map are case sensitive.
@@ -454,6 +473,16 @@ celix_status_t rsaShm_removeExportedService(rsa_shm_t *admin, export_registratio
     return status;
 }
 
+static void rsaShm_copyRpcCapabilities(void *handle, void *svc CELIX_UNUSED, const celix_properties_t *rpcFacProps) {
+    celix_properties_t *endpointProperties = handle;
+    size_t prefixLen = strlen(CELIX_RSA_RPC_CAPABILITY_PREFIX);
+    CELIX_PROPERTIES_ITERATE(rpcFacProps, iter) {
+        if (strncmp(iter.key, CELIX_RSA_RPC_CAPABILITY_PREFIX, prefixLen) == 0) {
+            celix_properties_setEntry(endpointProperties, iter.key, &iter.entry);
+        }
+    }
+}
+
 static celix_status_t rsaShm_createEndpointDescription(rsa_shm_t *admin,
         celix_properties_t *exportedProperties, char *interface, endpoint_description_t **description) {
     celix_status_t status = CELIX_SUCCESS;
@@ -490,6 +519,19 @@ static celix_status_t rsaShm_createEndpointDescription(rsa_shm_t *admin,
     if (celix_properties_get(endpointProperties, RSA_SHM_RPC_TYPE_KEY, NULL) == NULL) {
         celix_properties_set(endpointProperties, RSA_SHM_RPC_TYPE_KEY, RSA_SHM_RPC_TYPE_DEFAULT);
     }
+    //Advertise the capabilities of the rpc factory, if it is not (yet) available the importing side falls back to the basic protocol.
+    char rpcFilter[128] = {0};
+    int bytes = snprintf(rpcFilter, sizeof(rpcFilter), "(%s=%s)", CELIX_RSA_RPC_TYPE_KEY,
+            celix_properties_get(endpointProperties, RSA_SHM_RPC_TYPE_KEY, ""));
+    if (bytes < sizeof(rpcFilter)) {
+        celix_service_use_options_t useOpts = CELIX_EMPTY_SERVICE_USE_OPTIONS;
+        useOpts.filter.serviceName = CELIX_RSA_RPC_FACTORY_NAME;
+        useOpts.filter.versionRange = CELIX_RSA_RPC_FACTORY_USE_RANGE;
+        useOpts.filter.filter = rpcFilter;
+        useOpts.callbackHandle = endpointProperties;
+        useOpts.useWithProperties = rsaShm_copyRpcCapabilities;
+        (void)celix_bundleContext_useServiceWithOptions(admin->context, &useOpts);
+    }
     celix_properties_set(endpointProperties, (char *) RSA_SHM_SERVER_NAME_KEY, admin->shmServerName);
     status = endpointDescription_create(endpointProperties, description);
     if (status != CELIX_SUCCESS) {
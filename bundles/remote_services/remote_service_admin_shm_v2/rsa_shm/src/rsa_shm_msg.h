@@ -33,6 +33,7 @@ typedef enum {
     REPLIED = 2,
     ABEND = 3,//abnormal end
     REQ_CANCELLED = 4,
+    SERVER_BUSY = 5,//the server rejected the request, because too many requests are waiting to be handled
 }rsa_shm_msg_state;
 
 typedef struct rsa_shm_msg_control {
@@ -43,6 +44,19 @@ typedef struct rsa_shm_msg_control {
     size_t actualReplyedSize;
 }rsa_shm_msg_control_t;
 
+/**
+ * @brief If set, the server sends the ctrlDataOffset of the message (as ssize_t) to the sender address of the message
+ * every time the message state changes to REPLYING, REPLIED or ABEND. It is used by asynchronous requests, so that
+ * the client does not need a blocked thread per request.
+ */
+#define RSA_SHM_MSG_FLAG_NOTIFY_STATE_CHANGE 0x01
+
+/**
+ * @brief If set, the server ends the message with the SERVER_BUSY state if it rejects the request because it is
+ * overloaded. Otherwise the server uses the ABEND state, which is the only end state known by older clients.
+ */
+#define RSA_SHM_MSG_FLAG_ACCEPT_BUSY_STATE 0x02
+
 typedef struct rsa_shm_msg {
     size_t size;//The size of ‘struct rsa_shm_msg‘.It is used to extend 'struct rsa_shm_msg' in the future.
     int shmId;
@@ -52,6 +66,7 @@ typedef struct rsa_shm_msg {
     size_t msgBodyTotalSize;//equal metadataSize + requestSize + reserve space size
     size_t metadataSize;
     size_t requestSize;
+    unsigned int flags;//Since the field is added later, the server only uses it if 'size' includes it
 }rsa_shm_msg_t;
 
 #ifdef __cplusplus
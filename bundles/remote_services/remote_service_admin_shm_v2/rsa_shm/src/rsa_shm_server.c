@@ -19,13 +19,13 @@
 #include "rsa_shm_server.h"
 #include "rsa_shm_msg.h"
 #include "rsa_shm_constants.h"
+#include "rsa_shm_work_pool.h"
 #include "shm_cache.h"
 #include "celix_log_helper.h"
 #include "celix_stdlib_cleanup.h"
 #include "celix_build_assert.h"
 #include "celix_api.h"
 #include "celix_unistd_cleanup.h"
-#include <thpool.h>
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -37,11 +37,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <errno.h>
+#include <limits.h>
 
-#define MAX_RSA_SHM_SERVER_HANDLE_MSG_THREADS_NUM 5
+#define RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_IN_MS 10000
 
-// move to thpool.h once it is reused in other places
-CELIX_DEFINE_AUTO_CLEANUP_FREE_FUNC(threadpool, thpool_destroy, NULL)
+struct rsa_shm_server_work_data;
 
 struct rsa_shm_server {
     celix_bundle_context_t *ctx;
@@ -49,7 +49,9 @@ struct rsa_shm_server {
     celix_log_helper_t *loghelper;
     int sfd;
     shm_cache_t *shmCache;
-    threadpool threadPool;
+    rsa_shm_work_pool_t *workPool;
+    struct rsa_shm_server_work_data *freeWorkData;//atomic, the work data released by the workers
+    struct rsa_shm_server_work_data *localFreeWorkData;//only used by the receive msg thread
     celix_thread_t revMsgThread;
     bool revMsgThreadActive;
     rsaShmServer_receiveMsgCB revCB;
@@ -57,8 +59,22 @@ struct rsa_shm_server {
     long msgTimeOutInSec;
 };
 
-struct rsa_shm_server_thpool_work_data {
+/**
+ * The sender of a message, which is notified of the message state changes if the message has the
+ * RSA_SHM_MSG_FLAG_NOTIFY_STATE_CHANGE flag.
+ */
+struct rsa_shm_server_msg_sender {
+    bool notifyStateChange;
+    bool acceptBusyState;//whether the sender knows the SERVER_BUSY state
+    struct sockaddr_un addr;
+    socklen_t addrLen;
+    ssize_t ctrlDataOffset;
+};
+
+struct rsa_shm_server_work_data {
+    struct rsa_shm_server_work_data *next;//used by the free lists
     rsa_shm_server_t *server;
+    struct rsa_shm_server_msg_sender sender;
     rsa_shm_msg_control_t *msgCtrl;
     void *msgBody;
     size_t msgBodyTotalSize;
@@ -68,6 +84,20 @@ struct rsa_shm_server_thpool_work_data {
 
 static void *rsaShmServer_receiveMsgThread(void *data);
 
+/**
+ * Gets a work pool config value, negative values and values which do not fit an unsigned int are rejected.
+ */
+static celix_status_t rsaShmServer_getWorkPoolConfigValue(celix_bundle_context_t *ctx, celix_log_helper_t *loghelper,
+        const char *key, long defaultValue, unsigned int *valueOut) {
+    long value = celix_bundleContext_getPropertyAsLong(ctx, key, defaultValue);
+    if (value < 0 || value > UINT_MAX) {
+        celix_logHelper_error(loghelper, "RsaShmServer: Invalid value %ld for %s.", value, key);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *valueOut = (unsigned int)value;
+    return CELIX_SUCCESS;
+}
+
 celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name, celix_log_helper_t *loghelper,
         rsaShmServer_receiveMsgCB receiveCB, void *revHandle, rsa_shm_server_t **shmServerOut) {
     int status = CELIX_SUCCESS;
@@ -84,6 +114,25 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
     server->ctx = ctx;
     server->msgTimeOutInSec = celix_bundleContext_getPropertyAsLong(ctx,
             RSA_SHM_MSG_TIMEOUT_KEY, RSA_SHM_MSG_TIMEOUT_DEFAULT_IN_S);
+    if (server->msgTimeOutInSec < 0) {
+        celix_logHelper_error(loghelper, "RsaShmServer: Invalid value %ld for %s.", server->msgTimeOutInSec,
+                RSA_SHM_MSG_TIMEOUT_KEY);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    rsa_shm_work_pool_config_t workPoolConfig = {.idleTimeoutInMs = RSA_SHM_SERVER_WORKER_IDLE_TIMEOUT_IN_MS};
+    status = rsaShmServer_getWorkPoolConfigValue(ctx, loghelper, RSA_SHM_SERVER_MIN_THREADS_KEY,
+            RSA_SHM_SERVER_MIN_THREADS_DEFAULT, &workPoolConfig.minThreads);
+    if (status == CELIX_SUCCESS) {
+        status = rsaShmServer_getWorkPoolConfigValue(ctx, loghelper, RSA_SHM_SERVER_MAX_THREADS_KEY,
+                RSA_SHM_SERVER_MAX_THREADS_DEFAULT, &workPoolConfig.maxThreads);
+    }
+    if (status == CELIX_SUCCESS) {
+        status = rsaShmServer_getWorkPoolConfigValue(ctx, loghelper, RSA_SHM_SERVER_MAX_QUEUE_DEPTH_KEY,
+                RSA_SHM_SERVER_MAX_QUEUE_DEPTH_DEFAULT, &workPoolConfig.maxQueueDepth);
+    }
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
     server->name = celix_utils_strdup(name);
     if (server->name == NULL) {
         return CELIX_ENOMEM;
@@ -114,12 +163,12 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
     }
     server->shmCache = shmCache;
 
-    server->threadPool = thpool_init(MAX_RSA_SHM_SERVER_HANDLE_MSG_THREADS_NUM);
-    if (server->threadPool == NULL) {
-        celix_logHelper_error(loghelper, "RsaShmServer: create thread pool err.");
-        return CELIX_ILLEGAL_STATE;
+    status = rsaShmWorkPool_create(loghelper, &workPoolConfig, &server->workPool);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(loghelper, "RsaShmServer: create work pool err; error code is %d.", status);
+        return status;
     }
-    celix_auto(threadpool) thpool = server->threadPool;
+    celix_autoptr(rsa_shm_work_pool_t) workPool = server->workPool;
     server->revCB = receiveCB;
     server->revCBHandle = revHandle;
     server->revMsgThreadActive = true;
@@ -128,7 +177,7 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
         celix_logHelper_error(loghelper, "RsaShmServer: create receive msg thread err.");
         return status;
     }
-    celix_steal_ptr(thpool);
+    celix_steal_ptr(workPool);
     celix_steal_ptr(shmCache);
     celix_steal_fd(&sfd);
     celix_steal_ptr(serverName);
@@ -136,13 +185,22 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
     return CELIX_SUCCESS;
 }
 
+static void rsaShmServer_freeWorkDataList(struct rsa_shm_server_work_data *list) {
+    while (list != NULL) {
+        struct rsa_shm_server_work_data *next = list->next;
+        free(list);
+        list = next;
+    }
+}
+
 void rsaShmServer_destroy(rsa_shm_server_t *server) {
     if (server != NULL) {
         server->revMsgThreadActive = false;
         shutdown(server->sfd,SHUT_RD);
         celixThread_join(server->revMsgThread, NULL);
-        thpool_wait(server->threadPool);
-        thpool_destroy(server->threadPool);
+        rsaShmWorkPool_destroy(server->workPool);
+        rsaShmServer_freeWorkDataList(server->localFreeWorkData);
+        rsaShmServer_freeWorkDataList(server->freeWorkData);
         shmCache_destroy(server->shmCache);
         close(server->sfd);
         free(server->name);
@@ -152,23 +210,61 @@ void rsaShmServer_destroy(rsa_shm_server_t *server) {
 }
 
 
-static void rsaShmServer_terminateMsgHandling(rsa_shm_msg_control_t *ctrl) {
+static void rsaShmServer_notifyStateChange(rsa_shm_server_t *server, const struct rsa_shm_server_msg_sender *sender) {
+    if (!sender->notifyStateChange) {
+        return;
+    }
+    //Never block the server on a slow client, the client will treat a lost notification as a timeout.
+    if (sendto(server->sfd, &sender->ctrlDataOffset, sizeof(sender->ctrlDataOffset), MSG_DONTWAIT,
+               (const struct sockaddr *)&sender->addr, sender->addrLen) != sizeof(sender->ctrlDataOffset)) {
+        celix_logHelper_warning(server->loghelper, "RsaShmServer: Error notifying message state change. %d.", errno);
+    }
+    return;
+}
+
+static void rsaShmServer_terminateMsgHandling(rsa_shm_server_t *server, rsa_shm_msg_control_t *ctrl,
+        const struct rsa_shm_server_msg_sender *sender, bool busy) {
     assert(ctrl != NULL);
 
     // weakup client, terminate current interaction
     pthread_mutex_lock(&ctrl->lock);
-    ctrl->msgState = ABEND;
+    ctrl->msgState = (busy && sender->acceptBusyState) ? SERVER_BUSY : ABEND;
     //Signaling the condition variable first, and then unlocking the mutex, because client will free ctrl when msgState is ABEND.
     pthread_cond_signal(&ctrl->signal);
     pthread_mutex_unlock(&ctrl->lock);
+    rsaShmServer_notifyStateChange(server, sender);
 
     return;
 }
 
+/**
+ * Gets a work data from the free lists, or allocates a new one. Only called by the receive msg thread.
+ */
+static struct rsa_shm_server_work_data *rsaShmServer_acquireWorkData(rsa_shm_server_t *server) {
+    if (server->localFreeWorkData == NULL) {
+        //Take all work data released by the workers at once, so that only the workers push to the shared free list.
+        server->localFreeWorkData = __atomic_exchange_n(&server->freeWorkData, NULL, __ATOMIC_ACQUIRE);
+    }
+    struct rsa_shm_server_work_data *workData = server->localFreeWorkData;
+    if (workData != NULL) {
+        server->localFreeWorkData = workData->next;
+        return workData;
+    }
+    return (struct rsa_shm_server_work_data *)malloc(sizeof(*workData));
+}
+
+static void rsaShmServer_releaseWorkData(rsa_shm_server_t *server, struct rsa_shm_server_work_data *workData) {
+    workData->next = __atomic_load_n(&server->freeWorkData, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&server->freeWorkData, &workData->next, workData, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        //workData->next is updated with the current head
+    }
+}
+
 static void rsaShmServer_msgHandlingWork(void *data) {
     assert(data != NULL);
     int status =  CELIX_SUCCESS;
-    struct rsa_shm_server_thpool_work_data *workData = data;
+    struct rsa_shm_server_work_data *workData = data;
     rsa_shm_server_t *server = workData->server;
     assert(server != NULL);
 
@@ -220,6 +316,7 @@ static void rsaShmServer_msgHandlingWork(void *data) {
             msgCtrl->msgState = REPLYING;
             msgCtrl->actualReplyedSize = bytes;
             pthread_cond_signal(&msgCtrl->signal);
+            rsaShmServer_notifyStateChange(server, &workData->sender);
 
             struct timespec timeout = celix_gettime(CLOCK_MONOTONIC);
             timeout.tv_sec += server->msgTimeOutInSec;
@@ -230,7 +327,7 @@ static void rsaShmServer_msgHandlingWork(void *data) {
         }
     }
     pthread_mutex_unlock(&msgCtrl->lock);
-
+    rsaShmServer_notifyStateChange(server, &workData->sender);
 
     free(reply.iov_base);
     if (metadataProps != NULL) {
@@ -238,7 +335,7 @@ static void rsaShmServer_msgHandlingWork(void *data) {
     }
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-    free(data);
+    rsaShmServer_releaseWorkData(server, workData);
     return;
 
 reply_err:
@@ -247,10 +344,10 @@ call_receive_cb_failed:
     if (metadataProps != NULL) {
         celix_properties_destroy(metadataProps);
     }
-    rsaShmServer_terminateMsgHandling(msgCtrl);
+    rsaShmServer_terminateMsgHandling(server, msgCtrl, &workData->sender, false);
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-    free(data);
+    rsaShmServer_releaseWorkData(server, workData);
     return;
 }
 
@@ -287,9 +384,12 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
     assert(server != NULL);
     ssize_t revBytes = 0;
     rsa_shm_msg_t msgInfo;
+    struct rsa_shm_server_msg_sender sender;
 
     while (server->revMsgThreadActive) {
-        revBytes = recvfrom(server->sfd, &msgInfo, sizeof(msgInfo), 0, NULL, NULL);
+        memset(&sender, 0, sizeof(sender));
+        sender.addrLen = sizeof(sender.addr);
+        revBytes = recvfrom(server->sfd, &msgInfo, sizeof(msgInfo), 0, (struct sockaddr *)&sender.addr, &sender.addrLen);
         if (revBytes <= 0) {
             celix_logHelper_error(server->loghelper, "RsaShmServer: recv msg err(%d) or recv zero-length datagrams.", errno);
             continue;
@@ -298,6 +398,11 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
             celix_logHelper_error(server->loghelper,"RsaShmServer: Shm message info is invalid. It maybe cause memory leak!");
             continue;
         }
+        sender.ctrlDataOffset = msgInfo.ctrlDataOffset;
+        unsigned int flags = ((size_t)revBytes >= offsetof(rsa_shm_msg_t, flags) + sizeof(msgInfo.flags)
+                && msgInfo.size >= offsetof(rsa_shm_msg_t, flags) + sizeof(msgInfo.flags)) ? msgInfo.flags : 0;
+        sender.notifyStateChange = (flags & RSA_SHM_MSG_FLAG_NOTIFY_STATE_CHANGE) != 0 && sender.addrLen > sizeof(sa_family_t);
+        sender.acceptBusyState = (flags & RSA_SHM_MSG_FLAG_ACCEPT_BUSY_STATE) != 0;
         rsa_shm_msg_control_t *msgCtrl = shmCache_getMemoryPtr(server->shmCache,
                 msgInfo.shmId, msgInfo.ctrlDataOffset);
         if (rsaShmServer_msgCtrlInvalid(server, msgCtrl)) {
@@ -309,25 +414,38 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
                 msgInfo.msgBodyOffset);
         if (msgBody == NULL) {
             celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg data buffer cache failed.");
-            rsaShmServer_terminateMsgHandling(msgCtrl);
+            rsaShmServer_terminateMsgHandling(server, msgCtrl, &sender, false);
+            shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
+            continue;
+        }
+        struct rsa_shm_server_work_data *workData = rsaShmServer_acquireWorkData(server);
+        if (workData == NULL) {
+            celix_logHelper_error(server->loghelper,"RsaShmServer: Failed to allocate memory for work data.");
+            rsaShmServer_terminateMsgHandling(server, msgCtrl, &sender, false);
+            shmCache_releaseMemoryPtr(server->shmCache, msgBody);
             shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
             continue;
         }
-        struct rsa_shm_server_thpool_work_data *workData = ( struct rsa_shm_server_thpool_work_data *)malloc(sizeof(*workData));
-        assert(workData != NULL);
         workData->server = server;
+        workData->sender = sender;
         workData->msgCtrl = msgCtrl;
         workData->msgBody = msgBody;
         workData->msgBodyTotalSize = msgInfo.msgBodyTotalSize;
         workData->metadataSize = msgInfo.metadataSize;
         workData->requestSize = msgInfo.requestSize;
-        int retVal = thpool_add_work(server->threadPool, (void *)rsaShmServer_msgHandlingWork, (void*)workData);
-        if (retVal != 0) {
-            celix_logHelper_error(server->loghelper, "RsaShmServer: maybe pool thread is full, error code is %d.", retVal);
-            rsaShmServer_terminateMsgHandling(msgCtrl);
+        //If the work queues are full, the request is rejected with a busy reply instead of blocking the receive thread
+        celix_status_t status = rsaShmWorkPool_submit(server->workPool, rsaShmServer_msgHandlingWork, workData);
+        if (status != CELIX_SUCCESS) {
+            bool busy = status == RSA_SHM_WORK_POOL_BUSY;
+            if (busy) {
+                celix_logHelper_warning(server->loghelper, "RsaShmServer: Too many queued requests, request rejected.");
+            } else {
+                celix_logHelper_error(server->loghelper, "RsaShmServer: Error submitting msg handling work. %d.", status);
+            }
+            rsaShmServer_terminateMsgHandling(server, msgCtrl, &sender, busy);
             shmCache_releaseMemoryPtr(server->shmCache, msgBody);
             shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-            free(workData);
+            rsaShmServer_releaseWorkData(server, workData);
             continue;
         }
     }
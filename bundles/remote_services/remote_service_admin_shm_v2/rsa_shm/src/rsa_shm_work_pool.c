@@ -0,0 +1,333 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "rsa_shm_work_pool.h"
+#include "celix_threads.h"
+#include "celix_stdlib_cleanup.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+typedef struct rsa_shm_work {
+    rsaShmWorkPool_workFn fn;
+    void *data;
+} rsa_shm_work_t;
+
+/**
+ * A worker and its work queue. The queue is a ring buffer, which can hold maxQueueDepth works.
+ */
+typedef struct rsa_shm_worker {
+    rsa_shm_work_pool_t *pool;
+    unsigned int index;
+    celix_thread_t thread;
+    bool threadStarted;//protected by pool mutex, true if the thread is not yet joined
+    bool idle;//protected by pool mutex, true if the worker waits for work and is not yet woken up by a submitter
+    celix_thread_cond_t wakeUp;//used with the pool mutex
+    celix_thread_mutex_t queueLock;//protects below
+    rsa_shm_work_t *queue;
+    size_t queueHead;
+    size_t queueSize;
+} rsa_shm_worker_t;
+
+struct rsa_shm_work_pool {
+    celix_log_helper_t *logHelper;
+    rsa_shm_work_pool_config_t config;
+    rsa_shm_worker_t *workers;//maxThreads workers, the first nrOfThreads workers are running
+    size_t queueDepth;//atomic, the total number of works in the worker queues
+    celix_thread_mutex_t mutex;//protects below
+    unsigned int nrOfThreads;
+    unsigned int *idleWorkers;//the indexes of the idle workers
+    unsigned int nrOfIdleWorkers;
+    unsigned int nextWorker;
+    bool running;
+};
+
+static void *rsaShmWorkPool_workerThread(void *data);
+
+static celix_status_t rsaShmWorkPool_initWorkers(rsa_shm_work_pool_t *pool) {
+    for (unsigned int i = 0; i < pool->config.maxThreads; ++i) {
+        rsa_shm_worker_t *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        worker->queue = calloc(pool->config.maxQueueDepth, sizeof(*worker->queue));
+        if (worker->queue == NULL) {
+            return CELIX_ENOMEM;
+        }
+        celix_status_t status = celixThreadMutex_create(&worker->queueLock, NULL);
+        if (status != CELIX_SUCCESS) {
+            free(worker->queue);
+            worker->queue = NULL;
+            return status;
+        }
+        status = celixThreadCondition_init(&worker->wakeUp, NULL);
+        if (status != CELIX_SUCCESS) {
+            celixThreadMutex_destroy(&worker->queueLock);
+            free(worker->queue);
+            worker->queue = NULL;
+            return status;
+        }
+    }
+    return CELIX_SUCCESS;
+}
+
+static void rsaShmWorkPool_deinitWorkers(rsa_shm_work_pool_t *pool) {
+    for (unsigned int i = 0; i < pool->config.maxThreads; ++i) {
+        rsa_shm_worker_t *worker = &pool->workers[i];
+        if (worker->queue != NULL) {
+            celixThreadCondition_destroy(&worker->wakeUp);
+            celixThreadMutex_destroy(&worker->queueLock);
+            free(worker->queue);
+        }
+    }
+    free(pool->workers);
+    free(pool->idleWorkers);
+}
+
+/**
+ * Starts the next worker, must be called with the pool mutex locked.
+ */
+static celix_status_t rsaShmWorkPool_startWorker(rsa_shm_work_pool_t *pool) {
+    assert(pool->nrOfThreads < pool->config.maxThreads);
+    rsa_shm_worker_t *worker = &pool->workers[pool->nrOfThreads];
+    if (worker->threadStarted) {
+        //The previous thread of the worker is stopped, see rsaShmWorkPool_workerThread
+        celixThread_join(worker->thread, NULL);
+        worker->threadStarted = false;
+    }
+    celix_status_t status = celixThread_create(&worker->thread, NULL, rsaShmWorkPool_workerThread, worker);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(pool->logHelper, "RsaShmWorkPool: Error creating worker thread. %d.", status);
+        return status;
+    }
+    celixThread_setName(&worker->thread, "RsaShmWorker");
+    worker->threadStarted = true;
+    pool->nrOfThreads += 1;
+    return CELIX_SUCCESS;
+}
+
+celix_status_t rsaShmWorkPool_create(celix_log_helper_t *logHelper, const rsa_shm_work_pool_config_t *config,
+        rsa_shm_work_pool_t **poolOut) {
+    if (logHelper == NULL || config == NULL || poolOut == NULL || config->maxThreads == 0
+            || config->minThreads > config->maxThreads || config->maxQueueDepth == 0 || config->idleTimeoutInMs == 0) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_autofree rsa_shm_work_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        celix_logHelper_error(logHelper, "RsaShmWorkPool: Failed to allocate memory for work pool.");
+        return CELIX_ENOMEM;
+    }
+    pool->logHelper = logHelper;
+    pool->config = *config;
+    pool->running = true;
+    celix_status_t status = celixThreadMutex_create(&pool->mutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "RsaShmWorkPool: Error creating mutex. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) mutex = &pool->mutex;
+    pool->workers = calloc(config->maxThreads, sizeof(*pool->workers));
+    pool->idleWorkers = calloc(config->maxThreads, sizeof(*pool->idleWorkers));
+    if (pool->workers == NULL || pool->idleWorkers == NULL) {
+        celix_logHelper_error(logHelper, "RsaShmWorkPool: Failed to allocate memory for workers.");
+        free(pool->workers);
+        free(pool->idleWorkers);
+        return CELIX_ENOMEM;
+    }
+    status = rsaShmWorkPool_initWorkers(pool);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "RsaShmWorkPool: Error creating worker queues. %d.", status);
+        rsaShmWorkPool_deinitWorkers(pool);
+        return status;
+    }
+    celixThreadMutex_lock(&pool->mutex);
+    for (unsigned int i = 0; i < config->minThreads && status == CELIX_SUCCESS; ++i) {
+        status = rsaShmWorkPool_startWorker(pool);
+    }
+    celixThreadMutex_unlock(&pool->mutex);
+    if (status != CELIX_SUCCESS) {
+        rsa_shm_work_pool_t *startedPool = celix_steal_ptr(pool);
+        celix_steal_ptr(mutex);
+        rsaShmWorkPool_destroy(startedPool);
+        return status;
+    }
+
+    celix_steal_ptr(mutex);
+    *poolOut = celix_steal_ptr(pool);
+    return CELIX_SUCCESS;
+}
+
+void rsaShmWorkPool_destroy(rsa_shm_work_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    celixThreadMutex_lock(&pool->mutex);
+    pool->running = false;
+    for (unsigned int i = 0; i < pool->config.maxThreads; ++i) {
+        celixThreadCondition_signal(&pool->workers[i].wakeUp);
+    }
+    celixThreadMutex_unlock(&pool->mutex);
+    //The workers only stop if all queues are empty, and no worker is started or stopped after running is false
+    for (unsigned int i = 0; i < pool->config.maxThreads; ++i) {
+        if (pool->workers[i].threadStarted) {
+            celixThread_join(pool->workers[i].thread, NULL);
+        }
+    }
+    assert(__atomic_load_n(&pool->queueDepth, __ATOMIC_SEQ_CST) == 0);
+    rsaShmWorkPool_deinitWorkers(pool);
+    celixThreadMutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+static void rsaShmWorkPool_removeIdleWorker(rsa_shm_work_pool_t *pool, rsa_shm_worker_t *worker) {
+    worker->idle = false;
+    for (unsigned int i = 0; i < pool->nrOfIdleWorkers; ++i) {
+        if (pool->idleWorkers[i] == worker->index) {
+            pool->idleWorkers[i] = pool->idleWorkers[--pool->nrOfIdleWorkers];
+            break;
+        }
+    }
+}
+
+/**
+ * Wakes up the idle worker with the lowest index, so that the last started workers stay idle and can stop if the
+ * load decreases. Must be called with the pool mutex locked.
+ */
+static rsa_shm_worker_t *rsaShmWorkPool_wakeUpIdleWorker(rsa_shm_work_pool_t *pool) {
+    assert(pool->nrOfIdleWorkers > 0);
+    unsigned int index = pool->idleWorkers[0];
+    for (unsigned int i = 1; i < pool->nrOfIdleWorkers; ++i) {
+        index = pool->idleWorkers[i] < index ? pool->idleWorkers[i] : index;
+    }
+    rsa_shm_worker_t *worker = &pool->workers[index];
+    rsaShmWorkPool_removeIdleWorker(pool, worker);
+    celixThreadCondition_signal(&worker->wakeUp);
+    return worker;
+}
+
+celix_status_t rsaShmWorkPool_submit(rsa_shm_work_pool_t *pool, rsaShmWorkPool_workFn fn, void *data) {
+    if (pool == NULL || fn == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&pool->mutex);
+    if (!pool->running) {
+        return CELIX_ILLEGAL_STATE;
+    }
+    //Works are only added with the pool mutex locked, so the queue depth cannot exceed the limit after this check
+    if (__atomic_load_n(&pool->queueDepth, __ATOMIC_SEQ_CST) >= pool->config.maxQueueDepth) {
+        return RSA_SHM_WORK_POOL_BUSY;
+    }
+    rsa_shm_worker_t *worker = NULL;
+    if (pool->nrOfIdleWorkers > 0) {
+        worker = rsaShmWorkPool_wakeUpIdleWorker(pool);
+    } else if (pool->nrOfThreads < pool->config.maxThreads
+               && rsaShmWorkPool_startWorker(pool) == CELIX_SUCCESS) {
+        worker = &pool->workers[pool->nrOfThreads - 1];
+    } else if (pool->nrOfThreads > 0) {
+        //all workers are busy, the first worker which is done takes the work from this queue
+        worker = &pool->workers[pool->nextWorker++ % pool->nrOfThreads];
+    } else {
+        return CELIX_ILLEGAL_STATE;
+    }
+
+    celixThreadMutex_lock(&worker->queueLock);
+    size_t tail = (worker->queueHead + worker->queueSize) % pool->config.maxQueueDepth;
+    worker->queue[tail].fn = fn;
+    worker->queue[tail].data = data;
+    worker->queueSize += 1;
+    __atomic_add_fetch(&pool->queueDepth, 1, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&worker->queueLock);
+    return CELIX_SUCCESS;
+}
+
+static bool rsaShmWorkPool_popWork(rsa_shm_worker_t *worker, rsa_shm_work_t *workOut) {
+    rsa_shm_work_pool_t *pool = worker->pool;
+    bool found = false;
+    celixThreadMutex_lock(&worker->queueLock);
+    if (worker->queueSize > 0) {
+        *workOut = worker->queue[worker->queueHead];
+        worker->queueHead = (worker->queueHead + 1) % pool->config.maxQueueDepth;
+        worker->queueSize -= 1;
+        __atomic_sub_fetch(&pool->queueDepth, 1, __ATOMIC_SEQ_CST);
+        found = true;
+    }
+    celixThreadMutex_unlock(&worker->queueLock);
+    return found;
+}
+
+/**
+ * Takes a work from the own queue of the worker, or steals one from the queues of the other workers.
+ */
+static bool rsaShmWorkPool_takeWork(rsa_shm_worker_t *worker, rsa_shm_work_t *workOut) {
+    rsa_shm_work_pool_t *pool = worker->pool;
+    for (unsigned int i = 0; i < pool->config.maxThreads; ++i) {
+        rsa_shm_worker_t *victim = &pool->workers[(worker->index + i) % pool->config.maxThreads];
+        if (rsaShmWorkPool_popWork(victim, workOut)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void *rsaShmWorkPool_workerThread(void *data) {
+    rsa_shm_worker_t *worker = data;
+    rsa_shm_work_pool_t *pool = worker->pool;
+    rsa_shm_work_t work;
+    while (true) {
+        if (rsaShmWorkPool_takeWork(worker, &work)) {
+            work.fn(work.data);
+            continue;
+        }
+
+        celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&pool->mutex);
+        if (__atomic_load_n(&pool->queueDepth, __ATOMIC_SEQ_CST) > 0) {
+            continue;
+        }
+        if (!pool->running) {
+            break;
+        }
+        worker->idle = true;
+        pool->idleWorkers[pool->nrOfIdleWorkers++] = worker->index;
+        struct timespec idleDeadline = celixThreadCondition_getDelayedTime(pool->config.idleTimeoutInMs / 1000.0);
+        celix_status_t status = CELIX_SUCCESS;
+        while (worker->idle && pool->running && status == CELIX_SUCCESS) {
+            status = celixThreadCondition_waitUntil(&worker->wakeUp, &pool->mutex, &idleDeadline);
+        }
+        if (!worker->idle) {
+            //woken up by a submitter
+            continue;
+        }
+        rsaShmWorkPool_removeIdleWorker(pool, worker);
+        //Only the last started worker stops, so that the running workers are always the first nrOfThreads workers.
+        if (status == ETIMEDOUT && pool->running && pool->nrOfThreads > pool->config.minThreads
+                && worker->index == pool->nrOfThreads - 1 && __atomic_load_n(&pool->queueDepth, __ATOMIC_SEQ_CST) == 0) {
+            pool->nrOfThreads -= 1;
+            break;
+        }
+    }
+    return NULL;
+}
+
+size_t rsaShmWorkPool_queueDepth(rsa_shm_work_pool_t *pool) {
+    return __atomic_load_n(&pool->queueDepth, __ATOMIC_SEQ_CST);
+}
+
+unsigned int rsaShmWorkPool_nrOfThreads(rsa_shm_work_pool_t *pool) {
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&pool->mutex);
+    return pool->nrOfThreads;
+}
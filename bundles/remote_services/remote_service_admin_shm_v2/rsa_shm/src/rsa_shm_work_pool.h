@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_SHM_WORK_POOL_H_
+#define _RSA_SHM_WORK_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "celix_cleanup.h"
+#include "celix_log_helper.h"
+#include "celix_errno.h"
+#include <stddef.h>
+#include <errno.h>
+
+/**
+ * @brief The worker pool of the RSA SHM server.
+ *
+ * Every worker thread has its own work queue. Submitted works are distributed over the queues of the running workers
+ * and an idle worker steals works from the queues of the other workers, so there is no single global work queue.
+ * The pool starts a new worker (up to maxThreads) if a work is submitted while no worker is idle, and a worker which
+ * is idle for idleTimeoutInMs stops (down to minThreads).
+ *
+ * The number of queued works is limited by maxQueueDepth. If the limit is reached, rsaShmWorkPool_submit rejects
+ * the work with RSA_SHM_WORK_POOL_BUSY, so that the submitter can report the overload instead of waiting for it.
+ */
+typedef struct rsa_shm_work_pool rsa_shm_work_pool_t;
+
+typedef void (*rsaShmWorkPool_workFn)(void *data);
+
+/**
+ * @brief The status of rsaShmWorkPool_submit if the work is rejected, because maxQueueDepth works are queued.
+ */
+#define RSA_SHM_WORK_POOL_BUSY CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EBUSY)
+
+typedef struct rsa_shm_work_pool_config {
+    unsigned int minThreads;
+    unsigned int maxThreads;
+    unsigned int maxQueueDepth;
+    unsigned int idleTimeoutInMs;
+} rsa_shm_work_pool_config_t;
+
+celix_status_t rsaShmWorkPool_create(celix_log_helper_t *logHelper, const rsa_shm_work_pool_config_t *config,
+        rsa_shm_work_pool_t **poolOut);
+
+/**
+ * @brief Destroys the pool, after all submitted works are done.
+ */
+void rsaShmWorkPool_destroy(rsa_shm_work_pool_t *pool);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(rsa_shm_work_pool_t, rsaShmWorkPool_destroy)
+
+/**
+ * @brief Submits a work to the pool. It never blocks.
+ * @return CELIX_SUCCESS if the work is queued, RSA_SHM_WORK_POOL_BUSY if maxQueueDepth works are queued,
+ * CELIX_ILLEGAL_STATE if the pool is being destroyed or no worker could be started.
+ */
+celix_status_t rsaShmWorkPool_submit(rsa_shm_work_pool_t *pool, rsaShmWorkPool_workFn fn, void *data);
+
+/**
+ * @brief Returns the number of queued works, which are not yet taken by a worker.
+ */
+size_t rsaShmWorkPool_queueDepth(rsa_shm_work_pool_t *pool);
+
+/**
+ * @brief Returns the number of running worker threads.
+ */
+unsigned int rsaShmWorkPool_nrOfThreads(rsa_shm_work_pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_SHM_WORK_POOL_H_ */
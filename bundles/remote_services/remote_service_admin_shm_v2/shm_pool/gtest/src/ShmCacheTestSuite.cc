@@ -21,6 +21,7 @@
 #include "shm_pool.h"
 #include "malloc_ei.h"
 #include "celix_threads_ei.h"
+#include "celix_err.h"
 #include <gtest/gtest.h>
 #include <string.h>
 
@@ -190,6 +191,31 @@ TEST_F(ShmCacheTestSuite, GetMemoryPtrFailedDueToInvalidArgument) {
     shmCache_destroy(shmCache);
 }
 
+TEST_F(ShmCacheTestSuite, GetMemoryPtrInRange) {
+    shm_cache_t *shmCache = nullptr;
+    celix_status_t status = shmCache_create(false, &shmCache);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    void *mem = shmPool_malloc(shmPool, 128);
+    EXPECT_TRUE(mem != nullptr);
+    ssize_t memOffset = shmPool_getMemoryOffset(shmPool, mem);
+    EXPECT_LT(0, memOffset);
+
+    void *addr = shmCache_getMemoryPtrInRange(shmCache, shmId, memOffset, 128);
+    EXPECT_TRUE(addr != nullptr);
+    shmCache_releaseMemoryPtr(shmCache, addr);
+
+    //memory ranges which are not within the shared memory
+    EXPECT_TRUE(shmCache_getMemoryPtrInRange(shmCache, shmId, memOffset, 1024 * 1024) == nullptr);
+    EXPECT_TRUE(shmCache_getMemoryPtrInRange(shmCache, shmId, memOffset, SIZE_MAX) == nullptr);
+    EXPECT_TRUE(shmCache_getMemoryPtrInRange(shmCache, shmId, 1024 * 1024, 1) == nullptr);
+    EXPECT_TRUE(shmCache_getMemoryPtr(shmCache, shmId, 1024 * 1024) == nullptr);
+    celix_err_resetErrors();
+
+    shmPool_free(shmPool, mem);
+    shmCache_destroy(shmCache);
+}
+
 TEST_F(ShmCacheTestSuite, EvictInactiveShmCacheBlock) {
     shm_pool_t *shmPool = nullptr;
     celix_status_t status = shmPool_create(8192, &shmPool);
@@ -81,6 +81,21 @@ void shmCache_setShmPeerClosedCB(shm_cache_t *shmCache, shmCache_shmPeerClosedCB
  */
 void * shmCache_getMemoryPtr(shm_cache_t *shmCache, int shmId, ssize_t memoryOffset);
 
+/**
+ * @brief Get shared memory address of a memory range from shared memory cache.
+ *
+ * Same as shmCache_getMemoryPtr, but NULL is returned if the memory range [memoryOffset, memoryOffset + size) is not
+ * within the shared memory. Should be used if the offset and size are received from a peer.
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param shmCache The shared memory cache instance
+ * @param shmId Shared memory id
+ * @param memoryOffset shared memory offset
+ * @param size The size of the memory range
+ * @return Shared memory address/NULL
+ */
+void * shmCache_getMemoryPtrInRange(shm_cache_t *shmCache, int shmId, ssize_t memoryOffset, size_t size);
+
 /**
  * @brief Give back shared memory to shared memory cache
  *
@@ -36,6 +36,7 @@ typedef struct shm_cache_block {
     uint64_t lastHeartbeatCnt;
     unsigned int refCnt;
     size_t maxOffset;
+    size_t shmSize;
 }shm_cache_block_t;
 
 struct shm_cache{
@@ -114,7 +115,11 @@ static shm_cache_block_t * shmCache_createBlock(shm_cache_t *shmCache, int shmId
     } else {
         shmStartAddr = shmat(shmId, NULL, 0);
     }
-    if (shmStartAddr != (void*)-1) {
+    struct shmid_ds shmInfo;
+    if (shmStartAddr != (void*)-1 && shmctl(shmId, IPC_STAT, &shmInfo) != 0) {
+        celix_err_pushf("Shm cache: Error getting size of shared memory for shmid %d. %d.\n", shmId, errno);
+        shmdt(shmStartAddr);
+    } else if (shmStartAddr != (void*)-1) {
         shmBlock = (shm_cache_block_t *)malloc(sizeof(shm_cache_block_t));
         assert(shmBlock != NULL);
         shmBlock->shmId = shmId;
@@ -123,6 +128,7 @@ static shm_cache_block_t * shmCache_createBlock(shm_cache_t *shmCache, int shmId
         shmBlock->lastHeartbeatCnt = 0;
         shmBlock->refCnt = 1;
         shmBlock->maxOffset = 0;
+        shmBlock->shmSize = shmInfo.shm_segsz;
     } else {
         celix_err_pushf("Shm cache: Error attaching shared memory for shmid %d. %d.\n", shmId, errno);
     }
@@ -137,6 +143,10 @@ static void shmCache_destroyBlock(shm_cache_t *shmCache, shm_cache_block_t *shmB
 }
 
 void * shmCache_getMemoryPtr(shm_cache_t *shmCache, int shmId, ssize_t memoryOffset) {
+    return shmCache_getMemoryPtrInRange(shmCache, shmId, memoryOffset, 1);
+}
+
+void * shmCache_getMemoryPtrInRange(shm_cache_t *shmCache, int shmId, ssize_t memoryOffset, size_t size) {
     void *ptr = NULL;
     if (shmCache != NULL && shmId > 0 && memoryOffset > 0) {
         celixThreadMutex_lock(&shmCache->mutex);
@@ -150,7 +160,11 @@ void * shmCache_getMemoryPtr(shm_cache_t *shmCache, int shmId, ssize_t memoryOff
             }
         }
 
-        if (shmBlock != NULL) {
+        if (shmBlock != NULL && (size > shmBlock->shmSize || (size_t)memoryOffset > shmBlock->shmSize - size)) {
+            celix_err_pushf("Shm cache: Memory range (offset %zd, size %zu) is out of shared memory %d.\n",
+                            memoryOffset, size, shmId);
+            shmBlock->refCnt--;
+        } else if (shmBlock != NULL) {
             if (shmBlock->maxOffset < memoryOffset) {
                 shmBlock->maxOffset = memoryOffset;
             }
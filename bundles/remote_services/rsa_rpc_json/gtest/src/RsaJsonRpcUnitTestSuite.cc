@@ -45,6 +45,9 @@
 #include "celix_long_hash_map_ei.h"
 #include <gtest/gtest.h>
 #include <cstdlib>
+#include <atomic>
+#include <string>
+#include <thread>
 extern "C" {
 #include "remote_interceptors_handler.h"
 }
@@ -70,6 +73,7 @@ public:
         celix_ei_expect_celix_bundle_getManifestValue(nullptr, 0, nullptr);
         celix_ei_expect_calloc(nullptr, 0, nullptr);
         celix_ei_expect_celixThreadMutex_create(nullptr, 0, 0);
+        celix_ei_expect_celixThreadCondition_init(nullptr, 0, 0);
         celix_ei_expect_celix_bundleContext_registerServiceFactoryAsync(nullptr, 0, 0);
         celix_ei_expect_celix_version_createVersionFromString(nullptr, 0, nullptr);
         celix_ei_expect_dynFunction_createClosure(nullptr, 0, 0);
@@ -167,6 +171,15 @@ TEST_F(RsaJsonRpcUnitTestSuite, FailedToCreateThreadMutex) {
     EXPECT_EQ(CELIX_ENOMEM, status);
 }
 
+TEST_F(RsaJsonRpcUnitTestSuite, FailedToCreateThreadCondition) {
+    rsa_json_rpc_t *jsonRpc = nullptr;
+    celix_ei_expect_celix_bundle_getManifestValue((void*)&rsaJsonRpc_create, 1, "1.0.0");
+
+    celix_ei_expect_celixThreadCondition_init((void*)&rsaJsonRpc_create, 0, CELIX_ENOMEM);
+    auto status  = rsaJsonRpc_create(ctx.get(), logHelper.get(), &jsonRpc);
+    EXPECT_EQ(CELIX_ENOMEM, status);
+}
+
 TEST_F(RsaJsonRpcUnitTestSuite, FailedToCreateRemoteInterceptorsHandler) {
     rsa_json_rpc_t *jsonRpc = nullptr;
     celix_ei_expect_celix_bundle_getManifestValue((void*)&rsaJsonRpc_create, 1, "1.0.0");
@@ -446,6 +459,254 @@ TEST_F(RsaJsonRpcProxyUnitTestSuite, FailedToRegisterProxyService) {
     endpointDescription_destroy(endpoint);
 }
 
+TEST_F(RsaJsonRpcProxyUnitTestSuite, CallProxyServiceWithBatching) {
+    setenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY, "5000000", true);//the batch is sent when full
+    setenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY, "2", true);
+    static std::atomic<int> nrOfRequests{0};
+    nrOfRequests = 0;
+    reqSenderSvc.sendRequest = [](void *handle, const endpoint_description_t *endpointDesc, celix_properties_t *metadata, const struct iovec *request, struct iovec *response) -> celix_status_t {
+        (void)handle;//unused
+        (void)endpointDesc;//unused
+        EXPECT_NE(nullptr, metadata);
+        EXPECT_EQ(0, strncmp("{\"b\":[", (const char*)request->iov_base, 6));
+        nrOfRequests++;
+        response->iov_base = strdup("{\"b\":[{},{\"e\":70003}]}");
+        response->iov_len = strlen((const char*)response->iov_base) + 1;
+        return CELIX_SUCCESS;
+    };
+    auto endpoint = CreateEndpointDescription();
+    celix_properties_setBool(endpoint->properties, RSA_JSON_RPC_BATCH_SUPPORTED_KEY, true);
+    long proxySvcId = -1;
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &proxySvcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_waitForEvents(ctx.get());//wait for proxy service registration
+
+    std::atomic<int> results[2]{{-1}, {-1}};
+    auto call = [this](std::atomic<int>* result) {
+        auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, result, [](void *handle, void *svc) {
+            auto proxySvc = static_cast<rsa_rpc_json_test_service_t*>(svc);
+            *static_cast<std::atomic<int>*>(handle) = proxySvc->test(proxySvc->handle);
+        });
+        EXPECT_TRUE(found);
+    };
+    std::thread t1{call, &results[0]};
+    std::thread t2{call, &results[1]};
+    t1.join();
+    t2.join();
+
+    EXPECT_EQ(1, nrOfRequests.load());
+    //the order of the calls in the batch is not known, but one call succeeds and one call gets the remote error
+    EXPECT_EQ(70003, results[0].load() + results[1].load());
+    EXPECT_TRUE(results[0].load() == CELIX_SUCCESS || results[1].load() == CELIX_SUCCESS);
+
+    rsaJsonRpc_destroyProxy(jsonRpc.get(), proxySvcId);
+    unsetenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY);
+    unsetenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY);
+}
+
+TEST_F(RsaJsonRpcProxyUnitTestSuite, CallProxyServiceWithBatchingOnlyMergesCallsWithEqualMetadata) {
+    setenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY, "5000000", true);//the batch is sent when full
+    setenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY, "3", true);
+    static thread_local const char* caller = nullptr;
+    static remote_interceptor_t interceptor{};
+    interceptor.preProxyCall = [](void *handle, const celix_properties_t *svcProperties, const char *functionName, celix_properties_t *metadata) -> bool {
+        (void)handle;//unused
+        (void)svcProperties;//unused
+        (void)functionName;//unused
+        celix_properties_set(metadata, "caller", caller);
+        return true;
+    };
+    interceptor.postProxyCall = [](void *handle, const celix_properties_t *svcProperties, const char *functionName, celix_properties_t *metadata) {
+        (void)handle;//unused
+        (void)svcProperties;//unused
+        (void)functionName;//unused
+        EXPECT_STREQ(caller, celix_properties_get(metadata, "caller", nullptr));
+    };
+    celix_service_registration_options_t opts{};
+    opts.serviceName = CELIX_RSA_REMOTE_INTERCEPTOR_SERVICE_NAME;
+    opts.serviceVersion = CELIX_RSA_REMOTE_INTERCEPTOR_SERVICE_VERSION;
+    opts.svc = &interceptor;
+    auto interceptorSvcId = celix_bundleContext_registerServiceWithOptionsAsync(ctx.get(), &opts);
+    celix_bundleContext_waitForAsyncRegistration(ctx.get(), interceptorSvcId);
+
+    static std::atomic<int> nrOfRequests{0};
+    nrOfRequests = 0;
+    reqSenderSvc.sendRequest = [](void *handle, const endpoint_description_t *endpointDesc, celix_properties_t *metadata, const struct iovec *request, struct iovec *response) -> celix_status_t {
+        (void)handle;//unused
+        (void)endpointDesc;//unused
+        nrOfRequests++;
+        if (strncmp("{\"b\":[", (const char*)request->iov_base, 6) == 0) {
+            //the two calls of caller a are merged
+            EXPECT_STREQ("a", celix_properties_get(metadata, "caller", nullptr));
+            response->iov_base = strdup("{\"b\":[{},{}]}");
+        } else {
+            EXPECT_STREQ("b", celix_properties_get(metadata, "caller", nullptr));
+            response->iov_base = strdup("{}");
+        }
+        response->iov_len = strlen((const char*)response->iov_base) + 1;
+        return CELIX_SUCCESS;
+    };
+    auto endpoint = CreateEndpointDescription();
+    celix_properties_setBool(endpoint->properties, RSA_JSON_RPC_BATCH_SUPPORTED_KEY, true);
+    long proxySvcId = -1;
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &proxySvcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_waitForEvents(ctx.get());//wait for proxy service registration and interceptor tracking
+
+    auto call = [this](const char* callerName) {
+        caller = callerName;
+        auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, nullptr, [](void *handle, void *svc) {
+            (void)handle;//unused
+            auto proxySvc = static_cast<rsa_rpc_json_test_service_t*>(svc);
+            EXPECT_EQ(CELIX_SUCCESS, proxySvc->test(proxySvc->handle));
+        });
+        EXPECT_TRUE(found);
+    };
+    std::thread t1{call, "a"};
+    std::thread t2{call, "a"};
+    std::thread t3{call, "b"};
+    t1.join();
+    t2.join();
+    t3.join();
+
+    EXPECT_EQ(2, nrOfRequests.load());
+
+    rsaJsonRpc_destroyProxy(jsonRpc.get(), proxySvcId);
+    celix_bundleContext_unregisterServiceAsync(ctx.get(), interceptorSvcId, nullptr, nullptr);
+    celix_bundleContext_waitForEvents(ctx.get());
+    unsetenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY);
+    unsetenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY);
+}
+
+TEST_F(RsaJsonRpcProxyUnitTestSuite, CallProxyServiceWithBatchingAndInvalidBatchReply) {
+    setenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY, "5000000", true);
+    setenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY, "2", true);
+    reqSenderSvc.sendRequest = [](void *handle, const endpoint_description_t *endpointDesc, celix_properties_t *metadata, const struct iovec *request, struct iovec *response) -> celix_status_t {
+        (void)handle;//unused
+        (void)endpointDesc;//unused
+        (void)metadata;//unused
+        (void)request;//unused
+        response->iov_base = strdup("{\"b\":[{}]}");//only one reply for two calls
+        response->iov_len = strlen((const char*)response->iov_base) + 1;
+        return CELIX_SUCCESS;
+    };
+    auto endpoint = CreateEndpointDescription();
+    celix_properties_setBool(endpoint->properties, RSA_JSON_RPC_BATCH_SUPPORTED_KEY, true);
+    long proxySvcId = -1;
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &proxySvcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_waitForEvents(ctx.get());//wait for proxy service registration
+
+    auto call = [this]() {
+        auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, nullptr, [](void *handle, void *svc) {
+            (void)handle;//unused
+            auto proxySvc = static_cast<rsa_rpc_json_test_service_t*>(svc);
+            EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, proxySvc->test(proxySvc->handle));
+        });
+        EXPECT_TRUE(found);
+    };
+    std::thread t1{call};
+    std::thread t2{call};
+    t1.join();
+    t2.join();
+
+    rsaJsonRpc_destroyProxy(jsonRpc.get(), proxySvcId);
+    unsetenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY);
+    unsetenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY);
+}
+
+TEST_F(RsaJsonRpcProxyUnitTestSuite, CallProxyServiceWithBatchingNotSupportedByEndpoint) {
+    setenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY, "5000000", true);
+    setenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY, "2", true);
+    static std::atomic<int> nrOfRequests{0};
+    nrOfRequests = 0;
+    reqSenderSvc.sendRequest = [](void *handle, const endpoint_description_t *endpointDesc, celix_properties_t *metadata, const struct iovec *request, struct iovec *response) -> celix_status_t {
+        (void)handle;//unused
+        (void)endpointDesc;//unused
+        (void)metadata;//unused
+        EXPECT_NE(0, strncmp("{\"b\":", (const char*)request->iov_base, 4));//not a batch request
+        nrOfRequests++;
+        response->iov_base = strdup("{}");
+        response->iov_len = strlen((const char*)response->iov_base) + 1;
+        return CELIX_SUCCESS;
+    };
+    auto endpoint = CreateEndpointDescription();//without RSA_JSON_RPC_BATCH_SUPPORTED_KEY
+    long proxySvcId = -1;
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &proxySvcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_waitForEvents(ctx.get());//wait for proxy service registration
+
+    auto call = [this]() {
+        auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, nullptr, [](void *handle, void *svc) {
+            (void)handle;//unused
+            auto proxySvc = static_cast<rsa_rpc_json_test_service_t*>(svc);
+            EXPECT_EQ(CELIX_SUCCESS, proxySvc->test(proxySvc->handle));
+        });
+        EXPECT_TRUE(found);
+    };
+    std::thread t1{call};
+    std::thread t2{call};
+    t1.join();
+    t2.join();
+    EXPECT_EQ(2, nrOfRequests.load());
+
+    rsaJsonRpc_destroyProxy(jsonRpc.get(), proxySvcId);
+    unsetenv(RSA_JSON_RPC_BATCH_MAX_SIZE_KEY);
+    unsetenv(RSA_JSON_RPC_BATCH_WINDOW_US_KEY);
+}
+
+TEST_F(RsaJsonRpcProxyUnitTestSuite, UngetProxyServiceWithAsyncCallInFlight) {
+    static rsa_request_sender_completion_fp pendingCallback = nullptr;
+    static void *pendingCallbackData = nullptr;
+    pendingCallback = nullptr;
+    pendingCallbackData = nullptr;
+    reqSenderSvc.sendRequestAsync = [](void *handle, const endpoint_description_t *endpointDesc, celix_properties_t *metadata, const struct iovec *request, rsa_request_sender_completion_fp callback, void *callbackData) -> celix_status_t {
+        (void)handle;//unused
+        (void)endpointDesc;//unused
+        (void)metadata;//unused
+        (void)request;//unused
+        pendingCallback = callback;
+        pendingCallbackData = callbackData;
+        return CELIX_SUCCESS;
+    };
+    auto endpoint = CreateEndpointDescription();
+    long proxySvcId = -1;
+    auto status = rsaJsonRpc_createProxy(jsonRpc.get(), endpoint, reqSenderSvcId, &proxySvcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_waitForEvents(ctx.get());//wait for proxy service registration
+
+    struct CallData {
+        rsa_json_rpc_t *jsonRpc;
+        long proxySvcId;
+        std::atomic<celix_status_t> result;
+    } callData{jsonRpc.get(), proxySvcId, {-1}};
+    //the proxy service is ungotten directly after the async call is sent, so the proxy is detached
+    auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, &callData, [](void *handle, void *svc) {
+        auto data = static_cast<CallData*>(handle);
+        auto rc = rsaJsonRpc_callAsync(data->jsonRpc, data->proxySvcId, svc, "test", nullptr, [](void *callbackData, celix_status_t callStatus) {
+            static_cast<CallData*>(callbackData)->result = callStatus;
+        }, data);
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+    });
+    EXPECT_TRUE(found);
+    ASSERT_NE(nullptr, pendingCallback);
+    EXPECT_EQ(-1, callData.result.load());
+
+    //destroying the proxy factory does not wait for the in-flight call either
+    rsaJsonRpc_destroyProxy(jsonRpc.get(), proxySvcId);
+    celix_bundleContext_waitForEvents(ctx.get());
+
+    struct iovec response{strdup("{}"), 3};
+    pendingCallback(pendingCallbackData, CELIX_SUCCESS, &response);
+    EXPECT_EQ(CELIX_SUCCESS, callData.result.load());
+    reqSenderSvc.sendRequestAsync = nullptr;
+}
+
 TEST_F(RsaJsonRpcProxyUnitTestSuite2, CallProxyService) {
     auto found = celix_bundleContext_useService(ctx.get(), RSA_RPC_JSON_TEST_SERVICE, nullptr, [](void *handle, void *svc) {
         (void)handle;//unused
@@ -757,6 +1018,101 @@ TEST_F(RsaJsonRpcEndPointUnitTestSuite, UseRequestHandler) {
     endpointDescription_destroy(endpoint);
 }
 
+TEST_F(RsaJsonRpcEndPointUnitTestSuite, UseRequestHandlerWithBatchRequest) {
+    auto endpoint = CreateEndpointDescription(rpcTestSvcId);
+    long svcId = -1L;
+    auto status = rsaJsonRpc_createEndpoint(jsonRpc.get(), endpoint, &svcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    celix_bundleContext_waitForEvents(ctx.get());//wait for async endpoint creation
+
+    unsigned int serialProtoId = GenerateSerialProtoId();
+    celix_properties_t *metadata = celix_properties_create();
+    celix_properties_setLong(metadata, "SerialProtocolId", serialProtoId);
+
+    auto found = celix_bundleContext_useService(ctx.get(), CELIX_RSA_REQUEST_HANDLER_SERVICE_NAME, metadata, [](void *handle, void *svc) {
+        celix_properties_t *metadata = static_cast< celix_properties_t *>(handle);
+        auto reqHandler = static_cast<rsa_request_handler_service_t*>(svc);
+        EXPECT_NE(nullptr, reqHandler);
+        struct iovec request{};
+        request.iov_base =  (char *)"{\"b\":[{\"m\":\"test\",\"a\":[]},{\"a\":[]},{\"m\":\"unknown\",\"a\":[]}]}";
+        request.iov_len = strlen((char*)request.iov_base);
+        struct iovec reply{nullptr,0};
+        EXPECT_EQ(CELIX_SUCCESS, reqHandler->handleRequest(reqHandler->handle, metadata, &request, &reply));
+        //the second request has no method and the third request calls an unknown method
+        std::string expected = std::string{"{\"b\":[{},{\"s\":"} + std::to_string(CELIX_ILLEGAL_ARGUMENT) +
+                "},{\"s\":" + std::to_string(CELIX_SERVICE_EXCEPTION) + "}]}";
+        EXPECT_STREQ(expected.c_str(), (char*)reply.iov_base);
+        free(reply.iov_base);
+    });
+    EXPECT_TRUE(found);
+
+    celix_properties_destroy(metadata);
+
+    rsaJsonRpc_destroyEndpoint(jsonRpc.get(), svcId);
+    endpointDescription_destroy(endpoint);
+}
+
+TEST_F(RsaJsonRpcEndPointUnitTestSuite, BatchedInvocationsGetTheirOwnMetadata) {
+    static std::atomic<int> nrOfPreExportCalls{0};
+    nrOfPreExportCalls = 0;
+    static remote_interceptor_t interceptor{};
+    interceptor.preExportCall = [](void *handle, const celix_properties_t *svcProperties, const char *functionName, celix_properties_t *metadata) -> bool {
+        (void)handle;//unused
+        (void)svcProperties;//unused
+        (void)functionName;//unused
+        //metadata set by the interceptor for a previous invocation in the batch must not be visible
+        EXPECT_FALSE(celix_properties_hasKey(metadata, "intercepted"));
+        celix_properties_setBool(metadata, "intercepted", true);
+        nrOfPreExportCalls++;
+        return true;
+    };
+    interceptor.postExportCall = [](void *handle, const celix_properties_t *svcProperties, const char *functionName, celix_properties_t *metadata) {
+        (void)handle;//unused
+        (void)svcProperties;//unused
+        (void)functionName;//unused
+        EXPECT_TRUE(celix_properties_getAsBool(metadata, "intercepted", false));
+    };
+    celix_service_registration_options_t opts{};
+    opts.serviceName = CELIX_RSA_REMOTE_INTERCEPTOR_SERVICE_NAME;
+    opts.serviceVersion = CELIX_RSA_REMOTE_INTERCEPTOR_SERVICE_VERSION;
+    opts.svc = &interceptor;
+    auto interceptorSvcId = celix_bundleContext_registerServiceWithOptionsAsync(ctx.get(), &opts);
+    celix_bundleContext_waitForAsyncRegistration(ctx.get(), interceptorSvcId);
+
+    auto endpoint = CreateEndpointDescription(rpcTestSvcId);
+    long svcId = -1L;
+    auto status = rsaJsonRpc_createEndpoint(jsonRpc.get(), endpoint, &svcId);
+    EXPECT_EQ(CELIX_SUCCESS, status);
+
+    celix_bundleContext_waitForEvents(ctx.get());//wait for async endpoint creation and interceptor tracking
+
+    unsigned int serialProtoId = GenerateSerialProtoId();
+    celix_properties_t *metadata = celix_properties_create();
+    celix_properties_setLong(metadata, "SerialProtocolId", serialProtoId);
+
+    auto found = celix_bundleContext_useService(ctx.get(), CELIX_RSA_REQUEST_HANDLER_SERVICE_NAME, metadata, [](void *handle, void *svc) {
+        celix_properties_t *metadata = static_cast< celix_properties_t *>(handle);
+        auto reqHandler = static_cast<rsa_request_handler_service_t*>(svc);
+        struct iovec request{};
+        request.iov_base =  (char *)"{\"b\":[{\"m\":\"test\",\"a\":[]},{\"m\":\"test\",\"a\":[]}]}";
+        request.iov_len = strlen((char*)request.iov_base);
+        struct iovec reply{nullptr,0};
+        EXPECT_EQ(CELIX_SUCCESS, reqHandler->handleRequest(reqHandler->handle, metadata, &request, &reply));
+        EXPECT_STREQ("{\"b\":[{},{}]}", (char*)reply.iov_base);
+        free(reply.iov_base);
+    });
+    EXPECT_TRUE(found);
+    EXPECT_EQ(2, nrOfPreExportCalls.load());
+    EXPECT_FALSE(celix_properties_hasKey(metadata, "intercepted"));
+
+    celix_properties_destroy(metadata);
+
+    rsaJsonRpc_destroyEndpoint(jsonRpc.get(), svcId);
+    endpointDescription_destroy(endpoint);
+    celix_bundleContext_unregisterServiceAsync(ctx.get(), interceptorSvcId, nullptr, nullptr);
+}
+
 TEST_F(RsaJsonRpcEndPointUnitTestSuite, FailedToFindInterfaceDescriptor) {
     setenv("CELIX_FRAMEWORK_EXTENDER_PATH", RESOURCES_DIR"/non-exist", true);
     auto endpoint = CreateEndpointDescription(rpcTestSvcId);
@@ -18,8 +18,10 @@
  */
 
 #include "rsa_json_rpc_impl.h"
+#include "rsa_json_rpc_constants.h"
 #include "celix_log_helper.h"
 #include "rsa_rpc_factory.h"
+#include "rsa_rpc_async_call_service.h"
 #include "celix_bundle_activator.h"
 #include <assert.h>
 
@@ -29,6 +31,8 @@ typedef struct rsa_json_rpc_activator {
     rsa_json_rpc_t *jsonRpc;
     rsa_rpc_factory_t rpcFac;
     long rpcSvcId;
+    rsa_rpc_async_call_service_t asyncCallSvc;
+    long asyncCallSvcId;
     celix_log_helper_t *logHelper;
 }rsa_json_rpc_activator_t;
 
@@ -39,6 +43,7 @@ static celix_status_t rsaJsonRpc_start(rsa_json_rpc_activator_t* activator, celi
 
     activator->ctx = ctx;
     activator->rpcSvcId = -1;
+    activator->asyncCallSvcId = -1;
     celix_autoptr(celix_log_helper_t) logHelper = activator->logHelper = celix_logHelper_create(ctx, "rsa_json_rpc");
     if (activator->logHelper == NULL) {
         return CELIX_BUNDLE_EXCEPTION;
@@ -56,6 +61,7 @@ static celix_status_t rsaJsonRpc_start(rsa_json_rpc_activator_t* activator, celi
         return CELIX_ENOMEM;
     }
     celix_properties_set(props, CELIX_RSA_RPC_TYPE_KEY, "celix.remote.admin.rpc_type.json");
+    celix_properties_setBool(props, RSA_JSON_RPC_BATCH_SUPPORTED_KEY, true);
     activator->rpcFac.handle = activator->jsonRpc;
     activator->rpcFac.createProxy = rsaJsonRpc_createProxy;
     activator->rpcFac.destroyProxy = rsaJsonRpc_destroyProxy;
@@ -71,6 +77,29 @@ static celix_status_t rsaJsonRpc_start(rsa_json_rpc_activator_t* activator, celi
         celix_logHelper_error(activator->logHelper, "Error registering json rpc service.");
         return CELIX_BUNDLE_EXCEPTION;
     }
+
+    celix_properties_t *asyncCallProps = celix_properties_create();
+    if (asyncCallProps == NULL) {
+        celix_logHelper_error(activator->logHelper, "Error creating properties for json rpc async call service.");
+        celix_bundleContext_unregisterServiceAsync(ctx, activator->rpcSvcId, NULL, NULL);
+        celix_bundleContext_waitForEvents(ctx);
+        return CELIX_ENOMEM;
+    }
+    celix_properties_set(asyncCallProps, CELIX_RSA_RPC_TYPE_KEY, "celix.remote.admin.rpc_type.json");
+    activator->asyncCallSvc.handle = activator->jsonRpc;
+    activator->asyncCallSvc.callAsync = rsaJsonRpc_callAsync;
+    celix_service_registration_options_t asyncCallOpts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    asyncCallOpts.serviceName = CELIX_RSA_RPC_ASYNC_CALL_SERVICE_NAME;
+    asyncCallOpts.serviceVersion = CELIX_RSA_RPC_ASYNC_CALL_SERVICE_VERSION;
+    asyncCallOpts.properties = asyncCallProps;
+    asyncCallOpts.svc = &activator->asyncCallSvc;
+    activator->asyncCallSvcId = celix_bundleContext_registerServiceWithOptionsAsync(ctx, &asyncCallOpts);
+    if (activator->asyncCallSvcId < 0) {
+        celix_logHelper_error(activator->logHelper, "Error registering json rpc async call service.");
+        celix_bundleContext_unregisterServiceAsync(ctx, activator->rpcSvcId, NULL, NULL);
+        celix_bundleContext_waitForEvents(ctx);
+        return CELIX_BUNDLE_EXCEPTION;
+    }
     celix_steal_ptr(jsonRpc);
     celix_steal_ptr(logHelper);
     return CELIX_SUCCESS;
@@ -79,6 +108,7 @@ static celix_status_t rsaJsonRpc_start(rsa_json_rpc_activator_t* activator, celi
 static celix_status_t rsaJsonRpc_stop(rsa_json_rpc_activator_t *activator, celix_bundle_context_t* ctx) {
     assert(activator != NULL);
     assert(ctx != NULL);
+    celix_bundleContext_unregisterServiceAsync(ctx, activator->asyncCallSvcId, NULL, NULL);
     celix_bundleContext_unregisterServiceAsync(ctx, activator->rpcSvcId, NULL, NULL);
     celix_bundleContext_waitForEvents(ctx);//Ensure that no events use jsonRpc
     rsaJsonRpc_destroy(activator->jsonRpc);
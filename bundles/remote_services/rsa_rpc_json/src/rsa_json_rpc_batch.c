@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "rsa_json_rpc_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+celix_status_t rsaJsonRpcBatch_compose(const struct iovec* messages, size_t nrOfMessages, struct iovec* out) {
+    char* buf = NULL;
+    size_t len = 0;
+    FILE* stream = open_memstream(&buf, &len);
+    if (stream == NULL) {
+        return CELIX_ENOMEM;
+    }
+    fputs("{\"" RSA_JSON_RPC_BATCH_KEY "\":[", stream);
+    for (size_t i = 0; i < nrOfMessages; ++i) {
+        if (i > 0) {
+            fputc(',', stream);
+        }
+        //the messages are null terminated JSON strings
+        fputs((const char*)messages[i].iov_base, stream);
+    }
+    fputs("]}", stream);
+    if (fclose(stream) != 0) {
+        free(buf);
+        return CELIX_ENOMEM;
+    }
+    out->iov_base = buf;
+    out->iov_len = len + 1;// make it include '\0'
+    return CELIX_SUCCESS;
+}
+
+json_t* rsaJsonRpcBatch_getMessages(json_t* message) {
+    json_t* messages = json_is_object(message) ? json_object_get(message, RSA_JSON_RPC_BATCH_KEY) : NULL;
+    return json_is_array(messages) ? messages : NULL;
+}
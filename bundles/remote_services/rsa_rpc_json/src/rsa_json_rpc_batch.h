@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_JSON_RPC_BATCH_H_
+#define _RSA_JSON_RPC_BATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "celix_errno.h"
+#include <jansson.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+/**
+ * A batch request carries multiple JSON-RPC invocations for the same endpoint: {"b":[<request>,...]}.
+ * The reply of a batch request is {"b":[<reply>,...]}, where the n-th reply belongs to the n-th request. A reply is
+ * either the JSON-RPC reply of the invocation or {"s":<status>} if the endpoint failed to handle the invocation.
+ */
+#define RSA_JSON_RPC_BATCH_KEY "b"
+#define RSA_JSON_RPC_BATCH_STATUS_KEY "s"
+
+/**
+ * @brief Composes a batch request or batch reply from the given JSON-RPC messages.
+ *
+ * The messages are not reparsed, they are copied as is in the batch array.
+ * The caller is the owner of the output and should free the iov_base using free.
+ */
+celix_status_t rsaJsonRpcBatch_compose(const struct iovec* messages, size_t nrOfMessages, struct iovec* out);
+
+/**
+ * @brief Returns the array of batched messages from a (parsed) JSON-RPC message or NULL if it is not a batch message.
+ */
+json_t* rsaJsonRpcBatch_getMessages(json_t* message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_JSON_RPC_BATCH_H_ */
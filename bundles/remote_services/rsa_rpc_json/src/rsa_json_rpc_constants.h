@@ -29,6 +29,23 @@ extern "C" {
 #define RSA_JSON_RPC_LOG_CALLS_FILE_KEY          "RSA_JSON_RPC_LOG_CALLS_FILE"
 #define RSA_JSON_RPC_LOG_CALLS_FILE_DEFAULT      "stdout"
 
+/**
+ * The time window (in microseconds) in which concurrent calls to the same imported endpoint are coalesced into a
+ * single batch request. 0 disables batching. Calls are only batched if the endpoint description advertises that the
+ * exporting side supports batch requests, see RSA_JSON_RPC_BATCH_SUPPORTED_KEY.
+ */
+#define RSA_JSON_RPC_BATCH_WINDOW_US_KEY         "RSA_JSON_RPC_BATCH_WINDOW_US"
+#define RSA_JSON_RPC_BATCH_WINDOW_US_DEFAULT     0
+/**
+ * The max number of calls in a single batch request. A full batch is sent without waiting for the batch window.
+ */
+#define RSA_JSON_RPC_BATCH_MAX_SIZE_KEY          "RSA_JSON_RPC_BATCH_MAX_SIZE"
+#define RSA_JSON_RPC_BATCH_MAX_SIZE_DEFAULT      32
+/**
+ * The rpc capability (see CELIX_RSA_RPC_CAPABILITY_PREFIX) which advertises that the endpoint handles batch requests.
+ */
+#define RSA_JSON_RPC_BATCH_SUPPORTED_KEY         "celix.remote.admin.rpc.json.batch"
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,17 +18,21 @@
  */
 
 #include "rsa_json_rpc_endpoint_impl.h"
+#include "rsa_json_rpc_batch.h"
 #include "rsa_request_handler_service.h"
 #include "remote_interceptors_handler.h"
 #include "endpoint_description.h"
 #include "dfi_utils.h"
 #include "json_rpc.h"
+#include "dyn_interface_plan.h"
 #include "celix_stdlib_cleanup.h"
 #include "celix_threads.h"
 #include "celix_constants.h"
 #include <sys/uio.h>
 #include <jansson.h>
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 struct rsa_json_rpc_endpoint {
@@ -44,6 +48,7 @@ struct rsa_json_rpc_endpoint {
     celix_thread_rwlock_t lock; //projects below
     void *service;
     dyn_interface_type *intfType;
+    dyn_interface_plan *intfPlan;
 };
 
 static void rsaJsonRpcEndpoint_stopSvcTrackerDone(void *data);
@@ -82,6 +87,7 @@ celix_status_t rsaJsonRpcEndpoint_create(celix_bundle_context_t* ctx, celix_log_
     endpoint->interceptorsHandler = interceptorsHandler;
     endpoint->service = NULL;
     endpoint->intfType = NULL;
+    endpoint->intfPlan = NULL;
     status = celixThreadRwlock_create(&endpoint->lock, NULL);
     if (status != CELIX_SUCCESS) {
         celix_logHelper_error(logHelper, "RSA json rpc endpoint: Error initilizing lock for %s. %d.",
@@ -184,8 +190,16 @@ static void rsaJsonRpcEndpoint_addSvcWithOwner(void *handle, void *service,
         return;
     }
 
+    celix_autoptr(dyn_interface_plan) intfPlan = NULL;
+    if (dynInterfacePlan_create(intfType, &intfPlan) != 0) {
+        celix_logHelper_logTssErrors(endpoint->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(endpoint->logHelper, "Endpoint: Error creating interface plan for %s.", serviceName);
+        return;
+    }
+
     endpoint->service = service;
     endpoint->intfType = celix_steal_ptr(intfType);
+    endpoint->intfPlan = celix_steal_ptr(intfPlan);
     return;
 }
 
@@ -198,15 +212,124 @@ static void rsaJsonRpcEndpoint_removeSvcWithOwner(void *handle, void *service,
     celix_auto(celix_rwlock_wlock_guard_t) lock = celixRwlockWlockGuard_init(&endpoint->lock);
     if (endpoint->service == service) {
         endpoint->service = NULL;
+        dynInterfacePlan_destroy(endpoint->intfPlan);
+        endpoint->intfPlan = NULL;
         dynInterface_destroy(endpoint->intfType);
         endpoint->intfType = NULL;
     }
     return;
 }
 
+static celix_status_t rsaJsonRpcEndpoint_invoke(rsa_json_rpc_endpoint_t *endpoint, celix_properties_t **metadata,
+        const char *sig, const char *request, char **responseOut) {
+    celix_status_t status = CELIX_SUCCESS;
+    char *szResponse = NULL;
+    bool cont = remoteInterceptorHandler_invokePreExportCall(endpoint->interceptorsHandler,
+            endpoint->endpointDesc->properties, sig, metadata);
+    if (cont) {
+        celixThreadRwlock_readLock(&endpoint->lock);
+        if (endpoint->service != NULL) {
+            int rc1 = jsonRpc_callWithPlan(endpoint->intfPlan, endpoint->service, request, &szResponse);
+            status = (rc1 != 0) ? CELIX_SERVICE_EXCEPTION : CELIX_SUCCESS;
+            if (rc1 != 0) {
+                celix_logHelper_logTssErrors(endpoint->logHelper, CELIX_LOG_LEVEL_ERROR);
+                celix_logHelper_error(endpoint->logHelper, "Error calling remote service. Got error code %d", rc1);
+            }
+        } else {
+            status = CELIX_ILLEGAL_STATE;
+            celix_logHelper_error(endpoint->logHelper, "%s is null, please try again.", endpoint->endpointDesc->serviceName);
+        }
+        celixThreadRwlock_unlock(&endpoint->lock);
+
+        remoteInterceptorHandler_invokePostExportCall(endpoint->interceptorsHandler,
+                endpoint->endpointDesc->properties, sig, *metadata);
+    } else {
+        celix_logHelper_error(endpoint->logHelper, "%s has been intercepted.", endpoint->endpointDesc->serviceName);
+        status = CELIX_INTERCEPTOR_EXCEPTION;
+    }
+
+    if (endpoint->callsLogFile != NULL) {
+        fprintf(endpoint->callsLogFile, "ENDPOINT REMOTE CALL:\n\tservice=%s\n\tservice_id=%lu\n\trequest_payload=%s\n\trequest_response=%s\n\tstatus=%i\n",
+                endpoint->endpointDesc->serviceName, endpoint->endpointDesc->serviceId, request, szResponse, status);
+        fflush(endpoint->callsLogFile);
+    }
+
+    *responseOut = szResponse;
+    return status;
+}
+
+static char* rsaJsonRpcEndpoint_statusReply(celix_status_t status) {
+    char *reply = NULL;
+    if (asprintf(&reply, "{\"" RSA_JSON_RPC_BATCH_STATUS_KEY "\":%d}", status) < 0) {
+        return NULL;
+    }
+    return reply;
+}
+
+/**
+ * Handles a batch request. Every invocation in the batch is dispatched (and intercepted) separately using its own copy
+ * of the metadata of the batch request, so interceptors cannot leak state from one call into the next.
+ * A failed invocation does not fail the batch, its status is returned in its reply.
+ */
+static celix_status_t rsaJsonRpcEndpoint_handleBatchRequest(rsa_json_rpc_endpoint_t *endpoint,
+        celix_properties_t *metadata, json_t *requests, struct iovec *responseOut) {
+    size_t nrOfRequests = json_array_size(requests);
+    celix_autofree struct iovec *replies = calloc(nrOfRequests > 0 ? nrOfRequests : 1, sizeof(*replies));
+    if (replies == NULL) {
+        celix_logHelper_error(endpoint->logHelper, "Error allocating replies for batch request of %s.",
+                endpoint->endpointDesc->serviceName);
+        return CELIX_ENOMEM;
+    }
+
+    celix_status_t status = CELIX_SUCCESS;
+    size_t nrOfReplies = 0;
+    for (; nrOfReplies < nrOfRequests && status == CELIX_SUCCESS; ++nrOfReplies) {
+        json_t *jsRequest = json_array_get(requests, nrOfReplies);
+        const char *sig = NULL;
+        celix_autofree char *request = NULL;
+        char *reply = NULL;
+        celix_status_t callStatus = CELIX_ILLEGAL_ARGUMENT;
+        if (json_unpack(jsRequest, "{s:s}", "m", &sig) == 0) {
+            celix_autoptr(celix_properties_t) callMetadata = celix_properties_copy(metadata);
+            request = json_dumps(jsRequest, JSON_COMPACT);
+            if (request != NULL && callMetadata != NULL) {
+                callStatus = rsaJsonRpcEndpoint_invoke(endpoint, &callMetadata, sig, request, &reply);
+            } else {
+                callStatus = CELIX_ENOMEM;
+            }
+        } else {
+            celix_logHelper_error(endpoint->logHelper, "Error requesting method for batched request %zu of %s.",
+                    nrOfReplies, endpoint->endpointDesc->serviceName);
+        }
+        if (reply == NULL) {
+            reply = rsaJsonRpcEndpoint_statusReply(callStatus);
+        } else if (callStatus != CELIX_SUCCESS) {
+            free(reply);
+            reply = rsaJsonRpcEndpoint_statusReply(callStatus);
+        }
+        if (reply == NULL) {
+            status = CELIX_ENOMEM;
+            continue;
+        }
+        replies[nrOfReplies].iov_base = reply;
+        replies[nrOfReplies].iov_len = strlen(reply) + 1;
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = rsaJsonRpcBatch_compose(replies, nrOfReplies, responseOut);
+    }
+    for (size_t i = 0; i < nrOfReplies; ++i) {
+        free(replies[i].iov_base);
+    }
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(endpoint->logHelper, "Error creating batch reply for %s. %d.",
+                endpoint->endpointDesc->serviceName, status);
+    }
+    return status;
+}
+
 static celix_status_t rsaJsonRpcEndpoint_handleRequest(void *handle, celix_properties_t *metadata,
         const struct iovec *request, struct iovec *responseOut) {
-    celix_status_t status = CELIX_SUCCESS;
     if (handle == NULL || request == NULL || request->iov_base == NULL
             || request->iov_len == 0 || responseOut == NULL || metadata == NULL) {
         return CELIX_ILLEGAL_ARGUMENT;
@@ -227,6 +350,10 @@ static celix_status_t rsaJsonRpcEndpoint_handleRequest(void *handle, celix_prope
         celix_logHelper_error(endpoint->logHelper, "Parse request json string failed for %s.", (char *)request->iov_base);
         return CELIX_ILLEGAL_ARGUMENT;
     }
+    json_t *batchedRequests = rsaJsonRpcBatch_getMessages(jsRequest);
+    if (batchedRequests != NULL) {
+        return rsaJsonRpcEndpoint_handleBatchRequest(endpoint, metadata, batchedRequests, responseOut);
+    }
     const char *sig;
     int rc = json_unpack(jsRequest, "{s:s}", "m", &sig);
     if (rc != 0) {
@@ -235,40 +362,10 @@ static celix_status_t rsaJsonRpcEndpoint_handleRequest(void *handle, celix_prope
     }
 
     char *szResponse = NULL;
-    bool cont = remoteInterceptorHandler_invokePreExportCall(endpoint->interceptorsHandler,
-            endpoint->endpointDesc->properties, sig, &metadata);
-    if (cont) {
-        celixThreadRwlock_readLock(&endpoint->lock);
-        if (endpoint->service != NULL) {
-            int rc1 = jsonRpc_call(endpoint->intfType, endpoint->service, (char *)request->iov_base, &szResponse);
-            status = (rc1 != 0) ? CELIX_SERVICE_EXCEPTION : CELIX_SUCCESS;
-            if (rc1 != 0) {
-                celix_logHelper_logTssErrors(endpoint->logHelper, CELIX_LOG_LEVEL_ERROR);
-                celix_logHelper_error(endpoint->logHelper, "Error calling remote service. Got error code %d", rc1);
-            }
-        } else {
-            status = CELIX_ILLEGAL_STATE;
-            celix_logHelper_error(endpoint->logHelper, "%s is null, please try again.", endpoint->endpointDesc->serviceName);
-        }
-        celixThreadRwlock_unlock(&endpoint->lock);
-
-        remoteInterceptorHandler_invokePostExportCall(endpoint->interceptorsHandler,
-                endpoint->endpointDesc->properties, sig, metadata);
-    } else {
-        celix_logHelper_error(endpoint->logHelper, "%s has been intercepted.", endpoint->endpointDesc->serviceName);
-        status = CELIX_INTERCEPTOR_EXCEPTION;
-    }
-
+    celix_status_t status = rsaJsonRpcEndpoint_invoke(endpoint, &metadata, sig, (const char *)request->iov_base, &szResponse);
     if (szResponse != NULL) {
         responseOut->iov_base = szResponse;
         responseOut->iov_len = strlen(szResponse) + 1;// make it include '\0'
     }
-
-    if (endpoint->callsLogFile != NULL) {
-        fprintf(endpoint->callsLogFile, "ENDPOINT REMOTE CALL:\n\tservice=%s\n\tservice_id=%lu\n\trequest_payload=%s\n\trequest_response=%s\n\tstatus=%i\n",
-                endpoint->endpointDesc->serviceName, endpoint->endpointDesc->serviceId, (char *)request->iov_base, szResponse, status);
-        fflush(endpoint->callsLogFile);
-    }
-
     return status;
-}
\ No newline at end of file
+}
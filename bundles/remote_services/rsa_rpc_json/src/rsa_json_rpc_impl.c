@@ -41,8 +41,10 @@
 struct rsa_json_rpc {
     celix_bundle_context_t *ctx;
     celix_log_helper_t *logHelper;
-    celix_thread_mutex_t mutex; //It protects svcProxyFactories and svcEndpoints
+    celix_thread_mutex_t mutex; //It protects svcProxyFactories, svcEndpoints and nrOfDestroyingProxyFactories
+    celix_thread_cond_t proxyFactoryDestroyedCond; //broadcasted when a proxy factory is freed
     celix_long_hash_map_t *svcProxyFactories;// Key: proxy factory service id, Value: rsa_json_rpc_proxy_factory_t
+    unsigned int nrOfDestroyingProxyFactories; //proxy factories which are destroyed, but not yet freed
     celix_long_hash_map_t *svcEndpoints;// Key:request handler service id, Value: rsa_json_rpc_endpoint_t
     remote_interceptors_handler_t *interceptorsHandler;
     rsa_request_sender_tracker_t *reqSenderTracker;
@@ -90,6 +92,12 @@ celix_status_t rsaJsonRpc_create(celix_bundle_context_t* ctx, celix_log_helper_t
         return status;
     }
     celix_autoptr(celix_thread_mutex_t) mutex = &rpc->mutex;
+    status = celixThreadCondition_init(&rpc->proxyFactoryDestroyedCond, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Error creating proxy factory condition. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_cond_t) proxyFactoryDestroyedCond = &rpc->proxyFactoryDestroyedCond;
     celix_autoptr(celix_long_hash_map_t) svcProxyFactories = rpc->svcProxyFactories = celix_longHashMap_create();
     assert(rpc->svcProxyFactories != NULL);
     celix_autoptr(celix_long_hash_map_t) svcEndpoints = rpc->svcEndpoints = celix_longHashMap_create();
@@ -122,6 +130,7 @@ celix_status_t rsaJsonRpc_create(celix_bundle_context_t* ctx, celix_log_helper_t
     celix_steal_ptr(interceptorsHandler);
     celix_steal_ptr(svcEndpoints);
     celix_steal_ptr(svcProxyFactories);
+    celix_steal_ptr(proxyFactoryDestroyedCond);
     celix_steal_ptr(mutex);
     *jsonRpcOut = celix_steal_ptr(rpc);
     return CELIX_SUCCESS;
@@ -129,6 +138,12 @@ celix_status_t rsaJsonRpc_create(celix_bundle_context_t* ctx, celix_log_helper_t
 
 void rsaJsonRpc_destroy(rsa_json_rpc_t *jsonRpc) {
     if (jsonRpc != NULL) {
+        //the async calls of detached proxies use the request sender tracker, the interceptors and the calls log file
+        celixThreadMutex_lock(&jsonRpc->mutex);
+        while (jsonRpc->nrOfDestroyingProxyFactories > 0) {
+            celixThreadCondition_wait(&jsonRpc->proxyFactoryDestroyedCond, &jsonRpc->mutex);
+        }
+        celixThreadMutex_unlock(&jsonRpc->mutex);
         if (jsonRpc->callsLogFile != NULL && jsonRpc->callsLogFile != stdout) {
             fclose(jsonRpc->callsLogFile);
         }
@@ -138,6 +153,7 @@ void rsaJsonRpc_destroy(rsa_json_rpc_t *jsonRpc) {
         celix_longHashMap_destroy(jsonRpc->svcEndpoints);
         assert(celix_longHashMap_size(jsonRpc->svcProxyFactories) == 0);
         celix_longHashMap_destroy(jsonRpc->svcProxyFactories);
+        (void)celixThreadCondition_destroy(&jsonRpc->proxyFactoryDestroyedCond);
         (void)celixThreadMutex_destroy(&jsonRpc->mutex);
         free(jsonRpc);
     }
@@ -173,6 +189,13 @@ celix_status_t rsaJsonRpc_createProxy(void *handle, const endpoint_description_t
     return CELIX_SUCCESS;
 }
 
+static void rsaJsonRpc_proxyFactoryDestroyed(void *data) {
+    rsa_json_rpc_t *jsonRpc = (rsa_json_rpc_t *)data;
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&jsonRpc->mutex);
+    jsonRpc->nrOfDestroyingProxyFactories -= 1;
+    celixThreadCondition_broadcast(&jsonRpc->proxyFactoryDestroyedCond);
+}
+
 void rsaJsonRpc_destroyProxy(void *handle, long proxySvcId) {
     if (handle == NULL  || proxySvcId < 0) {
         return;
@@ -183,9 +206,12 @@ void rsaJsonRpc_destroyProxy(void *handle, long proxySvcId) {
             celix_longHashMap_get(jsonRpc->svcProxyFactories, proxySvcId);
     if (proxyFactory != NULL) {
         (void)celix_longHashMap_remove(jsonRpc->svcProxyFactories, proxySvcId);
-        rsaJsonRpcProxy_factoryDestroy(proxyFactory);
+        jsonRpc->nrOfDestroyingProxyFactories += 1;
     }
     celixThreadMutex_unlock(&jsonRpc->mutex);
+    if (proxyFactory != NULL) {
+        rsaJsonRpcProxy_factoryDestroy(proxyFactory, jsonRpc, rsaJsonRpc_proxyFactoryDestroyed);
+    }
     return;
 }
 
@@ -232,3 +258,24 @@ void rsaJsonRpc_destroyEndpoint(void *handle, long requestHandlerSvcId) {
     return;
 }
 
+
+celix_status_t rsaJsonRpc_callAsync(void *handle, long svcId, void *svc, const char *methodName, void *args[],
+        rsa_rpc_async_call_completion_fp callback, void *callbackData) {
+    if (handle == NULL || svc == NULL || methodName == NULL || callback == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    rsa_json_rpc_t *jsonRpc = (rsa_json_rpc_t *)handle;
+    rsa_json_rpc_proxy_t *proxy = NULL;
+    celixThreadMutex_lock(&jsonRpc->mutex);
+    //The service id of an imported service is the service id of its proxy factory
+    rsa_json_rpc_proxy_factory_t *proxyFactory = celix_longHashMap_get(jsonRpc->svcProxyFactories, svcId);
+    if (proxyFactory != NULL) {
+        proxy = rsaJsonRpcProxy_acquire(proxyFactory, svc);
+    }
+    celixThreadMutex_unlock(&jsonRpc->mutex);
+    if (proxy == NULL) {
+        celix_logHelper_error(jsonRpc->logHelper, "Service %ld is not an imported json rpc service.", svcId);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    return rsaJsonRpcProxy_callAsync(proxy, methodName, args, callback, callbackData);
+}
@@ -28,6 +28,7 @@ extern "C" {
 #include "celix_log_helper.h"
 #include "celix_types.h"
 #include "celix_errno.h"
+#include "rsa_rpc_async_call_service.h"
 
 typedef struct rsa_json_rpc rsa_json_rpc_t;
 
@@ -47,6 +48,9 @@ celix_status_t rsaJsonRpc_createEndpoint(void *handle, const endpoint_descriptio
 
 void rsaJsonRpc_destroyEndpoint(void *handle, long requestHandlerSvcId);
 
+celix_status_t rsaJsonRpc_callAsync(void *handle, long svcId, void *svc, const char *methodName, void *args[],
+        rsa_rpc_async_call_completion_fp callback, void *callbackData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,8 +18,11 @@
  */
 
 #include "rsa_json_rpc_proxy_impl.h"
+#include "rsa_json_rpc_batch.h"
+#include "rsa_json_rpc_constants.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <sys/queue.h>
 #include <string.h>
@@ -30,6 +33,7 @@
 #include "celix_long_hash_map.h"
 #include "celix_rsa_utils.h"
 #include "celix_stdlib_cleanup.h"
+#include "celix_threads.h"
 #include "celix_version.h"
 #include "dfi_utils.h"
 #include "endpoint_description.h"
@@ -44,24 +48,71 @@ struct rsa_json_rpc_proxy_factory {
     celix_service_factory_t factory;
     long factorySvcId;
     endpoint_description_t *endpointDesc;
-    celix_long_hash_map_t *proxies;//Key:requestingBundle, Value: rsa_json_rpc_proxy_t *. Work on the celix_event thread , so locks are not required
+    celix_long_hash_map_t *proxies;//Key:requestingBundle, Value: rsa_json_rpc_proxy_t *. Modified on the celix_event thread with asyncMutex locked
     remote_interceptors_handler_t *interceptorsHandler;
     rsa_request_sender_tracker_t *reqSenderTracker;
     long reqSenderSvcId;
+    long batchWindowInUs; //0 means batching is disabled
+    long maxBatchSize;
+    celix_thread_mutex_t batchMutex; //protects below
+    celix_thread_cond_t batchCond; //signaled when the pending batch is full
+    celix_thread_cond_t batchDoneCond; //broadcasted when the calls of a batch are completed
+    struct rsa_json_rpc_proxy_call *pendingCalls; //calls to be sent in the batch which is being collected, FIFO
+    struct rsa_json_rpc_proxy_call *lastPendingCall;
+    long nrOfPendingCalls;
+    bool collectingBatch; //whether a caller is collecting calls for a batch
+    celix_thread_mutex_t asyncMutex; //protects the modification of proxies, the async state of the proxies and below
+    unsigned int nrOfDetachedProxies; //ungotten proxies which are destroyed when their last async call is completed
+    bool unregistered; //whether the factory service is unregistered, the factory is freed with the last detached proxy
+    void *destroyedData;
+    void (*destroyedCallback)(void *data);
 };
 
-typedef struct rsa_json_rpc_proxy {
+/**
+ * A proxy call waiting to be sent in a batch. The call lives on the stack of the calling thread.
+ */
+typedef struct rsa_json_rpc_proxy_call {
+    celix_properties_t *metadata;
+    const struct iovec *request;
+    struct iovec *response;
+    celix_status_t status;
+    bool sent; //whether the call is sent, only accessed by the thread sending the batch
+    bool done;
+    struct rsa_json_rpc_proxy_call *next;
+} rsa_json_rpc_proxy_call_t;
+
+struct rsa_json_rpc_proxy {
     rsa_json_rpc_proxy_factory_t *proxyFactory;
     dyn_interface_type *intfType;
     void *service;
     unsigned int useCnt;
-}rsa_json_rpc_proxy_t;
+    unsigned int nrOfAsyncCalls; //protected by the asyncMutex of the proxy factory
+    bool detached; //the proxy service is ungotten while async calls are in flight, protected by the asyncMutex
+};
+
+/**
+ * An asynchronous proxy call, which lives until the request sender completes the call.
+ */
+typedef struct rsa_json_rpc_proxy_async_call {
+    rsa_json_rpc_proxy_t *proxy;
+    const struct method_entry *entry;
+    rsa_json_rpc_proxy_t *handle; //the value of the handle argument
+    void **args; //the arguments of the method, including the handle
+    char *invokeRequest;
+    celix_properties_t *metadata;
+    rsa_rpc_async_call_completion_fp callback;
+    void *callbackData;
+} rsa_json_rpc_proxy_async_call_t;
 
 struct rsa_request_sender_callback_data {
     endpoint_description_t *endpointDesc;
     celix_properties_t *metadata;
     const struct iovec *request;
     struct iovec *response;
+    rsa_request_sender_completion_fp callback; //only used for async requests
+    void *callbackData;
+    bool sentAsync; //whether the request is sent using sendRequestAsync, if not the response is set
+    celix_status_t status; //the status of the synchronous fallback of an async request
 };
 
 static void* rsaJsonRpcProxy_getService(void *handle, const celix_bundle_t *requestingBundle,
@@ -72,6 +123,7 @@ static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxy
         const celix_bundle_t *requestingBundle, rsa_json_rpc_proxy_t **proxyOut);
 static void rsaJsonRpcProxy_destroy(rsa_json_rpc_proxy_t *proxy);
 static void rsaJsonRpcProxy_unregisterFacSvcDone(void *data);
+static void rsaJsonRpcProxy_factoryFree(rsa_json_rpc_proxy_factory_t *proxyFactory);
 
 celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx,
                                              celix_log_helper_t* logHelper,
@@ -102,6 +154,15 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx,
     proxyFactory->reqSenderSvcId = requestSenderSvcId;
     proxyFactory->serialProtoId = serialProtoId;
 
+    proxyFactory->batchWindowInUs = celix_bundleContext_getPropertyAsLong(ctx, RSA_JSON_RPC_BATCH_WINDOW_US_KEY,
+                                                                          RSA_JSON_RPC_BATCH_WINDOW_US_DEFAULT);
+    proxyFactory->maxBatchSize = celix_bundleContext_getPropertyAsLong(ctx, RSA_JSON_RPC_BATCH_MAX_SIZE_KEY,
+                                                                       RSA_JSON_RPC_BATCH_MAX_SIZE_DEFAULT);
+    bool batchSupported = celix_properties_getAsBool(endpointDesc->properties, RSA_JSON_RPC_BATCH_SUPPORTED_KEY, false);
+    if (!batchSupported || proxyFactory->batchWindowInUs < 0 || proxyFactory->maxBatchSize <= 1) {
+        proxyFactory->batchWindowInUs = 0;
+    }
+
     CELIX_BUILD_ASSERT(sizeof(long) == sizeof(void*)); // The hash_map uses the pointer as key, so this should be true
     celix_autoptr(celix_long_hash_map_t) proxies = proxyFactory->proxies = celix_longHashMap_create();
     if (proxyFactory->proxies == NULL) {
@@ -109,6 +170,31 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx,
         return CELIX_ENOMEM;
     }
 
+    celix_status_t status = celixThreadMutex_create(&proxyFactory->batchMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating batch mutex. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) batchMutex = &proxyFactory->batchMutex;
+    status = celixThreadCondition_init(&proxyFactory->batchCond, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating batch condition. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_cond_t) batchCond = &proxyFactory->batchCond;
+    status = celixThreadCondition_init(&proxyFactory->batchDoneCond, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating batch done condition. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_cond_t) batchDoneCond = &proxyFactory->batchDoneCond;
+    status = celixThreadMutex_create(&proxyFactory->asyncMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(logHelper, "Proxy: Error creating async mutex. %d.", status);
+        return status;
+    }
+    celix_autoptr(celix_thread_mutex_t) asyncMutex = &proxyFactory->asyncMutex;
+
     celix_autoptr(endpoint_description_t) endpointDescCopy = proxyFactory->endpointDesc =
         endpointDescription_clone(endpointDesc);
     if (proxyFactory->endpointDesc == NULL) {
@@ -120,8 +206,7 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx,
     proxyFactory->factory.getService = rsaJsonRpcProxy_getService;
     proxyFactory->factory.ungetService = rsaJsonRpcProxy_ungetService;
     celix_properties_t* svcProperties = NULL;
-    celix_status_t status =
-        celix_rsaUtils_createServicePropertiesFromEndpointProperties(endpointDesc->properties, &svcProperties);
+    status = celix_rsaUtils_createServicePropertiesFromEndpointProperties(endpointDesc->properties, &svcProperties);
     if (status != CELIX_SUCCESS) {
         return status;
     }
@@ -134,13 +219,20 @@ celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx,
     }
 
     celix_steal_ptr(endpointDescCopy);
+    celix_steal_ptr(asyncMutex);
+    celix_steal_ptr(batchDoneCond);
+    celix_steal_ptr(batchCond);
+    celix_steal_ptr(batchMutex);
     celix_steal_ptr(proxies);
     *proxyFactoryOut = celix_steal_ptr(proxyFactory);
     return CELIX_SUCCESS;
 }
 
-void rsaJsonRpcProxy_factoryDestroy(rsa_json_rpc_proxy_factory_t *proxyFactory) {
+void rsaJsonRpcProxy_factoryDestroy(rsa_json_rpc_proxy_factory_t *proxyFactory, void *destroyedData,
+        void (*destroyedCallback)(void *data)) {
     assert(proxyFactory != NULL);
+    proxyFactory->destroyedData = destroyedData;
+    proxyFactory->destroyedCallback = destroyedCallback;
     celix_bundleContext_unregisterServiceAsync(proxyFactory->ctx, proxyFactory->factorySvcId,
             proxyFactory, rsaJsonRpcProxy_unregisterFacSvcDone);
 }
@@ -152,10 +244,31 @@ long rsaJsonRpcProxy_factorySvcId(rsa_json_rpc_proxy_factory_t *proxyFactory) {
 static void rsaJsonRpcProxy_unregisterFacSvcDone(void *data) {
     assert(data);
     rsa_json_rpc_proxy_factory_t *proxyFactory = (rsa_json_rpc_proxy_factory_t *)data;
+    celixThreadMutex_lock(&proxyFactory->asyncMutex);
+    proxyFactory->unregistered = true;
+    bool freeFactory = proxyFactory->nrOfDetachedProxies == 0;
+    celixThreadMutex_unlock(&proxyFactory->asyncMutex);
+    if (freeFactory) {
+        rsaJsonRpcProxy_factoryFree(proxyFactory);
+    }
+    return;
+}
+
+static void rsaJsonRpcProxy_factoryFree(rsa_json_rpc_proxy_factory_t *proxyFactory) {
+    void *destroyedData = proxyFactory->destroyedData;
+    void (*destroyedCallback)(void *data) = proxyFactory->destroyedCallback;
     endpointDescription_destroy(proxyFactory->endpointDesc);
+    assert(proxyFactory->nrOfPendingCalls == 0);
+    (void)celixThreadMutex_destroy(&proxyFactory->asyncMutex);
+    (void)celixThreadCondition_destroy(&proxyFactory->batchDoneCond);
+    (void)celixThreadCondition_destroy(&proxyFactory->batchCond);
+    (void)celixThreadMutex_destroy(&proxyFactory->batchMutex);
     assert(celix_longHashMap_size(proxyFactory->proxies) == 0);
     celix_longHashMap_destroy(proxyFactory->proxies);
     free(proxyFactory);
+    if (destroyedCallback != NULL) {
+        destroyedCallback(destroyedData);
+    }
     return;
 }
 
@@ -175,7 +288,9 @@ static void* rsaJsonRpcProxy_getService(void *handle, const celix_bundle_t *requ
                     proxyFactory->endpointDesc->serviceName, status);
             return NULL;
         }
+        celixThreadMutex_lock(&proxyFactory->asyncMutex);
         celix_longHashMap_put(proxyFactory->proxies, (long)requestingBundle, proxy);
+        celixThreadMutex_unlock(&proxyFactory->asyncMutex);
     }
     proxy->useCnt += 1;
 
@@ -192,8 +307,18 @@ static void rsaJsonRpcProxy_ungetService(void *handle, const celix_bundle_t *req
     if (proxy != NULL) {
         proxy->useCnt -= 1;
         if (proxy->useCnt == 0) {
+            celixThreadMutex_lock(&proxyFactory->asyncMutex);
             (void)celix_longHashMap_remove(proxyFactory->proxies, (long)requestingBundle);
-            rsaJsonRpcProxy_destroy(proxy);
+            //the async calls use the interface type of the proxy, so the last async call destroys a detached proxy
+            if (proxy->nrOfAsyncCalls > 0) {
+                proxy->detached = true;
+                proxyFactory->nrOfDetachedProxies += 1;
+                proxy = NULL;
+            }
+            celixThreadMutex_unlock(&proxyFactory->asyncMutex);
+            if (proxy != NULL) {
+                rsaJsonRpcProxy_destroy(proxy);
+            }
         }
     }
     return;
@@ -207,6 +332,221 @@ static celix_status_t rsaJsonRpcProxy_useReqSenderSvcCallback(void *handle, rsa_
             data->request, data->response);
 }
 
+static celix_status_t rsaJsonRpcProxy_sendRequest(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        celix_properties_t *metadata, const struct iovec *request, struct iovec *response) {
+    struct rsa_request_sender_callback_data data= {
+            .endpointDesc = proxyFactory->endpointDesc,
+            .metadata = metadata,
+            .request = request,
+            .response = response
+    };
+    return rsaRequestSenderTracker_useService(proxyFactory->reqSenderTracker, proxyFactory->reqSenderSvcId,
+            &data, rsaJsonRpcProxy_useReqSenderSvcCallback);
+}
+
+static celix_status_t rsaJsonRpcProxy_handleBatchReply(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_call_t **calls, long nrOfCalls, const struct iovec *batchReply) {
+    json_error_t error;
+    json_auto_t *jsReply = batchReply->iov_base != NULL ? json_loads(batchReply->iov_base, 0, &error) : NULL;
+    json_t *replies = rsaJsonRpcBatch_getMessages(jsReply);
+    if (replies == NULL || json_array_size(replies) != (size_t)nrOfCalls) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Invalid batch reply for %s.",
+                              proxyFactory->endpointDesc->serviceName);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    for (long i = 0; i < nrOfCalls; ++i) {
+        rsa_json_rpc_proxy_call_t *call = calls[i];
+        json_t *reply = json_array_get(replies, i);
+        json_t *replyStatus = json_object_get(reply, RSA_JSON_RPC_BATCH_STATUS_KEY);
+        if (replyStatus != NULL) {
+            call->status = (celix_status_t)json_integer_value(replyStatus);
+            continue;
+        }
+        char *replyStr = json_dumps(reply, JSON_COMPACT);
+        if (replyStr == NULL) {
+            call->status = CELIX_ENOMEM;
+            continue;
+        }
+        call->response->iov_base = replyStr;
+        call->response->iov_len = strlen(replyStr) + 1;
+        call->status = CELIX_SUCCESS;
+    }
+    return CELIX_SUCCESS;
+}
+
+/**
+ * Sends calls with equal metadata in a single batch request, using the (shared) metadata for the batch request.
+ */
+static void rsaJsonRpcProxy_sendBatchOfEqualCalls(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_call_t **calls, long nrOfCalls) {
+    if (nrOfCalls == 1) {
+        //no need for the batch envelope
+        calls[0]->status = rsaJsonRpcProxy_sendRequest(proxyFactory, calls[0]->metadata, calls[0]->request,
+                                                       calls[0]->response);
+        return;
+    }
+
+    celix_status_t status = CELIX_SUCCESS;
+    celix_autofree struct iovec *requests = malloc(nrOfCalls * sizeof(*requests));
+    if (requests == NULL) {
+        status = CELIX_ENOMEM;
+    } else {
+        for (long i = 0; i < nrOfCalls; ++i) {
+            requests[i] = *calls[i]->request;
+        }
+    }
+    struct iovec batchRequest = {NULL, 0};
+    if (status == CELIX_SUCCESS) {
+        status = rsaJsonRpcBatch_compose(requests, nrOfCalls, &batchRequest);
+    }
+    struct iovec batchReply = {NULL, 0};
+    if (status == CELIX_SUCCESS) {
+        status = rsaJsonRpcProxy_sendRequest(proxyFactory, calls[0]->metadata, &batchRequest, &batchReply);
+    }
+    if (status == CELIX_SUCCESS) {
+        status = rsaJsonRpcProxy_handleBatchReply(proxyFactory, calls, nrOfCalls, &batchReply);
+    }
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error sending batch of %ld calls for %s. %d.",
+                              nrOfCalls, proxyFactory->endpointDesc->serviceName, status);
+        for (long i = 0; i < nrOfCalls; ++i) {
+            calls[i]->status = status;
+        }
+    }
+    free(batchReply.iov_base);
+    free(batchRequest.iov_base);
+}
+
+/**
+ * Sends the collected calls. The request sender and the endpoint only get one metadata per request, so only calls
+ * with equal metadata (e.g. not changed by a remote interceptor) are merged into the same batch request.
+ */
+static void rsaJsonRpcProxy_sendBatch(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        rsa_json_rpc_proxy_call_t *calls, long nrOfCalls) {
+    celix_autofree rsa_json_rpc_proxy_call_t **equalCalls = malloc(nrOfCalls * sizeof(*equalCalls));
+    if (equalCalls == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Error sending batch of %ld calls for %s. %d.",
+                              nrOfCalls, proxyFactory->endpointDesc->serviceName, CELIX_ENOMEM);
+        for (rsa_json_rpc_proxy_call_t *call = calls; call != NULL; call = call->next) {
+            call->status = CELIX_ENOMEM;
+        }
+        return;
+    }
+    for (rsa_json_rpc_proxy_call_t *first = calls; first != NULL; first = first->next) {
+        if (first->sent) {
+            continue;
+        }
+        long nrOfEqualCalls = 0;
+        for (rsa_json_rpc_proxy_call_t *call = first; call != NULL; call = call->next) {
+            if (!call->sent && celix_properties_equals(call->metadata, first->metadata)) {
+                call->sent = true;
+                equalCalls[nrOfEqualCalls++] = call;
+            }
+        }
+        rsaJsonRpcProxy_sendBatchOfEqualCalls(proxyFactory, equalCalls, nrOfEqualCalls);
+    }
+}
+
+/**
+ * Sends the request as part of a batch. The first caller of a batch collects the calls issued within the batch
+ * window (or until the batch is full), sends the batch and completes the calls of the other callers.
+ */
+static celix_status_t rsaJsonRpcProxy_sendBatchedRequest(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        celix_properties_t *metadata, const struct iovec *request, struct iovec *response) {
+    rsa_json_rpc_proxy_call_t call = {
+            .metadata = metadata,
+            .request = request,
+            .response = response,
+            .status = CELIX_SUCCESS,
+            .sent = false,
+            .done = false,
+            .next = NULL
+    };
+
+    celixThreadMutex_lock(&proxyFactory->batchMutex);
+    if (proxyFactory->lastPendingCall == NULL) {
+        proxyFactory->pendingCalls = &call;
+    } else {
+        proxyFactory->lastPendingCall->next = &call;
+    }
+    proxyFactory->lastPendingCall = &call;
+    proxyFactory->nrOfPendingCalls += 1;
+
+    if (proxyFactory->collectingBatch) {
+        if (proxyFactory->nrOfPendingCalls >= proxyFactory->maxBatchSize) {
+            celixThreadCondition_signal(&proxyFactory->batchCond);
+        }
+        while (!call.done) {
+            celixThreadCondition_wait(&proxyFactory->batchDoneCond, &proxyFactory->batchMutex);
+        }
+        celixThreadMutex_unlock(&proxyFactory->batchMutex);
+        return call.status;
+    }
+
+    proxyFactory->collectingBatch = true;
+    struct timespec deadline = celixThreadCondition_getDelayedTime((double)proxyFactory->batchWindowInUs / 1000000.0);
+    while (proxyFactory->nrOfPendingCalls < proxyFactory->maxBatchSize) {
+        if (celixThreadCondition_waitUntil(&proxyFactory->batchCond, &proxyFactory->batchMutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    rsa_json_rpc_proxy_call_t *calls = proxyFactory->pendingCalls;
+    long nrOfCalls = proxyFactory->nrOfPendingCalls;
+    proxyFactory->pendingCalls = NULL;
+    proxyFactory->lastPendingCall = NULL;
+    proxyFactory->nrOfPendingCalls = 0;
+    proxyFactory->collectingBatch = false;
+    celixThreadMutex_unlock(&proxyFactory->batchMutex);
+
+    rsaJsonRpcProxy_sendBatch(proxyFactory, calls, nrOfCalls);
+
+    celixThreadMutex_lock(&proxyFactory->batchMutex);
+    rsa_json_rpc_proxy_call_t *next = NULL;
+    for (rsa_json_rpc_proxy_call_t *c = calls; c != NULL; c = next) {
+        next = c->next; //note c is invalid after done is set, because the caller can return
+        c->done = true;
+    }
+    celixThreadCondition_broadcast(&proxyFactory->batchDoneCond);
+    celixThreadMutex_unlock(&proxyFactory->batchMutex);
+    return call.status;
+}
+
+/**
+ * Deserializes the output argument and the return status of the remote service method from the reply.
+ */
+static celix_status_t rsaJsonRpcProxy_handleReply(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        const struct method_entry *entry, void *args[], const struct iovec *reply) {
+    celix_status_t status = CELIX_SUCCESS;
+    if (!dynFunction_hasReturn(entry->dynFunc)) {
+        return CELIX_SUCCESS;
+    }
+    if (reply->iov_base == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper,"Expect service proxy has return, but reply is empty.");
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    int rsErrno = CELIX_SUCCESS;
+    int retVal = jsonRpc_handleReply(entry->dynFunc, (const char *)reply->iov_base , args, &rsErrno);
+    if(retVal != 0) {
+        status = CELIX_SERVICE_EXCEPTION;
+        celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(proxyFactory->logHelper, "Error handling reply for %s",
+                              dynFunction_getName(entry->dynFunc));
+    } else if (rsErrno != CELIX_SUCCESS) {
+        //return the invocation error of remote service function
+        status = rsErrno;
+    }
+    return status;
+}
+
+static void rsaJsonRpcProxy_logCall(rsa_json_rpc_proxy_factory_t *proxyFactory, const char *invokeRequest,
+        const struct iovec *reply, celix_status_t status) {
+    if (proxyFactory->callsLogFile != NULL) {
+        fprintf(proxyFactory->callsLogFile, "PROXY REMOTE CALL:\n\tservice=%s\n\tservice_id=%lu\n\trequest_payload=%s\n\trequest_response=%s\n\tstatus=%i\n",
+                proxyFactory->endpointDesc->serviceName, proxyFactory->endpointDesc->serviceId, invokeRequest, (char *)reply->iov_base, status);
+        fflush(proxyFactory->callsLogFile);
+    }
+}
+
 static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *returnVal) {
     celix_status_t  status = CELIX_SUCCESS;
     if (returnVal == NULL) {
@@ -246,33 +586,14 @@ static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *retu
             proxyFactory->endpointDesc->properties, dynFunction_getName(entry->dynFunc), &metadata);
     if (cont) {
         struct iovec requestIovec = {invokeRequest,strlen(invokeRequest) + 1};
-        struct rsa_request_sender_callback_data data= {
-                .endpointDesc = proxyFactory->endpointDesc,
-                .metadata = metadata,
-                .request = &requestIovec,
-                .response = &replyIovec
-        };
-        status = rsaRequestSenderTracker_useService(proxyFactory->reqSenderTracker, proxyFactory->reqSenderSvcId,
-                &data, rsaJsonRpcProxy_useReqSenderSvcCallback);
-        if (status == CELIX_SUCCESS && dynFunction_hasReturn(entry->dynFunc)) {
-            if (replyIovec.iov_base != NULL) {
-                int rsErrno = CELIX_SUCCESS;
-                int retVal = jsonRpc_handleReply(entry->dynFunc,
-                        (const char *)replyIovec.iov_base , args, &rsErrno);
-                if(retVal != 0) {
-                    status = CELIX_SERVICE_EXCEPTION;
-                    celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
-                    celix_logHelper_error(proxyFactory->logHelper, "Error handling reply for %s",
-                                          dynFunction_getName(entry->dynFunc));
-                } else if (rsErrno != CELIX_SUCCESS) {
-                    //return the invocation error of remote service function
-                    status = rsErrno;
-                }
-            } else {
-                celix_logHelper_error(proxyFactory->logHelper,"Expect service proxy has return, but reply is empty.");
-                status = CELIX_ILLEGAL_ARGUMENT;
-            }
-        } else if (status != CELIX_SUCCESS) {
+        if (proxyFactory->batchWindowInUs > 0) {
+            status = rsaJsonRpcProxy_sendBatchedRequest(proxyFactory, metadata, &requestIovec, &replyIovec);
+        } else {
+            status = rsaJsonRpcProxy_sendRequest(proxyFactory, metadata, &requestIovec, &replyIovec);
+        }
+        if (status == CELIX_SUCCESS) {
+            status = rsaJsonRpcProxy_handleReply(proxyFactory, entry, args, &replyIovec);
+        } else {
             celix_logHelper_error(proxyFactory->logHelper,"Service proxy send request failed. %d", status);
         }
         remoteInterceptorHandler_invokePostProxyCall(proxyFactory->interceptorsHandler,
@@ -287,12 +608,7 @@ static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *retu
         celix_properties_destroy(metadata);
     }
 
-    if (proxyFactory->callsLogFile != NULL) {
-        fprintf(proxyFactory->callsLogFile, "PROXY REMOTE CALL:\n\tservice=%s\n\tservice_id=%lu\n\trequest_payload=%s\n\trequest_response=%s\n\tstatus=%i\n",
-                proxyFactory->endpointDesc->serviceName, proxyFactory->endpointDesc->serviceId, invokeRequest, (char *)replyIovec.iov_base, status);
-        fflush(proxyFactory->callsLogFile);
-    }
-
+    rsaJsonRpcProxy_logCall(proxyFactory, invokeRequest, &replyIovec, status);
 
     free(invokeRequest); //Allocated by json_dumps in jsonRpc_prepareInvokeRequest
     if (replyIovec.iov_base) {
@@ -304,6 +620,195 @@ static void rsaJsonRpcProxy_serviceFunc(void *userData, void *args[], void *retu
     return;
 }
 
+static celix_status_t rsaJsonRpcProxy_useReqSenderSvcAsyncCallback(void *handle, rsa_request_sender_service_t *svc) {
+    assert(handle != NULL);
+    assert(svc != NULL);
+    struct rsa_request_sender_callback_data *data = (struct rsa_request_sender_callback_data *)handle;
+    if (svc->sendRequestAsync != NULL) {
+        data->sentAsync = true;
+        return svc->sendRequestAsync(svc->handle, data->endpointDesc, data->metadata, data->request,
+                data->callback, data->callbackData);
+    }
+    //the request sender has no async support, the call is completed by the caller outside the use callback
+    data->status = svc->sendRequest(svc->handle, data->endpointDesc, data->metadata, data->request, data->response);
+    return CELIX_SUCCESS;
+}
+
+/**
+ * Sends the request using sendRequestAsync of the request sender, or sendRequest if the request sender has no
+ * async support. If CELIX_SUCCESS is returned, the callback is called exactly once.
+ */
+static celix_status_t rsaJsonRpcProxy_sendRequestAsync(rsa_json_rpc_proxy_factory_t *proxyFactory,
+        celix_properties_t *metadata, const struct iovec *request, rsa_request_sender_completion_fp callback,
+        void *callbackData) {
+    struct iovec response = {NULL, 0};
+    struct rsa_request_sender_callback_data data= {
+            .endpointDesc = proxyFactory->endpointDesc,
+            .metadata = metadata,
+            .request = request,
+            .response = &response,
+            .callback = callback,
+            .callbackData = callbackData,
+            .sentAsync = false,
+            .status = CELIX_SUCCESS
+    };
+    celix_status_t status = rsaRequestSenderTracker_useService(proxyFactory->reqSenderTracker,
+            proxyFactory->reqSenderSvcId, &data, rsaJsonRpcProxy_useReqSenderSvcAsyncCallback);
+    if (status == CELIX_SUCCESS && !data.sentAsync) {
+        callback(callbackData, data.status, &response);
+    }
+    return status;
+}
+
+rsa_json_rpc_proxy_t *rsaJsonRpcProxy_acquire(rsa_json_rpc_proxy_factory_t *proxyFactory, const void *svc) {
+    rsa_json_rpc_proxy_t *proxy = NULL;
+    celix_auto(celix_mutex_lock_guard_t) lock = celixMutexLockGuard_init(&proxyFactory->asyncMutex);
+    CELIX_LONG_HASH_MAP_ITERATE(proxyFactory->proxies, iter) {
+        rsa_json_rpc_proxy_t *candidate = iter.value.ptrValue;
+        if (candidate->service == svc) {
+            proxy = candidate;
+            proxy->nrOfAsyncCalls += 1;
+            break;
+        }
+    }
+    return proxy;
+}
+
+static void rsaJsonRpcProxy_release(rsa_json_rpc_proxy_t *proxy) {
+    rsa_json_rpc_proxy_factory_t *proxyFactory = proxy->proxyFactory;
+    bool destroyProxy = false;
+    bool freeFactory = false;
+    celixThreadMutex_lock(&proxyFactory->asyncMutex);
+    assert(proxy->nrOfAsyncCalls > 0);
+    proxy->nrOfAsyncCalls -= 1;
+    if (proxy->nrOfAsyncCalls == 0 && proxy->detached) {
+        destroyProxy = true;
+        proxyFactory->nrOfDetachedProxies -= 1;
+        freeFactory = proxyFactory->unregistered && proxyFactory->nrOfDetachedProxies == 0;
+    }
+    celixThreadMutex_unlock(&proxyFactory->asyncMutex);
+    if (destroyProxy) {
+        rsaJsonRpcProxy_destroy(proxy);
+    }
+    if (freeFactory) {
+        rsaJsonRpcProxy_factoryFree(proxyFactory);
+    }
+}
+
+static void rsaJsonRpcProxy_destroyAsyncCall(rsa_json_rpc_proxy_async_call_t *call) {
+    if (call->metadata != NULL) {
+        celix_properties_destroy(call->metadata);
+    }
+    free(call->invokeRequest);
+    free(call->args);
+    rsaJsonRpcProxy_release(call->proxy);
+    free(call);
+}
+
+static void rsaJsonRpcProxy_asyncCallCompleted(void *data, celix_status_t status, struct iovec *response) {
+    rsa_json_rpc_proxy_async_call_t *call = data;
+    rsa_json_rpc_proxy_factory_t *proxyFactory = call->proxy->proxyFactory;
+    const char *methodName = dynFunction_getName(call->entry->dynFunc);
+    if (status == CELIX_SUCCESS) {
+        status = rsaJsonRpcProxy_handleReply(proxyFactory, call->entry, call->args, response);
+    } else {
+        celix_logHelper_error(proxyFactory->logHelper,"Service proxy send async request failed. %d", status);
+    }
+    remoteInterceptorHandler_invokePostProxyCall(proxyFactory->interceptorsHandler,
+            proxyFactory->endpointDesc->properties, methodName, call->metadata);
+    rsaJsonRpcProxy_logCall(proxyFactory, call->invokeRequest, response, status);
+    if (response->iov_base != NULL) {
+        free(response->iov_base);
+    }
+
+    rsa_rpc_async_call_completion_fp callback = call->callback;
+    void *callbackData = call->callbackData;
+    //release the proxy before calling back, so that the callback can unget the proxy service
+    rsaJsonRpcProxy_destroyAsyncCall(call);
+    callback(callbackData, status);
+}
+
+static const struct method_entry *rsaJsonRpcProxy_findMethod(rsa_json_rpc_proxy_t *proxy, const char *methodName) {
+    const struct method_entry *entry = NULL;
+    TAILQ_FOREACH(entry, dynInterface_methods(proxy->intfType), entries) {
+        if (strcmp(dynFunction_getName(entry->dynFunc), methodName) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+celix_status_t rsaJsonRpcProxy_callAsync(rsa_json_rpc_proxy_t *proxy, const char *methodName, void *args[],
+        rsa_rpc_async_call_completion_fp callback, void *callbackData) {
+    assert(proxy != NULL);
+    rsa_json_rpc_proxy_factory_t *proxyFactory = proxy->proxyFactory;
+    celix_autofree rsa_json_rpc_proxy_async_call_t *call = calloc(1, sizeof(*call));
+    if (call == NULL) {
+        rsaJsonRpcProxy_release(proxy);
+        return CELIX_ENOMEM;
+    }
+    call->proxy = proxy;
+    call->handle = proxy;
+    call->callback = callback;
+    call->callbackData = callbackData;
+    call->entry = rsaJsonRpcProxy_findMethod(proxy, methodName);
+    if (call->entry == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper, "Proxy: Method %s not found for %s.", methodName,
+                              proxyFactory->endpointDesc->serviceName);
+        rsaJsonRpcProxy_release(proxy);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    int nrOfArgs = dynFunction_nrOfArguments(call->entry->dynFunc);
+    call->args = calloc(nrOfArgs, sizeof(*call->args));
+    if (call->args == NULL) {
+        rsaJsonRpcProxy_destroyAsyncCall(celix_steal_ptr(call));
+        return CELIX_ENOMEM;
+    }
+    call->args[0] = &call->handle;
+    for (int i = 1; i < nrOfArgs; ++i) {
+        call->args[i] = args[i - 1];
+    }
+
+    int rc = jsonRpc_prepareInvokeRequest(call->entry->dynFunc, call->entry->id, call->args, &call->invokeRequest);
+    if (rc != 0) {
+        celix_logHelper_logTssErrors(proxyFactory->logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(proxyFactory->logHelper, "Error preparing invoke request for %s", methodName);
+        rsaJsonRpcProxy_destroyAsyncCall(celix_steal_ptr(call));
+        return CELIX_SERVICE_EXCEPTION;
+    }
+    call->metadata = celix_properties_create();
+    if (call->metadata == NULL) {
+        celix_logHelper_error(proxyFactory->logHelper,"Error creating metadata for %s", methodName);
+        rsaJsonRpcProxy_destroyAsyncCall(celix_steal_ptr(call));
+        return CELIX_ENOMEM;
+    }
+    celix_properties_setLong(call->metadata, "SerialProtocolId", proxyFactory->serialProtoId);
+    bool cont = remoteInterceptorHandler_invokePreProxyCall(proxyFactory->interceptorsHandler,
+            proxyFactory->endpointDesc->properties, methodName, &call->metadata);
+    if (!cont) {
+        celix_logHelper_error(proxyFactory->logHelper, "%s has been intercepted.", proxyFactory->endpointDesc->serviceName);
+        rsaJsonRpcProxy_destroyAsyncCall(celix_steal_ptr(call));
+        return CELIX_INTERCEPTOR_EXCEPTION;
+    }
+
+    //async calls are not batched, the request sender already overlaps the in-flight calls
+    struct iovec requestIovec = {call->invokeRequest, strlen(call->invokeRequest) + 1};
+    celix_status_t status = rsaJsonRpcProxy_sendRequestAsync(proxyFactory, call->metadata, &requestIovec,
+            rsaJsonRpcProxy_asyncCallCompleted, call);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(proxyFactory->logHelper,"Service proxy send async request failed. %d", status);
+        remoteInterceptorHandler_invokePostProxyCall(proxyFactory->interceptorsHandler,
+                proxyFactory->endpointDesc->properties, methodName, call->metadata);
+        struct iovec noReply = {NULL, 0};
+        rsaJsonRpcProxy_logCall(proxyFactory, call->invokeRequest, &noReply, status);
+        rsaJsonRpcProxy_destroyAsyncCall(celix_steal_ptr(call));
+        return status;
+    }
+    //the call is owned by the completion callback, which may already have been called
+    celix_steal_ptr(call);
+    return CELIX_SUCCESS;
+}
+
 static celix_status_t rsaJsonRpcProxy_create(rsa_json_rpc_proxy_factory_t *proxyFactory,
         const celix_bundle_t *requestingBundle, rsa_json_rpc_proxy_t **proxyOut) {
     celix_status_t status = CELIX_SUCCESS;
@@ -25,6 +25,7 @@ extern "C" {
 #endif
 #include "remote_interceptors_handler.h"
 #include "rsa_request_sender_tracker.h"
+#include "rsa_rpc_async_call_service.h"
 #include "endpoint_description.h"
 #include "celix_log_helper.h"
 #include "celix_types.h"
@@ -32,16 +33,38 @@ extern "C" {
 #include <stdio.h>
 
 typedef struct rsa_json_rpc_proxy_factory rsa_json_rpc_proxy_factory_t;
+typedef struct rsa_json_rpc_proxy rsa_json_rpc_proxy_t;
 
 celix_status_t rsaJsonRpcProxy_factoryCreate(celix_bundle_context_t* ctx, celix_log_helper_t *logHelper,
         FILE *logFile, remote_interceptors_handler_t *interceptorsHandler,
         const endpoint_description_t *endpointDesc, rsa_request_sender_tracker_t *reqSenderTracker,
         long requestSenderSvcId, unsigned int serialProtoId, rsa_json_rpc_proxy_factory_t **proxyFactoryOut);
 
-void rsaJsonRpcProxy_factoryDestroy(rsa_json_rpc_proxy_factory_t *proxyFactory);
+/**
+ * @brief Unregisters the proxy factory service and destroys the proxy factory.
+ *
+ * Proxies which are ungotten while async calls are in flight are detached instead of waited for, so the proxy
+ * factory can outlive this call. The destroyedCallback is called when the proxy factory is actually freed.
+ */
+void rsaJsonRpcProxy_factoryDestroy(rsa_json_rpc_proxy_factory_t *proxyFactory, void *destroyedData,
+        void (*destroyedCallback)(void *data));
 
 long rsaJsonRpcProxy_factorySvcId(rsa_json_rpc_proxy_factory_t *proxyFactory);
 
+/**
+ * @brief Finds the proxy with the given service instance and marks it as used by an async call.
+ * The proxy will not be destroyed until the async call is completed (or failed to start).
+ * @return The proxy or NULL if the service instance is not a proxy of the factory.
+ */
+rsa_json_rpc_proxy_t *rsaJsonRpcProxy_acquire(rsa_json_rpc_proxy_factory_t *proxyFactory, const void *svc);
+
+/**
+ * @brief Calls a method of an acquired proxy asynchronously, see rsa_rpc_async_call_service_t.
+ * The proxy is released when the call is completed or when the call failed to start.
+ */
+celix_status_t rsaJsonRpcProxy_callAsync(rsa_json_rpc_proxy_t *proxy, const char *methodName, void *args[],
+        rsa_rpc_async_call_completion_fp callback, void *callbackData);
+
 #ifdef __cplusplus
 }
 #endif
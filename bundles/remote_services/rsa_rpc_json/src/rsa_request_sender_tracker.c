@@ -24,6 +24,7 @@
 #include "celix_long_hash_map.h"
 #include "celix_threads.h"
 #include "celix_constants.h"
+#include "celix_version.h"
 #include <stdlib.h>
 #include <assert.h>
 
@@ -32,7 +33,7 @@ struct rsa_request_sender_tracker {
     celix_log_helper_t *logHelper;
     long reqSenderTrkId;
     celix_thread_rwlock_t lock;//projects below
-    celix_long_hash_map_t *requestSenderSvcs;//Key:service id, Value:service
+    celix_long_hash_map_t *requestSenderSvcs;//Key:service id, Value:copy of the service, see rsaRequestSenderTracker_copyService
 };
 
 static void rsaRequestSenderTracker_addServiceWithProperties(void *handle, void *svc,
@@ -57,7 +58,9 @@ celix_status_t rsaRequestSenderTracker_create(celix_bundle_context_t* ctx, celix
         return status;
     }
     celix_autoptr(celix_thread_rwlock_t) lock = &tracker->lock;
-    celix_autoptr(celix_long_hash_map_t) requestSenderSvcs = tracker->requestSenderSvcs = celix_longHashMap_create();
+    celix_long_hash_map_create_options_t mapOpts = CELIX_EMPTY_LONG_HASH_MAP_CREATE_OPTIONS;
+    mapOpts.simpleRemovedCallback = free;
+    celix_autoptr(celix_long_hash_map_t) requestSenderSvcs = tracker->requestSenderSvcs = celix_longHashMap_createWithOptions(&mapOpts);
     assert(tracker->requestSenderSvcs != NULL);
     celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
     opts.filter.serviceName = CELIX_RSA_REQUEST_SENDER_SERVICE_NAME;
@@ -76,6 +79,28 @@ celix_status_t rsaRequestSenderTracker_create(celix_bundle_context_t* ctx, celix
     return CELIX_SUCCESS;
 }
 
+/**
+ * Copies the request sender service, so that the optional functions which are not provided by older versions of the
+ * service are set to NULL.
+ */
+static rsa_request_sender_service_t* rsaRequestSenderTracker_copyService(const rsa_request_sender_service_t *svc,
+        const celix_properties_t *props) {
+    celix_autoptr(celix_version_t) version = NULL;
+    if (celix_properties_getAsVersion(props, CELIX_FRAMEWORK_SERVICE_VERSION, NULL, &version) != CELIX_SUCCESS) {
+        return NULL;
+    }
+    rsa_request_sender_service_t *copy = calloc(1, sizeof(*copy));
+    if (copy == NULL) {
+        return NULL;
+    }
+    copy->handle = svc->handle;
+    copy->sendRequest = svc->sendRequest;
+    if (version != NULL && celix_version_compareToMajorMinor(version, 1, 1) >= 0) {
+        copy->sendRequestAsync = svc->sendRequestAsync;
+    }
+    return copy;
+}
+
 static void rsaRequestSenderTracker_addServiceWithProperties(void *handle, void *svc,
         const celix_properties_t *props) {
     assert(handle != NULL);
@@ -88,8 +113,15 @@ static void rsaRequestSenderTracker_addServiceWithProperties(void *handle, void
         celix_logHelper_error(tracker->logHelper, "Error getting rsa request sender service id for %s.", serviceName);
         return;
     }
+    rsa_request_sender_service_t *copy = rsaRequestSenderTracker_copyService(svc, props);
+    if (copy == NULL) {
+        celix_logHelper_error(tracker->logHelper, "Error copying rsa request sender service %ld.", svcId);
+        return;
+    }
     celixThreadRwlock_writeLock(&tracker->lock);
-    (void)celix_longHashMap_put(tracker->requestSenderSvcs, svcId, svc);
+    if (celix_longHashMap_put(tracker->requestSenderSvcs, svcId, copy) != CELIX_SUCCESS) {
+        free(copy);
+    }
     celixThreadRwlock_unlock(&tracker->lock);
     return;
 }
@@ -29,9 +29,18 @@ extern "C" {
 #include <sys/uio.h>
 
 #define CELIX_RSA_REQUEST_SENDER_SERVICE_NAME "rsa_request_sender_service"
-#define CELIX_RSA_REQUEST_SENDER_SERVICE_VERSION "1.0.0"
+#define CELIX_RSA_REQUEST_SENDER_SERVICE_VERSION "1.1.0"
 #define CELIX_RSA_REQUEST_SENDER_SERVICE_USE_RANGE "[1.0.0,2)"
 
+/**
+ * @brief The completion callback of an asynchronous request.
+ * @param[in] data The callback data given to sendRequestAsync
+ * @param[in] status The status of the request, @see celix_errno.h
+ * @param[in] response The response received from remote service endpoint, only valid if status is CELIX_SUCCESS.
+ * The callback is the owner of the response memory and should use free function to free it.
+ */
+typedef void (*rsa_request_sender_completion_fp)(void *data, celix_status_t status, struct iovec *response);
+
 /**
  * @brief The service send RPC request
  * @note It can be implemented by RSA bundles, and called by RPC bundles.
@@ -50,6 +59,21 @@ typedef struct rsa_request_sender_service {
      * @return @see celix_errno.h
      */
     celix_status_t (*sendRequest)(void *handle, const endpoint_description_t *endpointDesciption, celix_properties_t *metadata, const struct iovec *request, struct iovec *response);
+    /**
+     * @brief Send the request that from remote service proxy, without waiting for the response.
+     * @note It is optional and can be NULL, in which case the caller should fall back to sendRequest. Since version 1.1.0.
+     * @note If the function returns CELIX_SUCCESS, the callback will be called exactly once. It is called from a thread
+     * of the RSA bundle, or from the calling thread if the request completes immediately.
+     * If the function returns an error, the callback will not be called.
+     * @param[in] handle Service handle
+     * @param[in] endpointDesciption The endpoint desciption of remote service
+     * @param[in] metadata The metadata, can be NULL. It is only used during the call.
+     * @param[in] request The request for the remote service endpoint. It is only used during the call.
+     * @param[in] callback The completion callback
+     * @param[in] callbackData The data passed to the completion callback
+     * @return @see celix_errno.h
+     */
+    celix_status_t (*sendRequestAsync)(void *handle, const endpoint_description_t *endpointDesciption, celix_properties_t *metadata, const struct iovec *request, rsa_request_sender_completion_fp callback, void *callbackData);
 }rsa_request_sender_service_t;
 
 
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_RPC_ASYNC_CALL_SERVICE_H_
+#define _RSA_RPC_ASYNC_CALL_SERVICE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <celix_errno.h>
+
+#define CELIX_RSA_RPC_ASYNC_CALL_SERVICE_NAME "rsa_rpc_async_call_service"
+#define CELIX_RSA_RPC_ASYNC_CALL_SERVICE_VERSION "1.0.0"
+#define CELIX_RSA_RPC_ASYNC_CALL_SERVICE_USE_RANGE "[1.0.0,2.0.0)"
+
+/**
+ * @brief The completion callback of an asynchronous remote service call.
+ * @param[in] data The callback data given to callAsync
+ * @param[in] status The status of the remote call, which is the return value of the remote service method if the call succeeded. @see celix_errno.h
+ */
+typedef void (*rsa_rpc_async_call_completion_fp)(void *data, celix_status_t status);
+
+/**
+ * @brief The service used to call a method of an imported (proxy) service without blocking for the reply.
+ *
+ * Compared with calling the method of the imported service directly, the calling thread only serializes and sends
+ * the request. So a few threads can keep many remote calls in flight.
+ *
+ * @note It can be implemented by RPC bundles, the property CELIX_RSA_RPC_TYPE_KEY indicates the RPC type.
+ */
+typedef struct rsa_rpc_async_call_service {
+    void *handle;/// The Service handle
+    /**
+     * @brief Calls a method of an imported service asynchronously.
+     *
+     * The arguments use the same convention as the dynamic function calls of libdfi: every entry points to the value
+     * of the corresponding method argument, excluding the service handle. e.g. for `int add(void *handle, double a,
+     * double b, double *result)` the arguments are `{&a, &b, &result}`. The input arguments are only used during
+     * the call, the output argument (if any) must remain valid until the completion callback is called.
+     *
+     * @note If the function returns CELIX_SUCCESS, the callback will be called exactly once, either from a thread of
+     * the RSA bundle or from the calling thread. If the function returns an error, the callback will not be called.
+     * @note The imported service must be in use (i.e. retrieved from the service registry and not yet released) by
+     * the caller during the call.
+     *
+     * @param[in] handle Service handle
+     * @param[in] svcId The service id of the imported service
+     * @param[in] svc The imported service, as retrieved from the service registry
+     * @param[in] methodName The name of the method to call
+     * @param[in] args The method arguments, excluding the service handle
+     * @param[in] callback The completion callback
+     * @param[in] callbackData The data passed to the completion callback
+     * @return CELIX_SUCCESS if the call is sent, CELIX_ILLEGAL_ARGUMENT if the service or the method is unknown. @see celix_errno.h
+     */
+    celix_status_t (*callAsync)(void *handle, long svcId, void *svc, const char *methodName, void *args[],
+                                rsa_rpc_async_call_completion_fp callback, void *callbackData);
+} rsa_rpc_async_call_service_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_RPC_ASYNC_CALL_SERVICE_H_ */
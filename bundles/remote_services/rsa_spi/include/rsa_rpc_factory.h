@@ -33,6 +33,14 @@ extern "C" {
  */
 #define CELIX_RSA_RPC_TYPE_KEY "celix.remote.admin.rpc_type"
 
+/**
+ * @brief The prefix of the rpc factory service properties which advertise a capability of the RPC bundle.
+ *
+ * A remote service admin copies the properties with this prefix of the rpc factory it exports a service with
+ * into the endpoint description, so that the importing side can check which capabilities the exporting side supports.
+ */
+#define CELIX_RSA_RPC_CAPABILITY_PREFIX "celix.remote.admin.rpc."
+
 #define CELIX_RSA_RPC_FACTORY_NAME "rsa_rpc_factory"
 #define CELIX_RSA_RPC_FACTORY_VERSION "1.0.0"
 #define CELIX_RSA_RPC_FACTORY_USE_RANGE "[1.0.0,2.0.0)"
@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "celix_bundle_context.h"
+#include "celix_constants.h"
+#include "celix_framework_factory.h"
+#include "celix_log_helper.h"
+
+extern "C" {
+#include "remote_constants.h"
+#include "remote_service_admin.h"
+#include "topology_manager.h"
+#include "scope.h"
+
+struct import_registration {
+    endpoint_description_t *endpoint;
+};
+
+struct remote_service_admin {
+    celix_bundle_context_t* ctx;
+};
+}
+
+/**
+ * Benchmark for export and import scope changes of the topology manager.
+ *
+ * The topology manager exports and imports state.range(0) services, spread over NR_OF_SERVICE_NAMES service names.
+ * A scope for a single service name is added and removed, which should only re-evaluate the exports/imports of that
+ * service name.
+ */
+static constexpr int NR_OF_SERVICE_NAMES = 100;
+
+class TopologyManagerScopeBenchmark {
+public:
+    explicit TopologyManagerScopeBenchmark(int nrOfServices) {
+        auto* config = celix_properties_create();
+        celix_properties_set(config, CELIX_FRAMEWORK_CLEAN_CACHE_DIR_ON_CREATE, "true");
+        celix_properties_set(config, CELIX_FRAMEWORK_CACHE_DIR, ".tm_benchmark_cache");
+        celix_properties_set(config, "CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
+        fw = celix_frameworkFactory_createFramework(config);
+        ctx = celix_framework_getFrameworkContext(fw);
+        logHelper = celix_logHelper_create(ctx, "tm_benchmark");
+        topologyManager_create(ctx, logHelper, &tm, &scope);
+
+        rsa.ctx = ctx;
+        rsaSvc.admin = &rsa;
+        rsaSvc.exportService = [](remote_service_admin_t*, char*, celix_properties_t*, celix_array_list_t** registrations) -> celix_status_t {
+            *registrations = celix_arrayList_create();
+            return CELIX_SUCCESS;
+        };
+        rsaSvc.importService = [](remote_service_admin_t*, endpoint_description_t* endpoint, import_registration_t** registration) -> celix_status_t {
+            auto importReg = (import_registration_t*)calloc(1, sizeof(import_registration_t));
+            importReg->endpoint = endpoint;
+            *registration = importReg;
+            return CELIX_SUCCESS;
+        };
+        rsaSvc.importRegistration_close = [](remote_service_admin_t*, import_registration_t* registration) -> celix_status_t {
+            free(registration);
+            return CELIX_SUCCESS;
+        };
+        rsaSvcId = celix_bundleContext_registerService(ctx, &rsaSvc, CELIX_RSA_REMOTE_SERVICE_ADMIN, nullptr);
+        bundleContext_getServiceReference(ctx, CELIX_RSA_REMOTE_SERVICE_ADMIN, &rsaSvcRef);
+        topologyManager_rsaAdded(tm, rsaSvcRef, &rsaSvc);
+
+        for (int i = 0; i < nrOfServices; ++i) {
+            std::string name = "tmBenchService" + std::to_string(i % NR_OF_SERVICE_NAMES);
+
+            auto* svcProps = celix_properties_create();
+            celix_properties_set(svcProps, CELIX_RSA_SERVICE_EXPORTED_INTERFACES, "*");
+            long svcId = celix_bundleContext_registerService(ctx, &dummySvc, name.c_str(), svcProps);
+            exportedSvcIds.push_back(svcId);
+            service_reference_pt ref{};
+            std::string filter = "(" + std::string{CELIX_FRAMEWORK_SERVICE_ID} + "=" + std::to_string(svcId) + ")";
+            celix_array_list_t* refs{};
+            bundleContext_getServiceReferences(ctx, nullptr, filter.c_str(), &refs);
+            ref = (service_reference_pt)celix_arrayList_get(refs, 0);
+            celix_arrayList_destroy(refs);
+            exportedSvcRefs.push_back(ref);
+            topologyManager_addExportedService(tm, ref, &dummySvc);
+
+            auto* endpointProps = celix_properties_create();
+            celix_properties_set(endpointProps, CELIX_FRAMEWORK_SERVICE_NAME, name.c_str());
+            celix_properties_set(endpointProps, CELIX_RSA_ENDPOINT_FRAMEWORK_UUID, "1fb0bb2a-95ad-4cf9-8e79-072ec8bd4a85");
+            celix_properties_setLong(endpointProps, CELIX_RSA_ENDPOINT_SERVICE_ID, 100 + i);
+            celix_properties_set(endpointProps, CELIX_RSA_ENDPOINT_ID, ("tm-benchmark-endpoint-" + std::to_string(i)).c_str());
+            celix_properties_set(endpointProps, CELIX_RSA_SERVICE_IMPORTED, "true");
+            celix_properties_set(endpointProps, CELIX_RSA_SERVICE_IMPORTED_CONFIGS, "tm_benchmark_config_type");
+            endpoint_description_t* endpoint{};
+            endpointDescription_create(endpointProps, &endpoint);
+            endpoints.push_back(endpoint);
+            topologyManager_addImportedService(tm, endpoint, nullptr);
+        }
+    }
+
+    ~TopologyManagerScopeBenchmark() noexcept {
+        for (auto* endpoint : endpoints) {
+            topologyManager_removeImportedService(tm, endpoint, nullptr);
+            endpointDescription_destroy(endpoint);
+        }
+        for (auto* ref : exportedSvcRefs) {
+            topologyManager_removeExportedService(tm, ref, &dummySvc);
+            bundleContext_ungetServiceReference(ctx, ref);
+        }
+        for (auto svcId : exportedSvcIds) {
+            celix_bundleContext_unregisterService(ctx, svcId);
+        }
+        topologyManager_rsaRemoved(tm, rsaSvcRef, &rsaSvc);
+        bundleContext_ungetServiceReference(ctx, rsaSvcRef);
+        celix_bundleContext_unregisterService(ctx, rsaSvcId);
+        topologyManager_destroy(tm);
+        celix_logHelper_destroy(logHelper);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    TopologyManagerScopeBenchmark(TopologyManagerScopeBenchmark&&) = delete;
+    TopologyManagerScopeBenchmark& operator=(TopologyManagerScopeBenchmark&&) = delete;
+
+    celix_framework_t* fw{};
+    celix_bundle_context_t* ctx{};
+    celix_log_helper_t* logHelper{};
+    topology_manager_t* tm{};
+    void* scope{};
+    remote_service_admin_t rsa{};
+    remote_service_admin_service_t rsaSvc{};
+    long rsaSvcId{-1};
+    service_reference_pt rsaSvcRef{};
+    struct {
+        void* handle;
+    } dummySvc{};
+    std::vector<long> exportedSvcIds{};
+    std::vector<service_reference_pt> exportedSvcRefs{};
+    std::vector<endpoint_description_t*> endpoints{};
+};
+
+static void TopologyManager_ExportScopeChanged(benchmark::State& state) {
+    TopologyManagerScopeBenchmark benchmark{(int)state.range(0)};
+    char filter[] = "(objectClass=tmBenchService0)";
+    for (auto _ : state) {
+        tm_addExportScope(benchmark.scope, filter, celix_properties_create());
+        tm_removeExportScope(benchmark.scope, filter);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+static void TopologyManager_ImportScopeChanged(benchmark::State& state) {
+    TopologyManagerScopeBenchmark benchmark{(int)state.range(0)};
+    char filter[] = "(objectClass=tmBenchService0)";
+    for (auto _ : state) {
+        tm_addImportScope(benchmark.scope, filter);
+        tm_removeImportScope(benchmark.scope, filter);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(TopologyManager_ExportScopeChanged)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(TopologyManager_ImportScopeChanged)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -17,9 +17,14 @@
  * under the License.
  */
 
+#include <atomic>
 #include <gtest/gtest.h>
 #include "TopologyManagerTestSuiteBaseClass.h"
 
+extern "C" {
+#include "scope.h"
+}
+
 class TopologyManagerTestSuite : public TopologyManagerTestSuiteBaseClass {
 public:
     TopologyManagerTestSuite() = default;
@@ -469,4 +474,99 @@ TEST_F(TopologyManagerTestSuite, ImportService2Test) {
         status = topologyManager_removeImportedService(tm, importEndpoint, nullptr);
         EXPECT_EQ(CELIX_SUCCESS, status);
     });
-}
\ No newline at end of file
+}
+static std::atomic<int> scopeTestEndpointAddedCount{0};
+static std::atomic<int> scopeTestImportCount{0};
+static void* scopeTestScope{};
+
+TEST_F(TopologyManagerTestSuite, ExportScopeChangedTest) {
+    scopeTestEndpointAddedCount = 0;
+    scopeTestScope = tmScope;
+    TestExportService([](topology_manager_t* tm, service_reference_pt rsaSvcRef, void* rsaSvc, service_reference_pt exportedSvcRef, void* exportedSvc, service_reference_pt eplSvcRef, void* eplSvc, celix_bundle_context_t* ctx) {
+        (void)ctx;
+        auto status = topologyManager_rsaAdded(tm, rsaSvcRef, rsaSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_endpointListenerAdded(tm, eplSvcRef, eplSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_addExportedService(tm, exportedSvcRef, exportedSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(1, scopeTestEndpointAddedCount.load());
+
+        //a scope for another service must not re-export the exported service
+        char otherFilter[] = "(objectClass=tmOtherTestService)";
+        status = tm_addExportScope(scopeTestScope, otherFilter, celix_properties_create());
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(1, scopeTestEndpointAddedCount.load());
+
+        //a scope for the exported service must re-export the exported service
+        char filter[] = "(&(objectClass=tmTestService)(service.exported.interfaces=*))";
+        status = tm_addExportScope(scopeTestScope, filter, celix_properties_create());
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(2, scopeTestEndpointAddedCount.load());
+
+        status = tm_removeExportScope(scopeTestScope, otherFilter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(2, scopeTestEndpointAddedCount.load());
+
+        status = tm_removeExportScope(scopeTestScope, filter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(3, scopeTestEndpointAddedCount.load());
+
+        status = topologyManager_removeExportedService(tm, exportedSvcRef, exportedSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_endpointListenerRemoved(tm, eplSvcRef, eplSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_rsaRemoved(tm, rsaSvcRef, rsaSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }, false, nullptr, [](void *handle, endpoint_description_t *endpoint, char *matchedFilter) -> celix_status_t {
+        (void)handle;
+        (void)endpoint;
+        (void)matchedFilter;
+        scopeTestEndpointAddedCount++;
+        return CELIX_SUCCESS;
+    });
+}
+
+TEST_F(TopologyManagerTestSuite, ImportScopeChangedTest) {
+    scopeTestImportCount = 0;
+    scopeTestScope = tmScope;
+    TestImportService([](topology_manager_t* tm, service_reference_pt rsaSvcRef, void* rsaSvc, endpoint_description_t *importEndpoint) {
+        auto status = topologyManager_rsaAdded(tm, rsaSvcRef, rsaSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_addImportedService(tm, importEndpoint, nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(1, scopeTestImportCount.load());
+
+        //only allow importing another service, the import must be closed
+        char otherFilter[] = "(objectClass=tmOtherTestService)";
+        status = tm_addImportScope(scopeTestScope, otherFilter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(1, scopeTestImportCount.load());
+
+        //allow importing the service again, the service must be imported again
+        char filter[] = "(objectClass=tmTestService)";
+        status = tm_addImportScope(scopeTestScope, filter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(2, scopeTestImportCount.load());
+
+        //the service is still allowed to be imported, it must not be imported again
+        status = tm_removeImportScope(scopeTestScope, otherFilter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        EXPECT_EQ(2, scopeTestImportCount.load());
+
+        status = topologyManager_removeImportedService(tm, importEndpoint, nullptr);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+        status = topologyManager_rsaRemoved(tm, rsaSvcRef, rsaSvc);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+
+        status = tm_removeImportScope(scopeTestScope, filter);
+        EXPECT_EQ(CELIX_SUCCESS, status);
+    }, [](remote_service_admin_t* admin, endpoint_description_t* endpoint, import_registration_t** registration) -> celix_status_t {
+        (void)admin;
+        auto importReg = (import_registration_t*)calloc(1, sizeof(import_registration_t));
+        importReg->endpoint = endpoint;
+        *registration = importReg;
+        scopeTestImportCount++;
+        return CELIX_SUCCESS;
+    });
+}
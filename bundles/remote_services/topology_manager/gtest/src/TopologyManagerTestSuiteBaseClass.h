@@ -66,9 +66,8 @@ public:
         ctx = std::shared_ptr<celix_bundle_context_t>{celix_framework_getFrameworkContext(fw.get()), [](auto){/*nop*/}};
         logHelper = std::shared_ptr<celix_log_helper_t>{celix_logHelper_create(ctx.get(), "tm_unit_test"), [](auto l) {celix_logHelper_destroy(l);}};
 
-        void* scope = nullptr;
         topology_manager_t* tmPtr{};
-        auto status = topologyManager_create(ctx.get(), logHelper.get(), &tmPtr, &scope);
+        auto status = topologyManager_create(ctx.get(), logHelper.get(), &tmPtr, &tmScope);
         EXPECT_EQ(status, CELIX_SUCCESS);
         tm = std::shared_ptr<topology_manager_t>{tmPtr, [](auto t) {topologyManager_destroy(t);}};
     }
@@ -217,12 +216,13 @@ public:
         }
     }
 
-    void TestImportService(void (*testBody)(topology_manager_t* tm, service_reference_pt rsaSvcRef, void* rsaSvc, endpoint_description_t *importEndpoint)) {
+    void TestImportService(void (*testBody)(topology_manager_t* tm, service_reference_pt rsaSvcRef, void* rsaSvc, endpoint_description_t *importEndpoint),
+                           celix_status_t (*importService)(remote_service_admin_t* admin, endpoint_description_t* endpoint, import_registration_t** registration) = nullptr) {
         remote_service_admin_t rsa{};
         rsa.ctx = ctx.get();
         remote_service_admin_service_t rsaSvc{};
         rsaSvc.admin = &rsa;
-        rsaSvc.importService = [](remote_service_admin_t* admin, endpoint_description_t* endpoint, import_registration_t** registration) -> celix_status_t {
+        rsaSvc.importService = importService != nullptr ? importService : [](remote_service_admin_t* admin, endpoint_description_t* endpoint, import_registration_t** registration) -> celix_status_t {
             (void)admin;
             auto importReg = (import_registration_t*)calloc(1, sizeof(import_registration_t));
             importReg->endpoint = endpoint;
@@ -265,6 +265,7 @@ public:
     std::shared_ptr<celix_bundle_context_t> ctx{};
     std::shared_ptr<celix_log_helper_t> logHelper{};
     std::shared_ptr<topology_manager_t> tm{};
+    void* tmScope{};
 };
 
 #ifdef __cplusplus
@@ -25,11 +25,13 @@
 #include "topology_manager.h"
 #include "utils.h"
 #include "filter.h"
+#include "celix_utils.h"
 
 static bool import_equal(celix_array_list_entry_t src, celix_array_list_entry_t dest);
 
 struct scope_item {
     celix_properties_t *props;
+    celix_filter_t *filter; // parsed filter, NULL if the filter is not parsable
 };
 
 struct scope {
@@ -69,6 +71,7 @@ celix_status_t tm_addExportScope(void *handle, char *filter, celix_properties_t
                 status = CELIX_ENOMEM;
             } else {
                 item->props = props;
+                item->filter = celix_filter_create(filter);
                 hashMap_put(scope->exportScopes, (void*) strdup(filter), (void*) item);
             }
         } else {
@@ -99,6 +102,7 @@ celix_status_t tm_removeExportScope(void *handle, char *filter) {
             status = CELIX_ILLEGAL_ARGUMENT;
         } else {
             celix_properties_destroy(present->props);
+            celix_filter_destroy(present->filter);
             hashMap_remove(scope->exportScopes, filter); // frees also the item!
         }
         celixThreadMutex_unlock(&scope->exportScopeLock);
@@ -216,6 +220,7 @@ celix_status_t scope_scopeDestroy(scope_pt scope) {
             hash_map_entry_pt scopedEntry = hashMapIterator_nextEntry(iter);
             struct scope_item *item = (struct scope_item*) hashMapEntry_getValue(scopedEntry);
             celix_properties_destroy(item->props);
+            celix_filter_destroy(item->filter);
         }
         hashMapIterator_destroy(iter);
         hashMap_destroy(scope->exportScopes, true, true); // free keys, free values
@@ -270,11 +275,28 @@ bool scope_allowImport(scope_pt scope, endpoint_description_t *endpoint) {
     return allowImport;
 }
 
+static void scope_findExportScope_nolock(scope_pt scope, const celix_properties_t *serviceProperties, const char **matchedFilter, celix_properties_t **props) {
+    *matchedFilter = NULL;
+    *props = NULL;
+    hash_map_iterator_t scopedPropIter = hashMapIterator_construct(scope->exportScopes);
+    // TODO: now stopping if first filter matches, alternatively we could build up
+    //       the additional output properties for each filter that matches?
+    while (hashMapIterator_hasNext(&scopedPropIter)) {
+        hash_map_entry_pt scopedEntry = hashMapIterator_nextEntry(&scopedPropIter);
+        struct scope_item *item = (struct scope_item *) hashMapEntry_getValue(scopedEntry);
+        // test if the scope filter matches the exported service properties
+        if (item->filter != NULL && celix_filter_match(item->filter, serviceProperties)) {
+            *matchedFilter = (const char *) hashMapEntry_getKey(scopedEntry);
+            *props = item->props;
+            break;
+        }
+    }
+}
+
 celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props) {
     celix_status_t status = CELIX_SUCCESS;
     unsigned int size = 0;
     char **keys;
-    bool found = false;
 
     *props = NULL;
     celix_properties_t *serviceProperties = celix_properties_create();  // GB: not sure if a copy is needed
@@ -297,23 +319,8 @@ celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt re
     free(keys);
 
     if (celixThreadMutex_lock(&(scope->exportScopeLock)) == CELIX_SUCCESS) {
-        hash_map_iterator_pt scopedPropIter = hashMapIterator_create(scope->exportScopes);
-        // TODO: now stopping if first filter matches, alternatively we could build up
-        //       the additional output properties for each filter that matches?
-        while ((!found) && hashMapIterator_hasNext(scopedPropIter)) {
-            hash_map_entry_pt scopedEntry = hashMapIterator_nextEntry(scopedPropIter);
-            char *filterStr = (char *) hashMapEntry_getKey(scopedEntry);
-            celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
-            if (filter != NULL) {
-                // test if the scope filter matches the exported service properties
-                status = filter_match(filter, serviceProperties, &found);
-                if (found) {
-                    struct scope_item *item = (struct scope_item *) hashMapEntry_getValue(scopedEntry);
-                    *props = item->props;
-                }
-            }
-        }
-        hashMapIterator_destroy(scopedPropIter);
+        const char *matchedFilter = NULL;
+        scope_findExportScope_nolock(scope, serviceProperties, &matchedFilter, props);
         celix_properties_destroy(serviceProperties);
 
         celixThreadMutex_unlock(&(scope->exportScopeLock));
@@ -321,3 +328,26 @@ celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt re
 
     return status;
 }
+
+celix_status_t scope_getExportScope(scope_pt scope, const celix_properties_t *serviceProperties, char **matchedFilter, celix_properties_t **props) {
+    celix_status_t status = CELIX_SUCCESS;
+    *matchedFilter = NULL;
+    if (props != NULL) {
+        *props = NULL;
+    }
+
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&scope->exportScopeLock);
+    const char *filter = NULL;
+    celix_properties_t *scopeProps = NULL;
+    scope_findExportScope_nolock(scope, serviceProperties, &filter, &scopeProps);
+    if (filter != NULL) {
+        *matchedFilter = celix_utils_strdup(filter);
+        if (*matchedFilter == NULL) {
+            return CELIX_ENOMEM;
+        }
+    }
+    if (props != NULL) {
+        *props = scopeProps;
+    }
+    return status;
+}
@@ -100,6 +100,21 @@ bool scope_allowImport(scope_pt scope, endpoint_description_t *endpoint);
  */
 celix_status_t scope_getExportProperties(scope_pt scope, service_reference_pt reference, celix_properties_t **props);
 
+/* \brief  Find the export scope for the properties of an exported service
+ *
+ * \param  scope containing export rules
+ * \param  serviceProperties properties of the exported service
+ * \param  matchedFilter, copy of the filter of the matching export scope (caller owned)
+ *                NULL if no export scope matches
+ * \param  props, additional properties defining restrictions for the exported service
+ *                NULL if no export scope matches. Can be NULL if not needed.
+ *
+ * \return CELIX_SUCCESS
+ *         CELIX_ENOMEM
+ *
+ */
+celix_status_t scope_getExportScope(scope_pt scope, const celix_properties_t *serviceProperties, char **matchedFilter, celix_properties_t **props);
+
 /* \brief  add restricted scope for specified exported service
  *
  * \param  handle pointer to scope
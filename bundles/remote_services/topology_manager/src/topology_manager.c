@@ -34,6 +34,7 @@
 #include "topology_manager.h"
 #include "celix_build_assert.h"
 #include "celix_long_hash_map.h"
+#include "celix_string_hash_map.h"
 #include "celix_stdlib_cleanup.h"
 #include "bundle_context.h"
 #include "celix_compiler.h"
@@ -63,9 +64,17 @@ typedef struct celix_rsa_service_entry {
 
 typedef struct celix_exported_service_entry {
     service_reference_pt reference;
+    celix_properties_t* properties; //snapshot of the service properties, used to evaluate export scope changes
+    char* exportScope; //filter of the export scope used for the export, NULL if no export scope matched
     celix_long_hash_map_t* registrations; //key:rsa service id, val:celix_array_list_t<export_registration_t*>
 } celix_exported_service_entry_t;
 
+typedef struct celix_export_scope_candidate {
+    long serviceId;
+    celix_properties_t* properties;
+    char* exportScope;
+} celix_export_scope_candidate_t;
+
 struct topology_manager {
 	celix_bundle_context_t *context;
 
@@ -76,12 +85,14 @@ struct topology_manager {
 	hash_map_pt listenerList;
 
     celix_long_hash_map_t* exportedServices;//key:service id, val:celix_exported_service_entry_t*
+    celix_string_hash_map_t* exportedServicesByName;//key:service name, val:celix_long_hash_map_t<service id, celix_exported_service_entry_t*>
 
 	hash_map_pt importedServices;
+    celix_string_hash_map_t* importedServicesByName;//key:service name, val:celix_array_list_t<endpoint_description_t*>
 
 	bool closed;
 
-	//The mutex is used to protect rsaList,listenerList,exportedServices,importedServices,closed,and their related operations.
+	//The mutex is used to protect rsaList,listenerList,exportedServices,importedServices,closed,their indices and their related operations.
 	celix_thread_mutex_t lock;
 
 	scope_pt scope;
@@ -142,6 +153,18 @@ celix_status_t topologyManager_create(celix_bundle_context_t *context, celix_log
         celix_logHelper_error(logHelper, "TOPOLOGY_MANAGER: Error creating long hash map for exported services.");
         return CELIX_ENOMEM;
     }
+    celix_autoptr(celix_string_hash_map_t) exportedServicesByName = tm->exportedServicesByName = celix_stringHashMap_create();
+    if (exportedServicesByName == NULL) {
+        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(logHelper, "TOPOLOGY_MANAGER: Error creating string hash map for exported services.");
+        return CELIX_ENOMEM;
+    }
+    celix_autoptr(celix_string_hash_map_t) importedServicesByName = tm->importedServicesByName = celix_stringHashMap_create();
+    if (importedServicesByName == NULL) {
+        celix_logHelper_logTssErrors(logHelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(logHelper, "TOPOLOGY_MANAGER: Error creating string hash map for imported services.");
+        return CELIX_ENOMEM;
+    }
 
     //TODO remove deprecated hashMap
 	(*manager)->listenerList = hashMap_create(serviceReference_hashCode, NULL, serviceReference_equals2, NULL);
@@ -158,6 +181,8 @@ celix_status_t topologyManager_create(celix_bundle_context_t *context, celix_log
 	scope_setImportScopeChangedCallback(tm->scope, topologyManager_importScopeChanged);
 	*scope = tm->scope;
 
+    celix_steal_ptr(importedServicesByName);
+    celix_steal_ptr(exportedServicesByName);
     celix_steal_ptr(exportedServices);
     celix_steal_ptr(networkIfNames);
     celix_steal_ptr(dynamicIpEndpoints);
@@ -178,6 +203,12 @@ celix_status_t topologyManager_destroy(topology_manager_pt manager) {
 	hashMap_destroy(manager->importedServices, false, false);
 	hashMap_destroy(manager->listenerList, false, false);
 
+    CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, iter) {
+        celix_arrayList_destroy(iter.value.ptrValue);
+    }
+    celix_stringHashMap_destroy(manager->importedServicesByName);
+    assert(celix_stringHashMap_size(manager->exportedServicesByName) == 0);
+    celix_stringHashMap_destroy(manager->exportedServicesByName);
     assert(celix_longHashMap_size(manager->exportedServices) == 0);
     celix_longHashMap_destroy(manager->exportedServices);
     CELIX_LONG_HASH_MAP_ITERATE(manager->networkIfNames, iter) {
@@ -239,6 +270,11 @@ celix_status_t topologyManager_closeImports(topology_manager_pt manager) {
 	}
 	hashMapIterator_destroy(iter);
 
+    CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, nameIter) {
+        celix_arrayList_destroy(nameIter.value.ptrValue);
+    }
+    celix_stringHashMap_clear(manager->importedServicesByName);
+
 	status = celixThreadMutex_unlock(&manager->lock);
 
 	return status;
@@ -689,12 +725,93 @@ celix_status_t topologyManager_rsaRemoved(void * handle, service_reference_pt re
 	return status;
 }
 
+static const celix_filter_t* topologyManager_findServiceNameFilter(const celix_filter_t* filter) {
+    if (filter->operand == CELIX_FILTER_OPERAND_AND) {
+        for (int i = 0; i < celix_arrayList_size(filter->children); ++i) {
+            const celix_filter_t* nameFilter = topologyManager_findServiceNameFilter(celix_arrayList_get(filter->children, i));
+            if (nameFilter != NULL) {
+                return nameFilter;
+            }
+        }
+    } else if (filter->attribute != NULL && celix_utils_stringEquals(filter->attribute, CELIX_FRAMEWORK_SERVICE_NAME)) {
+        return filter;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns whether a service name can match the service name (objectClass) constraint of a scope filter.
+ * If the scope filter has no service name constraint, every service name can match.
+ */
+static bool topologyManager_serviceNameMatches(const celix_filter_t* nameFilter, const char* name) {
+    if (nameFilter == NULL) {
+        return true;
+    }
+    if (nameFilter->operand == CELIX_FILTER_OPERAND_EQUAL) {
+        return celix_utils_stringEquals(nameFilter->value, name);
+    }
+    celix_autoptr(celix_properties_t) nameProps = celix_properties_create();
+    if (nameProps == NULL || celix_properties_set(nameProps, CELIX_FRAMEWORK_SERVICE_NAME, name) != CELIX_SUCCESS) {
+        return true;
+    }
+    return celix_filter_match(nameFilter, nameProps);
+}
+
+static void topologyManager_destroyExportScopeCandidate(void* data) {
+    celix_export_scope_candidate_t* candidate = data;
+    celix_properties_destroy(candidate->properties);
+    free(candidate->exportScope);
+    free(candidate);
+}
+
+static celix_status_t topologyManager_addExportScopeCandidate(celix_array_list_t* candidates, long serviceId, celix_exported_service_entry_t* svcEntry) {
+    celix_export_scope_candidate_t* candidate = calloc(1, sizeof(*candidate));
+    if (candidate == NULL) {
+        return CELIX_ENOMEM;
+    }
+    candidate->serviceId = serviceId;
+    candidate->properties = celix_properties_copy(svcEntry->properties);
+    candidate->exportScope = svcEntry->exportScope == NULL ? NULL : celix_utils_strdup(svcEntry->exportScope);
+    if (candidate->properties == NULL || (svcEntry->exportScope != NULL && candidate->exportScope == NULL) ||
+        celix_arrayList_add(candidates, candidate) != CELIX_SUCCESS) {
+        topologyManager_destroyExportScopeCandidate(candidate);
+        return CELIX_ENOMEM;
+    }
+    return CELIX_SUCCESS;
+}
+
+static celix_status_t topologyManager_collectExportScopeCandidates(topology_manager_t* manager, const celix_filter_t* nameFilter, celix_array_list_t* candidates) {
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&manager->lock);
+    if (nameFilter != NULL && nameFilter->operand == CELIX_FILTER_OPERAND_EQUAL) {
+        celix_long_hash_map_t* bucket = celix_stringHashMap_get(manager->exportedServicesByName, nameFilter->value);
+        if (bucket == NULL) {
+            return CELIX_SUCCESS;
+        }
+        CELIX_LONG_HASH_MAP_ITERATE(bucket, iter) {
+            celix_status_t status = topologyManager_addExportScopeCandidate(candidates, iter.key, iter.value.ptrValue);
+            if (status != CELIX_SUCCESS) {
+                return status;
+            }
+        }
+        return CELIX_SUCCESS;
+    }
+    CELIX_STRING_HASH_MAP_ITERATE(manager->exportedServicesByName, nameIter) {
+        if (!topologyManager_serviceNameMatches(nameFilter, nameIter.key)) {
+            continue;
+        }
+        CELIX_LONG_HASH_MAP_ITERATE((celix_long_hash_map_t*)nameIter.value.ptrValue, iter) {
+            celix_status_t status = topologyManager_addExportScopeCandidate(candidates, iter.key, iter.value.ptrValue);
+            if (status != CELIX_SUCCESS) {
+                return status;
+            }
+        }
+    }
+    return CELIX_SUCCESS;
+}
+
 celix_status_t topologyManager_exportScopeChanged(void *handle, char *filterStr) {
 	celix_status_t status = CELIX_SUCCESS;
 	topology_manager_pt manager = (topology_manager_pt) handle;
-	service_registration_t *reg = NULL;
-	bool found;
-	celix_properties_t *props;
 	celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
 
 	if (filter == NULL) {
@@ -702,88 +819,146 @@ celix_status_t topologyManager_exportScopeChanged(void *handle, char *filterStr)
 		return CELIX_ENOMEM;
 	}
 
-	// add already exported services to new rsa
-    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&manager->lock);
-
-	int size = celix_longHashMap_size(manager->exportedServices);
-	celix_autofree service_reference_pt *srvRefs = (service_reference_pt *) calloc(size, sizeof(service_reference_pt));
-    if (srvRefs == NULL) {
+    //Only exported services with a service name which can match the changed scope are candidates
+    celix_array_list_create_options_t opts = CELIX_EMPTY_ARRAY_LIST_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = topologyManager_destroyExportScopeCandidate;
+    celix_autoptr(celix_array_list_t) candidates = celix_arrayList_createWithOptions(&opts);
+    if (candidates == NULL) {
+        celix_logHelper_logTssErrors(manager->loghelper, CELIX_LOG_LEVEL_ERROR);
         return CELIX_ENOMEM;
     }
-	int nrFound = 0;
-
-	found = false;
-
-    CELIX_LONG_HASH_MAP_ITERATE(manager->exportedServices, iter) {
-        celix_exported_service_entry_t* svcEntry = iter.value.ptrValue;
-		service_reference_pt reference = svcEntry->reference;
-		reg = NULL;
-		serviceReference_getServiceRegistration(reference, &reg);
-		if (reg != NULL) {
-			props = NULL;
-			serviceRegistration_getProperties(reg, &props);
-			status = filter_match(filter, props, &found);
-			if (found) {
-				srvRefs[nrFound++] = reference;
-			}
-		}
-	}
+    status = topologyManager_collectExportScopeCandidates(manager, topologyManager_findServiceNameFilter(filter), candidates);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(manager->loghelper, "TOPOLOGY_MANAGER: Error collecting exported services for export scope change.");
+        return status;
+    }
 
-	if (nrFound > 0) {
-		for (int i = 0; i < nrFound; i++) {
-			// Question: can srvRefs become invalid meanwhile??
-			const char* export = NULL;
-			serviceReference_getProperty(srvRefs[i], (char *) CELIX_RSA_SERVICE_EXPORTED_INTERFACES, &export);
+    //Evaluate the export scopes outside the lock, only services for which the export scope changed need to be re-exported
+    for (int i = celix_arrayList_size(candidates) - 1; i >= 0; --i) {
+        celix_export_scope_candidate_t* candidate = celix_arrayList_get(candidates, i);
+        bool changed = false;
+        if (celix_filter_match(filter, candidate->properties)) {
+            celix_autofree char* exportScope = NULL;
+            scope_getExportScope(manager->scope, candidate->properties, &exportScope, NULL);
+            changed = !celix_utils_stringEquals(exportScope == NULL ? "" : exportScope, candidate->exportScope == NULL ? "" : candidate->exportScope)
+                      || (exportScope != NULL && celix_utils_stringEquals(exportScope, filterStr));
+        }
+        if (!changed) {
+            celix_arrayList_removeAt(candidates, i);
+        }
+    }
 
-			if (export) {
-				topologyManager_removeExportedService_nolock(manager, srvRefs[i]);
-                celix_status_t substatus = topologyManager_addExportedService_nolock(manager, srvRefs[i]);
-				if (substatus != CELIX_SUCCESS) {
-					status = substatus;
-				}
-			}
-		}
-	}
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&manager->lock);
+    for (int i = 0; i < celix_arrayList_size(candidates); ++i) {
+        celix_export_scope_candidate_t* candidate = celix_arrayList_get(candidates, i);
+        //The exported service can be removed in the meantime
+        celix_exported_service_entry_t* svcEntry = celix_longHashMap_get(manager->exportedServices, candidate->serviceId);
+        if (svcEntry == NULL) {
+            continue;
+        }
+        service_reference_pt reference = svcEntry->reference;
+        topologyManager_removeExportedService_nolock(manager, reference);
+        celix_status_t substatus = topologyManager_addExportedService_nolock(manager, reference);
+        if (substatus != CELIX_SUCCESS) {
+            status = substatus;
+        }
+    }
 
 	return status;
 }
 
-celix_status_t topologyManager_importScopeChanged(void *handle, char *service_name) {
+celix_status_t topologyManager_importScopeChanged(void *handle, char *filterStr) {
 	celix_status_t status = CELIX_SUCCESS;
-	endpoint_description_t *endpoint;
 	topology_manager_pt manager = (topology_manager_pt) handle;
-	bool found = false;
-
-	// add already imported services to new rsa
-	celixThreadMutex_lock(&manager->lock);
-
-	hash_map_iterator_pt importedServicesIterator = hashMapIterator_create(manager->importedServices);
-	while (!found && hashMapIterator_hasNext(importedServicesIterator)) {
-		hash_map_entry_pt entry = hashMapIterator_nextEntry(importedServicesIterator);
-		endpoint = hashMapEntry_getKey(entry);
+    celix_autoptr(celix_filter_t) filter = celix_filter_create(filterStr);
 
-        const char* name = celix_properties_get(endpoint->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
-		// Test if a service with the same name is imported
-		if (strcmp(name, service_name) == 0) {
-			found = true;
-		}
-	}
-	hashMapIterator_destroy(importedServicesIterator);
+    if (filter == NULL) {
+        celix_logHelper_error(manager->loghelper,"filter creating failed\n");
+        return CELIX_ENOMEM;
+    }
+    const celix_filter_t* nameFilter = topologyManager_findServiceNameFilter(filter);
 
-	if (found) {
-		status = topologyManager_removeImportedService_nolock(manager, endpoint, NULL);
+    //The endpoints are owned by discovery and are only guaranteed to be valid while the lock is held
+    celix_auto(celix_mutex_lock_guard_t) lockGuard = celixMutexLockGuard_init(&manager->lock);
+    if (manager->closed) {
+        return CELIX_SUCCESS;
+    }
+    CELIX_STRING_HASH_MAP_ITERATE(manager->importedServicesByName, nameIter) {
+        if (!topologyManager_serviceNameMatches(nameFilter, nameIter.key)) {
+            continue;
+        }
+        celix_array_list_t* endpoints = nameIter.value.ptrValue;
+        for (int i = 0; i < celix_arrayList_size(endpoints); ++i) {
+            endpoint_description_t* endpoint = celix_arrayList_get(endpoints, i);
+            hash_map_pt imports = hashMap_get(manager->importedServices, endpoint);
+            if (imports == NULL) {
+                continue;
+            }
+            bool imported = hashMap_size(imports) > 0;
+            bool allowed = scope_allowImport(manager->scope, endpoint);
+            if (allowed && !imported) {
+                CELIX_LONG_HASH_MAP_ITERATE(manager->rsaMap, iter) {
+                    celix_rsa_service_entry_t* rsaSvcEntry = iter.value.ptrValue;
+                    remote_service_admin_service_t* rsa = rsaSvcEntry->rsa;
+                    import_registration_t* import = NULL;
+                    celix_status_t substatus = rsa->importService(rsa->admin, endpoint, &import);
+                    if (substatus == CELIX_SUCCESS) {
+                        hashMap_put(imports, rsa, import);
+                    } else {
+                        celix_logHelper_error(manager->loghelper, "TOPOLOGY_MANAGER: Import of service (%s; %s) failed.", endpoint->serviceName, endpoint->id);
+                        status = substatus;
+                    }
+                }
+            } else if (!allowed && imported) {
+                hash_map_iterator_pt importsIter = hashMapIterator_create(imports);
+                while (hashMapIterator_hasNext(importsIter)) {
+                    hash_map_entry_pt entry = hashMapIterator_nextEntry(importsIter);
+                    remote_service_admin_service_t* rsa = hashMapEntry_getKey(entry);
+                    import_registration_t* import = hashMapEntry_getValue(entry);
+                    celix_status_t substatus = rsa->importRegistration_close(rsa->admin, import);
+                    if (substatus == CELIX_SUCCESS) {
+                        hashMapIterator_remove(importsIter);
+                    } else {
+                        celix_logHelper_error(manager->loghelper, "TOPOLOGY_MANAGER: Removal of imported service (%s; %s) failed.", endpoint->serviceName, endpoint->id);
+                        status = substatus;
+                    }
+                }
+                hashMapIterator_destroy(importsIter);
+            }
+        }
+    }
 
-		if (status != CELIX_SUCCESS) {
-			celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_ERROR, "TOPOLOGY_MANAGER: Removal of imported service (%s; %s) failed.", endpoint->serviceName, endpoint->id);
-		} else {
-			status = topologyManager_addImportedService_nolock(manager, endpoint, NULL);
-		}
-	}
+	return status;
+}
 
-	//should unlock until here ?, avoid endpoint is released during topologyManager_removeImportedService
-	celixThreadMutex_unlock(&manager->lock);
+static void topologyManager_indexImportedService_nolock(topology_manager_t* tm, endpoint_description_t* endpoint) {
+    const char* name = celix_properties_get(endpoint->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
+    celix_array_list_t* endpoints = celix_stringHashMap_get(tm->importedServicesByName, name);
+    if (endpoints == NULL) {
+        endpoints = celix_arrayList_create();
+        if (endpoints == NULL || celix_stringHashMap_put(tm->importedServicesByName, name, endpoints) != CELIX_SUCCESS) {
+            celix_arrayList_destroy(endpoints);
+            celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
+            celix_logHelper_warning(tm->loghelper, "TOPOLOGY_MANAGER: Error indexing imported service (%s; %s), import scope changes will not be applied.", endpoint->serviceName, endpoint->id);
+            return;
+        }
+    }
+    if (celix_arrayList_add(endpoints, endpoint) != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_warning(tm->loghelper, "TOPOLOGY_MANAGER: Error indexing imported service (%s; %s), import scope changes will not be applied.", endpoint->serviceName, endpoint->id);
+    }
+}
 
-	return status;
+static void topologyManager_unindexImportedService_nolock(topology_manager_t* tm, endpoint_description_t* endpoint) {
+    const char* name = celix_properties_get(endpoint->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
+    celix_array_list_t* endpoints = celix_stringHashMap_get(tm->importedServicesByName, name);
+    if (endpoints != NULL) {
+        celix_arrayList_remove(endpoints, endpoint);
+        if (celix_arrayList_size(endpoints) == 0) {
+            celix_stringHashMap_remove(tm->importedServicesByName, name);
+            celix_arrayList_destroy(endpoints);
+        }
+    }
 }
 
 static celix_status_t topologyManager_addImportedService_nolock(void *handle, endpoint_description_t *endpoint, char *matchedFilter) {
@@ -800,6 +975,7 @@ static celix_status_t topologyManager_addImportedService_nolock(void *handle, en
 
 	hash_map_pt imports = hashMap_create(NULL, NULL, NULL, NULL);
 	hashMap_put(manager->importedServices, endpoint, imports);
+    topologyManager_indexImportedService_nolock(manager, endpoint);
 
 	if (scope_allowImport(manager->scope, endpoint)) {
         CELIX_LONG_HASH_MAP_ITERATE(manager->rsaMap, iter) {
@@ -861,6 +1037,7 @@ static celix_status_t topologyManager_removeImportedService_nolock(void *handle,
 			}
 			hashMapIterator_destroy(importsIter);
 			hashMapIterator_remove(iter);
+            topologyManager_unindexImportedService_nolock(manager, ep);
 
 			hashMap_destroy(imports, false, false);
 		}
@@ -892,6 +1069,22 @@ static celix_exported_service_entry_t* exportedServiceEntry_create(topology_mana
         return NULL;
     }
     svcEntry->reference = reference;
+    celix_autoptr(celix_properties_t) properties = svcEntry->properties = celix_properties_create();
+    if (properties == NULL) {
+        celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_error(tm->loghelper, "TOPOLOGY_MANAGER: Error creating properties for exported service entry.");
+        return NULL;
+    }
+    unsigned int size = 0;
+    char** keys = NULL;
+    serviceReference_getPropertyKeys(reference, &keys, &size);
+    for (unsigned int i = 0; i < size; i++) {
+        const char* value = NULL;
+        if (serviceReference_getProperty(reference, keys[i], &value) == CELIX_SUCCESS && value != NULL) {
+            celix_properties_set(properties, keys[i], value);
+        }
+    }
+    free(keys);
     celix_autoptr(celix_long_hash_map_t) registrations = svcEntry->registrations = celix_longHashMap_create();
     if (registrations == NULL) {
         celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
@@ -899,15 +1092,48 @@ static celix_exported_service_entry_t* exportedServiceEntry_create(topology_mana
         return NULL;
     }
     celix_steal_ptr(registrations);
+    celix_steal_ptr(properties);
     return celix_steal_ptr(svcEntry);
 }
 
 static void exportedServiceEntry_destroy(celix_exported_service_entry_t* entry) {
     celix_longHashMap_destroy(entry->registrations);
+    celix_properties_destroy(entry->properties);
+    free(entry->exportScope);
     free(entry);
     return;
 }
 
+static void topologyManager_indexExportedService_nolock(topology_manager_t* tm, long serviceId, celix_exported_service_entry_t* svcEntry) {
+    const char* name = celix_properties_get(svcEntry->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
+    celix_long_hash_map_t* bucket = celix_stringHashMap_get(tm->exportedServicesByName, name);
+    if (bucket == NULL) {
+        bucket = celix_longHashMap_create();
+        if (bucket == NULL || celix_stringHashMap_put(tm->exportedServicesByName, name, bucket) != CELIX_SUCCESS) {
+            celix_longHashMap_destroy(bucket);
+            celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
+            celix_logHelper_warning(tm->loghelper, "TOPOLOGY_MANAGER: Error indexing exported service %li, export scope changes will not be applied.", serviceId);
+            return;
+        }
+    }
+    if (celix_longHashMap_put(bucket, serviceId, svcEntry) != CELIX_SUCCESS) {
+        celix_logHelper_logTssErrors(tm->loghelper, CELIX_LOG_LEVEL_ERROR);
+        celix_logHelper_warning(tm->loghelper, "TOPOLOGY_MANAGER: Error indexing exported service %li, export scope changes will not be applied.", serviceId);
+    }
+}
+
+static void topologyManager_unindexExportedService_nolock(topology_manager_t* tm, long serviceId, celix_exported_service_entry_t* svcEntry) {
+    const char* name = celix_properties_get(svcEntry->properties, CELIX_FRAMEWORK_SERVICE_NAME, "");
+    celix_long_hash_map_t* bucket = celix_stringHashMap_get(tm->exportedServicesByName, name);
+    if (bucket != NULL) {
+        celix_longHashMap_remove(bucket, serviceId);
+        if (celix_longHashMap_size(bucket) == 0) {
+            celix_stringHashMap_remove(tm->exportedServicesByName, name);
+            celix_longHashMap_destroy(bucket);
+        }
+    }
+}
+
 static celix_status_t topologyManager_addExportedService_nolock(void * handle, service_reference_pt reference) {
     topology_manager_pt manager = handle;
 	celix_status_t status = CELIX_SUCCESS;
@@ -922,14 +1148,14 @@ static celix_status_t topologyManager_addExportedService_nolock(void * handle, s
 
 	celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "TOPOLOGY_MANAGER: Add exported service (%li).", serviceId);
 
-
-	scope_getExportProperties(manager->scope, reference, &serviceProperties);
-
     celix_exported_service_entry_t* svcEntry = exportedServiceEntry_create(manager, reference);
     if (svcEntry == NULL) {
         celix_logHelper_error(manager->loghelper, "TOPOLOGY_MANAGER: Error allocating exported service entry.");
         return CELIX_ENOMEM;
     }
+
+    scope_getExportScope(manager->scope, svcEntry->properties, &svcEntry->exportScope, &serviceProperties);
+
     status = celix_longHashMap_put(manager->exportedServices, serviceId, svcEntry);
     if (status != CELIX_SUCCESS) {
         exportedServiceEntry_destroy(svcEntry);
@@ -937,6 +1163,7 @@ static celix_status_t topologyManager_addExportedService_nolock(void * handle, s
         celix_logHelper_error(manager->loghelper, "TOPOLOGY_MANAGER: Error adding exported service entry to map.");
         return status;
     }
+    topologyManager_indexExportedService_nolock(manager, serviceId, svcEntry);
 
     if (celix_longHashMap_size(manager->rsaMap) == 0) {
         celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_WARNING, "TOPOLOGY_MANAGER: No RSA available yet.");
@@ -1023,6 +1250,7 @@ static void topologyManager_removeExportedService_nolock(void * handle, service_
         }
     }
 
+    topologyManager_unindexExportedService_nolock(manager, serviceId, svcEntry);
     celix_longHashMap_remove(manager->exportedServices, serviceId);
     exportedServiceEntry_destroy(svcEntry);
 
@@ -54,6 +54,7 @@ class CelixConan(ConanFile):
         "build_log_helper": False,
         "build_log_service_api": False,
         "build_syslog_writer": False,
+        "build_file_writer": False,
         "build_cxx_remote_service_admin": False,
         "build_cxx_rsa_integration": False,
         "build_remote_service_admin": False,
@@ -240,6 +241,9 @@ class CelixConan(ConanFile):
         if options["build_syslog_writer"]:
             options["build_log_service"] = True
 
+        if options["build_file_writer"]:
+            options["build_log_service"] = True
+
         if options["build_log_service"]:
             options["build_log_service_api"] = True
             options["build_shell_api"] = True
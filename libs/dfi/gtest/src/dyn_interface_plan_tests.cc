@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dyn_interface.h"
+#include "dyn_interface_plan.h"
+#include "celix_err.h"
+
+#include <stdio.h>
+
+class DynInterfacePlanTests : public ::testing::Test {
+public:
+    DynInterfacePlanTests() = default;
+    ~DynInterfacePlanTests() override {
+        dynInterface_destroy(intf);
+        celix_err_resetErrors();
+    }
+
+    void parse(const char* descriptor) {
+        FILE* desc = fopen(descriptor, "r");
+        ASSERT_TRUE(desc != nullptr);
+        int rc = dynInterface_parse(desc, &intf);
+        fclose(desc);
+        ASSERT_EQ(0, rc);
+    }
+
+    dyn_interface_type* intf{nullptr};
+};
+
+TEST_F(DynInterfacePlanTests, CreatePlanForCalculator) {
+    parse("descriptors/example1.descriptor");
+    dyn_interface_plan* plan = nullptr;
+    ASSERT_EQ(0, dynInterfacePlan_create(intf, &plan));
+    EXPECT_EQ(intf, dynInterfacePlan_interface(plan));
+    EXPECT_EQ(dynInterface_nrOfMethods(intf), dynInterfacePlan_nrOfMethods(plan));
+
+    const dyn_method_plan* add = dynInterfacePlan_findMethod(plan, "add(DD)D");
+    ASSERT_TRUE(add != nullptr);
+    EXPECT_EQ(add, dynInterfacePlan_methodForIndex(plan, add->index));
+    EXPECT_EQ(dynInterface_findMethod(intf, "add(DD)D")->dynFunc, add->dynFunc);
+    EXPECT_EQ(4, add->nrOfArguments);
+    EXPECT_EQ(2, add->nrOfStandardArguments);
+    EXPECT_EQ(DYN_ARGUMENT_OP__HANDLE, add->arguments[0].op);
+    EXPECT_EQ(DYN_ARGUMENT_OP__VALUE, add->arguments[1].op);
+    EXPECT_EQ(DYN_ARGUMENT_OP__VALUE, add->arguments[2].op);
+    ASSERT_TRUE(add->output != nullptr);
+    EXPECT_EQ(3, add->output->index);
+    EXPECT_EQ(DYN_ARGUMENT_OP__PRE_ALLOCATED, add->output->op);
+    EXPECT_EQ(sizeof(double), dynType_size(add->output->freeType));
+
+    const dyn_method_plan* stats = dynInterfacePlan_findMethod(plan, "stats([D)LStatsResult;");
+    ASSERT_TRUE(stats != nullptr);
+    EXPECT_EQ(1, stats->nrOfStandardArguments);
+    ASSERT_TRUE(stats->output != nullptr);
+    EXPECT_EQ(DYN_ARGUMENT_OP__OUTPUT_VALUE, stats->output->op);
+    EXPECT_EQ('{', dynType_descriptorType(stats->output->freeType));
+
+    EXPECT_EQ(nullptr, dynInterfacePlan_findMethod(plan, "unknown"));
+    EXPECT_EQ(nullptr, dynInterfacePlan_methodForIndex(plan, -1));
+    EXPECT_EQ(nullptr, dynInterfacePlan_methodForIndex(plan, dynInterfacePlan_nrOfMethods(plan)));
+    dynInterfacePlan_destroy(plan);
+}
+
+TEST_F(DynInterfacePlanTests, CreatePlanWithTextArguments) {
+    parse("descriptors/example4.descriptor");
+    dyn_interface_plan* plan = nullptr;
+    ASSERT_EQ(0, dynInterfacePlan_create(intf, &plan));
+
+    const dyn_method_plan* getName = dynInterfacePlan_findMethod(plan, "getName(V)t");
+    ASSERT_TRUE(getName != nullptr);
+    EXPECT_EQ(0, getName->nrOfStandardArguments);
+    ASSERT_TRUE(getName->output != nullptr);
+    EXPECT_EQ(DYN_ARGUMENT_OP__OUTPUT_TEXT, getName->output->op);
+
+    const dyn_method_plan* setName = dynInterfacePlan_findMethod(plan, "setName");
+    ASSERT_TRUE(setName != nullptr);
+    EXPECT_EQ(nullptr, setName->output);
+    EXPECT_EQ(DYN_ARGUMENT_OP__TEXT, setName->arguments[1].op);
+
+    const dyn_method_plan* setConstName = dynInterfacePlan_findMethod(plan, "setConstName");
+    ASSERT_TRUE(setConstName != nullptr);
+    EXPECT_EQ(DYN_ARGUMENT_OP__CONST_TEXT, setConstName->arguments[1].op);
+    dynInterfacePlan_destroy(plan);
+}
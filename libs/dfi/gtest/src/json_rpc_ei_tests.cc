@@ -162,7 +162,7 @@ TEST_F(JsonRpcErrorInjectionTestSuite, responsePayloadGenerationErrorTest) {
     char *result = nullptr;
     tst_serv serv {nullptr, add, nullptr, nullptr, nullptr};
 
-    celix_ei_expect_json_object((void*)jsonRpc_call, 0, nullptr);
+    celix_ei_expect_json_object((void*)jsonRpc_call, 1, nullptr);
     rc = jsonRpc_call(intf, &serv, R"({"m":"add(DD)D", "a": [1.0,2.0]})", &result);
     ASSERT_NE(0, rc);
     EXPECT_EQ(nullptr, result);
@@ -181,7 +181,7 @@ TEST_F(JsonRpcErrorInjectionTestSuite, responseRenderingErrorTest) {
     char *result = nullptr;
     tst_serv serv {nullptr, add, nullptr, nullptr, nullptr};
 
-    celix_ei_expect_json_dumps((void*)jsonRpc_call, 0, nullptr);
+    celix_ei_expect_json_dumps((void*)jsonRpc_call, 1, nullptr);
     rc = jsonRpc_call(intf, &serv, R"({"m":"add(DD)D", "a": [1.0,2.0]})", &result);
     ASSERT_NE(0, rc);
     EXPECT_EQ(nullptr, result);
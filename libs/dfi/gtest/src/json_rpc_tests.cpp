@@ -37,6 +37,7 @@ extern "C" {
 #include "dyn_function.h"
 #include "json_serializer.h"
 #include "json_rpc.h"
+#include "dyn_interface_plan.h"
 #include "json_rpc_test.h"
 #include "celix_compiler.h"
 #include "celix_errno.h"
@@ -729,6 +730,81 @@ TEST_F(JsonRpcTests, callPre) {
     callTestPreAllocated();
 }
 
+TEST_F(JsonRpcTests, callWithPlan) {
+    dyn_interface_type *intf = nullptr;
+    FILE *desc = fopen("descriptors/example1.descriptor", "r");
+    ASSERT_TRUE(desc != nullptr);
+    int rc = dynInterface_parse(desc, &intf);
+    ASSERT_EQ(0, rc);
+    fclose(desc);
+    dyn_interface_plan* plan = nullptr;
+    rc = dynInterfacePlan_create(intf, &plan);
+    ASSERT_EQ(0, rc);
+
+    char *result = nullptr;
+    tst_serv serv {nullptr, add, nullptr, nullptr, stats};
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m":"add(DD)D", "a": [1.0,2.0]})", &result);
+    ASSERT_EQ(0, rc);
+    EXPECT_TRUE(strstr(result, "3.0") != nullptr);
+    free(result);
+
+    result = nullptr;
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m":"stats([D)LStatsResult;", "a": [[1.0,2.0]]})", &result);
+    ASSERT_EQ(0, rc);
+    EXPECT_TRUE(strstr(result, "1.5") != nullptr); //average
+    free(result);
+
+    result = nullptr;
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m":"unknown", "a": [1.0,2.0]})", &result);
+    EXPECT_NE(0, rc);
+    EXPECT_EQ(nullptr, result);
+    EXPECT_STREQ("Cannot find method with sig 'unknown'", celix_err_popLastError());
+
+    dynInterfacePlan_destroy(plan);
+    dynInterface_destroy(intf);
+}
+
+TEST_F(JsonRpcTests, callWithPlanTextArguments) {
+    dyn_interface_type *intf = nullptr;
+    FILE *desc = fopen("descriptors/example4.descriptor", "r");
+    ASSERT_TRUE(desc != nullptr);
+    int rc = dynInterface_parse(desc, &intf);
+    ASSERT_EQ(0, rc);
+    fclose(desc);
+    dyn_interface_plan* plan = nullptr;
+    rc = dynInterfacePlan_create(intf, &plan);
+    ASSERT_EQ(0, rc);
+
+    char *result = nullptr;
+    tst_serv_example4 serv {nullptr, [](void*, char** name)->int {
+        *name = strdup("allocatedInFunction");
+        return 0;
+    }, [](void*, char* name)->int {
+        EXPECT_STREQ(name, "hello");
+        free(name);
+        return 0;
+    }, [](void*, const char *name)->int {
+        EXPECT_STREQ(name, "hello const char");
+        return 0;
+    }};
+
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m": "getName(V)t", "a": []})", &result);
+    ASSERT_EQ(0, rc);
+    EXPECT_STREQ(R"({"r":"allocatedInFunction"})", result);
+    free(result);
+
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m": "setName", "a":["hello"]})", &result);
+    ASSERT_EQ(0, rc);
+    free(result);
+
+    rc = jsonRpc_callWithPlan(plan, &serv, R"({"m": "setConstName", "a":["hello const char"]})", &result);
+    ASSERT_EQ(0, rc);
+    free(result);
+
+    dynInterfacePlan_destroy(plan);
+    dynInterface_destroy(intf);
+}
+
 TEST_F(JsonRpcTests, callPreWithMismatchedArgumentNumber) {
     dyn_interface_type *intf = nullptr;
     FILE *desc = fopen("descriptors/example1.descriptor", "r");
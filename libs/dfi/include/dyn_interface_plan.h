@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef __DYN_INTERFACE_PLAN_H_
+#define __DYN_INTERFACE_PLAN_H_
+
+#include <stddef.h>
+
+#include "dyn_type.h"
+#include "dyn_function.h"
+#include "dyn_interface.h"
+#include "celix_cleanup.h"
+#include "celix_dfi_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An interface plan is a precompiled, flat representation of a dynamic interface type.
+ *
+ * For every method the plan contains the resolved argument types and the operation needed to (de)serialize and
+ * release each argument. Methods are indexed both by method index and, through
+ * a hash map, by method id. Codecs (e.g. json_rpc) can use a plan to execute a call without walking the dyn type
+ * trees or searching the method list for every invocation.
+ */
+typedef struct dyn_interface_plan dyn_interface_plan;
+
+/**
+ * The operation needed to handle a single argument of a remote call.
+ */
+enum dyn_argument_op {
+    DYN_ARGUMENT_OP__HANDLE = 0,         ///< The service handle, passed as is.
+    DYN_ARGUMENT_OP__VALUE = 1,          ///< Standard argument, deserialized and deep freed after the call.
+    DYN_ARGUMENT_OP__TEXT = 2,           ///< Standard char* argument, the callee takes ownership of the string.
+    DYN_ARGUMENT_OP__CONST_TEXT = 3,     ///< Standard const char* argument, deep freed after the call.
+    DYN_ARGUMENT_OP__PRE_ALLOCATED = 4,  ///< Pre-allocated output argument (am=pre).
+    DYN_ARGUMENT_OP__OUTPUT_TEXT = 5,    ///< Output argument pointing to a char* (am=out).
+    DYN_ARGUMENT_OP__OUTPUT_VALUE = 6    ///< Output argument pointing to a pointer of a serializable type (am=out).
+};
+
+typedef struct dyn_argument_plan {
+    int index; ///< The index of the argument in the function
+    enum dyn_function_argument_meta argumentMeta; ///< The argument meta of the argument
+    enum dyn_argument_op op; ///< The operation needed to handle the argument
+    const dyn_type* type; ///< The argument type as declared, which can be a reference type
+    const dyn_type* serializeType; ///< The type to use for (de)serializing the argument, NULL for the handle
+    const dyn_type* freeType; ///< The type to use for releasing the argument value, NULL if a plain free is enough
+} dyn_argument_plan;
+
+typedef struct dyn_method_plan {
+    int index; ///< The index of the method in the interface
+    const char* id; ///< The signature of the method
+    const dyn_function_type* dynFunc; ///< The function type of the method
+    int nrOfArguments; ///< The number of arguments, including the handle and the output argument
+    int nrOfStandardArguments; ///< The number of arguments to deserialize from the request
+    const dyn_argument_plan* arguments; ///< The argument plans, ordered by argument index
+    const dyn_argument_plan* output; ///< The output argument plan or NULL if the method has no output argument
+} dyn_method_plan;
+
+/**
+ * @brief Creates an interface plan for the given dynamic interface type.
+ *
+ * The plan refers to the types and method ids of the given interface, so the interface must outlive the plan.
+ * The caller is the owner of the plan and the plan should be freed using dynInterfacePlan_destroy.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] intf The dynamic interface type instance.
+ * @param[out] out The created interface plan.
+ * @return 0 if successful, 1 otherwise.
+ */
+CELIX_DFI_EXPORT int dynInterfacePlan_create(const dyn_interface_type* intf, dyn_interface_plan** out);
+
+/**
+ * @brief Destroys the given interface plan.
+ * @param[in] plan The interface plan to destroy.
+ */
+CELIX_DFI_EXPORT void dynInterfacePlan_destroy(dyn_interface_plan* plan);
+
+CELIX_DEFINE_AUTOPTR_CLEANUP_FUNC(dyn_interface_plan, dynInterfacePlan_destroy);
+
+/**
+ * @brief Returns the dynamic interface type the plan was created for.
+ */
+CELIX_DFI_EXPORT const dyn_interface_type* dynInterfacePlan_interface(const dyn_interface_plan* plan);
+
+/**
+ * @brief Returns the number of methods in the given interface plan.
+ */
+CELIX_DFI_EXPORT int dynInterfacePlan_nrOfMethods(const dyn_interface_plan* plan);
+
+/**
+ * @brief Returns the method plan for the given method index or NULL if the index is out of range.
+ * The interface plan is the owner of the returned method plan and it should not be freed.
+ */
+CELIX_DFI_EXPORT const dyn_method_plan* dynInterfacePlan_methodForIndex(const dyn_interface_plan* plan, int index);
+
+/**
+ * @brief Finds the method plan for the given method id using a hash lookup.
+ * The interface plan is the owner of the returned method plan and it should not be freed.
+ *
+ * @param[in] plan The interface plan.
+ * @param[in] id The id of the method to find, which is currently the signature of the method.
+ * @return The method plan for the given method id, or NULL if no matching method is found.
+ */
+CELIX_DFI_EXPORT const dyn_method_plan* dynInterfacePlan_findMethod(const dyn_interface_plan* plan, const char* id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,6 +24,7 @@
 #include "dyn_type.h"
 #include "dyn_function.h"
 #include "dyn_interface.h"
+#include "dyn_interface_plan.h"
 #include "celix_dfi_export.h"
 
 #ifdef __cplusplus
@@ -46,6 +47,24 @@ extern "C" {
  */
 CELIX_DFI_EXPORT int jsonRpc_call(const dyn_interface_type* intf, void* service, const char* request, char** out);
 
+/**
+ * @brief Call a remote service using JSON-RPC and a precompiled interface plan.
+ *
+ * Same as jsonRpc_call, but the method is resolved with a hash lookup in the interface plan and the arguments are
+ * handled using the precompiled method plan instead of walking the dynamic types of the interface for every call.
+ *
+ * Caller is the owner of the out parameter and should release it using free.
+ *
+ * In case of an error, an error message is added to celix_err.
+ *
+ * @param[in] plan The interface plan of the service to call.
+ * @param[in] service The service to call.
+ * @param[in] request The JSON-RPC request to send.
+ * @param[out] out The JSON-RPC reply.
+ * @return 0 if successful, otherwise 1.
+ */
+CELIX_DFI_EXPORT int jsonRpc_callWithPlan(const dyn_interface_plan* plan, void* service, const char* request, char** out);
+
 /**
  * @brief Prepare a JSON-RPC request for a given function.
  *
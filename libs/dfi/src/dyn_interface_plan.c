@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "dyn_interface_plan.h"
+#include "dyn_interface_plan_common.h"
+#include "celix_err.h"
+#include "celix_stdlib_cleanup.h"
+#include "celix_string_hash_map.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const int OK = 0;
+static const int ERROR = 1;
+
+struct dyn_interface_plan {
+    const dyn_interface_type* intf;
+    int nrOfMethods;
+    dyn_method_plan* methods; //indexed by method index
+    dyn_argument_plan* arguments; //flat storage for the argument plans of all methods
+    celix_string_hash_map_t* methodsById; //key = method id (weak), value = dyn_method_plan*
+};
+
+static bool dynInterfacePlan_isConstText(const dyn_type* type) {
+    const char* isConst = dynType_getMetaInfo(type, "const");
+    return isConst != NULL && strcmp("true", isConst) == 0;
+}
+
+static void dynInterfacePlan_compileArgument(const dyn_function_argument_type* entry, dyn_argument_plan* arg) {
+    const dyn_type* realType = dynType_realType(entry->type);
+    arg->index = entry->index;
+    arg->argumentMeta = entry->argumentMeta;
+    arg->type = entry->type;
+    arg->serializeType = NULL;
+    arg->freeType = NULL;
+    switch (entry->argumentMeta) {
+        case DYN_FUNCTION_ARGUMENT_META__HANDLE:
+            arg->op = DYN_ARGUMENT_OP__HANDLE;
+            break;
+        case DYN_FUNCTION_ARGUMENT_META__STD:
+            arg->serializeType = entry->type;
+            if (dynType_descriptorType(realType) == 't') {
+                // the const meta info is on the original type, which could be a reference, rather than the real type
+                if (dynInterfacePlan_isConstText(entry->type)) {
+                    arg->op = DYN_ARGUMENT_OP__CONST_TEXT;
+                    arg->freeType = realType;
+                } else {
+                    //char* -> callee is owner, only the pointer holder needs to be freed
+                    arg->op = DYN_ARGUMENT_OP__TEXT;
+                }
+            } else {
+                arg->op = DYN_ARGUMENT_OP__VALUE;
+                arg->freeType = realType;
+            }
+            break;
+        case DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT:
+            arg->op = DYN_ARGUMENT_OP__PRE_ALLOCATED;
+            arg->serializeType = realType;
+            arg->freeType = dynType_typedPointer_getTypedType(realType);
+            break;
+        case DYN_FUNCTION_ARGUMENT_META__OUTPUT: {
+            const dyn_type* typedType = dynType_typedPointer_getTypedType(realType);
+            arg->serializeType = typedType;
+            if (dynType_descriptorType(typedType) == 't') {
+                arg->op = DYN_ARGUMENT_OP__OUTPUT_TEXT;
+            } else {
+                arg->op = DYN_ARGUMENT_OP__OUTPUT_VALUE;
+                arg->freeType = dynType_typedPointer_getTypedType(typedType);
+            }
+            break;
+        }
+    }
+}
+
+void dynInterfacePlan_compileMethod(const struct method_entry* method, dyn_argument_plan* arguments, dyn_method_plan* out) {
+    out->index = method->index;
+    out->id = method->id;
+    out->dynFunc = method->dynFunc;
+    out->nrOfArguments = 0;
+    out->nrOfStandardArguments = 0;
+    out->arguments = arguments;
+    out->output = NULL;
+
+    const dyn_function_argument_type* entry = NULL;
+    TAILQ_FOREACH(entry, dynFunction_arguments(method->dynFunc), entries) {
+        dyn_argument_plan* arg = &arguments[out->nrOfArguments++];
+        dynInterfacePlan_compileArgument(entry, arg);
+        if (arg->argumentMeta == DYN_FUNCTION_ARGUMENT_META__STD) {
+            out->nrOfStandardArguments += 1;
+        } else if (arg->argumentMeta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT ||
+                   arg->argumentMeta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
+            // dynInterface_parse ensures that an output argument can only be the last argument
+            out->output = arg;
+        }
+    }
+}
+
+int dynInterfacePlan_create(const dyn_interface_type* intf, dyn_interface_plan** out) {
+    celix_autofree dyn_interface_plan* plan = calloc(1, sizeof(*plan));
+    if (plan == NULL) {
+        celix_err_push("Error allocating memory for dynamic interface plan");
+        return ERROR;
+    }
+    plan->intf = intf;
+    plan->nrOfMethods = dynInterface_nrOfMethods(intf);
+
+    size_t nrOfArguments = 0;
+    const struct method_entry* entry = NULL;
+    TAILQ_FOREACH(entry, dynInterface_methods(intf), entries) {
+        nrOfArguments += dynFunction_nrOfArguments(entry->dynFunc);
+    }
+
+    celix_autofree dyn_method_plan* methods = calloc(plan->nrOfMethods > 0 ? plan->nrOfMethods : 1, sizeof(*methods));
+    celix_autofree dyn_argument_plan* arguments = calloc(nrOfArguments > 0 ? nrOfArguments : 1, sizeof(*arguments));
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.storeKeysWeakly = true; //method ids are owned by the interface type
+    opts.initialCapacity = (unsigned int)plan->nrOfMethods * 2;
+    celix_autoptr(celix_string_hash_map_t) methodsById = celix_stringHashMap_createWithOptions(&opts);
+    if (methods == NULL || arguments == NULL || methodsById == NULL) {
+        celix_err_push("Error allocating memory for dynamic interface plan methods");
+        return ERROR;
+    }
+
+    dyn_argument_plan* nextArguments = arguments;
+    TAILQ_FOREACH(entry, dynInterface_methods(intf), entries) {
+        dyn_method_plan* method = &methods[entry->index];
+        dynInterfacePlan_compileMethod(entry, nextArguments, method);
+        nextArguments += method->nrOfArguments;
+        if (celix_stringHashMap_hasKey(methodsById, method->id)) {
+            //keep the first method, same as the linear lookup of dynInterface_findMethod
+            continue;
+        }
+        if (celix_stringHashMap_put(methodsById, method->id, method) != CELIX_SUCCESS) {
+            celix_err_pushf("Error adding method %s to dynamic interface plan", method->id);
+            return ERROR;
+        }
+    }
+
+    plan->methods = celix_steal_ptr(methods);
+    plan->arguments = celix_steal_ptr(arguments);
+    plan->methodsById = celix_steal_ptr(methodsById);
+    *out = celix_steal_ptr(plan);
+    return OK;
+}
+
+void dynInterfacePlan_destroy(dyn_interface_plan* plan) {
+    if (plan != NULL) {
+        celix_stringHashMap_destroy(plan->methodsById);
+        free(plan->arguments);
+        free(plan->methods);
+        free(plan);
+    }
+}
+
+const dyn_interface_type* dynInterfacePlan_interface(const dyn_interface_plan* plan) {
+    return plan->intf;
+}
+
+int dynInterfacePlan_nrOfMethods(const dyn_interface_plan* plan) {
+    return plan->nrOfMethods;
+}
+
+const dyn_method_plan* dynInterfacePlan_methodForIndex(const dyn_interface_plan* plan, int index) {
+    if (index < 0 || index >= plan->nrOfMethods) {
+        return NULL;
+    }
+    return &plan->methods[index];
+}
+
+const dyn_method_plan* dynInterfacePlan_findMethod(const dyn_interface_plan* plan, const char* id) {
+    return celix_stringHashMap_get(plan->methodsById, id);
+}
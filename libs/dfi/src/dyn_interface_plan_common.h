@@ -16,22 +16,26 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-//TODO: Move it to libs/error_injector and use conan to import thpool
-#include "thpool_ei.h"
 
+#ifndef _DYN_INTERFACE_PLAN_COMMON_H_
+#define _DYN_INTERFACE_PLAN_COMMON_H_
+
+#include "dyn_interface_plan.h"
+
+#ifdef __cplusplus
 extern "C" {
-struct thpool_* __real_thpool_init(int num_threads);
-CELIX_EI_DEFINE(thpool_init, struct thpool_*)
-struct thpool_* __wrap_thpool_init(int num_threads) {
-    CELIX_EI_IMPL(thpool_init);
-    return __real_thpool_init(num_threads);
-}
+#endif
+
+/**
+ * @brief Compiles a single method entry into a method plan.
+ *
+ * The provided argument plan storage must be able to hold dynFunction_nrOfArguments(method->dynFunc) entries.
+ * This makes it possible to compile a method plan on the stack when no interface plan is available.
+ */
+void dynInterfacePlan_compileMethod(const struct method_entry* method, dyn_argument_plan* arguments, dyn_method_plan* out);
 
-int __real_thpool_add_work(struct thpool_* thpool_p, void (*function_p)(void*), void* arg_p);
-CELIX_EI_DEFINE(thpool_add_work, int)
-int __wrap_thpool_add_work(struct thpool_* thpool_p, void (*function_p)(void*), void* arg_p) {
-    CELIX_EI_IMPL(thpool_add_work);
-    return __real_thpool_add_work(thpool_p, function_p, arg_p);
+#ifdef __cplusplus
 }
+#endif
 
-}
\ No newline at end of file
+#endif
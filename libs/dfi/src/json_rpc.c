@@ -21,6 +21,8 @@
 #include "json_serializer.h"
 #include "dyn_type.h"
 #include "dyn_interface.h"
+#include "dyn_interface_plan.h"
+#include "dyn_interface_plan_common.h"
 #include "dyn_type_common.h"
 #include "celix_cleanup.h"
 #include "celix_err.h"
@@ -43,117 +45,106 @@ struct generic_service_layout {
 };
 
 typedef struct celix_rpc_args {
-    const struct dyn_function_arguments_head* dynArgs;
+    const dyn_method_plan* method;
     void* args[CELIX_JSON_RPC_MAX_ARGS];
 }celix_rpc_args_t;
 
 static void celix_rpcArgs_cleanup(celix_rpc_args_t* args) {
-    const struct dyn_function_arguments_head* dynArgs = args->dynArgs;
-    if (dynArgs == NULL) {
+    const dyn_method_plan* method = args->method;
+    if (method == NULL) {
         return;
     }
-    dyn_function_argument_type* entry = NULL;
-    TAILQ_FOREACH(entry, dynArgs, entries) {
-        const dyn_type* argType = dynType_realType(entry->type);
-        enum dyn_function_argument_meta meta = entry->argumentMeta;
-        if (meta == DYN_FUNCTION_ARGUMENT_META__STD) {
-            if (dynType_descriptorType(argType) == 't') {
-                const char* isConst = dynType_getMetaInfo(entry->type, "const");
-                if (isConst != NULL && strncmp("true", isConst, 5) == 0) {
-                    dynType_free(argType, args->args[entry->index]);
-                } else {
-                    //char* -> callee is now owner, no free for char seq needed
-                    //will free the actual pointer
-                    free(args->args[entry->index]);
-                }
-            } else {
-                dynType_free(argType, args->args[entry->index]);
-            }
-        } else if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
-            const dyn_type* subType = dynType_typedPointer_getTypedType(argType);
-            dynType_free(subType, *(void**)(args->args[entry->index]));
-        } else if (meta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
-            const dyn_type* typedType = dynType_typedPointer_getTypedType(argType);
-            if (dynType_descriptorType(typedType) == 't') {
-                free(**(void***)args->args[entry->index]);
-            } else {
-                const dyn_type* typedTypedType = dynType_typedPointer_getTypedType(typedType);
-                dynType_free(typedTypedType, **(void***)args->args[entry->index]);
-            }
+    for (int i = 0; i < method->nrOfArguments; ++i) {
+        const dyn_argument_plan* arg = &method->arguments[i];
+        void* value = args->args[arg->index];
+        switch (arg->op) {
+            case DYN_ARGUMENT_OP__VALUE:
+            case DYN_ARGUMENT_OP__CONST_TEXT:
+                dynType_free(arg->freeType, value);
+                break;
+            case DYN_ARGUMENT_OP__TEXT:
+                //char* -> callee is now owner, no free for char seq needed
+                //will free the actual pointer
+                free(value);
+                break;
+            case DYN_ARGUMENT_OP__PRE_ALLOCATED:
+                dynType_free(arg->freeType, *(void**)value);
+                break;
+            case DYN_ARGUMENT_OP__OUTPUT_TEXT:
+                free(**(void***)value);
+                break;
+            case DYN_ARGUMENT_OP__OUTPUT_VALUE:
+                dynType_free(arg->freeType, **(void***)value);
+                break;
+            default:
+                break;
         }
     }
-    args->dynArgs = NULL;
+    args->method = NULL;
 }
 
 CELIX_DEFINE_AUTO_CLEANUP_CLEAR_FUNC(celix_rpc_args_t, celix_rpcArgs_cleanup)
 
-int jsonRpc_call(const dyn_interface_type* intf, void* service, const char* request, char** out) {
-    int status = OK;
-
+static int jsonRpc_parseRequest(const char* request, json_t** jsRequestOut, const char** sigOut, json_t** argumentsOut) {
     json_error_t error;
     json_auto_t* js_request = json_loads(request, 0, &error);
     if (js_request == NULL) {
         celix_err_pushf("Got json error: %s", error.text);
         return ERROR;
     }
-    json_t* arguments = NULL;
     const char* sig;
     if (json_unpack(js_request, "{s:s}", "m", &sig) != 0) {
         celix_err_push("Error getting method signature");
         return ERROR;
     }
-    arguments = json_object_get(js_request, "a");
+    json_t* arguments = json_object_get(js_request, "a");
     if (arguments == NULL || !json_is_array(arguments)) {
         celix_err_pushf("Error getting arguments array for %s", sig);
         return ERROR;
     }
+    *sigOut = sig;
+    *argumentsOut = arguments;
+    *jsRequestOut = celix_steal_ptr(js_request);
+    return OK;
+}
 
-    const struct method_entry* method = dynInterface_findMethod(intf, sig);
-    if (method == NULL) {
-        celix_err_pushf("Cannot find method with sig '%s'", sig);
-        return ERROR;
-    }
-
+static int jsonRpc_callMethod(const dyn_method_plan* method, void* service, json_t* arguments, char** out) {
+    int status = OK;
+    const char* sig = method->id;
     struct generic_service_layout* serv = service;
-    const struct dyn_function_arguments_head* dynArgs = dynFunction_arguments(method->dynFunc);
-    const dyn_function_argument_type* last = TAILQ_LAST(dynArgs, dyn_function_arguments_head);
-    int nrOfArgs = dynFunction_nrOfArguments(method->dynFunc);
-    if (nrOfArgs > CELIX_JSON_RPC_MAX_ARGS) {
-        celix_err_pushf("Too many arguments for %s: %d > %d", sig, nrOfArgs, CELIX_JSON_RPC_MAX_ARGS);
+    if (method->nrOfArguments > CELIX_JSON_RPC_MAX_ARGS) {
+        celix_err_pushf("Too many arguments for %s: %d > %d", sig, method->nrOfArguments, CELIX_JSON_RPC_MAX_ARGS);
         return ERROR;
     }
     void* ptr = NULL;
     void* ptrToPtr = &ptr;
-    celix_auto(celix_rpc_args_t) rpcArgs = { dynArgs, {0} };
+    celix_auto(celix_rpc_args_t) rpcArgs = { method, {0} };
 
     rpcArgs.args[0] = &serv->handle;
-    --nrOfArgs;
-    if (last->argumentMeta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
-        const dyn_type *subType = dynType_typedPointer_getTypedType(dynType_realType(last->type));
-        rpcArgs.args[last->index] = &ptr;
-        if ((status = dynType_alloc(subType, &ptr)) != OK) {
+    const dyn_argument_plan* output = method->output;
+    if (output != NULL && output->op == DYN_ARGUMENT_OP__PRE_ALLOCATED) {
+        rpcArgs.args[output->index] = &ptr;
+        if ((status = dynType_alloc(output->freeType, &ptr)) != OK) {
             celix_err_pushf("Error allocating memory for pre-allocated output argument of %s", sig);
             return ERROR;
         }
-        --nrOfArgs;
-    } else if (last->argumentMeta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
-        rpcArgs.args[last->index] = &ptrToPtr;
-        --nrOfArgs;
+    } else if (output != NULL) {
+        rpcArgs.args[output->index] = &ptrToPtr;
     }
-    if ((size_t)nrOfArgs != json_array_size(arguments)) {
+    if ((size_t)method->nrOfStandardArguments != json_array_size(arguments)) {
         celix_err_pushf("Wrong number of standard arguments for %s. Expected %d, got %zu",
-                        sig, nrOfArgs, json_array_size(arguments));
+                        sig, method->nrOfStandardArguments, json_array_size(arguments));
         return ERROR;
     }
     //setup and deserialize input
-    dyn_function_argument_type* entry = NULL;
-    TAILQ_FOREACH(entry, dynArgs, entries) {
-        if (entry->argumentMeta != DYN_FUNCTION_ARGUMENT_META__STD) {
+    for (int i = 0; i < method->nrOfArguments; ++i) {
+        const dyn_argument_plan* arg = &method->arguments[i];
+        if (arg->argumentMeta != DYN_FUNCTION_ARGUMENT_META__STD) {
             continue;
         }
-        status = jsonSerializer_deserializeJson(entry->type, json_array_get(arguments, entry->index-1), &(rpcArgs.args[entry->index]));
+        status = jsonSerializer_deserializeJson(arg->serializeType, json_array_get(arguments, arg->index-1), &(rpcArgs.args[arg->index]));
         if (status != OK) {
-            celix_err_pushf("Error deserializing argument %d for %s", entry->index, sig);
+            celix_err_pushf("Error deserializing argument %d for %s", arg->index, sig);
             return status;
         }
     }
@@ -163,12 +154,11 @@ int jsonRpc_call(const dyn_interface_type* intf, void* service, const char* requ
     int funcCallStatus = (int)returnVal;
     //serialize output
     json_auto_t* jsonResult = NULL;
-    if (funcCallStatus == 0) {
-        const dyn_type* argType = dynType_realType(last->type);
-        if (last->argumentMeta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
-            status = jsonSerializer_serializeJson(argType, rpcArgs.args[last->index], &jsonResult);
-        } else if (last->argumentMeta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
-            status = jsonSerializer_serializeJson(dynType_typedPointer_getTypedType(argType), (void*) &ptr, &jsonResult);
+    if (funcCallStatus == 0 && output != NULL) {
+        if (output->op == DYN_ARGUMENT_OP__PRE_ALLOCATED) {
+            status = jsonSerializer_serializeJson(output->serializeType, rpcArgs.args[output->index], &jsonResult);
+        } else {
+            status = jsonSerializer_serializeJson(output->serializeType, (void*) &ptr, &jsonResult);
         }
         if (status != OK) {
             celix_err_pushf("Error serializing result for %s", sig);
@@ -194,6 +184,47 @@ int jsonRpc_call(const dyn_interface_type* intf, void* service, const char* requ
     return (*out != NULL) ? OK : ERROR;
 }
 
+int jsonRpc_call(const dyn_interface_type* intf, void* service, const char* request, char** out) {
+    json_auto_t* js_request = NULL;
+    const char* sig = NULL;
+    json_t* arguments = NULL;
+    if (jsonRpc_parseRequest(request, &js_request, &sig, &arguments) != OK) {
+        return ERROR;
+    }
+
+    const struct method_entry* entry = dynInterface_findMethod(intf, sig);
+    if (entry == NULL) {
+        celix_err_pushf("Cannot find method with sig '%s'", sig);
+        return ERROR;
+    }
+    int nrOfArgs = dynFunction_nrOfArguments(entry->dynFunc);
+    if (nrOfArgs > CELIX_JSON_RPC_MAX_ARGS) {
+        celix_err_pushf("Too many arguments for %s: %d > %d", sig, nrOfArgs, CELIX_JSON_RPC_MAX_ARGS);
+        return ERROR;
+    }
+    //no interface plan available, compile a plan for this method only
+    dyn_argument_plan argumentPlans[CELIX_JSON_RPC_MAX_ARGS];
+    dyn_method_plan method;
+    dynInterfacePlan_compileMethod(entry, argumentPlans, &method);
+    return jsonRpc_callMethod(&method, service, arguments, out);
+}
+
+int jsonRpc_callWithPlan(const dyn_interface_plan* plan, void* service, const char* request, char** out) {
+    json_auto_t* js_request = NULL;
+    const char* sig = NULL;
+    json_t* arguments = NULL;
+    if (jsonRpc_parseRequest(request, &js_request, &sig, &arguments) != OK) {
+        return ERROR;
+    }
+
+    const dyn_method_plan* method = dynInterfacePlan_findMethod(plan, sig);
+    if (method == NULL) {
+        celix_err_pushf("Cannot find method with sig '%s'", sig);
+        return ERROR;
+    }
+    return jsonRpc_callMethod(method, service, arguments, out);
+}
+
 int jsonRpc_prepareInvokeRequest(const dyn_function_type* func, const char* id, void* args[], char** out) {
     json_auto_t* invoke = json_object();
     // each method must have a non-null id
@@ -23,6 +23,8 @@
 
 namespace celix {
 
+    class PromiseFactory;
+
     /**
      * @brief A Promise of a value.
      *
@@ -421,9 +423,8 @@ namespace celix {
          * @param <R>    The value type associated with the returned Promise.
          * @return A Promise that returns the value of this Promise as mapped by the specified Function.
          */
-//        TODO
-//        template<typename R>
-//        [[nodiscard]] celix::Promise<R> flatMap(std::function<celix::Promise<R>(T)> mapper);
+        template<typename R>
+        [[nodiscard]] celix::Promise<R> flatMap(std::function<celix::Promise<R>(T)> mapper);
 
         /**
          * @brief Chain a new Promise to this Promise with success and failure callbacks.
@@ -482,7 +483,8 @@ namespace celix {
     private:
         std::shared_ptr<celix::impl::SharedPromiseState<T>> state;
 
-        friend class Promise<void>;
+        template<typename> friend class Promise;
+        friend class PromiseFactory;
     };
 
 
@@ -538,6 +540,9 @@ namespace celix {
         template<typename R>
         [[nodiscard]] celix::Promise<R> map(std::function<R()> mapper);
 
+        template<typename R>
+        [[nodiscard]] celix::Promise<R> flatMap(std::function<celix::Promise<R>()> mapper);
+
         template<typename Rep, typename Period>
         [[nodiscard]] Promise<void> timeout(std::chrono::duration<Rep, Period> duration);
 
@@ -551,6 +556,9 @@ namespace celix {
         [[nodiscard]] celix::Promise<U> then(std::function<celix::Promise<U>(celix::Promise<void>)> success, std::function<void(celix::Promise<void>)> failure = {});
     private:
         std::shared_ptr<celix::impl::SharedPromiseState<void>> state;
+
+        template<typename> friend class Promise;
+        friend class PromiseFactory;
     };
 }
 
@@ -780,4 +788,47 @@ inline celix::Promise<U> celix::Promise<void>::then(std::function<celix::Promise
     };
     state->addChain(std::move(chain));
     return celix::Promise<U>{p};
-}
\ No newline at end of file
+}
+
+template<typename T>
+template<typename R>
+inline celix::Promise<R> celix::Promise<T>::flatMap(std::function<celix::Promise<R>(T)> mapper) {
+    if (!mapper) {
+        throw celix::PromiseInvocationException("provided mapper is not valid");
+    }
+    auto p = celix::impl::SharedPromiseState<R>::create(state->getExecutor(), state->getScheduledExecutor(), state->getPriority());
+    state->addChain([s = state, p, mapper = std::move(mapper)] {
+        if (s->isSuccessfullyResolved()) {
+            try {
+                auto mapped = mapper(s->moveOrGetValue());
+                p->resolveWith(*mapped.state);
+            } catch (...) {
+                p->tryFail(std::current_exception());
+            }
+        } else {
+            p->tryFail(s->getFailure());
+        }
+    });
+    return celix::Promise<R>{p};
+}
+
+template<typename R>
+inline celix::Promise<R> celix::Promise<void>::flatMap(std::function<celix::Promise<R>()> mapper) {
+    if (!mapper) {
+        throw celix::PromiseInvocationException("provided mapper is not valid");
+    }
+    auto p = celix::impl::SharedPromiseState<R>::create(state->getExecutor(), state->getScheduledExecutor(), state->getPriority());
+    state->addChain([s = state, p, mapper = std::move(mapper)] {
+        if (s->isSuccessfullyResolved()) {
+            try {
+                auto mapped = mapper();
+                p->resolveWith(*mapped.state);
+            } catch (...) {
+                p->tryFail(std::current_exception());
+            }
+        } else {
+            p->tryFail(s->getFailure());
+        }
+    });
+    return celix::Promise<R>{p};
+}
@@ -19,10 +19,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <optional>
+#include <vector>
+
 #include "celix/Deferred.h"
 #include "celix/IExecutor.h"
 #include "celix/DefaultExecutor.h"
+#include "celix/ThreadPoolExecutor.h"
 #include "celix/DefaultScheduledExecutor.h"
+#include "celix/TimerScheduledExecutor.h"
 
 namespace celix {
 
@@ -30,9 +36,18 @@ namespace celix {
     //TODO documentation
     class PromiseFactory {
     public:
+        /**
+         * @brief Creates a promise factory.
+         * @param _executor The executor used for the promise callbacks and deferred tasks. Defaults to a
+         *                  celix::DefaultExecutor, which runs every task on its own thread, so continuations can block
+         *                  (e.g. call getValue on another promise). A celix::ThreadPoolExecutor can be provided for
+         *                  bounded threads, but then blocking continuations can exhaust its workers.
+         * @param _scheduledExecutor The scheduled executor used for timeouts and delays. If nullptr, a
+         *                           celix::TimerScheduledExecutor which executes the due tasks on _executor is created.
+         */
         explicit PromiseFactory(
                 std::shared_ptr<celix::IExecutor> _executor = std::make_shared<celix::DefaultExecutor>(),
-                std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor = std::make_shared<celix::DefaultScheduledExecutor>());
+                std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor = nullptr);
 
         ~PromiseFactory() noexcept;
 
@@ -63,6 +78,54 @@ namespace celix {
 
         [[nodiscard]] celix::Promise<void> resolvedWithPrio(int priority) const;
 
+        /**
+         * @brief Returns a promise which is resolved with the values of the provided promises (in the same order)
+         * when all provided promises are successfully resolved.
+         *
+         * The returned promise fails with the failure of the first provided promise that fails.
+         * If no promises are provided, the returned promise is resolved with an empty vector.
+         *
+         * The fan-in is done with a single atomic countdown; no thread blocks waiting for the provided promises.
+         * Note that the values are copied from the provided promises, unless T is not copy constructible.
+         * In that case the values are moved out of the provided promises (as with Promise::moveOrGetValue), which
+         * makes the provided promises unusable: getting their value throws a celix::PromiseInvocationException.
+         */
+        template<typename T>
+        [[nodiscard]] celix::Promise<std::vector<T>> all(const std::vector<celix::Promise<T>>& promises, int priority = 0) const;
+
+        /**
+         * @brief Returns a promise which is resolved when all provided promises are successfully resolved.
+         *
+         * The returned promise fails with the failure of the first provided promise that fails.
+         * If no promises are provided, the returned promise is resolved.
+         */
+        [[nodiscard]] celix::Promise<void> all(const std::vector<celix::Promise<void>>& promises, int priority = 0) const;
+
+        /**
+         * @brief Returns a promise which is resolved with the value of the first provided promise that is
+         * successfully resolved.
+         *
+         * The returned promise only fails if all provided promises fail, with the failure of the last failed promise.
+         * If no promises are provided, the returned promise fails with a celix::PromiseInvocationException.
+         *
+         * If T is not copy constructible, the value of every successfully resolved provided promise is moved out
+         * (also the values that are not used for the returned promise), so the provided promises are consumed.
+         */
+        template<typename T>
+        [[nodiscard]] celix::Promise<T> any(const std::vector<celix::Promise<T>>& promises, int priority = 0) const;
+
+        /**
+         * @brief Returns a promise which is resolved with the value or failure of the first provided promise that
+         * is resolved.
+         *
+         * If no promises are provided, the returned promise fails with a celix::PromiseInvocationException.
+         *
+         * If T is not copy constructible, the value of every successfully resolved provided promise is moved out
+         * (also the values that are not used for the returned promise), so the provided promises are consumed.
+         */
+        template<typename T>
+        [[nodiscard]] celix::Promise<T> race(const std::vector<celix::Promise<T>>& promises, int priority = 0) const;
+
         [[nodiscard]] std::shared_ptr<celix::IExecutor> getExecutor() const;
 
         [[nodiscard]] std::shared_ptr<celix::IScheduledExecutor> getScheduledExecutor() const;
@@ -86,7 +149,7 @@ inline celix::PromiseFactory::PromiseFactory(
         std::shared_ptr<celix::IExecutor> _executor,
         std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor) :
         executor{std::move(_executor)},
-        scheduledExecutor{std::move(_scheduledExecutor)} {}
+        scheduledExecutor{_scheduledExecutor ? std::move(_scheduledExecutor) : std::make_shared<celix::TimerScheduledExecutor>(executor)} {}
 
 inline celix::PromiseFactory::~PromiseFactory() noexcept {
     //ensure that the executors tasks are empty before allowing the to be deallocated.
@@ -144,6 +207,120 @@ inline celix::Promise<void> celix::PromiseFactory::resolvedWithPrio(int priority
     return def.getPromise();
 }
 
+template<typename T>
+celix::Promise<std::vector<T>> celix::PromiseFactory::all(const std::vector<celix::Promise<T>>& promises, int priority) const {
+    auto result = celix::impl::SharedPromiseState<std::vector<T>>::create(executor, scheduledExecutor, priority);
+    if (promises.empty()) {
+        result->tryResolve(std::vector<T>{});
+        return celix::Promise<std::vector<T>>{result};
+    }
+
+    struct Join {
+        explicit Join(std::size_t n) : remaining{n}, values(n) {}
+        std::atomic<std::size_t> remaining;
+        std::vector<std::optional<T>> values;
+    };
+    auto join = std::make_shared<Join>(promises.size());
+    for (std::size_t i = 0; i < promises.size(); ++i) {
+        auto& s = promises[i].state;
+        s->addChain([s, i, join, result] {
+            if (!s->isSuccessfullyResolved()) {
+                result->tryFail(s->getFailure());
+                return;
+            }
+            if constexpr (std::is_copy_constructible_v<T>) {
+                join->values[i].emplace(s->getValue());
+            } else {
+                join->values[i].emplace(s->moveOrGetValue());
+            }
+            //note the acq_rel countdown ensures that the last resolver sees all values
+            if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::vector<T> values{};
+                values.reserve(join->values.size());
+                for (auto& value : join->values) {
+                    values.emplace_back(std::move(*value));
+                }
+                result->tryResolve(std::move(values));
+            }
+        });
+    }
+    return celix::Promise<std::vector<T>>{result};
+}
+
+inline celix::Promise<void> celix::PromiseFactory::all(const std::vector<celix::Promise<void>>& promises, int priority) const {
+    auto result = celix::impl::SharedPromiseState<void>::create(executor, scheduledExecutor, priority);
+    if (promises.empty()) {
+        result->tryResolve();
+        return celix::Promise<void>{result};
+    }
+
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(promises.size());
+    for (const auto& promise : promises) {
+        auto& s = promise.state;
+        s->addChain([s, remaining, result] {
+            if (!s->isSuccessfullyResolved()) {
+                result->tryFail(s->getFailure());
+            } else if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                result->tryResolve();
+            }
+        });
+    }
+    return celix::Promise<void>{result};
+}
+
+template<typename T>
+celix::Promise<T> celix::PromiseFactory::any(const std::vector<celix::Promise<T>>& promises, int priority) const {
+    auto result = celix::impl::SharedPromiseState<T>::create(executor, scheduledExecutor, priority);
+    if (promises.empty()) {
+        result->tryFail(celix::PromiseInvocationException{"Cannot resolve any of an empty list of promises"});
+        return celix::Promise<T>{result};
+    }
+
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(promises.size());
+    for (const auto& promise : promises) {
+        auto& s = promise.state;
+        s->addChain([s, remaining, result] {
+            if (s->isSuccessfullyResolved()) {
+                if constexpr (std::is_void_v<T>) {
+                    result->tryResolve();
+                } else if constexpr (std::is_copy_constructible_v<T>) {
+                    result->tryResolve(s->getValue());
+                } else {
+                    result->tryResolve(s->moveOrGetValue());
+                }
+            } else if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                result->tryFail(s->getFailure());
+            }
+        });
+    }
+    return celix::Promise<T>{result};
+}
+
+template<typename T>
+celix::Promise<T> celix::PromiseFactory::race(const std::vector<celix::Promise<T>>& promises, int priority) const {
+    auto result = celix::impl::SharedPromiseState<T>::create(executor, scheduledExecutor, priority);
+    if (promises.empty()) {
+        result->tryFail(celix::PromiseInvocationException{"Cannot race an empty list of promises"});
+        return celix::Promise<T>{result};
+    }
+
+    for (const auto& promise : promises) {
+        auto& s = promise.state;
+        s->addChain([s, result] {
+            if (!s->isSuccessfullyResolved()) {
+                result->tryFail(s->getFailure());
+            } else if constexpr (std::is_void_v<T>) {
+                result->tryResolve();
+            } else if constexpr (std::is_copy_constructible_v<T>) {
+                result->tryResolve(s->getValue());
+            } else {
+                result->tryResolve(s->moveOrGetValue());
+            }
+        });
+    }
+    return celix::Promise<T>{result};
+}
+
 inline std::shared_ptr<celix::IExecutor> celix::PromiseFactory::getExecutor() const {
     return executor;
 }
@@ -0,0 +1,312 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "celix/Task.h requires C++20 coroutine support, link against Celix::PromisesCoroutines"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "celix/Deferred.h"
+#include "celix/Promise.h"
+#include "celix/PromiseFactory.h"
+
+namespace celix {
+
+    template<typename T = void>
+    class Task;
+
+    namespace impl {
+
+        /**
+         * @brief Awaiter for a celix::Promise.
+         *
+         * If the promise is not yet resolved, the awaiting coroutine is resumed as a callback of the promise, so on
+         * the executor of the promise. A failed promise rethrows its (original) failure in the awaiting coroutine.
+         */
+        template<typename T>
+        class PromiseAwaiter {
+        public:
+            explicit PromiseAwaiter(celix::Promise<T> _promise) : promise{std::move(_promise)} {}
+
+            [[nodiscard]] bool await_ready() const {
+                return promise.isDone();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                //note the coroutine can be resumed on another thread before onResolve returns
+                promise.onResolve([handle] { handle.resume(); });
+            }
+
+            T await_resume() {
+                if (!promise.isSuccessfullyResolved()) {
+                    std::rethrow_exception(promise.getFailure());
+                }
+                if constexpr (std::is_void_v<T>) {
+                    return;
+                } else if constexpr (std::is_copy_constructible_v<T>) {
+                    return promise.getValue();
+                } else {
+                    return promise.moveOrGetValue();
+                }
+            }
+        private:
+            celix::Promise<T> promise;
+        };
+
+        template<typename T>
+        class TaskResult {
+        public:
+            template<typename U>
+            void return_value(U&& val) {
+                value.emplace(std::forward<U>(val));
+            }
+
+        protected:
+            void resolve(celix::Deferred<T>& deferred) {
+                deferred.resolve(std::move(*value));
+            }
+
+            T takeValue() {
+                return std::move(*value);
+            }
+
+            std::optional<T> value{};
+        };
+
+        template<>
+        class TaskResult<void> {
+        public:
+            void return_void() {}
+
+        protected:
+            static void resolve(celix::Deferred<void>& deferred) {
+                deferred.resolve();
+            }
+
+            static void takeValue() {}
+        };
+
+        /**
+         * @brief The promise type of the celix::Task coroutine.
+         *
+         * A task is lazily started. When completed, the task resumes the coroutine awaiting it (symmetric
+         * transfer) or, if the task is started with celix::Task::start, resolves the deferred of the started task and
+         * destroys the coroutine frame.
+         */
+        template<typename T>
+        class TaskPromise : public TaskResult<T> {
+        public:
+            celix::Task<T> get_return_object() noexcept;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            auto final_suspend() noexcept {
+                struct FinalAwaiter {
+                    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<TaskPromise> handle) noexcept {
+                        return handle.promise().complete(handle);
+                    }
+
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+
+            void unhandled_exception() noexcept {
+                exception = std::current_exception();
+            }
+
+            void setContinuation(std::coroutine_handle<> handle) {
+                continuation = handle;
+            }
+
+            void setDeferred(celix::Deferred<T> def) {
+                deferred.emplace(std::move(def));
+            }
+
+            T result() {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+                return this->takeValue();
+            }
+        private:
+            std::coroutine_handle<> complete(std::coroutine_handle<TaskPromise> handle) noexcept {
+                if (continuation) {
+                    return continuation;
+                }
+                if (deferred) {
+                    try {
+                        if (exception) {
+                            deferred->fail(exception);
+                        } else {
+                            this->resolve(*deferred);
+                        }
+                    } catch (...) {
+                        //note the continuations of the promise could not be executed (executor rejected them).
+                    }
+                    handle.destroy();
+                }
+                return std::noop_coroutine();
+            }
+
+            std::coroutine_handle<> continuation{};
+            std::exception_ptr exception{};
+            std::optional<celix::Deferred<T>> deferred{};
+        };
+    }
+
+    /**
+     * @brief A lazily started coroutine which produces a value of type T (or an exception).
+     *
+     * A task can be awaited by another coroutine, in which case the task runs on the thread of the awaiting coroutine
+     * and the awaiting coroutine is resumed directly when the task completes. A task can also be started on the
+     * executor of a promise factory, which returns a celix::Promise for the result of the task.
+     *
+     * In a task (or any other coroutine) a celix::Promise and a celix::Deferred can be awaited. If the promise is not
+     * yet resolved, the coroutine is resumed on the executor of the promise. This makes it possible to write a
+     * sequence of asynchronous calls linearly, with a single coroutine frame instead of a promise state and
+     * std::function per step:
+     * @code
+     * celix::Task<std::string> fetchName(RemoteService& service, long id) {
+     *     auto key = co_await service.lookup(id);
+     *     auto record = co_await service.fetch(key);
+     *     co_return record.name;
+     * }
+     *
+     * celix::Promise<std::string> promise = fetchName(service, 42).start(factory);
+     * @endcode
+     *
+     * A task can only be awaited or started once.
+     * Requires C++20, use the Celix::PromisesCoroutines target (CMake option PROMISES_COROUTINES).
+     */
+    template<typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = celix::impl::TaskPromise<T>;
+
+        Task(Task&& rhs) noexcept : handle{std::exchange(rhs.handle, {})} {}
+
+        Task& operator=(Task&& rhs) noexcept {
+            if (this != &rhs) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(rhs.handle, {});
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() noexcept {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        /**
+         * @brief Whether this task still refers to a coroutine, i.e. it is not moved and not started.
+         */
+        [[nodiscard]] bool isValid() const {
+            return static_cast<bool>(handle);
+        }
+
+        /**
+         * @brief Starts the task on the executor of the provided promise factory.
+         *
+         * The coroutine frame is destroyed when the task completes.
+         * @return A promise which is resolved with the result (or failure) of the task.
+         * @throws celix::PromiseInvocationException if the task is not valid.
+         * @throws celix::RejectedExecutionException if the executor rejects the task.
+         */
+        celix::Promise<T> start(const celix::PromiseFactory& factory, int priority = 0) && {
+            if (!handle) {
+                throw celix::PromiseInvocationException{"Cannot start an invalid task"};
+            }
+            auto deferred = factory.deferred<T>(priority);
+            auto h = std::exchange(handle, {});
+            h.promise().setDeferred(deferred);
+            try {
+                factory.getExecutor()->execute(priority, [h] { h.resume(); });
+            } catch (...) {
+                h.destroy();
+                throw;
+            }
+            return deferred.getPromise();
+        }
+
+        auto operator co_await() noexcept {
+            struct TaskAwaiter {
+                [[nodiscard]] bool await_ready() const noexcept {
+                    return !handle || handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().setContinuation(awaiting);
+                    return handle;
+                }
+
+                T await_resume() {
+                    if (!handle) {
+                        throw celix::PromiseInvocationException{"Cannot await an invalid task"};
+                    }
+                    return handle.promise().result();
+                }
+
+                std::coroutine_handle<promise_type> handle;
+            };
+            return TaskAwaiter{handle};
+        }
+    private:
+        friend promise_type;
+
+        explicit Task(std::coroutine_handle<promise_type> _handle) : handle{_handle} {}
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    template<typename T>
+    celix::impl::PromiseAwaiter<T> operator co_await(celix::Promise<T> promise) {
+        return celix::impl::PromiseAwaiter<T>{std::move(promise)};
+    }
+
+    template<typename T>
+    celix::impl::PromiseAwaiter<T> operator co_await(celix::Deferred<T> deferred) {
+        return celix::impl::PromiseAwaiter<T>{deferred.getPromise()};
+    }
+}
+
+/*********************************************************************************
+ Implementation
+*********************************************************************************/
+
+template<typename T>
+celix::Task<T> celix::impl::TaskPromise<T>::get_return_object() noexcept {
+    return celix::Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
@@ -0,0 +1,384 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "celix/IExecutor.h"
+
+namespace celix {
+
+    /**
+     * @brief An elastic thread pool executor with per-worker task queues and work stealing.
+     *
+     * Tasks submitted from a thread that is not a worker of the executor are added to a shared injection queue.
+     * Tasks submitted from a worker thread, e.g. the continuation of a promise resolved in a task, are added to the
+     * task queue of that worker, so that related tasks stay on the same thread and no shared lock is needed.
+     * An idle worker first takes tasks from its own queue, then from the injection queue and then steals tasks from the
+     * queues of the other workers.
+     *
+     * The priority argument is honored: every queue is ordered on priority (higher value first) and, for equal priority,
+     * on submission order. Because tasks are spread over multiple queues, the priority order is a best effort and not
+     * a strict global ordering.
+     *
+     * The pool is elastic: a worker thread is started if a task is submitted and no worker is idle, up to the
+     * configured max number of threads. Workers above the configured min number of threads stop after being idle for
+     * the configured idle timeout. Because tasks can block (e.g. waiting on a promise), the max number of threads should
+     * be large enough to avoid a starvation deadlock.
+     */
+    class ThreadPoolExecutor : public celix::IExecutor {
+    public:
+        /**
+         * @brief Creates a thread pool executor.
+         * @param minThreads The number of workers kept alive when idle. Workers are started lazily.
+         * @param maxThreads The max number of workers. If 0, the max is 4 times the hardware concurrency with a minimum
+         *                   of 16 threads.
+         * @param idleTimeout The time an idle worker above minThreads waits for new tasks before stopping.
+         */
+        explicit ThreadPoolExecutor(std::size_t minThreads = 1,
+                                    std::size_t maxThreads = 0,
+                                    std::chrono::milliseconds idleTimeout = std::chrono::milliseconds{5000});
+
+        ~ThreadPoolExecutor() noexcept override;
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor(ThreadPoolExecutor&&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(ThreadPoolExecutor&&) = delete;
+
+        using celix::IExecutor::execute;
+
+        void execute(int priority, std::function<void()> task) override;
+
+        /**
+         * @brief Wait until all submitted tasks, including tasks submitted by running tasks, are executed.
+         */
+        void wait() override;
+
+        /**
+         * @brief Returns the number of started worker threads.
+         */
+        [[nodiscard]] std::size_t getNrOfThreads() const;
+
+        /**
+         * @brief Returns the number of submitted tasks which are not yet executed, including the running tasks.
+         */
+        [[nodiscard]] std::size_t getNrOfPendingTasks() const;
+
+        /**
+         * @brief Returns the number of tasks which are stolen from the queue of another worker.
+         */
+        [[nodiscard]] std::size_t getNrOfStolenTasks() const;
+    private:
+        struct Task {
+            int priority;
+            std::uint64_t seq;
+            std::function<void()> fn;
+        };
+
+        struct TaskOrder {
+            bool operator()(const Task& lhs, const Task& rhs) const {
+                //note std::priority_queue pops the largest element
+                if (lhs.priority != rhs.priority) {
+                    return lhs.priority < rhs.priority;
+                }
+                return lhs.seq > rhs.seq;
+            }
+        };
+
+        class TaskQueue {
+        public:
+            void push(Task task) {
+                std::lock_guard lck{mutex};
+                tasks.push(std::move(task));
+                size.store(tasks.size(), std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Pops the highest priority task if its priority is at least minPriority.
+             */
+            bool pop(Task& out, int minPriority = std::numeric_limits<int>::min()) {
+                if (size.load(std::memory_order_relaxed) == 0) {
+                    return false;
+                }
+                std::lock_guard lck{mutex};
+                if (tasks.empty() || tasks.top().priority < minPriority) {
+                    return false;
+                }
+                //note priority_queue::top is const, the task is moved out right before it is popped.
+                out = std::move(const_cast<Task&>(tasks.top()));
+                tasks.pop();
+                size.store(tasks.size(), std::memory_order_relaxed);
+                return true;
+            }
+
+            bool peekPriority(int& priority) {
+                if (size.load(std::memory_order_relaxed) == 0) {
+                    return false;
+                }
+                std::lock_guard lck{mutex};
+                if (tasks.empty()) {
+                    return false;
+                }
+                priority = tasks.top().priority;
+                return true;
+            }
+
+            [[nodiscard]] bool empty() const {
+                return size.load(std::memory_order_relaxed) == 0;
+            }
+        private:
+            std::mutex mutex{}; //protects tasks
+            std::priority_queue<Task, std::vector<Task>, TaskOrder> tasks{};
+            std::atomic<std::size_t> size{0};
+        };
+
+        struct Worker {
+            std::size_t index{0};
+            TaskQueue queue{};
+            std::thread thread{};
+            bool active{false}; //protected by ThreadPoolExecutor::mutex
+        };
+
+        struct CurrentWorker {
+            const ThreadPoolExecutor* executor{nullptr};
+            Worker* worker{nullptr};
+        };
+
+        static CurrentWorker& currentWorker() {
+            static thread_local CurrentWorker current{};
+            return current;
+        }
+
+        void run(Worker* worker);
+        bool takeTask(Worker* worker, Task& out);
+        void signalWorkers();
+        void startWorker(std::unique_lock<std::mutex>& lck);
+        void taskDone();
+
+        const std::size_t minThreads;
+        const std::size_t maxThreads;
+        const std::chrono::milliseconds idleTimeout;
+        std::vector<std::unique_ptr<Worker>> workers{}; //fixed size (maxThreads), created in the ctor
+        TaskQueue injectionQueue{};
+        std::atomic<std::uint64_t> nextSeq{0};
+        std::atomic<std::size_t> nrOfPendingTasks{0};
+        std::atomic<std::size_t> nrOfQueuedTasks{0};
+        std::atomic<std::size_t> nrOfIdleWorkers{0};
+        std::atomic<std::size_t> nrOfThreads{0};
+        std::atomic<std::size_t> nrOfStolenTasks{0};
+
+        mutable std::mutex mutex{}; //protects below and Worker::active
+        std::condition_variable workCond{};
+        std::condition_variable doneCond{};
+        std::size_t nrOfWakeUps{0}; //number of notified, but not yet awoken, idle workers
+        bool stopping{false};
+    };
+}
+
+/*********************************************************************************
+ Implementation
+*********************************************************************************/
+
+inline celix::ThreadPoolExecutor::ThreadPoolExecutor(std::size_t _minThreads,
+                                                     std::size_t _maxThreads,
+                                                     std::chrono::milliseconds _idleTimeout) :
+        minThreads{_minThreads},
+        maxThreads{_maxThreads > 0 ? std::max(_maxThreads, _minThreads) :
+                   std::max<std::size_t>({16, std::thread::hardware_concurrency() * 4, _minThreads})},
+        idleTimeout{_idleTimeout} {
+    workers.reserve(maxThreads);
+    for (std::size_t i = 0; i < maxThreads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        workers.emplace_back(std::move(worker));
+    }
+}
+
+inline celix::ThreadPoolExecutor::~ThreadPoolExecutor() noexcept {
+    {
+        std::lock_guard lck{mutex};
+        stopping = true;
+    }
+    workCond.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+inline void celix::ThreadPoolExecutor::execute(int priority, std::function<void()> task) {
+    auto& current = currentWorker();
+    Task t{priority, nextSeq.fetch_add(1, std::memory_order_relaxed), std::move(task)};
+    if (current.executor != this) {
+        std::lock_guard lck{mutex};
+        if (stopping) {
+            throw celix::RejectedExecutionException{};
+        }
+    }
+    //note the counters are increased before the task is queued, so that they never drop below zero
+    nrOfPendingTasks.fetch_add(1, std::memory_order_seq_cst);
+    nrOfQueuedTasks.fetch_add(1, std::memory_order_seq_cst);
+    if (current.executor == this) {
+        current.worker->queue.push(std::move(t));
+    } else {
+        injectionQueue.push(std::move(t));
+    }
+    signalWorkers();
+}
+
+inline void celix::ThreadPoolExecutor::signalWorkers() {
+    //fast path: no idle worker to wake and no room to start a new worker
+    if (nrOfIdleWorkers.load(std::memory_order_seq_cst) == 0 && nrOfThreads.load(std::memory_order_relaxed) >= maxThreads) {
+        return;
+    }
+    std::unique_lock lck{mutex};
+    if (nrOfIdleWorkers.load(std::memory_order_relaxed) > nrOfWakeUps) {
+        nrOfWakeUps += 1;
+        lck.unlock();
+        workCond.notify_one();
+    } else if (!stopping && nrOfThreads.load(std::memory_order_relaxed) < maxThreads) {
+        startWorker(lck);
+    }
+}
+
+inline void celix::ThreadPoolExecutor::startWorker(std::unique_lock<std::mutex>& /*lck, must be locked*/) {
+    for (auto& worker : workers) {
+        if (!worker->active) {
+            if (worker->thread.joinable()) {
+                //note a retired worker thread is already done with its loop
+                worker->thread.join();
+            }
+            worker->active = true;
+            nrOfThreads.fetch_add(1, std::memory_order_relaxed);
+            try {
+                worker->thread = std::thread{&ThreadPoolExecutor::run, this, worker.get()};
+            } catch (const std::system_error& /*sysExp*/) {
+                //note the task is still queued and will be picked up by a running worker
+                worker->active = false;
+                nrOfThreads.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+    }
+}
+
+inline bool celix::ThreadPoolExecutor::takeTask(Worker* worker, Task& out) {
+    int injectedPriority = 0;
+    if (injectionQueue.peekPriority(injectedPriority)) {
+        //prefer the injected task if it has a higher priority than the tasks in the own queue
+        if (worker->queue.pop(out, injectedPriority) || injectionQueue.pop(out)) {
+            return true;
+        }
+    }
+    if (worker->queue.pop(out) || injectionQueue.pop(out)) {
+        return true;
+    }
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        auto& victim = workers[(worker->index + i) % workers.size()];
+        if (victim->queue.pop(out)) {
+            nrOfStolenTasks.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void celix::ThreadPoolExecutor::run(Worker* worker) {
+    auto& current = currentWorker();
+    current.executor = this;
+    current.worker = worker;
+
+    Task task{};
+    while (true) {
+        if (takeTask(worker, task)) {
+            nrOfQueuedTasks.fetch_sub(1, std::memory_order_seq_cst);
+            try {
+                task.fn();
+            } catch (...) {
+                //note same as the DefaultExecutor, the exception of a task is ignored.
+            }
+            task.fn = nullptr; //to ensure captures of task go out of scope
+            taskDone();
+            continue;
+        }
+
+        std::unique_lock lck{mutex};
+        nrOfIdleWorkers.fetch_add(1, std::memory_order_seq_cst);
+        bool timedOut = false;
+        while (!stopping && nrOfQueuedTasks.load(std::memory_order_seq_cst) == 0 && !timedOut) {
+            timedOut = workCond.wait_for(lck, idleTimeout) == std::cv_status::timeout;
+        }
+        nrOfIdleWorkers.fetch_sub(1, std::memory_order_seq_cst);
+        if (nrOfWakeUps > 0) {
+            nrOfWakeUps -= 1;
+        }
+        bool hasWork = nrOfQueuedTasks.load(std::memory_order_seq_cst) > 0;
+        if (stopping && !hasWork) {
+            break;
+        }
+        if (timedOut && !hasWork && worker->queue.empty() && nrOfThreads.load(std::memory_order_relaxed) > minThreads) {
+            //retire, only this thread pushes to its own queue, so it stays empty
+            worker->active = false;
+            nrOfThreads.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    current.executor = nullptr;
+    current.worker = nullptr;
+}
+
+inline void celix::ThreadPoolExecutor::taskDone() {
+    if (nrOfPendingTasks.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        std::lock_guard lck{mutex};
+        doneCond.notify_all();
+    }
+}
+
+inline void celix::ThreadPoolExecutor::wait() {
+    std::unique_lock lck{mutex};
+    doneCond.wait(lck, [this]{ return nrOfPendingTasks.load(std::memory_order_seq_cst) == 0; });
+}
+
+inline std::size_t celix::ThreadPoolExecutor::getNrOfThreads() const {
+    return nrOfThreads.load(std::memory_order_relaxed);
+}
+
+inline std::size_t celix::ThreadPoolExecutor::getNrOfPendingTasks() const {
+    return nrOfPendingTasks.load(std::memory_order_relaxed);
+}
+
+inline std::size_t celix::ThreadPoolExecutor::getNrOfStolenTasks() const {
+    return nrOfStolenTasks.load(std::memory_order_relaxed);
+}
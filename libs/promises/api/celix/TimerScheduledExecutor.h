@@ -0,0 +1,340 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "celix/IScheduledExecutor.h"
+#include "celix/DefaultExecutor.h"
+
+namespace celix {
+
+    /**
+     * @brief A scheduled executor which uses a single timer thread and a binary heap of deadlines.
+     *
+     * The timer thread only waits for the earliest deadline; due tasks are handed to the (regular) executor, so a
+     * scheduled task never blocks the timer thread and the timer thread is started lazily on the first schedule.
+     *
+     * Cancelling a scheduled task is O(1): the task is only marked as cancelled and skipped when its deadline is
+     * reached. To bound the memory use for tasks which are mostly cancelled (e.g. promise timeouts), the heap is
+     * compacted when more than half of the entries are cancelled.
+     *
+     * Zero and negative delays are treated as requests for immediate execution.
+     */
+    class TimerScheduledExecutor : public celix::IScheduledExecutor {
+    public:
+        /**
+         * @brief Creates a timer scheduled executor.
+         * @param executor The executor used to execute the due tasks. If the executor rejects a due task, the task is
+         *                 executed on the timer thread.
+         */
+        explicit TimerScheduledExecutor(std::shared_ptr<celix::IExecutor> executor = std::make_shared<celix::DefaultExecutor>());
+
+        /**
+         * @brief Destroys the timer scheduled executor. Scheduled tasks which are not yet due are cancelled.
+         */
+        ~TimerScheduledExecutor() noexcept override;
+
+        TimerScheduledExecutor(const TimerScheduledExecutor&) = delete;
+        TimerScheduledExecutor(TimerScheduledExecutor&&) = delete;
+        TimerScheduledExecutor& operator=(const TimerScheduledExecutor&) = delete;
+        TimerScheduledExecutor& operator=(TimerScheduledExecutor&&) = delete;
+
+        /**
+         * @brief Wait until all scheduled tasks are executed or cancelled.
+         */
+        void wait() override;
+
+        /**
+         * @brief Returns the number of scheduled tasks which are not yet executed or cancelled.
+         */
+        [[nodiscard]] std::size_t getNrOfScheduledTasks() const;
+
+        /**
+         * @brief Returns the number of entries in the deadline heap, including cancelled entries which are not yet removed.
+         */
+        [[nodiscard]] std::size_t getHeapSize() const;
+    private:
+        struct TimerState;
+
+        class ScheduledFuture : public celix::IScheduledFuture {
+        public:
+            enum class Status : int {
+                SCHEDULED,
+                RUNNING,
+                DONE,
+                CANCELLED
+            };
+
+            ScheduledFuture(int _priority,
+                            std::uint64_t _seq,
+                            std::chrono::steady_clock::time_point _deadline,
+                            std::function<void()> _task,
+                            std::weak_ptr<TimerState> _timerState) :
+                    priority{_priority},
+                    seq{_seq},
+                    deadline{_deadline},
+                    task{std::move(_task)},
+                    timerState{std::move(_timerState)} {}
+
+            ~ScheduledFuture() noexcept override = default;
+
+            [[nodiscard]] bool isCancelled() const override {
+                return status.load(std::memory_order_acquire) == Status::CANCELLED;
+            }
+
+            [[nodiscard]] bool isDone() const override {
+                auto s = status.load(std::memory_order_acquire);
+                return s == Status::DONE || s == Status::CANCELLED;
+            }
+
+            void cancel() override;
+
+            const int priority;
+            const std::uint64_t seq;
+            const std::chrono::steady_clock::time_point deadline;
+            std::function<void()> task; //only accessed by the thread which changes the status from SCHEDULED
+            const std::weak_ptr<TimerState> timerState;
+            std::atomic<Status> status{Status::SCHEDULED}; //changes from SCHEDULED are done with TimerState::mutex locked
+        };
+
+        struct DeadlineOrder {
+            bool operator()(const std::shared_ptr<ScheduledFuture>& lhs, const std::shared_ptr<ScheduledFuture>& rhs) const {
+                //note the heap functions keep the largest element in front
+                if (lhs->deadline != rhs->deadline) {
+                    return lhs->deadline > rhs->deadline;
+                }
+                return lhs->seq > rhs->seq;
+            }
+        };
+
+        /**
+         * @brief The state shared with the scheduled futures.
+         * Note that the state does not own the executor, because the last reference to the state can be released
+         * by a task running on the executor.
+         */
+        struct TimerState {
+            void compactIfNeeded();
+            void taskDone();
+
+            std::mutex mutex{}; //protects below
+            std::condition_variable timerCond{};
+            std::condition_variable doneCond{};
+            std::vector<std::shared_ptr<ScheduledFuture>> heap{};
+            std::size_t nrOfCancelledEntries{0};
+            std::size_t nrOfPendingTasks{0};
+            std::uint64_t nextSeq{0};
+            bool timerStarted{false};
+            bool stopping{false};
+        };
+
+        static constexpr std::size_t MIN_HEAP_SIZE_FOR_COMPACTION = 64;
+
+        void runTimer();
+        void dispatch(const std::shared_ptr<ScheduledFuture>& future);
+        std::shared_ptr<celix::IScheduledFuture> scheduleInMilli(int priority, std::chrono::duration<double, std::milli> delay, std::function<void()> task) override;
+
+        const std::shared_ptr<celix::IExecutor> executor;
+        const std::shared_ptr<TimerState> state;
+        std::thread timerThread{};
+    };
+}
+
+/*********************************************************************************
+ Implementation
+*********************************************************************************/
+
+inline void celix::TimerScheduledExecutor::ScheduledFuture::cancel() {
+    auto s = timerState.lock();
+    if (!s) {
+        auto expected = Status::SCHEDULED;
+        status.compare_exchange_strong(expected, Status::CANCELLED, std::memory_order_acq_rel);
+        return;
+    }
+    std::lock_guard lck{s->mutex};
+    auto expected = Status::SCHEDULED;
+    if (status.compare_exchange_strong(expected, Status::CANCELLED, std::memory_order_acq_rel)) {
+        task = nullptr; //to ensure captures of task go out of scope
+        s->nrOfCancelledEntries += 1;
+        s->nrOfPendingTasks -= 1;
+        s->compactIfNeeded();
+        if (s->nrOfPendingTasks == 0) {
+            s->doneCond.notify_all();
+        }
+    }
+}
+
+inline void celix::TimerScheduledExecutor::TimerState::compactIfNeeded() {
+    //note should be called while mutex is locked.
+    if (heap.size() < MIN_HEAP_SIZE_FOR_COMPACTION || nrOfCancelledEntries * 2 <= heap.size()) {
+        return;
+    }
+    heap.erase(std::remove_if(heap.begin(), heap.end(), [](const std::shared_ptr<ScheduledFuture>& f) {
+        return f->status.load(std::memory_order_relaxed) == ScheduledFuture::Status::CANCELLED;
+    }), heap.end());
+    std::make_heap(heap.begin(), heap.end(), DeadlineOrder{});
+    nrOfCancelledEntries = 0;
+    timerCond.notify_one();
+}
+
+inline void celix::TimerScheduledExecutor::TimerState::taskDone() {
+    std::lock_guard lck{mutex};
+    nrOfPendingTasks -= 1;
+    if (nrOfPendingTasks == 0) {
+        doneCond.notify_all();
+    }
+}
+
+inline celix::TimerScheduledExecutor::TimerScheduledExecutor(std::shared_ptr<celix::IExecutor> _executor) :
+        executor{std::move(_executor)},
+        state{std::make_shared<TimerState>()} {}
+
+inline celix::TimerScheduledExecutor::~TimerScheduledExecutor() noexcept {
+    {
+        std::lock_guard lck{state->mutex};
+        state->stopping = true;
+        for (auto& future : state->heap) {
+            auto expected = ScheduledFuture::Status::SCHEDULED;
+            if (future->status.compare_exchange_strong(expected, ScheduledFuture::Status::CANCELLED)) {
+                future->task = nullptr;
+                state->nrOfPendingTasks -= 1;
+            }
+        }
+        state->heap.clear();
+        state->nrOfCancelledEntries = 0;
+        state->timerCond.notify_all();
+        state->doneCond.notify_all();
+    }
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+}
+
+inline std::shared_ptr<celix::IScheduledFuture> celix::TimerScheduledExecutor::scheduleInMilli(int priority, std::chrono::duration<double, std::milli> delay, std::function<void()> task) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay);
+    std::unique_lock lck{state->mutex};
+    if (state->stopping) {
+        throw celix::RejectedExecutionException{};
+    }
+    auto future = std::make_shared<ScheduledFuture>(priority, state->nextSeq++, deadline, std::move(task), state);
+    if (delay.count() <= 0) {
+        future->status.store(ScheduledFuture::Status::RUNNING, std::memory_order_relaxed);
+        state->nrOfPendingTasks += 1;
+        lck.unlock();
+        dispatch(future);
+        return future;
+    }
+    if (!state->timerStarted) {
+        try {
+            timerThread = std::thread{&TimerScheduledExecutor::runTimer, this};
+        } catch (const std::system_error& /*sysExp*/) {
+            throw celix::RejectedExecutionException{};
+        }
+        state->timerStarted = true;
+    }
+    state->heap.emplace_back(future);
+    std::push_heap(state->heap.begin(), state->heap.end(), DeadlineOrder{});
+    state->nrOfPendingTasks += 1;
+    if (state->heap.front() == future) {
+        //new earliest deadline
+        state->timerCond.notify_one();
+    }
+    return future;
+}
+
+inline void celix::TimerScheduledExecutor::runTimer() {
+    std::vector<std::shared_ptr<ScheduledFuture>> dueTasks{};
+    std::unique_lock lck{state->mutex};
+    while (!state->stopping) {
+        if (state->heap.empty()) {
+            state->timerCond.wait(lck);
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto earliest = state->heap.front()->deadline;
+        if (earliest > now) {
+            state->timerCond.wait_until(lck, earliest);
+            continue;
+        }
+        while (!state->heap.empty() && state->heap.front()->deadline <= now) {
+            std::pop_heap(state->heap.begin(), state->heap.end(), DeadlineOrder{});
+            auto future = std::move(state->heap.back());
+            state->heap.pop_back();
+            auto expected = ScheduledFuture::Status::SCHEDULED;
+            if (future->status.compare_exchange_strong(expected, ScheduledFuture::Status::RUNNING, std::memory_order_acq_rel)) {
+                dueTasks.emplace_back(std::move(future));
+            } else {
+                state->nrOfCancelledEntries -= 1;
+            }
+        }
+        lck.unlock();
+        for (auto& future : dueTasks) {
+            dispatch(future);
+        }
+        dueTasks.clear();
+        lck.lock();
+    }
+}
+
+inline void celix::TimerScheduledExecutor::dispatch(const std::shared_ptr<ScheduledFuture>& future) {
+    auto run = [future] {
+        try {
+            future->task();
+        } catch (...) {
+            //note same as the DefaultScheduledExecutor, the exception of a task is ignored.
+        }
+        future->task = nullptr; //to ensure captures of task go out of scope
+        future->status.store(ScheduledFuture::Status::DONE, std::memory_order_release);
+        auto s = future->timerState.lock();
+        if (s) {
+            s->taskDone();
+        }
+    };
+    try {
+        executor->execute(future->priority, run);
+    } catch (const celix::RejectedExecutionException& /*rejected*/) {
+        run();
+    }
+}
+
+inline void celix::TimerScheduledExecutor::wait() {
+    std::unique_lock lck{state->mutex};
+    state->doneCond.wait(lck, [this]{ return state->nrOfPendingTasks == 0; });
+}
+
+inline std::size_t celix::TimerScheduledExecutor::getNrOfScheduledTasks() const {
+    std::lock_guard lck{state->mutex};
+    return state->nrOfPendingTasks;
+}
+
+inline std::size_t celix::TimerScheduledExecutor::getHeapSize() const {
+    std::lock_guard lck{state->mutex};
+    return state->heap.size();
+}
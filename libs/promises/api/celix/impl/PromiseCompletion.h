@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "celix/IExecutor.h"
+
+namespace celix::impl {
+
+    /**
+     * @brief The completion state of a shared promise state.
+     *
+     * Replaces the mutex, condition variable and vector of std::function of a promise state with:
+     *  - an atomic state word (PENDING -> RESOLVING -> DONE), so that only one resolver can write the result and
+     *    readers only need an acquire load to check whether the promise is done;
+     *  - a lock-free intrusive list of continuations, where the callable is stored inline in the list node,
+     *    so adding a continuation costs a single allocation;
+     *  - a mutex/condition variable pair which is only created if a thread actually needs to block in wait().
+     */
+    class PromiseCompletion {
+    public:
+        PromiseCompletion() = default;
+
+        ~PromiseCompletion() noexcept {
+            //note continuations of a never completed promise are destroyed without being executed
+            auto* node = head.load(std::memory_order_acquire);
+            if (node != closedMarker()) {
+                destroyList(node);
+            }
+            delete waiter.load(std::memory_order_acquire);
+        }
+
+        PromiseCompletion(const PromiseCompletion&) = delete;
+        PromiseCompletion(PromiseCompletion&&) = delete;
+        PromiseCompletion& operator=(const PromiseCompletion&) = delete;
+        PromiseCompletion& operator=(PromiseCompletion&&) = delete;
+
+        /**
+         * @brief Try to become the (single) resolver of the promise.
+         * @return true if the caller can write the result and must call complete or abortResolve.
+         */
+        bool tryStartResolve() {
+            auto expected = State::PENDING;
+            return state.compare_exchange_strong(expected, State::RESOLVING, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Reverts a tryStartResolve, e.g. because writing the result failed.
+         */
+        void abortResolve() {
+            state.store(State::PENDING, std::memory_order_release);
+        }
+
+        /**
+         * @brief Marks the promise as done, wakes up the waiting threads and executes the continuations on the
+         * executor (in the order they were added).
+         */
+        void complete(celix::IExecutor& executor, int priority) {
+            state.store(State::DONE, std::memory_order_seq_cst);
+            auto* w = waiter.load(std::memory_order_seq_cst);
+            if (w != nullptr) {
+                std::lock_guard lck{w->mutex};
+                w->cond.notify_all();
+            }
+
+            //reverse the LIFO list, so that the continuations are executed in the order they were added
+            auto* node = head.exchange(closedMarker(), std::memory_order_acq_rel);
+            ContinuationNode* ordered = nullptr;
+            while (node != nullptr) {
+                auto* next = node->next;
+                node->next = ordered;
+                ordered = node;
+                node = next;
+            }
+            while (ordered != nullptr) {
+                auto* next = ordered->next;
+                try {
+                    dispatch(ordered, executor, priority);
+                } catch (...) {
+                    destroyList(next);
+                    throw;
+                }
+                ordered = next;
+            }
+        }
+
+        /**
+         * @brief Adds a continuation which is executed on the executor when the promise is done, or directly
+         * submitted to the executor if the promise is already done.
+         */
+        template<typename F>
+        void addContinuation(F&& fn, celix::IExecutor& executor, int priority) {
+            ContinuationNode* node = new Continuation<std::decay_t<F>>{std::forward<F>(fn)};
+            auto* h = head.load(std::memory_order_acquire);
+            do {
+                if (h == closedMarker()) {
+                    dispatch(node, executor, priority);
+                    return;
+                }
+                node->next = h;
+            } while (!head.compare_exchange_weak(h, node, std::memory_order_acq_rel, std::memory_order_acquire));
+        }
+
+        [[nodiscard]] bool isDone() const {
+            return state.load(std::memory_order_acquire) == State::DONE;
+        }
+
+        /**
+         * @brief Waits until the promise is done. The wait state is only created if the promise is not yet done.
+         */
+        void wait() const {
+            if (isDone()) {
+                return;
+            }
+            auto* w = waiter.load(std::memory_order_seq_cst);
+            if (w == nullptr) {
+                auto* created = new Waiter{};
+                if (waiter.compare_exchange_strong(w, created, std::memory_order_seq_cst)) {
+                    w = created;
+                } else {
+                    delete created;
+                }
+            }
+            std::unique_lock lck{w->mutex};
+            w->cond.wait(lck, [this]{ return state.load(std::memory_order_seq_cst) == State::DONE; });
+        }
+    private:
+        enum class State : std::uint8_t {
+            PENDING,
+            RESOLVING,
+            DONE
+        };
+
+        struct ContinuationNode {
+            virtual ~ContinuationNode() noexcept = default;
+            virtual void run() = 0;
+            ContinuationNode* next{nullptr};
+        };
+
+        template<typename F>
+        struct Continuation final : ContinuationNode {
+            explicit Continuation(F&& _fn) : fn{std::move(_fn)} {}
+            explicit Continuation(const F& _fn) : fn{_fn} {}
+            void run() override { fn(); }
+            F fn;
+        };
+
+        struct Waiter {
+            std::mutex mutex{};
+            std::condition_variable cond{};
+        };
+
+        static ContinuationNode* closedMarker() {
+            //note only used as marker value, never dereferenced
+            static char marker{};
+            return reinterpret_cast<ContinuationNode*>(&marker);
+        }
+
+        static void destroyList(ContinuationNode* node) {
+            while (node != nullptr) {
+                auto* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+
+        static void dispatch(ContinuationNode* node, celix::IExecutor& executor, int priority) {
+            //note the task only captures a pointer, so the std::function does not need an additional allocation.
+            //The node is deleted after it is executed, to ensure captures of the continuation go out of scope.
+            try {
+                executor.execute(priority, [node] {
+                    struct Deleter {
+                        ContinuationNode* n;
+                        ~Deleter() { delete n; }
+                    } deleter{node};
+                    node->run();
+                });
+            } catch (...) {
+                delete node;
+                throw;
+            }
+        }
+
+        std::atomic<State> state{State::PENDING};
+        std::atomic<ContinuationNode*> head{nullptr};
+        mutable std::atomic<Waiter*> waiter{nullptr};
+    };
+}
@@ -19,18 +19,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <type_traits>
 #include <functional>
 #include <chrono>
-#include <mutex>
-#include <condition_variable>
 #include <utility>
-#include <vector>
-#include <thread>
 #include <optional>
 
 #include "celix/IExecutor.h"
 #include "celix/IScheduledExecutor.h"
+#include "celix/impl/PromiseCompletion.h"
 
 #include "celix/PromiseInvocationException.h"
 #include "celix/PromiseTimeoutException.h"
@@ -101,7 +99,12 @@ namespace celix::impl {
         template<typename Rep, typename Period>
         std::shared_ptr<SharedPromiseState<T>> setTimeout(std::chrono::duration<Rep, Period> duration);
 
-        void addChain(std::function<void()> chainFunction);
+        /**
+         * @brief Adds a chain function which is executed on the executor when the promise is resolved.
+         * The chain function is stored in an intrusive continuation node and not wrapped in a std::function.
+         */
+        template<typename F>
+        void addChain(F&& chainFunction);
 
         [[nodiscard]] std::shared_ptr<celix::IExecutor> getExecutor() const;
 
@@ -111,31 +114,34 @@ namespace celix::impl {
 
         [[nodiscard]] std::weak_ptr<SharedPromiseState<T>> getSelf() const;
     private:
-        explicit SharedPromiseState(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority);
-
+        struct PrivateTag {
+            explicit PrivateTag() = default;
+        };
+    public:
+        //note public so that the state and control block can be allocated in one go with std::make_shared.
+        SharedPromiseState(PrivateTag, std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority);
+    private:
         void setSelf(std::weak_ptr<SharedPromiseState<T>> self);
 
         /**
-         * Complete the resolving and call the registered tasks
-         * A reference to the possible locked unique_lock.
+         * Complete the resolving and call the registered tasks.
+         * Should only be called by the resolver (after a successful completion.tryStartResolve()).
          */
-        void complete(std::unique_lock<std::mutex> &lck);
+        void complete();
 
         /**
-         * Wait for data and check if it resolved as expected (expects mutex locked)
+         * Wait for data and check if it resolved as expected
          */
-        void waitForAndCheckData(std::unique_lock<std::mutex> &lck, bool expectValid) const;
+        void waitForAndCheckData(bool expectValid) const;
 
         const std::shared_ptr<celix::IExecutor> executor;
         const std::shared_ptr<celix::IScheduledExecutor> scheduledExecutor;
         const int priority;
         std::weak_ptr<SharedPromiseState<T>> self{};
 
-        mutable std::mutex mutex{}; //protects below
-        mutable std::condition_variable cond{};
-        bool done = false;
-        bool dataMoved = false;
-        std::vector<std::function<void()>> chain{}; //chain tasks are executed on thread pool.
+        PromiseCompletion completion{};
+        //note exp and data are written by the resolver before completion and only read after completion.
+        std::atomic<bool> dataMoved{false};
         std::exception_ptr exp{nullptr};
         std::optional<T> data{};
     };
@@ -190,7 +196,12 @@ namespace celix::impl {
         template<typename Rep, typename Period>
         std::shared_ptr<SharedPromiseState<void>> setTimeout(std::chrono::duration<Rep, Period> duration);
 
-        void addChain(std::function<void()> chainFunction);
+        /**
+         * @brief Adds a chain function which is executed on the executor when the promise is resolved.
+         * The chain function is stored in an intrusive continuation node and not wrapped in a std::function.
+         */
+        template<typename F>
+        void addChain(F&& chainFunction);
 
         [[nodiscard]] std::shared_ptr<celix::IExecutor> getExecutor() const;
 
@@ -200,30 +211,33 @@ namespace celix::impl {
 
         [[nodiscard]] std::weak_ptr<SharedPromiseState<void>> getSelf() const;
     private:
-        explicit SharedPromiseState(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority);
-
+        struct PrivateTag {
+            explicit PrivateTag() = default;
+        };
+    public:
+        //note public so that the state and control block can be allocated in one go with std::make_shared.
+        SharedPromiseState(PrivateTag, std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority);
+    private:
         void setSelf(std::weak_ptr<SharedPromiseState<void>> self);
 
         /**
-         * Complete the resolving and call the registered tasks
-         * A reference to the possible locked unique_lock.
+         * Complete the resolving and call the registered tasks.
+         * Should only be called by the resolver (after a successful completion.tryStartResolve()).
          */
-        void complete(std::unique_lock<std::mutex> &lck);
+        void complete();
 
         /**
-         * Wait for data and check if it resolved as expected (expects mutex locked)
+         * Wait for data and check if it resolved as expected
          */
-        void waitForAndCheckData(std::unique_lock<std::mutex> &lck, bool expectValid) const;
+        void waitForAndCheckData(bool expectValid) const;
 
         const std::shared_ptr<celix::IExecutor> executor;
         const std::shared_ptr<celix::IScheduledExecutor> scheduledExecutor;
         const int priority;
         std::weak_ptr<SharedPromiseState<void>> self{};
 
-        mutable std::mutex mutex{}; //protects below
-        mutable std::condition_variable cond{};
-        bool done = false;
-        std::vector<std::function<void()>> chain{}; //chain tasks are executed on thread pool.
+        PromiseCompletion completion{};
+        //note exp is written by the resolver before completion and only read after completion.
         std::exception_ptr exp{nullptr};
     };
 }
@@ -235,21 +249,21 @@ namespace celix::impl {
 
 template<typename T>
 std::shared_ptr<celix::impl::SharedPromiseState<T>> celix::impl::SharedPromiseState<T>::create(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int priority) {
-    auto state = std::shared_ptr<celix::impl::SharedPromiseState<T>>{new celix::impl::SharedPromiseState<T>{std::move(_executor), std::move(_scheduledExecutor), priority}};
+    auto state = std::make_shared<celix::impl::SharedPromiseState<T>>(PrivateTag{}, std::move(_executor), std::move(_scheduledExecutor), priority);
     state->setSelf(state);
     return state;
 }
 
 inline std::shared_ptr<celix::impl::SharedPromiseState<void>> celix::impl::SharedPromiseState<void>::create(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int priority) {
-    auto state = std::shared_ptr<celix::impl::SharedPromiseState<void>>{new celix::impl::SharedPromiseState<void>{std::move(_executor), std::move(_scheduledExecutor), priority}};
+    auto state = std::make_shared<celix::impl::SharedPromiseState<void>>(PrivateTag{}, std::move(_executor), std::move(_scheduledExecutor), priority);
     state->setSelf(state);
     return state;
 }
 
 template<typename T>
-celix::impl::SharedPromiseState<T>::SharedPromiseState(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority) : executor{std::move(_executor)}, scheduledExecutor{std::move(_scheduledExecutor)}, priority{_priority} {}
+celix::impl::SharedPromiseState<T>::SharedPromiseState(PrivateTag, std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority) : executor{std::move(_executor)}, scheduledExecutor{std::move(_scheduledExecutor)}, priority{_priority} {}
 
-inline celix::impl::SharedPromiseState<void>::SharedPromiseState(std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority) : executor{std::move(_executor)}, scheduledExecutor{std::move(_scheduledExecutor)}, priority{_priority} {}
+inline celix::impl::SharedPromiseState<void>::SharedPromiseState(PrivateTag, std::shared_ptr<celix::IExecutor> _executor, std::shared_ptr<celix::IScheduledExecutor> _scheduledExecutor, int _priority) : executor{std::move(_executor)}, scheduledExecutor{std::move(_scheduledExecutor)}, priority{_priority} {}
 
 template<typename T>
 void celix::impl::SharedPromiseState<T>::setSelf(std::weak_ptr<SharedPromiseState<T>> _self) {
@@ -271,63 +285,66 @@ inline std::weak_ptr<celix::impl::SharedPromiseState<void>> celix::impl::SharedP
 
 template<typename T>
 bool celix::impl::SharedPromiseState<T>::tryResolve(T&& value) {
-    std::unique_lock<std::mutex> lck{mutex};
-    if (!done) {
-        dataMoved = false;
+    if (!completion.tryStartResolve()) {
+        return false;
+    }
+    try {
         if constexpr (std::is_move_constructible_v<T>) {
             data = std::forward<T>(value);
         } else {
             data = value;
         }
-        exp = nullptr;
-        complete(lck);
-        return true;
+    } catch (...) {
+        completion.abortResolve();
+        throw;
     }
-    return false;
+    exp = nullptr;
+    complete();
+    return true;
 }
 
 template<typename T>
 bool celix::impl::SharedPromiseState<T>::tryResolve(const T& value) {
-    std::unique_lock<std::mutex> lck{mutex};
-    if (!done) {
-        dataMoved = false;
+    if (!completion.tryStartResolve()) {
+        return false;
+    }
+    try {
         data = value;
-        exp = nullptr;
-        complete(lck);
-        return true;
+    } catch (...) {
+        completion.abortResolve();
+        throw;
     }
-    return false;
+    exp = nullptr;
+    complete();
+    return true;
 }
 
 inline bool celix::impl::SharedPromiseState<void>::tryResolve() {
-    std::unique_lock<std::mutex> lck{mutex};
-    if (!done) {
-        exp = nullptr;
-        complete(lck);
-        return true;
+    if (!completion.tryStartResolve()) {
+        return false;
     }
-    return false;
+    exp = nullptr;
+    complete();
+    return true;
 }
 
 template<typename T>
 bool celix::impl::SharedPromiseState<T>::tryFail(const std::exception_ptr& e) {
-    std::unique_lock<std::mutex> lck{mutex};
-    if (!done) {
-        exp = e;
-        complete(lck);
-        return true;
+    if (!completion.tryStartResolve()) {
+        return false;
     }
-    return false;
+    exp = e;
+    complete();
+    return true;
 }
 
 inline bool celix::impl::SharedPromiseState<void>::tryFail(const std::exception_ptr& e) {
-    std::unique_lock<std::mutex> lck{mutex};
-    if (!done) {
-        exp = e;
-        complete(lck);
-        return true;
+    if (!completion.tryStartResolve()) {
+        return false;
     }
-    return false;
+    exp = e;
+    complete();
+    return true;
 }
 
 template<typename T>
@@ -343,33 +360,26 @@ bool celix::impl::SharedPromiseState<void>::tryFail(const E& e) {
 
 template<typename T>
 bool celix::impl::SharedPromiseState<T>::isDone() const {
-    std::lock_guard lck{mutex};
-    return done;
+    return completion.isDone();
 }
 
 inline bool celix::impl::SharedPromiseState<void>::isDone() const {
-    std::lock_guard lck{mutex};
-    return done;
+    return completion.isDone();
 }
 
 template<typename T>
 bool celix::impl::SharedPromiseState<T>::isSuccessfullyResolved() const {
-    std::lock_guard lck{mutex};
-    return done && !exp;
+    return completion.isDone() && !exp;
 }
 
 inline bool celix::impl::SharedPromiseState<void>::isSuccessfullyResolved() const {
-    std::lock_guard lck{mutex};
-    return done && !exp;
+    return completion.isDone() && !exp;
 }
 
 
 template<typename T>
-void celix::impl::SharedPromiseState<T>::waitForAndCheckData(std::unique_lock<std::mutex>& lck, bool expectValid) const {
-    if (!lck.owns_lock()) {
-        lck.lock();
-    }
-    cond.wait(lck, [this]{return done;});
+void celix::impl::SharedPromiseState<T>::waitForAndCheckData(bool expectValid) const {
+    completion.wait();
     if (expectValid && exp) {
         std::string what;
         try {
@@ -387,11 +397,8 @@ void celix::impl::SharedPromiseState<T>::waitForAndCheckData(std::unique_lock<st
     }
 }
 
-inline void celix::impl::SharedPromiseState<void>::waitForAndCheckData(std::unique_lock<std::mutex>& lck, bool expectValid) const {
-    if (!lck.owns_lock()) {
-        lck.lock();
-    }
-    cond.wait(lck, [this]{return done;});
+inline void celix::impl::SharedPromiseState<void>::waitForAndCheckData(bool expectValid) const {
+    completion.wait();
     if (expectValid && exp) {
         std::string what;
         try {
@@ -409,42 +416,36 @@ inline void celix::impl::SharedPromiseState<void>::waitForAndCheckData(std::uniq
 
 template<typename T>
 T& celix::impl::SharedPromiseState<T>::getValue() & {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     return *data;
 }
 
 template<typename T>
 const T& celix::impl::SharedPromiseState<T>::getValue() const & {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     return *data;
 }
 
 template<typename T>
 T&& celix::impl::SharedPromiseState<T>::getValue() && {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     return std::move(*data);
 }
 
 template<typename T>
 const T&& celix::impl::SharedPromiseState<T>::getValue() const && {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     return std::move(*data);
 }
 
 inline bool celix::impl::SharedPromiseState<void>::getValue() const {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     return true;
 }
 
 template<typename T>
 T celix::impl::SharedPromiseState<T>::moveOrGetValue() {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, true);
+    waitForAndCheckData(true);
     if constexpr (std::is_move_constructible_v<T>) {
         dataMoved = true;
         return std::move(*data);
@@ -482,25 +483,21 @@ inline int celix::impl::SharedPromiseState<void>::getPriority() const {
 
 template<typename T>
 void celix::impl::SharedPromiseState<T>::wait() const {
-    std::unique_lock<std::mutex> lck{mutex};
-    cond.wait(lck, [this]{return done;});
+    completion.wait();
 }
 
 inline void celix::impl::SharedPromiseState<void>::wait() const {
-    std::unique_lock<std::mutex> lck{mutex};
-    cond.wait(lck, [this]{return done;});
+    completion.wait();
 }
 
 template<typename T>
 std::exception_ptr celix::impl::SharedPromiseState<T>::getFailure() const {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, false);
+    waitForAndCheckData(false);
     return exp;
 }
 
 inline std::exception_ptr celix::impl::SharedPromiseState<void>::getFailure() const {
-    std::unique_lock<std::mutex> lck{mutex};
-    waitForAndCheckData(lck, false);
+    waitForAndCheckData(false);
     return exp;
 }
 
@@ -712,38 +709,14 @@ inline std::shared_ptr<celix::impl::SharedPromiseState<void>> celix::impl::Share
 }
 
 template<typename T>
-void celix::impl::SharedPromiseState<T>::addChain(std::function<void()> chainFunction) {
-    std::function<void()> localChain{};
-    {
-        std::lock_guard lck{mutex};
-        if (!done) {
-            chain.emplace_back([func = std::move(chainFunction)]() {
-                func();
-            });
-        } else {
-            localChain = std::move(chainFunction);
-        }
-    }
-    if (localChain) {
-        executor->execute(priority, std::move(localChain));
-    }
+template<typename F>
+void celix::impl::SharedPromiseState<T>::addChain(F&& chainFunction) {
+    completion.addContinuation(std::forward<F>(chainFunction), *executor, priority);
 }
 
-inline void celix::impl::SharedPromiseState<void>::addChain(std::function<void()> chainFunction) {
-    std::function<void()> localChain{};
-    {
-        std::lock_guard lck{mutex};
-        if (!done) {
-            chain.emplace_back([func = std::move(chainFunction)]() {
-                func();
-            });
-        } else {
-            localChain = std::move(chainFunction);
-        }
-    }
-    if (localChain) {
-        executor->execute(priority, std::move(localChain));
-    }
+template<typename F>
+void celix::impl::SharedPromiseState<void>::addChain(F&& chainFunction) {
+    completion.addContinuation(std::forward<F>(chainFunction), *executor, priority);
 }
 
 template<typename T>
@@ -836,56 +809,44 @@ inline std::shared_ptr<celix::impl::SharedPromiseState<void>> celix::impl::Share
 
 template<typename T>
 void celix::impl::SharedPromiseState<T>::addOnResolve(std::function<void(std::optional<T>, std::exception_ptr)> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
-        std::exception_ptr e;
-        {
-            std::lock_guard<std::mutex> lck{s->mutex};
-            e = s->exp;
-        }
+    addChain([s = self.lock(), callback = std::move(callback)] {
+        std::exception_ptr e = s->exp;
         if(e) {
             callback({}, e);
         } else {
             callback(s->getValue(), e);
         }
-    };
-    addChain(task);
+    });
 }
 
 inline void celix::impl::SharedPromiseState<void>::addOnResolve(std::function<void(std::optional<std::exception_ptr>)> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
-        std::exception_ptr e;
-        {
-            std::lock_guard<std::mutex> lck{s->mutex};
-            e = s->exp;
-        }
+    addChain([s = self.lock(), callback = std::move(callback)] {
+        std::exception_ptr e = s->exp;
         callback(e);
-    };
-    addChain(task);
+    });
 }
 
 template<typename T>
 void celix::impl::SharedPromiseState<T>::addOnSuccessConsumeCallback(std::function<void(T)> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
+    addChain([s = self.lock(), callback = std::move(callback)] {
         if (s->isSuccessfullyResolved()) {
             callback(s->getValue());
         }
-    };
-    addChain(task);
+    });
 }
 
 inline void celix::impl::SharedPromiseState<void>::addOnSuccessConsumeCallback(std::function<void()> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
+    addChain([s = self.lock(), callback = std::move(callback)] {
         if (s->isSuccessfullyResolved()) {
             s->getValue();
             callback();
         }
-    };
-    addChain(task);
+    });
 }
 
 template<typename T>
 void celix::impl::SharedPromiseState<T>::addOnFailureConsumeCallback(std::function<void(const std::exception&)> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
+    addChain([s = self.lock(), callback = std::move(callback)] {
         if (!s->isSuccessfullyResolved()) {
             try {
                 std::rethrow_exception(s->getFailure());
@@ -897,12 +858,11 @@ void celix::impl::SharedPromiseState<T>::addOnFailureConsumeCallback(std::functi
                 callback(logicError);
             }
         }
-    };
-    addChain(task);
+    });
 }
 
 inline void celix::impl::SharedPromiseState<void>::addOnFailureConsumeCallback(std::function<void(const std::exception&)> callback) {
-    std::function<void()> task = [s = self.lock(), callback = std::move(callback)] {
+    addChain([s = self.lock(), callback = std::move(callback)] {
         if (!s->isSuccessfullyResolved()) {
             try {
                 std::rethrow_exception(s->getFailure());
@@ -914,47 +874,14 @@ inline void celix::impl::SharedPromiseState<void>::addOnFailureConsumeCallback(s
                 callback(logicError);
             }
         }
-    };
-    addChain(task);
+    });
 }
 
 template<typename T>
-void celix::impl::SharedPromiseState<T>::complete(std::unique_lock<std::mutex>& lck) {
-    if (!lck.owns_lock()) {
-        lck.lock();
-    }
-    if (!done) {
-        done = true;
-        cond.notify_all();
-        while (!chain.empty()) {
-            std::vector<std::function<void()>> localChains{};
-            localChains.swap(chain);
-            lck.unlock();
-            for (auto &chainTask: localChains) {
-                executor->execute(priority, std::move(chainTask));
-            }
-            localChains.clear();
-            lck.lock();
-        }
-    }
+void celix::impl::SharedPromiseState<T>::complete() {
+    completion.complete(*executor, priority);
 }
 
-inline void celix::impl::SharedPromiseState<void>::complete(std::unique_lock<std::mutex>& lck) {
-    if (!lck.owns_lock()) {
-        lck.lock();
-    }
-    if (!done) {
-        done = true;
-        cond.notify_all();
-        while (!chain.empty()) {
-            std::vector<std::function<void()>> localChains{};
-            localChains.swap(chain);
-            lck.unlock();
-            for (auto &chainTask: localChains) {
-                executor->execute(priority, std::move(chainTask));
-            }
-            localChains.clear();
-            lck.lock();
-        }
-    }
+inline void celix::impl::SharedPromiseState<void>::complete() {
+    completion.complete(*executor, priority);
 }
\ No newline at end of file
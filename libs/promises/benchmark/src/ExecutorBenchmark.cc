@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+
+#include "celix/DefaultExecutor.h"
+#include "celix/ThreadPoolExecutor.h"
+#include "celix/PromiseFactory.h"
+
+/**
+ * Benchmark for the celix::IExecutor implementations.
+ *
+ * Compares the std::async based celix::DefaultExecutor with the work stealing celix::ThreadPoolExecutor for
+ * - tasks submitted from a single (non worker) thread,
+ * - tasks submitted from running tasks (fork/join style, stolen by idle workers) and
+ * - a chain of promise continuations.
+ */
+
+template<typename Executor>
+static std::shared_ptr<celix::IExecutor> createExecutor() {
+    return std::make_shared<Executor>();
+}
+
+template<typename Executor>
+static void ExecutorBenchmark_executeTasks(benchmark::State& state) {
+    auto executor = createExecutor<Executor>();
+    const auto nrOfTasks = state.range(0);
+    std::atomic<long> counter{0};
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfTasks; ++i) {
+            executor->execute([&counter]{ counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        executor->wait();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfTasks);
+}
+
+template<typename Executor>
+static void ExecutorBenchmark_executeNestedTasks(benchmark::State& state) {
+    auto executor = createExecutor<Executor>();
+    const long nrOfRootTasks = 8;
+    const auto nrOfNestedTasks = state.range(0) / nrOfRootTasks;
+    std::atomic<long> counter{0};
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfRootTasks; ++i) {
+            executor->execute([executor = executor.get(), nrOfNestedTasks, &counter] {
+                for (long j = 0; j < nrOfNestedTasks; ++j) {
+                    executor->execute([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        executor->wait();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfRootTasks * nrOfNestedTasks);
+}
+
+template<typename Executor>
+static void ExecutorBenchmark_promiseChain(benchmark::State& state) {
+    celix::PromiseFactory factory{createExecutor<Executor>()};
+    const auto chainLength = state.range(0);
+    for (auto _ : state) {
+        auto promise = factory.deferredTask<long>([](auto deferred) { deferred.resolve(0); });
+        for (long i = 0; i < chainLength; ++i) {
+            promise = promise.template map<long>([](long value) { return value + 1; });
+        }
+        benchmark::DoNotOptimize(promise.getValue());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * chainLength);
+}
+
+BENCHMARK_TEMPLATE(ExecutorBenchmark_executeTasks, celix::DefaultExecutor)->Arg(100)->Arg(1000)->UseRealTime();
+BENCHMARK_TEMPLATE(ExecutorBenchmark_executeTasks, celix::ThreadPoolExecutor)->Arg(100)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK_TEMPLATE(ExecutorBenchmark_executeNestedTasks, celix::DefaultExecutor)->Arg(1000)->UseRealTime();
+BENCHMARK_TEMPLATE(ExecutorBenchmark_executeNestedTasks, celix::ThreadPoolExecutor)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK_TEMPLATE(ExecutorBenchmark_promiseChain, celix::DefaultExecutor)->Arg(100)->UseRealTime();
+BENCHMARK_TEMPLATE(ExecutorBenchmark_promiseChain, celix::ThreadPoolExecutor)->Arg(100)->Arg(10000)->UseRealTime();
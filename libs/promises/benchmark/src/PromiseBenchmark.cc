@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+
+#include "celix/PromiseFactory.h"
+
+/**
+ * Benchmark for the promise core (celix::impl::SharedPromiseState).
+ *
+ * To measure the cost of the promise core and not the cost of the executor, most benchmarks use an executor which
+ * executes the tasks directly on the calling thread.
+ */
+
+namespace {
+    class InlineExecutor : public celix::IExecutor {
+    public:
+        void execute(int /*priority*/, std::function<void()> task) override {
+            task();
+        }
+
+        void wait() override {}
+    };
+}
+
+static void PromiseBenchmark_resolveAndGetValue(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<InlineExecutor>()};
+    for (auto _ : state) {
+        auto deferred = factory.deferred<long>();
+        deferred.resolve(42);
+        benchmark::DoNotOptimize(deferred.getPromise().getValue());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void PromiseBenchmark_continuationChain(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<InlineExecutor>()};
+    const auto chainLength = state.range(0);
+    for (auto _ : state) {
+        auto deferred = factory.deferred<long>();
+        auto promise = deferred.getPromise();
+        for (long i = 0; i < chainLength; ++i) {
+            promise = promise.map<long>([](long value) { return value + 1; });
+        }
+        deferred.resolve(0);
+        benchmark::DoNotOptimize(promise.getValue());
+    }
+    state.SetItemsProcessed(state.iterations() * chainLength);
+}
+
+static void PromiseBenchmark_onSuccessCallbacks(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<InlineExecutor>()};
+    const auto nrOfCallbacks = state.range(0);
+    long counter = 0;
+    for (auto _ : state) {
+        auto deferred = factory.deferred<long>();
+        auto promise = deferred.getPromise();
+        for (long i = 0; i < nrOfCallbacks; ++i) {
+            promise.onSuccess([&counter](long value) { counter += value; });
+        }
+        deferred.resolve(1);
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * nrOfCallbacks);
+}
+
+static void PromiseBenchmark_continuationChainOnThreadPool(benchmark::State& state) {
+    celix::PromiseFactory factory{};
+    const auto chainLength = state.range(0);
+    for (auto _ : state) {
+        auto deferred = factory.deferred<long>();
+        auto promise = deferred.getPromise();
+        for (long i = 0; i < chainLength; ++i) {
+            promise = promise.map<long>([](long value) { return value + 1; });
+        }
+        deferred.resolve(0);
+        benchmark::DoNotOptimize(promise.getValue());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * chainLength);
+}
+
+BENCHMARK(PromiseBenchmark_resolveAndGetValue);
+BENCHMARK(PromiseBenchmark_continuationChain)->Arg(5)->Arg(100);
+BENCHMARK(PromiseBenchmark_onSuccessCallbacks)->Arg(1)->Arg(10);
+BENCHMARK(PromiseBenchmark_continuationChainOnThreadPool)->Arg(5)->Arg(100)->UseRealTime();
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+#include "celix/PromiseFactory.h"
+#include "celix/ThreadPoolExecutor.h"
+
+/**
+ * Benchmark for the fan-in of promises with celix::PromiseFactory::all.
+ *
+ * Compares joining the promises with all (a single atomic countdown, no blocking) with joining the promises by
+ * blocking on every promise in turn.
+ */
+
+namespace {
+    class InlineExecutor : public celix::IExecutor {
+    public:
+        void execute(int /*priority*/, std::function<void()> task) override {
+            task();
+        }
+
+        void wait() override {}
+    };
+}
+
+static void PromiseCombinatorBenchmark_allInline(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<InlineExecutor>()};
+    const auto nrOfPromises = state.range(0);
+    for (auto _ : state) {
+        std::vector<celix::Deferred<long>> deferreds{};
+        std::vector<celix::Promise<long>> promises{};
+        deferreds.reserve(nrOfPromises);
+        promises.reserve(nrOfPromises);
+        for (long i = 0; i < nrOfPromises; ++i) {
+            deferreds.emplace_back(factory.deferred<long>());
+            promises.emplace_back(deferreds.back().getPromise());
+        }
+        auto all = factory.all(promises);
+        for (long i = 0; i < nrOfPromises; ++i) {
+            deferreds[i].resolve(i);
+        }
+        benchmark::DoNotOptimize(all.getValue().size());
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfPromises);
+}
+
+static void PromiseCombinatorBenchmark_allThreadPool(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<celix::ThreadPoolExecutor>()};
+    const auto nrOfPromises = state.range(0);
+    for (auto _ : state) {
+        std::vector<celix::Promise<long>> promises{};
+        promises.reserve(nrOfPromises);
+        for (long i = 0; i < nrOfPromises; ++i) {
+            promises.emplace_back(factory.deferredTask<long>([i](auto deferred) { deferred.resolve(i); }));
+        }
+        benchmark::DoNotOptimize(factory.all(promises).getValue().size());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * nrOfPromises);
+}
+
+static void PromiseCombinatorBenchmark_blockingJoinThreadPool(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<celix::ThreadPoolExecutor>()};
+    const auto nrOfPromises = state.range(0);
+    for (auto _ : state) {
+        std::vector<celix::Promise<long>> promises{};
+        promises.reserve(nrOfPromises);
+        for (long i = 0; i < nrOfPromises; ++i) {
+            promises.emplace_back(factory.deferredTask<long>([i](auto deferred) { deferred.resolve(i); }));
+        }
+        std::vector<long> values{};
+        values.reserve(nrOfPromises);
+        for (auto& promise : promises) {
+            values.emplace_back(promise.getValue());
+        }
+        benchmark::DoNotOptimize(values.size());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * nrOfPromises);
+}
+
+BENCHMARK(PromiseCombinatorBenchmark_allInline)->Arg(100)->Arg(10000);
+BENCHMARK(PromiseCombinatorBenchmark_allThreadPool)->Arg(10000)->UseRealTime();
+BENCHMARK(PromiseCombinatorBenchmark_blockingJoinThreadPool)->Arg(10000)->UseRealTime();
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "celix/DefaultScheduledExecutor.h"
+#include "celix/TimerScheduledExecutor.h"
+#include "celix/PromiseFactory.h"
+
+/**
+ * Benchmark for the celix::IScheduledExecutor implementations.
+ *
+ * Compares the thread per scheduled task celix::DefaultScheduledExecutor with the single timer thread
+ * celix::TimerScheduledExecutor for
+ * - scheduling and cancelling timeouts which are never reached (the common case for promise timeouts),
+ * - scheduling short delays and waiting until all of them are executed and
+ * - resolving promises with a timeout.
+ *
+ * Note that the DefaultScheduledExecutor uses an OS thread per scheduled task, so it is only benchmarked with
+ * a limited number of concurrent tasks.
+ */
+
+template<typename ScheduledExecutor>
+static void ScheduledExecutorBenchmark_scheduleAndCancel(benchmark::State& state) {
+    auto executor = std::make_shared<ScheduledExecutor>();
+    const auto nrOfTimeouts = state.range(0);
+    std::vector<std::shared_ptr<celix::IScheduledFuture>> futures{};
+    futures.reserve(nrOfTimeouts);
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfTimeouts; ++i) {
+            futures.emplace_back(executor->schedule(std::chrono::seconds{30}, []{}));
+        }
+        for (auto& future : futures) {
+            future->cancel();
+        }
+        futures.clear();
+        executor->wait();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfTimeouts);
+}
+
+template<typename ScheduledExecutor>
+static void ScheduledExecutorBenchmark_scheduleAndExecute(benchmark::State& state) {
+    auto executor = std::make_shared<ScheduledExecutor>();
+    const auto nrOfTasks = state.range(0);
+    std::atomic<long> counter{0};
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfTasks; ++i) {
+            executor->schedule(std::chrono::milliseconds{1 + i % 10}, [&counter]{ counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        executor->wait();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfTasks);
+}
+
+template<typename ScheduledExecutor>
+static void ScheduledExecutorBenchmark_resolvePromisesWithTimeout(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<celix::ThreadPoolExecutor>(), std::make_shared<ScheduledExecutor>()};
+    const auto nrOfPromises = state.range(0);
+    std::vector<celix::Deferred<long>> deferreds{};
+    deferreds.reserve(nrOfPromises);
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfPromises; ++i) {
+            auto deferred = factory.deferred<long>();
+            deferred.getPromise().setTimeout(std::chrono::seconds{30});
+            deferreds.emplace_back(std::move(deferred));
+        }
+        for (auto& deferred : deferreds) {
+            deferred.resolve(42);
+        }
+        deferreds.clear();
+        factory.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfPromises);
+}
+
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_scheduleAndCancel, celix::DefaultScheduledExecutor)->Arg(100)->UseRealTime();
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_scheduleAndCancel, celix::TimerScheduledExecutor)->Arg(100)->Arg(100000)->UseRealTime();
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_scheduleAndExecute, celix::DefaultScheduledExecutor)->Arg(100)->UseRealTime();
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_scheduleAndExecute, celix::TimerScheduledExecutor)->Arg(100)->Arg(100000)->UseRealTime();
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_resolvePromisesWithTimeout, celix::DefaultScheduledExecutor)->Arg(100)->UseRealTime();
+BENCHMARK_TEMPLATE(ScheduledExecutorBenchmark_resolvePromisesWithTimeout, celix::TimerScheduledExecutor)->Arg(100)->Arg(100000)->UseRealTime();
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#include "celix/Task.h"
+#include "celix/ThreadPoolExecutor.h"
+
+/**
+ * Benchmark for sequential asynchronous steps with C++20 coroutines (celix::Task) compared to the equivalent
+ * celix::Promise::flatMap chain.
+ *
+ * Every step is an asynchronous call (a deferred task) followed by a transformation of the result.
+ */
+
+namespace {
+    class InlineExecutor : public celix::IExecutor {
+    public:
+        void execute(int /*priority*/, std::function<void()> task) override {
+            task();
+        }
+
+        void wait() override {}
+    };
+
+    celix::Promise<long> asyncStep(const celix::PromiseFactory& factory, long value) {
+        return factory.deferredTask<long>([value](auto deferred) { deferred.resolve(value + 1); });
+    }
+
+    celix::Task<long> coroutineSteps(const celix::PromiseFactory& factory, long nrOfSteps) {
+        long value = 0;
+        for (long i = 0; i < nrOfSteps; ++i) {
+            value = co_await asyncStep(factory, value) * 2 / 2;
+        }
+        co_return value;
+    }
+}
+
+template<typename Executor>
+static void TaskBenchmark_thenChain(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<Executor>()};
+    const auto nrOfSteps = state.range(0);
+    for (auto _ : state) {
+        auto promise = factory.resolved<long>(0);
+        for (long i = 0; i < nrOfSteps; ++i) {
+            promise = promise.template flatMap<long>([&factory](long value) {
+                return asyncStep(factory, value).template map<long>([](long v) { return v * 2 / 2; });
+            });
+        }
+        benchmark::DoNotOptimize(promise.getValue());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * nrOfSteps);
+}
+
+template<typename Executor>
+static void TaskBenchmark_coroutine(benchmark::State& state) {
+    celix::PromiseFactory factory{std::make_shared<Executor>()};
+    const auto nrOfSteps = state.range(0);
+    for (auto _ : state) {
+        auto promise = coroutineSteps(factory, nrOfSteps).start(factory);
+        benchmark::DoNotOptimize(promise.getValue());
+    }
+    factory.wait();
+    state.SetItemsProcessed(state.iterations() * nrOfSteps);
+}
+
+BENCHMARK_TEMPLATE(TaskBenchmark_thenChain, InlineExecutor)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(TaskBenchmark_coroutine, InlineExecutor)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(TaskBenchmark_thenChain, celix::ThreadPoolExecutor)->Arg(10)->Arg(1000)->UseRealTime();
+BENCHMARK_TEMPLATE(TaskBenchmark_coroutine, celix::ThreadPoolExecutor)->Arg(10)->Arg(1000)->UseRealTime();
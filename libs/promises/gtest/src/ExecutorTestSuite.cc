@@ -24,6 +24,9 @@
 
 #include "celix/DefaultExecutor.h"
 #include "celix/DefaultScheduledExecutor.h"
+#include "celix/ThreadPoolExecutor.h"
+#include "celix/TimerScheduledExecutor.h"
+#include "celix/PromiseFactory.h"
 
 class ExecutorTestSuite : public ::testing::Test {
 public:
@@ -53,4 +56,200 @@ TEST_F(ExecutorTestSuite, ScheduledExecuteTasks) {
     auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
     EXPECT_EQ(3, counter.load());
     EXPECT_GT(diff, std::chrono::milliseconds{49});
-}
\ No newline at end of file
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolExecuteTasks) {
+    celix::ThreadPoolExecutor pool{1, 4};
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 1000; ++i) {
+        pool.execute([&counter]{counter++;});
+    }
+    pool.wait();
+    EXPECT_EQ(1000, counter.load());
+    EXPECT_EQ(0, pool.getNrOfPendingTasks());
+    EXPECT_GE(pool.getNrOfThreads(), 1);
+    EXPECT_LE(pool.getNrOfThreads(), 4);
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolWaitIncludesNestedTasks) {
+    celix::ThreadPoolExecutor pool{1, 4};
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 10; ++i) {
+        pool.execute([&pool, &counter]{
+            //note nested tasks are added to the queue of the current worker and can be stolen by other workers
+            for (int j = 0; j < 100; ++j) {
+                pool.execute([&counter]{
+                    std::this_thread::sleep_for(std::chrono::microseconds{10});
+                    counter++;
+                });
+            }
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolHonorsPriority) {
+    celix::ThreadPoolExecutor pool{1, 1};
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    bool started = false;
+    bool release = false;
+    std::vector<int> order{};
+
+    //block the single worker, so that the next tasks are queued
+    pool.execute([&]{
+        std::unique_lock lck{mutex};
+        started = true;
+        cond.notify_all();
+        cond.wait(lck, [&]{ return release; });
+    });
+    {
+        std::unique_lock lck{mutex};
+        cond.wait(lck, [&]{ return started; });
+    }
+    pool.execute(-1, [&]{ std::lock_guard lck{mutex}; order.push_back(-1); });
+    pool.execute(0, [&]{ std::lock_guard lck{mutex}; order.push_back(0); });
+    pool.execute(10, [&]{ std::lock_guard lck{mutex}; order.push_back(10); });
+    pool.execute(0, [&]{ std::lock_guard lck{mutex}; order.push_back(1); }); //same priority, after the first 0
+    {
+        std::lock_guard lck{mutex};
+        release = true;
+        cond.notify_all();
+    }
+    pool.wait();
+    std::vector<int> expected{10, 0, 1, -1};
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolGrowsForBlockingTasksAndShrinksWhenIdle) {
+    celix::ThreadPoolExecutor pool{1, 8, std::chrono::milliseconds{10}};
+    std::promise<void> release{};
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> running{0};
+    for (int i = 0; i < 4; ++i) {
+        pool.execute([&running, released]{
+            running++;
+            released.wait();
+        });
+    }
+    //all 4 blocking tasks must run concurrently, otherwise this will timeout
+    auto start = std::chrono::steady_clock::now();
+    while (running.load() < 4 && std::chrono::steady_clock::now() - start < std::chrono::seconds{5}) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(4, running.load());
+    EXPECT_GE(pool.getNrOfThreads(), 4);
+    release.set_value();
+    pool.wait();
+
+    start = std::chrono::steady_clock::now();
+    while (pool.getNrOfThreads() > 1 && std::chrono::steady_clock::now() - start < std::chrono::seconds{5}) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    EXPECT_EQ(1, pool.getNrOfThreads());
+
+    //the pool can grow again after shrinking
+    std::atomic<int> counter{0};
+    pool.execute([&counter]{counter++;});
+    pool.wait();
+    EXPECT_EQ(1, counter.load());
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolIgnoresTaskExceptions) {
+    celix::ThreadPoolExecutor pool{1, 1};
+    std::atomic<int> counter{0};
+    pool.execute([]{ throw std::logic_error{"test"}; });
+    pool.execute([&counter]{counter++;});
+    pool.wait();
+    EXPECT_EQ(1, counter.load());
+}
+
+TEST_F(ExecutorTestSuite, ThreadPoolAsPromiseFactoryExecutor) {
+    //note the thread pool is opt-in, the default executor of a promise factory is the celix::DefaultExecutor
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<celix::DefaultExecutor>(celix::PromiseFactory{}.getExecutor()));
+
+    celix::PromiseFactory factory{std::make_shared<celix::ThreadPoolExecutor>()};
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<celix::ThreadPoolExecutor>(factory.getExecutor()));
+
+    auto promise = factory.deferredTask<int>([](auto deferred) {
+        deferred.resolve(42);
+    }).map<int>([](int value) {
+        return value + 1;
+    });
+    EXPECT_EQ(43, promise.getValue());
+}
+
+TEST_F(ExecutorTestSuite, TimerScheduledExecuteTasks) {
+    celix::TimerScheduledExecutor timer{executor};
+    std::mutex mutex{};
+    std::vector<int> order{};
+    auto t1 = std::chrono::steady_clock::now();
+    timer.schedule(std::chrono::milliseconds{60}, [&]{ std::lock_guard lck{mutex}; order.push_back(3); });
+    timer.schedule(std::chrono::milliseconds{20}, [&]{ std::lock_guard lck{mutex}; order.push_back(1); });
+    timer.schedule(std::chrono::milliseconds{40}, [&]{ std::lock_guard lck{mutex}; order.push_back(2); });
+    timer.schedule(std::chrono::milliseconds{0}, [&]{ std::lock_guard lck{mutex}; order.push_back(0); });
+    timer.wait();
+    auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t1);
+    std::vector<int> expected{0, 1, 2, 3};
+    EXPECT_EQ(expected, order);
+    EXPECT_GT(diff, std::chrono::milliseconds{59});
+    EXPECT_EQ(0, timer.getNrOfScheduledTasks());
+}
+
+TEST_F(ExecutorTestSuite, TimerScheduledCancelTasks) {
+    celix::TimerScheduledExecutor timer{executor};
+    std::atomic<int> counter{0};
+    auto future1 = timer.schedule(std::chrono::milliseconds{20}, [&counter]{counter++;});
+    auto future2 = timer.schedule(std::chrono::hours{1}, [&counter]{counter++;});
+    EXPECT_EQ(2, timer.getNrOfScheduledTasks());
+    future2->cancel();
+    EXPECT_TRUE(future2->isCancelled());
+    EXPECT_TRUE(future2->isDone());
+
+    //wait does not wait for the cancelled task
+    timer.wait();
+    EXPECT_EQ(1, counter.load());
+    EXPECT_TRUE(future1->isDone());
+    EXPECT_FALSE(future1->isCancelled());
+    future1->cancel(); //no effect on a done task
+    EXPECT_FALSE(future1->isCancelled());
+}
+
+TEST_F(ExecutorTestSuite, TimerScheduledCompactsCancelledTasks) {
+    celix::TimerScheduledExecutor timer{executor};
+    std::vector<std::shared_ptr<celix::IScheduledFuture>> futures{};
+    for (int i = 0; i < 1000; ++i) {
+        futures.emplace_back(timer.schedule(std::chrono::hours{1}, []{}));
+    }
+    EXPECT_EQ(1000, timer.getHeapSize());
+    for (auto& future : futures) {
+        future->cancel();
+    }
+    EXPECT_EQ(0, timer.getNrOfScheduledTasks());
+    EXPECT_LT(timer.getHeapSize(), 64);
+    timer.wait();
+}
+
+TEST_F(ExecutorTestSuite, TimerScheduledCancelsTasksOnDestruction) {
+    std::atomic<int> counter{0};
+    std::shared_ptr<celix::IScheduledFuture> future{};
+    {
+        celix::TimerScheduledExecutor timer{executor};
+        future = timer.schedule(std::chrono::hours{1}, [&counter]{counter++;});
+    }
+    EXPECT_TRUE(future->isCancelled());
+    future->cancel(); //no effect after the scheduled executor is destroyed
+    EXPECT_EQ(0, counter.load());
+}
+
+TEST_F(ExecutorTestSuite, TimerScheduledIsDefaultPromiseFactoryScheduledExecutor) {
+    celix::PromiseFactory factory{};
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<celix::TimerScheduledExecutor>(factory.getScheduledExecutor()));
+
+    auto deferred = factory.deferred<int>();
+    auto promise = deferred.getPromise().timeout(std::chrono::milliseconds{10});
+    promise.wait();
+    EXPECT_THROW(std::rethrow_exception(promise.getFailure()), celix::PromiseTimeoutException);
+    deferred.resolve(42);
+}
@@ -789,6 +789,169 @@ TEST_F(PromiseTestSuite, testTryFailAndResolve) {
     EXPECT_EQ(successCount.load(), 0);
 }
 
+TEST_F(PromiseTestSuite, flatMap) {
+    auto def = factory->deferred<int>();
+    auto p = def.getPromise().flatMap<std::string>([this](int value) {
+        return factory->deferredTask<std::string>([value](auto d) { d.resolve(std::to_string(value + 1)); });
+    });
+    def.resolve(41);
+    EXPECT_EQ("42", p.getValue());
+
+    //failing source promise
+    auto failingDef = factory->deferred<int>();
+    auto failing = failingDef.getPromise().flatMap<std::string>([this](int) { return factory->resolved<std::string>("never"); });
+    failingDef.fail(std::logic_error{"source failed"});
+    failing.wait();
+    EXPECT_THROW(std::rethrow_exception(failing.getFailure()), std::logic_error);
+
+    //failing mapped promise
+    auto failingMapped = factory->resolved<int>(1).flatMap<std::string>([this](int) {
+        return factory->failed<std::string>(std::make_exception_ptr(std::logic_error{"mapped failed"}));
+    });
+    failingMapped.wait();
+    EXPECT_THROW(std::rethrow_exception(failingMapped.getFailure()), std::logic_error);
+
+    //throwing mapper
+    auto throwing = factory->resolved<int>(1).flatMap<std::string>([](int) -> celix::Promise<std::string> {
+        throw std::logic_error{"mapper failed"};
+    });
+    throwing.wait();
+    EXPECT_THROW(std::rethrow_exception(throwing.getFailure()), std::logic_error);
+    factory->wait();
+}
+
+TEST_F(PromiseTestSuite, all) {
+    std::vector<celix::Deferred<int>> deferreds{};
+    std::vector<celix::Promise<int>> promises{};
+    for (int i = 0; i < 10; ++i) {
+        deferreds.emplace_back(factory->deferred<int>());
+        promises.emplace_back(deferreds.back().getPromise());
+    }
+    auto all = factory->all(promises);
+    //resolve in reverse order, the result should still be in the order of the provided promises
+    for (int i = 9; i >= 0; --i) {
+        EXPECT_FALSE(all.isDone());
+        deferreds[i].resolve(i);
+    }
+    auto values = all.getValue();
+    ASSERT_EQ(10, values.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i, values[i]);
+    }
+    //the values are copied, so the provided promises are still usable
+    EXPECT_EQ(3, promises[3].getValue());
+
+    //empty list
+    auto empty = factory->all(std::vector<celix::Promise<int>>{});
+    EXPECT_TRUE(empty.getValue().empty());
+    factory->wait();
+}
+
+TEST_F(PromiseTestSuite, allFailsOnFirstFailure) {
+    auto def1 = factory->deferred<int>();
+    auto def2 = factory->deferred<int>();
+    auto all = factory->all<int>({def1.getPromise(), def2.getPromise()});
+    def2.fail(std::logic_error{"failed"});
+    all.wait();
+    EXPECT_THROW(std::rethrow_exception(all.getFailure()), std::logic_error);
+    def1.resolve(1); //note resolving after the fan-in failed has no effect
+    factory->wait();
+    EXPECT_FALSE(all.isSuccessfullyResolved());
+}
+
+TEST_F(PromiseTestSuite, any) {
+    auto def1 = factory->deferred<int>();
+    auto def2 = factory->deferred<int>();
+    auto def3 = factory->deferred<int>();
+    auto any = factory->any<int>({def1.getPromise(), def2.getPromise(), def3.getPromise()});
+    def1.fail(std::logic_error{"failed"});
+    def2.resolve(2);
+    EXPECT_EQ(2, any.getValue());
+    def3.resolve(3);
+
+    //all failing
+    auto fail1 = factory->deferred<int>();
+    auto fail2 = factory->deferred<int>();
+    auto allFailed = factory->any<int>({fail1.getPromise(), fail2.getPromise()});
+    fail1.fail(std::logic_error{"failed"});
+    fail2.fail(std::logic_error{"failed"});
+    allFailed.wait();
+    EXPECT_THROW(std::rethrow_exception(allFailed.getFailure()), std::logic_error);
+
+    //empty list
+    auto empty = factory->any(std::vector<celix::Promise<int>>{});
+    empty.wait();
+    EXPECT_THROW(std::rethrow_exception(empty.getFailure()), celix::PromiseInvocationException);
+    factory->wait();
+}
+
+TEST_F(PromiseTestSuite, race) {
+    auto def1 = factory->deferred<int>();
+    auto def2 = factory->deferred<int>();
+    auto race = factory->race<int>({def1.getPromise(), def2.getPromise()});
+    def2.resolve(2);
+    EXPECT_EQ(2, race.getValue());
+    def1.resolve(1);
+
+    auto fail1 = factory->deferred<int>();
+    auto fail2 = factory->deferred<int>();
+    auto failedRace = factory->race<int>({fail1.getPromise(), fail2.getPromise()});
+    fail1.fail(std::logic_error{"failed"});
+    failedRace.wait();
+    EXPECT_THROW(std::rethrow_exception(failedRace.getFailure()), std::logic_error);
+    fail2.resolve(2);
+
+    auto empty = factory->race(std::vector<celix::Promise<int>>{});
+    empty.wait();
+    EXPECT_THROW(std::rethrow_exception(empty.getFailure()), celix::PromiseInvocationException);
+    factory->wait();
+}
+
+TEST_F(PromiseTestSuite, allAnyAndRaceConsumeNonCopyableValues) {
+    auto def1 = factory->deferred<std::unique_ptr<int>>();
+    auto def2 = factory->deferred<std::unique_ptr<int>>();
+    auto promise1 = def1.getPromise();
+    auto all = factory->all<std::unique_ptr<int>>({promise1, def2.getPromise()});
+    def1.resolve(std::make_unique<int>(1));
+    def2.resolve(std::make_unique<int>(2));
+    auto values = all.moveOrGetValue();
+    ASSERT_EQ(2, values.size());
+    EXPECT_EQ(1, *values[0]);
+    EXPECT_EQ(2, *values[1]);
+    //the values are moved out of the provided promises
+    EXPECT_THROW(promise1.getValue(), celix::PromiseInvocationException);
+
+    auto anyDef = factory->deferred<std::unique_ptr<int>>();
+    auto anyPromise = anyDef.getPromise();
+    auto any = factory->any<std::unique_ptr<int>>({anyPromise});
+    anyDef.resolve(std::make_unique<int>(3));
+    EXPECT_EQ(3, *any.moveOrGetValue());
+    EXPECT_THROW(anyPromise.getValue(), celix::PromiseInvocationException);
+
+    auto raceDef = factory->deferred<std::unique_ptr<int>>();
+    auto racePromise = raceDef.getPromise();
+    auto race = factory->race<std::unique_ptr<int>>({racePromise});
+    raceDef.resolve(std::make_unique<int>(4));
+    EXPECT_EQ(4, *race.moveOrGetValue());
+    EXPECT_THROW(racePromise.getValue(), celix::PromiseInvocationException);
+    factory->wait();
+}
+
+TEST_F(PromiseTestSuite, allWithManyConcurrentlyResolvedPromises) {
+    auto pool = std::make_shared<celix::ThreadPoolExecutor>(4, 4);
+    celix::PromiseFactory poolFactory{pool};
+    std::vector<celix::Promise<long>> promises{};
+    for (long i = 0; i < 1000; ++i) {
+        promises.emplace_back(poolFactory.deferredTask<long>([i](auto d) { d.resolve(i); }));
+    }
+    auto values = poolFactory.all(promises).getValue();
+    ASSERT_EQ(1000, values.size());
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i, values[i]);
+    }
+    poolFactory.wait();
+}
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
@@ -0,0 +1,174 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "celix/Task.h"
+#include "celix/ThreadPoolExecutor.h"
+
+class TaskTestSuite : public ::testing::Test {
+public:
+    ~TaskTestSuite() noexcept override {
+        factory->wait();
+    }
+
+    std::shared_ptr<celix::ThreadPoolExecutor> executor = std::make_shared<celix::ThreadPoolExecutor>(2, 4);
+    std::shared_ptr<celix::PromiseFactory> factory = std::make_shared<celix::PromiseFactory>(executor);
+};
+
+static celix::Task<long> addOneAsync(const celix::PromiseFactory& factory, long value) {
+    auto promise = factory.deferredTask<long>([value](auto deferred) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        deferred.resolve(value + 1);
+    });
+    co_return co_await promise;
+}
+
+TEST_F(TaskTestSuite, awaitPromise) {
+    auto task = [](const celix::PromiseFactory& f) -> celix::Task<std::string> {
+        auto value = co_await f.deferredTask<long>([](auto deferred) { deferred.resolve(41); });
+        co_return std::to_string(value + 1);
+    };
+    auto promise = task(*factory).start(*factory);
+    EXPECT_EQ("42", promise.getValue());
+}
+
+TEST_F(TaskTestSuite, awaitResolvedPromiseAndDeferred) {
+    auto def = factory->deferred<int>();
+    auto task = [](celix::Promise<int> resolved, celix::Deferred<int> deferred) -> celix::Task<int> {
+        int a = co_await resolved;
+        int b = co_await deferred;
+        co_return a + b;
+    };
+    auto promise = task(factory->resolved(1), def).start(*factory);
+    def.resolve(2);
+    EXPECT_EQ(3, promise.getValue());
+}
+
+TEST_F(TaskTestSuite, awaitNestedTasks) {
+    auto task = [](const celix::PromiseFactory& f) -> celix::Task<long> {
+        long value = 0;
+        for (int i = 0; i < 10; ++i) {
+            value = co_await addOneAsync(f, value);
+        }
+        co_return value;
+    };
+    EXPECT_EQ(10, task(*factory).start(*factory).getValue());
+}
+
+TEST_F(TaskTestSuite, failedPromiseThrowsInCoroutine) {
+    auto task = [](const celix::PromiseFactory& f) -> celix::Task<int> {
+        try {
+            co_await f.failed<int>(std::make_exception_ptr(std::logic_error{"failed"}));
+        } catch (const std::logic_error&) {
+            co_return 1;
+        }
+        co_return 2;
+    };
+    EXPECT_EQ(1, task(*factory).start(*factory).getValue());
+}
+
+TEST_F(TaskTestSuite, exceptionFailsStartedTask) {
+    auto task = []() -> celix::Task<int> {
+        throw std::logic_error{"failed"};
+        co_return 1;
+    };
+    auto promise = task().start(*factory);
+    promise.wait();
+    EXPECT_THROW(std::rethrow_exception(promise.getFailure()), std::logic_error);
+
+    auto outer = []() -> celix::Task<int> {
+        auto inner = []() -> celix::Task<int> {
+            throw std::logic_error{"failed"};
+            co_return 1;
+        };
+        try {
+            co_await inner();
+        } catch (const std::logic_error&) {
+            co_return 42;
+        }
+        co_return 0;
+    };
+    EXPECT_EQ(42, outer().start(*factory).getValue());
+}
+
+TEST_F(TaskTestSuite, voidTask) {
+    std::atomic<int> count{0};
+    auto task = [](const celix::PromiseFactory& f, std::atomic<int>& c) -> celix::Task<> {
+        co_await f.deferredTask<void>([](auto deferred) { deferred.resolve(); });
+        c.fetch_add(1);
+        co_await f.resolved();
+        c.fetch_add(1);
+    };
+    auto promise = task(*factory, count).start(*factory);
+    promise.wait();
+    EXPECT_TRUE(promise.isSuccessfullyResolved());
+    EXPECT_EQ(2, count.load());
+}
+
+TEST_F(TaskTestSuite, moveOnlyValues) {
+    auto task = [](const celix::PromiseFactory& f) -> celix::Task<std::unique_ptr<int>> {
+        auto ptr = co_await f.deferredTask<std::unique_ptr<int>>([](auto deferred) {
+            deferred.resolve(std::make_unique<int>(42));
+        });
+        co_return ptr;
+    };
+    auto promise = task(*factory).start(*factory);
+    EXPECT_EQ(42, *promise.moveOrGetValue());
+}
+
+TEST_F(TaskTestSuite, notStartedTaskIsDestroyed) {
+    auto value = std::make_shared<int>(1);
+    {
+        auto task = [](std::shared_ptr<int> v) -> celix::Task<int> { co_return *v; };
+        auto t = task(value);
+        EXPECT_TRUE(t.isValid());
+        EXPECT_EQ(2, value.use_count());
+    }
+    EXPECT_EQ(1, value.use_count());
+}
+
+TEST_F(TaskTestSuite, invalidTask) {
+    auto task = []() -> celix::Task<int> { co_return 1; };
+    auto t = task();
+    auto promise = std::move(t).start(*factory);
+    EXPECT_FALSE(t.isValid()); // NOLINT(bugprone-use-after-move)
+    EXPECT_THROW((void)std::move(t).start(*factory), celix::PromiseInvocationException); // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(1, promise.getValue());
+}
+
+TEST_F(TaskTestSuite, manyConcurrentTasks) {
+    auto task = [](const celix::PromiseFactory& f, long i) -> celix::Task<long> {
+        auto value = co_await f.deferredTask<long>([i](auto deferred) { deferred.resolve(i); });
+        co_return value * 2;
+    };
+    std::vector<celix::Promise<long>> promises{};
+    for (long i = 0; i < 1000; ++i) {
+        promises.emplace_back(task(*factory, i).start(*factory));
+    }
+    auto values = factory->all(promises).getValue();
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i * 2, values[i]);
+    }
+}
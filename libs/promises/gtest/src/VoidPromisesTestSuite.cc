@@ -606,3 +606,40 @@ TEST_F(VoidPromiseTestSuite, testTryFailAndResolve) {
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
+
+TEST_F(VoidPromiseTestSuite, flatMap) {
+    auto def = factory->deferred<void>();
+    auto p = def.getPromise().flatMap<int>([this] { return factory->resolved<int>(42); });
+    def.resolve();
+    EXPECT_EQ(42, p.getValue());
+
+    auto failing = factory->failed<void>(std::make_exception_ptr(std::logic_error{"failed"})).flatMap<int>([this] { return factory->resolved<int>(42); });
+    failing.wait();
+    EXPECT_THROW(std::rethrow_exception(failing.getFailure()), std::logic_error);
+}
+
+TEST_F(VoidPromiseTestSuite, allAnyAndRace) {
+    auto def1 = factory->deferred<void>();
+    auto def2 = factory->deferred<void>();
+    auto all = factory->all({def1.getPromise(), def2.getPromise()});
+    auto any = factory->any<void>({def1.getPromise(), def2.getPromise()});
+    auto race = factory->race<void>({def1.getPromise(), def2.getPromise()});
+    def1.resolve();
+    any.wait();
+    race.wait();
+    EXPECT_TRUE(any.isSuccessfullyResolved());
+    EXPECT_TRUE(race.isSuccessfullyResolved());
+    def2.resolve();
+    all.wait();
+    EXPECT_TRUE(all.isSuccessfullyResolved());
+
+    auto failDef = factory->deferred<void>();
+    auto failedAll = factory->all({factory->resolved(), failDef.getPromise()});
+    failDef.fail(std::logic_error{"failed"});
+    failedAll.wait();
+    EXPECT_THROW(std::rethrow_exception(failedAll.getFailure()), std::logic_error);
+
+    auto empty = factory->all(std::vector<celix::Promise<void>>{});
+    empty.wait();
+    EXPECT_TRUE(empty.isSuccessfullyResolved());
+}
@@ -0,0 +1,56 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace celix {
+
+    /**
+     * @brief What a buffered push stream does with an event if its buffer is full.
+     */
+    enum class QueuePolicyOption : std::uint8_t {
+        GROW,           //the event is queued in an unbounded overflow queue, so no event is blocked or discarded
+        BLOCK,          //the publishing thread waits until there is room in the buffer
+        DISCARD_OLDEST, //the oldest event in the buffer is discarded
+        DISCARD_NEWEST, //the new event is discarded
+        FAIL            //the stream fails with an IllegalStateException, the buffered events are discarded
+    };
+
+    /**
+     * @brief The back-pressure (in milliseconds) a buffered push stream returns to the event source.
+     */
+    enum class PushbackPolicyOption : std::uint8_t {
+        FIXED,          //always the pushback time
+        ON_FULL_FIXED,  //the pushback time if the buffer is full, otherwise 0
+        LINEAR          //the pushback time scaled with the buffer fill level
+    };
+
+    /**
+     * @brief The buffer options of a buffered push stream.
+     */
+    struct BufferOptions {
+        std::size_t bufferSize{1024}; //rounded up to a power of 2
+        QueuePolicyOption queuePolicy{QueuePolicyOption::GROW};
+        PushbackPolicyOption pushbackPolicy{PushbackPolicyOption::ON_FULL_FIXED};
+        long pushbackTime{0}; //in milliseconds
+    };
+}
@@ -20,6 +20,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <utility>
+
 #include "celix/IllegalStateException.h"
 
 namespace celix {
@@ -48,13 +51,14 @@ namespace celix {
     class DataPushEvent: public PushEvent<T> {
     public:
         explicit DataPushEvent(const T& _data);
+        explicit DataPushEvent(T&& _data);
 
         inline const T& getData() const override;
 
         std::unique_ptr<PushEvent<T>> clone() const override ;
 
     private:
-        const T data;
+        T data; //note not const, so that a data event can be moved
     };
 
     template <typename T>
@@ -107,6 +111,11 @@ celix::DataPushEvent<T>::DataPushEvent(const T& _data) :
     celix::PushEvent<T>::PushEvent{celix::PushEvent<T>::EventType::DATA}, data{_data} {
 }
 
+template<typename T>
+celix::DataPushEvent<T>::DataPushEvent(T&& _data) :
+    celix::PushEvent<T>::PushEvent{celix::PushEvent<T>::EventType::DATA}, data{std::move(_data)} {
+}
+
 template<typename T>
 inline const T& celix::DataPushEvent<T>::getData() const {
     return this->data;
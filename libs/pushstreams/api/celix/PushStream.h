@@ -23,6 +23,10 @@
 #include <iostream>
 #include <queue>
 #include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 
 #include "celix/IAutoCloseable.h"
 
@@ -93,6 +97,93 @@ namespace celix {
          */
         [[nodiscard]] std::vector<std::shared_ptr<PushStream<T>>> split(std::vector<PredicateFunction> predicates);
 
+        /**
+         * @brief Collects the events in windows and sends every window downstream as a single vector event.
+         *
+         * A window starts with the first event after the previous window and is sent downstream when the duration
+         * since the start of the window has elapsed, or when the window contains maxEvents events.
+         * The elapsed windows are sent downstream by a task on the scheduled executor of the promise factory.
+         * A non-empty window is sent downstream before a close or error event.
+         * @param duration The max duration of a window, a duration of zero means no time limit.
+         * @param maxEvents The max number of events in a window, 0 means no limit.
+         * @throws std::invalid_argument if both the duration and maxEvents are 0.
+         * @return a new IntermediateStream
+         */
+        [[nodiscard]] PushStream<std::vector<T>>& window(std::chrono::milliseconds duration, std::size_t maxEvents = 0);
+
+        /**
+         * @brief Sends the events downstream in batches (vectors) of maxEvents events.
+         * A non-empty partial batch is sent downstream before a close or error event.
+         * @param maxEvents The number of events in a batch.
+         * @throws std::invalid_argument if maxEvents is 0.
+         * @return a new IntermediateStream
+         */
+        [[nodiscard]] PushStream<std::vector<T>>& batch(std::size_t maxEvents);
+
+        /**
+         * @brief Coalesces events using the accumulator. The accumulator is called for every event and an event is
+         * sent downstream when the accumulator returns a value.
+         * @param accumulator Stateful function which accumulates the events.
+         * @tparam R The resulting Type
+         * @return a new IntermediateStream
+         */
+        template<typename R>
+        [[nodiscard]] PushStream<R>& coalesce(std::function<std::optional<R>(const T&)> accumulator);
+
+        /**
+         * @brief Coalesces every count events into a single event using the provided function.
+         * @param count The number of events to coalesce.
+         * @param coalescer Function which combines the events.
+         * @tparam R The resulting Type
+         * @throws std::invalid_argument if count is 0.
+         * @return a new IntermediateStream
+         */
+        template<typename R>
+        [[nodiscard]] PushStream<R>& coalesce(std::size_t count, std::function<R(std::vector<T>&&)> coalescer);
+
+        /**
+         * @brief Adjusts the back-pressure (in milliseconds) returned upstream for an event.
+         * @param adjustment Function called with the event and the back-pressure returned by the downstream.
+         * @return a new IntermediateStream
+         */
+        [[nodiscard]] PushStream<T>& adjustBackPressure(std::function<long(const T&, long)> adjustment);
+
+        /**
+         * @brief Adjusts the back-pressure (in milliseconds) returned upstream.
+         * @param adjustment Function called with the back-pressure returned by the downstream.
+         * @return a new IntermediateStream
+         */
+        [[nodiscard]] PushStream<T>& adjustBackPressure(std::function<long(long)> adjustment);
+
+        /**
+         * @brief Maps the events in parallel, using max nrOfWorkers workers on the executor of the promise factory.
+         *
+         * The events are queued, with a sequence number, in a bounded buffer and the workers map the queued events
+         * concurrently. If ordered, the mapped events are merged back in the original order (using the sequence
+         * numbers) and sent downstream one at the time. If not ordered, the mapped events are sent downstream
+         * concurrently by the workers, so the downstream stages must be thread-safe.
+         * A close or error event is sent downstream after all preceding events. If a mapping fails, the stream ends
+         * with its error, which is sent downstream after the data events that are already being sent downstream.
+         * @param nrOfWorkers The max number of concurrent workers.
+         * @param mapper Function which maps the events, called concurrently.
+         * @param ordered Whether the mapped events are sent downstream in the original order.
+         * @tparam R The resulting Type
+         * @throws std::invalid_argument if nrOfWorkers is 0.
+         * @return a new IntermediateStream
+         */
+        template<typename R>
+        [[nodiscard]] PushStream<R>& parallel(std::size_t nrOfWorkers, std::function<R(const T&)> mapper, bool ordered = true);
+
+        /**
+         * @brief Forks the stream: the events are sent downstream concurrently by max nrOfWorkers workers on the
+         * executor of the promise factory, in no particular order.
+         * A close or error event is sent downstream after all preceding events.
+         * @param nrOfWorkers The max number of concurrent workers.
+         * @throws std::invalid_argument if nrOfWorkers is 0.
+         * @return a new IntermediateStream
+         */
+        [[nodiscard]] PushStream<T>& fork(std::size_t nrOfWorkers);
+
         /**
          * Given method will be called on close
          * @param closeFunction
@@ -153,6 +244,7 @@ namespace celix {
 #include "celix/impl/IntermediatePushStream.h"
 #include "celix/impl/UnbufferedPushStream.h"
 #include "celix/impl/BufferedPushStream.h"
+#include "celix/impl/ParallelPushStage.h"
 
 template<typename T>
 celix::PushStream<T>::PushStream(std::shared_ptr<PromiseFactory>& _promiseFactory) : promiseFactory{_promiseFactory} {
@@ -170,23 +262,23 @@ template<typename T>
 celix::Promise<void> celix::PushStream<T>::forEach(ForEachFunction func) {
     nextEvent = PushEventConsumer<T>([&, func = std::move(func)](const PushEvent<T>& event) -> long {
         try {
-            switch(event.getType()) {
-                case celix::PushEvent<T>::EventType::DATA:
-                    func(event.getData());
-                    return IPushEventConsumer<T>::CONTINUE;
-                case celix::PushEvent<T>::EventType::CLOSE:
-                    streamEnd.resolve();
-                    break;
-                case celix::PushEvent<T>::EventType::ERROR:
-                    streamEnd.fail(event.getFailure());
-                    break;
+            if (event.getType() == celix::PushEvent<T>::EventType::DATA) {
+                func(event.getData());
+                return IPushEventConsumer<T>::CONTINUE;
             }
+            //note the stream end is resolved after closing the (upstream) streams, because the streams can be
+            //destroyed as soon as the stream end is resolved.
             close(event, false);
+            if (event.getType() == celix::PushEvent<T>::EventType::ERROR) {
+                streamEnd.fail(event.getFailure());
+            } else {
+                streamEnd.resolve();
+            }
             return IPushEventConsumer<T>::ABORT;
         } catch (const std::exception& e) {
             auto errorEvent = ErrorPushEvent<T>(std::current_exception());
-            streamEnd.fail(errorEvent.getFailure());
             close(errorEvent, false);
+            streamEnd.fail(errorEvent.getFailure());
             return IPushEventConsumer<T>::ABORT;
         }
     });
@@ -200,7 +292,8 @@ celix::PushStream<T>& celix::PushStream<T>::filter(PredicateFunction predicate)
     auto downstream = std::make_shared<celix::IntermediatePushStream<T>>(promiseFactory, *this);
     nextEvent = PushEventConsumer<T>([downstream = downstream, predicate = std::move(predicate)](const PushEvent<T>& event) -> long {
         if (event.getType() != celix::PushEvent<T>::EventType::DATA || predicate(event.getData())) {
-            downstream->handleEvent(event);
+            //note the back-pressure of the downstream is propagated, an abort is not
+            return std::max(downstream->handleEvent(event), IPushEventConsumer<T>::CONTINUE);
         }
         return IPushEventConsumer<T>::CONTINUE;
     });
@@ -236,7 +329,7 @@ celix::PushStream<R>& celix::PushStream<T>::map(std::function<R(const T&)> mappe
 
     nextEvent = PushEventConsumer<T>([downstream = downstream, mapper = std::move(mapper)](const PushEvent<T>& event) -> long {
         if (event.getType() == celix::PushEvent<T>::EventType::DATA) {
-            downstream->handleEvent(DataPushEvent<R>(mapper(event.getData())));
+            return std::max(downstream->handleEvent(DataPushEvent<R>(mapper(event.getData()))), IPushEventConsumer<T>::CONTINUE);
         } else {
             downstream->handleEvent(celix::ClosePushEvent<R>());
         }
@@ -246,6 +339,179 @@ celix::PushStream<R>& celix::PushStream<T>::map(std::function<R(const T&)> mappe
     return *downstream;
 }
 
+template<typename T>
+celix::PushStream<std::vector<T>>& celix::PushStream<T>::window(std::chrono::milliseconds duration, std::size_t maxEvents) {
+    if (duration.count() <= 0 && maxEvents == 0) {
+        throw std::invalid_argument("A window needs a duration or a max number of events");
+    }
+    using Window = std::vector<T>;
+    struct WindowState {
+        std::mutex mutex{}; //protects below and serializes sending windows downstream
+        Window events{};
+        std::uint64_t windowId{0};
+        std::shared_ptr<celix::IScheduledFuture> timer{};
+
+        //note must be called with the mutex locked
+        Window takeWindow() {
+            windowId += 1;
+            if (timer) {
+                timer->cancel();
+                timer.reset();
+            }
+            Window result{};
+            result.swap(events);
+            return result;
+        }
+    };
+    auto downstream = std::make_shared<celix::IntermediatePushStream<Window, T>>(promiseFactory, *this);
+    auto state = std::make_shared<WindowState>();
+    auto scheduledExecutor = promiseFactory->getScheduledExecutor();
+
+    nextEvent = PushEventConsumer<T>([downstream, state, scheduledExecutor, duration, maxEvents](const PushEvent<T>& event) -> long {
+        std::lock_guard lck{state->mutex};
+        if (event.getType() != celix::PushEvent<T>::EventType::DATA) {
+            auto remaining = state->takeWindow();
+            if (!remaining.empty()) {
+                downstream->handleEvent(DataPushEvent<Window>(std::move(remaining)));
+            }
+            if (event.getType() == celix::PushEvent<T>::EventType::ERROR) {
+                downstream->handleEvent(ErrorPushEvent<Window>(event.getFailure()));
+            } else {
+                downstream->handleEvent(ClosePushEvent<Window>());
+            }
+            return IPushEventConsumer<T>::CONTINUE;
+        }
+
+        if (state->events.empty() && duration.count() > 0) {
+            auto id = state->windowId;
+            std::weak_ptr<WindowState> weakState = state;
+            std::weak_ptr<celix::IntermediatePushStream<Window, T>> weakDownstream = downstream;
+            state->timer = scheduledExecutor->schedule(duration, [weakState, weakDownstream, id] {
+                auto s = weakState.lock();
+                auto d = weakDownstream.lock();
+                if (s && d) {
+                    std::lock_guard timerLck{s->mutex};
+                    if (s->windowId == id) {
+                        auto elapsed = s->takeWindow();
+                        d->handleEvent(DataPushEvent<Window>(std::move(elapsed)));
+                    }
+                }
+            });
+        }
+        state->events.push_back(event.getData());
+        if (maxEvents > 0 && state->events.size() >= maxEvents) {
+            return std::max(downstream->handleEvent(DataPushEvent<Window>(state->takeWindow())), IPushEventConsumer<T>::CONTINUE);
+        }
+        return IPushEventConsumer<T>::CONTINUE;
+    });
+
+    return *downstream;
+}
+
+template<typename T>
+celix::PushStream<std::vector<T>>& celix::PushStream<T>::batch(std::size_t maxEvents) {
+    if (maxEvents == 0) {
+        throw std::invalid_argument("A batch needs at least 1 event");
+    }
+    return window(std::chrono::milliseconds{0}, maxEvents);
+}
+
+template<typename T>
+template<typename R>
+celix::PushStream<R>& celix::PushStream<T>::coalesce(std::function<std::optional<R>(const T&)> accumulator) {
+    auto downstream = std::make_shared<celix::IntermediatePushStream<R, T>>(promiseFactory, *this);
+
+    nextEvent = PushEventConsumer<T>([downstream, accumulator = std::move(accumulator)](const PushEvent<T>& event) -> long {
+        switch (event.getType()) {
+            case celix::PushEvent<T>::EventType::DATA: {
+                auto result = accumulator(event.getData());
+                if (result) {
+                    return std::max(downstream->handleEvent(DataPushEvent<R>(std::move(*result))), IPushEventConsumer<T>::CONTINUE);
+                }
+                break;
+            }
+            case celix::PushEvent<T>::EventType::ERROR:
+                downstream->handleEvent(ErrorPushEvent<R>(event.getFailure()));
+                break;
+            case celix::PushEvent<T>::EventType::CLOSE:
+                downstream->handleEvent(ClosePushEvent<R>());
+                break;
+        }
+        return IPushEventConsumer<T>::CONTINUE;
+    });
+
+    return *downstream;
+}
+
+template<typename T>
+template<typename R>
+celix::PushStream<R>& celix::PushStream<T>::coalesce(std::size_t count, std::function<R(std::vector<T>&&)> coalescer) {
+    if (count == 0) {
+        throw std::invalid_argument("Cannot coalesce 0 events");
+    }
+    struct CoalesceState {
+        std::mutex mutex{}; //protects below and serializes sending the coalesced events downstream
+        std::vector<T> events{};
+
+        //note must be called with the mutex locked
+        std::vector<T> takeEvents(std::size_t nextCapacity) {
+            std::vector<T> result{};
+            result.reserve(nextCapacity);
+            result.swap(events);
+            return result;
+        }
+    };
+    auto downstream = std::make_shared<celix::IntermediatePushStream<R, T>>(promiseFactory, *this);
+    auto state = std::make_shared<CoalesceState>();
+    state->events.reserve(count);
+
+    //note the collected events are moved into the coalescer and a fresh buffer is reserved for the next events
+    nextEvent = PushEventConsumer<T>([downstream, state, count, coalescer = std::move(coalescer)](const PushEvent<T>& event) -> long {
+        std::lock_guard lck{state->mutex};
+        if (event.getType() != celix::PushEvent<T>::EventType::DATA) {
+            if (!state->events.empty()) {
+                downstream->handleEvent(DataPushEvent<R>(coalescer(state->takeEvents(0))));
+            }
+            if (event.getType() == celix::PushEvent<T>::EventType::ERROR) {
+                downstream->handleEvent(ErrorPushEvent<R>(event.getFailure()));
+            } else {
+                downstream->handleEvent(ClosePushEvent<R>());
+            }
+            return IPushEventConsumer<T>::CONTINUE;
+        }
+
+        state->events.push_back(event.getData());
+        if (state->events.size() >= count) {
+            return std::max(downstream->handleEvent(DataPushEvent<R>(coalescer(state->takeEvents(count)))), IPushEventConsumer<T>::CONTINUE);
+        }
+        return IPushEventConsumer<T>::CONTINUE;
+    });
+
+    return *downstream;
+}
+
+template<typename T>
+celix::PushStream<T>& celix::PushStream<T>::adjustBackPressure(std::function<long(const T&, long)> adjustment) {
+    auto downstream = std::make_shared<celix::IntermediatePushStream<T>>(promiseFactory, *this);
+
+    nextEvent = PushEventConsumer<T>([downstream, adjustment = std::move(adjustment)](const PushEvent<T>& event) -> long {
+        long result = downstream->handleEvent(event);
+        if (event.getType() == celix::PushEvent<T>::EventType::DATA && result >= 0) {
+            return adjustment(event.getData(), result);
+        }
+        return result;
+    });
+
+    return *downstream;
+}
+
+template<typename T>
+celix::PushStream<T>& celix::PushStream<T>::adjustBackPressure(std::function<long(long)> adjustment) {
+    return adjustBackPressure([adjustment = std::move(adjustment)](const T& /*event*/, long backPressure) {
+        return adjustment(backPressure);
+    });
+}
+
 template<typename T>
 celix::PushStream<T>& celix::PushStream<T>::onClose(celix::PushStream<T>::CloseFunction closeFunction) {
     onCloseCallback = std::move(closeFunction);
@@ -307,3 +573,31 @@ typename celix::PushStream<T>::State celix::PushStream<T>::getAndSetState(celix:
     closed = newValue;
     return returnValue;
 }
+
+template<typename T>
+template<typename R>
+celix::PushStream<R>& celix::PushStream<T>::parallel(std::size_t nrOfWorkers, std::function<R(const T&)> mapper, bool ordered) {
+    if (nrOfWorkers == 0) {
+        throw std::invalid_argument("A parallel stream needs at least 1 worker");
+    }
+    auto downstream = std::make_shared<celix::IntermediatePushStream<R, T>>(promiseFactory, *this);
+    auto stage = std::make_shared<celix::impl::ParallelPushStage<T, R>>(
+            promiseFactory->getExecutor(),
+            nrOfWorkers,
+            ordered,
+            std::move(mapper),
+            [downstream](const PushEvent<R>& event) -> long {
+                return downstream->handleEvent(event);
+            });
+
+    nextEvent = PushEventConsumer<T>([stage](const PushEvent<T>& event) -> long {
+        return stage->handleEvent(event);
+    });
+
+    return *downstream;
+}
+
+template<typename T>
+celix::PushStream<T>& celix::PushStream<T>::fork(std::size_t nrOfWorkers) {
+    return parallel<T>(nrOfWorkers, [](const T& event) { return event; }, false);
+}
@@ -80,6 +80,18 @@ namespace celix {
         template <typename T>
         [[nodiscard]] std::shared_ptr<celix::PushStream<T>> createStream(std::shared_ptr<celix::IPushEventSource<T>> eventSource, std::shared_ptr<PromiseFactory>&  promiseFactory);
 
+        /**
+         * @brief creates a stream of for event type T. Stream is buffered (see celix::BufferOptions), on reception of event,
+         * the event processing will be deferred using the PromiseFactory executor.
+         * @param eventSource the coupled event source of which the event are injected.
+         * @param promiseFactory the used promiseFactory
+         * @param options the buffer size, the queue policy for a full buffer and the back-pressure policy.
+         * @tparam T The type of the events
+         * @return the stream, the caller needs to hold the shared_ptr.
+         */
+        template <typename T>
+        [[nodiscard]] std::shared_ptr<celix::BufferedPushStream<T>> createStream(std::shared_ptr<celix::IPushEventSource<T>> eventSource, std::shared_ptr<PromiseFactory>&  promiseFactory, const celix::BufferOptions& options);
+
     private:
         template <typename T>
         void createStreamConsumer(std::shared_ptr<celix::UnbufferedPushStream<T>> stream, std::shared_ptr<celix::IPushEventSource<T>> eventSource);
@@ -113,6 +125,13 @@ std::shared_ptr<celix::PushStream<T>> celix::PushStreamProvider::createStream(st
     return stream;
 }
 
+template <typename T>
+std::shared_ptr<celix::BufferedPushStream<T>> celix::PushStreamProvider::createStream(std::shared_ptr<celix::IPushEventSource<T>> eventSource, std::shared_ptr<PromiseFactory>& promiseFactory, const celix::BufferOptions& options) {
+    auto stream = std::make_shared<BufferedPushStream<T>>(promiseFactory, options);
+    createStreamConsumer<T>(stream, eventSource);
+    return stream;
+}
+
 template<typename T>
 void celix::PushStreamProvider::createStreamConsumer(std::shared_ptr<celix::UnbufferedPushStream<T>> stream, std::shared_ptr<celix::IPushEventSource<T>> eventSource) {
     auto pushStreamConsumer = std::make_shared<celix::StreamPushEventConsumer<T>>(stream);
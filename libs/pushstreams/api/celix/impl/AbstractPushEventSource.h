@@ -20,8 +20,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <set>
+#include <thread>
 
 #include "celix/IPushEventSource.h"
 #include "celix/IAutoCloseable.h"
@@ -40,6 +44,11 @@ namespace celix {
 
         /**
          * Publishes event event in the stream
+         *
+         * The return value of the consumers is honored: a consumer returning a negative value (ABORT) does not receive
+         * any further events and a consumer returning a positive value (back-pressure in milliseconds) receives its
+         * next event after the back-pressure time.
+         * For a synchronous source the publishing thread waits for the back-pressure time.
          * @param event
          */
         void publish(const T& event);
@@ -70,10 +79,30 @@ namespace celix {
         std::shared_ptr<PromiseFactory> promiseFactory;
 
     private:
+        struct ConnectedConsumer {
+            explicit ConnectedConsumer(std::shared_ptr<IPushEventConsumer<T>> _consumer) : consumer{std::move(_consumer)} {}
+
+            /**
+             * @brief Sends the event to the consumer and stores the back-pressure the consumer returned.
+             *
+             * The back-pressure is waited for by publish, before the source lock is taken.
+             */
+            void accept(const PushEvent<T>& event);
+
+            const std::shared_ptr<IPushEventConsumer<T>> consumer;
+            std::atomic<bool> aborted{false};
+            std::atomic<std::chrono::steady_clock::rep> backPressureUntil{0};
+        };
+
+        /**
+         * @brief Waits until the back-pressure of all connected consumers has passed. Must be called without the lock.
+         */
+        void waitForBackPressure();
+
         std::mutex mutex {};
         bool closed{false};
         std::vector<Deferred<void>> connected {};
-        std::vector<std::shared_ptr<IPushEventConsumer<T>>> eventConsumers {};
+        std::vector<std::shared_ptr<ConnectedConsumer>> eventConsumers {};
     };
 }
 
@@ -92,7 +121,7 @@ void celix::AbstractPushEventSource<T>::open(std::shared_ptr<celix::IPushEventCo
     if (closed) {
         _eventConsumer->accept(celix::ClosePushEvent<T>());
     } else {
-        eventConsumers.push_back(_eventConsumer);
+        eventConsumers.push_back(std::make_shared<ConnectedConsumer>(std::move(_eventConsumer)));
         for(auto& connect: connected) {
             connect.resolve();
         }
@@ -108,21 +137,55 @@ template <typename T>
     return connect.getPromise();
 }
 
+template <typename T>
+void celix::AbstractPushEventSource<T>::waitForBackPressure() {
+    auto until = std::chrono::steady_clock::time_point::min();
+    {
+        std::lock_guard lck{mutex};
+        for (const auto& eventConsumer : eventConsumers) {
+            auto consumerUntil = std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{
+                eventConsumer->backPressureUntil.load(std::memory_order_relaxed)}};
+            until = std::max(until, consumerUntil);
+        }
+    }
+    if (until > std::chrono::steady_clock::now()) {
+        std::this_thread::sleep_until(until);
+    }
+}
+
 template <typename T>
 void celix::AbstractPushEventSource<T>::publish(const T& event) {
+    waitForBackPressure();
     std::lock_guard lck{mutex};
 
     if (closed) {
         throw IllegalStateException("AbstractPushEventSource closed");
     } else {
+        eventConsumers.erase(std::remove_if(eventConsumers.begin(), eventConsumers.end(), [](const auto& c) {
+            return c->aborted.load(std::memory_order_relaxed);
+        }), eventConsumers.end());
         for(auto& eventConsumer : eventConsumers) {
-            execute([&, event]() {
+            execute([eventConsumer, event]() {
                 eventConsumer->accept(celix::DataPushEvent<T>(event));
             });
         }
     }
 }
 
+template <typename T>
+void celix::AbstractPushEventSource<T>::ConnectedConsumer::accept(const PushEvent<T>& event) {
+    if (aborted.load(std::memory_order_relaxed)) {
+        return;
+    }
+    long result = consumer->accept(event);
+    if (result < 0) {
+        aborted.store(true, std::memory_order_relaxed);
+    } else if (result > 0) {
+        auto next = std::chrono::steady_clock::now() + std::chrono::milliseconds{result};
+        backPressureUntil.store(next.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+}
+
 template <typename T>
 bool celix::AbstractPushEventSource<T>::isConnected() {
     std::lock_guard lck{mutex};
@@ -143,7 +206,9 @@ void celix::AbstractPushEventSource<T>::close() {
 
         for (auto &eventConsumer : eventConsumers) {
             execute([eventConsumer]() {
-                eventConsumer->accept(celix::ClosePushEvent<T>());
+                if (!eventConsumer->aborted.load(std::memory_order_relaxed)) {
+                    eventConsumer->consumer->accept(celix::ClosePushEvent<T>());
+                }
             });
         }
     }
@@ -19,14 +19,39 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <variant>
+
+#include "celix/BufferOptions.h"
 #include "celix/IPushEventSource.h"
+#include "celix/IllegalStateException.h"
+#include "celix/impl/RingBuffer.h"
 
 namespace celix {
 
+    /**
+     * @brief A push stream which buffers the received events in a lock-free ring buffer and sends them
+     * downstream using a worker on the executor of the promise factory.
+     *
+     * The events are stored in place in the ring buffer (no heap allocation per event) and the worker moves an event
+     * out of the ring buffer before processing it, so that its slot is directly available again. If the buffer is full, the queue policy of the buffer options is applied. The return value of
+     * handleEvent is the back-pressure for the event source, according to the pushback policy of the buffer options.
+     *
+     * With the default QueuePolicyOption::GROW the events which do not fit in the ring buffer are queued in an
+     * unbounded overflow queue (guarded by a mutex), so the stream is unbounded like an unbuffered stream.
+     * Note that with the QueuePolicyOption::BLOCK the publishing thread waits for the worker, so the worker must be
+     * able to run on another thread than the publishing thread.
+     */
     template<typename T>
     class BufferedPushStream: public UnbufferedPushStream<T> {
     public:
-        explicit BufferedPushStream(std::shared_ptr<PromiseFactory>& _promiseFactory);
+        explicit BufferedPushStream(std::shared_ptr<PromiseFactory>& _promiseFactory, BufferOptions _options = {});
         BufferedPushStream(const BufferedPushStream&) = delete;
         BufferedPushStream(BufferedPushStream&&) = delete;
         BufferedPushStream& operator=(const BufferedPushStream&) = delete;
@@ -39,20 +64,45 @@ namespace celix {
         void close() override {
             UnbufferedPushStream<T>::close();
             std::unique_lock lk(mutex);
-            cv.wait(lk, [this]{return nrWorkers == 0;});
+            cv.notify_all(); //wake up blocked publishers
+            //note close can be called by a downstream consumer on the worker, which cannot wait for itself
+            if (workerThread.load() != std::this_thread::get_id()) {
+                cv.wait(lk, [this]{return !workerActive.load();});
+            }
+        }
+
+        /**
+         * @brief The number of events discarded because the buffer was full.
+         */
+        [[nodiscard]] std::size_t getNrOfDiscardedEvents() const {
+            return nrOfDiscardedEvents.load(std::memory_order_relaxed);
         }
 
     protected:
         long handleEvent(const PushEvent<T>& event) override;
 
     private:
-        void startWorker();
-        std::unique_ptr<PushEvent<T>> popQueue();
+        using QueuedEvent = std::variant<std::monostate, DataPushEvent<T>, ClosePushEvent<T>, ErrorPushEvent<T>>;
+
+        bool tryQueue(const PushEvent<T>& event);
+        bool queueBlocking(const PushEvent<T>& event);
+        void queueOrGrow(const PushEvent<T>& event);
+        bool tryTakeOverflow(std::optional<QueuedEvent>& current);
+        long backPressure() const;
+        void startWorkerIfIdle();
+        void drainQueue();
 
-        std::shared_ptr<std::queue<std::unique_ptr<PushEvent<T>>>> queue{std::make_shared<std::queue<std::unique_ptr<PushEvent<T>>>>()};
+        const BufferOptions options;
+        celix::impl::RingBuffer<QueuedEvent> queue;
+        std::deque<QueuedEvent> overflow{}; //only used with QueuePolicyOption::GROW, guarded by the mutex
+        std::atomic<std::size_t> overflowSize{0};
+        std::atomic<bool> workerActive{false};
+        std::atomic<std::thread::id> workerThread{};
+        std::atomic<bool> terminalEventQueued{false};
+        std::atomic<std::size_t> nrOfBlockedPublishers{0};
+        std::atomic<std::size_t> nrOfDiscardedEvents{0};
         std::condition_variable cv{};
-        std::mutex mutex{};
-        int nrWorkers{0};
+        std::mutex mutex{}; //used for waiting on cv, the queue itself is lock-free
     };
 }
 
@@ -61,50 +111,209 @@ namespace celix {
 *********************************************************************************/
 
 template<typename T>
-celix::BufferedPushStream<T>::BufferedPushStream(std::shared_ptr<PromiseFactory>& _promiseFactory) : celix::UnbufferedPushStream<T>(_promiseFactory) {
+celix::BufferedPushStream<T>::BufferedPushStream(std::shared_ptr<PromiseFactory>& _promiseFactory, BufferOptions _options) :
+        celix::UnbufferedPushStream<T>(_promiseFactory),
+        options{_options},
+        queue{_options.bufferSize} {
 }
 
 template<typename T>
 long celix::BufferedPushStream<T>::handleEvent(const PushEvent<T>& event) {
-    std::unique_lock lk(mutex);
-    if(this->closed != celix::PushStream<T>::State::CLOSED) {
-        queue->push(std::move(event.clone()));
-        if (nrWorkers == 0)  {
-            startWorker();
+    if (this->closed == celix::PushStream<T>::State::CLOSED || terminalEventQueued.load(std::memory_order_acquire)) {
+        return IPushEventConsumer<T>::ABORT;
+    }
+
+    if (event.getType() != PushEvent<T>::EventType::DATA) {
+        //note close and error events are never discarded
+        terminalEventQueued.store(true, std::memory_order_release);
+        if (options.queuePolicy == QueuePolicyOption::GROW) {
+            queueOrGrow(event);
+        } else {
+            queueBlocking(event);
+        }
+        startWorkerIfIdle();
+        return IPushEventConsumer<T>::ABORT;
+    }
+
+    if (options.queuePolicy == QueuePolicyOption::GROW) {
+        queueOrGrow(event);
+        startWorkerIfIdle();
+        return backPressure();
+    }
+
+    bool queued = tryQueue(event);
+    if (!queued) {
+        switch (options.queuePolicy) {
+            case QueuePolicyOption::GROW: //note handled above
+            case QueuePolicyOption::BLOCK:
+                queued = queueBlocking(event);
+                break;
+            case QueuePolicyOption::DISCARD_OLDEST:
+                while (!queued) {
+                    if (queue.tryConsume([](QueuedEvent&) {})) {
+                        nrOfDiscardedEvents.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    queued = tryQueue(event);
+                }
+                break;
+            case QueuePolicyOption::DISCARD_NEWEST:
+                nrOfDiscardedEvents.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case QueuePolicyOption::FAIL:
+                terminalEventQueued.store(true, std::memory_order_release);
+                try {
+                    throw IllegalStateException("PushStream buffer is full");
+                } catch (...) {
+                    //note the stream fails directly, so the queued events are discarded to make room for the error
+                    ErrorPushEvent<T> error{std::current_exception()};
+                    while (!tryQueue(error)) {
+                        if (queue.tryConsume([](QueuedEvent&) {})) {
+                            nrOfDiscardedEvents.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                startWorkerIfIdle();
+                return IPushEventConsumer<T>::ABORT;
         }
-        return IPushEventConsumer<T>::CONTINUE;
     }
-    return IPushEventConsumer<T>::ABORT;
+    if (queued) {
+        startWorkerIfIdle();
+    }
+    return backPressure();
 }
 
 template<typename T>
-std::unique_ptr<celix::PushEvent<T>> celix::BufferedPushStream<T>::popQueue() {
-    std::unique_lock lk(mutex);
-    std::unique_ptr<celix::PushEvent<T>> returnValue{nullptr};
-    if (!queue->empty()) {
-        returnValue = std::move(queue->front());
-        queue->pop();
-    } else {
-        nrWorkers = 0;
+bool celix::BufferedPushStream<T>::tryQueue(const PushEvent<T>& event) {
+    switch (event.getType()) {
+        case PushEvent<T>::EventType::DATA:
+            return queue.tryEmplace(std::in_place_type<DataPushEvent<T>>, event.getData());
+        case PushEvent<T>::EventType::CLOSE:
+            return queue.tryEmplace(std::in_place_type<ClosePushEvent<T>>);
+        default:
+            return queue.tryEmplace(std::in_place_type<ErrorPushEvent<T>>, event.getFailure());
     }
+}
 
-    return returnValue;
+template<typename T>
+bool celix::BufferedPushStream<T>::queueBlocking(const PushEvent<T>& event) {
+    if (tryQueue(event)) {
+        return true;
+    }
+    nrOfBlockedPublishers.fetch_add(1, std::memory_order_seq_cst);
+    bool queued = false;
+    {
+        std::unique_lock lk(mutex);
+        while (!(queued = tryQueue(event)) && this->closed != celix::PushStream<T>::State::CLOSED) {
+            startWorkerIfIdle();
+            //note timed wait, so that a missed notification only delays the publisher
+            cv.wait_for(lk, std::chrono::milliseconds{1});
+        }
+    }
+    nrOfBlockedPublishers.fetch_sub(1, std::memory_order_seq_cst);
+    return queued;
 }
 
 template<typename T>
-void celix::BufferedPushStream<T>::startWorker() {
-    nrWorkers++;
-    this->promiseFactory->getExecutor()->execute([&]() {
-        std::weak_ptr<std::queue<std::unique_ptr<PushEvent<T>>>> weak{queue};
-        auto lk = weak.lock();
-        if (lk) {
-            std::unique_ptr<celix::PushEvent<T>> event = popQueue();
-            while (event != nullptr) {
-                this->nextEvent.accept(*event);
-                event = popQueue();
-            }
+void celix::BufferedPushStream<T>::queueOrGrow(const PushEvent<T>& event) {
+    //note once events are in the overflow queue, new events must be queued after them to keep the order
+    if (overflowSize.load(std::memory_order_seq_cst) == 0 && tryQueue(event)) {
+        return;
+    }
+    std::lock_guard lk(mutex);
+    if (overflow.empty() && tryQueue(event)) {
+        return;
+    }
+    switch (event.getType()) {
+        case PushEvent<T>::EventType::DATA:
+            overflow.emplace_back(std::in_place_type<DataPushEvent<T>>, event.getData());
+            break;
+        case PushEvent<T>::EventType::CLOSE:
+            overflow.emplace_back(std::in_place_type<ClosePushEvent<T>>);
+            break;
+        default:
+            overflow.emplace_back(std::in_place_type<ErrorPushEvent<T>>, event.getFailure());
+            break;
+    }
+    overflowSize.fetch_add(1, std::memory_order_seq_cst);
+}
+
+template<typename T>
+bool celix::BufferedPushStream<T>::tryTakeOverflow(std::optional<QueuedEvent>& current) {
+    if (overflowSize.load(std::memory_order_seq_cst) == 0) {
+        return false;
+    }
+    std::lock_guard lk(mutex);
+    if (overflow.empty()) {
+        return false;
+    }
+    current.emplace(std::move(overflow.front()));
+    overflow.pop_front();
+    overflowSize.fetch_sub(1, std::memory_order_seq_cst);
+    return true;
+}
+
+template<typename T>
+long celix::BufferedPushStream<T>::backPressure() const {
+    if (options.pushbackTime <= 0) {
+        return 0;
+    }
+    switch (options.pushbackPolicy) {
+        case PushbackPolicyOption::FIXED:
+            return options.pushbackTime;
+        case PushbackPolicyOption::ON_FULL_FIXED:
+            return queue.size() >= queue.capacity() ? options.pushbackTime : 0;
+        default: //LINEAR
+            return static_cast<long>(static_cast<std::size_t>(options.pushbackTime) * (queue.size() + overflowSize.load()) / queue.capacity());
+    }
+}
+
+template<typename T>
+void celix::BufferedPushStream<T>::startWorkerIfIdle() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!workerActive.exchange(true)) {
+        try {
+            this->promiseFactory->getExecutor()->execute([this] { drainQueue(); });
+        } catch (...) {
+            std::lock_guard lk(mutex);
+            workerActive = false;
             cv.notify_all();
+            throw;
         }
-    });
+    }
 }
 
+template<typename T>
+void celix::BufferedPushStream<T>::drainQueue() {
+    std::optional<QueuedEvent> current{};
+    auto take = [&current](QueuedEvent& queued) {
+        current.emplace(std::move(queued));
+    };
+    workerThread.store(std::this_thread::get_id());
+    while (true) {
+        //note the ring buffer is drained before the overflow queue, which only holds newer events
+        while (queue.tryConsume(take) || tryTakeOverflow(current)) {
+            if (nrOfBlockedPublishers.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard lk(mutex);
+                cv.notify_all();
+            }
+            std::visit([this](auto& event) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(event)>, std::monostate>) {
+                    this->nextEvent.accept(event);
+                }
+            }, *current);
+            current.reset();
+        }
+
+        std::lock_guard lk(mutex);
+        workerThread.store(std::thread::id{});
+        workerActive.store(false);
+        //note an event can be queued after the last tryConsume and before the worker is marked inactive
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((!queue.empty() || !overflow.empty()) && !workerActive.exchange(true)) {
+            workerThread.store(std::this_thread::get_id());
+            continue;
+        }
+        cv.notify_all();
+        return;
+    }
+}
@@ -0,0 +1,322 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <variant>
+
+#include "celix/IExecutor.h"
+#include "celix/IPushEventConsumer.h"
+#include "celix/PushEvent.h"
+#include "celix/impl/RingBuffer.h"
+
+namespace celix::impl {
+
+    /**
+     * @brief A push stream stage which maps the events using max nrOfWorkers workers on an executor.
+     *
+     * The events are queued, with a sequence number, in a bounded lock-free ring buffer. Workers are started on the
+     * executor when an event is queued and less than nrOfWorkers workers are active, a worker maps and sends events
+     * downstream until the ring buffer is empty.
+     *
+     * If ordered, the mapped events are sent downstream in the order of the sequence numbers: a mapped event which is
+     * not next in sequence is parked in a reorder map until the preceding events are sent downstream. If not ordered,
+     * the mapped events are sent downstream concurrently by the workers. In both cases a close or error event is
+     * sent downstream after all preceding events. A failed mapping ends the stream: if not ordered, its error is sent
+     * downstream after the data events which are being sent downstream by other workers at that time.
+     *
+     * Note that a publisher waits if the ring buffer is full.
+     */
+    template<typename T, typename R>
+    class ParallelPushStage : public std::enable_shared_from_this<ParallelPushStage<T, R>> {
+    public:
+        using Mapper = std::function<R(const T&)>;
+        using Emitter = std::function<long(const PushEvent<R>&)>;
+
+        ParallelPushStage(std::shared_ptr<IExecutor> _executor, std::size_t _nrOfWorkers, bool _ordered,
+                          Mapper _mapper, Emitter _emitter, std::size_t bufferSize = 1024) :
+                executor{std::move(_executor)},
+                nrOfWorkers{_nrOfWorkers},
+                ordered{_ordered},
+                mapper{std::move(_mapper)},
+                emitter{std::move(_emitter)},
+                queue{bufferSize} {}
+
+        ParallelPushStage(const ParallelPushStage&) = delete;
+        ParallelPushStage(ParallelPushStage&&) = delete;
+        ParallelPushStage& operator=(const ParallelPushStage&) = delete;
+        ParallelPushStage& operator=(ParallelPushStage&&) = delete;
+
+        /**
+         * @brief Queues the event for the workers.
+         * @return ABORT if a close or error event is already queued, otherwise CONTINUE.
+         */
+        long handleEvent(const PushEvent<T>& event);
+
+    private:
+        struct Terminal {
+            std::exception_ptr failure{}; //nullptr for a close event
+            bool endOfStream{true}; //false for a failed mapping
+        };
+
+        struct QueuedEvent {
+            QueuedEvent() noexcept = default;
+
+            template<typename... Args>
+            explicit QueuedEvent(std::uint64_t _seq, Args&&... args) : seq{_seq}, value{std::forward<Args>(args)...} {}
+
+            std::uint64_t seq{0};
+            std::variant<std::monostate, T, Terminal> value{};
+        };
+
+        using MappedEvent = std::variant<R, Terminal>;
+
+        void startWorker();
+        void work();
+        void process(QueuedEvent& event);
+        void deliverOrdered(std::uint64_t seq, MappedEvent&& event);
+        void deliverUnordered(std::uint64_t seq, MappedEvent&& event);
+        void emit(MappedEvent& event); //note must be called with the mergeMutex locked
+
+        const std::shared_ptr<IExecutor> executor;
+        const std::size_t nrOfWorkers;
+        const bool ordered;
+        const Mapper mapper;
+        const Emitter emitter;
+        celix::impl::RingBuffer<QueuedEvent> queue;
+        std::atomic<std::size_t> nrOfActiveWorkers{0};
+        std::atomic<std::size_t> nrOfBlockedPublishers{0};
+        std::atomic<bool> terminalEventQueued{false};
+
+        std::mutex publishMutex{}; //protects nextSeq and serializes queuing, so that the queue order is the seq order
+        std::condition_variable publishCond{};
+        std::uint64_t nextSeq{0};
+
+        std::mutex mergeMutex{}; //protects below and serializes the ordered/terminal events sent downstream
+        bool downstreamDone{false};
+        std::uint64_t nextSeqToEmit{0}; //ordered: next seq to send downstream, unordered: nr of processed events
+        std::map<std::uint64_t, MappedEvent> parked{};
+        std::optional<std::pair<std::uint64_t, MappedEvent>> parkedTerminal{};
+        std::size_t nrOfInFlightEmits{0}; //unordered: nr of data events being sent downstream outside the mergeMutex
+        std::optional<MappedEvent> pendingFailure{}; //unordered: failed mapping waiting for the in-flight data events
+    };
+}
+
+/*********************************************************************************
+ Implementation
+*********************************************************************************/
+
+template<typename T, typename R>
+long celix::impl::ParallelPushStage<T, R>::handleEvent(const PushEvent<T>& event) {
+    if (terminalEventQueued.load(std::memory_order_acquire)) {
+        return IPushEventConsumer<T>::ABORT;
+    }
+    {
+        std::unique_lock lk{publishMutex};
+        auto tryQueue = [&]() -> bool {
+            switch (event.getType()) {
+                case PushEvent<T>::EventType::DATA:
+                    return queue.tryEmplace(nextSeq, std::in_place_type<T>, event.getData());
+                case PushEvent<T>::EventType::CLOSE:
+                    return queue.tryEmplace(nextSeq, std::in_place_type<Terminal>);
+                default:
+                    return queue.tryEmplace(nextSeq, std::in_place_type<Terminal>, Terminal{event.getFailure(), true});
+            }
+        };
+        if (!tryQueue()) {
+            nrOfBlockedPublishers.fetch_add(1, std::memory_order_seq_cst);
+            while (!tryQueue()) {
+                startWorker();
+                //note timed wait, so that a missed notification only delays the publisher
+                publishCond.wait_for(lk, std::chrono::milliseconds{1});
+            }
+            nrOfBlockedPublishers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+        //note if queuing throws, a default QueuedEvent (monostate) is queued and the seq is not used.
+        nextSeq += 1;
+        if (event.getType() != PushEvent<T>::EventType::DATA) {
+            terminalEventQueued.store(true, std::memory_order_release);
+        }
+    }
+    startWorker();
+    return IPushEventConsumer<T>::CONTINUE;
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::startWorker() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto active = nrOfActiveWorkers.load();
+    while (active < nrOfWorkers && !queue.empty()) {
+        if (nrOfActiveWorkers.compare_exchange_weak(active, active + 1)) {
+            try {
+                executor->execute([self = this->shared_from_this()] { self->work(); });
+            } catch (...) {
+                nrOfActiveWorkers.fetch_sub(1);
+                throw;
+            }
+            return;
+        }
+    }
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::work() {
+    std::optional<QueuedEvent> current{};
+    auto take = [&current](QueuedEvent& queued) {
+        current.emplace(std::move(queued));
+    };
+    while (true) {
+        while (queue.tryConsume(take)) {
+            if (nrOfBlockedPublishers.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard lk{publishMutex};
+                publishCond.notify_all();
+            }
+            process(*current);
+            current.reset();
+        }
+
+        nrOfActiveWorkers.fetch_sub(1);
+        //note an event can be queued after the last tryConsume and before the worker is marked inactive
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto active = nrOfActiveWorkers.load();
+        if (queue.empty() || active >= nrOfWorkers || !nrOfActiveWorkers.compare_exchange_strong(active, active + 1)) {
+            return;
+        }
+    }
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::process(QueuedEvent& event) {
+    if (std::holds_alternative<std::monostate>(event.value)) {
+        return;
+    }
+    std::optional<MappedEvent> mapped{};
+    if (auto* data = std::get_if<T>(&event.value)) {
+        try {
+            mapped.emplace(std::in_place_index<0>, mapper(*data));
+        } catch (...) {
+            mapped.emplace(std::in_place_index<1>, Terminal{std::current_exception(), false});
+        }
+    } else {
+        mapped.emplace(std::in_place_index<1>, std::get<Terminal>(event.value));
+    }
+    if (ordered) {
+        deliverOrdered(event.seq, std::move(*mapped));
+    } else {
+        deliverUnordered(event.seq, std::move(*mapped));
+    }
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::deliverOrdered(std::uint64_t seq, MappedEvent&& event) {
+    std::lock_guard lk{mergeMutex};
+    if (seq != nextSeqToEmit) {
+        parked.emplace(seq, std::move(event));
+        return;
+    }
+    emit(event);
+    nextSeqToEmit += 1;
+    auto it = parked.find(nextSeqToEmit);
+    while (it != parked.end()) {
+        emit(it->second);
+        parked.erase(it);
+        nextSeqToEmit += 1;
+        it = parked.find(nextSeqToEmit);
+    }
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::deliverUnordered(std::uint64_t seq, MappedEvent&& event) {
+    if (auto* data = std::get_if<R>(&event)) {
+        bool done;
+        {
+            std::lock_guard lk{mergeMutex};
+            done = downstreamDone || pendingFailure;
+            if (!done) {
+                nrOfInFlightEmits += 1;
+            }
+        }
+        //note data events are sent downstream concurrently
+        long result = done ? IPushEventConsumer<R>::ABORT : emitter(DataPushEvent<R>(std::move(*data)));
+        std::lock_guard lk{mergeMutex};
+        if (!done) {
+            nrOfInFlightEmits -= 1;
+            if (result < 0) {
+                downstreamDone = true;
+            }
+        }
+        if (pendingFailure && nrOfInFlightEmits == 0) {
+            emit(*pendingFailure);
+            pendingFailure.reset();
+        }
+        nextSeqToEmit += 1;
+        if (parkedTerminal && parkedTerminal->first == nextSeqToEmit) {
+            emit(parkedTerminal->second);
+            parkedTerminal.reset();
+        }
+    } else {
+        std::lock_guard lk{mergeMutex};
+        if (!std::get<Terminal>(event).endOfStream) {
+            //note a failed mapping ends the stream, after the data events which are in flight
+            if (nrOfInFlightEmits == 0) {
+                emit(event);
+            } else if (!pendingFailure) {
+                pendingFailure.emplace(std::move(event));
+            }
+            nextSeqToEmit += 1;
+        } else if (seq == nextSeqToEmit) {
+            emit(event);
+        } else {
+            //note the close or error event of the upstream has the last seq, so it is sent downstream when
+            //all preceding events are processed (it is not counted itself)
+            parkedTerminal.emplace(seq, std::move(event));
+        }
+    }
+}
+
+template<typename T, typename R>
+void celix::impl::ParallelPushStage<T, R>::emit(MappedEvent& event) {
+    if (downstreamDone) {
+        return;
+    }
+    if (auto* data = std::get_if<R>(&event)) {
+        if (emitter(DataPushEvent<R>(std::move(*data))) < 0) {
+            downstreamDone = true;
+        }
+    } else {
+        auto& terminal = std::get<Terminal>(event);
+        if (terminal.failure) {
+            emitter(ErrorPushEvent<R>(terminal.failure));
+        } else {
+            emitter(ClosePushEvent<R>());
+        }
+        downstreamDone = true;
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace celix::impl {
+
+    /**
+     * @brief A bounded lock-free multi producer / multi consumer queue.
+     *
+     * The elements are stored in place in a ring of slots, so pushing and popping an element does not allocate.
+     * Every slot has a sequence number which tells whether the slot is free for the producer or filled for the
+     * consumer of a position, producers and consumers only contend on the (separate) enqueue and dequeue positions.
+     *
+     * E must be nothrow default constructible: if constructing an element throws, a default constructed element is
+     * queued instead (a claimed slot must always be filled) and the exception is rethrown.
+     */
+    template<typename E>
+    class RingBuffer {
+    public:
+        static_assert(std::is_nothrow_default_constructible_v<E>, "E must be nothrow default constructible");
+
+        /**
+         * @brief Creates a ring buffer with a capacity of at least the provided capacity (rounded up to a power of 2).
+         */
+        explicit RingBuffer(std::size_t minCapacity) :
+                mask{roundUpToPowerOf2(minCapacity) - 1},
+                slots{std::make_unique<Slot[]>(mask + 1)} {
+            for (std::size_t i = 0; i <= mask; ++i) {
+                slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~RingBuffer() noexcept {
+            while (tryConsume([](E&) {})) {
+                //nop
+            }
+        }
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer(RingBuffer&&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+        RingBuffer& operator=(RingBuffer&&) = delete;
+
+        /**
+         * @brief Tries to construct an element at the end of the queue.
+         * @return false if the queue is full.
+         */
+        template<typename... Args>
+        bool tryEmplace(Args&&... args) {
+            auto pos = enqueuePos.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[pos & mask];
+                auto seq = slot->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false; //full
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            try {
+                new (slot->storage) E(std::forward<Args>(args)...);
+            } catch (...) {
+                new (slot->storage) E{};
+                slot->seq.store(pos + 1, std::memory_order_release);
+                throw;
+            }
+            slot->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Tries to take the element at the front of the queue and calls the provided function with the element
+         * (in place), after which the element is destroyed.
+         *
+         * The slot of the element is only released after the function returns.
+         * @return false if the queue is empty.
+         */
+        template<typename F>
+        bool tryConsume(F&& fn) {
+            auto pos = dequeuePos.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[pos & mask];
+                auto seq = slot->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false; //empty
+                } else {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            struct Release {
+                Slot* slot;
+                std::size_t nextSeq;
+                ~Release() {
+                    std::launder(reinterpret_cast<E*>(slot->storage))->~E();
+                    slot->seq.store(nextSeq, std::memory_order_release);
+                }
+            } release{slot, pos + mask + 1};
+            fn(*std::launder(reinterpret_cast<E*>(slot->storage)));
+            return true;
+        }
+
+        /**
+         * @brief The number of queued elements. Only a snapshot if producers or consumers are active.
+         */
+        [[nodiscard]] std::size_t size() const {
+            auto deq = dequeuePos.load(std::memory_order_seq_cst);
+            auto enq = enqueuePos.load(std::memory_order_seq_cst);
+            return enq > deq ? enq - deq : 0;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return mask + 1;
+        }
+    private:
+        struct Slot {
+            std::atomic<std::size_t> seq{0};
+            alignas(E) unsigned char storage[sizeof(E)];
+        };
+
+        static std::size_t roundUpToPowerOf2(std::size_t n) {
+            std::size_t result = 2;
+            while (result < n) {
+                result <<= 1U;
+            }
+            return result;
+        }
+
+        const std::size_t mask;
+        const std::unique_ptr<Slot[]> slots;
+        alignas(64) std::atomic<std::size_t> enqueuePos{0};
+        alignas(64) std::atomic<std::size_t> dequeuePos{0};
+    };
+}
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "PushEventConsumer.h"
 #include "celix/IAutoCloseable.h"
 #include "celix/PushStream.h"
@@ -36,7 +38,7 @@ namespace celix {
     private:
 
         std::weak_ptr<PushStream<T>> pushStream;
-        bool closed{false};
+        std::atomic<bool> closed{false}; //note closed by the stream, possibly on another thread than the publisher
     };
 }
 
@@ -50,7 +52,7 @@ celix::StreamPushEventConsumer<T>::StreamPushEventConsumer(std::weak_ptr<PushStr
 
 template <typename T>
 inline long celix::StreamPushEventConsumer<T>::accept(const celix::PushEvent<T>& event) {
-    if (!closed) {
+    if (!closed.load(std::memory_order_acquire)) {
         auto tmp = pushStream.lock();
         if (tmp) {
             return tmp->handleEvent(event);
@@ -62,5 +64,5 @@ inline long celix::StreamPushEventConsumer<T>::accept(const celix::PushEvent<T>&
 
 template <typename T>
 void celix::StreamPushEventConsumer<T>::close() {
-    closed = true;
+    closed.store(true, std::memory_order_release);
 };
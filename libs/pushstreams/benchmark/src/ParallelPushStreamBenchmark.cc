@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "celix/PushStreamProvider.h"
+#include "celix/ThreadPoolExecutor.h"
+
+/**
+ * Throughput benchmark for a CPU heavy map stage.
+ *
+ * Compares a (sequential) map stage with a parallel map stage (ordered and not ordered) using 1 to 16 workers.
+ * The events are published by a synchronous event source, so the benchmark measures the throughput of the complete
+ * stream.
+ */
+
+namespace {
+    constexpr int NR_OF_EVENTS = 1000;
+    constexpr int NR_OF_WORK_ITERATIONS = 20'000;
+
+    std::uint64_t cpuHeavyMap(const int& event) {
+        std::uint64_t result = static_cast<std::uint64_t>(event);
+        for (int i = 0; i < NR_OF_WORK_ITERATIONS; ++i) {
+            result = result * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        return result;
+    }
+
+    template<typename StageFactory>
+    void runStream(benchmark::State& state, StageFactory&& createStage) {
+        celix::PushStreamProvider psp{};
+        auto promiseFactory = std::make_shared<celix::PromiseFactory>(std::make_shared<celix::ThreadPoolExecutor>(1, 32));
+        for (auto _ : state) {
+            auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+            auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+            //note the unordered parallel stage calls forEach concurrently
+            std::atomic<std::uint64_t> sum{0};
+            auto streamEnded = createStage(*stream).forEach([&sum](std::uint64_t event) {
+                sum.fetch_add(event, std::memory_order_relaxed);
+            });
+            for (int i = 0; i < NR_OF_EVENTS; ++i) {
+                ses->publish(i);
+            }
+            ses->close();
+            streamEnded.wait();
+            benchmark::DoNotOptimize(sum.load());
+        }
+        promiseFactory->wait();
+        state.SetItemsProcessed(state.iterations() * NR_OF_EVENTS);
+    }
+}
+
+static void ParallelPushStreamBenchmark_map(benchmark::State& state) {
+    runStream(state, [](celix::PushStream<int>& stream) -> celix::PushStream<std::uint64_t>& {
+        return stream.map<std::uint64_t>(cpuHeavyMap);
+    });
+}
+
+static void ParallelPushStreamBenchmark_parallelOrdered(benchmark::State& state) {
+    auto nrOfWorkers = static_cast<std::size_t>(state.range(0));
+    runStream(state, [nrOfWorkers](celix::PushStream<int>& stream) -> celix::PushStream<std::uint64_t>& {
+        return stream.parallel<std::uint64_t>(nrOfWorkers, cpuHeavyMap, true);
+    });
+}
+
+static void ParallelPushStreamBenchmark_parallelUnordered(benchmark::State& state) {
+    auto nrOfWorkers = static_cast<std::size_t>(state.range(0));
+    runStream(state, [nrOfWorkers](celix::PushStream<int>& stream) -> celix::PushStream<std::uint64_t>& {
+        return stream.parallel<std::uint64_t>(nrOfWorkers, cpuHeavyMap, false);
+    });
+}
+
+BENCHMARK(ParallelPushStreamBenchmark_map)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(ParallelPushStreamBenchmark_parallelOrdered)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(ParallelPushStreamBenchmark_parallelUnordered)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -727,3 +727,444 @@ TEST_F(PushStreamTestSuite, SplitStreamsTest) {
     //GTEST_ASSERT_EQ(12, counts[1]);
 }
 
+
+TEST_F(PushStreamTestSuite, BufferedStreamBlockPolicyTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    celix::BufferOptions options{};
+    options.bufferSize = 4;
+    options.queuePolicy = celix::QueuePolicyOption::BLOCK;
+    auto stream = psp.createStream<int>(ses, promiseFactory, options);
+
+    std::vector<int> received{};
+    auto streamEnded = stream->forEach([&](int event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 1000; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    ASSERT_EQ(1000, received.size());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i, received[i]);
+    }
+    EXPECT_EQ(0, stream->getNrOfDiscardedEvents());
+}
+
+TEST_F(PushStreamTestSuite, BufferedStreamGrowPolicyTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    celix::BufferOptions options{};
+    options.bufferSize = 4;
+    EXPECT_EQ(celix::QueuePolicyOption::GROW, options.queuePolicy); //note GROW is the default
+    auto stream = psp.createStream<int>(ses, promiseFactory, options);
+
+    std::promise<void> gate{};
+    auto gateFuture = gate.get_future().share();
+    std::vector<int> received{};
+    auto streamEnded = stream->forEach([&, gateFuture](int event) {
+        gateFuture.wait();
+        received.push_back(event);
+    });
+
+    //note the consumer is blocked, so the events which do not fit in the buffer go to the overflow queue
+    for (int i = 0; i < 100; ++i) {
+        ses->publish(i);
+    }
+    gate.set_value();
+    ses->close();
+    streamEnded.wait();
+
+    ASSERT_EQ(100, received.size());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i, received[i]);
+    }
+    EXPECT_EQ(0, stream->getNrOfDiscardedEvents());
+}
+
+TEST_F(PushStreamTestSuite, BufferedStreamCloseFromWorkerTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createStream<int>(ses, promiseFactory);
+
+    std::atomic<int> count{0};
+    auto streamEnded = stream->forEach([&](int event) {
+        count++;
+        if (event == 5) {
+            stream->close(); //note called on the worker of the buffered stream
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    streamEnded.wait();
+    EXPECT_GE(count.load(), 6);
+    ses->close();
+}
+
+TEST_F(PushStreamTestSuite, BufferedStreamDiscardPolicyTest) {
+    for (auto policy : {celix::QueuePolicyOption::DISCARD_NEWEST, celix::QueuePolicyOption::DISCARD_OLDEST}) {
+        auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+        celix::BufferOptions options{};
+        options.bufferSize = 4;
+        options.queuePolicy = policy;
+        auto stream = psp.createStream<int>(ses, promiseFactory, options);
+
+        std::promise<void> gate{};
+        auto gateFuture = gate.get_future().share();
+        std::vector<int> received{};
+        auto streamEnded = stream->forEach([&, gateFuture](int event) {
+            gateFuture.wait();
+            received.push_back(event);
+        });
+
+        for (int i = 0; i < 100; ++i) {
+            ses->publish(i);
+        }
+        gate.set_value();
+        ses->close();
+        streamEnded.wait();
+
+        //note the event in progress (and the events in the buffer) are not discarded
+        EXPECT_GE(received.size(), 4);
+        EXPECT_LE(received.size(), 5);
+        EXPECT_EQ(100, received.size() + stream->getNrOfDiscardedEvents());
+        if (policy == celix::QueuePolicyOption::DISCARD_OLDEST) {
+            EXPECT_EQ(99, received.back());
+        } else {
+            EXPECT_EQ(0, received.front());
+            EXPECT_LT(received.back(), 10);
+        }
+    }
+}
+
+TEST_F(PushStreamTestSuite, BufferedStreamFailPolicyTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    celix::BufferOptions options{};
+    options.bufferSize = 2;
+    options.queuePolicy = celix::QueuePolicyOption::FAIL;
+    auto stream = psp.createStream<int>(ses, promiseFactory, options);
+
+    std::promise<void> gate{};
+    auto gateFuture = gate.get_future().share();
+    auto streamEnded = stream->forEach([gateFuture](int /*event*/) {
+        gateFuture.wait();
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    gate.set_value();
+    streamEnded.wait();
+    EXPECT_FALSE(streamEnded.isSuccessfullyResolved());
+    EXPECT_THROW(std::rethrow_exception(streamEnded.getFailure()), celix::IllegalStateException);
+    ses->close();
+}
+
+TEST_F(PushStreamTestSuite, EventSourceHonorsBackPressureTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    std::atomic<int> count{0};
+    auto consumer = std::make_shared<celix::PushEventConsumer<int>>([&](const celix::PushEvent<int>& event) -> long {
+        if (event.getType() != celix::PushEvent<int>::EventType::DATA) {
+            return celix::IPushEventConsumer<int>::ABORT;
+        }
+        count++;
+        return event.getData() == 0 ? 50 : celix::IPushEventConsumer<int>::CONTINUE;
+    });
+    ses->open(consumer);
+
+    ses->publish(0);
+    auto start = std::chrono::steady_clock::now();
+    ses->publish(1); //note synchronous source, so publish waits for the back-pressure
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds{40});
+    EXPECT_EQ(2, count.load());
+    ses->close();
+}
+
+TEST_F(PushStreamTestSuite, EventSourceHonorsAbortTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    std::atomic<int> count{0};
+    auto consumer = std::make_shared<celix::PushEventConsumer<int>>([&](const celix::PushEvent<int>& /*event*/) -> long {
+        count++;
+        return celix::IPushEventConsumer<int>::ABORT;
+    });
+    ses->open(consumer);
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    EXPECT_EQ(1, count.load());
+}
+
+TEST_F(PushStreamTestSuite, BatchTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::vector<std::vector<int>> received{};
+    auto streamEnded = stream->batch(4).forEach([&](const std::vector<int>& batch) {
+        received.push_back(batch);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    //note the partial batch is sent before the close event
+    ASSERT_EQ(3, received.size());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), received[0]);
+    EXPECT_EQ((std::vector<int>{4, 5, 6, 7}), received[1]);
+    EXPECT_EQ((std::vector<int>{8, 9}), received[2]);
+    EXPECT_THROW((void)stream->batch(0), std::invalid_argument);
+}
+
+TEST_F(PushStreamTestSuite, WindowTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::mutex windowMutex{};
+    std::condition_variable windowCond{};
+    std::vector<std::vector<int>> received{};
+    auto streamEnded = stream->window(std::chrono::milliseconds{50}, 100).forEach([&](const std::vector<int>& window) {
+        std::lock_guard lck{windowMutex};
+        received.push_back(window);
+        windowCond.notify_all();
+    });
+
+    ses->publish(1);
+    ses->publish(2);
+    ses->publish(3);
+    {
+        //note the window is sent downstream by the scheduled executor after 50ms
+        std::unique_lock lck{windowMutex};
+        ASSERT_TRUE(windowCond.wait_for(lck, std::chrono::seconds{5}, [&]{ return !received.empty(); }));
+        ASSERT_EQ(1, received.size());
+        EXPECT_EQ((std::vector<int>{1, 2, 3}), received[0]);
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        ses->publish(i);
+    }
+    {
+        //note full window, sent directly
+        std::lock_guard lck{windowMutex};
+        ASSERT_EQ(2, received.size());
+        EXPECT_EQ(100, received[1].size());
+    }
+
+    ses->publish(4);
+    ses->close();
+    streamEnded.wait();
+    std::lock_guard lck{windowMutex};
+    ASSERT_EQ(3, received.size());
+    EXPECT_EQ((std::vector<int>{4}), received[2]);
+}
+
+TEST_F(PushStreamTestSuite, CoalesceTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    int sum = 0;
+    std::vector<int> received{};
+    auto streamEnded = stream->coalesce<int>([&sum](const int& event) -> std::optional<int> {
+        sum += event;
+        if (sum >= 10) {
+            int result = sum;
+            sum = 0;
+            return result;
+        }
+        return {};
+    }).forEach([&](int event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    EXPECT_EQ((std::vector<int>{10, 11, 15}), received);
+}
+
+TEST_F(PushStreamTestSuite, CoalesceCountTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::vector<long> received{};
+    auto streamEnded = stream->coalesce<long>(3, [](std::vector<int>&& events) {
+        long sum = 0;
+        for (auto event : events) {
+            sum += event;
+        }
+        return sum;
+    }).forEach([&](long event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 9; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    EXPECT_EQ((std::vector<long>{3, 12, 21}), received);
+}
+
+TEST_F(PushStreamTestSuite, CoalesceCountRemainingEventsTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::vector<std::size_t> received{};
+    auto streamEnded = stream->coalesce<std::size_t>(4, [](std::vector<int>&& events) {
+        return events.size();
+    }).forEach([&](std::size_t event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    //note the remaining events are coalesced before the close event is sent downstream
+    EXPECT_EQ((std::vector<std::size_t>{4, 4, 2}), received);
+}
+
+TEST_F(PushStreamTestSuite, AdjustBackPressureTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::atomic<int> count{0};
+    auto streamEnded = stream->adjustBackPressure([](const int& event, long backPressure) {
+        return event == 0 ? 50 : backPressure;
+    }).forEach([&](int /*event*/) {
+        count++;
+    });
+
+    ses->publish(0);
+    auto start = std::chrono::steady_clock::now();
+    ses->publish(1); //note synchronous source, so publish waits for the back-pressure
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds{40});
+    ses->close();
+    streamEnded.wait();
+    EXPECT_EQ(2, count.load());
+}
+
+TEST_F(PushStreamTestSuite, ParallelOrderedTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::atomic<int> concurrent{0};
+    std::atomic<int> maxConcurrent{0};
+    std::vector<long> received{};
+    auto streamEnded = stream->parallel<long>(4, [&](const int& event) -> long {
+        int current = ++concurrent;
+        int max = maxConcurrent.load();
+        while (current > max && !maxConcurrent.compare_exchange_weak(max, current)) {
+            //nop
+        }
+        //note later events are mapped faster, so that the events need to be reordered
+        std::this_thread::sleep_for(std::chrono::microseconds{(10 - event % 10) * 100});
+        --concurrent;
+        return event * 2L;
+    }).forEach([&](long event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 200; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    ASSERT_EQ(200, received.size());
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(i * 2L, received[i]);
+    }
+    EXPECT_LE(maxConcurrent.load(), 4);
+    EXPECT_THROW((void)stream->parallel<long>(0, [](const int& event) { return long{event}; }), std::invalid_argument);
+}
+
+TEST_F(PushStreamTestSuite, ForkTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::atomic<int> count{0};
+    std::atomic<long> sum{0};
+    auto streamEnded = stream->fork(4).forEach([&](int event) {
+        count++;
+        sum += event;
+    });
+
+    for (int i = 0; i < 1000; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    //note the close event is sent downstream after all events
+    EXPECT_EQ(1000, count.load());
+    EXPECT_EQ(499'500, sum.load());
+}
+
+TEST_F(PushStreamTestSuite, ParallelMapperExceptionTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::vector<int> received{};
+    auto streamEnded = stream->parallel<int>(2, [](const int& event) -> int {
+        if (event == 5) {
+            throw TestException("Mapping failed");
+        }
+        return event;
+    }).forEach([&](int event) {
+        received.push_back(event);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    EXPECT_FALSE(streamEnded.isSuccessfullyResolved());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), received);
+}
+
+TEST_F(PushStreamTestSuite, ParallelUnorderedMapperExceptionTest) {
+    auto ses = psp.createSynchronousEventSource<int>(promiseFactory);
+    auto stream = psp.createUnbufferedStream<int>(ses, promiseFactory);
+
+    std::atomic<bool> errorReceived{false};
+    std::atomic<int> dataReceivedAfterError{0};
+    auto streamEnded = stream->parallel<int>(4, [](const int& event) -> int {
+        if (event == 5) {
+            throw TestException("Mapping failed");
+        }
+        return event;
+    }, false).onError([&]() {
+        errorReceived = true;
+    }).forEach([&](int /*event*/) {
+        //note a slow consumer, so that data events are in flight when the mapping fails
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        if (errorReceived) {
+            dataReceivedAfterError++;
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        ses->publish(i);
+    }
+    ses->close();
+    streamEnded.wait();
+
+    EXPECT_FALSE(streamEnded.isSuccessfullyResolved());
+    EXPECT_EQ(0, dataReceivedAfterError.load());
+}